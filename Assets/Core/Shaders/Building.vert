@@ -11,6 +11,7 @@
 #include "CloudShadows.h"
 #include "DepthPrecision.h"
 #include "Noise/FastRandom.h"
+#include "VertexQuantization.h"
 
 in vec4 osg_Vertex;
 in vec4 osg_Normal;
@@ -33,7 +34,8 @@ uniform sampler2D cloudSampler;
 
 void main()
 {
-	gl_Position = osg_ModelViewProjectionMatrix * osg_Vertex;
+	vec4 position = dequantizePosition(osg_Vertex);
+	gl_Position = osg_ModelViewProjectionMatrix * position;
 	
 #ifdef CAST_SHADOWS
 	return;
@@ -41,10 +43,11 @@ void main()
 	
 	gl_Position.z = logarithmicZ_vertexShader(gl_Position.z, gl_Position.w, logZ);
 	
-	texCoord = osg_MultiTexCoord0.xyz;
-	normalWS = mat3(modelMatrix) * osg_Normal.xyz;	
+	vec4 texCoord0 = dequantizeTexCoord(osg_MultiTexCoord0);
+	texCoord = texCoord0.xyz;
+	normalWS = mat3(modelMatrix) * decodeOctahedralNormal(osg_Normal.xy);
 
-	vec4 positionWS = modelMatrix * osg_Vertex;
+	vec4 positionWS = modelMatrix * position;
 	positionRelCamera = positionWS.xyz - cameraPosition;
 	
 	// Atmospheric scattering
@@ -53,5 +56,5 @@ void main()
 	scattering = calcAtmosphericScattering(cameraPositionRelPlanet, positionRelPlanet, lightDirection, cloudSampler);
 
 	shadowTexCoord = (shadowProjectionMatrix0 * positionWS).xyz;
-	colorMultiplier = vec3(0.15 + 0.7 * randomFast1d(osg_MultiTexCoord0.w));
+	colorMultiplier = vec3(0.15 + 0.7 * randomFast1d(texCoord0.w));
 }
@@ -10,6 +10,7 @@
 #include "CloudShadows.h"
 #include "Ocean.h"
 #include "Planet.h"
+#include "VertexQuantization.h"
 
 in vec4 osg_Vertex;
 out vec3 positionRelCameraWS;
@@ -31,7 +32,7 @@ uniform vec2 heightMapTexCoordScales[NUM_OCEAN_CASCADES];
 
 void main()
 {
-	positionWS = vec3(modelMatrix * osg_Vertex).xyz;
+	positionWS = vec3(modelMatrix * dequantizePosition(osg_Vertex)).xyz;
 	
 	wrappedNoiseCoord = calcWrappedNoiseCoord(positionWS).xy;
 	// Surface drop is disabled because it drops lakes too far compared with terrain. TODO: investigate.
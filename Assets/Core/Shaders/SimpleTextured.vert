@@ -10,10 +10,12 @@
 #pragma import_defines ( ENABLE_ATMOSPHERE )
 #pragma import_defines ( ENABLE_NORMAL_MAP )
 #pragma import_defines ( FLIP_V )
+#pragma import_defines ( QUANTIZED_VERTEX )
 
 #include "AtmosphericScatteringWithClouds.h"
 #include "CloudShadows.h"
 #include "DepthPrecision.h"
+#include "VertexQuantization.h"
 
 in vec4 osg_Vertex;
 in vec4 osg_Normal;
@@ -38,7 +40,17 @@ uniform sampler2D cloudSampler;
 
 void main()
 {
-	gl_Position = osg_ModelViewProjectionMatrix * osg_Vertex;
+#ifdef QUANTIZED_VERTEX
+	vec4 position = dequantizePosition(osg_Vertex);
+	vec3 normal = decodeOctahedralNormal(osg_Normal.xy);
+	vec4 texCoord0 = dequantizeTexCoord(osg_MultiTexCoord0);
+#else
+	vec4 position = osg_Vertex;
+	vec3 normal = osg_Normal.xyz;
+	vec4 texCoord0 = osg_MultiTexCoord0;
+#endif
+
+	gl_Position = osg_ModelViewProjectionMatrix * position;
 	
 #ifdef CAST_SHADOWS
 	return;
@@ -46,19 +58,19 @@ void main()
 	
 	gl_Position.z = logarithmicZ_vertexShader(gl_Position.z, gl_Position.w, logZ);
 	
-	texCoord = osg_MultiTexCoord0.xyz;
+	texCoord = texCoord0.xyz;
 	
 #ifdef FLIP_V
 	texCoord.y = 1.0 - texCoord.y;
 #endif
 	
-	normalWS = mat3(modelMatrix) * osg_Normal.xyz;
+	normalWS = mat3(modelMatrix) * normal;
 	
 #ifdef ENABLE_NORMAL_MAP
 	tangentWS = mat3(modelMatrix) * osg_MultiTexCoord1.xyz;
 #endif
 	
-	vec4 positionWS = modelMatrix * osg_Vertex;
+	vec4 positionWS = modelMatrix * position;
 	positionRelCamera = positionWS.xyz - cameraPosition;
 	
 #ifdef ENABLE_ATMOSPHERE
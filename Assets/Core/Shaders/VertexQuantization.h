@@ -0,0 +1,38 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Decodes compact vertex attributes written by SkyboltVis/VertexQuantization.h
+
+uniform vec3 positionDequantizeOffset;
+uniform vec3 positionDequantizeScale;
+
+// Must match texCoordQuantizationStepsPerUnit in SkyboltVis/VertexQuantization.h
+const float texCoordDequantizeScale = 1.0 / 256.0;
+
+vec4 dequantizePosition(vec4 quantized)
+{
+	return vec4(positionDequantizeOffset + quantized.xyz * positionDequantizeScale, 1.0);
+}
+
+vec2 signNotZero(vec2 v)
+{
+	return vec2((v.x >= 0.0) ? 1.0 : -1.0, (v.y >= 0.0) ? 1.0 : -1.0);
+}
+
+vec3 decodeOctahedralNormal(vec2 encoded)
+{
+	vec3 v = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	if (v.z < 0.0)
+	{
+		v.xy = (1.0 - abs(v.yx)) * signNotZero(v.xy);
+	}
+	return normalize(v);
+}
+
+vec4 dequantizeTexCoord(vec4 quantized)
+{
+	return vec4(quantized.xy * texCoordDequantizeScale, quantized.zw);
+}
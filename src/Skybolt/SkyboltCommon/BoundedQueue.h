@@ -0,0 +1,124 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+
+namespace skybolt {
+
+//! Lock-free bounded queue for passing items between any number of producer and consumer threads.
+//! Each slot has a sequence number which tells producers and consumers whether the slot is free or full,
+//! so that pushing and popping only require a compare-and-swap on the shared head or tail position.
+//! Based on Dmitry Vyukov's bounded MPMC queue.
+template <typename T>
+class BoundedQueue
+{
+public:
+	//! @param capacity must be a power of two
+	explicit BoundedQueue(size_t capacity) :
+		mCells(new Cell[capacity]),
+		mMask(capacity - 1)
+	{
+		if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+		{
+			throw std::invalid_argument("BoundedQueue capacity must be a power of two");
+		}
+
+		for (size_t i = 0; i < capacity; ++i)
+		{
+			mCells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	size_t capacity() const { return mMask + 1; }
+
+	//! @returns false without modifying item if the queue is full
+	bool tryPush(T&& item)
+	{
+		size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+			if (diff == 0)
+			{
+				if (mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false;
+			}
+			else
+			{
+				position = mEnqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->data = std::move(item);
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	//! @returns nullopt if the queue is empty
+	std::optional<T> tryPop()
+	{
+		size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+		Cell* cell;
+		while (true)
+		{
+			cell = &mCells[position & mMask];
+			size_t sequence = cell->sequence.load(std::memory_order_acquire);
+			std::ptrdiff_t diff = std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1);
+			if (diff == 0)
+			{
+				if (mDequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			else if (diff < 0)
+			{
+				return std::nullopt;
+			}
+			else
+			{
+				position = mDequeuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		std::optional<T> result(std::move(cell->data));
+		cell->sequence.store(position + mMask + 1, std::memory_order_release);
+		return result;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> sequence;
+		T data;
+	};
+
+	static constexpr size_t cacheLineSize = 64;
+
+	std::unique_ptr<Cell[]> mCells;
+	const size_t mMask;
+
+	// Keep producer and consumer positions on separate cache lines to avoid false sharing
+	alignas(cacheLineSize) std::atomic<size_t> mEnqueuePosition{0};
+	alignas(cacheLineSize) std::atomic<size_t> mDequeuePosition{0};
+};
+
+} // namespace skybolt
@@ -0,0 +1,282 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "AssetIndex.h"
+#include "SkyboltCommon/ShaUtility.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <string_view>
+
+namespace skybolt {
+namespace file {
+
+namespace fs = std::filesystem;
+
+static const std::string indexFileHeader = "SkyboltAssetIndex 1";
+
+std::optional<std::string> toAssetIndexKey(const std::string& filename)
+{
+	std::string key = filename;
+	std::replace(key.begin(), key.end(), '\\', '/');
+
+	// Remove redundant separators and current directory components
+	std::string result;
+	result.reserve(key.size());
+	size_t start = 0;
+	while (start <= key.size())
+	{
+		size_t end = key.find('/', start);
+		if (end == std::string::npos)
+		{
+			end = key.size();
+		}
+
+		std::string_view component(key.data() + start, end - start);
+		if (component == "..")
+		{
+			return std::nullopt; // Paths that leave the package are not indexed
+		}
+		else if (!component.empty() && component != ".")
+		{
+			if (!result.empty())
+			{
+				result += '/';
+			}
+			result += component;
+		}
+		else if (component.empty() && start == 0 && end < key.size())
+		{
+			return std::nullopt; // Absolute path
+		}
+		start = end + 1;
+	}
+
+	if (result.empty() || fs::path(result).has_root_name())
+	{
+		return std::nullopt;
+	}
+	return result;
+}
+
+static std::int64_t getModifiedTime(const fs::path& path, std::error_code& ec)
+{
+	return fs::last_write_time(path, ec).time_since_epoch().count();
+}
+
+AssetIndex::AssetIndex(const Paths& packagePaths, const std::optional<Path>& cacheDirectory) :
+	mPackagePaths(packagePaths)
+{
+	auto startTime = std::chrono::steady_clock::now();
+
+	if (cacheDirectory)
+	{
+		std::error_code ec;
+		fs::create_directories(*cacheDirectory, ec);
+	}
+
+	for (size_t packageIndex = 0; packageIndex < mPackagePaths.size(); ++packageIndex)
+	{
+		const Path& packagePath = mPackagePaths[packageIndex];
+
+		std::optional<Path> indexFilename;
+		std::optional<PackageIndex> index;
+		if (cacheDirectory)
+		{
+			std::error_code ec;
+			Path absolutePackagePath = fs::absolute(packagePath, ec);
+			indexFilename = *cacheDirectory / (calcSha1(absolutePackagePath.generic_string()) + ".txt");
+			index = readPackageIndex(*indexFilename, absolutePackagePath);
+			if (index && isUpToDate(*index))
+			{
+				++mBuildStats.packagesLoadedFromCacheCount;
+			}
+			else
+			{
+				index.reset();
+			}
+		}
+
+		if (!index)
+		{
+			index = buildPackageIndex(packagePath);
+			if (indexFilename)
+			{
+				index->packagePath = fs::absolute(packagePath);
+				writePackageIndex(*indexFilename, *index);
+			}
+		}
+
+		for (const std::string& file : index->files)
+		{
+			// Packages earlier in the list take precedence
+			mFilePackageIndices.emplace(file, packageIndex);
+		}
+	}
+
+	mBuildStats.packageCount = mPackagePaths.size();
+	mBuildStats.fileCount = mFilePackageIndices.size();
+	mBuildStats.buildTimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+std::optional<Path> AssetIndex::find(const std::string& filename) const
+{
+	++mLookupCount;
+
+	std::optional<std::string> key = toAssetIndexKey(filename);
+	if (!key)
+	{
+		return std::nullopt;
+	}
+
+	auto i = mFilePackageIndices.find(*key);
+	if (i == mFilePackageIndices.end())
+	{
+		return std::nullopt;
+	}
+
+	++mHitCount;
+	mAvoidedProbeCount += i->second + 1;
+	return mPackagePaths[i->second] / *key;
+}
+
+AssetIndexStats AssetIndex::getStats() const
+{
+	AssetIndexStats stats = mBuildStats;
+	stats.lookupCount = mLookupCount;
+	stats.hitCount = mHitCount;
+	stats.avoidedProbeCount = mAvoidedProbeCount;
+	return stats;
+}
+
+AssetIndex::PackageIndex AssetIndex::buildPackageIndex(const Path& packagePath)
+{
+	PackageIndex index;
+	index.packagePath = packagePath;
+
+	std::error_code ec;
+	index.directoryModifiedTimes.emplace_back("", getModifiedTime(packagePath, ec));
+	if (ec)
+	{
+		return index;
+	}
+
+	for (fs::recursive_directory_iterator it(packagePath, fs::directory_options::skip_permission_denied, ec), end; !ec && it != end; it.increment(ec))
+	{
+		std::error_code entryEc;
+		std::string relativePath = fs::relative(it->path(), packagePath, entryEc).generic_string();
+		if (entryEc)
+		{
+			continue;
+		}
+
+		if (it->is_directory(entryEc))
+		{
+			index.directoryModifiedTimes.emplace_back(relativePath, getModifiedTime(it->path(), entryEc));
+		}
+		else if (it->is_regular_file(entryEc))
+		{
+			index.files.push_back(relativePath);
+		}
+	}
+	return index;
+}
+
+std::optional<AssetIndex::PackageIndex> AssetIndex::readPackageIndex(const Path& filename, const Path& packagePath)
+{
+	std::ifstream f(filename);
+	if (!f.is_open())
+	{
+		return std::nullopt;
+	}
+
+	std::string line;
+	if (!std::getline(f, line) || line != indexFileHeader)
+	{
+		return std::nullopt;
+	}
+
+	if (!std::getline(f, line) || line.size() < 2 || line.compare(0, 2, "P ") != 0 || Path(line.substr(2)) != packagePath)
+	{
+		return std::nullopt;
+	}
+
+	PackageIndex index;
+	index.packagePath = packagePath;
+	while (std::getline(f, line))
+	{
+		if (line.size() < 2)
+		{
+			continue;
+		}
+
+		if (line[0] == 'F')
+		{
+			index.files.push_back(line.substr(2));
+		}
+		else if (line[0] == 'D')
+		{
+			size_t separator = line.find(' ', 2);
+			std::int64_t modifiedTime;
+			auto [ptr, error] = std::from_chars(line.data() + 2, line.data() + std::min(separator, line.size()), modifiedTime);
+			if (separator == std::string::npos || error != std::errc())
+			{
+				return std::nullopt; // Corrupt index
+			}
+			index.directoryModifiedTimes.emplace_back(line.substr(separator + 1), modifiedTime);
+		}
+	}
+	return index;
+}
+
+void AssetIndex::writePackageIndex(const Path& filename, const PackageIndex& index)
+{
+	// Write to a temporary file first so that readers never see a partially written index
+	Path tempFilename = filename;
+	tempFilename += ".tmp";
+	{
+		std::ofstream f(tempFilename);
+		if (!f.is_open())
+		{
+			return;
+		}
+
+		f << indexFileHeader << "\n";
+		f << "P " << index.packagePath.string() << "\n";
+		for (const auto& [directory, modifiedTime] : index.directoryModifiedTimes)
+		{
+			f << "D " << modifiedTime << " " << directory << "\n";
+		}
+		for (const std::string& file : index.files)
+		{
+			f << "F " << file << "\n";
+		}
+	}
+
+	std::error_code ec;
+	fs::rename(tempFilename, filename, ec);
+}
+
+bool AssetIndex::isUpToDate(const PackageIndex& index)
+{
+	// Adding or removing a file or directory changes the modification time of the parent directory,
+	// so it is sufficient to check directories rather than every file.
+	for (const auto& [directory, modifiedTime] : index.directoryModifiedTimes)
+	{
+		std::error_code ec;
+		std::int64_t currentModifiedTime = getModifiedTime(index.packagePath / directory, ec);
+		if (ec || currentModifiedTime != modifiedTime)
+		{
+			return false;
+		}
+	}
+	return !index.directoryModifiedTimes.empty();
+}
+
+} // namespace file
+} // namespace skybolt
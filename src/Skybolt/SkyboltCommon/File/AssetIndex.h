@@ -0,0 +1,76 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "FileUtility.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace skybolt {
+namespace file {
+
+struct AssetIndexStats
+{
+	double buildTimeSeconds = 0;
+	size_t packageCount = 0;
+	size_t packagesLoadedFromCacheCount = 0;
+	size_t fileCount = 0;
+	size_t lookupCount = 0;
+	size_t hitCount = 0;
+	size_t avoidedProbeCount = 0; //!< Number of file existence checks that probing each package in turn would have made for the lookups that hit
+};
+
+//! Maps paths relative to asset packages to the files in the packages, so that files can be located
+//! without probing each package directory for every lookup.
+//! If multiple packages contain the same relative path, the first package wins, matching the search order of the package list.
+//! The index of each package is persisted in a cache directory and reused until the modification time of any directory in the package changes.
+//! The index is immutable after construction and may be used from multiple threads.
+class AssetIndex
+{
+public:
+	//! @param cacheDirectory is the directory used to persist package indices. If empty, indices are not persisted.
+	AssetIndex(const Paths& packagePaths, const std::optional<Path>& cacheDirectory = std::nullopt);
+
+	//! @param filename is a path relative to an asset package, using '/' or '\' separators
+	//! @returns the path of the file in the first package that contains it, or nullopt if no package contains it.
+	std::optional<Path> find(const std::string& filename) const;
+
+	AssetIndexStats getStats() const;
+
+private:
+	struct PackageIndex
+	{
+		Path packagePath;
+		std::vector<std::pair<std::string, std::int64_t>> directoryModifiedTimes; //!< Relative directory path and modification time
+		std::vector<std::string> files; //!< Relative file paths
+	};
+
+	static PackageIndex buildPackageIndex(const Path& packagePath);
+	static std::optional<PackageIndex> readPackageIndex(const Path& filename, const Path& packagePath);
+	static void writePackageIndex(const Path& filename, const PackageIndex& index);
+	static bool isUpToDate(const PackageIndex& index);
+
+private:
+	Paths mPackagePaths;
+	std::unordered_map<std::string, size_t> mFilePackageIndices; //!< Maps relative file path to index of package containing the file
+	AssetIndexStats mBuildStats;
+
+	mutable std::atomic<size_t> mLookupCount = 0;
+	mutable std::atomic<size_t> mHitCount = 0;
+	mutable std::atomic<size_t> mAvoidedProbeCount = 0;
+};
+
+//! @returns the path normalized to the form used as an AssetIndex key, or nullopt if the path is not relative
+std::optional<std::string> toAssetIndexKey(const std::string& filename);
+
+} // namespace file
+} // namespace skybolt
@@ -0,0 +1,425 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "AsyncLogSink.h"
+#include "SkyboltCommon/BoundedQueue.h"
+
+#include <boost/log/attributes/value_extraction.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions/message.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/make_shared.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace bl = boost::log;
+namespace fs = std::filesystem;
+
+namespace skybolt {
+
+namespace {
+
+class RotatingLogFile
+{
+public:
+	explicit RotatingLogFile(const RotatingLogFileConfig& config) :
+		mConfig(config)
+	{
+		if (mConfig.maxFileCount < 1 || mConfig.maxFileSizeBytes == 0)
+		{
+			throw std::invalid_argument("Rotating log file must have positive max file count and size");
+		}
+
+		std::error_code ec;
+		std::uintmax_t size = fs::file_size(mConfig.filename, ec);
+		mSize = ec ? 0 : size;
+		open(std::ios::app);
+	}
+
+	//! Does nothing if the file could not be reopened after rotation
+	void write(const std::string& line)
+	{
+		if (!mFile.is_open())
+		{
+			return;
+		}
+
+		std::uintmax_t lineSize = line.size() + 1;
+		if (mSize > 0 && mSize + lineSize > mConfig.maxFileSizeBytes)
+		{
+			rotate();
+		}
+		mFile << line << '\n';
+		mSize += lineSize;
+	}
+
+	void flush()
+	{
+		mFile.flush();
+	}
+
+	//! @returns false if the file could not be reopened after rotation
+	bool isOpen() const
+	{
+		return mFile.is_open();
+	}
+
+private:
+	void open(std::ios::openmode mode)
+	{
+		mFile.open(mConfig.filename, std::ios::out | mode);
+		if (!mFile.is_open())
+		{
+			throw std::runtime_error("Could not open log file: " + mConfig.filename.string());
+		}
+	}
+
+	fs::path getRotatedFilename(int index) const
+	{
+		fs::path filename = mConfig.filename;
+		return filename.replace_extension(std::to_string(index) + mConfig.filename.extension().string());
+	}
+
+	void rotate()
+	{
+		mFile.close();
+
+		// Errors are ignored because there is nowhere to report them other than the log being written
+		std::error_code ec;
+		int lastIndex = mConfig.maxFileCount - 1;
+		if (lastIndex > 0)
+		{
+			fs::remove(getRotatedFilename(lastIndex), ec);
+			for (int i = lastIndex - 1; i >= 1; --i)
+			{
+				fs::rename(getRotatedFilename(i), getRotatedFilename(i + 1), ec);
+			}
+			fs::rename(mConfig.filename, getRotatedFilename(1), ec);
+		}
+
+		// Rotation runs on the writer thread, which must not throw, so the file is left closed if it can't be reopened
+		mFile.open(mConfig.filename, std::ios::out | std::ios::trunc);
+		mSize = 0;
+	}
+
+private:
+	const RotatingLogFileConfig mConfig;
+	std::ofstream mFile;
+	std::uintmax_t mSize;
+};
+
+//! Counts repeats of each message within the current interval
+class LogRateLimiter
+{
+public:
+	explicit LogRateLimiter(const LogRateLimitConfig& config) :
+		mConfig(config),
+		mIntervalStartTime(std::chrono::steady_clock::now())
+	{
+	}
+
+	//! @returns true if the message should be written
+	bool accept(const std::string& message)
+	{
+		int& count = mRepeatCounts[message];
+		++count;
+		return count <= mConfig.maxRepeatsPerInterval;
+	}
+
+	//! Starts a new interval if the current one has ended.
+	//! @param writeSummary is called with a summary of each message that was suppressed during the interval
+	template <typename WriteSummaryT>
+	void update(std::chrono::steady_clock::time_point now, bool force, const WriteSummaryT& writeSummary)
+	{
+		if (!force && now - mIntervalStartTime < mConfig.interval)
+		{
+			return;
+		}
+
+		for (const auto& [message, count] : mRepeatCounts)
+		{
+			int suppressedCount = count - mConfig.maxRepeatsPerInterval;
+			if (suppressedCount > 0)
+			{
+				writeSummary("Suppressed " + std::to_string(suppressedCount) + " repeats of log message: " + message);
+			}
+		}
+		mRepeatCounts.clear();
+		mIntervalStartTime = now;
+	}
+
+private:
+	const LogRateLimitConfig mConfig;
+	std::unordered_map<std::string, int> mRepeatCounts;
+	std::chrono::steady_clock::time_point mIntervalStartTime;
+};
+
+} // namespace
+
+class AsyncLogSinkBackend : public bl::sinks::basic_sink_backend<bl::sinks::concurrent_feeding>
+{
+public:
+	explicit AsyncLogSinkBackend(const AsyncLogSinkConfig& config) :
+		mQueue(config.queueCapacity),
+		mOverflowPolicy(config.overflowPolicy),
+		mStream(config.stream)
+	{
+		if (config.rotatingFile)
+		{
+			mFile.emplace(*config.rotatingFile);
+		}
+		if (config.rateLimit)
+		{
+			mRateLimiter.emplace(*config.rateLimit);
+		}
+		mWriterThread = std::thread([this] { runWriter(); });
+	}
+
+	~AsyncLogSinkBackend()
+	{
+		stop();
+	}
+
+	//! Called concurrently by logging threads
+	void consume(const bl::record_view& record)
+	{
+		if (!mRunning.load(std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		std::string line;
+		{
+			std::ostringstream ss;
+			if (auto severity = bl::extract<bl::trivial::severity_level>("Severity", record))
+			{
+				ss << "[" << *severity << "] ";
+			}
+			if (auto message = record[bl::expressions::smessage])
+			{
+				ss << *message;
+			}
+			line = ss.str();
+		}
+
+		mQueuedCount.fetch_add(1, std::memory_order_relaxed);
+		if (!push(std::move(line)))
+		{
+			mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+			mProcessedCount.fetch_add(1, std::memory_order_release);
+			return;
+		}
+
+		if (mWriterWaiting.load(std::memory_order_acquire))
+		{
+			mWriterWakeCondition.notify_one();
+		}
+	}
+
+	void flush()
+	{
+		std::uint64_t target = mQueuedCount.load(std::memory_order_relaxed);
+		while (mProcessedCount.load(std::memory_order_acquire) < target && mRunning.load(std::memory_order_relaxed))
+		{
+			mWriterWakeCondition.notify_one();
+			std::this_thread::yield();
+		}
+	}
+
+	void stop()
+	{
+		if (mRunning.exchange(false))
+		{
+			mWriterWakeCondition.notify_one();
+			mWriterThread.join();
+		}
+	}
+
+	std::uint64_t getDroppedCount() const { return mDroppedCount.load(std::memory_order_relaxed); }
+	std::uint64_t getSuppressedCount() const { return mSuppressedCount.load(std::memory_order_relaxed); }
+
+private:
+	bool push(std::string&& line)
+	{
+		if (mQueue.tryPush(std::move(line)))
+		{
+			return true;
+		}
+		if (mOverflowPolicy == LogOverflowPolicy::Drop)
+		{
+			return false;
+		}
+
+		// Spin briefly, then yield to the writer thread until there is room
+		for (int attempt = 0; mRunning.load(std::memory_order_relaxed); ++attempt)
+		{
+			if (mQueue.tryPush(std::move(line)))
+			{
+				return true;
+			}
+			mWriterWakeCondition.notify_one();
+			if (attempt > 64)
+			{
+				std::this_thread::yield();
+			}
+		}
+		return false;
+	}
+
+	void runWriter()
+	{
+		bool stopping = false;
+		while (!stopping)
+		{
+			// Read the flag before draining the queue so that messages pushed before stop() are always written
+			stopping = !mRunning.load(std::memory_order_acquire);
+
+			std::uint64_t batchSize = 0;
+			while (std::optional<std::string> line = mQueue.tryPop())
+			{
+				if (!mRateLimiter || mRateLimiter->accept(*line))
+				{
+					write(*line);
+				}
+				else
+				{
+					mSuppressedCount.fetch_add(1, std::memory_order_relaxed);
+				}
+				++batchSize;
+			}
+
+			if (mRateLimiter)
+			{
+				mRateLimiter->update(std::chrono::steady_clock::now(), stopping, [this] (const std::string& summary) {
+					write(summary);
+				});
+			}
+
+			std::uint64_t droppedCount = mDroppedCount.load(std::memory_order_relaxed);
+			if (droppedCount != mReportedDroppedCount)
+			{
+				write("Dropped " + std::to_string(droppedCount - mReportedDroppedCount) + " log messages because the log queue was full");
+				mReportedDroppedCount = droppedCount;
+			}
+
+			if (batchSize > 0)
+			{
+				flushOutputs();
+				mProcessedCount.fetch_add(batchSize, std::memory_order_release);
+			}
+			else if (!stopping)
+			{
+				waitForMessages();
+			}
+		}
+		flushOutputs();
+	}
+
+	void waitForMessages()
+	{
+		std::unique_lock<std::mutex> lock(mWriterWakeMutex);
+		mWriterWaiting.store(true, std::memory_order_release);
+
+		// A wakeup may be missed if a message is pushed between the emptiness check and the wait,
+		// so wait with a timeout rather than making logging threads take the mutex.
+		// The timeout also bounds how late rate limiting summaries are written.
+		mWriterWakeCondition.wait_for(lock, std::chrono::milliseconds(10));
+		mWriterWaiting.store(false, std::memory_order_relaxed);
+	}
+
+	void write(const std::string& line)
+	{
+		if (mStream)
+		{
+			*mStream << line << '\n';
+		}
+		if (mFile)
+		{
+			mFile->write(line);
+			if (!mFile->isOpen())
+			{
+				mFile.reset();
+				if (mStream)
+				{
+					*mStream << "Stopped writing log file because it could not be reopened after rotation" << '\n';
+				}
+			}
+		}
+	}
+
+	void flushOutputs()
+	{
+		if (mStream)
+		{
+			mStream->flush();
+		}
+		if (mFile)
+		{
+			mFile->flush();
+		}
+	}
+
+private:
+	BoundedQueue<std::string> mQueue;
+	const LogOverflowPolicy mOverflowPolicy;
+
+	// Only accessed by the writer thread
+	std::ostream* mStream;
+	std::optional<RotatingLogFile> mFile;
+	std::optional<LogRateLimiter> mRateLimiter;
+	std::uint64_t mReportedDroppedCount = 0;
+
+	std::atomic<bool> mRunning{true};
+	std::atomic<bool> mWriterWaiting{false};
+	std::atomic<std::uint64_t> mQueuedCount{0};
+	std::atomic<std::uint64_t> mProcessedCount{0};
+	std::atomic<std::uint64_t> mDroppedCount{0};
+	std::atomic<std::uint64_t> mSuppressedCount{0};
+
+	std::mutex mWriterWakeMutex;
+	std::condition_variable mWriterWakeCondition;
+	std::thread mWriterThread;
+};
+
+AsyncLogSink::AsyncLogSink(const AsyncLogSinkConfig& config) :
+	mBackend(boost::make_shared<AsyncLogSinkBackend>(config))
+{
+	// The unlocked frontend lets logging threads call the backend concurrently without a sink-wide lock
+	mFrontend = boost::make_shared<bl::sinks::unlocked_sink<AsyncLogSinkBackend>>(mBackend);
+	bl::core::get()->add_sink(mFrontend);
+}
+
+AsyncLogSink::~AsyncLogSink()
+{
+	bl::core::get()->remove_sink(mFrontend);
+	mBackend->stop();
+}
+
+void AsyncLogSink::flush()
+{
+	mBackend->flush();
+}
+
+std::uint64_t AsyncLogSink::getDroppedCount() const
+{
+	return mBackend->getDroppedCount();
+}
+
+std::uint64_t AsyncLogSink::getSuppressedCount() const
+{
+	return mBackend->getSuppressedCount();
+}
+
+} // namespace skybolt
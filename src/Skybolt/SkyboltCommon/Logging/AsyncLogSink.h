@@ -0,0 +1,84 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <boost/log/sinks/sink.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+
+namespace skybolt {
+
+//! Determines what happens when a message is logged while the queue is full
+enum class LogOverflowPolicy
+{
+	Drop, //!< Discard the message. The number of dropped messages is reported in the log.
+	Block //!< Wait until the writer thread has made room for the message
+};
+
+//! Writes to a log file which is rotated when it reaches a maximum size.
+//! Rotated files are renamed with an increasing index, e.g. "log.txt" becomes "log.1.txt", then "log.2.txt",
+//! and the oldest file is deleted once there are maxFileCount files.
+struct RotatingLogFileConfig
+{
+	std::filesystem::path filename;
+	std::uintmax_t maxFileSizeBytes = 10 * 1024 * 1024;
+	int maxFileCount = 5; //!< Includes the current file
+};
+
+//! Limits how often an identical message is written.
+//! Messages repeated more than maxRepeatsPerInterval times within an interval are suppressed,
+//! and the number of suppressed repeats is written at the end of the interval.
+struct LogRateLimitConfig
+{
+	std::chrono::milliseconds interval = std::chrono::seconds(1);
+	int maxRepeatsPerInterval = 10;
+};
+
+struct AsyncLogSinkConfig
+{
+	size_t queueCapacity = 8192; //!< Must be a power of two
+	LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Drop;
+	std::ostream* stream = &std::cout; //!< May be null to disable stream output. Must outlive the sink.
+	std::optional<RotatingLogFileConfig> rotatingFile;
+	std::optional<LogRateLimitConfig> rateLimit;
+};
+
+class AsyncLogSinkBackend;
+
+//! Log sink which formats messages on the logging thread and passes them through a bounded lock-free queue
+//! to a dedicated writer thread, so that logging never waits on console or file IO.
+//! The sink is registered with the boost log core for the lifetime of this object.
+class AsyncLogSink
+{
+public:
+	//! @throws std::invalid_argument if the config is invalid
+	//! @throws std::runtime_error if the log file could not be opened
+	explicit AsyncLogSink(const AsyncLogSinkConfig& config = {});
+
+	//! Unregisters the sink and writes all queued messages before returning
+	~AsyncLogSink();
+
+	//! Blocks until all messages logged before this call have been written
+	void flush();
+
+	//! @returns the number of messages dropped because the queue was full
+	std::uint64_t getDroppedCount() const;
+
+	//! @returns the number of messages suppressed by rate limiting
+	std::uint64_t getSuppressedCount() const;
+
+private:
+	boost::shared_ptr<AsyncLogSinkBackend> mBackend;
+	boost::shared_ptr<boost::log::sinks::sink> mFrontend;
+};
+
+} // namespace skybolt
@@ -0,0 +1,162 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "GriddedTable.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <stdexcept>
+#include <string>
+
+namespace skybolt {
+namespace math {
+
+int findBracket(const std::vector<double>& axis, double x)
+{
+	assert(axis.size() >= 2);
+	int lastBracket = int(axis.size()) - 2;
+	int i = int(std::upper_bound(axis.begin(), axis.end(), x) - axis.begin()) - 1;
+	return std::clamp(i, 0, lastBracket);
+}
+
+int findBracketFromHint(const std::vector<double>& axis, double x, int hint)
+{
+	assert(axis.size() >= 2);
+	int lastBracket = int(axis.size()) - 2;
+	int i = std::clamp(hint, 0, lastBracket);
+
+	if (x < axis[i])
+	{
+		// Check the bracket below before searching
+		if (i == 0 || x >= axis[i - 1])
+		{
+			return std::max(0, i - 1);
+		}
+	}
+	else if (i < lastBracket && x >= axis[i + 1])
+	{
+		// Check the bracket above before searching
+		if (i + 1 == lastBracket || x < axis[i + 2])
+		{
+			return i + 1;
+		}
+	}
+	else
+	{
+		return i;
+	}
+	return findBracket(axis, x);
+}
+
+GriddedTable::GriddedTable(std::vector<std::vector<double>> axes, std::vector<double> values) :
+	mAxes(std::move(axes)),
+	mValues(std::move(values))
+{
+	if (mAxes.empty() || mAxes.size() > griddedTableMaxDimensionCount)
+	{
+		throw std::invalid_argument("Table must have between 1 and " + std::to_string(griddedTableMaxDimensionCount) + " dimensions");
+	}
+
+	mStrides.resize(mAxes.size());
+	size_t stride = 1;
+	for (int d = int(mAxes.size()) - 1; d >= 0; --d)
+	{
+		const std::vector<double>& axis = mAxes[d];
+		if (axis.empty())
+		{
+			throw std::invalid_argument("Table axis " + std::to_string(d) + " has no breakpoints");
+		}
+		for (size_t i = 1; i < axis.size(); ++i)
+		{
+			if (!(axis[i] > axis[i - 1]))
+			{
+				throw std::invalid_argument("Table axis " + std::to_string(d) + " breakpoints are not strictly increasing");
+			}
+		}
+		mStrides[d] = stride;
+		stride *= axis.size();
+	}
+
+	if (stride != mValues.size())
+	{
+		throw std::invalid_argument("Table has " + std::to_string(mValues.size()) + " values but axes require " + std::to_string(stride));
+	}
+}
+
+double GriddedTable::evaluate(const double* point) const
+{
+	return evaluate(point, [&] (int d, double x) {
+		return findBracket(mAxes[d], x);
+	});
+}
+
+double GriddedTable::evaluate(const double* point, GriddedTableCursor& cursor) const
+{
+	return evaluate(point, [&] (int d, double x) {
+		int bracket = findBracketFromHint(mAxes[d], x, cursor.brackets[d]);
+		cursor.brackets[d] = bracket;
+		return bracket;
+	});
+}
+
+template <typename BracketFinder>
+double GriddedTable::evaluate(const double* point, const BracketFinder& findBracketForDimension) const
+{
+	const int dimensionCount = int(mAxes.size());
+
+	size_t baseOffset = 0;
+	std::array<size_t, griddedTableMaxDimensionCount> upperSteps;
+	std::array<double, griddedTableMaxDimensionCount> weights;
+
+	for (int d = 0; d < dimensionCount; ++d)
+	{
+		const std::vector<double>& axis = mAxes[d];
+		if (axis.size() == 1)
+		{
+			upperSteps[d] = 0;
+			weights[d] = 0;
+			continue;
+		}
+
+		int i = findBracketForDimension(d, point[d]);
+		double weight = (point[d] - axis[i]) / (axis[i + 1] - axis[i]);
+		weights[d] = std::clamp(weight, 0.0, 1.0);
+		baseOffset += i * mStrides[d];
+		upperSteps[d] = mStrides[d];
+	}
+
+	// Gather the values at the corners of the grid cell. Bit d of the corner index selects the upper breakpoint of dimension d.
+	std::array<double, 1 << griddedTableMaxDimensionCount> corners;
+	const int cornerCount = 1 << dimensionCount;
+	for (int c = 0; c < cornerCount; ++c)
+	{
+		size_t offset = baseOffset;
+		for (int d = 0; d < dimensionCount; ++d)
+		{
+			if (c & (1 << d))
+			{
+				offset += upperSteps[d];
+			}
+		}
+		corners[c] = mValues[offset];
+	}
+
+	// Interpolate along each dimension in turn, halving the number of corners each time
+	int count = cornerCount;
+	for (int d = 0; d < dimensionCount; ++d)
+	{
+		count /= 2;
+		double w = weights[d];
+		for (int i = 0; i < count; ++i)
+		{
+			corners[i] = corners[2 * i] + (corners[2 * i + 1] - corners[2 * i]) * w;
+		}
+	}
+	return corners[0];
+}
+
+} // namespace math
+} // namespace skybolt
@@ -0,0 +1,67 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace skybolt {
+namespace math {
+
+constexpr size_t griddedTableMaxDimensionCount = 8;
+
+//! @returns index i of the bracket [axis[i], axis[i+1]) containing x.
+//! Values outside the axis are placed in the first or last bracket.
+//! Uses binary search. Axis must be sorted in strictly increasing order and have at least two values.
+int findBracket(const std::vector<double>& axis, double x);
+
+//! Equivalent to findBracket(), but checks the hint bracket and its neighbours before falling back to binary search.
+//! This makes lookups O(1) when x moves by small amounts between calls.
+int findBracketFromHint(const std::vector<double>& axis, double x, int hint);
+
+//! Stores the brackets found by the previous lookup into a GriddedTable, to speed up lookups at nearby points.
+//! Each table evaluated repeatedly, for example once per simulation step, should have its own cursor.
+struct GriddedTableCursor
+{
+	std::array<int, griddedTableMaxDimensionCount> brackets = {};
+};
+
+//! An N-dimensional table of values on a rectilinear grid, evaluated with multilinear interpolation.
+//! Points outside the grid are clamped to the grid bounds.
+class GriddedTable
+{
+public:
+	//! @param axes are the breakpoints of each dimension, each sorted in strictly increasing order.
+	//!        An axis with one breakpoint represents a dimension on which the value does not depend.
+	//! @param values are in row-major order, i.e. the last axis varies fastest.
+	//!        The number of values must equal the product of the axis sizes.
+	//! @throws std::invalid_argument if the axes or values are invalid
+	GriddedTable(std::vector<std::vector<double>> axes, std::vector<double> values);
+
+	size_t getDimensionCount() const { return mAxes.size(); }
+	const std::vector<std::vector<double>>& getAxes() const { return mAxes; }
+	const std::vector<double>& getValues() const { return mValues; }
+
+	//! @param point contains one coordinate for each dimension
+	double evaluate(const double* point) const;
+
+	//! Evaluates the table, starting each bracket search from the cursor's brackets, and stores the found brackets in the cursor
+	double evaluate(const double* point, GriddedTableCursor& cursor) const;
+
+private:
+	template <typename BracketFinder>
+	double evaluate(const double* point, const BracketFinder& findBracketForDimension) const;
+
+private:
+	std::vector<std::vector<double>> mAxes;
+	std::vector<double> mValues;
+	std::vector<size_t> mStrides; //!< Distance between consecutive values of each dimension
+};
+
+} // namespace math
+} // namespace skybolt
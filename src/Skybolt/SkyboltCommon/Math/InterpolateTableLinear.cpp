@@ -62,7 +62,7 @@ std::optional<double> interpolateTableLinear(const std::vector<double> &xData, c
 	{
 		return std::nullopt;
 	}
-	return math::lerp(xData[point->bounds.first], xData[point->bounds.last], point->weight);
+	return math::lerp(yData[point->bounds.first], yData[point->bounds.last], point->weight);
 }
 
 } // namespace math
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <random>
 
 namespace skybolt {
@@ -48,4 +49,57 @@ private:
 	std::mt19937 generator;
 };
 
+//! Combines integer values into a well mixed 32 bit hash, e.g. for seeding a FastRandom from grid coordinates
+inline std::uint32_t hashSeed(std::uint32_t a, std::uint32_t b = 0, std::uint32_t c = 0)
+{
+	// Murmur3 style mixing
+	auto mix = [](std::uint32_t h, std::uint32_t k) {
+		k *= 0xcc9e2d51u;
+		k = (k << 15) | (k >> 17);
+		k *= 0x1b873593u;
+		h ^= k;
+		h = (h << 13) | (h >> 19);
+		return h * 5u + 0xe6546b64u;
+	};
+
+	std::uint32_t h = mix(mix(mix(0x9747b28cu, a), b), c);
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h;
+}
+
+//! Small and fast random number generator (SplitMix64).
+//! Unlike Random, construction is cheap and needs no warm up, so it is suitable for
+//! creating many independent deterministic streams, e.g. one per grid cell.
+class FastRandom
+{
+public:
+	FastRandom(std::uint64_t seed) : mState(seed) {}
+
+	std::uint32_t next()
+	{
+		std::uint64_t z = (mState += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return std::uint32_t((z ^ (z >> 31)) >> 32);
+	}
+
+	//! @returns value in range [0, 1)
+	float unitRand()
+	{
+		return float(next() >> 8) * (1.0f / 16777216.0f);
+	}
+
+	float rangedRand(float minValue, float maxValue)
+	{
+		return minValue + (maxValue - minValue) * unitRand();
+	}
+
+private:
+	std::uint64_t mState;
+};
+
 } // namespace skybolt
\ No newline at end of file
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
+#include <utility>
 
 namespace skybolt {
 
@@ -19,8 +21,40 @@ public:
 template <typename KeyT, typename FactoryT>
 class RegistryT : public std::map<KeyT, FactoryT>, public Registry
 {
+	using Base = std::map<KeyT, FactoryT>;
+
 public:
 	~RegistryT() override = default;
+
+	//! @returns a number which increases whenever items are inserted, replaced or erased.
+	//! Used by clients to detect changes to the registry. Items modified through iterators are not tracked.
+	uint64_t getVersion() const { return mVersion; }
+
+	//! Non-const access may replace the item, so always counts as a change
+	FactoryT& operator[](const KeyT& key) { ++mVersion; return Base::operator[](key); }
+	FactoryT& operator[](KeyT&& key) { ++mVersion; return Base::operator[](std::move(key)); }
+
+	auto insert(const typename Base::value_type& value) { ++mVersion; return Base::insert(value); }
+
+	template <typename... Args>
+	auto insert(Args&&... args) { ++mVersion; return Base::insert(std::forward<Args>(args)...); }
+
+	template <typename... Args>
+	auto insert_or_assign(Args&&... args) { ++mVersion; return Base::insert_or_assign(std::forward<Args>(args)...); }
+
+	template <typename... Args>
+	auto emplace(Args&&... args) { ++mVersion; return Base::emplace(std::forward<Args>(args)...); }
+
+	template <typename... Args>
+	auto try_emplace(Args&&... args) { ++mVersion; return Base::try_emplace(std::forward<Args>(args)...); }
+
+	template <typename... Args>
+	auto erase(Args&&... args) { ++mVersion; return Base::erase(std::forward<Args>(args)...); }
+
+	void clear() { ++mVersion; Base::clear(); }
+
+private:
+	uint64_t mVersion = 0;
 };
 
-} // namespace skybolt
\ No newline at end of file
+} // namespace skybolt
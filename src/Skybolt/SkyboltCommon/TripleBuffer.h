@@ -0,0 +1,68 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace skybolt {
+
+//! Lock-free triple buffer for handing off results from a single producer thread to a single consumer thread.
+//! The producer writes into the write buffer and publishes it, while the consumer reads the most recently
+//! published buffer. Neither side ever blocks or waits on the other, and the consumer never sees a partially written buffer.
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() = default;
+
+	//! All three buffers are initialized to the given value
+	explicit TripleBuffer(const T& initialValue) :
+		mBuffers{initialValue, initialValue, initialValue}
+	{
+	}
+
+	//! Called by the producer. Returns the buffer to write the next result into.
+	T& getWriteBuffer() { return mBuffers[mWriteIndex]; }
+
+	//! Called by the producer to make the write buffer available to the consumer.
+	//! Any previously published buffer not yet taken by the consumer is recycled as the next write buffer.
+	void publish()
+	{
+		std::uint8_t previous = mMiddleState.exchange(std::uint8_t(mWriteIndex | newDataBit), std::memory_order_acq_rel);
+		mWriteIndex = previous & indexMask;
+	}
+
+	//! Called by the consumer to acquire the most recently published buffer.
+	//! @returns true if a new buffer was acquired, or false if no new buffer has been published since the last update.
+	bool update()
+	{
+		if ((mMiddleState.load(std::memory_order_acquire) & newDataBit) == 0)
+		{
+			return false;
+		}
+
+		std::uint8_t previous = mMiddleState.exchange(std::uint8_t(mReadIndex), std::memory_order_acq_rel);
+		mReadIndex = previous & indexMask;
+		return true;
+	}
+
+	//! Called by the consumer. Returns the buffer acquired by the last call to update().
+	const T& getReadBuffer() const { return mBuffers[mReadIndex]; }
+
+private:
+	static constexpr std::uint8_t indexMask = 0x3;
+	static constexpr std::uint8_t newDataBit = 0x4;
+
+	std::array<T, 3> mBuffers;
+	int mWriteIndex = 0; //!< Owned by producer
+	int mReadIndex = 1; //!< Owned by consumer
+	std::atomic<std::uint8_t> mMiddleState{2}; //!< Index of the buffer shared between producer and consumer, plus newDataBit
+};
+
+} // namespace skybolt
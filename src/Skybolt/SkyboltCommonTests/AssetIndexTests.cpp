@@ -0,0 +1,99 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/File/AssetIndex.h>
+
+#include <fstream>
+
+using namespace skybolt;
+using namespace skybolt::file;
+
+namespace fs = std::filesystem;
+
+static fs::path getTemporaryDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "AssetIndexTests";
+}
+
+static void writeFile(const fs::path& path)
+{
+	fs::create_directories(path.parent_path());
+	std::ofstream(path) << "test";
+}
+
+//! Creates two packages, with "Shared/File.txt" present in both
+static Paths createPackages()
+{
+	fs::remove_all(getTemporaryDirectory());
+
+	fs::path packageA = getTemporaryDirectory() / "Packages" / "A";
+	fs::path packageB = getTemporaryDirectory() / "Packages" / "B";
+	writeFile(packageA / "Shared" / "File.txt");
+	writeFile(packageA / "OnlyInA.txt");
+	writeFile(packageB / "Shared" / "File.txt");
+	writeFile(packageB / "Nested" / "Deeper" / "OnlyInB.txt");
+	return {packageA, packageB};
+}
+
+TEST_CASE("AssetIndex locates files in packages in package order")
+{
+	Paths packages = createPackages();
+	AssetIndex index(packages);
+
+	CHECK(index.find("OnlyInA.txt") == packages[0] / "OnlyInA.txt");
+	CHECK(index.find("Nested/Deeper/OnlyInB.txt") == packages[1] / "Nested/Deeper/OnlyInB.txt");
+	CHECK(index.find("Shared/File.txt") == packages[0] / "Shared/File.txt");
+	CHECK(!index.find("Missing.txt"));
+	CHECK(!index.find("Nested")); // Directories are not indexed
+
+	AssetIndexStats stats = index.getStats();
+	CHECK(stats.packageCount == 2);
+	CHECK(stats.fileCount == 3);
+	CHECK(stats.packagesLoadedFromCacheCount == 0);
+	CHECK(stats.lookupCount == 5);
+	CHECK(stats.hitCount == 3);
+	CHECK(stats.avoidedProbeCount == 1 + 2 + 1);
+}
+
+TEST_CASE("AssetIndex normalizes lookup paths")
+{
+	Paths packages = createPackages();
+	AssetIndex index(packages);
+
+	CHECK(index.find("./Nested//Deeper/OnlyInB.txt") == packages[1] / "Nested/Deeper/OnlyInB.txt");
+	CHECK(index.find("Nested\\Deeper\\OnlyInB.txt") == packages[1] / "Nested/Deeper/OnlyInB.txt");
+	CHECK(!index.find("Nested/../OnlyInA.txt"));
+	CHECK(!index.find("/OnlyInA.txt"));
+	CHECK(!index.find(""));
+}
+
+TEST_CASE("AssetIndex is persisted and invalidated when package directories change")
+{
+	Paths packages = createPackages();
+	fs::path cacheDirectory = getTemporaryDirectory() / "Cache";
+
+	{
+		AssetIndex index(packages, cacheDirectory);
+		CHECK(index.getStats().packagesLoadedFromCacheCount == 0);
+	}
+
+	{
+		AssetIndex index(packages, cacheDirectory);
+		CHECK(index.getStats().packagesLoadedFromCacheCount == 2);
+		CHECK(index.find("Nested/Deeper/OnlyInB.txt"));
+	}
+
+	// Adding a file to a nested directory invalidates that package only
+	writeFile(packages[1] / "Nested" / "Deeper" / "Added.txt");
+	fs::last_write_time(packages[1] / "Nested" / "Deeper", fs::last_write_time(packages[1] / "Nested" / "Deeper") + std::chrono::seconds(1));
+
+	{
+		AssetIndex index(packages, cacheDirectory);
+		CHECK(index.getStats().packagesLoadedFromCacheCount == 1);
+		CHECK(index.find("Nested/Deeper/Added.txt") == packages[1] / "Nested/Deeper/Added.txt");
+	}
+}
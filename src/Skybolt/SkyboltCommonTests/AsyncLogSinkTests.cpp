@@ -0,0 +1,286 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/Logging/AsyncLogSink.h>
+
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace skybolt;
+namespace fs = std::filesystem;
+
+static std::vector<std::string> readLines(std::istream& stream)
+{
+	std::vector<std::string> lines;
+	std::string line;
+	while (std::getline(stream, line))
+	{
+		lines.push_back(line);
+	}
+	return lines;
+}
+
+static size_t countLinesContaining(const std::vector<std::string>& lines, const std::string& text)
+{
+	return std::count_if(lines.begin(), lines.end(), [&] (const std::string& line) {
+		return line.find(text) != std::string::npos;
+	});
+}
+
+namespace {
+
+//! Stream buffer which is slow to write, to simulate a slow console or disk
+class SlowStreamBuf : public std::stringbuf
+{
+protected:
+	std::streamsize xsputn(const char* s, std::streamsize count) override
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return std::stringbuf::xsputn(s, count);
+	}
+};
+
+} // namespace
+
+TEST_CASE("AsyncLogSink writes messages with severity")
+{
+	std::stringstream stream;
+	{
+		AsyncLogSinkConfig config;
+		config.stream = &stream;
+		AsyncLogSink sink(config);
+
+		BOOST_LOG_TRIVIAL(info) << "Hello " << 1;
+		BOOST_LOG_TRIVIAL(error) << "World";
+		sink.flush();
+		CHECK(readLines(stream) == std::vector<std::string>({"[info] Hello 1", "[error] World"}));
+		stream.clear(); // Clear EOF flag so that the stream can be written to again
+
+		BOOST_LOG_TRIVIAL(warning) << "Written on destruction";
+	}
+
+	CHECK(readLines(stream) == std::vector<std::string>({"[warning] Written on destruction"}));
+}
+
+TEST_CASE("AsyncLogSink drops and reports messages when queue is full")
+{
+	SlowStreamBuf buffer;
+	std::ostream stream(&buffer);
+
+	constexpr int messageCount = 1000;
+	AsyncLogSinkConfig config;
+	config.queueCapacity = 16;
+	config.overflowPolicy = LogOverflowPolicy::Drop;
+	config.stream = &stream;
+
+	std::uint64_t droppedCount;
+	{
+		AsyncLogSink sink(config);
+		for (int i = 0; i < messageCount; ++i)
+		{
+			BOOST_LOG_TRIVIAL(info) << "Message " << i;
+		}
+		sink.flush();
+		droppedCount = sink.getDroppedCount();
+	}
+
+	CHECK(droppedCount > 0);
+	std::istringstream result(buffer.str());
+	std::vector<std::string> lines = readLines(result);
+	CHECK(countLinesContaining(lines, "Message ") + droppedCount == messageCount);
+	CHECK(countLinesContaining(lines, "log messages because the log queue was full") > 0);
+}
+
+TEST_CASE("AsyncLogSink blocks rather than dropping when configured")
+{
+	std::stringstream stream;
+
+	constexpr int threadCount = 4;
+	constexpr int messagesPerThread = 2000;
+	AsyncLogSinkConfig config;
+	config.queueCapacity = 4;
+	config.overflowPolicy = LogOverflowPolicy::Block;
+	config.stream = &stream;
+
+	{
+		AsyncLogSink sink(config);
+
+		std::vector<std::thread> threads;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([] {
+				for (int i = 0; i < messagesPerThread; ++i)
+				{
+					BOOST_LOG_TRIVIAL(info) << "Message " << i;
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		sink.flush();
+		CHECK(sink.getDroppedCount() == 0);
+	}
+
+	CHECK(readLines(stream).size() == threadCount * messagesPerThread);
+}
+
+TEST_CASE("AsyncLogSink rate limits repeated messages")
+{
+	std::stringstream stream;
+	{
+		AsyncLogSinkConfig config;
+		config.stream = &stream;
+		config.rateLimit = LogRateLimitConfig();
+		config.rateLimit->interval = std::chrono::hours(1);
+		config.rateLimit->maxRepeatsPerInterval = 3;
+		AsyncLogSink sink(config);
+
+		for (int i = 0; i < 10; ++i)
+		{
+			BOOST_LOG_TRIVIAL(warning) << "Repeated";
+			BOOST_LOG_TRIVIAL(warning) << "Unique " << i;
+		}
+		sink.flush();
+		CHECK(sink.getSuppressedCount() == 7);
+	}
+
+	// Summary is written when the interval ends, which is forced when the sink is destroyed
+	std::vector<std::string> lines = readLines(stream);
+	CHECK(countLinesContaining(lines, "Repeated") == 4);
+	CHECK(countLinesContaining(lines, "Unique ") == 10);
+	CHECK(countLinesContaining(lines, "Suppressed 7 repeats of log message: [warning] Repeated") == 1);
+}
+
+TEST_CASE("AsyncLogSink rotates log file")
+{
+	fs::path dir = fs::temp_directory_path() / "SkyboltTests" / "AsyncLogSink";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+
+	{
+		AsyncLogSinkConfig config;
+		config.stream = nullptr;
+		config.rotatingFile = RotatingLogFileConfig();
+		config.rotatingFile->filename = dir / "log.txt";
+		config.rotatingFile->maxFileSizeBytes = 100;
+		config.rotatingFile->maxFileCount = 3;
+		AsyncLogSink sink(config);
+
+		// Each line is 50 bytes including newline, so each file holds two lines
+		for (int i = 0; i < 10; ++i)
+		{
+			BOOST_LOG_TRIVIAL(info) << "Line " << i << std::string(36, '.');
+		}
+	}
+
+	std::vector<fs::path> files = {dir / "log.txt", dir / "log.1.txt", dir / "log.2.txt"};
+	for (const fs::path& file : files)
+	{
+		CHECK(fs::file_size(file) == 100);
+	}
+	CHECK(!fs::exists(dir / "log.3.txt"));
+
+	// Newest messages are in the current file
+	std::ifstream current(files[0]);
+	std::vector<std::string> lines = readLines(current);
+	REQUIRE(lines.size() == 2);
+	CHECK(lines[0].find("Line 8") != std::string::npos);
+	CHECK(lines[1].find("Line 9") != std::string::npos);
+
+	std::ifstream oldest(files[2]);
+	lines = readLines(oldest);
+	REQUIRE(lines.size() == 2);
+	CHECK(lines[0].find("Line 4") != std::string::npos);
+}
+
+TEST_CASE("AsyncLogSink keeps writing to stream if log file can't be reopened after rotation")
+{
+	fs::path dir = fs::temp_directory_path() / "SkyboltTests" / "AsyncLogSinkRotationFailure";
+	fs::remove_all(dir);
+	fs::create_directories(dir);
+
+	std::stringstream stream;
+	{
+		AsyncLogSinkConfig config;
+		config.stream = &stream;
+		config.rotatingFile = RotatingLogFileConfig();
+		config.rotatingFile->filename = dir / "log.txt";
+		config.rotatingFile->maxFileSizeBytes = 100;
+		config.rotatingFile->maxFileCount = 1;
+		AsyncLogSink sink(config);
+
+		BOOST_LOG_TRIVIAL(info) << "Before rotation" << std::string(50, '.');
+		sink.flush();
+
+		// Removing the directory makes reopening the file fail when it is rotated
+		fs::remove_all(dir);
+
+		for (int i = 0; i < 4; ++i)
+		{
+			BOOST_LOG_TRIVIAL(info) << "Line " << i << std::string(50, '.');
+		}
+		sink.flush();
+		stream.clear();
+		BOOST_LOG_TRIVIAL(info) << "Written on destruction";
+	}
+
+	std::vector<std::string> lines = readLines(stream);
+	CHECK(countLinesContaining(lines, "Stopped writing log file") == 1);
+	CHECK(countLinesContaining(lines, "Line ") == 4);
+	CHECK(countLinesContaining(lines, "Written on destruction") == 1);
+	CHECK(!fs::exists(dir));
+}
+
+TEST_CASE("Burst of log calls from many threads does not wait on slow output")
+{
+	SlowStreamBuf buffer;
+	std::ostream stream(&buffer);
+
+	AsyncLogSinkConfig config;
+	config.queueCapacity = 256; // Keep small so that draining the queue on destruction is quick
+	config.overflowPolicy = LogOverflowPolicy::Drop;
+	config.stream = &stream;
+	AsyncLogSink sink(config);
+
+	constexpr int threadCount = 8;
+	constexpr int messagesPerThread = 1000;
+	std::vector<std::chrono::steady_clock::duration> threadDurations(threadCount);
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t] {
+			auto startTime = std::chrono::steady_clock::now();
+			for (int i = 0; i < messagesPerThread; ++i)
+			{
+				BOOST_LOG_TRIVIAL(info) << "Thread " << t << " message " << i;
+			}
+			threadDurations[t] = std::chrono::steady_clock::now() - startTime;
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	// Each write to the output stream takes at least 1ms, so a synchronous sink would take at least 8 seconds.
+	// The bound is generous to avoid false failures on loaded test machines.
+	for (const auto& duration : threadDurations)
+	{
+		CHECK(duration < std::chrono::milliseconds(500));
+	}
+}
@@ -0,0 +1,110 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/BoundedQueue.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace skybolt;
+
+TEST_CASE("BoundedQueue pops items in order until empty")
+{
+	BoundedQueue<int> queue(4);
+	CHECK(queue.capacity() == 4);
+	CHECK(!queue.tryPop());
+
+	for (int i = 0; i < 4; ++i)
+	{
+		CHECK(queue.tryPush(int(i)));
+	}
+	CHECK(!queue.tryPush(4));
+
+	for (int i = 0; i < 4; ++i)
+	{
+		CHECK(queue.tryPop() == i);
+	}
+	CHECK(!queue.tryPop());
+
+	// Wraps around
+	CHECK(queue.tryPush(5));
+	CHECK(queue.tryPop() == 5);
+}
+
+TEST_CASE("BoundedQueue does not move from item when full")
+{
+	BoundedQueue<std::string> queue(2);
+	CHECK(queue.tryPush("a"));
+	CHECK(queue.tryPush("b"));
+
+	std::string item = "c";
+	CHECK(!queue.tryPush(std::move(item)));
+	CHECK(item == "c");
+}
+
+TEST_CASE("BoundedQueue capacity must be power of two")
+{
+	CHECK_THROWS_AS(BoundedQueue<int>(3), std::invalid_argument);
+	CHECK_THROWS_AS(BoundedQueue<int>(0), std::invalid_argument);
+}
+
+TEST_CASE("BoundedQueue passes every item exactly once between many producers and consumers")
+{
+	constexpr int producerCount = 4;
+	constexpr int consumerCount = 4;
+	constexpr int itemsPerProducer = 20000;
+	BoundedQueue<int> queue(64);
+
+	std::vector<std::atomic<int>> receivedCounts(producerCount * itemsPerProducer);
+	std::atomic<int> consumedCount = 0;
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < producerCount; ++p)
+	{
+		threads.emplace_back([&, p] {
+			for (int i = 0; i < itemsPerProducer; ++i)
+			{
+				while (!queue.tryPush(p * itemsPerProducer + i))
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (int c = 0; c < consumerCount; ++c)
+	{
+		threads.emplace_back([&] {
+			while (consumedCount.load() < int(receivedCounts.size()))
+			{
+				if (std::optional<int> item = queue.tryPop())
+				{
+					++receivedCounts[*item];
+					++consumedCount;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	int wrongCount = 0;
+	for (const std::atomic<int>& count : receivedCounts)
+	{
+		wrongCount += (count.load() != 1) ? 1 : 0;
+	}
+	CHECK(wrongCount == 0);
+	CHECK(!queue.tryPop());
+}
@@ -0,0 +1,252 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <SkyboltCommon/Math/GriddedTable.h>
+#include <SkyboltCommon/Math/InterpolateTableLinear.h>
+#include <catch2/catch.hpp>
+
+#include <functional>
+#include <random>
+
+using namespace skybolt;
+using namespace math;
+
+static std::vector<double> createAxis(double first, double last, int count)
+{
+	std::vector<double> axis;
+	for (int i = 0; i < count; ++i)
+	{
+		axis.push_back(first + (last - first) * double(i) / double(count - 1));
+	}
+	return axis;
+}
+
+//! Multilinear functions are reproduced exactly by multilinear interpolation
+static double multilinearFunction(const double* p)
+{
+	return 1.0 + 2.0 * p[0] - 3.0 * p[1] + 0.5 * p[2] + p[0] * p[1] - 0.25 * p[1] * p[2] + 0.1 * p[0] * p[1] * p[2];
+}
+
+static GriddedTable createTable(const std::vector<std::vector<double>>& axes, const std::function<double(const double*)>& f)
+{
+	std::vector<double> values;
+	std::vector<size_t> index(axes.size(), 0);
+	std::vector<double> point(axes.size());
+	while (true)
+	{
+		for (size_t d = 0; d < axes.size(); ++d)
+		{
+			point[d] = axes[d][index[d]];
+		}
+		values.push_back(f(point.data()));
+
+		// Increment index with last dimension varying fastest
+		int d = int(axes.size()) - 1;
+		for (; d >= 0; --d)
+		{
+			if (++index[d] < axes[d].size())
+			{
+				break;
+			}
+			index[d] = 0;
+		}
+		if (d < 0)
+		{
+			break;
+		}
+	}
+	return GriddedTable(axes, values);
+}
+
+TEST_CASE("Find bracket")
+{
+	std::vector<double> axis = { 4, 5, 7, 10 };
+
+	CHECK(findBracket(axis, 2) == 0);
+	CHECK(findBracket(axis, 4) == 0);
+	CHECK(findBracket(axis, 4.5) == 0);
+	CHECK(findBracket(axis, 5) == 1);
+	CHECK(findBracket(axis, 9) == 2);
+	CHECK(findBracket(axis, 10) == 2);
+	CHECK(findBracket(axis, 20) == 2);
+}
+
+TEST_CASE("Find bracket from hint matches find bracket")
+{
+	std::vector<double> axis = createAxis(-10, 10, 21);
+
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<double> distribution(-12, 12);
+	for (int i = 0; i < 1000; ++i)
+	{
+		double x = distribution(generator);
+		int expected = findBracket(axis, x);
+		for (int hint : {-1, 0, expected - 2, expected - 1, expected, expected + 1, expected + 2, 100})
+		{
+			CHECK(findBracketFromHint(axis, x, hint) == expected);
+		}
+	}
+}
+
+TEST_CASE("Gridded table rejects invalid input")
+{
+	CHECK_THROWS(GriddedTable({}, {}));
+	CHECK_THROWS(GriddedTable({{}}, {}));
+	CHECK_THROWS(GriddedTable({{1, 1}}, {2, 3}));
+	CHECK_THROWS(GriddedTable({{2, 1}}, {2, 3}));
+	CHECK_THROWS(GriddedTable({{1, 2}, {1, 2}}, {1, 2, 3}));
+	CHECK_NOTHROW(GriddedTable({{1, 2}, {1, 2}}, {1, 2, 3, 4}));
+}
+
+TEST_CASE("Gridded table 1D interpolation matches interpolateTableLinear")
+{
+	std::vector<double> xData = { 4, 5, 7 };
+	std::vector<double> yData = { 1, 3, -1 };
+	GriddedTable table({xData}, yData);
+
+	for (double x = 3; x <= 8; x += 0.25)
+	{
+		CHECK(table.evaluate(&x) == Approx(*interpolateTableLinear(xData, yData, x, /* extrapolate */ false)));
+	}
+}
+
+TEST_CASE("Gridded table interpolates 2D table")
+{
+	// Values in row-major order, with the last axis varying fastest
+	GriddedTable table({{0, 1}, {0, 10, 20}}, {
+		0, 1, 2,
+		10, 11, 12
+	});
+
+	std::vector<double> p = {0.5, 15};
+	CHECK(table.evaluate(p.data()) == Approx(6.5));
+
+	p = {1, 20};
+	CHECK(table.evaluate(p.data()) == Approx(12));
+
+	// Points outside the grid are clamped
+	p = {-1, 30};
+	CHECK(table.evaluate(p.data()) == Approx(2));
+}
+
+TEST_CASE("Gridded table reproduces multilinear function exactly")
+{
+	GriddedTable table = createTable({createAxis(0, 1, 5), {-3, -1, 0, 0.5, 2}, createAxis(-5, 5, 4)}, &multilinearFunction);
+
+	GriddedTableCursor cursor;
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> distribution(0, 1);
+	for (int i = 0; i < 1000; ++i)
+	{
+		double p[3] = {distribution(generator), -3 + 5 * distribution(generator), -5 + 10 * distribution(generator)};
+		double expected = multilinearFunction(p);
+		CHECK(table.evaluate(p) == Approx(expected).margin(1e-12));
+		CHECK(table.evaluate(p, cursor) == Approx(expected).margin(1e-12));
+	}
+}
+
+TEST_CASE("Gridded table approximates smooth function with error bounded by grid resolution")
+{
+	auto f = [] (const double* p) { return std::sin(p[0]) * std::cos(p[1]); };
+
+	auto calcMaxError = [&] (int breakpointCount) {
+		GriddedTable table = createTable({createAxis(0, 3, breakpointCount), createAxis(0, 3, breakpointCount)}, f);
+		double maxError = 0;
+		for (double x = 0; x <= 3; x += 0.01)
+		{
+			for (double y = 0; y <= 3; y += 0.05)
+			{
+				double p[2] = {x, y};
+				maxError = std::max(maxError, std::abs(table.evaluate(p) - f(p)));
+			}
+		}
+		return maxError;
+	};
+
+	double coarseError = calcMaxError(10);
+	double fineError = calcMaxError(40);
+
+	// Linear interpolation error is bounded by h^2/8 * max second derivative, where h is the breakpoint spacing
+	auto errorBound = [] (int breakpointCount) {
+		double h = 3.0 / double(breakpointCount - 1);
+		return 2.0 * h * h / 8.0;
+	};
+	CHECK(coarseError < errorBound(10));
+	CHECK(fineError < errorBound(40));
+	CHECK(fineError < coarseError * 0.1);
+}
+
+TEST_CASE("Gridded table ignores axes with a single breakpoint")
+{
+	GriddedTable table({{0, 1}, {5}}, {1, 3});
+	double p[2] = {0.5, 100};
+	CHECK(table.evaluate(p) == Approx(2));
+}
+
+TEST_CASE("Benchmark table lookup", "[.][benchmark]")
+{
+	std::vector<double> axis = createAxis(-1, 1, 64);
+	std::vector<double> values(axis.size());
+	for (size_t i = 0; i < axis.size(); ++i)
+	{
+		values[i] = axis[i] * axis[i];
+	}
+
+	// Slowly varying inputs, as seen when evaluating once per simulation step
+	std::vector<double> inputs;
+	for (int i = 0; i < 1000; ++i)
+	{
+		inputs.push_back(0.95 * std::sin(double(i) * 0.01));
+	}
+
+	BENCHMARK("interpolateTableLinear")
+	{
+		double sum = 0;
+		for (double x : inputs)
+		{
+			sum += *interpolateTableLinear(axis, values, x, /* extrapolate */ false);
+		}
+		return sum;
+	};
+
+	GriddedTable table({axis}, values);
+	BENCHMARK("GriddedTable 1D binary search")
+	{
+		double sum = 0;
+		for (double x : inputs)
+		{
+			sum += table.evaluate(&x);
+		}
+		return sum;
+	};
+
+	BENCHMARK("GriddedTable 1D with cursor")
+	{
+		GriddedTableCursor cursor;
+		double sum = 0;
+		for (double x : inputs)
+		{
+			sum += table.evaluate(&x, cursor);
+		}
+		return sum;
+	};
+
+	// Typical aero coefficient table over mach, alpha, beta and control deflection
+	GriddedTable table4d = createTable({createAxis(0, 2, 10), createAxis(-0.5, 0.5, 30), createAxis(-0.3, 0.3, 10), createAxis(-1, 1, 7)},
+		[] (const double* p) { return p[0] + p[1] * p[2] + p[3]; });
+
+	BENCHMARK("GriddedTable 4D with cursor")
+	{
+		GriddedTableCursor cursor;
+		double sum = 0;
+		for (double x : inputs)
+		{
+			double p[4] = {1 + x, 0.5 * x, 0.3 * x, x};
+			sum += table4d.evaluate(p, cursor);
+		}
+		return sum;
+	};
+}
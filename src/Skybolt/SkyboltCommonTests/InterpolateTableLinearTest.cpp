@@ -65,3 +65,15 @@ TEST_CASE("findInterpolationPoint")
 		CHECK(point->weight == 0.25);
 	}
 }
+
+TEST_CASE("interpolateTableLinear")
+{
+	std::vector<double> xData = { 4, 5, 7 };
+	std::vector<double> yData = { 1, 3, -1 };
+
+	CHECK(!interpolateTableLinear({}, {}, 2, /* extrapolate */ true).has_value());
+	CHECK(*interpolateTableLinear(xData, yData, 4.5, /* extrapolate */ false) == 2);
+	CHECK(*interpolateTableLinear(xData, yData, 6, /* extrapolate */ false) == 1);
+	CHECK(*interpolateTableLinear(xData, yData, 8, /* extrapolate */ false) == -1);
+	CHECK(*interpolateTableLinear(xData, yData, 8, /* extrapolate */ true) == -3);
+}
@@ -0,0 +1,58 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/Registry.h>
+
+#include <string>
+
+using namespace skybolt;
+
+TEST_CASE("RegistryT version increases on insert, replace and erase")
+{
+	RegistryT<std::string, int> registry;
+	uint64_t version = registry.getVersion();
+
+	auto checkChanged = [&] {
+		CHECK(registry.getVersion() > version);
+		version = registry.getVersion();
+	};
+
+	registry["a"] = 1;
+	checkChanged();
+
+	// Replacing an item does not change the size, but must still be detected
+	registry["a"] = 2;
+	checkChanged();
+	CHECK(registry.size() == 1);
+
+	registry.insert({"b", 3});
+	checkChanged();
+
+	registry.insert_or_assign("b", 4);
+	checkChanged();
+
+	registry.emplace("c", 5);
+	checkChanged();
+
+	registry.try_emplace("d", 6);
+	checkChanged();
+
+	registry.erase("a");
+	checkChanged();
+
+	registry.erase(registry.begin());
+	checkChanged();
+
+	registry.clear();
+	checkChanged();
+	CHECK(registry.empty());
+
+	// Lookups do not change the version
+	registry.find("a");
+	registry.count("a");
+	CHECK(registry.getVersion() == version);
+}
@@ -0,0 +1,69 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/TripleBuffer.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace skybolt;
+
+TEST_CASE("TripleBuffer consumer receives most recently published value")
+{
+	TripleBuffer<int> buffer(0);
+	CHECK(!buffer.update());
+	CHECK(buffer.getReadBuffer() == 0);
+
+	buffer.getWriteBuffer() = 1;
+	buffer.publish();
+	buffer.getWriteBuffer() = 2;
+	buffer.publish();
+
+	CHECK(buffer.update());
+	CHECK(buffer.getReadBuffer() == 2);
+
+	// No new value published
+	CHECK(!buffer.update());
+	CHECK(buffer.getReadBuffer() == 2);
+}
+
+TEST_CASE("TripleBuffer hands off complete buffers between threads")
+{
+	constexpr int elementCount = 1000;
+	constexpr int publishCount = 10000;
+	TripleBuffer<std::vector<int>> buffer(std::vector<int>(elementCount, 0));
+
+	std::thread producer([&] {
+		for (int i = 1; i <= publishCount; ++i)
+		{
+			std::vector<int>& values = buffer.getWriteBuffer();
+			std::fill(values.begin(), values.end(), i);
+			buffer.publish();
+		}
+	});
+
+	int lastValue = 0;
+	bool torn = false;
+	bool decreased = false;
+	while (lastValue < publishCount)
+	{
+		if (buffer.update())
+		{
+			const std::vector<int>& values = buffer.getReadBuffer();
+			int value = values.front();
+			torn |= std::any_of(values.begin(), values.end(), [&](int v) { return v != value; });
+			decreased |= (value < lastValue);
+			lastValue = value;
+		}
+	}
+	producer.join();
+
+	CHECK(!torn);
+	CHECK(!decreased);
+	CHECK(lastValue == publishCount);
+}
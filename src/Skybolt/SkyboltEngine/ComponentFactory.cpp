@@ -36,6 +36,7 @@
 #include <SkyboltSim/Components/ReactionControlSystemComponent.h>
 #include <SkyboltSim/Components/RocketMotorComponent.h>
 #include <SkyboltSim/Components/ShipWakeComponent.h>
+#include <SkyboltSim/Components/WindComponent.h>
 #include <SkyboltVis/ElevationProvider/TilePlanetAltitudeProvider.h>
 #include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
 
@@ -73,11 +74,16 @@ static sim::ComponentPtr loadFuselage(Entity* entity, const ComponentFactoryCont
 
 	params.maxAutoTrimAngleOfAttack = readOptionalOrDefault(json, "maxAutoTrimAngleOfAttack", 0.5);
 
+	ifChildExists(json, "coefficientTables", [&] (const nlohmann::json& child) {
+		params.coefficientTables = std::make_shared<AeroCoefficientTables>(readAeroCoefficientTables(child));
+	});
+
 	FuselageComponentConfig config;
 	config.params = params;
 	config.node = entity->getFirstComponentRequired<Node>().get();
 	config.motion = entity->getFirstComponentRequired<Motion>().get();
 	config.body = entity->getFirstComponentRequired<DynamicBodyComponent>().get();
+	config.windField = context.windField;
 
 	auto inputs = entity->getFirstComponent<ControlInputsComponent>();
 	bool hasControlSurfaces = readOptionalOrDefault(json, "hasControlSurfaces", false);
@@ -355,26 +361,72 @@ static sim::ComponentPtr loadPlanetElevationTileSource(Entity* entity, const Com
 	return elevationComponent;
 }
 
+static sim::WindModelPtr readWindModel(const ComponentFactoryContext& context, const nlohmann::json& json)
+{
+	std::string type = json.at("type").get<std::string>();
+	if (type == "uniform")
+	{
+		return std::make_shared<UniformWindModel>(readVector3(json.at("velocityNed")));
+	}
+	else if (type == "gust")
+	{
+		GustWindModel::Params params;
+		params.startTime = json.at("startTime").get<double>();
+		params.duration = json.at("duration").get<double>();
+		params.peakVelocityNed = readVector3(json.at("peakVelocityNed"));
+		return std::make_shared<GustWindModel>(params);
+	}
+	else if (type == "turbulence")
+	{
+		TurbulenceWindModel::Params params;
+		params.rmsVelocity = readOptionalOrDefault(json, "rmsVelocity", params.rmsVelocity);
+		params.lengthScale = readOptionalOrDefault(json, "lengthScale", params.lengthScale);
+		params.modeCount = readOptionalOrDefault(json, "modeCount", params.modeCount);
+		params.seed = readOptionalOrDefault(json, "seed", params.seed);
+		return std::make_shared<TurbulenceWindModel>(params);
+	}
+	else if (type == "gridded")
+	{
+		file::Path filename = valueOrThrowException(context.fileLocator(json.at("file").get<std::string>()));
+		return readGriddedWindModel(filename);
+	}
+	throw std::runtime_error("Unknown wind model type: " + type);
+}
+
+static sim::ComponentPtr loadWind(Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json)
+{
+	std::vector<sim::WindModelPtr> models;
+	for (const auto& modelJson : json.at("models"))
+	{
+		models.push_back(readWindModel(context, modelJson));
+	}
+	return std::make_shared<WindComponent>(&context.simWorld->getWindField(), std::move(models));
+}
+
 void addDefaultFactories(ComponentFactoryRegistry& registry)
 {
-	registry["shipWake"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadShipWake);
+	// Factories that only create components from json and the entity's existing components are thread safe
+	constexpr bool threadSafe = true;
+
+	registry["shipWake"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadShipWake, threadSafe);
 	registry["attacher"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAttacher);
-	registry["attachmentPoint"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAttachmentPoint);
-	registry["assetDescription"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAssetDescription);
-	registry["camera"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadCamera);
+	registry["attachmentPoint"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAttachmentPoint, threadSafe);
+	registry["assetDescription"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAssetDescription, threadSafe);
+	registry["camera"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadCamera, threadSafe);
 	registry["cameraController"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadCameraController);
-	registry["controlInputs"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadControlInputs);
-	registry["dynamicBody"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadDynamicBody);
-	registry["fuselage"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadFuselage);
-	registry["mainRotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadMainRotor);
-	registry["motion"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadMotion);
-	registry["node"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadNode);
+	registry["controlInputs"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadControlInputs, threadSafe);
+	registry["dynamicBody"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadDynamicBody, threadSafe);
+	registry["fuselage"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadFuselage, threadSafe);
+	registry["mainRotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadMainRotor, threadSafe);
+	registry["motion"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadMotion, threadSafe);
+	registry["node"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadNode, threadSafe);
 	registry["planet"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadPlanet);
 	registry["planetElevationTileSource"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadPlanetElevationTileSource);
-	registry["reactionControlSystem"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadReactonControlSystem);
-	registry["rocketMotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadRocketMotor);
-	registry["scenarioMetadata"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadScenarioMetadata);
-	registry["tailRotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadTailRotor);
+	registry["reactionControlSystem"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadReactonControlSystem, threadSafe);
+	registry["rocketMotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadRocketMotor, threadSafe);
+	registry["scenarioMetadata"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadScenarioMetadata, threadSafe);
+	registry["tailRotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadTailRotor, threadSafe);
+	registry["wind"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadWind);
 }
 
 } // namespace skybolt
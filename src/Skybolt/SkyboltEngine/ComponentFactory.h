@@ -21,6 +21,7 @@ struct ComponentFactoryContext
 {
 	px_sched::Scheduler* scheduler;
 	sim::World* simWorld;
+	const sim::WindField* windField; //!< Wind field of simWorld. Thread safe factories may store this pointer but must not sample it.
 	EntityFactory const* entityFactory;
 	JulianDateProvider julianDateProvider;
 	EngineStats* stats;
@@ -35,6 +36,11 @@ public:
 
 	//! @return nullptr if component could not be created
 	virtual sim::ComponentPtr create(sim::Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) = 0;
+
+	//! @returns true if create() may be called concurrently for different entities.
+	//! Thread safe factories may only modify the entity they are creating a component for, and must not access the world or vis scene.
+	//! They may store the context's windField pointer in the component, for use in later sim updates.
+	virtual bool isThreadSafe() const { return false; }
 };
 
 class ComponentFactoryFunctionAdapter : public ComponentFactory
@@ -42,15 +48,18 @@ class ComponentFactoryFunctionAdapter : public ComponentFactory
 public:
 	typedef std::function<sim::ComponentPtr(sim::Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json)> Function;
 	
-	ComponentFactoryFunctionAdapter(Function fn) : mFunction(fn) {}
+	ComponentFactoryFunctionAdapter(Function fn, bool threadSafe = false) : mFunction(fn), mThreadSafe(threadSafe) {}
 
 	sim::ComponentPtr create(sim::Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) override
 	{
 		return mFunction(entity, context, json);
 	}
 
+	bool isThreadSafe() const override { return mThreadSafe; }
+
 private:
 	Function mFunction;
+	bool mThreadSafe;
 };
 
 typedef RegistryT<std::string, ComponentFactoryPtr> ComponentFactoryRegistry;
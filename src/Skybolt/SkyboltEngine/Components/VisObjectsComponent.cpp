@@ -5,6 +5,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "VisObjectsComponent.h"
+#include "SkyboltEngine/SimVisBinding/VisObjectAttachmentQueue.h"
 #include "SkyboltVis/Scene.h"
 
 namespace skybolt {
@@ -13,6 +14,10 @@ VisObjectsComponent::~VisObjectsComponent()
 {
 	for (const vis::VisObjectPtr& object : objects)
 	{
+		if (attachmentQueue)
+		{
+			attachmentQueue->remove(object);
+		}
 		scene->removeObject(object);
 	}
 }
@@ -21,7 +26,14 @@ void VisObjectsComponent::addObject(const vis::VisObjectPtr& object, bool addToS
 {
 	if (addToScene)
 	{
-		scene->addObject(object);
+		if (attachmentQueue)
+		{
+			attachmentQueue->push(object);
+		}
+		else
+		{
+			scene->addObject(object);
+		}
 	}
 	objects.push_back(object);
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "SkyboltEngine/SkyboltEngineFwd.h"
 #include <SkyboltSim/Component.h>
 #include <SkyboltSim/Entity.h>
 #include <SkyboltVis/VisObject.h>
@@ -17,7 +18,8 @@ namespace skybolt {
 class VisObjectsComponent : public sim::Component
 {
 public:
-	VisObjectsComponent(vis::Scene* scene) : scene(scene) {}
+	//! @param attachmentQueue is used to defer adding objects to the scene. If null, objects are added immediately.
+	VisObjectsComponent(vis::Scene* scene, VisObjectAttachmentQueue* attachmentQueue = nullptr) : scene(scene), attachmentQueue(attachmentQueue) {}
 	~VisObjectsComponent();
 
 	void addObject(const vis::VisObjectPtr& object, bool addToScene = true);
@@ -27,6 +29,7 @@ public:
 private:
 	std::vector<vis::VisObjectPtr> objects;
 	vis::Scene* scene;
+	VisObjectAttachmentQueue* attachmentQueue;
 };
 
 template <class T>
@@ -7,13 +7,16 @@
 #include "EngineRoot.h"
 #include "ComponentFactory.h"
 #include "SimVisBinding/SimVisSystem.h"
+#include "SimVisBinding/VisObjectAttachmentQueue.h"
 #include <SkyboltSim/System/EntitySystem.h>
+#include <SkyboltSim/System/WindSystem.h>
 #include <SkyboltSim/World.h>
 #include <SkyboltVis/OsgStateSetHelpers.h>
 #include <SkyboltVis/Scene.h>
 #include <SkyboltVis/TextureCache.h>
 #include <SkyboltVis/Renderable/Model/ModelFactory.h>
 #include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
+#include <SkyboltCommon/File/AssetIndex.h>
 #include <SkyboltCommon/File/FileUtility.h>
 #include <SkyboltCommon/File/OsDirectories.h>
 #include <SkyboltCommon/Json/JsonHelpers.h>
@@ -22,6 +25,7 @@
 #define PX_SCHED_IMPLEMENTATION 1
 #include <px_sched/px_sched.h>
 
+#include <osgDB/Callbacks>
 #include <osgDB/Registry>
 #include <boost/algorithm/string.hpp>
 #include <boost/log/trivial.hpp>
@@ -44,15 +48,44 @@ Expected<file::Path> locateFile(const std::string& filename)
 	return resolvedFilename;
 };
 
+//! Resolves osgDB data file lookups through the AssetIndex, falling back to osgDB's search path probing for files that are not indexed
+class AssetIndexFindFileCallback : public osgDB::FindFileCallback
+{
+public:
+	AssetIndexFindFileCallback(const std::shared_ptr<const file::AssetIndex>& index) :
+		mIndex(index)
+	{
+		assert(mIndex);
+	}
+
+	std::string findDataFile(const std::string& filename, const osgDB::Options* options, osgDB::CaseSensitivity caseSensitivity) override
+	{
+		// Lookups relative to the options' database paths, e.g. textures relative to a model, take precedence over asset packages
+		bool hasDatabasePaths = options && !options->getDatabasePathList().empty();
+		if (caseSensitivity == osgDB::CASE_SENSITIVE && !hasDatabasePaths)
+		{
+			if (auto path = mIndex->find(filename); path)
+			{
+				return path->string();
+			}
+		}
+		return osgDB::Registry::instance()->findDataFileImplementation(filename, options, caseSensitivity);
+	}
+
+private:
+	std::shared_ptr<const file::AssetIndex> mIndex;
+};
+
 static std::vector<std::string> transparentMaterialNames() { return { "transparentExt", "transparent" }; } //@deprecated. Set osg::Material diffuse alpha < 1 instead to treat geometry as transparent.
 
-static vis::ModelFactoryPtr createModelFactory(const vis::ShaderPrograms& programs)
+static vis::ModelFactoryPtr createModelFactory(const vis::ShaderPrograms& programs, px_sched::Scheduler* scheduler)
 {
 	osg::ref_ptr<osg::Program> glassProgram = programs.getRequiredProgram("glass");
 
 	vis::ModelFactoryConfig config;
 	config.defaultProgram = programs.getRequiredProgram("model");
 	config.glassProgram = glassProgram;
+	config.scheduler = scheduler;
 	for (const std::string& name : transparentMaterialNames())
 	{
 		config.stateSetModifiers[name] = [=](osg::StateSet& stateSet, const osg::Material& material) {
@@ -109,7 +142,7 @@ static file::Path getDefaultCacheDir()
 	return file::getAppUserDataDirectory("Skybolt") / "Cache";
 }
 
-static file::Path getCacheDir()
+file::Path getCacheDir()
 {
 	if (const char* dir = std::getenv(skyboltCacheDirEnvironmentVariable.c_str()); dir)
 	{
@@ -164,6 +197,23 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 		}
 	}
 
+	// Index asset packages so that files can be located without probing every package directory
+	assetIndex = std::make_shared<file::AssetIndex>(file::Paths(mAssetPackagePaths.begin(), mAssetPackagePaths.end()), getCacheDir() / "AssetIndex");
+	osgDB::Registry::instance()->setFindFileCallback(new AssetIndexFindFileCallback(assetIndex));
+	fileLocator = [index = assetIndex] (const std::string& filename) -> Expected<file::Path> {
+		if (auto path = index->find(filename); path)
+		{
+			return *path;
+		}
+		return locateFile(filename);
+	};
+
+	{
+		file::AssetIndexStats stats = assetIndex->getStats();
+		BOOST_LOG_TRIVIAL(info) << "Indexed " << stats.fileCount << " asset files in " << stats.packageCount << " packages in "
+			<< stats.buildTimeSeconds << "s (" << stats.packagesLoadedFromCacheCount << " packages loaded from cache)";
+	}
+
 	if (!requiredPackages.empty())
 	{
 		std::string packagesString = boost::algorithm::join(requiredPackages, ", ");
@@ -176,6 +226,7 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 		programs = vis::createShaderPrograms();
 	}
 	scene.reset(new vis::Scene(new osg::StateSet()));
+	visObjectAttachmentQueue = std::make_unique<VisObjectAttachmentQueue>(scene.get());
 
 	auto julianDateProvider = [scenario = scenario.get()]() {
 		return getCurrentJulianDate(*scenario);
@@ -207,7 +258,7 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 	context.julianDateProvider = julianDateProvider;
 	context.stats = &stats;
 	context.tileSourceFactoryRegistry = tileSourceFactoryRegistry;
-	context.fileLocator = locateFile;
+	context.fileLocator = fileLocator;
 	context.assetPackagePaths = mAssetPackagePaths;
 	context.engineSettings = engineSettings;
 
@@ -218,8 +269,9 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 			c.scene = scene.get();
 			c.programs = &programs;
 			c.visFactoryRegistry = visFactoryRegistry;
-			c.modelFactory = createModelFactory(programs);
+			c.modelFactory = createModelFactory(programs, scheduler.get());
 			c.textureCache = std::make_shared<vis::TextureCache>();
+			c.attachmentQueue = visObjectAttachmentQueue.get();
 			return c;
 		}();
 	}
@@ -228,16 +280,27 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 	entityFactory.reset(new EntityFactory(context, paths));
 
 	// Create default systems
+	auto simVisSystem = std::make_shared<SimVisSystem>(&scenario->world, scene);
+	simVisSystem->setVisObjectAttachmentQueue(visObjectAttachmentQueue.get());
+
 	systemRegistry = std::make_shared<sim::SystemRegistry>(sim::SystemRegistry({
 		std::make_shared<sim::EntitySystem>(&scenario->world),
-		std::make_shared<SimVisSystem>(&scenario->world, scene)
+		std::make_shared<sim::WindSystem>(&scenario->world.getWindField()),
+		simVisSystem
 	}));
+
+	stepAdvancer = std::make_unique<FixedStepAdvancer>(systemRegistry, scenario.get());
 }
 
 EngineRoot::~EngineRoot()
 {
 	// shutdown all systems first
 	systemRegistry->clear();
+
+	osgDB::Registry::instance()->setFindFileCallback(nullptr);
+
+	file::AssetIndexStats stats = assetIndex->getStats();
+	BOOST_LOG_TRIVIAL(info) << "Asset index resolved " << stats.hitCount << " of " << stats.lookupCount << " lookups, avoiding " << stats.avoidedProbeCount << " file probes";
 }
 
 void EngineRoot::loadPlugins(const std::vector<PluginFactory>& pluginFactories)
@@ -11,10 +11,12 @@
 #include "FactoryRegistries.h"
 #include "Scenario/Scenario.h"
 #include "Plugin/Plugin.h"
+#include "UpdateLoop/FixedStepAdvancer.h"
 #include <SkyboltReflect/SkyboltReflectFwd.h>
 #include <SkyboltSim/System/SystemRegistry.h>
 #include <SkyboltVis/Shader/ShaderProgramRegistry.h>
 #include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
+#include <SkyboltCommon/File/AssetIndex.h>
 #include <SkyboltCommon/File/FileUtility.h>
 
 #include <memory>
@@ -48,18 +50,25 @@ public:
 	std::unique_ptr<px_sched::Scheduler> scheduler;
 	vis::ShaderPrograms programs;
 	vis::ScenePtr scene;
-	file::FileLocator fileLocator;
+	std::unique_ptr<VisObjectAttachmentQueue> visObjectAttachmentQueue; //!< Attaches vis objects of entities created in bulk to the scene over multiple frames
+	std::shared_ptr<file::AssetIndex> assetIndex;
+	file::FileLocator fileLocator; //!< Locates files using assetIndex, falling back to osgDB data file paths
 	std::unique_ptr<EntityFactory> entityFactory;
 	vis::JsonTileSourceFactoryRegistryPtr tileSourceFactoryRegistry;
 	EngineStats stats;
 	std::unique_ptr<Scenario> scenario;
 	sim::SystemRegistryPtr systemRegistry;
+	std::unique_ptr<FixedStepAdvancer> stepAdvancer; //!< Persistent stepper used to advance the simulation from scripts
 	std::unique_ptr<refl::TypeRegistry> typeRegistry;
 	std::unique_ptr<FactoryRegistries> factoryRegistries;
 	nlohmann::json engineSettings;
 };
 
 Expected<file::Path> locateFile(const std::string& filename);
+
+//! @returns the directory in which cached data such as tile images are stored.
+//! This is given by the SKYBOLT_CACHE_DIR environment variable if set to a valid path, otherwise a directory in the user's app data.
+file::Path getCacheDir();
 file::Paths getPathsInAssetPackages(const std::vector<std::string>& assetPackagePaths, const std::string& relativePath);
 file::Paths getFilesWithExtensionInDirectoryInAssetPackages(const std::vector<std::string>& assetPackagePaths, const std::string& relativeDirectory, const std::string& extension);
 
@@ -34,6 +34,12 @@ nlohmann::json createDefaultEngineSettings()
 	},
 	"clouds": {
 		"enableTemporalUpscaling": true
+	},
+	"tilePrefetch": {
+		"enabled": false,
+		"horizonSeconds": 20.0,
+		"sampleCount": 4,
+		"minSampleSeparation": 200.0
 	}
 })"_json;
 }
@@ -93,4 +99,21 @@ vis::CloudRenderingParams getCloudRenderingParams(const nlohmann::json& engineSe
 	return params;
 }
 
+std::optional<TrajectorySamplingConfig> getTilePrefetchSamplingConfig(const nlohmann::json& engineSettings)
+{
+	auto i = engineSettings.find("tilePrefetch");
+	if (i != engineSettings.end())
+	{
+		if (readOptionalOrDefault<bool>(i.value(), "enabled", false))
+		{
+			TrajectorySamplingConfig config;
+			readOptionalToVar(i.value(), "horizonSeconds", config.horizonSeconds);
+			readOptionalToVar(i.value(), "sampleCount", config.sampleCount);
+			readOptionalToVar(i.value(), "minSampleSeparation", config.minSampleSeparation);
+			return config;
+		}
+	}
+	return std::nullopt;
+}
+
 } // namespace skybolt
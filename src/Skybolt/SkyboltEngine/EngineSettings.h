@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "SkyboltEngine/SimVisBinding/TilePrefetchBinding.h"
 #include <SkyboltVis/DisplaySettings.h>
 #include <SkyboltVis/Renderable/Clouds/CloudRenderingParams.h>
 #include <SkyboltVis/Shadow/ShadowParams.h>
@@ -23,4 +24,7 @@ vis::DisplaySettings getDisplaySettingsFromEngineSettings(const nlohmann::json&
 std::optional<vis::ShadowParams> getShadowParams(const nlohmann::json& engineSettings);
 vis::CloudRenderingParams getCloudRenderingParams(const nlohmann::json& engineSettings);
 
+//! @returns config for prefetching planet tiles along the camera's predicted path, or nullopt if prefetching is disabled
+std::optional<TrajectorySamplingConfig> getTilePrefetchSamplingConfig(const nlohmann::json& engineSettings);
+
 } // namespace skybolt
@@ -13,6 +13,8 @@ struct EngineStats
 {
 	size_t terrainTileLoadQueueSize = 0;
 	size_t featureTileLoadQueueSize = 0;
+	size_t terrainPrefetchHitCount = 0; //!< Number of visible terrain tile loads satisfied by prefetching
+	size_t terrainPrefetchMissCount = 0; //!< Number of visible terrain tile loads not satisfied by prefetching
 };
 
 } // namespace skybolt
\ No newline at end of file
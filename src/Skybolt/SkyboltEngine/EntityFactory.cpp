@@ -8,6 +8,7 @@
 #include "EngineRoot.h"
 #include "EngineSettings.h"
 #include "EngineStats.h"
+#include "SchedulerUtility.h"
 #include "Components/PlanetElevationComponent.h"
 #include "Components/TemplateNameComponent.h"
 #include "Components/VisObjectsComponent.h"
@@ -20,6 +21,8 @@
 #include "SimVisBinding/ParticlesVisBinding.h"
 #include "SimVisBinding/PlanetVisBinding.h"
 #include "SimVisBinding/PolylineVisBinding.h"
+#include "SimVisBinding/TilePrefetchBinding.h"
+#include "SimVisBinding/VisObjectAttachmentQueue.h"
 #include "SimVisBinding/WakeBinding.h"
 
 #include <SkyboltSim/JsonHelpers.h>
@@ -76,6 +79,9 @@
 #include <osgDB/ReadFile>
 #include <osgDB/Registry>
 
+#include <boost/log/trivial.hpp>
+#include <set>
+
 using namespace skybolt;
 using namespace skybolt::sim;
 
@@ -232,7 +238,7 @@ static vis::ModelPtr createVisualModel(const nlohmann::json& json, vis::ModelFac
 	std::string filename = json.at("model").get<std::string>();
 	std::vector<vis::ModelFactory::TextureRole> textureRoles = readTextureRoles(json);
 	vis::ModelConfig config;
-	config.node = factory.createModel(filename, textureRoles);
+	config.node = factory.createModelAsync(filename, textureRoles);
 
 	registerAssetSearchDirectory(getParentDirectory(filename));
 
@@ -309,6 +315,7 @@ static void loadParticleSystem(Entity* entity, const EntityFactory::Context& con
 	integratorParams.atmosphericSlowdownFactor = json.at("atmosphericSlowdownFactor");
 	integratorParams.heatTransferCoefficent = readOptional<float>(json, "heatTransferCoefficent");
 	integratorParams.nearestPlanetProvider = nearestPlanetProvider;
+	integratorParams.windField = &context.simWorld->getWindField();
 
 	auto particleSystem = std::make_shared<ParticleSystem>(ParticleSystem::Operations({
 		std::make_shared<ParticleIntegrator>(integratorParams), // integrate before emission ensure new particles emitted at end of time step
@@ -480,6 +487,7 @@ static void loadVisualPlanet(Entity* entity, const EntityFactory::Context& conte
 			atmosphereConfig.mieSingleScatteringAlbedo = atmosphere.at("mieSingleScatteringAlbedo").get<double>();
 			atmosphereConfig.miePhaseFunctionG = atmosphere.at("miePhaseFunctionG").get<double>();
 			atmosphereConfig.useEarthOzone = readOptionalOrDefault<bool>(atmosphere, "useEarthOzone", false);
+			atmosphereConfig.cacheDirectory = (getCacheDir() / "Atmosphere").string();
 
 			config.atmosphereConfig = atmosphereConfig;
 		}
@@ -573,7 +581,7 @@ static void loadVisualPlanet(Entity* entity, const EntityFactory::Context& conte
 	vis::PlanetPtr visObject(new vis::Planet(config));
 	visObjectsComponent->addObject(visObject);
 
-	SimVisBindingPtr simVis(std::make_shared<PlanetVisBinding>(context.julianDateProvider, entity, visObject));
+	SimVisBindingPtr simVis(std::make_shared<PlanetVisBinding>(context.julianDateProvider, entity, visObject, &context.simWorld->getWindField()));
 	simVisBindingComponent->bindings.push_back(simVis);
 
 	if (const osg::ref_ptr<vis::WaterMaterial>& waterMaterial = visObject->getWaterMaterial(); waterMaterial)
@@ -587,10 +595,54 @@ static void loadVisualPlanet(Entity* entity, const EntityFactory::Context& conte
 
 	std::shared_ptr<PlanetStatsUpdater> statsUpdater = std::make_shared<PlanetStatsUpdater>(context.stats, static_cast<vis::Planet*>(visObject.get()));
 	entity->addComponent(statsUpdater);
+
+	if (auto prefetchConfig = getTilePrefetchSamplingConfig(context.engineSettings); prefetchConfig)
+	{
+		// Prefetch tiles along the path of the first camera, predicted from its current velocity
+		ObserverProvider observerProvider = createFirstCameraObserverProvider(context.simWorld);
+		auto binding = std::make_shared<TilePrefetchBinding>(observerProvider, visObject, std::vector<ObserverPositionPredictor>({createVelocityExtrapolationPredictor(observerProvider)}),
+			*prefetchConfig, context.stats);
+		simVisBindingComponent->bindings.push_back(binding);
+	}
 }
 
 using VisComponentLoader = std::function<void(Entity*, const EntityFactory::Context&, const EntityFactory::VisContext&, VisObjectsComponentPtr&, const SimVisBindingsComponentPtr&, const nlohmann::json&)>;
 
+static const std::map<std::string, VisComponentLoader>& getVisComponentLoaders()
+{
+	static std::map<std::string, VisComponentLoader> visComponentLoaders =
+	{
+		{ "camera", loadVisualCamera },
+		{ "particleSystem", loadParticleSystem },
+		{ "visualModel", loadVisualModel },
+		{ "visualMainRotor", loadVisualMainRotor },
+		{ "visualTailRotor", loadVisualTailRotor },
+		{ "visualPlanet", loadVisualPlanet }
+	};
+	return visComponentLoaders;
+}
+
+namespace skybolt {
+
+//! Sequence of component factory calls resolved from an entity template's json,
+//! allowing entities to be created without searching factory registries for each component.
+struct EntityComponentPlan
+{
+	struct Step
+	{
+		const nlohmann::json* content;
+		ComponentFactoryPtr componentFactory; //!< May be null
+		const VisComponentLoader* visComponentLoader; //!< May be null
+	};
+
+	std::shared_ptr<const nlohmann::json> json; //!< Owns the json referenced by the steps. May be null if json is owned elsewhere.
+	std::vector<Step> steps;
+	size_t threadSafeStepCount; //!< Number of leading steps that only use thread safe component factories and can run concurrently for different entities
+	uint64_t componentFactoryRegistryVersion; //!< Version of the component factory registry when the plan was compiled, used to detect changes to the registry
+};
+
+} // namespace skybolt
+
 const ScenarioObjectPath& skybolt::getDefaultEntityScenarioObjectDirectory()
 {
 	static ScenarioObjectPath d = {"Platforms"};
@@ -606,92 +658,139 @@ static std::shared_ptr<ScenarioMetadataComponent> createDefaultEntityScenarioMet
 
 EntityPtr EntityFactory::createEntityFromJson(const nlohmann::json& json, const std::string& templateName, const std::string& instanceName, const Vector3& position, const Quaternion& orientation, EntityId id) const
 {
-	EntityPtr entity = std::make_shared<sim::Entity>((id != nullEntityId()) ? id : generateNextEntityId());
-
-	// Create required components
-	entity->addComponent(std::make_shared<NameComponent>(instanceName));
-	entity->addComponent(std::make_shared<TemplateNameComponent>(templateName));
-
-	VisObjectsComponentPtr visObjectsComponent;
-	SimVisBindingsComponentPtr simVisBindingComponent;
-	if (mContext.visContext)
-	{
-		visObjectsComponent = std::make_shared<VisObjectsComponent>(mContext.visContext->scene);
-		entity->addComponent(visObjectsComponent);
-
-		simVisBindingComponent = std::make_shared<SimVisBindingsComponent>();
-		entity->addComponent(simVisBindingComponent);
+	return createEntityFromPlan(compileComponentPlan(json), templateName, instanceName, position, orientation, id);
 }
 
-	// Create additional components from json
-	ComponentFactoryContext componentFactoryContext;
-	componentFactoryContext.julianDateProvider = mContext.julianDateProvider;
-	componentFactoryContext.scheduler = mContext.scheduler;
-	componentFactoryContext.simWorld = mContext.simWorld;
-	componentFactoryContext.entityFactory = this;
-	componentFactoryContext.stats = mContext.stats;
-	componentFactoryContext.tileSourceFactoryRegistry = mContext.tileSourceFactoryRegistry;
-	componentFactoryContext.fileLocator = mContext.fileLocator;
+EntityComponentPlan EntityFactory::compileComponentPlan(const nlohmann::json& json) const
+{
+	EntityComponentPlan plan;
+	plan.componentFactoryRegistryVersion = mContext.componentFactoryRegistry->getVersion();
 
 	const nlohmann::json& components = json.at("components");
 	for (const auto& component : components)
 	{
 		for (nlohmann::json::const_iterator componentIt = component.begin(); componentIt != component.end(); ++componentIt)
 		{
-			std::string key = componentIt.key();
-			const nlohmann::json& content = componentIt.value();
-			
+			const std::string& key = componentIt.key();
+
+			EntityComponentPlan::Step step;
+			step.content = &componentIt.value();
+
 			// Sim components
-			{
-				auto it = mContext.componentFactoryRegistry->find(key);
-				if (it != mContext.componentFactoryRegistry->end())
-				{
-					ComponentFactoryPtr factory = it->second;
-					auto newComponent = factory->create(entity.get(), componentFactoryContext, content);
-					if (newComponent)
-					{
-						entity->addComponent(newComponent);
-					}
-				}
-			}
+			auto it = mContext.componentFactoryRegistry->find(key);
+			step.componentFactory = (it != mContext.componentFactoryRegistry->end()) ? it->second : nullptr;
+
 			// Vis components
+			step.visComponentLoader = nullptr;
 			if (mContext.visContext)
 			{
-				static std::map<std::string, VisComponentLoader> visComponentLoaders =
-				{
-					{ "camera", loadVisualCamera },
-					{ "particleSystem", loadParticleSystem },
-					{ "visualModel", loadVisualModel },
-					{ "visualMainRotor", loadVisualMainRotor },
-					{ "visualTailRotor", loadVisualTailRotor },
-					{ "visualPlanet", loadVisualPlanet }
-				};
-
-				auto it = visComponentLoaders.find(key);
-				if (it != visComponentLoaders.end())
+				const auto& visComponentLoaders = getVisComponentLoaders();
+				if (auto it = visComponentLoaders.find(key); it != visComponentLoaders.end())
 				{
-					assert(visObjectsComponent);
-					assert(simVisBindingComponent);
-					it->second(entity.get(), mContext, *mContext.visContext, visObjectsComponent, simVisBindingComponent, content);
+					step.visComponentLoader = &it->second;
 				}
 			}
+
+			if (step.componentFactory || step.visComponentLoader)
+			{
+				plan.steps.push_back(step);
+			}
 		}
 	}
 
+	auto firstUnsafeStep = std::find_if(plan.steps.begin(), plan.steps.end(), [] (const EntityComponentPlan::Step& step) {
+		return step.visComponentLoader || !step.componentFactory->isThreadSafe();
+	});
+	plan.threadSafeStepCount = std::distance(plan.steps.begin(), firstUnsafeStep);
+	return plan;
+}
+
+EntityPtr EntityFactory::createEntityFromPlan(const EntityComponentPlan& plan, const std::string& templateName, const std::string& instanceName, const Vector3& position, const Quaternion& orientation, EntityId id) const
+{
+	EntityPtr entity = createEntityWithRequiredComponents(templateName, instanceName, (id != nullEntityId()) ? id : generateNextEntityId(), nullptr);
+	runComponentPlanSteps(plan, 0, plan.steps.size(), *entity);
+	finishEntity(*entity, position, orientation);
+	return entity;
+}
+
+EntityPtr EntityFactory::createEntityWithRequiredComponents(const std::string& templateName, const std::string& instanceName, EntityId id, VisObjectAttachmentQueue* attachmentQueue) const
+{
+	EntityPtr entity = std::make_shared<sim::Entity>(id);
+
+	entity->addComponent(std::make_shared<NameComponent>(instanceName));
+	entity->addComponent(std::make_shared<TemplateNameComponent>(templateName));
+
+	if (mContext.visContext)
+	{
+		entity->addComponent(std::make_shared<VisObjectsComponent>(mContext.visContext->scene, attachmentQueue));
+		entity->addComponent(std::make_shared<SimVisBindingsComponent>());
+	}
+	return entity;
+}
+
+void EntityFactory::runComponentPlanSteps(const EntityComponentPlan& plan, size_t begin, size_t end, sim::Entity& entity) const
+{
+	ComponentFactoryContext componentFactoryContext = createComponentFactoryContext();
+
+	VisObjectsComponentPtr visObjectsComponent;
+	SimVisBindingsComponentPtr simVisBindingComponent;
+	if (mContext.visContext)
+	{
+		visObjectsComponent = entity.getFirstComponent<VisObjectsComponent>();
+		simVisBindingComponent = entity.getFirstComponent<SimVisBindingsComponent>();
+	}
+
+	for (size_t i = begin; i < end; ++i)
+	{
+		const EntityComponentPlan::Step& step = plan.steps[i];
+
+		// Sim components
+		if (step.componentFactory)
+		{
+			auto newComponent = step.componentFactory->create(&entity, componentFactoryContext, *step.content);
+			if (newComponent)
+			{
+				entity.addComponent(newComponent);
+			}
+		}
+		// Vis components
+		if (step.visComponentLoader)
+		{
+			assert(visObjectsComponent);
+			assert(simVisBindingComponent);
+			(*step.visComponentLoader)(&entity, mContext, *mContext.visContext, visObjectsComponent, simVisBindingComponent, *step.content);
+		}
+	}
+}
+
+void EntityFactory::finishEntity(sim::Entity& entity, const Vector3& position, const Quaternion& orientation) const
+{
 	// Add default ScenarioMetadataComponent if one wasn't in the json file
-	if (!entity->getFirstComponent<ScenarioMetadataComponent>())
+	if (!entity.getFirstComponent<ScenarioMetadataComponent>())
 	{
-		entity->addComponent(createDefaultEntityScenarioMetadataComponent());
+		entity.addComponent(createDefaultEntityScenarioMetadataComponent());
 	}
 
 	// Initialise entity pose
-	if (Node* node = entity->getFirstComponent<Node>().get(); node)
+	if (Node* node = entity.getFirstComponent<Node>().get(); node)
 	{
 		node->setPosition(position);
 		node->setOrientation(orientation);
 	}
+}
 
-	return entity;
+ComponentFactoryContext EntityFactory::createComponentFactoryContext() const
+{
+	ComponentFactoryContext context;
+	context.julianDateProvider = mContext.julianDateProvider;
+	context.scheduler = mContext.scheduler;
+	context.simWorld = mContext.simWorld;
+	context.windField = mContext.simWorld ? &mContext.simWorld->getWindField() : nullptr;
+	context.entityFactory = this;
+	context.stats = mContext.stats;
+	context.tileSourceFactoryRegistry = mContext.tileSourceFactoryRegistry;
+	context.fileLocator = mContext.fileLocator;
+	return context;
 }
 
 static ScenarioObjectPath readScenarioObjectDirectory(const nlohmann::json& json)
@@ -716,11 +815,9 @@ EntityFactory::EntityFactory(const EntityFactory::Context& context, const std::v
 	mContext(context)
 {
 	assert(context.julianDateProvider);
-	assert(context.programs);
 	assert(context.simWorld);
 	assert(context.stats);
 	assert(context.tileSourceFactoryRegistry);
-	assert(context.scene);
 
 	if (context.visContext)
 	{
@@ -734,29 +831,110 @@ EntityFactory::EntityFactory(const EntityFactory::Context& context, const std::v
 	for (const std::filesystem::path& filename : entityFilenames)
 	{
 		std::string name = filename.stem().string();
-		nlohmann::json json = readJsonFile(filename.string());
-		mTemplateJsonMap[name] = json;
+		mTemplateCache[name].filename = filename;
 		mTemplateNames.push_back(name);
-		mTemplateDirectories[name] = readScenarioObjectDirectory(json);
 	}
 }
 
-EntityPtr EntityFactory::createEntity(const std::string& templateName, const std::string& nameIn, const Vector3& position, const Quaternion& orientation, EntityId id) const
+EntityFactory::~EntityFactory() = default;
+
+EntityFactory::TemplateCacheEntry& EntityFactory::getLoadedTemplate(const std::string& templateName) const
 {
+	auto i = mTemplateCache.find(templateName);
+	if (i == mTemplateCache.end())
 	{
-		auto i = mTemplateJsonMap.find(templateName);
-		if (i != mTemplateJsonMap.end())
+		throw std::runtime_error("Invalid templateName: " + templateName);
+	}
+
+	TemplateCacheEntry& entry = i->second;
+	if (!entry.json)
+	{
+		auto json = std::make_shared<nlohmann::json>(readJsonFile(entry.filename.string()));
+		entry.scenarioObjectDirectory = readScenarioObjectDirectory(*json);
+		entry.json = json;
+	}
+	return entry;
+}
+
+const nlohmann::json& EntityFactory::getTemplateJson(const std::string& templateName) const
+{
+	std::scoped_lock<std::mutex> lock(mTemplateCacheMutex);
+	return *getLoadedTemplate(templateName).json;
+}
+
+std::shared_ptr<const EntityComponentPlan> EntityFactory::getTemplatePlan(const std::string& templateName) const
+{
+	std::scoped_lock<std::mutex> lock(mTemplateCacheMutex);
+	TemplateCacheEntry& entry = getLoadedTemplate(templateName);
+	if (!entry.plan || entry.plan->componentFactoryRegistryVersion != mContext.componentFactoryRegistry->getVersion())
+	{
+		auto plan = std::make_shared<EntityComponentPlan>(compileComponentPlan(*entry.json));
+		plan->json = entry.json;
+		entry.plan = plan;
+	}
+	return entry.plan;
+}
+
+void EntityFactory::prefetchModels(const std::vector<std::string>& templateNames) const
+{
+	if (!mContext.visContext)
+	{
+		return;
+	}
+
+	static const std::set<std::string> modelComponentNames = { "visualModel", "visualMainRotor", "visualTailRotor" };
+
+	for (const std::string& templateName : templateNames)
+	{
+		if (mTemplateCache.find(templateName) == mTemplateCache.end())
 		{
-			std::string instanceName = nameIn.empty() ? createUniqueObjectName(templateName) : nameIn;
-			try
-			{
-				return createEntityFromJson(i->second, templateName, instanceName, position, orientation, id);
-			}
-			catch (const std::exception& e)
+			continue;
+		}
+
+		try
+		{
+			const nlohmann::json& json = getTemplateJson(templateName);
+			for (const auto& component : json.at("components"))
 			{
-				throw Exception("Error loading '" + templateName + "': " + e.what());
+				for (const auto& [key, content] : component.items())
+				{
+					if (modelComponentNames.find(key) != modelComponentNames.end())
+					{
+						mContext.visContext->modelFactory->prefetchModel(content.at("model").get<std::string>(), readTextureRoles(content));
+					}
+				}
 			}
 		}
+		catch (const std::exception& e)
+		{
+			BOOST_LOG_TRIVIAL(warning) << "Could not prefetch models for template '" << templateName << "': " << e.what();
+		}
+	}
+}
+
+void EntityFactory::invalidateTemplatePlans()
+{
+	std::scoped_lock<std::mutex> lock(mTemplateCacheMutex);
+	for (auto& [name, entry] : mTemplateCache)
+	{
+		entry.plan = nullptr;
+	}
+}
+
+EntityPtr EntityFactory::createEntity(const std::string& templateName, const std::string& nameIn, const Vector3& position, const Quaternion& orientation, EntityId id) const
+{
+	if (mTemplateCache.find(templateName) != mTemplateCache.end())
+	{
+		std::string instanceName = nameIn.empty() ? createUniqueObjectName(templateName) : nameIn;
+		try
+		{
+			std::shared_ptr<const EntityComponentPlan> plan = getTemplatePlan(templateName);
+			return createEntityFromPlan(*plan, templateName, instanceName, position, orientation, id);
+		}
+		catch (const std::exception& e)
+		{
+			throw Exception("Error loading '" + templateName + "': " + e.what());
+		}
 	}
 
 	// Try builtin types
@@ -771,6 +949,90 @@ EntityPtr EntityFactory::createEntity(const std::string& templateName, const std
 	throw std::runtime_error("Invalid templateName: " + templateName);
 }
 
+//! Number of entities created by each task. Entities are batched to amortize task overhead.
+constexpr size_t entitiesPerSpawnTask = 32;
+
+std::vector<EntityPtr> EntityFactory::createEntities(const std::vector<EntitySpawnRequest>& requests) const
+{
+	struct PendingEntity
+	{
+		const EntitySpawnRequest* request;
+		std::shared_ptr<const EntityComponentPlan> plan; //!< Null if entity is created from a builtin template
+		std::string instanceName;
+		EntityId id;
+		EntityPtr entity;
+	};
+
+	VisObjectAttachmentQueue* attachmentQueue = mContext.visContext ? mContext.visContext->attachmentQueue : nullptr;
+
+	// Resolve plans, names and ids on the calling thread because they use factory state that is not thread safe
+	std::vector<PendingEntity> pending;
+	pending.reserve(requests.size());
+	for (const EntitySpawnRequest& request : requests)
+	{
+		PendingEntity& p = pending.emplace_back();
+		p.request = &request;
+		if (mTemplateCache.find(request.templateName) != mTemplateCache.end())
+		{
+			try
+			{
+				p.plan = getTemplatePlan(request.templateName);
+			}
+			catch (const std::exception& e)
+			{
+				throw Exception("Error loading '" + request.templateName + "': " + e.what());
+			}
+			p.instanceName = request.instanceName.empty() ? createUniqueObjectName(request.templateName) : request.instanceName;
+			p.id = (request.id != nullEntityId()) ? request.id : generateNextEntityId();
+		}
+	}
+
+	// Run the thread safe steps of each plan in parallel
+	forEachRange(mContext.scheduler, pending.size(), entitiesPerSpawnTask, [&] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			PendingEntity& p = pending[i];
+			if (p.plan)
+			{
+				try
+				{
+					p.entity = createEntityWithRequiredComponents(p.request->templateName, p.instanceName, p.id, attachmentQueue);
+					runComponentPlanSteps(*p.plan, 0, p.plan->threadSafeStepCount, *p.entity);
+				}
+				catch (const std::exception& e)
+				{
+					throw Exception("Error loading '" + p.request->templateName + "': " + e.what());
+				}
+			}
+		}
+	});
+
+	// Run remaining steps on the calling thread
+	std::vector<EntityPtr> result;
+	result.reserve(pending.size());
+	for (PendingEntity& p : pending)
+	{
+		if (p.plan)
+		{
+			try
+			{
+				runComponentPlanSteps(*p.plan, p.plan->threadSafeStepCount, p.plan->steps.size(), *p.entity);
+				finishEntity(*p.entity, p.request->position, p.request->orientation);
+			}
+			catch (const std::exception& e)
+			{
+				throw Exception("Error loading '" + p.request->templateName + "': " + e.what());
+			}
+			result.push_back(std::move(p.entity));
+		}
+		else
+		{
+			result.push_back(createEntity(p.request->templateName, p.request->instanceName, p.request->position, p.request->orientation, p.request->id));
+		}
+	}
+	return result;
+}
+
 const float sunDistance = 10000;
 const float moonDistance = sunDistance;
 const float sunDiameter = 2.0f * tan(skybolt::math::degToRadF() * 0.53f * 0.5f) * sunDistance;
@@ -882,20 +1144,26 @@ EntityPtr EntityFactory::createStars(const EntityFactory::VisContext& visContext
 
 const skybolt::ScenarioObjectPath& EntityFactory::getScenarioObjectDirectoryForTemplate(const std::string& templateName) const
 {
-	if (auto i = mTemplateDirectories.find(templateName); i != mTemplateDirectories.end())
+	if (mTemplateCache.find(templateName) != mTemplateCache.end())
 	{
-		return i->second;
+		std::scoped_lock<std::mutex> lock(mTemplateCacheMutex);
+		return getLoadedTemplate(templateName).scenarioObjectDirectory;
 	}
 	return getDefaultEntityScenarioObjectDirectory();
 }
 
 std::string EntityFactory::createUniqueObjectName(const std::string& baseName) const
 {
-	for (int i = 1; i < INT_MAX; ++i)
+	// Start searching from the index after the last name handed out for this base name,
+	// so that creating N objects with the same base name does not take O(N^2) probes.
+	std::scoped_lock<std::mutex> lock(mNextObjectNameIndicesMutex);
+	int& nextIndex = mNextObjectNameIndices[baseName];
+	for (int i = std::max(1, nextIndex); i < INT_MAX; ++i)
 	{
 		std::string name = baseName + std::to_string(i);
 		if (mContext.simWorld->findObjectByName(name) == nullptr)
 		{
+			nextIndex = i + 1;
 			return name;
 		}
 	}
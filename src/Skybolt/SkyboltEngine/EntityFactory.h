@@ -18,13 +18,26 @@
 
 #include <nlohmann/json.hpp>
 
+#include <filesystem>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <optional>
 #include <vector>
 
 namespace skybolt {
 
+struct EntityComponentPlan;
+
+struct EntitySpawnRequest
+{
+	std::string templateName;
+	std::string instanceName; //!< If empty, a unique name is generated
+	sim::Vector3 position = math::dvec3Zero();
+	sim::Quaternion orientation = math::dquatIdentity();
+	sim::EntityId id = sim::nullEntityId();
+};
+
 class EntityFactory
 {
 public:
@@ -35,6 +48,7 @@ public:
 		const vis::ShaderPrograms* programs;
 		vis::ModelFactoryPtr modelFactory;
 		vis::TextureCachePtr textureCache;
+		VisObjectAttachmentQueue* attachmentQueue = nullptr; //!< Used to defer attaching vis objects of entities created by createEntities(). If null, objects are attached immediately.
 	};
 
 	struct Context
@@ -51,9 +65,20 @@ public:
 		std::optional<VisContext> visContext; // !< If empty, visual objects will not be created
 	};
 
+	//! Templates are loaded from entityFilenames on first use
 	EntityFactory(const Context& context, const std::vector<std::filesystem::path>& entityFilenames);
+	~EntityFactory();
 
 	sim::EntityPtr createEntity(const std::string& templateName, const std::string& instanceName = "", const sim::Vector3& position = math::dvec3Zero(), const sim::Quaternion& orientation = math::dquatIdentity(), sim::EntityId id = sim::nullEntityId()) const;
+	//! Creates a batch of entities, e.g. to populate a formation or crowd.
+	//! Components are created in parallel on the context's scheduler by component factories that declare themselves thread safe,
+	//! up to the first component in each template that is not thread safe. Remaining components are created on the calling thread in template order.
+	//! Vis objects are queued in the vis context's attachment queue, if there is one, rather than being added to the scene immediately.
+	//! Entities are not added to the world. Use World::addEntities() to add them in a single transaction.
+	//! @returns entities in the same order as the requests
+	//! @throws if any entity could not be created
+	std::vector<sim::EntityPtr> createEntities(const std::vector<EntitySpawnRequest>& requests) const;
+
 	sim::EntityPtr createEntityFromJson(const nlohmann::json& json, const std::string& templateName, const std::string& instanceName, const sim::Vector3& position, const sim::Quaternion& orientation, sim::EntityId id = sim::nullEntityId()) const;
 
 	typedef std::vector<std::string> Strings;
@@ -62,24 +87,65 @@ public:
 	 //!< Gets the default scenario object directory for objects created from the given template
 	const skybolt::ScenarioObjectPath& getScenarioObjectDirectoryForTemplate(const std::string& templateName) const;
 
-	typedef std::map<std::string, nlohmann::json> TemplateJsonMap;
-	const TemplateJsonMap& getTemplateJsonMap() const { return mTemplateJsonMap; }
+	//! @returns the json of a template, loading it if it has not been loaded already.
+	//! @throws if the template does not exist or could not be loaded
+	const nlohmann::json& getTemplateJson(const std::string& templateName) const;
 
+	//! Starts loading the visual models used by the given templates in the background, so that entities can later be created from them without stalling.
+	//! Templates that do not exist or can not be loaded are ignored.
+	void prefetchModels(const std::vector<std::string>& templateNames) const;
+
+	//! Discards the component plans compiled from templates, so that they are recompiled on next use.
+	//! Plans are recompiled automatically if factories are added to, replaced in or removed from the component factory registry,
+	//! so this only needs to be called if a factory is modified through a registry iterator.
+	void invalidateTemplatePlans();
+
+	//! @returns a name of the form <baseName><N> that is not used by any object in the world.
+	//! Successive calls return different names, even if the entities have not been added to the world.
 	std::string createUniqueObjectName(const std::string& baseName) const;
 
 	sim::EntityId generateNextEntityId() const;
 
 private:
+	struct TemplateCacheEntry
+	{
+		std::filesystem::path filename;
+		std::shared_ptr<const nlohmann::json> json; //!< Null until loaded
+		skybolt::ScenarioObjectPath scenarioObjectDirectory;
+		std::shared_ptr<const EntityComponentPlan> plan; //!< Null until compiled
+	};
+
+	//! Must be called with mTemplateCacheMutex locked
+	TemplateCacheEntry& getLoadedTemplate(const std::string& templateName) const;
+
+	std::shared_ptr<const EntityComponentPlan> getTemplatePlan(const std::string& templateName) const;
+	EntityComponentPlan compileComponentPlan(const nlohmann::json& json) const;
+	sim::EntityPtr createEntityFromPlan(const EntityComponentPlan& plan, const std::string& templateName, const std::string& instanceName, const sim::Vector3& position, const sim::Quaternion& orientation, sim::EntityId id) const;
+
+	//! Creates an entity with the components required by all entities, without running the plan's steps
+	sim::EntityPtr createEntityWithRequiredComponents(const std::string& templateName, const std::string& instanceName, sim::EntityId id, VisObjectAttachmentQueue* attachmentQueue) const;
+
+	//! Runs steps in the range [begin, end) of the plan to create the entity's components
+	void runComponentPlanSteps(const EntityComponentPlan& plan, size_t begin, size_t end, sim::Entity& entity) const;
+
+	void finishEntity(sim::Entity& entity, const sim::Vector3& position, const sim::Quaternion& orientation) const;
+
+	ComponentFactoryContext createComponentFactoryContext() const;
+
 	sim::EntityPtr createSun(const EntityFactory::VisContext& visContext) const;
 	sim::EntityPtr createMoon(const EntityFactory::VisContext& visContext) const;
 	sim::EntityPtr createStars(const EntityFactory::VisContext& visContext) const;
 
 private:
 	Strings mTemplateNames;
-	std::map<std::string, skybolt::ScenarioObjectPath> mTemplateDirectories;
 	std::map<std::string, std::function<sim::EntityPtr()>> mBuiltinTemplates; // TODO: genericize these
 
-	TemplateJsonMap mTemplateJsonMap;
+	//! Contains an entry for each template. Entries are populated lazily, but no entries are added or removed after construction.
+	mutable std::map<std::string, TemplateCacheEntry> mTemplateCache;
+	mutable std::mutex mTemplateCacheMutex;
+
+	mutable std::map<std::string, int> mNextObjectNameIndices; //!< Next index to try for each unique object base name
+	mutable std::mutex mNextObjectNameIndicesMutex;
 
 	Context mContext;
 	mutable sim::EntityId mNextEntityId{1,0};
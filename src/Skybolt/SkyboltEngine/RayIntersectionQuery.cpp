@@ -0,0 +1,85 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "RayIntersectionQuery.h"
+#include "SchedulerUtility.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <SkyboltSim/CollisionGroupMasks.h>
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/Components/PlanetComponent.h>
+
+namespace skybolt {
+
+std::vector<std::optional<sim::RayIntersectionResult>> intersectRays(const RayQueryContext& context, const std::vector<RayQuery>& rays)
+{
+	std::vector<std::optional<sim::RayIntersectionResult>> results(rays.size());
+
+	if (context.collisionSystem)
+	{
+		for (size_t i = 0; i < rays.size(); ++i)
+		{
+			results[i] = context.collisionSystem->intersectRay(rays[i].start, rays[i].end, rays[i].collisionFilterMask);
+		}
+	}
+
+	const sim::PlanetComponent* planetComponent = context.planet ? context.planet->getFirstComponent<sim::PlanetComponent>().get() : nullptr;
+	if (!planetComponent || !planetComponent->altitudeProvider)
+	{
+		return results;
+	}
+
+	glm::dmat4 planetTransform = sim::getTransform(*context.planet).value_or(math::dmat4Identity());
+	glm::dmat4 invPlanetTransform = glm::inverse(planetTransform);
+	const sim::PlanetAltitudeProvider& provider = *planetComponent->altitudeProvider;
+
+	forEachRange(context.scheduler, rays.size(), context.raysPerTask, [&] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			const RayQuery& ray = rays[i];
+			if (!(ray.collisionFilterMask & sim::CollisionGroupMasks::terrain))
+			{
+				continue;
+			}
+
+			// Only search for terrain in front of the nearest body intersection
+			sim::Vector3 end = ray.end;
+			std::optional<sim::RayIntersectionResult>& result = results[i];
+			if (result)
+			{
+				end = result->position;
+			}
+
+			sim::Vector3 startInPlanetSpace(invPlanetTransform * glm::dvec4(ray.start, 1.0));
+			sim::Vector3 endInPlanetSpace(invPlanetTransform * glm::dvec4(end, 1.0));
+
+			if (auto intersection = sim::intersectTerrain(provider, planetComponent->radius, startInPlanetSpace, endInPlanetSpace, context.terrainConfig); intersection)
+			{
+				sim::RayIntersectionResult terrainResult;
+				terrainResult.position = sim::Vector3(planetTransform * glm::dvec4(intersection->position, 1.0));
+				terrainResult.normal = glm::normalize(sim::Vector3(planetTransform * glm::dvec4(intersection->normal, 0.0)));
+				terrainResult.distance = intersection->distance;
+				terrainResult.entity = context.planet->getId();
+				result = terrainResult;
+			}
+		}
+	});
+
+	return results;
+}
+
+std::vector<bool> hasLineOfSight(const RayQueryContext& context, const std::vector<RayQuery>& rays)
+{
+	std::vector<std::optional<sim::RayIntersectionResult>> intersections = intersectRays(context, rays);
+
+	std::vector<bool> result(rays.size());
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		result[i] = !intersections[i].has_value();
+	}
+	return result;
+}
+
+} // namespace skybolt
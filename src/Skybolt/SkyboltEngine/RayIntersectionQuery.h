@@ -0,0 +1,45 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltSim/SkyboltSimFwd.h>
+#include <SkyboltSim/Spatial/TerrainRayIntersection.h>
+#include <SkyboltSim/System/CollisionSystem.h>
+#include <SkyboltVis/SkyboltVisFwd.h>
+
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+
+struct RayQuery
+{
+	sim::Vector3 start; //!< World space
+	sim::Vector3 end; //!< World space
+	int collisionFilterMask = ~0; //!< Terrain is intersected if the mask contains sim::CollisionGroupMasks::terrain
+};
+
+struct RayQueryContext
+{
+	const sim::Entity* planet = nullptr; //!< Planet whose terrain is intersected. If null, terrain is not intersected.
+	const sim::CollisionSystem* collisionSystem = nullptr; //!< Used to intersect bodies. If null, bodies are not intersected.
+	sim::TerrainRayIntersectionConfig terrainConfig;
+	px_sched::Scheduler* scheduler = nullptr; //!< If not null, rays are intersected with terrain in parallel
+	size_t raysPerTask = 16;
+};
+
+//! Intersects a batch of rays with bodies and terrain.
+//! Rays are first intersected with bodies on the calling thread, because body intersection is not thread safe,
+//! and then the remaining length of each ray is intersected with the planet's terrain in parallel.
+//! Terrain intersections are attributed to the planet entity.
+//! @returns the nearest intersection of each ray, in world space
+std::vector<std::optional<sim::RayIntersectionResult>> intersectRays(const RayQueryContext& context, const std::vector<RayQuery>& rays);
+
+//! @returns true for each ray that does not intersect bodies or terrain between its start and end
+std::vector<bool> hasLineOfSight(const RayQueryContext& context, const std::vector<RayQuery>& rays);
+
+} // namespace skybolt
@@ -6,6 +6,7 @@
 
 #include "ScenarioSerialization.h"
 #include "Scenario.h"
+#include <SkyboltEngine/SchedulerUtility.h>
 #include <SkyboltEngine/Scenario/ScenarioMetadataComponent.h>
 #include <SkyboltEngine/Components/TemplateNameComponent.h>
 #include <SkyboltSim/Components/NameComponent.h>
@@ -16,6 +17,10 @@
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <SkyboltCommon/StringVector.h>
 
+#include <set>
+#include <typeindex>
+#include <unordered_map>
+
 using namespace skybolt::sim;
 
 namespace skybolt {
@@ -43,7 +48,7 @@ static std::string toString(TimelineMode mode)
 	return "live";
 }
 
-void readScenario(refl::TypeRegistry& typeRegistry, Scenario& scenario, const EntityFactoryFn& entityFactory, const nlohmann::json& json, EntityPersistenceFlags entityPersistenceFlags)
+void readScenario(refl::TypeRegistry& typeRegistry, Scenario& scenario, const EntityFactoryFn& entityFactory, const nlohmann::json& json, EntityPersistenceFlags entityPersistenceFlags, px_sched::Scheduler* scheduler)
 {
 	SecondsD startTime = readOptionalOrDefault(json, "startTime", SecondsD(0));
 
@@ -53,11 +58,11 @@ void readScenario(refl::TypeRegistry& typeRegistry, Scenario& scenario, const En
 	scenario.timelineMode = readTimelineMode(readOptionalOrDefault<std::string>(json, "timelineMode", "live"));
 
 	ifChildExists(json, "entities", [&] (const nlohmann::json& child) {
-		readEntities(typeRegistry, scenario.world, entityFactory, child, entityPersistenceFlags);
+		readEntities(typeRegistry, scenario.world, entityFactory, child, entityPersistenceFlags, scheduler);
 	});
 }
 
-nlohmann::json writeScenario(refl::TypeRegistry& typeRegistry, const Scenario& scenario)
+nlohmann::json writeScenario(refl::TypeRegistry& typeRegistry, const Scenario& scenario, px_sched::Scheduler* scheduler)
 {
 	const auto& timeRange = scenario.timeSource.getRange();
 	nlohmann::json json;
@@ -66,20 +71,161 @@ nlohmann::json writeScenario(refl::TypeRegistry& typeRegistry, const Scenario& s
 	json["duration"] = timeRange.end - timeRange.start;
 	json["currentTime"] = scenario.timeSource.getTime();
 	json["timelineMode"] = toString(scenario.timelineMode.get());
-	json["entities"] = writeEntities(typeRegistry, scenario.world);
+	json["entities"] = writeEntities(typeRegistry, scenario.world, scheduler);
 	return json;
 }
 
-static void readEntityComponents(refl::TypeRegistry& registry, World& world, sim::Entity& entity, const nlohmann::json& json)
+std::vector<std::string> readScenarioTemplateNames(const nlohmann::json& json)
+{
+	std::set<std::string> names;
+	ifChildExists(json, "entities", [&] (const nlohmann::json& entities) {
+		for (const auto& [key, entityJson] : entities.items())
+		{
+			ifChildExists(entityJson, "template", [&] (const nlohmann::json& templateName) {
+				names.insert(templateName.get<std::string>());
+			});
+		}
+	});
+	return std::vector<std::string>(names.begin(), names.end());
+}
+
+namespace {
+
+//! Reflection metadata of a component type
+struct ComponentTypeInfo
+{
+	refl::TypePtr type;
+
+	//! Properties of the type, or nullopt if the type is not serialized through a static property list,
+	//! i.e. it provides properties dynamically or implements ExplicitSerialization.
+	//! Components of types without a static property list may run arbitrary code when serialized, so are serialized on the calling thread.
+	std::optional<refl::Type::PropertyMap> properties;
+};
+
+//! Caches reflection metadata by component type, so that metadata is looked up once per type rather than once per component.
+//! Lookups may create types in the registry, so the cache must be populated on the calling thread before serializing in parallel.
+class ComponentTypeCache
+{
+public:
+	ComponentTypeCache(refl::TypeRegistry& registry) :
+		mRegistry(registry)
+	{
+		prepareConcurrentSerialization(mRegistry);
+	}
+
+	const ComponentTypeInfo& get(sim::Component& component)
+	{
+		std::type_index key = typeid(component);
+		if (const auto& i = mInfos.find(key); i != mInfos.end())
+		{
+			return i->second;
+		}
+
+		ComponentTypeInfo info;
+		info.type = mRegistry.getOrCreateMostDerivedType(component);
+		if (!info.type->isDerivedFrom<refl::DynamicPropertySource>() && !info.type->isDerivedFrom<ExplicitSerialization>())
+		{
+			refl::Instance instance = refl::makeRefInstance(mRegistry, &component);
+			info.properties = refl::getProperties(instance);
+		}
+		return mInfos.emplace(key, std::move(info)).first->second;
+	}
+
+private:
+	refl::TypeRegistry& mRegistry;
+	std::unordered_map<std::type_index, ComponentTypeInfo> mInfos;
+};
+
+struct ComponentRef
 {
+	sim::Component* component;
+	const ComponentTypeInfo* typeInfo;
+	refl::Instance instance;
+};
+
+//! Returns components of the entity with their type metadata. Must be called on the calling thread.
+std::vector<ComponentRef> getComponentRefs(refl::TypeRegistry& registry, ComponentTypeCache& cache, const sim::Entity& entity)
+{
+	std::vector<ComponentRef> result;
 	for (const auto& component : entity.getComponents())
 	{
-		refl::TypePtr type = registry.getOrCreateMostDerivedType(*component);
-		ifChildExists(json, type->getName(), [&] (const nlohmann::json& componentJson) {
-			refl::Instance instance = refl::makeRefInstance(registry, component.get());
-			readReflectedObject(registry, instance, componentJson);
+		result.push_back({ component.get(), &cache.get(*component), refl::makeRefInstance(registry, component.get()) });
+	}
+	return result;
+}
+
+//! Number of entities serialized by each task. Entities are batched to amortize task overhead.
+constexpr size_t entitiesPerTask = 64;
+
+//! A component property value parsed from json, to be applied to the component on the calling thread
+struct ParsedProperty
+{
+	refl::PropertyPtr property;
+	std::optional<refl::Instance> value; //!< Value parsed in advance, or nullopt if the value must be read from json when applied
+	const nlohmann::json* json;
+};
+
+struct ParsedComponent
+{
+	ComponentRef* ref;
+	const nlohmann::json* json;
+	std::optional<std::vector<ParsedProperty>> properties; //!< Parsed properties, or nullopt if the component must be read from json when applied
+};
+
+} // namespace
+
+//! Parses component state from json without modifying components. Thread safe.
+static std::vector<ParsedComponent> parseEntityComponents(refl::TypeRegistry& registry, std::vector<ComponentRef>& components, const nlohmann::json& json)
+{
+	std::vector<ParsedComponent> result;
+	for (ComponentRef& ref : components)
+	{
+		ifChildExists(json, ref.typeInfo->type->getName(), [&] (const nlohmann::json& componentJson) {
+			ParsedComponent& parsed = result.emplace_back(ParsedComponent{ &ref, &componentJson });
+			if (!ref.typeInfo->properties)
+			{
+				return;
+			}
+
+			parsed.properties.emplace();
+			for (const auto& [name, property] : *ref.typeInfo->properties)
+			{
+				ifChildExists(componentJson, property->getName(), [&] (const nlohmann::json& propertyJson) {
+					parsed.properties->push_back({ property, readBuiltInValue(registry, *property->getType(), propertyJson), &propertyJson });
+				});
+			}
 		});
 	}
+	return result;
+}
+
+//! Applies parsed component state to components. Must be called on the calling thread.
+static void applyEntityComponents(refl::TypeRegistry& registry, const std::vector<ParsedComponent>& components)
+{
+	for (const ParsedComponent& parsed : components)
+	{
+		refl::Instance& instance = parsed.ref->instance;
+		if (!parsed.properties)
+		{
+			readReflectedObject(registry, instance, *parsed.json);
+			continue;
+		}
+
+		for (const ParsedProperty& property : *parsed.properties)
+		{
+			if (property.value)
+			{
+				property.property->setValue(instance, *property.value);
+			}
+			else
+			{
+				// Property is an object without built-in json support, so read into the existing value
+				refl::Instance value = property.property->getValue(instance);
+				readReflectedObject(registry, value, *property.json);
+				property.property->setValue(instance, value);
+			}
+		}
+	}
 
 	// FIXME: we should remove all dynamically created components that already exist on entity,
 	// however currently we can't distinguish between pre-existing components that were added
@@ -87,22 +233,38 @@ static void readEntityComponents(refl::TypeRegistry& registry, World& world, sim
 	// that were dynamically created during the simulation (these should be removed).
 }
 
-static nlohmann::json writeEntityComponents(refl::TypeRegistry& registry, const sim::Entity& entity)
+//! Writes components with a static property list. Thread safe.
+static nlohmann::json writeEntityComponentsWithProperties(refl::TypeRegistry& registry, const std::vector<ComponentRef>& components)
 {
 	nlohmann::json json;
-	for (const auto& component : entity.getComponents())
+	for (const ComponentRef& ref : components)
 	{
-		refl::TypePtr type = registry.getOrCreateMostDerivedType(*component);
-		refl::Instance instance = refl::makeRefInstance(registry, component.get());
-		if (nlohmann::json componentJson = writeReflectedObject(registry, instance); !componentJson.is_null())
+		if (ref.typeInfo->properties)
 		{
-			json[type->getName()] = componentJson;
+			if (nlohmann::json componentJson = writeReflectedObjectProperties(registry, ref.instance, *ref.typeInfo->properties); !componentJson.is_null())
+			{
+				json[ref.typeInfo->type->getName()] = componentJson;
+			}
 		}
 	}
-
 	return json;
 }
 
+//! Writes components without a static property list. Must be called on the calling thread.
+static void writeEntityComponentsWithoutProperties(refl::TypeRegistry& registry, const std::vector<ComponentRef>& components, nlohmann::json& json)
+{
+	for (const ComponentRef& ref : components)
+	{
+		if (!ref.typeInfo->properties)
+		{
+			if (nlohmann::json componentJson = writeReflectedObject(registry, ref.instance); !componentJson.is_null())
+			{
+				json[ref.typeInfo->type->getName()] = componentJson;
+			}
+		}
+	}
+}
+
 //! Creates entity if it does not already exist in the world, then updates with read state
 static sim::EntityPtr readEntity(World& world, const EntityFactoryFn& factory, const std::string& name, const nlohmann::json& json)
 {
@@ -118,16 +280,6 @@ static sim::EntityPtr readEntity(World& world, const EntityFactoryFn& factory, c
 	return entity;
 }
 
-static nlohmann::json writeEntity(refl::TypeRegistry& registry, const Entity& entity, const std::string& templateName)
-{
-	nlohmann::json json;
-	json["template"] = templateName;
-	json["dynamicsEnabled"] = entity.isDynamicsEnabled();
-	json["components"] = writeEntityComponents(registry, entity);
-
-	return json;
-}
-
 template <typename T>
 inline std::set<T> toSet(const std::vector<T>& v)
 {
@@ -154,7 +306,7 @@ static bool shouldPersistAcrossLoad(const Entity& entity, EntityPersistenceFlags
 	return false; // Entities should not persist by default.
 }
 
-void readEntities(refl::TypeRegistry& registry, World& world, const EntityFactoryFn& factory, const nlohmann::json& json, EntityPersistenceFlags entityPersistenceFlags)
+void readEntities(refl::TypeRegistry& registry, World& world, const EntityFactoryFn& factory, const nlohmann::json& json, EntityPersistenceFlags entityPersistenceFlags, px_sched::Scheduler* scheduler)
 {
 	// Make a set of names of entities in the world that should be removed if they don't exist in the serialized state being read.
 	std::set<std::string> oldEntityNames;
@@ -170,11 +322,13 @@ void readEntities(refl::TypeRegistry& registry, World& world, const EntityFactor
 
 	// Read entities into world
 	std::vector<sim::EntityPtr> entities;
+	std::vector<const nlohmann::json*> entityJsons;
 
 	for (const auto& [key, entityJson] : json.items())
 	{
 		EntityPtr entity = readEntity(world, factory, key, entityJson);
 		entities.push_back(entity);
+		entityJsons.push_back(&entityJson);
 		oldEntityNames.erase(getName(*entity));
 	}
 
@@ -187,20 +341,45 @@ void readEntities(refl::TypeRegistry& registry, World& world, const EntityFactor
 		}
 	}
 
-	// Read components after all entities exist, in case a component refers to an entity
-	int i = 0;
-	for (const auto& [key, entity] : json.items())
+	// Read components after all entities exist, in case a component refers to an entity.
+	// Component state is parsed in parallel, then applied to components in entity order on this thread.
+	ComponentTypeCache cache(registry);
+	std::vector<std::vector<ComponentRef>> componentRefs;
+	componentRefs.reserve(entities.size());
+	for (const EntityPtr& entity : entities)
 	{
-		ifChildExists(entity, "components", [&](const nlohmann::json& components){
-			readEntityComponents(registry, world, *entities[i], components);
-		});
-		++i;
+		componentRefs.push_back(getComponentRefs(registry, cache, *entity));
+	}
+
+	std::vector<std::vector<ParsedComponent>> parsedComponents(entities.size());
+	forEachRange(scheduler, entities.size(), entitiesPerTask, [&] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			ifChildExists(*entityJsons[i], "components", [&] (const nlohmann::json& components) {
+				parsedComponents[i] = parseEntityComponents(registry, componentRefs[i], components);
+			});
+		}
+	});
+
+	for (const std::vector<ParsedComponent>& components : parsedComponents)
+	{
+		applyEntityComponents(registry, components);
 	}
 }
 
-nlohmann::json writeEntities(refl::TypeRegistry& registry, const World& world)
+nlohmann::json writeEntities(refl::TypeRegistry& registry, const World& world, px_sched::Scheduler* scheduler)
 {
-	nlohmann::json json;
+	struct EntityToWrite
+	{
+		const Entity* entity;
+		const std::string* name;
+		const std::string* templateName;
+		std::vector<ComponentRef> components;
+	};
+
+	// Gather entities and reflection metadata on this thread, because metadata lookups may modify the registry
+	ComponentTypeCache cache(registry);
+	std::vector<EntityToWrite> entities;
 	for (const EntityPtr& entity : world.getEntities())
 	{
 		if (isSerializable(*entity))
@@ -209,11 +388,31 @@ nlohmann::json writeEntities(refl::TypeRegistry& registry, const World& world)
 			auto templateNameComponent = entity->getFirstComponent<TemplateNameComponent>();
 			if (!name.empty() && templateNameComponent)
 			{
-				json[name] = writeEntity(registry, *entity, templateNameComponent->name);
+				entities.push_back({ entity.get(), &name, &templateNameComponent->name, getComponentRefs(registry, cache, *entity) });
 			}
 		}
 	}
 
+	// Write each entity to an independent json fragment
+	std::vector<nlohmann::json> fragments(entities.size());
+	forEachRange(scheduler, entities.size(), entitiesPerTask, [&] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			nlohmann::json& entityJson = fragments[i];
+			entityJson["template"] = *entities[i].templateName;
+			entityJson["dynamicsEnabled"] = entities[i].entity->isDynamicsEnabled();
+			entityJson["components"] = writeEntityComponentsWithProperties(registry, entities[i].components);
+		}
+	});
+
+	// Merge fragments in world order, so the result is the same as writing entities serially
+	nlohmann::json json;
+	for (size_t i = 0; i < entities.size(); ++i)
+	{
+		writeEntityComponentsWithoutProperties(registry, entities[i].components, fragments[i]["components"]);
+		json[*entities[i].name] = std::move(fragments[i]);
+	}
+
 	return json;
 }
 
@@ -12,6 +12,11 @@
 
 #include <nlohmann/json.hpp>
 
+namespace px_sched
+{
+class Scheduler;
+}
+
 namespace skybolt {
 
 using EntityFactoryFn = std::function<sim::EntityPtr(const std::string& templateName, const std::string& instanceName)>;
@@ -23,12 +28,19 @@ struct EntityPersistenceFlags
 };
 
 //! Reads scenario state from json. Any existing world state will be overwritten.
-void readScenario(refl::TypeRegistry& typeRegistry, Scenario& scenario, const EntityFactoryFn& entityFactory, const nlohmann::json& value, EntityPersistenceFlags entityPersistenceFlags = {});
+//! @param scheduler is used to parse component state in parallel. If null, state is parsed on the calling thread.
+//! Entities are created and component state is applied on the calling thread in either case.
+void readScenario(refl::TypeRegistry& typeRegistry, Scenario& scenario, const EntityFactoryFn& entityFactory, const nlohmann::json& value, EntityPersistenceFlags entityPersistenceFlags = {}, px_sched::Scheduler* scheduler = nullptr);
+
+//! @param scheduler is used to write entities in parallel. If null, entities are written on the calling thread.
+//! The result is the same with or without a scheduler.
+nlohmann::json writeScenario(refl::TypeRegistry& typeRegistry, const Scenario& scenario, px_sched::Scheduler* scheduler = nullptr);
 
-nlohmann::json writeScenario(refl::TypeRegistry& typeRegistry, const Scenario& scenario);
+//! @returns the unique names of templates used by entities in scenario json
+std::vector<std::string> readScenarioTemplateNames(const nlohmann::json& value);
 
-void readEntities(refl::TypeRegistry& registry, sim::World& world, const EntityFactoryFn& factory, const nlohmann::json& value, EntityPersistenceFlags entityPersistenceFlags = {});
+void readEntities(refl::TypeRegistry& registry, sim::World& world, const EntityFactoryFn& factory, const nlohmann::json& value, EntityPersistenceFlags entityPersistenceFlags = {}, px_sched::Scheduler* scheduler = nullptr);
 
-nlohmann::json writeEntities(refl::TypeRegistry& registry, const sim::World& world);
+nlohmann::json writeEntities(refl::TypeRegistry& registry, const sim::World& world, px_sched::Scheduler* scheduler = nullptr);
 
 } // namespace skybolt
\ No newline at end of file
@@ -7,7 +7,8 @@ namespace skybolt {
 SimSnapshotRegistry::SimSnapshotRegistry(const SimSnapshotRegistryConfig& config) :
 	mEntityFactory(config.entityFactory),
 	mTypeRegistry(config.typeRegistry),
-	mScenario(config.scenario)
+	mScenario(config.scenario),
+	mScheduler(config.scheduler)
 {
 	assert(mEntityFactory);
 	assert(mTypeRegistry);
@@ -23,7 +24,7 @@ void SimSnapshotRegistry::loadSnapshot(const Snapshot& snapshot)
 		.persistUserManaged = true
 	};
 
-	readScenario(*mTypeRegistry, *mScenario, mEntityFactory, snapshot.state, entityPersistenceFlags);
+	readScenario(*mTypeRegistry, *mScenario, mEntityFactory, snapshot.state, entityPersistenceFlags, mScheduler);
 }
 
 void SimSnapshotRegistry::saveSnapshotAtCurrentTime()
@@ -39,7 +40,7 @@ void SimSnapshotRegistry::saveSnapshotAtCurrentTime()
 	}
 
 	// Add new snapshot
-	nlohmann::json state = writeScenario(*mTypeRegistry, *mScenario);
+	nlohmann::json state = writeScenario(*mTypeRegistry, *mScenario, mScheduler);
 	mSnapshots.push_back({ simTime, {state} });
 
 	// Keep snapshots vector ordered by time
@@ -76,6 +77,7 @@ std::unique_ptr<SimSnapshotRegistry> createSnapshotRegistry(const skybolt::Engin
 	};
 	config.typeRegistry = engineRoot.typeRegistry.get();
 	config.scenario = engineRoot.scenario.get();
+	config.scheduler = engineRoot.scheduler.get();
 	return std::make_unique<SimSnapshotRegistry>(config);
 }
 
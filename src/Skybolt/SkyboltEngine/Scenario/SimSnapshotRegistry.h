@@ -15,6 +15,7 @@ struct SimSnapshotRegistryConfig
 	EntityFactoryFn entityFactory;
 	refl::TypeRegistry* typeRegistry;
 	Scenario* scenario;
+	px_sched::Scheduler* scheduler = nullptr; //!< Optional scheduler used to serialize snapshots in parallel
 };
 
 class SimSnapshotRegistry
@@ -41,6 +42,7 @@ private:
 	const EntityFactoryFn mEntityFactory;
 	refl::TypeRegistry* mTypeRegistry;
 	Scenario* mScenario;
+	px_sched::Scheduler* mScheduler;
 
 	//! Time-ordered vector of snapshots
 	SnapshotVector mSnapshots;
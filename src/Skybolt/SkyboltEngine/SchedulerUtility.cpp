@@ -0,0 +1,55 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "SchedulerUtility.h"
+
+#include <px_sched/px_sched.h>
+
+#include <assert.h>
+#include <exception>
+#include <vector>
+
+namespace skybolt {
+
+void forEachRange(px_sched::Scheduler* scheduler, size_t count, size_t rangeSize, const RangeFunction& fn)
+{
+	assert(rangeSize > 0);
+	if (!scheduler || count <= rangeSize)
+	{
+		fn(0, count);
+		return;
+	}
+
+	size_t taskCount = (count + rangeSize - 1) / rangeSize;
+	std::vector<std::exception_ptr> exceptions(taskCount);
+
+	px_sched::Sync sync;
+	for (size_t task = 0; task < taskCount; ++task)
+	{
+		scheduler->run([&, task] {
+			try
+			{
+				size_t begin = task * rangeSize;
+				fn(begin, std::min(begin + rangeSize, count));
+			}
+			catch (...)
+			{
+				exceptions[task] = std::current_exception();
+			}
+		}, &sync);
+	}
+	scheduler->waitFor(sync);
+
+	for (const std::exception_ptr& exception : exceptions)
+	{
+		if (exception)
+		{
+			std::rethrow_exception(exception);
+		}
+	}
+}
+
+} // namespace skybolt
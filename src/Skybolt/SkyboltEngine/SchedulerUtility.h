@@ -0,0 +1,22 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltVis/SkyboltVisFwd.h>
+
+#include <functional>
+
+namespace skybolt {
+
+using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+//! Calls fn(begin, end) for consecutive ranges of [0, count) with at most rangeSize items each.
+//! Ranges are processed in parallel on the scheduler if one is provided, otherwise fn is called once on the calling thread.
+//! Blocks until all ranges are processed. Exceptions thrown by fn are rethrown on the calling thread.
+void forEachRange(px_sched::Scheduler* scheduler, size_t count, size_t rangeSize, const RangeFunction& fn);
+
+} // namespace skybolt
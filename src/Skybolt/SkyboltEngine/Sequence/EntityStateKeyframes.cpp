@@ -0,0 +1,139 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "EntityStateKeyframes.h"
+#include "SkyboltEngine/Sequence/Interpolator/CubicBSplineInterpolator.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <assert.h>
+
+namespace skybolt {
+
+static double getComponent(const EntitySequenceState& state, int componentIndex)
+{
+	return (componentIndex < 3) ? state.position[componentIndex] : state.orientation[componentIndex - 3];
+}
+
+void EntityStateKeyframes::assign(const EntityStateSequence& sequence)
+{
+	assert(sequence.times.size() == sequence.values.size());
+	mTimes = sequence.times;
+	mCachedBracketIndex = 0;
+
+	int size = int(mTimes.size());
+	for (int c = 0; c < componentCount; ++c)
+	{
+		std::vector<double>& values = mValues[c];
+		values.resize(size);
+		for (int i = 0; i < size; ++i)
+		{
+			values[i] = getComponent(sequence.values[i], c);
+		}
+
+		std::vector<double>& left = mControlPointsLeft[c];
+		std::vector<double>& right = mControlPointsRight[c];
+		left.resize(size);
+		right.resize(size);
+		for (int i = 0; i < size; ++i)
+		{
+			int indexPrev = std::max(0, i - 1);
+			int indexNext = std::min(size - 1, i + 1);
+
+			glm::dvec2 p0(mTimes[indexPrev], values[indexPrev]);
+			glm::dvec2 p1(mTimes[i], values[i]);
+			glm::dvec2 p2(mTimes[indexNext], values[indexNext]);
+			left[i] = calcCubicBSplineControlPoint(p0, p1, p2, /* rightSide */ false);
+			right[i] = calcCubicBSplineControlPoint(p0, p1, p2, /* rightSide */ true);
+		}
+	}
+}
+
+std::optional<math::InterpolationPoint> EntityStateKeyframes::findInterpolationPoint(double t) const
+{
+	int size = int(mTimes.size());
+	if (size <= 1)
+	{
+		return math::findInterpolationPoint(mTimes, t, /* extrapolate */ false);
+	}
+
+	// Find the left bound using the same rules as math::findInterpolationPoint
+	int lastBracket = size - 2;
+	int i;
+	if (t >= mTimes[lastBracket])
+	{
+		i = lastBracket;
+	}
+	else
+	{
+		i = std::min(mCachedBracketIndex, lastBracket);
+		bool cachedBracketValid = (i == 0 || t > mTimes[i]) && t <= mTimes[i + 1];
+		if (!cachedBracketValid)
+		{
+			// Try the next bracket before searching because it is the common case during playback
+			if (i + 1 < lastBracket && t > mTimes[i + 1] && t <= mTimes[i + 2])
+			{
+				++i;
+			}
+			else
+			{
+				auto it = std::lower_bound(mTimes.begin() + 1, mTimes.begin() + lastBracket, t);
+				i = int(it - mTimes.begin()) - 1;
+			}
+		}
+	}
+	mCachedBracketIndex = i;
+
+	double tL = mTimes[i];
+	double tR = mTimes[i + 1];
+
+	math::InterpolationPoint point;
+	point.bounds.first = i;
+	point.bounds.last = i + 1;
+	point.weight = math::clamp((t - tL) / (tR - tL), 0.0, 1.0);
+	return point;
+}
+
+EntityStateSample EntityStateKeyframes::evaluateAtTime(double t) const
+{
+	std::optional<math::InterpolationPoint> point = findInterpolationPoint(t);
+	if (point)
+	{
+		return evaluateAtInterpolationPoint(*point);
+	}
+	return {};
+}
+
+EntityStateSample EntityStateKeyframes::evaluateAtInterpolationPoint(const math::InterpolationPoint& point) const
+{
+	int first = point.bounds.first;
+	int last = point.bounds.last;
+
+	std::array<double, componentCount> result;
+	for (int c = 0; c < componentCount; ++c)
+	{
+		result[c] = evalCubicBezier(mValues[c][first], mControlPointsRight[c][first], mControlPointsLeft[c][last], mValues[c][last], point.weight);
+	}
+
+	EntityStateSample sample;
+	sample.position = sim::Vector3(result[0], result[1], result[2]);
+	for (int i = 0; i < 4; ++i)
+	{
+		sample.orientation[i] = result[3 + i];
+	}
+	sample.orientation = glm::normalize(sample.orientation);
+	sample.valid = true;
+	return sample;
+}
+
+void evaluateEntityStateKeyframesAtTime(std::span<const EntityStateKeyframes* const> keyframes, double t, std::span<EntityStateSample> results)
+{
+	assert(keyframes.size() == results.size());
+	for (size_t i = 0; i < keyframes.size(); ++i)
+	{
+		results[i] = keyframes[i]->evaluateAtTime(t);
+	}
+}
+
+} // namespace skybolt
@@ -0,0 +1,67 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "EntityStateSequenceController.h"
+#include <SkyboltCommon/Math/InterpolateTableLinear.h>
+
+#include <array>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace skybolt {
+
+struct EntityStateSample
+{
+	sim::Vector3 position;
+	sim::Quaternion orientation;
+	bool valid = false; //!< False if there were no keyframes to evaluate
+};
+
+//! Columnar copy of an EntityStateSequence's keyframes for fast playback.
+//! Each position and orientation component is stored in its own contiguous array
+//! alongside precomputed cubic B-spline control points, so evaluating a state
+//! requires only a bracket search and a bezier evaluation per component.
+//! Evaluation results are identical to interpolating the sequence with CubicBSplineInterpolatorD.
+class EntityStateKeyframes
+{
+public:
+	//! Rebuilds the keyframes from the sequence
+	void assign(const EntityStateSequence& sequence);
+
+	size_t size() const { return mTimes.size(); }
+	bool empty() const { return mTimes.empty(); }
+	const std::vector<double>& getTimes() const { return mTimes; }
+
+	//! Equivalent to math::findInterpolationPoint(getTimes(), t, false).
+	//! The bracket found by the previous call is checked first so that playback
+	//! with monotonically changing time is amortized O(1), otherwise falls back to binary search.
+	//! Not thread safe for concurrent calls on the same instance because the cached bracket is mutated.
+	std::optional<math::InterpolationPoint> findInterpolationPoint(double t) const;
+
+	//! @returns an invalid sample if the keyframes are empty
+	EntityStateSample evaluateAtTime(double t) const;
+
+	EntityStateSample evaluateAtInterpolationPoint(const math::InterpolationPoint& point) const;
+
+private:
+	static constexpr int componentCount = 7; //!< Position xyz followed by orientation xyzw
+
+	std::vector<double> mTimes;
+	std::array<std::vector<double>, componentCount> mValues;
+	std::array<std::vector<double>, componentCount> mControlPointsLeft;
+	std::array<std::vector<double>, componentCount> mControlPointsRight;
+
+	mutable int mCachedBracketIndex = 0;
+};
+
+//! Evaluates many keyframe sets at the same time.
+//! @param results must be the same size as keyframes. Each result is set to invalid if its keyframes are empty.
+void evaluateEntityStateKeyframesAtTime(std::span<const EntityStateKeyframes* const> keyframes, double t, std::span<EntityStateSample> results);
+
+} // namespace skybolt
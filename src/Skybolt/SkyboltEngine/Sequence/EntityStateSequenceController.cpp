@@ -5,48 +5,13 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "EntityStateSequenceController.h"
-#include "SkyboltEngine/Sequence/Interpolator/CubicBSplineInterpolator.h"
-#include "SkyboltEngine/Sequence/Interpolator/LinearInterpolator.h"
+#include "EntityStateKeyframes.h"
 #include <SkyboltSim/World.h>
 #include <SkyboltSim/Components/DynamicBodyComponent.h>
 #include <assert.h>
 
 namespace skybolt {
 
-constexpr bool linear = false;
-
-std::shared_ptr<InterpolatorD> createPositionComponentInterpolator(const std::shared_ptr<EntityStateSequence>& sequence, int componentIndex)
-{
-	if (linear)
-	{
-		return std::make_shared<LinearInterpolatorD>(
-			[sequence, componentIndex](int i) { return sequence->values[i].position[componentIndex]; });
-	}
-	else
-	{
-		return std::make_shared<CubicBSplineInterpolatorD>(
-			[sequence, componentIndex] { return int(sequence->values.size()); },
-			[sequence, componentIndex](int i) { return sequence->values[i].position[componentIndex]; },
-			[sequence, componentIndex](int i) { return sequence->times[i]; });
-	}
-}
-
-std::shared_ptr<InterpolatorD> createOrientationComponentInterpolator(const std::shared_ptr<EntityStateSequence>& sequence, int componentIndex)
-{
-	if (linear)
-	{
-		return std::make_shared<LinearInterpolatorD>(
-			[sequence, componentIndex](int i) { return sequence->values[i].orientation[componentIndex]; });
-	}
-	else
-	{
-		return std::make_shared<CubicBSplineInterpolatorD>(
-			[sequence, componentIndex] { return int(sequence->values.size()); },
-			[sequence, componentIndex](int i) { return sequence->values[i].orientation[componentIndex]; },
-			[sequence, componentIndex](int i) { return sequence->times[i]; });
-	}
-}
-
 static glm::dquat toSameSign(const glm::dquat& self, const glm::dquat& reference)
 {
 	double dot = glm::dot(self, reference);
@@ -72,18 +37,7 @@ EntityStateSequenceController::EntityStateSequenceController(const std::shared_p
 {
 	makeQuaternionSignConsistent(*sequence);
 
-	mPositionInterpolators = {
-		createPositionComponentInterpolator(sequence, 0),
-		createPositionComponentInterpolator(sequence, 1),
-		createPositionComponentInterpolator(sequence, 2)
-	};
-
-	mOrientationInterpolators = {
-		createOrientationComponentInterpolator(sequence, 0),
-		createOrientationComponentInterpolator(sequence, 1),
-		createOrientationComponentInterpolator(sequence, 2),
-		createOrientationComponentInterpolator(sequence, 3)
-	};
+	mKeyframes = std::make_unique<EntityStateKeyframes>();
 
 	auto sanitizeOrientation = [sequence](size_t index) {
 		glm::dquat& ori = sequence->values[index].orientation;
@@ -92,10 +46,22 @@ EntityStateSequenceController::EntityStateSequenceController(const std::shared_p
 
 	mConnections.push_back(sequence->itemAdded.connect(sanitizeOrientation));
 	mConnections.push_back(sequence->valueChanged.connect(sanitizeOrientation));
+
+	auto markKeyframesDirty = [this](size_t index) {
+		mKeyframesDirty = true;
+	};
+
+	mConnections.push_back(sequence->itemAdded.connect(markKeyframesDirty));
+	mConnections.push_back(sequence->valueChanged.connect(markKeyframesDirty));
+	mConnections.push_back(sequence->itemRemoved.connect(markKeyframesDirty));
 }
 
 EntityStateSequenceController::~EntityStateSequenceController()
 {
+	for (auto& connection : mConnections)
+	{
+		connection.disconnect();
+	}
 	setEntity(nullptr);
 }
 
@@ -160,22 +126,39 @@ void EntityStateSequenceController::setStateT(const EntitySequenceState& state)
 
 SequenceStatePtr EntityStateSequenceController::getStateAtInterpolationPoint(const math::InterpolationPoint& point) const
 {
-	glm::dvec3 position;
-	for (int i = 0; i < (int)mPositionInterpolators.size(); ++i)
+	EntityStateSample sample = getKeyframes().evaluateAtInterpolationPoint(point);
+
+	auto state = std::make_shared<EntitySequenceState>();
+	state->position = sample.position;
+	state->orientation = sample.orientation;
+	return state;
+}
+
+EntityStateSample EntityStateSequenceController::getEntityStateAtTime(double t) const
+{
+	return getKeyframes().evaluateAtTime(t);
+}
+
+void EntityStateSequenceController::setTime(double t)
+{
+	EntityStateSample sample = getEntityStateAtTime(t);
+	if (sample.valid)
 	{
-		position[i] = mPositionInterpolators[i]->interpolate(point.bounds.first, point.bounds.last, point.weight);
+		EntitySequenceState state;
+		state.position = sample.position;
+		state.orientation = sample.orientation;
+		setStateT(state);
 	}
+}
 
-	glm::dquat orientation;
-	for (int i = 0; i < (int)mOrientationInterpolators.size(); ++i)
+const EntityStateKeyframes& EntityStateSequenceController::getKeyframes() const
+{
+	if (mKeyframesDirty)
 	{
-		orientation[i] = mOrientationInterpolators[i]->interpolate(point.bounds.first, point.bounds.last, point.weight);
+		mKeyframes->assign(*mSequence);
+		mKeyframesDirty = false;
 	}
-
-	auto state = std::make_shared<EntitySequenceState>();
-	state->position = position;
-	state->orientation = glm::normalize(orientation);
-	return state;
+	return *mKeyframes;
 }
 
 SequenceStatePtr EntityStateSequenceController::getStateAtTime(double t) const
@@ -204,7 +187,15 @@ SequenceStatePtr EntityStateSequenceController::getStateAtTime(double t) const
 
 	return std::make_shared<EntitySequenceState>(finalState);
 #else
-	return StateSequenceControllerT<EntitySequenceState>::getStateAtTime(t);
+	EntityStateSample sample = getEntityStateAtTime(t);
+	if (sample.valid)
+	{
+		auto state = std::make_shared<EntitySequenceState>();
+		state->position = sample.position;
+		state->orientation = sample.orientation;
+		return state;
+	}
+	return nullptr;
 #endif
 }
 
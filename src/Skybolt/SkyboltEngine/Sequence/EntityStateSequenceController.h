@@ -7,7 +7,6 @@
 #pragma once
 
 #include "SequenceController.h"
-#include "SkyboltEngine/Sequence/Interpolator/Interpolator.h"
 #include <SkyboltSim/Entity.h>
 #include <SkyboltSim/SimMath.h>
 #include <SkyboltCommon/Math/MathUtility.h>
@@ -30,6 +29,9 @@ struct EntitySequenceState : public SequenceState
 
 using EntityStateSequence = StateSequenceT<EntitySequenceState>;
 
+class EntityStateKeyframes;
+struct EntityStateSample;
+
 class EntityStateSequenceController : public StateSequenceControllerT<EntitySequenceState>, public sim::Entity::Listener
 {
 public:
@@ -46,6 +48,17 @@ public:
 
 	SequenceStatePtr getStateAtTime(double t) const override;
 
+	//! Equivalent to getStateAtTime() but does not allocate
+	EntityStateSample getEntityStateAtTime(double t) const;
+
+	//! Evaluates the keyframes without allocating, and applies the state through setStateT()
+	void setTime(double t) override;
+
+	//! @returns keyframes which are rebuilt from the sequence on access if it has changed since the last access.
+	//! Changes are detected through the sequence's signals, so the sequence must be modified through StateSequenceT methods rather than by writing to its values directly.
+	//! Use with evaluateEntityStateKeyframesAtTime() to evaluate many sequences in one batch.
+	const EntityStateKeyframes& getKeyframes() const;
+
 	boost::signals2::signal<void(sim::Entity* entity)> entityChanged;
 
 private:
@@ -53,8 +66,8 @@ private:
 
 private:
 	sim::Entity* mEntity = nullptr;
-	std::vector<std::shared_ptr<InterpolatorD>> mPositionInterpolators;
-	std::vector<std::shared_ptr<InterpolatorD>> mOrientationInterpolators;
+	std::unique_ptr<EntityStateKeyframes> mKeyframes;
+	mutable bool mKeyframesDirty = true;
 	std::vector<boost::signals2::connection> mConnections;
 };
 
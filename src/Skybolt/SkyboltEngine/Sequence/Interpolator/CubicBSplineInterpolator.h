@@ -12,6 +12,46 @@
 
 namespace skybolt {
 
+//! Evaluates a cubic bezier segment with end points p0, p3 and control points p1, p2.
+//! @param u is the parameteric interpolation coordinate in range [0, 1]
+template <typename T>
+inline T evalCubicBezier(T p0, T p1, T p2, T p3, double u)
+{
+	// Weights from https://ocw.mit.edu/courses/electrical-engineering-and-computer-science/6-837-computer-graphics-fall-2012/lecture-notes/MIT6_837F12_Lec01.pdf
+	double u2 = u * u;
+	double u3 = u2 * u;
+	double oneMinusU = 1.0 - u;
+	double oneMinusU2 = oneMinusU * oneMinusU;
+	double oneMinusU3 = oneMinusU2 * oneMinusU;
+
+	glm::dvec4 p(p0, p1, p2, p3);
+	glm::dvec4 w;
+	w.x = oneMinusU3;
+	w.y = 3 * u * oneMinusU2;
+	w.z = 3 * u2 * oneMinusU;
+	w.w = u3;
+
+	return glm::dot(p, w);
+}
+
+//! Calculates the bezier control point to the left or right of a spline vertex,
+//! given the vertex and its previous and next neighbours as (time, value) pairs.
+template <typename T>
+inline T calcCubicBSplineControlPoint(const glm::tvec2<T>& p0, const glm::tvec2<T>& p1, const glm::tvec2<T>& p2, bool rightSide)
+{
+	// Calculate gradient
+	using vec = glm::tvec2<T>;
+	vec v0 = glm::normalize(p1 - p0);
+	vec v1 = glm::normalize(p2 - p1);
+
+	vec v = glm::normalize(v0 + v1);
+	T grad = (v.x > T(0)) ? (v.y / v.x) : T(0);
+
+	// Calculate control point offset along tangent by distance of 1/3 to next point
+	T timeOffset = T(1.0/3.0) * (rightSide ? (p2.x - p1.x) : (p0.x - p1.x));
+	return p1.y + grad * timeOffset;
+}
+
 template <typename T>
 class CubicBSplineInterpolator : public Interpolator<T>
 {
@@ -29,26 +69,12 @@ public:
 	//! @param u is the parameteric interpolation coordinate in range [0, 1]
 	T interpolate(int firstIndex, int secondIndex, double u) const override 
 	{
-		glm::dvec4 p;
-		p.x = mValueGetter(firstIndex);
-		p.y = calcControlPointRight(firstIndex);
-		p.z = calcControlPointLeft(secondIndex);
-		p.w = mValueGetter(secondIndex);
-
-		// Weights from https://ocw.mit.edu/courses/electrical-engineering-and-computer-science/6-837-computer-graphics-fall-2012/lecture-notes/MIT6_837F12_Lec01.pdf
-		double u2 = u * u;
-		double u3 = u2 * u;
-		double oneMinusU = 1.0 - u;
-		double oneMinusU2 = oneMinusU * oneMinusU;
-		double oneMinusU3 = oneMinusU2 * oneMinusU;
-
-		glm::dvec4 w;
-		w.x = oneMinusU3;
-		w.y = 3 * u * oneMinusU2;
-		w.z = 3 * u2 * oneMinusU;
-		w.w = u3;
-
-		return glm::dot(p, w);
+		return evalCubicBezier<T>(
+			mValueGetter(firstIndex),
+			calcControlPointRight(firstIndex),
+			calcControlPointLeft(secondIndex),
+			mValueGetter(secondIndex),
+			u);
 	}
 
 private:
@@ -64,7 +90,6 @@ private:
 
 	T calcControlPoint(int index, bool rightSide) const
 	{
-		// Calculate gradient
 		int size = mSizeGetter();
 		int indexPrev = glm::max(0, index - 1);
 		int indexNext = glm::min(size - 1, index + 1);
@@ -73,16 +98,7 @@ private:
 		vec p0(mTimeGetter(indexPrev), mValueGetter(indexPrev));
 		vec p1(mTimeGetter(index), mValueGetter(index));
 		vec p2(mTimeGetter(indexNext), mValueGetter(indexNext));
-
-		vec v0 = glm::normalize(p1 - p0);
-		vec v1 = glm::normalize(p2 - p1);
-
-		vec v = glm::normalize(v0 + v1);
-		T grad = (v.x > T(0)) ? (v.y / v.x) : T(0);
-
-		// Calculate control point offset along tangent by distance of 1/3 to next point
-		T timeOffset = T(1.0/3.0) * (rightSide ? (p2.x - p1.x) : (p0.x - p1.x));
-		return p1.y + grad * timeOffset;
+		return calcCubicBSplineControlPoint(p0, p1, p2, rightSide);
 	}
 
 private:
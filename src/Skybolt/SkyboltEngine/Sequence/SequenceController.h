@@ -37,16 +37,10 @@ struct Sequence
 
 	std::optional<size_t> getIndexAtTime(double time) const
 	{
-		for (size_t i = 0; i < times.size(); ++i)
+		auto it = std::lower_bound(times.begin(), times.end(), time);
+		if (it != times.end() && *it == time)
 		{
-			if (times[i] == time)
-			{
-				return i;
-			}
-			else if (times[i] > time)
-			{
-				break;
-			}
+			return size_t(it - times.begin());
 		}
 		return std::nullopt;
 	}
@@ -75,15 +69,8 @@ struct StateSequenceT : public Sequence
 
 	void addItemAtTime(const SequenceState& value, double time) override
 	{
-		for (size_t i = 0; i < times.size(); ++i)
-		{
-			if (time < times[i])
-			{
-				addItemAtIndex(value, time, i);
-				return;
-			}
-		}
-		addItemAtIndex(value, time, times.size());
+		auto it = std::upper_bound(times.begin(), times.end(), time);
+		addItemAtIndex(value, time, size_t(it - times.begin()));
 	}
 
 	void removeItemAtIndex(size_t index) override
@@ -5,19 +5,26 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "PlanetVisBinding.h"
+#include "GeocentricToNedConverter.h"
 #include <SkyboltSim/Entity.h>
 #include <SkyboltSim/Components/CloudComponent.h>
 #include <SkyboltSim/Components/OceanComponent.h>
+#include <SkyboltSim/Components/PlanetComponent.h>
+#include <SkyboltSim/Physics/WindField.h>
 #include <SkyboltVis/Renderable/Planet/Planet.h>
 #include <SkyboltVis/Renderable/Water/WaterMaterial.h>
 
 namespace skybolt {
 
-PlanetVisBinding::PlanetVisBinding(JulianDateProvider dateProvider, const sim::Entity* entity, const vis::PlanetPtr& visObject) :
+PlanetVisBinding::PlanetVisBinding(JulianDateProvider dateProvider, const sim::Entity* entity, const vis::PlanetPtr& visObject, const sim::WindField* windField) :
 	SimpleSimVisBinding(entity, visObject),
-	mDateProvider(dateProvider)
+	mDateProvider(dateProvider),
+	mWindField(windField)
 {}
 
+//! Clouds are drawn as a single layer, so wind is sampled at one representative altitude
+constexpr double cloudWindSampleAltitude = 3000;
+
 void PlanetVisBinding::syncVis(const GeocentricToNedConverter& converter)
 {
 	SimpleSimVisBinding::syncVis(converter);
@@ -39,6 +46,23 @@ void PlanetVisBinding::syncVis(const GeocentricToNedConverter& converter)
 		visPlanet->setCloudsVisible(cloud->cloudsVisible);
 		visPlanet->setCloudCoverageFraction(cloud->cloudCoverageFraction);
 	}
+
+	// Keep the default cloud drift unless wind has been defined
+	if (mWindField && !mWindField->getModels().empty())
+	{
+		if (auto planet = mEntity->getFirstComponent<sim::PlanetComponent>(); planet)
+		{
+			// Sample wind above the viewer, which is at the origin of the NED frame
+			sim::Vector3 viewerPosition = converter.convertLocalPosition(osg::Vec3d(0, 0, 0));
+			double length = glm::length(viewerPosition);
+			if (length > 0)
+			{
+				sim::Vector3 samplePosition = viewerPosition * ((planet->radius + cloudWindSampleAltitude) / length);
+				sim::Vector3 windNed = mWindField->sampleNed(samplePosition);
+				visPlanet->setCloudWindVelocity(osg::Vec2f(windNed.x, windNed.y));
+			}
+		}
+	}
 }
 
 } // namespace skybolt
\ No newline at end of file
@@ -15,11 +15,13 @@ namespace skybolt {
 class PlanetVisBinding : public SimpleSimVisBinding
 {
 public:
-	PlanetVisBinding(JulianDateProvider dateProvider, const sim::Entity* entity, const vis::PlanetPtr& visObject);
+	//! @param windField is optional. If set, clouds drift with the wind.
+	PlanetVisBinding(JulianDateProvider dateProvider, const sim::Entity* entity, const vis::PlanetPtr& visObject, const sim::WindField* windField = nullptr);
 	void syncVis(const GeocentricToNedConverter& converter) override;
 
 private:
 	JulianDateProvider mDateProvider;
+	const sim::WindField* mWindField;
 };
 
 } // namespace skybolt
\ No newline at end of file
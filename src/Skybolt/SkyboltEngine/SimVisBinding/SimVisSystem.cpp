@@ -8,6 +8,7 @@
 #include "EngineRoot.h"
 #include "SimVisBinding/GeocentricToNedConverter.h"
 #include "SimVisBinding/SimVisBinding.h"
+#include "SimVisBinding/VisObjectAttachmentQueue.h"
 #include <SkyboltCommon/VectorUtility.h>
 #include <SkyboltSim/Components/CameraComponent.h>
 #include <SkyboltSim/Components/Node.h>
@@ -38,6 +39,11 @@ SimVisSystem::~SimVisSystem()
 
 void SimVisSystem::updateState()
 {
+	if (mAttachmentQueue)
+	{
+		mAttachmentQueue->update();
+	}
+
 	Vector3 origin = mSceneOriginProvider();
 
 	// Get nearest planet
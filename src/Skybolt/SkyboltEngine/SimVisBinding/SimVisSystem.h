@@ -38,6 +38,9 @@ public:
 
 	void setSceneOriginProvider(SceneOriginProvider sceneOriginProvider) { mSceneOriginProvider = std::move(sceneOriginProvider); }
 
+	//! Sets a queue of deferred vis objects to attach to the scene, within the queue's budget, on each update
+	void setVisObjectAttachmentQueue(VisObjectAttachmentQueue* queue) { mAttachmentQueue = queue; }
+
 	static SceneOriginProvider sceneOriginFromPosition(const sim::Vector3& position);
 	static SceneOriginProvider sceneOriginFromEntity(const sim::World* world, const sim::EntityId& entity);
 	static SceneOriginProvider sceneOriginFromFirstCamera(const sim::World* world);
@@ -48,6 +51,7 @@ private:
 	SceneOriginProvider mSceneOriginProvider;
 	std::unique_ptr<GeocentricToNedConverter> mCoordinateConverter;
 	std::vector<SimVisBindingPtr> mSimVisBindings;
+	VisObjectAttachmentQueue* mAttachmentQueue = nullptr;
 };
 
 } // namespace skybolt
\ No newline at end of file
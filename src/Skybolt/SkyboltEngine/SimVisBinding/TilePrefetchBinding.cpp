@@ -0,0 +1,210 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TilePrefetchBinding.h"
+#include "GeocentricToNedConverter.h"
+#include "SkyboltEngine/EngineStats.h"
+#include "SkyboltEngine/Sequence/EntityStateKeyframes.h"
+#include "SkyboltEngine/Sequence/EntityStateSequenceController.h"
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/CameraComponent.h>
+#include <SkyboltVis/Renderable/Planet/Planet.h>
+#include <SkyboltVis/Renderable/Planet/PlanetSurface.h>
+
+#include <boost/log/trivial.hpp>
+#include <assert.h>
+
+namespace skybolt {
+
+ObserverProvider createFirstCameraObserverProvider(const sim::World* world)
+{
+	assert(world);
+	// Cache the camera's ID rather than a pointer so that a destroyed camera is never returned
+	auto cameraId = std::make_shared<sim::EntityId>(sim::nullEntityId());
+	return [world, cameraId] () -> const sim::Entity* {
+		if (sim::EntityPtr camera = world->getEntityById(*cameraId); camera)
+		{
+			return camera.get();
+		}
+
+		for (const sim::EntityPtr& entity : world->getEntities())
+		{
+			if (entity->getFirstComponent<sim::CameraComponent>())
+			{
+				*cameraId = entity->getId();
+				return entity.get();
+			}
+		}
+		return nullptr;
+	};
+}
+
+static std::optional<sim::Vector3> extrapolatePosition(const sim::Entity& entity, double secondsAhead)
+{
+	auto position = sim::getPosition(entity);
+	auto velocity = sim::getVelocity(entity);
+	if (position && velocity)
+	{
+		return *position + *velocity * secondsAhead;
+	}
+	return std::nullopt;
+}
+
+ObserverPositionPredictor createVelocityExtrapolationPredictor(const sim::Entity* entity)
+{
+	assert(entity);
+	return [entity] (double secondsAhead) {
+		return extrapolatePosition(*entity, secondsAhead);
+	};
+}
+
+ObserverPositionPredictor createVelocityExtrapolationPredictor(ObserverProvider observerProvider)
+{
+	assert(observerProvider);
+	return [observerProvider = std::move(observerProvider)] (double secondsAhead) -> std::optional<sim::Vector3> {
+		if (const sim::Entity* entity = observerProvider(); entity)
+		{
+			return extrapolatePosition(*entity, secondsAhead);
+		}
+		return std::nullopt;
+	};
+}
+
+ObserverPositionPredictor createSequencePredictor(const StateSequenceControllerPtr& controller, std::function<double()> timeProvider)
+{
+	assert(controller);
+	assert(timeProvider);
+
+	// Entity state sequences can be evaluated without allocating
+	if (auto entityController = std::dynamic_pointer_cast<EntityStateSequenceController>(controller); entityController)
+	{
+		return [entityController, timeProvider = std::move(timeProvider)] (double secondsAhead) -> std::optional<sim::Vector3> {
+			EntityStateSample sample = entityController->getEntityStateAtTime(timeProvider() + secondsAhead);
+			if (sample.valid)
+			{
+				return sample.position;
+			}
+			return std::nullopt;
+		};
+	}
+
+	return [controller, timeProvider = std::move(timeProvider)] (double secondsAhead) -> std::optional<sim::Vector3> {
+		SequenceStatePtr state = controller->getStateAtTime(timeProvider() + secondsAhead);
+		if (auto entityState = dynamic_cast<const EntitySequenceState*>(state.get()); entityState)
+		{
+			return entityState->position;
+		}
+		return std::nullopt;
+	};
+}
+
+std::vector<sim::Vector3> sampleObserverTrajectory(const ObserverPositionPredictor& predictor, const sim::Vector3& currentPosition, const TrajectorySamplingConfig& config)
+{
+	std::vector<sim::Vector3> result;
+	if (config.sampleCount <= 0)
+	{
+		return result;
+	}
+
+	sim::Vector3 previousPosition = currentPosition;
+	for (int i = 1; i <= config.sampleCount; ++i)
+	{
+		double secondsAhead = config.horizonSeconds * double(i) / double(config.sampleCount);
+		std::optional<sim::Vector3> position = predictor(secondsAhead);
+		if (position && glm::distance(*position, previousPosition) >= config.minSampleSeparation)
+		{
+			result.push_back(*position);
+			previousPosition = *position;
+		}
+	}
+	return result;
+}
+
+TilePrefetchBinding::TilePrefetchBinding(ObserverProvider observerProvider, const vis::PlanetPtr& planet, std::vector<ObserverPositionPredictor> predictors,
+	const TrajectorySamplingConfig& config, EngineStats* stats) :
+	mObserverProvider(std::move(observerProvider)),
+	mPlanet(planet),
+	mPredictors(std::move(predictors)),
+	mConfig(config),
+	mStats(stats)
+{
+	assert(mObserverProvider);
+	assert(mPlanet);
+}
+
+TilePrefetchBinding::TilePrefetchBinding(const sim::Entity* observer, const vis::PlanetPtr& planet, std::vector<ObserverPositionPredictor> predictors,
+	const TrajectorySamplingConfig& config) :
+	TilePrefetchBinding([observer] { return observer; }, planet, std::move(predictors), config)
+{
+	assert(observer);
+}
+
+TilePrefetchBinding::~TilePrefetchBinding()
+{
+	if (mStats)
+	{
+		const vis::TilePrefetchStats stats = getPrefetchStats();
+		BOOST_LOG_TRIVIAL(info) << "Tile prefetch requests: " << stats.requestCount << ", hits: " << stats.hitCount
+			<< ", misses: " << stats.missCount << ", evicted unused: " << stats.evictedUnusedCount;
+	}
+}
+
+void TilePrefetchBinding::syncVis(const GeocentricToNedConverter& converter)
+{
+	vis::PlanetSurface* surface = mPlanet->getSurface();
+	if (!surface)
+	{
+		return;
+	}
+
+	mSampledPositions.clear();
+	if (const sim::Entity* observer = mObserverProvider(); observer)
+	{
+		if (auto currentPosition = sim::getPosition(*observer); currentPosition)
+		{
+			for (const ObserverPositionPredictor& predictor : mPredictors)
+			{
+				std::vector<sim::Vector3> positions = sampleObserverTrajectory(predictor, *currentPosition, mConfig);
+				mSampledPositions.insert(mSampledPositions.end(), positions.begin(), positions.end());
+			}
+		}
+	}
+
+	mVisPositions.clear();
+	for (const sim::Vector3& position : mSampledPositions)
+	{
+		mVisPositions.push_back(converter.convertPosition(position));
+	}
+	surface->setPrefetchObserverPositions(mVisPositions);
+
+	updateStats();
+}
+
+vis::TilePrefetchStats TilePrefetchBinding::getPrefetchStats() const
+{
+	if (vis::PlanetSurface* surface = mPlanet->getSurface(); surface)
+	{
+		return surface->getPrefetchStats();
+	}
+	return {};
+}
+
+void TilePrefetchBinding::updateStats()
+{
+	if (!mStats)
+	{
+		return;
+	}
+
+	// Add the change since the last update, so that stats from several planets accumulate
+	const vis::TilePrefetchStats stats = getPrefetchStats();
+	mStats->terrainPrefetchHitCount += stats.hitCount - mReportedStats.hitCount;
+	mStats->terrainPrefetchMissCount += stats.missCount - mReportedStats.missCount;
+	mReportedStats = stats;
+}
+
+} // namespace skybolt
@@ -0,0 +1,93 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SimVisBinding.h"
+#include "SkyboltEngine/SkyboltEngineFwd.h"
+#include <SkyboltSim/SimMath.h>
+#include <SkyboltSim/SkyboltSimFwd.h>
+#include <SkyboltVis/Renderable/Planet/Tile/QuadTreeTileLoader.h>
+#include <SkyboltVis/SkyboltVisFwd.h>
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+
+//! Predicts an observer's position a given number of seconds ahead of the current time.
+//! @returns nullopt if the position cannot be predicted
+using ObserverPositionPredictor = std::function<std::optional<sim::Vector3>(double secondsAhead)>;
+
+//! @returns the observer entity, or null if there is currently no observer
+using ObserverProvider = std::function<const sim::Entity*()>;
+
+//! @returns the first entity in the world with a camera component
+ObserverProvider createFirstCameraObserverProvider(const sim::World* world);
+
+//! Predicts positions by extrapolating the entity's current velocity
+ObserverPositionPredictor createVelocityExtrapolationPredictor(const sim::Entity* entity);
+ObserverPositionPredictor createVelocityExtrapolationPredictor(ObserverProvider observerProvider);
+
+//! Predicts positions by evaluating a sequence ahead of the current time.
+//! Sequences of entity states are supported. Predictions from other sequences are always nullopt.
+//! @param timeProvider returns the current sequence time
+ObserverPositionPredictor createSequencePredictor(const StateSequenceControllerPtr& controller, std::function<double()> timeProvider);
+
+struct TrajectorySamplingConfig
+{
+	double horizonSeconds = 20; //!< How far ahead to predict
+	int sampleCount = 4; //!< Number of samples evenly spaced over the horizon
+
+	//! Samples closer than this distance in meters to the current position or to a previous sample are skipped,
+	//! because the tiles they need are already loaded or being prefetched.
+	double minSampleSeparation = 200;
+};
+
+//! @returns positions predicted at evenly spaced times up to the horizon, excluding samples which could not be predicted
+//! or which are within minSampleSeparation of the current position or a previous sample.
+std::vector<sim::Vector3> sampleObserverTrajectory(const ObserverPositionPredictor& predictor, const sim::Vector3& currentPosition, const TrajectorySamplingConfig& config);
+
+//! Prefetches planet tiles along the predicted path of an observer, such as a camera or the entity it follows,
+//! so that tiles are loaded before the observer arrives.
+class TilePrefetchBinding : public SimVisBinding
+{
+public:
+	//! @param observerProvider provides the entity whose current position is used to skip redundant samples.
+	//! Nothing is prefetched while there is no observer.
+	//! @param predictors predict the observer's future positions. Samples from all predictors are prefetched.
+	//! @param stats if not null, prefetch hits and misses are added to the stats
+	TilePrefetchBinding(ObserverProvider observerProvider, const vis::PlanetPtr& planet, std::vector<ObserverPositionPredictor> predictors,
+		const TrajectorySamplingConfig& config = {}, EngineStats* stats = nullptr);
+
+	TilePrefetchBinding(const sim::Entity* observer, const vis::PlanetPtr& planet, std::vector<ObserverPositionPredictor> predictors,
+		const TrajectorySamplingConfig& config = {});
+
+	~TilePrefetchBinding() override;
+
+	void syncVis(const GeocentricToNedConverter& converter) override;
+
+	//! @returns positions prefetched in the last sync
+	const std::vector<sim::Vector3>& getSampledPositions() const { return mSampledPositions; }
+
+	vis::TilePrefetchStats getPrefetchStats() const;
+
+private:
+	void updateStats();
+
+private:
+	ObserverProvider mObserverProvider;
+	vis::PlanetPtr mPlanet;
+	std::vector<ObserverPositionPredictor> mPredictors;
+	TrajectorySamplingConfig mConfig;
+	EngineStats* mStats;
+	vis::TilePrefetchStats mReportedStats; //!< Stats already added to mStats
+	std::vector<sim::Vector3> mSampledPositions;
+	std::vector<osg::Vec3d> mVisPositions;
+};
+
+} // namespace skybolt
@@ -0,0 +1,62 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "VisObjectAttachmentQueue.h"
+#include <SkyboltVis/Scene.h>
+
+#include <assert.h>
+
+namespace skybolt {
+
+VisObjectAttachmentQueue::VisObjectAttachmentQueue(vis::Scene* scene, size_t maxAttachmentsPerUpdate) :
+	mScene(scene),
+	mMaxAttachmentsPerUpdate(maxAttachmentsPerUpdate)
+{
+	assert(mScene);
+}
+
+void VisObjectAttachmentQueue::push(const vis::VisObjectPtr& object)
+{
+	assert(object);
+	assert(mPendingIterators.find(object.get()) == mPendingIterators.end());
+	mPendingIterators[object.get()] = mPending.insert(mPending.end(), object);
+}
+
+void VisObjectAttachmentQueue::remove(const vis::VisObjectPtr& object)
+{
+	if (auto i = mPendingIterators.find(object.get()); i != mPendingIterators.end())
+	{
+		mPending.erase(i->second);
+		mPendingIterators.erase(i);
+	}
+}
+
+size_t VisObjectAttachmentQueue::update()
+{
+	return attach(mMaxAttachmentsPerUpdate);
+}
+
+void VisObjectAttachmentQueue::flush()
+{
+	attach(mPending.size());
+}
+
+size_t VisObjectAttachmentQueue::attach(size_t maxCount)
+{
+	size_t count = 0;
+	while (!mPending.empty() && count < maxCount)
+	{
+		vis::VisObjectPtr object = std::move(mPending.front());
+		mPending.pop_front();
+		mPendingIterators.erase(object.get());
+
+		mScene->addObject(object);
+		++count;
+	}
+	return count;
+}
+
+} // namespace skybolt
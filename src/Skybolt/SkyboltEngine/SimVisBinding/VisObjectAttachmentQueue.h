@@ -0,0 +1,52 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltVis/SkyboltVisFwd.h>
+
+#include <list>
+#include <unordered_map>
+
+namespace skybolt {
+
+//! Defers adding vis objects to a scene, so that the cost of attaching a large batch of objects
+//! is spread over multiple frames rather than stalling a single frame.
+//! Objects are attached in the order they were queued. Must only be used from the thread that owns the scene.
+class VisObjectAttachmentQueue
+{
+public:
+	//! @param maxAttachmentsPerUpdate is the maximum number of objects attached by each call to update()
+	VisObjectAttachmentQueue(vis::Scene* scene, size_t maxAttachmentsPerUpdate = 200);
+
+	void push(const vis::VisObjectPtr& object);
+
+	//! Removes an object from the queue if it has not been attached yet
+	void remove(const vis::VisObjectPtr& object);
+
+	//! Attaches queued objects to the scene, up to the per-update budget.
+	//! @returns the number of objects attached
+	size_t update();
+
+	//! Attaches all queued objects to the scene
+	void flush();
+
+	size_t getPendingCount() const { return mPending.size(); }
+
+	void setMaxAttachmentsPerUpdate(size_t count) { mMaxAttachmentsPerUpdate = count; }
+
+private:
+	size_t attach(size_t maxCount);
+
+private:
+	vis::Scene* mScene;
+	size_t mMaxAttachmentsPerUpdate;
+
+	std::list<vis::VisObjectPtr> mPending;
+	std::unordered_map<const vis::VisObject*, std::list<vis::VisObjectPtr>::iterator> mPendingIterators;
+};
+
+} // namespace skybolt
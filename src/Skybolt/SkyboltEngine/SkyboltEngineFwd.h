@@ -37,6 +37,7 @@ class Updatable;
 class VisHud;
 class VisNameLabels;
 class VisObjectsComponent;
+class VisObjectAttachmentQueue;
 
 typedef std::shared_ptr<CameraInputSystem> CameraInputSystemPtr;
 typedef std::shared_ptr<ComponentFactory> ComponentFactoryPtr;
@@ -0,0 +1,65 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "FixedStepAdvancer.h"
+#include <SkyboltEngine/Scenario/Scenario.h>
+#include <SkyboltSim/System/SimStepper.h>
+
+#include <assert.h>
+
+namespace skybolt {
+
+using namespace sim;
+
+FixedStepAdvancer::FixedStepAdvancer(const SystemRegistryPtr& systems, Scenario* scenario) :
+	mScenario(scenario),
+	mStepper(std::make_unique<SimStepper>(systems))
+{
+	assert(mScenario);
+
+	// Take as many dynamics substeps as needed so that simulation time is never lost, matching SimUpdater
+	mStepper->setMaxDynamicsSubsteps(std::nullopt);
+}
+
+FixedStepAdvancer::~FixedStepAdvancer() = default;
+
+int FixedStepAdvancer::advance(SecondsD stepDt, int stepCount, int callbackInterval, const FixedStepCallback& callback)
+{
+	assert(stepDt >= 0);
+	TimeSource& timeSource = mScenario->timeSource;
+	mStepper->setDynamicsEnabled(mScenario->timelineMode.get() == TimelineMode::Live);
+
+	// The time source may have been changed since the last call, for example by loading a scenario
+	if (mStepper->getTime() != timeSource.getTime())
+	{
+		mStepper->setTime(timeSource.getTime());
+	}
+
+	for (int step = 0; step < stepCount; ++step)
+	{
+		// The time source clamps to the end of its range, so check before stepping to avoid
+		// updating systems while time is pinned. Steps of zero duration are still taken.
+		if (stepDt > 0 && timeSource.getTime() >= timeSource.getRange().end)
+		{
+			return step;
+		}
+
+		mStepper->update(stepDt);
+		timeSource.setTime(mStepper->getTime());
+
+		int stepsTaken = step + 1;
+		if (callback && callbackInterval > 0 && stepsTaken % callbackInterval == 0)
+		{
+			if (!callback(stepsTaken))
+			{
+				return stepsTaken;
+			}
+		}
+	}
+	return stepCount;
+}
+
+} // namespace skybolt
@@ -0,0 +1,47 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltEngine/SkyboltEngineFwd.h>
+#include <SkyboltSim/Chrono.h>
+#include <SkyboltSim/System/SystemRegistry.h>
+
+#include <functional>
+#include <memory>
+
+namespace skybolt {
+
+//! Called after every callbackInterval steps with the number of steps taken so far in the current advance() call.
+//! @returns false to stop advancing
+using FixedStepCallback = std::function<bool(int stepsTaken)>;
+
+//! Advances the simulation by a number of fixed size steps in a single call.
+//! The advancer owns a persistent SimStepper, so the simulation time and the dynamics substep remainder carry over between calls.
+//! The scenario's time source is kept in sync with the stepper in the same way as SimUpdater.
+class FixedStepAdvancer
+{
+public:
+	FixedStepAdvancer(const sim::SystemRegistryPtr& systems, Scenario* scenario);
+	~FixedStepAdvancer();
+
+	//! Advances the simulation by stepCount steps of duration stepDt.
+	//! A step with zero duration updates systems without advancing time.
+	//! Steps with non-zero duration are not taken once the end of the scenario's time range has been reached,
+	//! so systems are not updated while time cannot advance.
+	//! @param callbackInterval is the number of steps between calls to callback. If zero, callback is not called.
+	//! @returns number of steps taken, which is less than stepCount if the callback returned false
+	//! or the end of the scenario's time range was reached. Returns zero if already at the end of the time range.
+	int advance(sim::SecondsD stepDt, int stepCount, int callbackInterval = 0, const FixedStepCallback& callback = nullptr);
+
+	sim::SimStepper& getStepper() { return *mStepper; }
+
+private:
+	Scenario* mScenario;
+	std::unique_ptr<sim::SimStepper> mStepper;
+};
+
+} // namespace skybolt
@@ -37,6 +37,11 @@ BulletDynamicBodyComponent::BulletDynamicBodyComponent(const BulletDynamicBodyCo
 	mBody->setDamping(0.0, 0.0);
 	mBody->setUserPointer(this);
 
+	if (config.sleeping)
+	{
+		mWorld->setSleepingConfig(mBody, config.sleeping);
+	}
+
 	setPosition(mNode->getPosition());
 	setOrientation(mNode->getOrientation());
 	mBody->setLinearVelocity(toBtVector3(mMotion->linearVelocity));
@@ -53,26 +58,48 @@ void BulletDynamicBodyComponent::updatePreDynamics()
 	if (mDynamicsEnabled)
 	{
 		// Reset position and orientation if the node was moved by an external source since the last timestep
+		bool movedExternally = false;
 		auto newNodePosition = mNode->getPosition();
 		if (mNodePosition != newNodePosition)
 		{
 			setPosition(mNode->getPosition());
+			movedExternally = true;
 		}
 
 		auto newNodeOrientation = mNode->getOrientation();
 		if (mNodeOrientation != newNodeOrientation)
 		{
 			setOrientation(mNode->getOrientation());
+			movedExternally = true;
 		}
 
-		mBody->setLinearVelocity(toBtVector3(mMotion->linearVelocity));
-		mBody->setAngularVelocity(toBtVector3(mMotion->angularVelocity));
+		btVector3 linearVelocity = toBtVector3(mMotion->linearVelocity);
+		btVector3 angularVelocity = toBtVector3(mMotion->angularVelocity);
+
+		if (mBody->isActive())
+		{
+			mBody->setLinearVelocity(linearVelocity);
+			mBody->setAngularVelocity(angularVelocity);
+		}
+		else if (movedExternally || linearVelocity != mBody->getLinearVelocity() || angularVelocity != mBody->getAngularVelocity())
+		{
+			// Body is sleeping and was disturbed by an external source
+			mBody->activate();
+			mBody->setLinearVelocity(linearVelocity);
+			mBody->setAngularVelocity(angularVelocity);
+		}
 	}
 }
 
 void BulletDynamicBodyComponent::updatePostDynamics()
 {
-	if (mDynamicsEnabled)
+	// Node state only needs to be updated if the body was integrated in this substep.
+	// A body that fell asleep in this substep was still integrated, so update it one last time.
+	bool bodyActive = mBody->isActive();
+	bool bodyIntegrated = bodyActive || mBodyWasActive;
+	mBodyWasActive = bodyActive;
+
+	if (mDynamicsEnabled && bodyIntegrated)
 	{
 		// Calculate new node position
 		btVector3 worldSpaceCenterOfMass = quatRotate(mBody->getOrientation(), mCenterOfMass);
@@ -123,6 +150,7 @@ void BulletDynamicBodyComponent::setDynamicsEnabled(bool enabled)
 	if (enabled)
 	{
 		mBody->setMassProps(mMass, mMomentOfInertia);
+		mBody->activate();
 	}
 	else
 	{
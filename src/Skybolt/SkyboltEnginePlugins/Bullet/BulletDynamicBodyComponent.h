@@ -33,6 +33,7 @@ struct BulletDynamicBodyComponentConfig
 	btVector3 velocity;
 	int collisionGroupMask;
 	int collisionFilterMask;
+	std::optional<RigidBodySleepingConfig> sleeping; //!< If set, the body is allowed to sleep when at rest
 };
 
 class BulletDynamicBodyComponent : public DynamicBodyComponent
@@ -98,6 +99,7 @@ private:
 	double mMass;
 
 	bool mDynamicsEnabled;
+	bool mBodyWasActive = true; //!< True if the body was active in the previous substep
 	std::vector<AppliedForce> mCurrentForces; //!< For visualization purposes. Used to populate mForcesAppliedInLastSubstep in base class.
 };
 
@@ -73,6 +73,24 @@ static btCollisionShapePtr loadPlanetCollisionShape(const PlanetComponent& plane
 	return compoundShape;
 }
 
+//! Sleeping is opt-in, enabled by a "sleeping" object in the body's json
+static std::optional<RigidBodySleepingConfig> readSleepingConfig(const nlohmann::json& json)
+{
+	auto it = json.find("sleeping");
+	if (it == json.end())
+	{
+		return std::nullopt;
+	}
+
+	const nlohmann::json& j = it.value();
+	RigidBodySleepingConfig config;
+	readOptionalToVar(j, "linearThreshold", config.linearThreshold);
+	readOptionalToVar(j, "angularThreshold", config.angularThreshold);
+	readOptionalToVar(j, "wakeLinearAccelerationThreshold", config.wakeLinearAccelerationThreshold);
+	readOptionalToVar(j, "wakeAngularAccelerationThreshold", config.wakeAngularAccelerationThreshold);
+	return config;
+}
+
 static sim::ComponentPtr loadBulletDynamicBody(BulletWorld& world, Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json)
 {
 	double mass = json.at("mass");
@@ -80,8 +98,7 @@ static sim::ComponentPtr loadBulletDynamicBody(BulletWorld& world, Entity* entit
 	int collisionGroupMask = CollisionGroupMasks::simBody;
 	int collisionFilterMask = ~0;
 
-	// TODO: dispose of shape
-	auto shape = std::make_shared<btBoxShape>(toBtVector3(readVector3(json.at("size")) * 0.5));
+	btCollisionShapePtr shape = world.getShapeLibrary().getBox(toBtVector3(readVector3(json.at("size")) * 0.5));
 
 	btVector3 momentOfInertia = toBtVector3(readOptionalVector3(json, "momentOfInertia"));
 	if (momentOfInertia == btVector3(0, 0, 0))
@@ -103,6 +120,7 @@ static sim::ComponentPtr loadBulletDynamicBody(BulletWorld& world, Entity* entit
 		c.velocity = velocity;
 		c.collisionGroupMask = collisionGroupMask;
 		c.collisionFilterMask = collisionFilterMask;
+		c.sleeping = readSleepingConfig(json);
 		return c;
 	}());
 
@@ -132,7 +150,7 @@ public:
 
 		(*mComponentFactoryRegistry)[kinematicBodyComponentName] = std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
 			auto node = entity->getFirstComponentRequired<Node>().get();
-			auto shape = std::make_shared<btBoxShape>(toBtVector3(readVector3(json.at("size")) * 0.5));
+			btCollisionShapePtr shape = mBulletWorld->getShapeLibrary().getBox(toBtVector3(readVector3(json.at("size")) * 0.5));
 			return std::make_shared<KinematicBody>(mBulletWorld.get(), entity->getId(), node, shape, CollisionGroupMasks::simBody);
 		});
 
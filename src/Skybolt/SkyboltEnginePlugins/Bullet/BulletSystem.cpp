@@ -48,38 +48,28 @@ std::optional<RayIntersectionResult> BulletSystem::intersectRay(const Vector3 &s
 
 void BulletSystem::performSubStep()
 {
-	mWorld->getDynamicsWorld()->stepSimulation(mDt, 0, mDt);
-	processCollisionEvents();
+	mWorld->stepSimulation(mDt);
+	mContactEventAggregator.addContacts(*mWorld->getDynamicsWorld()->getDispatcher());
+	mSubStepsPerformedSinceLastPublish = true;
 	mDt = 0;
 };
 
-void BulletSystem::processCollisionEvents()
+void BulletSystem::publishCollisionEvents()
 {
-	const auto& dynamicsWorld = mWorld->getDynamicsWorld();
-    int numManifolds = dynamicsWorld->getDispatcher()->getNumManifolds();
-	for (int i=0; i<numManifolds; i++)
+	mCollisionEvents.clear();
+
+	// Contacts are unchanged if no substeps were performed, so keep the current contact state
+	if (!mSubStepsPerformedSinceLastPublish)
 	{
-		btPersistentManifold* contactManifold = dynamicsWorld->getDispatcher()->getManifoldByIndexInternal(i);
-		const btCollisionObject* objectA = contactManifold->getBody0();
-		const btCollisionObject* objectB = contactManifold->getBody1();
+		return;
+	}
+	mSubStepsPerformedSinceLastPublish = false;
 
-		int numContacts = contactManifold->getNumContacts();
-		for (int j=0;j<numContacts;j++)
-		{
-			btManifoldPoint& pt = contactManifold->getContactPoint(j);
-			if (pt.getDistance()<0.f)
-			{
-				CollisionEvent event;
-				event.entityA = objectA->getUserPointer() ? getEntity(*objectA) : nullEntityId();
-				event.entityB = objectB->getUserPointer() ? getEntity(*objectB) : nullEntityId();
-				event.position = toGlmDvec3(pt.getPositionWorldOnB());
-				event.normalB = toGlmDvec3(pt.m_normalWorldOnB);
-				if (event.entityA != nullEntityId() || event.entityB != nullEntityId())
-				{
-					mEventEmitter->emitEvent(event);
-				}
-			}
-		}
+	mContactEventAggregator.generateEvents(mCollisionEvents);
+
+	for (const CollisionEvent& event : mCollisionEvents)
+	{
+		mEventEmitter->emitEvent(event);
 	}
 }
 
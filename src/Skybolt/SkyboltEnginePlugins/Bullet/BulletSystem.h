@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "ContactEventAggregator.h"
 #include <SkyboltSim/System/CollisionSystem.h>
 
 class btCollisionObject;
@@ -21,6 +22,7 @@ public:
 
 	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
 		SKYBOLT_REGISTER_UPDATE_HANDLER(sim::UpdateStage::DynamicsSubStep, performSubStep)
+		SKYBOLT_REGISTER_UPDATE_HANDLER(sim::UpdateStage::EndStateUpdate, publishCollisionEvents)
 	SKYBOLT_END_REGISTER_UPDATE_HANDLERS
 
 	void advanceSimTime(SecondsD newTime, SecondsD dt) override;
@@ -29,12 +31,14 @@ public:
 
 	void performSubStep();
 
-private:
-	void processCollisionEvents();
+	//! Generates collision events for contacts in all substeps since the last call
+	void publishCollisionEvents();
 
 private:
 	BulletWorld* mWorld;
 	double mDt = 0;
+	ContactEventAggregator mContactEventAggregator;
+	bool mSubStepsPerformedSinceLastPublish = false;
 };
 
 sim::EntityId getEntity(const btCollisionObject& object);
@@ -9,6 +9,7 @@
 #include "BulletSystem.h"
 #include "BulletTypeConversion.h"
 
+#include <SkyboltCommon/VectorUtility.h>
 #include <SkyboltSim/CollisionGroupMasks.h>
 
 namespace skybolt {
@@ -52,9 +53,36 @@ RigidBody* BulletWorld::createRigidBody(const btCollisionShapePtr& shape, double
 
 void BulletWorld::destroyRigidBody(RigidBody* body)
 {
+	if (body->getSleepingConfig())
+	{
+		eraseFirst(mSleepableBodies, body);
+	}
 	delete body; 
 }
 
+void BulletWorld::setSleepingConfig(RigidBody* body, const std::optional<RigidBodySleepingConfig>& config)
+{
+	if (body->getSleepingConfig())
+	{
+		eraseFirst(mSleepableBodies, body);
+	}
+	if (config)
+	{
+		mSleepableBodies.push_back(body);
+	}
+	body->setSleepingConfig(config);
+}
+
+void BulletWorld::stepSimulation(double dt)
+{
+	for (RigidBody* body : mSleepableBodies)
+	{
+		body->wakeIfForcesChanged();
+	}
+
+	mDynamicsWorld->stepSimulation(dt, 0, dt);
+}
+
 std::optional<RayIntersectionResult> BulletWorld::intersectRay(const Vector3 &start, const Vector3 &end, int collisionFilterMask)
 {
 	btVector3 startBullet = toBtVector3(start);
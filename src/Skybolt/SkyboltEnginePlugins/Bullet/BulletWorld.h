@@ -6,17 +6,18 @@
 
 #pragma once
 
+#include "CollisionShapeLibrary.h"
+#include "RigidBody.h"
 #include "SkyboltBulletFwd.h"
 #include <btBulletDynamicsCommon.h>
 #include <SkyboltSim/SimMath.h>
 #include <SkyboltSim/System/CollisionSystem.h>
 #include <memory>
+#include <vector>
 
 namespace skybolt {
 namespace sim {
 
-class RigidBody;
-
 typedef std::shared_ptr<btDiscreteDynamicsWorld> btDiscreteDynamicsWorldPtr;
 
 
@@ -31,12 +32,23 @@ public:
 
 	void destroyRigidBody(RigidBody* body);
 
+	//! Allows a body to sleep when it comes to rest. If config is empty, the body never sleeps.
+	void setSleepingConfig(RigidBody* body, const std::optional<RigidBodySleepingConfig>& config);
+
+	//! Advances the simulation by a single step of duration dt.
+	//! Sleeping bodies are woken first if the forces applied to them have changed.
+	void stepSimulation(double dt);
+
+	CollisionShapeLibrary& getShapeLibrary() { return mShapeLibrary; }
+
 	inline btDiscreteDynamicsWorld* getDynamicsWorld() { return mDynamicsWorld.get(); }
 
 	virtual std::optional<RayIntersectionResult> intersectRay(const Vector3 &start, const Vector3 &end, int collisionFilterMask);
 
 private:
 	btDiscreteDynamicsWorldPtr mDynamicsWorld;
+	CollisionShapeLibrary mShapeLibrary;
+	std::vector<RigidBody*> mSleepableBodies; //!< Bodies with sleeping enabled
 };
 
 } // namespace sim
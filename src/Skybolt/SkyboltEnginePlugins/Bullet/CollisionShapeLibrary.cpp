@@ -0,0 +1,47 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "CollisionShapeLibrary.h"
+
+namespace skybolt {
+namespace sim {
+
+btCollisionShapePtr CollisionShapeLibrary::getBox(const btVector3& halfExtents)
+{
+	BoxKey key = {halfExtents.x(), halfExtents.y(), halfExtents.z()};
+
+	std::scoped_lock<std::mutex> lock(mMutex);
+	if (auto i = mBoxes.find(key); i != mBoxes.end())
+	{
+		if (btCollisionShapePtr shape = i->second.lock(); shape)
+		{
+			return shape;
+		}
+	}
+
+	// Remove entries for shapes that are no longer used
+	std::erase_if(mBoxes, [](const auto& item) {
+		return item.second.expired();
+	});
+
+	auto shape = std::make_shared<btBoxShape>(halfExtents);
+	mBoxes[key] = shape;
+	return shape;
+}
+
+size_t CollisionShapeLibrary::getShapeCount() const
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	size_t count = 0;
+	for (const auto& [key, shape] : mBoxes)
+	{
+		count += !shape.expired();
+	}
+	return count;
+}
+
+} // namespace sim
+} // namespace skybolt
@@ -0,0 +1,38 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltBulletFwd.h"
+#include <btBulletDynamicsCommon.h>
+#include <array>
+#include <map>
+#include <mutex>
+
+namespace skybolt {
+namespace sim {
+
+//! Deduplicates identical collision shapes across entities.
+//! Shapes are shared between all bodies requesting the same shape, and destroyed once no body uses them.
+//! Thread safe.
+class CollisionShapeLibrary
+{
+public:
+	//! @returns a box shape with the given half extents
+	btCollisionShapePtr getBox(const btVector3& halfExtents);
+
+	//! @returns number of distinct shapes currently in use
+	size_t getShapeCount() const;
+
+private:
+	using BoxKey = std::array<btScalar, 3>;
+
+	mutable std::mutex mMutex;
+	std::map<BoxKey, std::weak_ptr<btCollisionShape>> mBoxes;
+};
+
+} // namespace sim
+} // namespace skybolt
@@ -0,0 +1,153 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "ContactEventAggregator.h"
+#include "BulletSystem.h"
+#include "BulletTypeConversion.h"
+
+#include <btBulletDynamicsCommon.h>
+
+#include <algorithm>
+
+namespace skybolt::sim {
+
+static EntityId getEntityOrNull(const btCollisionObject& object)
+{
+	return object.getUserPointer() ? getEntity(object) : nullEntityId();
+}
+
+void ContactEventAggregator::addContacts(btDispatcher& dispatcher)
+{
+	++mSubstep;
+
+	// A pair may have several manifolds, e.g. one per child of a compound shape,
+	// so contacts are summed over all manifolds of the pair in this substep.
+	int numManifolds = dispatcher.getNumManifolds();
+	for (int i = 0; i < numManifolds; ++i)
+	{
+		const btPersistentManifold* manifold = dispatcher.getManifoldByIndexInternal(i);
+
+		// Aggregate the manifold's penetrating contact points
+		int contactCount = 0;
+		double impulse = 0;
+		const btManifoldPoint* deepestPoint = nullptr;
+
+		int numContacts = manifold->getNumContacts();
+		for (int j = 0; j < numContacts; ++j)
+		{
+			const btManifoldPoint& pt = manifold->getContactPoint(j);
+			if (pt.getDistance() < 0)
+			{
+				++contactCount;
+				impulse += pt.getAppliedImpulse();
+				if (!deepestPoint || pt.getDistance() < deepestPoint->getDistance())
+				{
+					deepestPoint = &pt;
+				}
+			}
+		}
+
+		if (contactCount == 0)
+		{
+			continue;
+		}
+
+		// Objects without entities have no stable identity and are never reported, so are not tracked
+		EntityId entity0 = getEntityOrNull(*manifold->getBody0());
+		EntityId entity1 = getEntityOrNull(*manifold->getBody1());
+		if (entity0 == nullEntityId() && entity1 == nullEntityId())
+		{
+			continue;
+		}
+
+		// Key is independent of the order in which Bullet reports the objects
+		bool swapped = entity1 < entity0;
+		PairState& pair = findOrAddPair(swapped ? PairKey{entity1, entity0} : PairKey{entity0, entity1});
+		if (!pair.touchingInPeriod)
+		{
+			pair.touchingInPeriod = true;
+			pair.peakImpulse = 0;
+		}
+
+		bool firstManifoldInSubstep = (pair.lastSubstep != mSubstep);
+		if (firstManifoldInSubstep)
+		{
+			pair.lastSubstep = mSubstep;
+			pair.substepImpulse = 0;
+			pair.contactCount = 0;
+		}
+		pair.substepImpulse += impulse;
+		pair.contactCount += contactCount;
+		pair.peakImpulse = std::max(pair.peakImpulse, pair.substepImpulse);
+
+		// Report the deepest point over all manifolds in the frame of the pair's first entity
+		if (firstManifoldInSubstep || deepestPoint->getDistance() < pair.deepestDistance)
+		{
+			pair.deepestDistance = deepestPoint->getDistance();
+			pair.position = toGlmDvec3(swapped ? deepestPoint->getPositionWorldOnA() : deepestPoint->getPositionWorldOnB());
+			pair.normalB = toGlmDvec3(swapped ? -deepestPoint->m_normalWorldOnB : deepestPoint->m_normalWorldOnB);
+		}
+	}
+}
+
+ContactEventAggregator::PairState& ContactEventAggregator::findOrAddPair(const PairKey& key)
+{
+	auto [it, inserted] = mPairIndices.try_emplace(key, mPairs.size());
+	if (inserted)
+	{
+		PairState& pair = mPairs.emplace_back();
+		pair.key = key;
+		return pair;
+	}
+	return mPairs[it->second];
+}
+
+void ContactEventAggregator::generateEvents(std::vector<CollisionEvent>& events)
+{
+	bool pairsRemoved = false;
+	for (PairState& pair : mPairs)
+	{
+		CollisionEvent event;
+		event.entityA = pair.key.entityA;
+		event.entityB = pair.key.entityB;
+		event.position = pair.position;
+		event.normalB = pair.normalB;
+
+		if (pair.touchingInPeriod)
+		{
+			event.phase = pair.touchingInPreviousPeriod ? CollisionEvent::Phase::Persist : CollisionEvent::Phase::Begin;
+			event.impulse = pair.peakImpulse;
+			event.contactCount = pair.contactCount;
+		}
+		else
+		{
+			event.phase = CollisionEvent::Phase::End;
+			event.impulse = 0;
+			event.contactCount = 0;
+			pairsRemoved = true;
+		}
+
+		events.push_back(event);
+
+		pair.touchingInPreviousPeriod = pair.touchingInPeriod;
+		pair.touchingInPeriod = false;
+	}
+
+	if (pairsRemoved)
+	{
+		std::erase_if(mPairs, [] (const PairState& pair) {
+			return !pair.touchingInPreviousPeriod;
+		});
+
+		mPairIndices.clear();
+		for (size_t i = 0; i < mPairs.size(); ++i)
+		{
+			mPairIndices[mPairs[i].key] = i;
+		}
+	}
+}
+
+} // namespace skybolt::sim
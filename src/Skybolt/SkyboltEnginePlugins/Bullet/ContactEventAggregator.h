@@ -0,0 +1,75 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltSim/System/CollisionSystem.h>
+
+#include <unordered_map>
+#include <vector>
+
+class btDispatcher;
+
+namespace skybolt::sim {
+
+//! Maintains a table of touching entity pairs and aggregates their contact points
+//! over the substeps of a sim step into one begin, persist or end event per pair.
+class ContactEventAggregator
+{
+public:
+	//! Accumulates contacts from the dispatcher's manifolds. Call after each simulation substep.
+	void addContacts(btDispatcher& dispatcher);
+
+	//! Appends events for contacts accumulated since the last call, and starts a new accumulation period.
+	//! Should only be called if addContacts() has been called at least once since the last call,
+	//! otherwise all pairs would be considered to have stopped touching.
+	void generateEvents(std::vector<CollisionEvent>& events);
+
+	//! @returns number of pairs in the contact table
+	size_t getPairCount() const { return mPairs.size(); }
+
+private:
+	//! Pairs are keyed by entity rather than by collision object, because collision object addresses may be reused
+	//! after objects are destroyed. Contacts between different bodies of the same two entities are merged into one pair.
+	struct PairKey
+	{
+		EntityId entityA;
+		EntityId entityB;
+
+		bool operator==(const PairKey& other) const { return entityA == other.entityA && entityB == other.entityB; }
+	};
+
+	struct PairKeyHash
+	{
+		size_t operator()(const PairKey& key) const
+		{
+			return std::hash<EntityId>()(key.entityA) ^ (std::hash<EntityId>()(key.entityB) * 31);
+		}
+	};
+
+	struct PairState
+	{
+		PairKey key;
+		bool touchingInPeriod = false; //!< True if the pair touched in any substep of the current accumulation period
+		bool touchingInPreviousPeriod = false;
+		double peakImpulse = 0; //!< Peak over the substeps of the period of the impulse summed over all the pair's manifolds
+		int lastSubstep = -1; //!< Index of the latest substep in which the pair touched
+		double substepImpulse = 0; //!< Impulse summed over the pair's manifolds in lastSubstep
+		int contactCount = 0; //!< Contact points summed over the pair's manifolds in lastSubstep
+		double deepestDistance = 0; //!< Distance of the deepest contact point over the pair's manifolds in lastSubstep
+		Vector3 position;
+		Vector3 normalB;
+	};
+
+	PairState& findOrAddPair(const PairKey& key);
+
+private:
+	int mSubstep = 0; //!< Incremented on each call to addContacts()
+	std::vector<PairState> mPairs; //!< Pairs in the order they started touching, so that event order is deterministic
+	std::unordered_map<PairKey, size_t, PairKeyHash> mPairIndices; //!< Index of each pair in mPairs
+};
+
+} // namespace skybolt::sim
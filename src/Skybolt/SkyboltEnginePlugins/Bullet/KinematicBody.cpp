@@ -18,7 +18,9 @@ KinematicBody::KinematicBody(BulletWorld* world, EntityId ownerEntityId, Node* n
 					   const Vector3 &localPosition, const Quaternion &localOrientation) :
 	mWorld(world),
 	mOwnerEntityId(ownerEntityId),
-	mNode(node)
+	mNode(node),
+	mNodePosition(node->getPosition()),
+	mNodeOrientation(node->getOrientation())
 {
 	// TODO: un-hardcode collision filter mask
 	mBody = world->createRigidBody(shape, 0, btVector3(0, 0, 0), toBtVector3(node->getPosition()), toBtQuaternion(node->getOrientation()), btVector3(0, 0, 0), collisionGroupMask, ~CollisionGroupMasks::terrain);
@@ -33,6 +35,16 @@ KinematicBody::~KinematicBody()
 
 void KinematicBody::updatePreDynamics()
 {
-	mBody->setPosition(toBtVector3(mNode->getPosition()));
-	mBody->setOrientation(toBtQuaternion(mNode->getOrientation()));
+	// Only update the body if the node has moved, since most kinematic bodies are stationary
+	if (mNodePosition != mNode->getPosition())
+	{
+		mNodePosition = mNode->getPosition();
+		mBody->setPosition(toBtVector3(mNodePosition));
+	}
+
+	if (mNodeOrientation != mNode->getOrientation())
+	{
+		mNodeOrientation = mNode->getOrientation();
+		mBody->setOrientation(toBtQuaternion(mNodeOrientation));
+	}
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "SkyboltBulletFwd.h"
 #include <SkyboltSim/Component.h>
 #include <SkyboltSim/EntityId.h>
+#include <SkyboltSim/SimMath.h>
 #include <SkyboltSim/SkyboltSimFwd.h>
 
 class btCollisionShape;
@@ -40,6 +41,8 @@ private:
 	EntityId mOwnerEntityId;
 	Node* mNode;
 	RigidBody* mBody;
+	Vector3 mNodePosition;
+	Quaternion mNodeOrientation;
 };
 
 } // namespace sim
@@ -72,6 +72,47 @@ void RigidBody::setOrientation(const btQuaternion& orientation)
 	getMotionState()->setWorldTransform(t);
 }
 
+void RigidBody::setSleepingConfig(const std::optional<RigidBodySleepingConfig>& config)
+{
+	mSleepingConfig = config;
+	if (config)
+	{
+		setSleepingThresholds(config->linearThreshold, config->angularThreshold);
+		forceActivationState(ACTIVE_TAG);
+	}
+	else
+	{
+		forceActivationState(DISABLE_DEACTIVATION);
+	}
+	activate();
+}
+
+void RigidBody::wakeIfForcesChanged()
+{
+	if (!mSleepingConfig)
+	{
+		return;
+	}
+
+	if (isActive())
+	{
+		mLastActiveForce = getTotalForce();
+		mLastActiveTorque = getTotalTorque();
+		return;
+	}
+
+	// Steady forces such as gravity are balanced by contacts while the body is at rest,
+	// so only wake the body if the forces differ from those applied when it fell asleep.
+	btVector3 linearAcceleration = (getTotalForce() - mLastActiveForce) * getInvMass();
+	btVector3 angularAcceleration = getInvInertiaTensorWorld() * (getTotalTorque() - mLastActiveTorque);
+
+	if (linearAcceleration.length2() > mSleepingConfig->wakeLinearAccelerationThreshold * mSleepingConfig->wakeLinearAccelerationThreshold ||
+		angularAcceleration.length2() > mSleepingConfig->wakeAngularAccelerationThreshold * mSleepingConfig->wakeAngularAccelerationThreshold)
+	{
+		activate();
+	}
+}
+
 void RigidBody::setCollisionGroupMask(int mask)
 {
 	mCollisionGroupMask = mask;
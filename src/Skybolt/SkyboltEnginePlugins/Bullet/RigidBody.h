@@ -12,10 +12,27 @@
 #include <SkyboltSim/EntityId.h>
 #include <SkyboltSim/SimMath.h>
 #include <btBulletDynamicsCommon.h>
+#include <optional>
 
 namespace skybolt {
 namespace sim {
 
+//! Thresholds controlling when a body is deactivated (put to sleep) and when it is woken again.
+//! Sleeping bodies are not integrated by Bullet, so they cost almost nothing per substep.
+struct RigidBodySleepingConfig
+{
+	double linearThreshold = 0.8; //!< Body may sleep once its linear speed stays below this value, in m/s
+	double angularThreshold = 1.0; //!< Body may sleep once its angular speed stays below this value, in rad/s
+
+	//! A sleeping body is woken if the net applied force differs from the force applied when it fell asleep
+	//! by more than the force needed to produce this acceleration, in m/s^2.
+	double wakeLinearAccelerationThreshold = 0.5;
+
+	//! A sleeping body is woken if the net applied torque differs from the torque applied when it fell asleep
+	//! by more than the torque needed to produce this angular acceleration, in rad/s^2.
+	double wakeAngularAccelerationThreshold = 0.5;
+};
+
 class RigidBody : public btRigidBody
 {
 public:
@@ -34,6 +51,15 @@ public:
 	void setCollisionGroupMask(int mask);
 	int getCollisionGroupMask() const {return mCollisionGroupMask;}
 
+	//! Allows the body to sleep when it comes to rest. If config is empty, the body never sleeps.
+	//! Sleeping is disabled by default. Use BulletWorld::setSleepingConfig() rather than calling this directly.
+	void setSleepingConfig(const std::optional<RigidBodySleepingConfig>& config);
+	const std::optional<RigidBodySleepingConfig>& getSleepingConfig() const { return mSleepingConfig; }
+
+	//! Must be called after forces have been applied and before each simulation step.
+	//! Wakes the body if it is sleeping and the applied forces have changed significantly since it fell asleep.
+	void wakeIfForcesChanged();
+
 private:
 	EntityId mOwnerEntityId;
 	btDiscreteDynamicsWorld* mWorld;
@@ -41,6 +67,10 @@ private:
 	int mCollisionFilterMask;
 	int mCollisionGroupMask;
 	bool mInWorld;
+
+	std::optional<RigidBodySleepingConfig> mSleepingConfig;
+	btVector3 mLastActiveForce = btVector3(0, 0, 0); //!< Net force applied during the last step in which the body was active
+	btVector3 mLastActiveTorque = btVector3(0, 0, 0); //!< Net torque applied during the last step in which the body was active
 };
 
 } // namespace sim
@@ -0,0 +1,45 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <Bullet/CollisionShapeLibrary.h>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+TEST_CASE("CollisionShapeLibrary shares identical shapes")
+{
+	CollisionShapeLibrary library;
+
+	btCollisionShapePtr a = library.getBox(btVector3(1, 2, 3));
+	btCollisionShapePtr b = library.getBox(btVector3(1, 2, 3));
+	btCollisionShapePtr c = library.getBox(btVector3(1, 2, 4));
+
+	CHECK(a == b);
+	CHECK(a != c);
+	CHECK(library.getShapeCount() == 2);
+
+	auto box = dynamic_cast<btBoxShape*>(c.get());
+	REQUIRE(box);
+	CHECK(box->getHalfExtentsWithMargin() == btVector3(1, 2, 4));
+}
+
+TEST_CASE("CollisionShapeLibrary releases shapes that are no longer used")
+{
+	CollisionShapeLibrary library;
+
+	btCollisionShapePtr a = library.getBox(btVector3(1, 1, 1));
+	std::weak_ptr<btCollisionShape> weakA = a;
+	a.reset();
+
+	CHECK(weakA.expired());
+	CHECK(library.getShapeCount() == 0);
+
+	// A new shape is created on the next request
+	btCollisionShapePtr b = library.getBox(btVector3(1, 1, 1));
+	CHECK(b);
+	CHECK(library.getShapeCount() == 1);
+}
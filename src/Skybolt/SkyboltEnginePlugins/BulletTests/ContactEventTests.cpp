@@ -0,0 +1,245 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <Bullet/BulletDynamicBodyComponent.h>
+#include <Bullet/BulletSystem.h>
+#include <Bullet/BulletWorld.h>
+#include <Bullet/KinematicBody.h>
+#include <SkyboltSim/CollisionGroupMasks.h>
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/Node.h>
+
+#include <btBulletDynamicsCommon.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+constexpr double substepDt = 1.0 / 240.0;
+constexpr int substepsPerStep = 4;
+constexpr double gravity = 9.8;
+constexpr double bodyMass = 1000;
+
+constexpr EntityId groundEntityId = {1, 1};
+constexpr EntityId boxEntityId = {1, 2};
+
+namespace {
+
+class CollisionEventRecorder : public EventListener
+{
+public:
+	void onEvent(const Event& event) override
+	{
+		events.push_back(static_cast<const CollisionEvent&>(event));
+	}
+
+	std::vector<CollisionEvent> events;
+};
+
+//! Headless scene with a box resting on a ground plane, stepped in the same stage order as SimStepper
+struct ContactScene
+{
+	//! @param boxShape is the shape of the dynamic body, or null to use a single box
+	explicit ContactScene(const btCollisionShapePtr& boxShape = nullptr) :
+		groundNode(Vector3(0, 0, 0)),
+		boxNode(Vector3(0, 0, 1.5)),
+		system(&world)
+	{
+		ground = std::make_unique<KinematicBody>(&world, groundEntityId, &groundNode, std::make_shared<btStaticPlaneShape>(btVector3(0, 0, 1), 0), CollisionGroupMasks::terrain);
+
+		BulletDynamicBodyComponentConfig config;
+		config.world = &world;
+		config.ownerEntityId = boxEntityId;
+		config.node = &boxNode;
+		config.motion = &boxMotion;
+		config.mass = bodyMass;
+		config.shape = boxShape ? boxShape : world.getShapeLibrary().getBox(btVector3(0.5, 0.5, 0.5));
+		config.shape->calculateLocalInertia(bodyMass, config.momentOfInertia);
+		config.velocity = btVector3(0, 0, 0);
+		config.collisionGroupMask = CollisionGroupMasks::simBody;
+		config.collisionFilterMask = ~0;
+		box = std::make_unique<BulletDynamicBodyComponent>(config);
+	}
+
+	void step()
+	{
+		for (int i = 0; i < substepsPerStep; ++i)
+		{
+			time += substepDt;
+			ground->updatePreDynamics();
+			box->updatePreDynamics();
+			box->applyCentralForce(Vector3(0, 0, -gravity * bodyMass));
+			system.advanceSimTime(time, substepDt);
+			system.update(UpdateStage::DynamicsSubStep);
+			box->updatePostDynamics();
+		}
+		system.update(UpdateStage::EndStateUpdate);
+	}
+
+	BulletWorld world;
+	Node groundNode;
+	Node boxNode;
+	Motion boxMotion;
+	BulletSystem system;
+	std::unique_ptr<KinematicBody> ground;
+	std::unique_ptr<BulletDynamicBodyComponent> box;
+	double time = 0;
+};
+
+} // namespace
+
+static bool isGroundBoxPair(const CollisionEvent& event)
+{
+	return (event.entityA == groundEntityId && event.entityB == boxEntityId) ||
+		(event.entityA == boxEntityId && event.entityB == groundEntityId);
+}
+
+TEST_CASE("BulletSystem emits one aggregated collision event per touching pair per step")
+{
+	ContactScene scene;
+	CollisionEventRecorder recorder;
+	scene.system.getEventEmitter()->addEventListener<CollisionEvent>(&recorder);
+
+	// Box falls onto the ground
+	int stepCount = 0;
+	while (scene.system.getCollisionEvents().empty())
+	{
+		CHECK(recorder.events.empty());
+		scene.step();
+		REQUIRE(++stepCount < 100);
+	}
+
+	// Contact begins
+	{
+		const std::vector<CollisionEvent>& events = scene.system.getCollisionEvents();
+		REQUIRE(events.size() == 1);
+		CHECK(events[0].phase == CollisionEvent::Phase::Begin);
+		CHECK(isGroundBoxPair(events[0]));
+		CHECK(events[0].impulse > 0);
+		CHECK(events[0].contactCount >= 1);
+		CHECK(events[0].contactCount <= 4);
+	}
+
+	// Contact persists while the box rests on the ground
+	for (int i = 0; i < 120; ++i)
+	{
+		scene.step();
+		const std::vector<CollisionEvent>& events = scene.system.getCollisionEvents();
+		REQUIRE(events.size() == 1);
+		CHECK(events[0].phase == CollisionEvent::Phase::Persist);
+		CHECK(isGroundBoxPair(events[0]));
+		CHECK(events[0].contactCount >= 1);
+	}
+
+	// Peak impulse of resting contact supports the box's weight for one substep
+	CHECK(scene.system.getCollisionEvents()[0].impulse == Approx(bodyMass * gravity * substepDt).epsilon(0.5));
+
+	// Contact ends when box is moved away from the ground
+	scene.boxNode.setPosition(Vector3(0, 0, 10));
+	scene.step();
+	{
+		const std::vector<CollisionEvent>& events = scene.system.getCollisionEvents();
+		REQUIRE(events.size() == 1);
+		CHECK(events[0].phase == CollisionEvent::Phase::End);
+		CHECK(isGroundBoxPair(events[0]));
+		CHECK(events[0].impulse == 0);
+		CHECK(events[0].contactCount == 0);
+	}
+
+	scene.step();
+	CHECK(scene.system.getCollisionEvents().empty());
+
+	// Listener received the same events, once per step
+	CHECK(recorder.events.size() == 1 + 120 + 1);
+	CHECK(recorder.events.front().phase == CollisionEvent::Phase::Begin);
+	CHECK(recorder.events.back().phase == CollisionEvent::Phase::End);
+}
+
+TEST_CASE("BulletSystem keeps contact state across steps with no substeps")
+{
+	ContactScene scene;
+	for (int i = 0; i < 60; ++i)
+	{
+		scene.step();
+	}
+	REQUIRE(scene.system.getCollisionEvents().size() == 1);
+	CHECK(scene.system.getCollisionEvents()[0].phase == CollisionEvent::Phase::Persist);
+
+	// A step with no substeps produces no events and does not end the contact
+	scene.system.update(UpdateStage::EndStateUpdate);
+	CHECK(scene.system.getCollisionEvents().empty());
+
+	scene.step();
+	REQUIRE(scene.system.getCollisionEvents().size() == 1);
+	CHECK(scene.system.getCollisionEvents()[0].phase == CollisionEvent::Phase::Persist);
+}
+
+//! @returns a compound of two boxes side by side, for which Bullet creates one manifold per child when touching the ground
+static btCollisionShapePtr createTwoBoxCompoundShape()
+{
+	auto childShape = std::make_shared<btBoxShape>(btVector3(0.5, 0.5, 0.5));
+	auto compound = new btCompoundShape();
+	compound->addChildShape(btTransform(btQuaternion::getIdentity(), btVector3(-1, 0, 0)), childShape.get());
+	compound->addChildShape(btTransform(btQuaternion::getIdentity(), btVector3(1, 0, 0)), childShape.get());
+
+	// Compound shape does not own its children, so keep the child alive for the compound's lifetime
+	return btCollisionShapePtr(compound, [childShape] (btCollisionShape* shape) { delete shape; });
+}
+
+static int countPenetratingContacts(const btPersistentManifold& manifold)
+{
+	int count = 0;
+	for (int i = 0; i < manifold.getNumContacts(); ++i)
+	{
+		count += (manifold.getContactPoint(i).getDistance() < 0) ? 1 : 0;
+	}
+	return count;
+}
+
+TEST_CASE("BulletSystem aggregates contacts over all manifolds of a pair")
+{
+	ContactScene scene(createTwoBoxCompoundShape());
+	for (int i = 0; i < 120; ++i)
+	{
+		scene.step();
+	}
+
+	// Both children of the compound rest on the ground, each with its own manifold
+	btDispatcher& dispatcher = *scene.world.getDynamicsWorld()->getDispatcher();
+	int touchingManifoldCount = 0;
+	int contactCount = 0;
+	double deepestDistance = 0;
+	for (int i = 0; i < dispatcher.getNumManifolds(); ++i)
+	{
+		const btPersistentManifold& manifold = *dispatcher.getManifoldByIndexInternal(i);
+		int count = countPenetratingContacts(manifold);
+		touchingManifoldCount += (count > 0) ? 1 : 0;
+		contactCount += count;
+		for (int j = 0; j < manifold.getNumContacts(); ++j)
+		{
+			deepestDistance = std::min(deepestDistance, double(manifold.getContactPoint(j).getDistance()));
+		}
+	}
+	REQUIRE(touchingManifoldCount == 2);
+
+	// One event for the pair, with contacts and impulse summed over both manifolds
+	const std::vector<CollisionEvent>& events = scene.system.getCollisionEvents();
+	REQUIRE(events.size() == 1);
+	CHECK(isGroundBoxPair(events[0]));
+	CHECK(events[0].phase == CollisionEvent::Phase::Persist);
+	CHECK(events[0].contactCount == contactCount);
+
+	// Peak impulse supports the whole body's weight, not just the half resting on one child
+	CHECK(events[0].impulse == Approx(bodyMass * gravity * substepDt).epsilon(0.25));
+
+	// Reported point is the deepest over both manifolds, and lies under one of the children
+	CHECK(deepestDistance < 0);
+	CHECK(std::abs(std::abs(events[0].position.x) - 1) < 0.6);
+	CHECK(events[0].position.z == Approx(0).margin(-deepestDistance + 1e-3));
+}
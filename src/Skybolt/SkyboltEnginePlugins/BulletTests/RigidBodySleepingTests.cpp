@@ -0,0 +1,234 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <Bullet/BulletDynamicBodyComponent.h>
+#include <Bullet/BulletWorld.h>
+#include <Bullet/RigidBody.h>
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/Node.h>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+constexpr double dt = 1.0 / 60.0;
+constexpr double gravity = 9.8;
+constexpr double bodyMass = 1000;
+
+static RigidBody* createGround(BulletWorld& world)
+{
+	auto shape = std::make_shared<btStaticPlaneShape>(btVector3(0, 0, 1), 0);
+	return world.createRigidBody(shape, 0, btVector3(0, 0, 0), btVector3(0, 0, 0));
+}
+
+static RigidBody* createBox(BulletWorld& world, const btVector3& position)
+{
+	btCollisionShapePtr shape = world.getShapeLibrary().getBox(btVector3(0.5, 0.5, 0.5));
+	btVector3 inertia;
+	shape->calculateLocalInertia(bodyMass, inertia);
+	return world.createRigidBody(shape, bodyMass, inertia, position);
+}
+
+//! Applies gravity as an external force, as EntitySystem does, then steps the world
+static void step(BulletWorld& world, const std::vector<RigidBody*>& bodies, int stepCount = 1)
+{
+	for (int i = 0; i < stepCount; ++i)
+	{
+		for (RigidBody* body : bodies)
+		{
+			body->applyCentralForce(btVector3(0, 0, -gravity * bodyMass));
+		}
+		world.stepSimulation(dt);
+	}
+}
+
+TEST_CASE("Bodies only sleep if sleeping is enabled")
+{
+	BulletWorld world;
+	RigidBody* ground = createGround(world);
+	RigidBody* sleepingBody = createBox(world, btVector3(0, 0, 0.5));
+	RigidBody* nonSleepingBody = createBox(world, btVector3(10, 0, 0.5));
+	world.setSleepingConfig(sleepingBody, RigidBodySleepingConfig());
+
+	step(world, {sleepingBody, nonSleepingBody}, 300);
+
+	CHECK(!sleepingBody->isActive());
+	CHECK(nonSleepingBody->isActive());
+
+	// Sleeping body should stay at rest on the ground
+	CHECK(sleepingBody->getWorldTransform().getOrigin().z() == Approx(0.5).margin(0.05));
+
+	world.destroyRigidBody(sleepingBody);
+	world.destroyRigidBody(nonSleepingBody);
+	world.destroyRigidBody(ground);
+}
+
+TEST_CASE("Sleeping body wakes when applied forces change")
+{
+	BulletWorld world;
+	RigidBody* ground = createGround(world);
+	RigidBody* body = createBox(world, btVector3(0, 0, 0.5));
+	world.setSleepingConfig(body, RigidBodySleepingConfig());
+
+	step(world, {body}, 300);
+	REQUIRE(!body->isActive());
+
+	// Small change in force does not wake the body
+	body->applyCentralForce(btVector3(0.1 * bodyMass, 0, 0));
+	step(world, {body});
+	CHECK(!body->isActive());
+
+	// Large change in force wakes the body
+	body->applyCentralForce(btVector3(5 * bodyMass, 0, 0));
+	step(world, {body});
+	CHECK(body->isActive());
+
+	world.destroyRigidBody(body);
+	world.destroyRigidBody(ground);
+}
+
+TEST_CASE("Sleeping dynamic body component wakes when node is moved externally")
+{
+	BulletWorld world;
+	RigidBody* ground = createGround(world);
+
+	Node node(Vector3(0, 0, 0.5));
+	Motion motion;
+
+	BulletDynamicBodyComponentConfig config;
+	config.world = &world;
+	config.ownerEntityId = nullEntityId();
+	config.node = &node;
+	config.motion = &motion;
+	config.mass = bodyMass;
+	config.shape = world.getShapeLibrary().getBox(btVector3(0.5, 0.5, 0.5));
+	config.shape->calculateLocalInertia(bodyMass, config.momentOfInertia);
+	config.velocity = btVector3(0, 0, 0);
+	config.collisionGroupMask = ~0;
+	config.collisionFilterMask = ~0;
+	config.sleeping = RigidBodySleepingConfig();
+
+	BulletDynamicBodyComponent component(config);
+
+	auto substep = [&] {
+		component.updatePreDynamics();
+		component.applyCentralForce(Vector3(0, 0, -gravity * bodyMass));
+		world.stepSimulation(dt);
+		component.updatePostDynamics();
+	};
+
+	for (int i = 0; i < 300; ++i)
+	{
+		substep();
+	}
+	REQUIRE(!component.getRigidBody()->isActive());
+
+	// Node should be synchronized with final resting state
+	Vector3 restingPosition = node.getPosition();
+	CHECK(restingPosition.z == Approx(0.5).margin(0.05));
+	CHECK(glm::length(motion.linearVelocity) == 0.0);
+
+	// Node state should not change while sleeping
+	substep();
+	CHECK(node.getPosition() == restingPosition);
+
+	// Moving the node wakes the body
+	node.setPosition(Vector3(0, 0, 10));
+	substep();
+	CHECK(component.getRigidBody()->isActive());
+	CHECK(node.getPosition().z < 10);
+	CHECK(node.getPosition().z > 9);
+
+	// Setting velocity wakes the body
+	for (int i = 0; i < 600; ++i)
+	{
+		substep();
+	}
+	REQUIRE(!component.getRigidBody()->isActive());
+	motion.linearVelocity = Vector3(10, 0, 0);
+	substep();
+	CHECK(component.getRigidBody()->isActive());
+	CHECK(node.getPosition().x > 0);
+
+	world.destroyRigidBody(ground);
+}
+
+TEST_CASE("Benchmark stepping idle and active bodies", "[.][benchmark]")
+{
+	constexpr int idleBodyCount = 500;
+	constexpr int activeBodyCount = 20;
+
+	auto createScene = [&] (BulletWorld& world, bool enableSleeping) {
+		std::vector<RigidBody*> bodies;
+		for (int i = 0; i < idleBodyCount; ++i)
+		{
+			bodies.push_back(createBox(world, btVector3((i % 50) * 3.0, (i / 50) * 3.0, 0.5)));
+		}
+		for (int i = 0; i < activeBodyCount; ++i)
+		{
+			// Active bodies move in free space above the idle bodies
+			RigidBody* body = createBox(world, btVector3(i * 3.0, -100, 100));
+			body->setLinearVelocity(btVector3(0, 10, 0));
+			bodies.push_back(body);
+		}
+
+		if (enableSleeping)
+		{
+			for (RigidBody* body : bodies)
+			{
+				world.setSleepingConfig(body, RigidBodySleepingConfig());
+			}
+		}
+		return bodies;
+	};
+
+	auto stepActiveBodies = [&] (BulletWorld& world, const std::vector<RigidBody*>& bodies) {
+		// Apply gravity to idle bodies only, so that active bodies keep flying
+		for (int i = 0; i < idleBodyCount; ++i)
+		{
+			bodies[i]->applyCentralForce(btVector3(0, 0, -gravity * bodyMass));
+		}
+		world.stepSimulation(dt);
+	};
+
+	BulletWorld worldWithoutSleeping;
+	RigidBody* ground1 = createGround(worldWithoutSleeping);
+	std::vector<RigidBody*> bodies1 = createScene(worldWithoutSleeping, false);
+
+	BulletWorld worldWithSleeping;
+	RigidBody* ground2 = createGround(worldWithSleeping);
+	std::vector<RigidBody*> bodies2 = createScene(worldWithSleeping, true);
+
+	// Let idle bodies settle
+	for (int i = 0; i < 300; ++i)
+	{
+		stepActiveBodies(worldWithoutSleeping, bodies1);
+		stepActiveBodies(worldWithSleeping, bodies2);
+	}
+
+	BENCHMARK("Substep without sleeping")
+	{
+		stepActiveBodies(worldWithoutSleeping, bodies1);
+	};
+
+	BENCHMARK("Substep with sleeping")
+	{
+		stepActiveBodies(worldWithSleeping, bodies2);
+	};
+
+	for (RigidBody* body : bodies1)
+	{
+		worldWithoutSleeping.destroyRigidBody(body);
+	}
+	worldWithoutSleeping.destroyRigidBody(ground1);
+
+	for (RigidBody* body : bodies2)
+	{
+		worldWithSleeping.destroyRigidBody(body);
+	}
+	worldWithSleeping.destroyRigidBody(ground2);
+}
@@ -0,0 +1,173 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "FftOceanSurfaceSampler.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <cmath>
+
+namespace skybolt {
+namespace vis {
+
+static int wrapIndex(int i, int size)
+{
+	int r = i % size;
+	return (r < 0) ? r + size : r;
+}
+
+//! Bilinearly samples the displacement field with wrapping, matching the GL_LINEAR + GL_REPEAT texture lookup used by the ocean shader
+static glm::dvec3 sampleDisplacement(const FftOceanField& field, const glm::dvec2& position)
+{
+	double texelsPerMeter = double(field.sizePixels) / double(field.worldSize);
+
+	// Wrap before scaling to preserve precision for large coordinates
+	glm::dvec2 texelCoord = glm::mod(position, glm::dvec2(field.worldSize)) * texelsPerMeter - 0.5;
+	glm::dvec2 texelFloor = glm::floor(texelCoord);
+	glm::dvec2 weight = texelCoord - texelFloor;
+
+	int size = field.sizePixels;
+	int x0 = wrapIndex(int(texelFloor.x), size);
+	int y0 = wrapIndex(int(texelFloor.y), size);
+	int x1 = wrapIndex(x0 + 1, size);
+	int y1 = wrapIndex(y0 + 1, size);
+
+	const glm::vec3* data = field.displacement.data();
+	glm::dvec3 v00(data[y0 * size + x0]);
+	glm::dvec3 v10(data[y0 * size + x1]);
+	glm::dvec3 v01(data[y1 * size + x0]);
+	glm::dvec3 v11(data[y1 * size + x1]);
+
+	return glm::mix(glm::mix(v00, v10, weight.x), glm::mix(v01, v11, weight.x), weight.y);
+}
+
+//! @returns altitude of the displaced surface vertex that lands on position
+static double calcAltitudeUnfiltered(const FftOceanField& field, const glm::dvec2& position)
+{
+	// The surface is displaced horizontally as well as vertically, so find the undisplaced
+	// position whose displaced position lands on the query point by fixed point iteration.
+	constexpr int iterationCount = 3;
+	glm::dvec2 sourcePosition = position;
+	glm::dvec3 displacement;
+	for (int i = 0; i < iterationCount; ++i)
+	{
+		displacement = sampleDisplacement(field, sourcePosition);
+		sourcePosition = position - glm::dvec2(displacement);
+	}
+	return sampleDisplacement(field, sourcePosition).z;
+}
+
+static bool isValid(const FftOceanField& field)
+{
+	return field.sizePixels > 0 && field.displacement.size() == size_t(field.sizePixels * field.sizePixels);
+}
+
+double FftOceanSurfaceSampler::calcAltitude(const FftOceanField& field, const glm::dvec2& position, double filterRadius)
+{
+	if (!isValid(field))
+	{
+		return 0.0;
+	}
+
+	double texelSize = double(field.worldSize) / double(field.sizePixels);
+	if (filterRadius <= texelSize * 0.5)
+	{
+		return calcAltitudeUnfiltered(field, position);
+	}
+
+	// Box filter over a 3x3 grid spanning the filter radius
+	double sum = 0;
+	for (int y = -1; y <= 1; ++y)
+	{
+		for (int x = -1; x <= 1; ++x)
+		{
+			sum += calcAltitudeUnfiltered(field, position + glm::dvec2(x, y) * filterRadius);
+		}
+	}
+	return sum / 9.0;
+}
+
+sim::Vector3 FftOceanSurfaceSampler::calcNormalNed(const FftOceanField& field, const glm::dvec2& position, double filterRadius)
+{
+	if (!isValid(field))
+	{
+		return sim::Vector3(0, 0, -1);
+	}
+
+	double texelSize = double(field.worldSize) / double(field.sizePixels);
+	double delta = std::max(texelSize, filterRadius);
+
+	double dAltitudeDNorth = (calcAltitude(field, position + glm::dvec2(delta, 0), filterRadius) - calcAltitude(field, position - glm::dvec2(delta, 0), filterRadius)) / (2.0 * delta);
+	double dAltitudeDEast = (calcAltitude(field, position + glm::dvec2(0, delta), filterRadius) - calcAltitude(field, position - glm::dvec2(0, delta), filterRadius)) / (2.0 * delta);
+
+	// Altitude is up, which is negative in NED
+	return glm::normalize(sim::Vector3(-dAltitudeDNorth, -dAltitudeDEast, -1.0));
+}
+
+FftOceanSurfaceSampler::FftOceanSurfaceSampler(std::shared_ptr<const FftOceanFieldBuffer> fieldBuffer) :
+	mFieldBuffer(std::move(fieldBuffer))
+{
+	assert(mFieldBuffer);
+}
+
+double FftOceanSurfaceSampler::calcOceanAltitude(const sim::LatLon& position, double filterRadius) const
+{
+	if (!mFrame)
+	{
+		return 0.0;
+	}
+	return calcAltitude(mFieldBuffer->getReadBuffer(), toWaveTexturePosition(position), filterRadius);
+}
+
+sim::Vector3 FftOceanSurfaceSampler::calcOceanNormalNed(const sim::LatLon& position, double filterRadius) const
+{
+	if (!mFrame)
+	{
+		return sim::Vector3(0, 0, -1);
+	}
+	return calcNormalNed(mFieldBuffer->getReadBuffer(), toWaveTexturePosition(position), filterRadius);
+}
+
+void FftOceanSurfaceSampler::calcOceanAltitudes(std::span<const sim::LatLon> positions, double filterRadius, std::span<double> results) const
+{
+	assert(positions.size() == results.size());
+	if (!mFrame)
+	{
+		std::fill(results.begin(), results.end(), 0.0);
+		return;
+	}
+
+	const FftOceanField& field = mFieldBuffer->getReadBuffer();
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		results[i] = calcAltitude(field, toWaveTexturePosition(positions[i]), filterRadius);
+	}
+}
+
+void FftOceanSurfaceSampler::calcOceanNormalsNed(std::span<const sim::LatLon> positions, double filterRadius, std::span<sim::Vector3> results) const
+{
+	assert(positions.size() == results.size());
+	if (!mFrame)
+	{
+		std::fill(results.begin(), results.end(), sim::Vector3(0, 0, -1));
+		return;
+	}
+
+	const FftOceanField& field = mFieldBuffer->getReadBuffer();
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		results[i] = calcNormalNed(field, toWaveTexturePosition(positions[i]), filterRadius);
+	}
+}
+
+glm::dvec2 FftOceanSurfaceSampler::toWaveTexturePosition(const sim::LatLon& position) const
+{
+	osg::Vec2d p = toWaveTextureSpace(*mFrame, position);
+	return glm::dvec2(p.x(), p.y());
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,71 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltCommon/TripleBuffer.h>
+#include <SkyboltSim/OceanSurfaceSampler.h>
+#include <SkyboltVis/Renderable/Water/WaveHeightTextureGenerator.h>
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+//! Vector displacement field of the ocean surface, as calculated by FftOceanGenerator
+struct FftOceanField
+{
+	//! Row-major image of size (sizePixels, sizePixels), tiling with period worldSize.
+	//! Components are (x, y) horizontal displacement and z height, in meters.
+	//! Image x and y axes are aligned with the wave texture space axes, see toWaveTextureSpace().
+	std::vector<glm::vec3> displacement;
+	int sizePixels = 0;
+	float worldSize = 0;
+	double time = 0;
+};
+
+using FftOceanFieldBuffer = TripleBuffer<FftOceanField>;
+
+//! Samples the ocean surface from the most recent FftOceanField, at the same wave texture coordinates as the ocean shader.
+//! The field is read from the consumer side of the buffer, so the sampler must be used on the
+//! same thread that calls FftOceanFieldBuffer::update(), which is the thread that calls
+//! FftOceanWaveHeightTextureGenerator::generate().
+//! The surface is flat until a frame has been set with setFrame().
+class FftOceanSurfaceSampler : public sim::OceanSurfaceSampler
+{
+public:
+	FftOceanSurfaceSampler(std::shared_ptr<const FftOceanFieldBuffer> fieldBuffer);
+	~FftOceanSurfaceSampler() override = default;
+
+	//! Sets the mapping from planet positions to wave texture space. Must be called on the same thread as the sampling functions.
+	void setFrame(const WaveTextureFrame& frame) { mFrame = frame; }
+
+	double calcOceanAltitude(const sim::LatLon& position, double filterRadius) const override;
+	sim::Vector3 calcOceanNormalNed(const sim::LatLon& position, double filterRadius) const override;
+
+	void calcOceanAltitudes(std::span<const sim::LatLon> positions, double filterRadius, std::span<double> results) const override;
+	void calcOceanNormalsNed(std::span<const sim::LatLon> positions, double filterRadius, std::span<sim::Vector3> results) const override;
+
+	//! @returns altitude of the surface at a point in wave texture space, given in meters
+	static double calcAltitude(const FftOceanField& field, const glm::dvec2& position, double filterRadius);
+
+	//! @returns surface normal in NED coordinates at a point in wave texture space, given in meters.
+	//! Wave texture space x and y axes are assumed to be aligned with north and east.
+	static sim::Vector3 calcNormalNed(const FftOceanField& field, const glm::dvec2& position, double filterRadius);
+
+private:
+	glm::dvec2 toWaveTexturePosition(const sim::LatLon& position) const;
+
+private:
+	std::shared_ptr<const FftOceanFieldBuffer> mFieldBuffer;
+	std::optional<WaveTextureFrame> mFrame;
+};
+
+} // namespace vis
+} // namespace skybolt
@@ -7,6 +7,7 @@
 #include <SkyboltVis/Renderable/Water/WaveHeightTextureGenerator.h>
 #include "WaveSpectrumWindow.h"
 #include "FftOceanGenerator.h"
+#include "FftOceanSurfaceSampler.h"
 
 #include <atomic>
 #include <condition_variable>
@@ -32,7 +33,15 @@ public:
 	{
 		mWindVelocity = calcWindVelocity();
 
-		mGeneratorResult = std::vector<glm::vec3>(config.textureSizePixels * config.textureSizePixels, glm::vec3(0,0,0));
+		mGeneratorResult = std::make_shared<FftOceanFieldBuffer>([&] {
+			FftOceanField field;
+			field.displacement = std::vector<glm::vec3>(config.textureSizePixels * config.textureSizePixels, glm::vec3(0,0,0));
+			field.sizePixels = config.textureSizePixels;
+			field.worldSize = config.textureWorldSize;
+			return field;
+			}());
+
+		mSurfaceSampler = std::make_shared<FftOceanSurfaceSampler>(mGeneratorResult);
 
 		mGenerator.reset(new FftOceanGenerator([&] {
 			FftOceanGeneratorConfig c;
@@ -78,21 +87,23 @@ public:
 			return false;
 		}
 
-		if (mGeneratorHasResult)
+		// Take the latest result from the generator thread without blocking.
+		// The read buffer is owned by this thread until the next update, so it can be copied without a lock.
+		if (mGeneratorResult->update())
 		{
+			const FftOceanField& field = mGeneratorResult->getReadBuffer();
 			osg::Image* image = mTexture->getImage();
-			{
-				// Copy image from generator thread to texture
-				std::lock_guard<std::mutex> lock(mGeneratorResultMutex);
-				memcpy(image->data(), mGeneratorResult.data(), mGeneratorResult.size() * sizeof(float) * 3);
-				mResultTime = mRequestTime;
+			memcpy(image->data(), field.displacement.data(), field.displacement.size() * sizeof(float) * 3);
+			image->dirty();
+			mResultTime = field.time;
 
-				// Request a new image to be generated
+			// Request a new image to be generated
+			{
+				std::lock_guard<std::mutex> lock(mGeneratorRequestMutex);
 				mGeneratorRequest = true;
 				mRequestTime = time;
 			}
 			mGeneratorRequestCV.notify_one();
-			image->dirty();
 			return true;
 		}
 		return false;
@@ -103,9 +114,12 @@ public:
 		while (!mTerminateGeneratorThread)
 		{
 			// Wait for generation request
+			double requestTime;
 			{
 				std::unique_lock<std::mutex> lock(mGeneratorRequestMutex);
 				mGeneratorRequestCV.wait(lock, [this] {return mGeneratorRequest || mTerminateGeneratorThread; });
+				requestTime = mRequestTime;
+				mGeneratorRequest = false;
 			}
 
 			if (mTerminateGeneratorThread)
@@ -113,19 +127,17 @@ public:
 				return;
 			}
 
+			if (mWindVelocityChanged)
 			{
-				std::lock_guard<std::mutex> lock(mGeneratorResultMutex);
-
-				if (mWindVelocityChanged)
-				{
-					mGenerator->setWindVelocity(mWindVelocity);
-					mWindVelocityChanged = false;
-				}
-
-				mGenerator->calculate(mRequestTime, std::span<glm::vec3>{mGeneratorResult.data(), mGeneratorResult.size()});
-				mGeneratorHasResult = true;
-				mGeneratorRequest = false;
+				mGenerator->setWindVelocity(mWindVelocity);
+				mWindVelocityChanged = false;
 			}
+
+			// Calculate into the write buffer, which is exclusively owned by this thread, and then hand it off
+			FftOceanField& field = mGeneratorResult->getWriteBuffer();
+			mGenerator->calculate(requestTime, std::span<glm::vec3>{field.displacement.data(), field.displacement.size()});
+			field.time = requestTime;
+			mGeneratorResult->publish();
 		}
 	}
 
@@ -168,6 +180,10 @@ public:
 
 	float getTextureWorldSize(int index) const { return mWorldSize; }
 
+	void setWaveTextureFrame(const WaveTextureFrame& frame) override { mSurfaceSampler->setFrame(frame); }
+
+	sim::OceanSurfaceSamplerPtr getSurfaceSampler() const override { return mSurfaceSampler; }
+
 private:
 	glm::vec2 calcWindVelocity() const {
 		float windSpeed = FftOceanGenerator::calcWindSpeedFromMaxWaveHeight(mWaveHeight, mGravity);
@@ -185,12 +201,11 @@ private:
 	std::thread mGeneratorThread;
 	std::atomic_bool mTerminateGeneratorThread = false;
 
-	std::vector<glm::vec3> mGeneratorResult;
-	std::mutex mGeneratorResultMutex;
-	std::atomic_bool mGeneratorHasResult = false;
+	std::shared_ptr<FftOceanFieldBuffer> mGeneratorResult; //!< Produced by generator thread, consumed by generate()
+	std::shared_ptr<FftOceanSurfaceSampler> mSurfaceSampler;
 	double mResultTime = std::numeric_limits<double>::infinity();
 
-	std::mutex mGeneratorRequestMutex;
+	std::mutex mGeneratorRequestMutex; //!< Guards the request variables below
 	std::condition_variable mGeneratorRequestCV;
 	double mRequestTime = 0;
 	bool mGeneratorRequest = false;
@@ -0,0 +1,249 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <FftOcean/FftOceanGenerator.h>
+#include <FftOcean/FftOceanSurfaceSampler.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+constexpr int fieldSizePixels = 256;
+constexpr float fieldWorldSize = 100;
+constexpr double waveAmplitude = 2.0;
+constexpr double earthRadius = 6371000.0;
+constexpr double moonRadius = 1737400.0;
+
+//! Single wave travelling north with wavelength equal to the field size
+static double analyticAltitude(const glm::dvec2& positionNe)
+{
+	return waveAmplitude * std::sin(2.0 * math::piD() * positionNe.x / fieldWorldSize);
+}
+
+static double analyticAltitudeGradientNorth(const glm::dvec2& positionNe)
+{
+	return waveAmplitude * 2.0 * math::piD() / fieldWorldSize * std::cos(2.0 * math::piD() * positionNe.x / fieldWorldSize);
+}
+
+static FftOceanField createAnalyticField(const glm::vec2& horizontalDisplacement = glm::vec2(0))
+{
+	FftOceanField field;
+	field.sizePixels = fieldSizePixels;
+	field.worldSize = fieldWorldSize;
+	field.displacement.resize(fieldSizePixels * fieldSizePixels);
+
+	double texelSize = fieldWorldSize / fieldSizePixels;
+	for (int y = 0; y < fieldSizePixels; ++y)
+	{
+		for (int x = 0; x < fieldSizePixels; ++x)
+		{
+			// Sample at texel centers
+			glm::dvec2 position = (glm::dvec2(x, y) + 0.5) * texelSize;
+			field.displacement[y * fieldSizePixels + x] = glm::vec3(horizontalDisplacement, float(analyticAltitude(position)));
+		}
+	}
+	return field;
+}
+
+TEST_CASE("FFT ocean surface sampler matches analytic wave field")
+{
+	FftOceanField field = createAnalyticField();
+
+	for (double north = -150; north < 150; north += 7.3)
+	{
+		glm::dvec2 position(north, 42.0);
+		CHECK(FftOceanSurfaceSampler::calcAltitude(field, position, 0) == Approx(analyticAltitude(position)).margin(1e-3));
+
+		sim::Vector3 normal = FftOceanSurfaceSampler::calcNormalNed(field, position, 0);
+		sim::Vector3 expectedNormal = glm::normalize(sim::Vector3(-analyticAltitudeGradientNorth(position), 0, -1));
+		CHECK(normal.x == Approx(expectedNormal.x).margin(1e-3));
+		CHECK(normal.y == Approx(expectedNormal.y).margin(1e-3));
+		CHECK(normal.z == Approx(expectedNormal.z).margin(1e-3));
+	}
+}
+
+TEST_CASE("FFT ocean surface sampler accounts for horizontal displacement")
+{
+	glm::vec2 horizontalDisplacement(10, 5);
+	FftOceanField field = createAnalyticField(horizontalDisplacement);
+
+	for (double north = 0; north < 100; north += 9.1)
+	{
+		glm::dvec2 position(north, 0);
+		double expected = analyticAltitude(position - glm::dvec2(horizontalDisplacement));
+		CHECK(FftOceanSurfaceSampler::calcAltitude(field, position, 0) == Approx(expected).margin(1e-3));
+	}
+}
+
+TEST_CASE("FFT ocean surface sampler filters out waves smaller than filter radius")
+{
+	FftOceanField field = createAnalyticField();
+
+	// A box filter spanning one wavelength averages the wave to zero
+	double filterRadius = fieldWorldSize / 3.0;
+	CHECK(FftOceanSurfaceSampler::calcAltitude(field, glm::dvec2(12.5, 0), filterRadius) == Approx(0.0).margin(1e-3));
+}
+
+//! @returns frame of a planet whose surface at latitude and longitude zero is at the vis world origin,
+//! with vis world x, y and z axes aligned with north, east and down at that point
+static WaveTextureFrame createFrame(double planetRadius, const osg::Vec3d& wrappedNoiseOrigin = osg::Vec3d())
+{
+	WaveTextureFrame frame;
+	frame.planetRadius = planetRadius;
+	frame.planetPosition = osg::Vec3d(0, 0, planetRadius);
+	// Rotate geocentric +x (up at latitude and longitude zero) to world -z, and geocentric +z (north pole) to world +x
+	frame.planetOrientation = osg::Quat(math::halfPiD(), osg::Vec3d(0, 1, 0));
+	frame.wrappedNoiseOrigin = wrappedNoiseOrigin;
+	return frame;
+}
+
+//! Inverse of the frame created by createFrame() for points on the planet surface
+static sim::LatLon worldToLatLon(double planetRadius, const glm::dvec2& positionWorld)
+{
+	double lat = std::asin(positionWorld.x / planetRadius);
+	double lon = std::asin(positionWorld.y / (planetRadius * std::cos(lat)));
+	return sim::LatLon(lat, lon);
+}
+
+static FftOceanGenerator createGenerator(const glm::vec2& windVelocity)
+{
+	FftOceanGeneratorConfig config;
+	config.seed = 0;
+	config.textureSizePixels = fieldSizePixels;
+	config.textureWorldSize = fieldWorldSize;
+	config.windVelocity = windVelocity;
+	config.gravity = 9.8f;
+	return FftOceanGenerator(config);
+}
+
+TEST_CASE("World to wave texture space mapping matches ocean shader")
+{
+	osg::Vec3d wrappedNoiseOrigin(1234.5, -777.25, 3);
+	for (double planetRadius : {earthRadius, moonRadius})
+	{
+		WaveTextureFrame frame = createFrame(planetRadius, wrappedNoiseOrigin);
+		for (const glm::dvec2& positionWorld : {glm::dvec2(0, 0), glm::dvec2(5000, -3000), glm::dvec2(-20000, 15000)})
+		{
+			// Shader samples wave textures at world position relative to the wrapped noise origin
+			osg::Vec2d result = toWaveTextureSpace(frame, worldToLatLon(planetRadius, positionWorld));
+			CHECK(result.x() == Approx(positionWorld.x - wrappedNoiseOrigin.x()).margin(1e-6));
+			CHECK(result.y() == Approx(positionWorld.y - wrappedNoiseOrigin.y()).margin(1e-6));
+		}
+	}
+}
+
+TEST_CASE("FFT ocean surface sampler matches generator output at world positions rendered by the ocean shader")
+{
+	FftOceanGenerator generator = createGenerator(glm::vec2(5, 0));
+
+	FftOceanField initialField;
+	initialField.sizePixels = fieldSizePixels;
+	initialField.worldSize = fieldWorldSize;
+	initialField.displacement.resize(fieldSizePixels * fieldSizePixels, glm::vec3(0));
+
+	auto buffer = std::make_shared<FftOceanFieldBuffer>(initialField);
+	FftOceanField& writeField = buffer->getWriteBuffer();
+	generator.calculate(3, std::span<glm::vec3>{writeField.displacement.data(), writeField.displacement.size()});
+	buffer->publish();
+	REQUIRE(buffer->update());
+	const FftOceanField& field = buffer->getReadBuffer();
+
+	float minHeight = std::numeric_limits<float>::infinity();
+	float maxHeight = -std::numeric_limits<float>::infinity();
+	for (const glm::vec3& v : field.displacement)
+	{
+		minHeight = std::min(minHeight, v.z);
+		maxHeight = std::max(maxHeight, v.z);
+	}
+	REQUIRE(maxHeight > minHeight);
+
+	// Allow for error in inverting the horizontal displacement
+	double tolerance = 0.05 * (maxHeight - minHeight);
+
+	osg::Vec3d wrappedNoiseOrigin(1234.5, -777.25, 0);
+	for (double planetRadius : {earthRadius, moonRadius})
+	{
+		FftOceanSurfaceSampler sampler(buffer);
+		sampler.setFrame(createFrame(planetRadius, wrappedNoiseOrigin));
+
+		double texelSize = double(fieldWorldSize) / fieldSizePixels;
+		for (int i = 0; i < 50; ++i)
+		{
+			int x = (i * 37) % fieldSizePixels;
+			int y = (i * 91 + 13) % fieldSizePixels;
+			glm::vec3 displacement = field.displacement[y * fieldSizePixels + x];
+
+			// The shader samples texel (x, y) for an ocean vertex at this undisplaced world position,
+			// several kilometers from the origin, then displaces the vertex by the texel's displacement.
+			glm::dvec2 tileOffset = glm::dvec2(40, -25) * double(fieldWorldSize);
+			glm::dvec2 undisplacedPosition = (glm::dvec2(x, y) + 0.5) * texelSize + tileOffset + glm::dvec2(wrappedNoiseOrigin.x(), wrappedNoiseOrigin.y());
+			glm::dvec2 renderedPosition = undisplacedPosition + glm::dvec2(displacement.x, displacement.y);
+
+			CHECK(sampler.calcOceanAltitude(worldToLatLon(planetRadius, renderedPosition), 0) == Approx(displacement.z).margin(tolerance));
+		}
+	}
+}
+
+TEST_CASE("FFT ocean surface sampler reads latest published generator field")
+{
+	FftOceanGenerator generator = createGenerator(glm::vec2(10, 0));
+
+	FftOceanField initialField;
+	initialField.sizePixels = fieldSizePixels;
+	initialField.worldSize = fieldWorldSize;
+	initialField.displacement.resize(fieldSizePixels * fieldSizePixels, glm::vec3(0));
+
+	auto buffer = std::make_shared<FftOceanFieldBuffer>(initialField);
+	FftOceanSurfaceSampler sampler(buffer);
+
+	std::vector<sim::LatLon> positions;
+	for (int i = 0; i < 100; ++i)
+	{
+		positions.push_back(sim::LatLon(0.5 + i * 1e-6, 0.2 + i * 2e-6));
+	}
+	std::vector<double> altitudes(positions.size());
+	std::vector<sim::Vector3> normals(positions.size());
+
+	// Publish a generated field
+	FftOceanField& field = buffer->getWriteBuffer();
+	generator.calculate(0, std::span<glm::vec3>{field.displacement.data(), field.displacement.size()});
+	buffer->publish();
+	REQUIRE(buffer->update());
+
+	// Until the frame has been set, the surface is flat
+	sampler.calcOceanAltitudes(positions, 0, altitudes);
+	CHECK(std::all_of(altitudes.begin(), altitudes.end(), [](double a) { return a == 0.0; }));
+
+	sampler.setFrame(createFrame(earthRadius));
+	sampler.calcOceanAltitudes(positions, 0, altitudes);
+	sampler.calcOceanNormalsNed(positions, 0, normals);
+
+	float minHeight = std::numeric_limits<float>::infinity();
+	float maxHeight = -std::numeric_limits<float>::infinity();
+	for (const glm::vec3& v : buffer->getReadBuffer().displacement)
+	{
+		minHeight = std::min(minHeight, v.z);
+		maxHeight = std::max(maxHeight, v.z);
+	}
+
+	bool anyNonZero = false;
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		// Batched results should match individual queries
+		CHECK(altitudes[i] == sampler.calcOceanAltitude(positions[i], 0));
+		CHECK(normals[i] == sampler.calcOceanNormalNed(positions[i], 0));
+
+		CHECK(altitudes[i] >= minHeight);
+		CHECK(altitudes[i] <= maxHeight);
+		CHECK(normals[i].z < 0);
+		anyNonZero |= (altitudes[i] != 0.0);
+	}
+	CHECK(anyNonZero);
+}
@@ -0,0 +1,314 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/EngineStats.h>
+#include <SkyboltEngine/EntityFactory.h>
+#include <SkyboltEngine/Scenario/Scenario.h>
+#include <SkyboltSim/Components/ControlInputsComponent.h>
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/NameComponent.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
+
+#include <px_sched/px_sched.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <typeindex>
+
+using namespace skybolt;
+
+namespace fs = std::filesystem;
+
+static fs::path getTemporaryDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "EntityFactoryTests";
+}
+
+static fs::path writeTemplate(const std::string& name, const std::string& content)
+{
+	fs::create_directories(getTemporaryDirectory());
+	fs::path path = getTemporaryDirectory() / (name + ".json");
+	std::ofstream(path) << content;
+	return path;
+}
+
+static const std::string nodeMotionTemplate = R"({"components": [{"node": {}}, {"motion": {}}]})";
+
+namespace {
+
+struct EntityFactoryFixture
+{
+	EntityFactoryFixture()
+	{
+		componentFactoryRegistry = std::make_shared<ComponentFactoryRegistry>();
+		addDefaultFactories(*componentFactoryRegistry);
+	}
+
+	EntityFactory::Context createContext()
+	{
+		EntityFactory::Context context;
+		context.scheduler = nullptr;
+		context.simWorld = &scenario.world;
+		context.julianDateProvider = [] { return 0.0; };
+		context.componentFactoryRegistry = componentFactoryRegistry;
+		context.tileSourceFactoryRegistry = std::make_shared<vis::JsonTileSourceFactoryRegistry>(vis::JsonTileSourceFactoryRegistryConfig());
+		context.stats = &stats;
+		return context;
+	}
+
+	Scenario scenario;
+	ComponentFactoryRegistryPtr componentFactoryRegistry;
+	EngineStats stats;
+};
+
+static std::vector<std::type_index> getComponentTypes(const sim::Entity& entity)
+{
+	std::vector<std::type_index> types;
+	for (const sim::ComponentPtr& component : entity.getComponents())
+	{
+		types.push_back(typeid(*component));
+	}
+	return types;
+}
+
+static std::vector<EntitySpawnRequest> createSpawnRequests(const std::string& templateName, int count)
+{
+	std::vector<EntitySpawnRequest> requests(count);
+	for (int i = 0; i < count; ++i)
+	{
+		requests[i].templateName = templateName;
+		requests[i].position = sim::Vector3(i, 0, 0);
+	}
+	return requests;
+}
+
+} // namespace
+
+TEST_CASE("EntityFactory creates entities from lazily loaded templates")
+{
+	EntityFactoryFixture f;
+	std::vector<fs::path> filenames = {
+		writeTemplate("Valid", nodeMotionTemplate),
+		writeTemplate("Invalid", "{ not json")
+	};
+
+	// Invalid templates do not prevent construction
+	EntityFactory factory(f.createContext(), filenames);
+	CHECK(factory.getTemplateNames() == EntityFactory::Strings({"Valid", "Invalid"}));
+
+	sim::EntityPtr entity = factory.createEntity("Valid", "", sim::Vector3(1, 2, 3));
+	REQUIRE(entity);
+	REQUIRE(entity->getFirstComponent<sim::Node>());
+	CHECK(entity->getFirstComponent<sim::Motion>());
+	CHECK(entity->getFirstComponent<sim::Node>()->getPosition() == sim::Vector3(1, 2, 3));
+	CHECK(factory.getTemplateJson("Valid").at("components").size() == 2);
+
+	// Errors in a template are reported when the template is first used
+	CHECK_THROWS(factory.createEntity("Invalid"));
+	CHECK_THROWS(factory.createEntity("NonExistent"));
+}
+
+TEST_CASE("EntityFactory creates unique entity names")
+{
+	EntityFactoryFixture f;
+	EntityFactory factory(f.createContext(), {writeTemplate("T", nodeMotionTemplate)});
+
+	f.scenario.world.addEntity(factory.createEntity("T"));
+	f.scenario.world.addEntity(factory.createEntity("T"));
+	CHECK(f.scenario.world.findObjectByName("T1"));
+	CHECK(f.scenario.world.findObjectByName("T2"));
+
+	// Names already used in the world are skipped
+	f.scenario.world.addEntity(factory.createEntity("T", "T3"));
+	sim::EntityPtr entity = factory.createEntity("T");
+	CHECK(sim::getName(*entity) == "T4");
+
+	// Names are unique even if entities have not been added to the world yet
+	CHECK(sim::getName(*factory.createEntity("T")) == "T5");
+}
+
+TEST_CASE("EntityFactory uses component factories registered after templates were first used")
+{
+	EntityFactoryFixture f;
+	EntityFactory factory(f.createContext(), {writeTemplate("T", R"({"components": [{"node": {}}, {"custom": {}}]})")});
+
+	size_t componentCount = factory.createEntity("T")->getComponents().size();
+
+	int createCount = 0;
+	(*f.componentFactoryRegistry)["custom"] = std::make_shared<ComponentFactoryFunctionAdapter>([&] (sim::Entity*, const ComponentFactoryContext&, const nlohmann::json&) {
+		++createCount;
+		return std::make_shared<sim::Motion>();
+	});
+
+	CHECK(factory.createEntity("T")->getComponents().size() == componentCount + 1);
+	CHECK(createCount == 1);
+
+	// Replacing an existing factory does not change the size of the registry, but must still be detected
+	(*f.componentFactoryRegistry)["custom"] = std::make_shared<ComponentFactoryFunctionAdapter>([&] (sim::Entity*, const ComponentFactoryContext&, const nlohmann::json&) {
+		createCount += 10;
+		return nullptr;
+	});
+
+	CHECK(factory.createEntity("T")->getComponents().size() == componentCount);
+	CHECK(createCount == 11);
+
+	// Erasing a factory
+	f.componentFactoryRegistry->erase("custom");
+
+	CHECK(factory.createEntity("T")->getComponents().size() == componentCount);
+	CHECK(createCount == 11);
+}
+
+TEST_CASE("EntityFactory creates batch of entities equivalent to entities created individually")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	EntityFactoryFixture f;
+	EntityFactory::Context context = f.createContext();
+	context.scheduler = &scheduler;
+
+	// The custom factory is not thread safe, so it and the components after it must be created on the calling thread
+	std::thread::id callingThread = std::this_thread::get_id();
+	std::atomic<int> unsafeCallsOffCallingThread = 0;
+	(*f.componentFactoryRegistry)["custom"] = std::make_shared<ComponentFactoryFunctionAdapter>([&] (sim::Entity* entity, const ComponentFactoryContext&, const nlohmann::json&) {
+		if (std::this_thread::get_id() != callingThread)
+		{
+			++unsafeCallsOffCallingThread;
+		}
+		CHECK(entity->getFirstComponent<sim::Node>()); // Components of earlier steps already exist
+		return std::make_shared<sim::ControlInputsComponent>();
+	});
+
+	EntityFactory factory(context, {writeTemplate("T", R"({"components": [{"node": {}}, {"custom": {}}, {"motion": {}}]})")});
+
+	constexpr int entityCount = 500;
+	std::vector<EntitySpawnRequest> requests = createSpawnRequests("T", entityCount);
+	requests[10].instanceName = "named";
+	std::vector<sim::EntityPtr> entities = factory.createEntities(requests);
+
+	sim::EntityPtr individualEntity = factory.createEntity("T");
+	REQUIRE(entities.size() == entityCount);
+	CHECK(unsafeCallsOffCallingThread == 0);
+
+	std::set<std::string> names;
+	std::set<sim::EntityId> ids;
+	for (int i = 0; i < entityCount; ++i)
+	{
+		REQUIRE(entities[i]);
+		CHECK(getComponentTypes(*entities[i]) == getComponentTypes(*individualEntity));
+		CHECK(entities[i]->getFirstComponent<sim::Node>()->getPosition() == sim::Vector3(i, 0, 0));
+		names.insert(sim::getName(*entities[i]));
+		ids.insert(entities[i]->getId());
+	}
+	CHECK(sim::getName(*entities[10]) == "named");
+	CHECK(names.size() == entityCount);
+	CHECK(ids.size() == entityCount);
+
+	f.scenario.world.addEntities(entities);
+	CHECK(f.scenario.world.getEntities().size() == entityCount);
+	CHECK(f.scenario.world.findObjectByName("named") == entities[10]);
+}
+
+TEST_CASE("EntityFactory creates components of batch in parallel with thread safe factories")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	EntityFactoryFixture f;
+	EntityFactory::Context context = f.createContext();
+	context.scheduler = &scheduler;
+
+	std::atomic<int> createCount = 0;
+	constexpr bool threadSafe = true;
+	(*f.componentFactoryRegistry)["custom"] = std::make_shared<ComponentFactoryFunctionAdapter>([&] (sim::Entity*, const ComponentFactoryContext&, const nlohmann::json&) {
+		++createCount;
+		return std::make_shared<sim::ControlInputsComponent>();
+	}, threadSafe);
+
+	EntityFactory factory(context, {writeTemplate("T", R"({"components": [{"node": {}}, {"custom": {}}, {"motion": {}}]})")});
+
+	std::vector<sim::EntityPtr> entities = factory.createEntities(createSpawnRequests("T", 300));
+	CHECK(createCount == 300);
+	for (const sim::EntityPtr& entity : entities)
+	{
+		CHECK(entity->getFirstComponent<sim::ControlInputsComponent>());
+		CHECK(entity->getFirstComponent<sim::Motion>());
+	}
+}
+
+TEST_CASE("EntityFactory reports errors creating batch of entities")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	EntityFactoryFixture f;
+	EntityFactory::Context context = f.createContext();
+	context.scheduler = &scheduler;
+
+	// dynamicBody requires a mass
+	EntityFactory factory(context, {
+		writeTemplate("Valid", nodeMotionTemplate),
+		writeTemplate("MissingMass", R"({"components": [{"node": {}}, {"motion": {}}, {"dynamicBody": {}}]})")
+	});
+
+	std::vector<EntitySpawnRequest> requests = createSpawnRequests("Valid", 200);
+	requests[150].templateName = "MissingMass";
+	CHECK_THROWS(factory.createEntities(requests));
+
+	requests[150].templateName = "NonExistent";
+	CHECK_THROWS(factory.createEntities(requests));
+}
+
+TEST_CASE("Benchmark entity creation", "[.][benchmark]")
+{
+	EntityFactoryFixture f;
+
+	constexpr int templateCount = 500;
+	std::vector<fs::path> filenames;
+	for (int i = 0; i < templateCount; ++i)
+	{
+		filenames.push_back(writeTemplate("Template" + std::to_string(i), nodeMotionTemplate));
+	}
+
+	BENCHMARK("Construct factory with 500 templates")
+	{
+		return EntityFactory(f.createContext(), filenames).getTemplateNames().size();
+	};
+
+	BENCHMARK("Spawn 10000 entities from one template")
+	{
+		Scenario scenario;
+		EntityFactory::Context context = f.createContext();
+		context.simWorld = &scenario.world;
+		EntityFactory factory(context, {filenames.front()});
+		for (int i = 0; i < 10000; ++i)
+		{
+			scenario.world.addEntity(factory.createEntity("Template0"));
+		}
+		return scenario.world.getEntities().size();
+	};
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	BENCHMARK("Spawn 10000 entities from one template in a batch")
+	{
+		Scenario scenario;
+		EntityFactory::Context context = f.createContext();
+		context.simWorld = &scenario.world;
+		context.scheduler = &scheduler;
+		EntityFactory factory(context, {filenames.front()});
+		scenario.world.addEntities(factory.createEntities(createSpawnRequests("Template0", 10000)));
+		return scenario.world.getEntities().size();
+	};
+}
@@ -0,0 +1,247 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/Sequence/EntityStateKeyframes.h>
+#include <SkyboltEngine/Sequence/EntityStateSequenceController.h>
+#include <SkyboltEngine/Sequence/Interpolator/CubicBSplineInterpolator.h>
+#include <SkyboltCommon/Random.h>
+
+using namespace skybolt;
+
+static std::shared_ptr<EntityStateSequence> createRandomSequence(int keyCount, std::uint32_t seed)
+{
+	Random random(seed);
+	auto sequence = std::make_shared<EntityStateSequence>();
+	double time = 0;
+	for (int i = 0; i < keyCount; ++i)
+	{
+		time += random.rangedRand(0.1f, 2.0f);
+
+		EntitySequenceState state;
+		state.position = sim::Vector3(random.rangedRand(-1000, 1000), random.rangedRand(-1000, 1000), random.rangedRand(-1000, 1000));
+		state.orientation = glm::normalize(sim::Quaternion(random.rangedRand(-1, 1), random.rangedRand(-1, 1), random.rangedRand(-1, 1), random.rangedRand(-1, 1)));
+		sequence->addItemAtTime(state, time);
+	}
+	return sequence;
+}
+
+//! Reference implementation which interpolates the sequence with type-erased per-component interpolators
+static EntitySequenceState interpolateReference(const EntityStateSequence& sequence, double t)
+{
+	std::optional<math::InterpolationPoint> point = math::findInterpolationPoint(sequence.times, t, /* extrapolate */ false);
+	REQUIRE(point);
+
+	auto interpolate = [&](const std::function<double(int)>& valueGetter) {
+		CubicBSplineInterpolatorD interpolator(
+			[&] { return int(sequence.values.size()); },
+			valueGetter,
+			[&](int i) { return sequence.times[i]; });
+		return interpolator.interpolate(point->bounds.first, point->bounds.last, point->weight);
+	};
+
+	EntitySequenceState state;
+	for (int c = 0; c < 3; ++c)
+	{
+		state.position[c] = interpolate([&](int i) { return sequence.values[i].position[c]; });
+	}
+	for (int c = 0; c < 4; ++c)
+	{
+		state.orientation[c] = interpolate([&](int i) { return sequence.values[i].orientation[c]; });
+	}
+	state.orientation = glm::normalize(state.orientation);
+	return state;
+}
+
+static void checkEqual(const EntityStateSample& sample, const EntitySequenceState& expected)
+{
+	CHECK(sample.valid);
+	for (int c = 0; c < 3; ++c)
+	{
+		CHECK(sample.position[c] == Approx(expected.position[c]).margin(1e-9));
+	}
+	for (int c = 0; c < 4; ++c)
+	{
+		CHECK(sample.orientation[c] == Approx(expected.orientation[c]).margin(1e-9));
+	}
+}
+
+TEST_CASE("Sequence insertion keeps times sorted and finds index at time")
+{
+	EntityStateSequence sequence;
+	EntitySequenceState state;
+	for (double time : {3.0, 1.0, 2.0, 5.0, 4.0, 2.0})
+	{
+		sequence.addItemAtTime(state, time);
+	}
+
+	CHECK(sequence.times == std::vector<double>({1.0, 2.0, 2.0, 3.0, 4.0, 5.0}));
+	CHECK(sequence.getIndexAtTime(1.0) == 0);
+	CHECK(sequence.getIndexAtTime(2.0) == 1);
+	CHECK(sequence.getIndexAtTime(5.0) == 5);
+	CHECK(!sequence.getIndexAtTime(2.5));
+	CHECK(!sequence.getIndexAtTime(6.0));
+}
+
+TEST_CASE("EntityStateKeyframes bracket search matches findInterpolationPoint")
+{
+	auto sequence = createRandomSequence(50, 1);
+	EntityStateKeyframes keyframes;
+	keyframes.assign(*sequence);
+
+	// Query forwards, backwards and at random to exercise the cached bracket and search paths
+	std::vector<double> queryTimes;
+	double endTime = sequence->times.back() + 1.0;
+	for (double t = -1.0; t < endTime; t += 0.05)
+	{
+		queryTimes.push_back(t);
+	}
+	for (double t = endTime; t > -1.0; t -= 0.3)
+	{
+		queryTimes.push_back(t);
+	}
+	Random random(2);
+	for (int i = 0; i < 200; ++i)
+	{
+		queryTimes.push_back(random.rangedRand(-1.0f, float(endTime)));
+	}
+	for (double t : sequence->times)
+	{
+		queryTimes.push_back(t);
+	}
+
+	for (double t : queryTimes)
+	{
+		std::optional<math::InterpolationPoint> expected = math::findInterpolationPoint(sequence->times, t, /* extrapolate */ false);
+		std::optional<math::InterpolationPoint> actual = keyframes.findInterpolationPoint(t);
+		REQUIRE(actual);
+		CHECK(actual->bounds.first == expected->bounds.first);
+		CHECK(actual->bounds.last == expected->bounds.last);
+		CHECK(actual->weight == expected->weight);
+	}
+}
+
+TEST_CASE("EntityStateKeyframes evaluation matches CubicBSplineInterpolator")
+{
+	auto sequence = createRandomSequence(20, 3);
+	EntityStateSequenceController controller(sequence);
+
+	for (double t = 0; t < sequence->times.back() + 1.0; t += 0.1)
+	{
+		checkEqual(controller.getEntityStateAtTime(t), interpolateReference(*sequence, t));
+	}
+}
+
+TEST_CASE("EntityStateKeyframes handle empty and single key sequences")
+{
+	auto sequence = std::make_shared<EntityStateSequence>();
+	EntityStateSequenceController controller(sequence);
+	CHECK(!controller.getEntityStateAtTime(0).valid);
+	CHECK(controller.getStateAtTime(0) == nullptr);
+
+	EntitySequenceState state;
+	state.position = sim::Vector3(1, 2, 3);
+	state.orientation = sim::Quaternion(1, 0, 0, 0);
+	sequence->addItemAtTime(state, 5.0);
+
+	EntityStateSample sample = controller.getEntityStateAtTime(0);
+	CHECK(sample.valid);
+	CHECK(sample.position == state.position);
+	CHECK(sample.orientation == state.orientation);
+}
+
+TEST_CASE("EntityStateSequenceController keyframes update when sequence changes")
+{
+	auto sequence = createRandomSequence(10, 4);
+	EntityStateSequenceController controller(sequence);
+	double t = sequence->times[4] + 0.1;
+	checkEqual(controller.getEntityStateAtTime(t), interpolateReference(*sequence, t));
+
+	EntitySequenceState state;
+	state.position = sim::Vector3(5, 6, 7);
+	state.orientation = sim::Quaternion(1, 0, 0, 0);
+	sequence->setValueAtIndex(state, 5);
+	checkEqual(controller.getEntityStateAtTime(t), interpolateReference(*sequence, t));
+
+	sequence->removeItemAtIndex(4);
+	checkEqual(controller.getEntityStateAtTime(t), interpolateReference(*sequence, t));
+
+	sequence->addItemAtTime(state, t - 0.05);
+	checkEqual(controller.getEntityStateAtTime(t), interpolateReference(*sequence, t));
+}
+
+TEST_CASE("Batch evaluation of EntityStateKeyframes matches individual evaluation")
+{
+	std::vector<EntityStateKeyframes> keyframes(5);
+	std::vector<const EntityStateKeyframes*> keyframesPtrs;
+	std::vector<std::shared_ptr<EntityStateSequence>> sequences;
+	for (size_t i = 0; i < keyframes.size(); ++i)
+	{
+		sequences.push_back(createRandomSequence(int(i) * 3, std::uint32_t(i)));
+		keyframes[i].assign(*sequences.back());
+		keyframesPtrs.push_back(&keyframes[i]);
+	}
+
+	double t = 4.0;
+	std::vector<EntityStateSample> results(keyframes.size());
+	evaluateEntityStateKeyframesAtTime(keyframesPtrs, t, results);
+
+	CHECK(!results[0].valid);
+	for (size_t i = 1; i < keyframes.size(); ++i)
+	{
+		checkEqual(results[i], interpolateReference(*sequences[i], t));
+	}
+}
+
+TEST_CASE("Benchmark entity sequence playback", "[.][benchmark]")
+{
+	constexpr int sequenceCount = 100;
+	constexpr int keyCount = 10000;
+	constexpr double dt = 1.0 / 60.0;
+
+	std::vector<std::shared_ptr<EntityStateSequence>> sequences;
+	std::vector<std::unique_ptr<EntityStateSequenceController>> controllers;
+	std::vector<const EntityStateKeyframes*> keyframes;
+	for (int i = 0; i < sequenceCount; ++i)
+	{
+		sequences.push_back(createRandomSequence(keyCount, std::uint32_t(i)));
+		controllers.push_back(std::make_unique<EntityStateSequenceController>(sequences.back()));
+		keyframes.push_back(&controllers.back()->getKeyframes());
+	}
+	std::vector<EntityStateSample> results(sequenceCount);
+
+	double t = 0;
+	BENCHMARK("Per-component interpolators with linear search")
+	{
+		t += dt;
+		double sum = 0;
+		for (const auto& sequence : sequences)
+		{
+			sum += interpolateReference(*sequence, t).position.x;
+		}
+		return sum;
+	};
+
+	t = 0;
+	BENCHMARK("Controller getStateAtTime")
+	{
+		t += dt;
+		double sum = 0;
+		for (const auto& controller : controllers)
+		{
+			sum += static_cast<const EntitySequenceState&>(*controller->getStateAtTime(t)).position.x;
+		}
+		return sum;
+	};
+
+	t = 0;
+	BENCHMARK("Columnar keyframes batch evaluation")
+	{
+		t += dt;
+		evaluateEntityStateKeyframesAtTime(keyframes, t, results);
+		return results.front().position.x;
+	};
+}
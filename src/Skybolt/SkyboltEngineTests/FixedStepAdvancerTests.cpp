@@ -0,0 +1,184 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/Scenario/Scenario.h>
+#include <SkyboltEngine/UpdateLoop/FixedStepAdvancer.h>
+#include <SkyboltSim/System/SimStepper.h>
+#include <SkyboltSim/System/System.h>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+namespace {
+
+//! Records the times at which the system was advanced
+class RecordingSystem : public System
+{
+public:
+	void setSimTime(SecondsD newTime) override
+	{
+		setTimes.push_back(newTime);
+	}
+
+	void advanceSimTime(SecondsD newTime, SecondsD dt) override
+	{
+		advanceTimes.push_back(newTime);
+	}
+
+	std::vector<SecondsD> setTimes;
+	std::vector<SecondsD> advanceTimes;
+};
+
+struct AdvancerFixture
+{
+	AdvancerFixture() :
+		system(std::make_shared<RecordingSystem>()),
+		systems(std::make_shared<SystemRegistry>(SystemRegistry({ system }))),
+		advancer(systems, &scenario)
+	{
+	}
+
+	Scenario scenario;
+	std::shared_ptr<RecordingSystem> system;
+	SystemRegistryPtr systems;
+	FixedStepAdvancer advancer;
+};
+
+//! @returns advance times recorded by stepping a SimStepper in the same way as SimUpdater
+std::vector<SecondsD> stepLikeSimUpdater(SecondsD dt, int steps)
+{
+	auto system = std::make_shared<RecordingSystem>();
+	SimStepper stepper(std::make_shared<SystemRegistry>(SystemRegistry({ system })));
+	stepper.setMaxDynamicsSubsteps(std::nullopt);
+	for (int i = 0; i < steps; ++i)
+	{
+		stepper.update(dt);
+	}
+	return system->advanceTimes;
+}
+
+} // namespace
+
+TEST_CASE("FixedStepAdvancer carries time and substep remainder across calls")
+{
+	// Step size is not a multiple of the dynamics substep size, so a remainder carries over between steps
+	const SecondsD dt = 0.01;
+	const int steps = 30;
+
+	AdvancerFixture f;
+	for (int i = 0; i < steps / 3; ++i)
+	{
+		CHECK(f.advancer.advance(dt, 3) == 3);
+	}
+
+	CHECK(f.system->advanceTimes == stepLikeSimUpdater(dt, steps));
+	CHECK(f.scenario.timeSource.getTime() == f.advancer.getStepper().getTime());
+	CHECK(f.scenario.timeSource.getTime() == Approx(steps * dt).margin(1.0 / 60.0));
+
+	// Time was continuous, so the stepper's time was never reset
+	CHECK(f.system->setTimes.empty());
+}
+
+TEST_CASE("FixedStepAdvancer advances in one call the same as in many calls")
+{
+	const SecondsD dt = 0.025;
+
+	AdvancerFixture single;
+	single.advancer.advance(dt, 40);
+
+	AdvancerFixture multiple;
+	for (int i = 0; i < 40; ++i)
+	{
+		multiple.advancer.advance(dt, 1);
+	}
+
+	CHECK(single.system->advanceTimes == multiple.system->advanceTimes);
+	CHECK(single.scenario.timeSource.getTime() == multiple.scenario.timeSource.getTime());
+}
+
+TEST_CASE("FixedStepAdvancer follows time source changes")
+{
+	AdvancerFixture f;
+	f.advancer.advance(0.1, 2);
+
+	f.scenario.timeSource.setTime(10.0);
+	f.advancer.advance(0.1, 1);
+
+	REQUIRE(!f.system->setTimes.empty());
+	CHECK(f.system->setTimes.back() == 10.0);
+	CHECK(f.system->advanceTimes.back() > 10.0);
+}
+
+TEST_CASE("FixedStepAdvancer calls callback at interval and stops when requested")
+{
+	AdvancerFixture f;
+
+	std::vector<int> callbackSteps;
+	int stepsTaken = f.advancer.advance(1.0 / 60.0, 20, 4, [&] (int stepsTaken) {
+		callbackSteps.push_back(stepsTaken);
+		return stepsTaken < 12;
+	});
+
+	CHECK(stepsTaken == 12);
+	CHECK(callbackSteps == std::vector<int>({ 4, 8, 12 }));
+}
+
+TEST_CASE("FixedStepAdvancer stops at end of time range")
+{
+	AdvancerFixture f;
+	f.scenario.timelineMode.set(TimelineMode::Free); // Disable dynamics substeps so that time advances by exactly dt
+	f.scenario.timeSource.setRange(TimeRange(0, 1));
+
+	CHECK(f.advancer.advance(0.25, 10) == 4);
+	CHECK(f.scenario.timeSource.getTime() == 1.0);
+}
+
+TEST_CASE("FixedStepAdvancer does not step systems when advancing past end of time range")
+{
+	AdvancerFixture f;
+	f.scenario.timelineMode.set(TimelineMode::Free);
+	f.scenario.timeSource.setRange(TimeRange(0, 1));
+
+	REQUIRE(f.advancer.advance(0.25, 10) == 4);
+	size_t advanceCount = f.system->advanceTimes.size();
+
+	CHECK(f.advancer.advance(0.25, 5) == 0);
+	CHECK(f.advancer.advance(0.25, 1) == 0);
+	CHECK(f.system->advanceTimes.size() == advanceCount);
+	CHECK(f.scenario.timeSource.getTime() == 1.0);
+
+	// Steps of zero duration are still taken so that systems can be updated for rendering
+	CHECK(f.advancer.advance(0.0, 1) == 1);
+	CHECK(f.scenario.timeSource.getTime() == 1.0);
+
+	// Extending the range allows stepping to continue
+	f.scenario.timeSource.setRange(TimeRange(0, 2));
+	CHECK(f.advancer.advance(0.25, 2) == 2);
+	CHECK(f.scenario.timeSource.getTime() == 1.5);
+}
+
+TEST_CASE("Benchmark FixedStepAdvancer", "[.][benchmark]")
+{
+	const SecondsD dt = 1.0 / 60.0;
+	const int steps = 1000;
+
+	BENCHMARK("1000 steps with a new SimStepper per step")
+	{
+		auto systems = std::make_shared<SystemRegistry>(SystemRegistry({ std::make_shared<RecordingSystem>() }));
+		for (int i = 0; i < steps; ++i)
+		{
+			SimStepper stepper(systems);
+			stepper.update(dt);
+		}
+	};
+
+	BENCHMARK("1000 steps with FixedStepAdvancer")
+	{
+		AdvancerFixture f;
+		return f.advancer.advance(dt, steps);
+	};
+}
@@ -9,9 +9,16 @@
 #include <SkyboltEngine/Components/TemplateNameComponent.h>
 #include <SkyboltEngine/Scenario/ScenarioMetadataComponent.h>
 #include <SkyboltEngine/Scenario/ScenarioSerialization.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <SkyboltSim/Components/Motion.h>
 #include <SkyboltSim/Components/NameComponent.h>
+#include <SkyboltSim/Components/Node.h>
 #include <SkyboltReflect/Reflection.h>
 
+#include <px_sched/px_sched.h>
+
+#include <cmath>
+
 using namespace skybolt;
 
 static sim::EntityPtr createEntity(const std::string& templateName, const std::string& instanceName)
@@ -21,6 +28,8 @@ static sim::EntityPtr createEntity(const std::string& templateName, const std::s
 	auto entity = std::make_shared<sim::Entity>(id);
 	entity->addComponent(std::make_shared<TemplateNameComponent>(templateName));
 	entity->addComponent(std::make_shared<sim::NameComponent>(instanceName));
+	entity->addComponent(std::make_shared<sim::Node>());
+	entity->addComponent(std::make_shared<sim::Motion>());
 
 	auto metadata = std::make_shared<ScenarioMetadataComponent>();
 	metadata->lifetimePolicy = ScenarioMetadataComponent::LifetimePolicy::Procedural;
@@ -113,4 +122,274 @@ TEST_CASE("On deserialization, new entities created, existing entities updated,
 
 	// Check that entityPersistant was not removed
 	CHECK(scenario.world.findObjectByName("entityPersistant"));
-}
\ No newline at end of file
+}
+
+static sim::Quaternion orientationForIndex(int i)
+{
+	return glm::angleAxis(double(i % 360) * math::degToRadD(), glm::normalize(sim::Vector3(1, i % 3, 2)));
+}
+
+static void addEntities(sim::World& world, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		sim::EntityPtr entity = createEntity("myTemplate", "entity" + std::to_string(i));
+		entity->setDynamicsEnabled(i % 2 == 0);
+		entity->getFirstComponentRequired<sim::Node>()->setPosition(sim::Vector3(i, -2.0 * i, 0.5 * i));
+		entity->getFirstComponentRequired<sim::Node>()->setOrientation(orientationForIndex(i));
+		entity->getFirstComponentRequired<sim::Motion>()->linearVelocity = sim::Vector3(0.25 * i, 0, -i);
+		world.addEntity(entity);
+	}
+}
+
+static void checkEqual(const sim::Quaternion& a, const sim::Quaternion& b)
+{
+	// q and -q represent the same rotation
+	CHECK(std::abs(glm::dot(a, b)) == Approx(1.0).margin(1e-9));
+}
+
+static void checkEqual(const sim::Vector3& a, const sim::Vector3& b)
+{
+	CHECK(a.x == Approx(b.x).margin(1e-9));
+	CHECK(a.y == Approx(b.y).margin(1e-9));
+	CHECK(a.z == Approx(b.z).margin(1e-9));
+}
+
+//! Checks that every value in expected exists in actual. Values in actual which are not in expected are ignored,
+//! e.g. components which are not serialized through reflected properties.
+static void checkContains(const nlohmann::json& actual, const nlohmann::json& expected, const std::string& path = "")
+{
+	INFO(path);
+	if (expected.is_object())
+	{
+		REQUIRE(actual.is_object());
+		for (const auto& [key, value] : expected.items())
+		{
+			REQUIRE(actual.contains(key));
+			checkContains(actual.at(key), value, path + "/" + key);
+		}
+	}
+	else if (expected.is_array())
+	{
+		REQUIRE(actual.is_array());
+		REQUIRE(actual.size() == expected.size());
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			checkContains(actual[i], expected[i], path + "/" + std::to_string(i));
+		}
+	}
+	else if (expected.is_number())
+	{
+		REQUIRE(actual.is_number());
+		CHECK(actual.get<double>() == Approx(expected.get<double>()).margin(1e-9));
+	}
+	else
+	{
+		CHECK(actual == expected);
+	}
+}
+
+//! Scenario as written by the serial writer before parallel serialization was introduced.
+//! Used to check that the file format is unchanged by both the serial and parallel paths.
+static const char* goldenScenarioJson = R"({
+	"julianDate": 2457982.9,
+	"startTime": 10.0,
+	"duration": 500.0,
+	"currentTime": 20.5,
+	"timelineMode": "free",
+	"entities": {
+		"aircraft": {
+			"template": "myTemplate",
+			"dynamicsEnabled": true,
+			"components": {
+				"Node": {
+					"position": [1000.5, -2000.25, 3.0],
+					"orientation": { "angleDeg": 90.0, "axis": [0.0, 0.0, 1.0] }
+				},
+				"Motion": {
+					"linearVelocity": [10.0, -20.0, 0.5],
+					"angularVelocity": [0.0, 0.1, 0.0]
+				}
+			}
+		},
+		"ship": {
+			"template": "myOtherTemplate",
+			"dynamicsEnabled": false,
+			"components": {
+				"Node": {
+					"position": [-1.0, 2.0, -3.0],
+					"orientation": { "angleDeg": 45.0, "axis": [1.0, 0.0, 0.0] }
+				},
+				"Motion": {
+					"linearVelocity": [0.0, 0.0, 0.0],
+					"angularVelocity": [0.0, 0.0, 0.0]
+				}
+			}
+		}
+	}
+})";
+
+struct GoldenEntityState
+{
+	std::string name;
+	bool dynamicsEnabled;
+	sim::Vector3 position;
+	sim::Quaternion orientation;
+	sim::Vector3 linearVelocity;
+	sim::Vector3 angularVelocity;
+};
+
+static std::vector<GoldenEntityState> getGoldenEntityStates()
+{
+	return {
+		{ "aircraft", true, sim::Vector3(1000.5, -2000.25, 3.0), glm::angleAxis(90.0 * math::degToRadD(), sim::Vector3(0, 0, 1)), sim::Vector3(10, -20, 0.5), sim::Vector3(0, 0.1, 0) },
+		{ "ship", false, sim::Vector3(-1, 2, -3), glm::angleAxis(45.0 * math::degToRadD(), sim::Vector3(1, 0, 0)), sim::Vector3(0, 0, 0), sim::Vector3(0, 0, 0) }
+	};
+}
+
+static void createGoldenScenario(Scenario& scenario)
+{
+	scenario.startJulianDate = 2457982.9;
+	scenario.timeSource.setRange({ 10, 510 });
+	scenario.timeSource.setTime(20.5);
+	scenario.timelineMode = TimelineMode::Free;
+
+	for (const GoldenEntityState& state : getGoldenEntityStates())
+	{
+		sim::EntityPtr entity = createEntity(state.name == "ship" ? "myOtherTemplate" : "myTemplate", state.name);
+		entity->setDynamicsEnabled(state.dynamicsEnabled);
+		entity->getFirstComponentRequired<sim::Node>()->setPosition(state.position);
+		entity->getFirstComponentRequired<sim::Node>()->setOrientation(state.orientation);
+		entity->getFirstComponentRequired<sim::Motion>()->linearVelocity = state.linearVelocity;
+		entity->getFirstComponentRequired<sim::Motion>()->angularVelocity = state.angularVelocity;
+		scenario.world.addEntity(entity);
+	}
+}
+
+TEST_CASE("Scenario is written in the golden format serially and in parallel")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	refl::TypeRegistry typeRegistry;
+	Scenario scenario;
+	createGoldenScenario(scenario);
+
+	nlohmann::json golden = nlohmann::json::parse(goldenScenarioJson);
+	for (px_sched::Scheduler* s : { (px_sched::Scheduler*)nullptr, &scheduler })
+	{
+		nlohmann::json json = writeScenario(typeRegistry, scenario, s);
+		checkContains(json, golden);
+		CHECK(json.size() == golden.size());
+		CHECK(json.at("entities").size() == golden.at("entities").size());
+	}
+}
+
+TEST_CASE("Scenario in the golden format is read serially and in parallel")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	nlohmann::json golden = nlohmann::json::parse(goldenScenarioJson);
+	for (px_sched::Scheduler* s : { (px_sched::Scheduler*)nullptr, &scheduler })
+	{
+		refl::TypeRegistry typeRegistry;
+		Scenario scenario;
+		readScenario(typeRegistry, scenario, &createEntity, golden, {}, s);
+
+		CHECK(scenario.startJulianDate == 2457982.9);
+		CHECK(scenario.timeSource.getRange() == TimeRange(10, 510));
+		CHECK(scenario.timeSource.getTime() == 20.5);
+		CHECK(scenario.timelineMode.get() == TimelineMode::Free);
+
+		REQUIRE(scenario.world.getEntities().size() == 2);
+		for (const GoldenEntityState& state : getGoldenEntityStates())
+		{
+			INFO(state.name);
+			sim::EntityPtr entity = scenario.world.findObjectByName(state.name);
+			REQUIRE(entity);
+			CHECK(entity->isDynamicsEnabled() == state.dynamicsEnabled);
+			checkEqual(entity->getFirstComponentRequired<sim::Node>()->getPosition(), state.position);
+			checkEqual(entity->getFirstComponentRequired<sim::Node>()->getOrientation(), state.orientation);
+			checkEqual(entity->getFirstComponentRequired<sim::Motion>()->linearVelocity, state.linearVelocity);
+			checkEqual(entity->getFirstComponentRequired<sim::Motion>()->angularVelocity, state.angularVelocity);
+		}
+	}
+}
+
+TEST_CASE("Scenario serialized in parallel is identical to scenario serialized serially")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	refl::TypeRegistry typeRegistry;
+	Scenario scenario;
+	addEntities(scenario.world, 200); // Enough entities to be split across several tasks
+
+	std::string serialJson = writeScenario(typeRegistry, scenario).dump();
+	std::string parallelJson = writeScenario(typeRegistry, scenario, &scheduler).dump();
+	CHECK(parallelJson == serialJson);
+}
+
+TEST_CASE("Scenario deserialized in parallel has the state of the serialized scenario")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	refl::TypeRegistry typeRegistry;
+	Scenario scenario1;
+	addEntities(scenario1.world, 200);
+	nlohmann::json scenarioJson = writeScenario(typeRegistry, scenario1);
+
+	Scenario scenario2;
+	readScenario(typeRegistry, scenario2, &createEntity, scenarioJson, {}, &scheduler);
+
+	REQUIRE(scenario2.world.getEntities().size() == scenario1.world.getEntities().size());
+	for (const sim::EntityPtr& entity1 : scenario1.world.getEntities())
+	{
+		std::string name = sim::getName(*entity1);
+		INFO(name);
+		sim::EntityPtr entity2 = scenario2.world.findObjectByName(name);
+		REQUIRE(entity2);
+		CHECK(entity2->isDynamicsEnabled() == entity1->isDynamicsEnabled());
+
+		auto node1 = entity1->getFirstComponentRequired<sim::Node>();
+		auto node2 = entity2->getFirstComponentRequired<sim::Node>();
+		checkEqual(node2->getPosition(), node1->getPosition());
+		checkEqual(node2->getOrientation(), node1->getOrientation());
+		checkEqual(entity2->getFirstComponentRequired<sim::Motion>()->linearVelocity, entity1->getFirstComponentRequired<sim::Motion>()->linearVelocity);
+	}
+
+	CHECK(writeScenario(typeRegistry, scenario2, &scheduler).dump() == scenarioJson.dump());
+}
+
+TEST_CASE("Benchmark scenario serialization", "[.][benchmark]")
+{
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	refl::TypeRegistry typeRegistry;
+	Scenario scenario;
+	addEntities(scenario.world, 5000);
+	nlohmann::json scenarioJson = writeScenario(typeRegistry, scenario);
+
+	BENCHMARK("Write serial")
+	{
+		return writeScenario(typeRegistry, scenario);
+	};
+
+	BENCHMARK("Write parallel")
+	{
+		return writeScenario(typeRegistry, scenario, &scheduler);
+	};
+
+	BENCHMARK("Read serial")
+	{
+		readScenario(typeRegistry, scenario, &createEntity, scenarioJson);
+	};
+
+	BENCHMARK("Read parallel")
+	{
+		readScenario(typeRegistry, scenario, &createEntity, scenarioJson, {}, &scheduler);
+	};
+}
@@ -0,0 +1,136 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/Sequence/EntityStateSequenceController.h>
+#include <SkyboltEngine/SimVisBinding/TilePrefetchBinding.h>
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/CameraComponent.h>
+
+using namespace skybolt;
+
+static ObserverPositionPredictor createConstantVelocityPredictor(const sim::Vector3& velocity)
+{
+	return [velocity] (double secondsAhead) -> std::optional<sim::Vector3> {
+		return velocity * secondsAhead;
+	};
+}
+
+TEST_CASE("Sample observer trajectory at evenly spaced times")
+{
+	TrajectorySamplingConfig config;
+	config.horizonSeconds = 20;
+	config.sampleCount = 4;
+	config.minSampleSeparation = 0;
+
+	std::vector<sim::Vector3> samples = sampleObserverTrajectory(createConstantVelocityPredictor(sim::Vector3(100, 0, 0)), sim::Vector3(0, 0, 0), config);
+	REQUIRE(samples.size() == 4);
+	CHECK(samples[0].x == Approx(500));
+	CHECK(samples[1].x == Approx(1000));
+	CHECK(samples[2].x == Approx(1500));
+	CHECK(samples[3].x == Approx(2000));
+}
+
+TEST_CASE("Samples closer than minimum separation are skipped")
+{
+	TrajectorySamplingConfig config;
+	config.horizonSeconds = 20;
+	config.sampleCount = 4;
+	config.minSampleSeparation = 800;
+
+	SECTION("Moving observer")
+	{
+		std::vector<sim::Vector3> samples = sampleObserverTrajectory(createConstantVelocityPredictor(sim::Vector3(100, 0, 0)), sim::Vector3(0, 0, 0), config);
+		REQUIRE(samples.size() == 2);
+		CHECK(samples[0].x == Approx(1000));
+		CHECK(samples[1].x == Approx(2000));
+	}
+
+	SECTION("Stationary observer")
+	{
+		std::vector<sim::Vector3> samples = sampleObserverTrajectory(createConstantVelocityPredictor(sim::Vector3(0, 0, 0)), sim::Vector3(0, 0, 0), config);
+		CHECK(samples.empty());
+	}
+}
+
+TEST_CASE("Samples that cannot be predicted are skipped")
+{
+	TrajectorySamplingConfig config;
+	config.horizonSeconds = 20;
+	config.sampleCount = 4;
+	config.minSampleSeparation = 0;
+
+	auto predictor = [] (double secondsAhead) -> std::optional<sim::Vector3> {
+		if (secondsAhead > 10)
+		{
+			return std::nullopt;
+		}
+		return sim::Vector3(secondsAhead, 0, 0);
+	};
+
+	std::vector<sim::Vector3> samples = sampleObserverTrajectory(predictor, sim::Vector3(0, 0, 0), config);
+	CHECK(samples.size() == 2);
+}
+
+TEST_CASE("Predict observer positions from sequence keyframes")
+{
+	// Keyframes along a straight line at constant speed
+	auto sequence = std::make_shared<EntityStateSequence>();
+	for (int i = 0; i <= 10; ++i)
+	{
+		EntitySequenceState state;
+		state.position = sim::Vector3(i * 1000.0, 0, 0);
+		state.orientation = sim::Quaternion(1, 0, 0, 0);
+		sequence->addItemAtTime(state, i * 10.0);
+	}
+	auto controller = std::make_shared<EntityStateSequenceController>(sequence);
+
+	double currentTime = 10;
+	ObserverPositionPredictor predictor = createSequencePredictor(controller, [&] { return currentTime; });
+
+	TrajectorySamplingConfig config;
+	config.horizonSeconds = 20;
+	config.sampleCount = 4;
+	config.minSampleSeparation = 0;
+
+	std::vector<sim::Vector3> samples = sampleObserverTrajectory(predictor, sim::Vector3(1000, 0, 0), config);
+	REQUIRE(samples.size() == 4);
+	CHECK(samples[0].x == Approx(1500).margin(1e-3));
+	CHECK(samples[3].x == Approx(3000).margin(1e-3));
+
+	// Predictions follow the sequence time
+	currentTime = 50;
+	samples = sampleObserverTrajectory(predictor, sim::Vector3(5000, 0, 0), config);
+	REQUIRE(samples.size() == 4);
+	CHECK(samples[3].x == Approx(7000).margin(1e-3));
+}
+
+TEST_CASE("First camera observer provider follows cameras added to and removed from the world")
+{
+	sim::World world;
+	ObserverProvider provider = createFirstCameraObserverProvider(&world);
+	CHECK(provider() == nullptr);
+
+	world.addEntity(std::make_shared<sim::Entity>(sim::EntityId{1, 1}));
+	CHECK(provider() == nullptr);
+
+	auto camera = std::make_shared<sim::Entity>(sim::EntityId{1, 2});
+	camera->addComponent(std::make_shared<sim::CameraComponent>());
+	world.addEntity(camera);
+	CHECK(provider() == camera.get());
+
+	auto otherCamera = std::make_shared<sim::Entity>(sim::EntityId{1, 3});
+	otherCamera->addComponent(std::make_shared<sim::CameraComponent>());
+	world.addEntity(otherCamera);
+	CHECK(provider() == camera.get());
+
+	world.removeEntity(camera.get());
+	CHECK(provider() == otherCamera.get());
+
+	world.removeEntity(otherCamera.get());
+	CHECK(provider() == nullptr);
+}
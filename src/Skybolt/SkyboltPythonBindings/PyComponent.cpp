@@ -24,8 +24,22 @@ static py::detail::str_attr_accessor getRequiredAttr(const py::handle& obj, cons
 	return obj.attr(name);
 }
 
-PyComponent::PyComponent(py::object pythonComponent) :
-	mPythonComponent(std::move(pythonComponent))
+//! @returns the attribute, or a null object if the attribute does not exist
+static py::object getOptionalAttr(const py::handle& obj, const char* name)
+{
+	if (py::hasattr(obj, name))
+	{
+		return obj.attr(name);
+	}
+	return py::object();
+}
+
+PyComponent::PyComponent(py::object pythonComponent, PyComponentBatchPtr batch) :
+	mPythonComponent(std::move(pythonComponent)),
+	mBatch(std::move(batch)),
+	mSetSimTime(getOptionalAttr(mPythonComponent, "set_sim_time")),
+	mAdvanceSimTime(getOptionalAttr(mPythonComponent, "advance_sim_time")),
+	mPropertyChanged(getOptionalAttr(mPythonComponent, "property_changed"))
 {
 	EngineRoot* engine = getGlobalEngineRoot();
 	if (!engine)
@@ -52,17 +66,24 @@ refl::Type::PropertyMap PyComponent::getProperties() const
 
 void PyComponent::setSimTime(SecondsD newTime)
 {
-	if (pybind11::hasattr(mPythonComponent, "set_sim_time"))
+	if (mSetSimTime)
 	{
-		mPythonComponent.attr("set_sim_time")(newTime);
+		py::gil_scoped_acquire acquire; // The simulation may be stepped with the GIL released
+		mSetSimTime(newTime);
 	}
 }
 
 void PyComponent::advanceSimTime(SecondsD newTime, SecondsD dt)
 {
-	if (pybind11::hasattr(mPythonComponent, "advance_sim_time"))
+	if (mBatch)
+	{
+		py::gil_scoped_acquire acquire;
+		mBatch->add(mPythonComponent, newTime, dt);
+	}
+	else if (mAdvanceSimTime)
 	{
-		mPythonComponent.attr("advance_sim_time")(newTime, dt);
+		py::gil_scoped_acquire acquire;
+		mAdvanceSimTime(newTime, dt);
 	}
 	else
 	{
@@ -6,17 +6,22 @@
 
 #pragma once
 
+#include "PyComponentBatch.h"
+
 #include <SkyboltSim/Component.h>
 
 #include <pybind11/pybind11.h>
 
 namespace skybolt {
 
-//! Wrapper allowing Python scripts define Component functionality
+//! Wrapper allowing Python scripts define Component functionality.
+//! The Python methods called by the wrapper are resolved once on construction, so methods added to the Python object afterwards are not called.
 class PyComponent : public sim::Component, public refl::DynamicPropertySource
 {
 public:
-	PyComponent(pybind11::object pythonComponent);
+	//! @param batch is the batch used to advance the component if the component's class implements `advance_sim_time_batch`.
+	//! If null, the component's `advance_sim_time` method is called individually.
+	PyComponent(pybind11::object pythonComponent, PyComponentBatchPtr batch = nullptr);
 	~PyComponent() override;
 
 	refl::Type::PropertyMap getProperties() const override;
@@ -27,21 +32,54 @@ public:
 private:
 	void addProperty(refl::TypeRegistry& typeRegistry, const std::string& name, const pybind11::handle& value);
 
+	//! Caches the C++ value of a Python property value.
+	//! Python bool, int, float and str objects are immutable, so the cached value is valid for as long as the property refers to the same object.
+	template <typename T>
+	struct CachedPropertyValue
+	{
+		pybind11::str key;
+		pybind11::object pythonValue;
+		T value;
+
+		const T& get(const pybind11::dict& dict)
+		{
+			PyObject* item = PyDict_GetItem(dict.ptr(), key.ptr()); // Borrowed reference
+			if (!item)
+			{
+				throw std::runtime_error("Python component property not found: " + std::string(key));
+			}
+
+			if (item != pythonValue.ptr())
+			{
+				pythonValue = pybind11::reinterpret_borrow<pybind11::object>(item);
+				value = pybind11::cast<T>(pythonValue);
+			}
+			return value;
+		}
+	};
+
 	template <typename T>
 	void addPropertyOfType(refl::TypeRegistry& typeRegistry, const std::string& name, const T& value)
 	{
-		auto getter = [name] (const PyComponent& c) -> T {
-			return pybind11::cast<T>(c.mPropertiesDict[name.c_str()]);
+		auto cache = std::make_shared<CachedPropertyValue<T>>();
+		cache->key = pybind11::str(name);
+		PyUnicode_InternInPlace(&cache->key.ptr());
+
+		auto getter = [cache] (const PyComponent& c) -> T {
+			return cache->get(c.mPropertiesDict);
 		};
 
-		auto setter = [name, this] (PyComponent& c, const T& value) {
-			auto oldValue = c.mPropertiesDict[name.c_str()];
-			if (pybind11::cast<T>(oldValue) != value)
+		auto setter = [cache] (PyComponent& c, const T& value) {
+			if (cache->get(c.mPropertiesDict) != value)
 			{
-				c.mPropertiesDict[name.c_str()] = value;
-				if (pybind11::hasattr(mPythonComponent, "property_changed"))
+				pybind11::object pythonValue = pybind11::cast(value);
+				PyDict_SetItem(c.mPropertiesDict.ptr(), cache->key.ptr(), pythonValue.ptr());
+				cache->pythonValue = pythonValue;
+				cache->value = value;
+
+				if (c.mPropertyChanged)
 				{
-					mPythonComponent.attr("property_changed")(name, value);
+					c.mPropertyChanged(cache->key, pythonValue);
 				}
 			}
 		};
@@ -51,6 +89,13 @@ private:
 
 private:
 	pybind11::object mPythonComponent;
+	PyComponentBatchPtr mBatch;
+
+	// Bound Python methods, or null if not implemented
+	pybind11::object mSetSimTime;
+	pybind11::object mAdvanceSimTime;
+	pybind11::object mPropertyChanged;
+
 	pybind11::dict mPropertiesDict;
 	refl::Type::PropertyMap mProperties;
 };
@@ -0,0 +1,116 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "PyComponentBatch.h"
+
+#include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltSim/System/SystemRegistry.h>
+
+namespace py = pybind11;
+
+namespace skybolt {
+
+using namespace skybolt::sim;
+
+static const char* advanceSimTimeBatchAttributeName = "advance_sim_time_batch";
+
+PyComponentBatch::PyComponentBatch(py::object advanceSimTimeBatch) :
+	mAdvanceSimTimeBatch(std::move(advanceSimTimeBatch))
+{
+}
+
+PyComponentBatch::~PyComponentBatch() = default;
+
+void PyComponentBatch::add(const py::handle& pythonComponent, SecondsD newTime, SecondsD dt)
+{
+	// Components queued for a different step must be dispatched before the new step begins
+	if (!mComponents.empty() && (newTime != mTime || dt != mDt))
+	{
+		dispatch();
+	}
+	mTime = newTime;
+	mDt = dt;
+	mComponents.append(pythonComponent);
+}
+
+void PyComponentBatch::dispatch()
+{
+	if (mComponents.empty())
+	{
+		return;
+	}
+
+	// Swap out the list before calling Python, so that components queued during the call go into the next batch
+	py::list components = std::move(mComponents);
+	mComponents = py::list();
+	mAdvanceSimTimeBatch(components, mTime, mDt);
+}
+
+PyComponentBatchSystem::~PyComponentBatchSystem() = default;
+
+PyComponentBatchPtr PyComponentBatchSystem::getOrCreateBatch(const py::handle& pyClass)
+{
+	if (const auto& i = mBatches.find(pyClass.ptr()); i != mBatches.end())
+	{
+		return i->second.batch;
+	}
+
+	if (!py::hasattr(pyClass, advanceSimTimeBatchAttributeName))
+	{
+		return nullptr;
+	}
+
+	auto batch = std::make_shared<PyComponentBatch>(pyClass.attr(advanceSimTimeBatchAttributeName));
+	mBatches[pyClass.ptr()] = { py::reinterpret_borrow<py::object>(pyClass), batch };
+	return batch;
+}
+
+PyComponentBatchPtr PyComponentBatchSystem::findBatch(const py::handle& pyClass) const
+{
+	if (const auto& i = mBatches.find(pyClass.ptr()); i != mBatches.end())
+	{
+		return i->second.batch;
+	}
+	return nullptr;
+}
+
+void PyComponentBatchSystem::advanceSimTime(SecondsD newTime, SecondsD dt)
+{
+	py::gil_scoped_acquire acquire; // The simulation may be stepped with the GIL released
+	for (const auto& [pyClass, classBatch] : mBatches)
+	{
+		classBatch.batch->dispatch();
+	}
+}
+
+void registerPyComponentClass(EngineRoot& engineRoot, const py::handle& pyClass)
+{
+	if (!py::hasattr(pyClass, advanceSimTimeBatchAttributeName))
+	{
+		return;
+	}
+
+	// Systems are added at registration time rather than when components are created,
+	// because components may be created while the system registry is being iterated.
+	auto system = findSystem<PyComponentBatchSystem>(*engineRoot.systemRegistry);
+	if (!system)
+	{
+		system = std::make_shared<PyComponentBatchSystem>();
+		engineRoot.systemRegistry->push_back(system);
+	}
+	system->getOrCreateBatch(pyClass);
+}
+
+PyComponentBatchPtr findPyComponentBatch(const EngineRoot& engineRoot, const py::handle& pyClass)
+{
+	if (auto system = findSystem<PyComponentBatchSystem>(*engineRoot.systemRegistry); system)
+	{
+		return system->findBatch(pyClass);
+	}
+	return nullptr;
+}
+
+} // namespace skybolt
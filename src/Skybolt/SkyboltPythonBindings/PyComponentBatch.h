@@ -0,0 +1,72 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltEngine/SkyboltEngineFwd.h>
+#include <SkyboltSim/System/System.h>
+
+#include <pybind11/pybind11.h>
+#include <map>
+#include <memory>
+
+namespace skybolt {
+
+//! Collects the components of a Python class that implements the class-level `advance_sim_time_batch(components, time, dt)` method,
+//! so that the class is advanced with a single Python call per substep instead of one call per component.
+class PyComponentBatch
+{
+public:
+	PyComponentBatch(pybind11::object advanceSimTimeBatch);
+	~PyComponentBatch();
+
+	//! Queues a Python component to be advanced by the next dispatch
+	void add(const pybind11::handle& pythonComponent, sim::SecondsD newTime, sim::SecondsD dt);
+
+	//! Calls `advance_sim_time_batch` with the queued components, if any
+	void dispatch();
+
+private:
+	pybind11::object mAdvanceSimTimeBatch;
+	pybind11::list mComponents;
+	sim::SecondsD mTime = 0;
+	sim::SecondsD mDt = 0;
+};
+
+using PyComponentBatchPtr = std::shared_ptr<PyComponentBatch>;
+
+//! Dispatches the PyComponentBatch of each registered Python class once per substep.
+//! Batches are dispatched after the EntitySystem has advanced all entities.
+class PyComponentBatchSystem : public sim::System
+{
+public:
+	~PyComponentBatchSystem() override;
+
+	//! @returns batch for the Python class, or null if the class does not implement `advance_sim_time_batch`
+	PyComponentBatchPtr getOrCreateBatch(const pybind11::handle& pyClass);
+
+	//! @returns batch for the Python class, or null if none has been created
+	PyComponentBatchPtr findBatch(const pybind11::handle& pyClass) const;
+
+	void advanceSimTime(sim::SecondsD newTime, sim::SecondsD dt) override;
+
+private:
+	struct ClassBatch
+	{
+		pybind11::object pyClass; //!< Keeps the class alive, so that its address remains a valid key
+		PyComponentBatchPtr batch;
+	};
+	std::map<PyObject*, ClassBatch> mBatches;
+};
+
+//! Registers a Python component class for batched dispatch if it implements `advance_sim_time_batch`.
+//! Adds a PyComponentBatchSystem to the engine's systems if one does not already exist.
+void registerPyComponentClass(EngineRoot& engineRoot, const pybind11::handle& pyClass);
+
+//! @returns batch for the Python class, or null if the class is not registered for batched dispatch
+PyComponentBatchPtr findPyComponentBatch(const EngineRoot& engineRoot, const pybind11::handle& pyClass);
+
+} // namespace skybolt
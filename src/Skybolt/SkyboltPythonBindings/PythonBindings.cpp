@@ -22,6 +22,7 @@
 #include <SkyboltEngine/Scenario/ScenarioSerialization.h>
 #include <SkyboltEngine/SimVisBinding/CameraSimVisBinding.h>
 #include <SkyboltEngine/SimVisBinding/SimVisSystem.h>
+#include <SkyboltEngine/UpdateLoop/FixedStepAdvancer.h>
 #include <SkyboltSim/Entity.h>
 #include <SkyboltSim/World.h>
 #include <SkyboltSim/CameraController/CameraController.h>
@@ -37,7 +38,6 @@
 #include <SkyboltSim/Spatial/GreatCircle.h>
 #include <SkyboltSim/Spatial/Orientation.h>
 #include <SkyboltSim/Spatial/Position.h>
-#include <SkyboltSim/System/SimStepper.h>
 
 #include <SkyboltVis/Rect.h>
 #include <SkyboltVis/VisRoot.h>
@@ -46,10 +46,12 @@
 #include <SkyboltVis/RenderOperation/DefaultRenderCameraViewport.h>
 #include <SkyboltVis/RenderOperation/RenderOperationSequence.h>
 #include <SkyboltVis/Window/CaptureScreenshot.h>
+#include <SkyboltVis/Window/FrameCaptureService.h>
 #include <SkyboltVis/Window/OffscreenWindow.h>
 #include <SkyboltVis/Window/StandaloneWindow.h>
 
 #include <osg/Image>
+#include <limits>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/operators.h>
@@ -168,11 +170,72 @@ static bool attachCameraToWindowWithEngine(sim::Entity& camera, vis::Window& win
 	return false;
 }
 
-static void advanceSimTime(EngineRoot& engineRoot, double dt)
+//! @returns false if the step was not taken because the end of the scenario's time range was reached
+static bool advanceSimTime(EngineRoot& engineRoot, double dt)
 {
-	// FIXME TODO: we should be starting from current sim time, not starting from zero
-	SimStepper stepper(engineRoot.systemRegistry);
-	stepper.update(dt);
+	return engineRoot.stepAdvancer->advance(dt, 1) == 1;
+}
+
+//! Advances the simulation by a number of fixed steps with the GIL released.
+//! The optional callback is called with the GIL held after every callbackInterval steps. Returning False from the callback stops advancing.
+//! @returns number of steps taken
+static int advanceSimTimeSteps(EngineRoot& engineRoot, double dt, int steps, int callbackInterval, const py::object& callback)
+{
+	FixedStepCallback stepCallback;
+	if (!callback.is_none())
+	{
+		stepCallback = [&callback] (int stepsTaken) {
+			py::gil_scoped_acquire acquire;
+			py::object result = callback(stepsTaken);
+			return result.is_none() || result.cast<bool>();
+		};
+	}
+
+	py::gil_scoped_release release;
+	return engineRoot.stepAdvancer->advance(dt, steps, callbackInterval, stepCallback);
+}
+
+static constexpr py::ssize_t recordedEntityStateSize = 7; //!< Position x, y, z followed by orientation quaternion x, y, z, w
+
+//! Advances the simulation by a number of fixed steps with the GIL released, recording the state of the given entities every recordInterval steps.
+//! @returns array of shape (recordCount, entityCount, 7) containing the geocentric position and orientation quaternion [x, y, z, w] of each entity.
+//! Entities without a position are recorded as NaN.
+static py::array_t<double> advanceSimTimeStepsAndRecordStates(EngineRoot& engineRoot, double dt, int steps, int recordInterval, const std::vector<EntityPtr>& entities)
+{
+	if (recordInterval <= 0)
+	{
+		throw std::invalid_argument("recordInterval must be greater than zero");
+	}
+
+	auto states = std::make_unique<std::vector<double>>();
+	py::ssize_t recordCount = 0;
+	{
+		py::gil_scoped_release release;
+		states->reserve(size_t(steps / recordInterval) * entities.size() * recordedEntityStateSize);
+
+		engineRoot.stepAdvancer->advance(dt, steps, recordInterval, [&] (int stepsTaken) {
+			for (const EntityPtr& entity : entities)
+			{
+				std::optional<Vector3> position = getPosition(*entity);
+				std::optional<Quaternion> orientation = getOrientation(*entity);
+				if (position && orientation)
+				{
+					states->insert(states->end(), { position->x, position->y, position->z, orientation->x, orientation->y, orientation->z, orientation->w });
+				}
+				else
+				{
+					states->insert(states->end(), recordedEntityStateSize, std::numeric_limits<double>::quiet_NaN());
+				}
+			}
+			++recordCount;
+			return true;
+		});
+	}
+
+	// Hand the buffer to numpy without copying
+	std::vector<double>* data = states.release();
+	py::capsule owner(data, [](void* p) { delete static_cast<std::vector<double>*>(p); });
+	return py::array_t<double>({ recordCount, py::ssize_t(entities.size()), recordedEntityStateSize }, data->data(), owner);
 }
 
 static void advanceWallTime(EngineRoot& engineRoot, double dt)
@@ -185,7 +248,8 @@ static void advanceWallTime(EngineRoot& engineRoot, double dt)
 
 static bool render(EngineRoot& engineRoot, vis::VisRoot& visRoot)
 {
-	advanceSimTime(engineRoot, 0.0); // FIXME: We need to call this to update all the systems prior to rendering
+	// Update systems without advancing time so that changes made from python since the last step are rendered
+	advanceSimTime(engineRoot, 0.0);
 	return visRoot.render();
 }
 
@@ -197,29 +261,33 @@ static py::array_t<std::uint8_t> captureScreenshotToImage(vis::VisRoot& visRoot)
 		throw std::runtime_error("Could not capture screenshot");
 	}
 
-	const int channelCount = image->getPixelSizeInBits() / 8;
-	const std::size_t size = image->s() * image->t() * channelCount;
-	auto result = py::array_t<std::uint8_t>(size);
-
-	py::buffer_info buf = result.request();
-	std::uint8_t* data = static_cast<std::uint8_t*>(buf.ptr);
-	std::memcpy(data, image->data(), size);
+	// Return a view of the image's pixels rather than copying them. The capsule keeps the image alive for the lifetime of the array.
+	const py::ssize_t channelCount = image->getPixelSizeInBits() / 8;
+	image->ref();
+	py::capsule owner(image.get(), [](void* p) { static_cast<osg::Image*>(p)->unref(); });
 
-	result.resize({ image->t(), image->s(), channelCount });
-    return result;
+	return py::array_t<std::uint8_t>(
+		{ py::ssize_t(image->t()), py::ssize_t(image->s()), channelCount },
+		{ py::ssize_t(image->getRowStepInBytes()), channelCount, py::ssize_t(1) },
+		image->data(), owner);
 }
 
 //! Register a python class as a component. The python class must derive from `skybolt.Component`.
+//! If the class implements a class-level `advance_sim_time_batch(components, time, dt)` method, its components are advanced
+//! by a single call to that method per substep rather than by calling `advance_sim_time` on each component.
 static void registerComponent(EngineRoot& engineRoot, const py::handle& pyClass)
 {
 	auto mComponentFactoryRegistry = valueOrThrowException(getExpectedRegistry<ComponentFactoryRegistry>(*engineRoot.factoryRegistries));
 
-	auto factory = std::make_shared<ComponentFactoryFunctionAdapter>([pyClass](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+	registerPyComponentClass(engineRoot, pyClass);
+	PyComponentBatchPtr batch = findPyComponentBatch(engineRoot, pyClass);
+
+	auto factory = std::make_shared<ComponentFactoryFunctionAdapter>([pyClass, batch](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
         // Instantiate the Python class
         py::object object = pyClass(entity);
 
 		// Create the C++ component to wrap the python object
-        return std::make_shared<PyComponent>(object);
+        return std::make_shared<PyComponent>(object, batch);
 	});
 
 	std::string componentClassName = py::str(pyClass.attr("__name__"));
@@ -234,14 +302,15 @@ static void loadScenarioFromJsonString(EngineRoot& engineRoot, const std::string
 
 	nlohmann::json j = nlohmann::json::parse(jsonString);
 	ifChildExists(j, "scenario", [&] (const nlohmann::json& child) {
-		readScenario(*engineRoot.typeRegistry, *engineRoot.scenario, entityFactoryFn, child);
+		engineRoot.entityFactory->prefetchModels(readScenarioTemplateNames(child));
+		readScenario(*engineRoot.typeRegistry, *engineRoot.scenario, entityFactoryFn, child, {}, engineRoot.scheduler.get());
 	});
 }
 
 static std::string saveScenarioToJsonString(EngineRoot& engineRoot)
 {
 	nlohmann::json j;
-	j["scenario"] = writeScenario(*engineRoot.typeRegistry, *engineRoot.scenario);
+	j["scenario"] = writeScenario(*engineRoot.typeRegistry, *engineRoot.scenario, engineRoot.scheduler.get());
 	return j.dump(4);
 }
 
@@ -488,18 +557,37 @@ PYBIND11_MODULE(skybolt, m) {
 		.def("getComponentsOfType", &getComponentsOfTypeName)
 		.def("getFirstComponentOfType", &getFirstComponentOfTypeName)
 		.def("addComponent", &Entity::addComponent)
+		.def("addPythonComponent", [](Entity* entity, const py::object& pythonComponent) {
+			// Wrap an instance of a python component class in a C++ component
+			EngineRoot* engineRoot = getGlobalEngineRoot();
+			PyComponentBatchPtr batch = engineRoot ? findPyComponentBatch(*engineRoot, py::type::of(pythonComponent)) : nullptr;
+			entity->addComponent(std::make_shared<PyComponent>(pythonComponent, batch));
+		})
 		.def_property("dynamicsEnabled", &Entity::isDynamicsEnabled, &Entity::setDynamicsEnabled);
 
 	py::class_<World>(m, "World")
 		.def("getEntities", &World::getEntities, py::return_value_policy::reference)
 		.def("addEntity", &World::addEntity)
+		.def("addEntities", &World::addEntities, "Adds a batch of entities in a single transaction")
 		.def("removeEntity", &World::removeEntity)
 		.def("removeAllEntities", &World::removeAllEntities)
 		.def("findEntityByName", &World::findObjectByName);
 
 	py::class_<EntityFactory>(m, "EntityFactory", "Class responsible for creating `Entity` instances based on a template name")
 		.def("createEntity", &EntityFactory::createEntity, py::return_value_policy::reference,
-			py::arg("templateName"), py::arg("name") = "", py::arg("position") = math::dvec3Zero(), py::arg("orientation") = math::dquatIdentity(), py::arg("id") = sim::nullEntityId());
+			py::arg("templateName"), py::arg("name") = "", py::arg("position") = math::dvec3Zero(), py::arg("orientation") = math::dquatIdentity(), py::arg("id") = sim::nullEntityId())
+		.def("createEntities", &EntityFactory::createEntities, "Creates a batch of entities, constructing components in parallel where possible. "
+			"The entities are not added to the world. Use `World.addEntities` to add them.");
+
+	py::class_<EntitySpawnRequest>(m, "EntitySpawnRequest")
+		.def(py::init([] (const std::string& templateName, const std::string& name, const sim::Vector3& position, const sim::Quaternion& orientation) {
+			return EntitySpawnRequest{templateName, name, position, orientation};
+		}), py::arg("templateName"), py::arg("name") = "", py::arg("position") = math::dvec3Zero(), py::arg("orientation") = math::dquatIdentity())
+		.def_readwrite("templateName", &EntitySpawnRequest::templateName)
+		.def_readwrite("name", &EntitySpawnRequest::instanceName)
+		.def_readwrite("position", &EntitySpawnRequest::position)
+		.def_readwrite("orientation", &EntitySpawnRequest::orientation)
+		.def_readwrite("id", &EntitySpawnRequest::id);
 
 	py::class_<Scenario>(m, "Scenario")
 		.def_readwrite("startJulianDate", &Scenario::startJulianDate)
@@ -538,13 +626,26 @@ PYBIND11_MODULE(skybolt, m) {
 		.def("removeWindow", &vis::VisRoot::removeWindow)
 		.def("setLoadTimingPolicy", &vis::VisRoot::setLoadTimingPolicy);
 
+	py::class_<vis::FrameCaptureService>(m, "FrameCaptureService", "Captures frames rendered to a window to file without stalling rendering")
+		.def(py::init<vis::Window&>(), py::keep_alive<1, 2>())
+		.def("captureNextFrame", py::overload_cast<const std::string&>(&vis::FrameCaptureService::captureNextFrame), py::arg("filename"))
+		.def("requestReadbackDrain", &vis::FrameCaptureService::requestReadbackDrain)
+		.def("getPendingReadbackCount", &vis::FrameCaptureService::getPendingReadbackCount)
+		.def("flushEncoder", &vis::FrameCaptureService::flushEncoder, py::call_guard<py::gil_scoped_release>());
+
 	m.def("getGlobalEngineRoot", &getGlobalEngineRoot, "Get global EngineRoot", py::return_value_policy::reference);
 	m.def("setGlobalEngineRoot", &setGlobalEngineRoot, "Set global EngineRoot");
 	m.def("createEngineRootWithDefaults", &createEngineRootWithDefaults, "Create an EngineRoot with default values"); //@deprecated
 	m.def("createEngineRoot", &createEngineRoot, py::arg("enableVis"), py::arg("loadPlugins"), "Create an EngineRoot");
 	m.def("attachCameraToWindowWithEngine", &attachCameraToWindowWithEngine);
 	m.def("registerComponent", &registerComponent);
-	m.def("advanceSimTime", &advanceSimTime);
+	m.def("advanceSimTime", &advanceSimTime, py::arg("engineRoot"), py::arg("dt"),
+		"Advance simulation by one step. Returns False if the step was not taken because the end of the scenario's time range was reached.");
+	m.def("advanceSimTimeSteps", &advanceSimTimeSteps, py::arg("engineRoot"), py::arg("dt"), py::arg("steps"), py::arg("callbackInterval") = 0, py::arg("callback") = py::none(),
+		"Advance simulation by a number of fixed steps without returning to python between steps. Returns the number of steps taken, "
+		"which is less than steps if the callback returned False or the end of the scenario's time range was reached.");
+	m.def("advanceSimTimeStepsAndRecordStates", &advanceSimTimeStepsAndRecordStates, py::arg("engineRoot"), py::arg("dt"), py::arg("steps"), py::arg("recordInterval"), py::arg("entities"),
+		"Advance simulation by a number of fixed steps, recording entity positions and orientations every recordInterval steps into an array of shape (recordCount, entityCount, 7)");
 	m.def("advanceWallTime", &advanceWallTime);
 	m.def("render", &render, py::arg("engineRoot"), py::arg("window"));
 	m.def("toGeocentricPosition", [](const PositionPtr& position) { return std::make_shared<GeocentricPosition>(toGeocentric(*position)); });
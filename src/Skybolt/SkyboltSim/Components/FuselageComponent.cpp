@@ -9,6 +9,7 @@
 #include "SkyboltSim/Components/Node.h"
 #include "SkyboltSim/Components/Motion.h"
 #include "SkyboltSim/Physics/Atmosphere.h"
+#include "SkyboltSim/Physics/WindField.h"
 #include "SkyboltSim/Spatial/GreatCircle.h"
 
 #include <algorithm>
@@ -22,7 +23,8 @@ FuselageComponent::FuselageComponent(const FuselageComponentConfig& config) :
 	mMotion(config.motion),
 	mBody(config.body),
 	mStickInput(config.stickInput),
-	mRudderInput(config.rudderInput)
+	mRudderInput(config.rudderInput),
+	mWindField(config.windField)
 {
 	assert(mNode);
 	assert(mMotion);
@@ -34,10 +36,10 @@ static double calcAltitude(const sim::Vector3& position)
 	return glm::length(position) - earthRadius();
 }
 
-static double calcAirDensity(double altitude)
+static const Atmosphere& getAtmosphere()
 {
 	static Atmosphere atmosphere = createEarthAtmosphere();
-	return atmosphere.getDensity(altitude);
+	return atmosphere;
 }
 
 void FuselageComponent::advanceSimTime(SecondsD newTime, SecondsD dt)
@@ -50,15 +52,32 @@ void FuselageComponent::updatePreDynamicsSubstep()
 	SecondsD dt = 0;
 	std::swap(mDt, dt);
 
-	const Vector3& velocityLocal = glm::inverse(mNode->getOrientation()) * mMotion->linearVelocity;
+	// Aerodynamics depend on velocity relative to the air
+	const Vector3 airVelocity = mWindField ? mMotion->linearVelocity - mWindField->sampleGeocentric(mNode->getPosition()) : mMotion->linearVelocity;
+	const Vector3 velocityLocal = glm::inverse(mNode->getOrientation()) * airVelocity;
 
 	// angle of attack and side slip
 	mAngleOfAttack = (float)std::atan2(velocityLocal.z, velocityLocal.x);
 	mSideSlipAngle = (float)std::atan2(-velocityLocal.y, velocityLocal.x);
 
+	const double altitude = calcAltitude(mNode->getPosition());
+	const float airDensity = getAtmosphere().getDensity(altitude);
+	const double speed = glm::length(airVelocity);
+
+	if (mParams.coefficientTables)
+	{
+		applyTableForcesAndMoments(*mParams.coefficientTables, velocityLocal, speed, airDensity, getAtmosphere().getSpeedOfSound(altitude));
+	}
+	else
+	{
+		applyAnalyticForcesAndMoments(velocityLocal, speed, airDensity);
+	}
+}
+
+void FuselageComponent::applyAnalyticForcesAndMoments(const Vector3& velocityLocal, double speed, float airDensity)
+{
 	// calculate lift
 	Vector3 lift;
-	const float airDensity = calcAirDensity(calcAltitude(mNode->getPosition()));
 
 	float alphaDelta = mAngleOfAttack - mParams.zeroLiftAlpha;
 
@@ -74,12 +93,10 @@ void FuselageComponent::updatePreDynamicsSubstep()
 
 	lift = Vector3(0.0f, 0.0f, -liftCoeff * mParams.liftArea * 0.5f * airDensity * glm::dot(velocityLocal, velocityLocal));
 
-	double speed = glm::length(mMotion->linearVelocity);
-	
 	//apply forces
 	if (speed > 0.0f)
 	{
-		Vector3 drag = calcDragForce(velocityLocal, -mMotion->linearVelocity / speed, airDensity);
+		Vector3 drag = calcDragForce(velocityLocal, -(mNode->getOrientation() * velocityLocal) / speed, airDensity);
 		mBody->applyCentralForce(drag);
 	}
 
@@ -96,7 +113,48 @@ void FuselageComponent::updatePreDynamicsSubstep()
 	double speedSquared = speed * speed;
 	float trimmedAngleOfAttack = calcTrimmedAngleOfAttack(mAngleOfAttack, airDensity, speedSquared);
 
-	const Vector3 moment = calcMoment(localAngularVelocity, sin(trimmedAngleOfAttack), sin(mSideSlipAngle), speedForMomentsSq, airDensity);
+	const Vector3 moment = calcStaticMoment(sin(trimmedAngleOfAttack), sin(mSideSlipAngle), speedForMomentsSq, airDensity)
+		+ calcDampingMoment(localAngularVelocity, airDensity);
+
+	mBody->applyTorque(orientation * moment * (double)mParams.momentMultiplier);
+}
+
+void FuselageComponent::applyTableForcesAndMoments(const AeroCoefficientTables& tables, const Vector3& velocityLocal, double speed, float airDensity, double speedOfSound)
+{
+	AeroVariables variables;
+	variables[size_t(AeroVariable::Mach)] = speed / speedOfSound;
+	variables[size_t(AeroVariable::AngleOfAttack)] = mAngleOfAttack;
+	variables[size_t(AeroVariable::SideSlipAngle)] = mSideSlipAngle;
+	variables[size_t(AeroVariable::Aileron)] = mStickInput ? mStickInput->value.x : 0.0;
+	variables[size_t(AeroVariable::Elevator)] = mStickInput ? mStickInput->value.y : 0.0;
+	variables[size_t(AeroVariable::Rudder)] = mRudderInput ? mRudderInput->value : 0.0;
+
+	const AeroCoefficients coefficients = tables.evaluate(variables, mCoefficientCursors);
+	const double qS = 0.5 * airDensity * speed * speed * tables.referenceArea;
+
+	const Quaternion& orientation = mNode->getOrientation();
+
+	if (speed > 0.0)
+	{
+		// Forces in wind axes. Drag opposes velocity, lift is perpendicular to velocity in the body x-z plane,
+		// and side force is perpendicular to both.
+		const Vector3 velocityDir = velocityLocal / speed;
+		Vector3 liftDir = glm::cross(Vector3(0, 1, 0), velocityDir);
+		double liftDirLength = glm::length(liftDir);
+		liftDir = (liftDirLength > 1e-8) ? liftDir / liftDirLength : Vector3(0, 0, -1);
+		const Vector3 sideForceDir = glm::cross(velocityDir, liftDir);
+
+		const Vector3 force = qS * (-coefficients.drag * velocityDir + coefficients.lift * liftDir + coefficients.sideForce * sideForceDir);
+		mBody->applyCentralForce(orientation * force);
+	}
+
+	const Vector3 localAngularVelocity = glm::inverse(orientation) * mMotion->angularVelocity;
+	const Vector3 staticMoment = qS * Vector3(
+		tables.referenceSpan * coefficients.rollMoment,
+		tables.referenceChord * coefficients.pitchMoment,
+		tables.referenceSpan * coefficients.yawMoment);
+
+	const Vector3 moment = staticMoment + calcDampingMoment(localAngularVelocity, airDensity);
 
 	mBody->applyTorque(orientation * moment * (double)mParams.momentMultiplier);
 }
@@ -109,21 +167,18 @@ Vector3 FuselageComponent::calcDragForce(const Vector3 &velocityLocal, const Vec
 	return dragDirection * CDrag * 0.5 * (double)density;
 }
 
-Vector3 FuselageComponent::calcMoment(const Vector3 &angularVelocity, float angleOfAttackFactor, float sideSlipFactor,
-									  float velSqLength, float airDensity) const
+Vector3 FuselageComponent::calcStaticMoment(float angleOfAttackFactor, float sideSlipFactor, float velSqLength, float airDensity) const
 {
 	Vector3 moment;
 
 	// Roll
-	moment.x = mParams.rollDueToSideSlipAngle * sideSlipFactor * velSqLength + mParams.rollDueToRollRate * angularVelocity.x
-		+ mParams.rollDueToYawRate * angularVelocity.z;
-	
+	moment.x = mParams.rollDueToSideSlipAngle * sideSlipFactor * velSqLength;
+
 	// Pitch
-	moment.y = mParams.pitchNeutralMoment * velSqLength + mParams.pitchDueToAngleOfAttack * angleOfAttackFactor * velSqLength
-			 + mParams.pitchDueToPitchRate * angularVelocity.y;
+	moment.y = mParams.pitchNeutralMoment * velSqLength + mParams.pitchDueToAngleOfAttack * angleOfAttackFactor * velSqLength;
 
 	// Yaw
-	moment.z = mParams.yawDueToSideSlipAngle * sideSlipFactor * velSqLength + mParams.yawDueToRollRate * angularVelocity.x + mParams.yawDueToYawRate * angularVelocity.z;
+	moment.z = mParams.yawDueToSideSlipAngle * sideSlipFactor * velSqLength;
 
 	// Control inputs
 	if (mStickInput)
@@ -140,6 +195,15 @@ Vector3 FuselageComponent::calcMoment(const Vector3 &angularVelocity, float angl
 	return moment * (double)airDensity;
 }
 
+Vector3 FuselageComponent::calcDampingMoment(const Vector3 &angularVelocity, float airDensity) const
+{
+	Vector3 moment;
+	moment.x = mParams.rollDueToRollRate * angularVelocity.x + mParams.rollDueToYawRate * angularVelocity.z;
+	moment.y = mParams.pitchDueToPitchRate * angularVelocity.y;
+	moment.z = mParams.yawDueToRollRate * angularVelocity.x + mParams.yawDueToYawRate * angularVelocity.z;
+	return moment * (double)airDensity;
+}
+
 float FuselageComponent::calcTrimmedAngleOfAttack(float angleOfAttack, float airDensity, float speedSquared) const
 {
 	if (mParams.maxAutoTrimAngleOfAttack)
@@ -9,6 +9,9 @@
 #include <SkyboltSim/Component.h>
 #include <SkyboltSim/SkyboltSimFwd.h>
 #include "SkyboltSim/Components/ControlInputsComponent.h"
+#include "SkyboltSim/Physics/AeroCoefficientTables.h"
+
+#include <memory>
 
 namespace skybolt {
 namespace sim {
@@ -43,6 +46,10 @@ struct FuselageParams
 	float yawDueToRudder;
 
 	std::optional<float> maxAutoTrimAngleOfAttack; //!< pitch auto trim disabled if empty
+
+	//! Optional. If set, the tables replace the analytic lift, drag and static moment models.
+	//! Rate damping moments are still calculated from the analytic parameters.
+	std::shared_ptr<const AeroCoefficientTables> coefficientTables;
 };
 
 struct FuselageComponentConfig
@@ -53,6 +60,7 @@ struct FuselageComponentConfig
 	DynamicBodyComponent* body;
 	ControlInputVec2Ptr stickInput; //!< Optional. Range is [-1, 1]. Positive backward and right.
 	ControlInputFloatPtr rudderInput; //!< Optional. Range [-1, 1]
+	const WindField* windField = nullptr; //!< Optional. If null, the air is assumed to be still.
 };
 
 class FuselageComponent : public Component
@@ -74,8 +82,11 @@ public: // SimUpdatable interface
 
 private:
 	Vector3 calcDragForce(const Vector3 &velocityLocal, const Vector3 &dragDirection, float density) const;
-	Vector3 calcMoment(const Vector3 &angularVelocity, float angleOfAttackFactor, float sideSlipFactor,
-				   float velSqLength, float airDensity) const;
+	Vector3 calcStaticMoment(float angleOfAttackFactor, float sideSlipFactor, float velSqLength, float airDensity) const;
+	Vector3 calcDampingMoment(const Vector3 &angularVelocity, float airDensity) const;
+
+	void applyAnalyticForcesAndMoments(const Vector3& velocityLocal, double speed, float airDensity);
+	void applyTableForcesAndMoments(const AeroCoefficientTables& tables, const Vector3& velocityLocal, double speed, float airDensity, double speedOfSound);
 
 	float calcTrimmedAngleOfAttack(float angleOfAttack, float airDensity, float speedSquared) const;
 
@@ -86,9 +97,11 @@ private:
 	DynamicBodyComponent* mBody;
 	ControlInputVec2Ptr mStickInput;
 	ControlInputFloatPtr mRudderInput;
+	const WindField* mWindField;
 
 	float mAngleOfAttack = 0;
 	float mSideSlipAngle = 0;
+	AeroCoefficientCursors mCoefficientCursors;
 	SecondsD mDt = 0;
 };
 
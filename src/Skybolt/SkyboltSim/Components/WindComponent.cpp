@@ -0,0 +1,32 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "WindComponent.h"
+
+#include <assert.h>
+
+namespace skybolt::sim {
+
+WindComponent::WindComponent(WindField* windField, std::vector<WindModelPtr> models) :
+	mWindField(windField),
+	mModels(std::move(models))
+{
+	assert(mWindField);
+	for (const WindModelPtr& model : mModels)
+	{
+		mWindField->addModel(model);
+	}
+}
+
+WindComponent::~WindComponent()
+{
+	for (const WindModelPtr& model : mModels)
+	{
+		mWindField->removeModel(model);
+	}
+}
+
+} // namespace skybolt::sim
@@ -0,0 +1,28 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltSim/Component.h"
+#include "SkyboltSim/Physics/WindField.h"
+
+namespace skybolt::sim {
+
+//! Adds wind models to a WindField for the lifetime of the component
+class WindComponent : public Component
+{
+public:
+	WindComponent(WindField* windField, std::vector<WindModelPtr> models);
+	~WindComponent() override;
+
+	const std::vector<WindModelPtr>& getModels() const { return mModels; }
+
+private:
+	WindField* mWindField;
+	std::vector<WindModelPtr> mModels;
+};
+
+} // namespace skybolt::sim
@@ -3,6 +3,9 @@
 #include "SkyboltSim/SimMath.h"
 #include "SkyboltSim/Spatial/LatLon.h"
 
+#include <assert.h>
+#include <span>
+
 namespace skybolt::sim {
 
 class OceanSurfaceSampler
@@ -12,6 +15,29 @@ public:
 
 	virtual double calcOceanAltitude(const skybolt::sim::LatLon& position, double filterRadius) const = 0;
 	virtual skybolt::sim::Vector3 calcOceanNormalNed(const skybolt::sim::LatLon& position, double filterRadius) const = 0;
+
+	//! Batched version of calcOceanAltitude(), e.g. for sampling many points on a hull.
+	//! Implementations may override this to amortize per-query overhead.
+	//! @param results must be the same size as positions
+	virtual void calcOceanAltitudes(std::span<const skybolt::sim::LatLon> positions, double filterRadius, std::span<double> results) const
+	{
+		assert(positions.size() == results.size());
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			results[i] = calcOceanAltitude(positions[i], filterRadius);
+		}
+	}
+
+	//! Batched version of calcOceanNormalNed()
+	//! @param results must be the same size as positions
+	virtual void calcOceanNormalsNed(std::span<const skybolt::sim::LatLon> positions, double filterRadius, std::span<skybolt::sim::Vector3> results) const
+	{
+		assert(positions.size() == results.size());
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			results[i] = calcOceanNormalNed(positions[i], filterRadius);
+		}
+	}
 };
 
 class PlanarOceanSurfaceSampler : public OceanSurfaceSampler
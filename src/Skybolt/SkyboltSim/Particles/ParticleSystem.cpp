@@ -8,6 +8,7 @@
 #include <SkyboltSim/Entity.h>
 #include <SkyboltSim/Components/PlanetComponent.h>
 #include <SkyboltSim/Physics/Atmosphere.h>
+#include <SkyboltSim/Physics/WindField.h>
 #include "SkyboltSim/Spatial/GreatCircle.h"
 #include "SkyboltSim/Spatial/Positionable.h"
 #include <SkyboltCommon/Random.h>
@@ -168,6 +169,12 @@ void ParticleIntegrator::update(float dt, std::vector<Particle>& particles)
 				sim::Vector3 particlePrevPositionWorldSpace = *mPrevPlanetTransform * glm::dvec4(particlePositionPlanetSpace, 1.0);
 
 				windVelocity = (firstParticlePosition - particlePrevPositionWorldSpace) / dtD;
+
+				// Wind is sampled once for all particles, which are assumed to be close together relative to the scale of wind variation
+				if (mParams.windField)
+				{
+					*windVelocity += mParams.windField->sampleGeocentric(firstParticlePosition);
+				}
 			}
 
 			mPrevPlanetTransform = planetTransform;
@@ -116,6 +116,7 @@ public:
 		float atmosphericSlowdownFactor;
 		std::optional<float> heatTransferCoefficent;
 		NearestPlanetProvider nearestPlanetProvider;
+		const WindField* windField = nullptr; //!< Optional. If null, the air moves with the planet.
 	};
 
 	ParticleIntegrator(const Params& params);
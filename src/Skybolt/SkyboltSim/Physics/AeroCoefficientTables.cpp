@@ -0,0 +1,180 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "AeroCoefficientTables.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <map>
+#include <stdexcept>
+
+namespace skybolt {
+namespace sim {
+
+AeroCoefficientTable::AeroCoefficientTable(std::vector<AeroVariable> axisVariables, math::GriddedTable table) :
+	mAxisVariables(std::move(axisVariables)),
+	mTable(std::move(table))
+{
+	if (mAxisVariables.size() != mTable.getDimensionCount())
+	{
+		throw std::invalid_argument("Number of aero table variables does not match number of table dimensions");
+	}
+}
+
+double AeroCoefficientTable::evaluate(const AeroVariables& variables, math::GriddedTableCursor& cursor) const
+{
+	std::array<double, math::griddedTableMaxDimensionCount> point;
+	for (size_t d = 0; d < mAxisVariables.size(); ++d)
+	{
+		point[d] = variables[size_t(mAxisVariables[d])];
+	}
+	return mTable.evaluate(point.data(), cursor);
+}
+
+static double evaluateOptional(const std::optional<AeroCoefficientTable>& table, const AeroVariables& variables, math::GriddedTableCursor& cursor)
+{
+	return table ? table->evaluate(variables, cursor) : 0.0;
+}
+
+AeroCoefficients AeroCoefficientTables::evaluate(const AeroVariables& variables, AeroCoefficientCursors& cursors) const
+{
+	AeroCoefficients c;
+	c.lift = evaluateOptional(lift, variables, cursors.lift);
+	c.drag = evaluateOptional(drag, variables, cursors.drag);
+	c.sideForce = evaluateOptional(sideForce, variables, cursors.sideForce);
+	c.rollMoment = evaluateOptional(rollMoment, variables, cursors.rollMoment);
+	c.pitchMoment = evaluateOptional(pitchMoment, variables, cursors.pitchMoment);
+	c.yawMoment = evaluateOptional(yawMoment, variables, cursors.yawMoment);
+	return c;
+}
+
+static AeroVariable readAeroVariable(const std::string& name)
+{
+	static const std::map<std::string, AeroVariable> variables = {
+		{"mach", AeroVariable::Mach},
+		{"angleOfAttack", AeroVariable::AngleOfAttack},
+		{"sideSlipAngle", AeroVariable::SideSlipAngle},
+		{"aileron", AeroVariable::Aileron},
+		{"elevator", AeroVariable::Elevator},
+		{"rudder", AeroVariable::Rudder}
+	};
+
+	auto i = variables.find(name);
+	if (i == variables.end())
+	{
+		throw std::runtime_error("Unknown aero table variable: " + name);
+	}
+	return i->second;
+}
+
+static bool isAngle(AeroVariable variable)
+{
+	return variable == AeroVariable::AngleOfAttack || variable == AeroVariable::SideSlipAngle;
+}
+
+//! Appends values to result in row-major order, checking that the nested array sizes match the axes
+static void flattenValues(const nlohmann::json& json, const std::vector<std::vector<double>>& axes, size_t dimension, std::vector<double>& result)
+{
+	if (!json.is_array() || json.size() != axes[dimension].size())
+	{
+		throw std::runtime_error("Aero table values for axis " + std::to_string(dimension) + " should be an array of " + std::to_string(axes[dimension].size()) + " elements");
+	}
+
+	if (dimension + 1 == axes.size())
+	{
+		for (const auto& value : json)
+		{
+			result.push_back(value.get<double>());
+		}
+	}
+	else
+	{
+		for (const auto& value : json)
+		{
+			flattenValues(value, axes, dimension + 1, result);
+		}
+	}
+}
+
+static AeroCoefficientTable readAeroCoefficientTable(const nlohmann::json& json)
+{
+	std::vector<AeroVariable> variables;
+	std::vector<std::vector<double>> axes;
+	for (const auto& axisJson : json.at("axes"))
+	{
+		AeroVariable variable = readAeroVariable(axisJson.at("variable").get<std::string>());
+		std::vector<double> breakpoints = axisJson.at("breakpoints").get<std::vector<double>>();
+
+		std::string units = axisJson.value("units", "radians");
+		if (units == "degrees" && isAngle(variable))
+		{
+			for (double& value : breakpoints)
+			{
+				value *= math::degToRadD();
+			}
+		}
+		else if (units != "radians")
+		{
+			throw std::runtime_error("Invalid units for aero table variable: " + units);
+		}
+
+		variables.push_back(variable);
+		axes.push_back(std::move(breakpoints));
+	}
+
+	if (axes.empty())
+	{
+		throw std::runtime_error("Aero table has no axes");
+	}
+
+	const nlohmann::json& valuesJson = json.at("values");
+	std::vector<double> values;
+	if (axes.size() > 1 && !valuesJson.empty() && valuesJson.front().is_number())
+	{
+		values = valuesJson.get<std::vector<double>>();
+	}
+	else
+	{
+		flattenValues(valuesJson, axes, 0, values);
+	}
+
+	try
+	{
+		return AeroCoefficientTable(std::move(variables), math::GriddedTable(std::move(axes), std::move(values)));
+	}
+	catch (const std::invalid_argument& e)
+	{
+		throw std::runtime_error(std::string("Invalid aero table: ") + e.what());
+	}
+}
+
+static std::optional<AeroCoefficientTable> readOptionalAeroCoefficientTable(const nlohmann::json& json, const std::string& name)
+{
+	auto i = json.find(name);
+	if (i != json.end())
+	{
+		return readAeroCoefficientTable(*i);
+	}
+	return std::nullopt;
+}
+
+AeroCoefficientTables readAeroCoefficientTables(const nlohmann::json& json)
+{
+	AeroCoefficientTables tables;
+	tables.referenceArea = json.at("referenceArea").get<double>();
+	tables.referenceSpan = json.value("referenceSpan", 1.0);
+	tables.referenceChord = json.value("referenceChord", 1.0);
+
+	tables.lift = readOptionalAeroCoefficientTable(json, "lift");
+	tables.drag = readOptionalAeroCoefficientTable(json, "drag");
+	tables.sideForce = readOptionalAeroCoefficientTable(json, "sideForce");
+	tables.rollMoment = readOptionalAeroCoefficientTable(json, "rollMoment");
+	tables.pitchMoment = readOptionalAeroCoefficientTable(json, "pitchMoment");
+	tables.yawMoment = readOptionalAeroCoefficientTable(json, "yawMoment");
+	return tables;
+}
+
+} // namespace sim
+} // namespace skybolt
@@ -0,0 +1,109 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltCommon/Math/GriddedTable.h>
+#include <nlohmann/json.hpp>
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace sim {
+
+//! Flight condition variables which aerodynamic coefficient tables can depend on
+enum class AeroVariable
+{
+	Mach,
+	AngleOfAttack, //!< Radians
+	SideSlipAngle, //!< Radians
+	Aileron, //!< Normalized deflection in range [-1, 1]
+	Elevator, //!< Normalized deflection in range [-1, 1]
+	Rudder, //!< Normalized deflection in range [-1, 1]
+	Count
+};
+
+using AeroVariables = std::array<double, size_t(AeroVariable::Count)>;
+
+//! A coefficient tabulated over a subset of AeroVariables
+class AeroCoefficientTable
+{
+public:
+	//! @param axisVariables is the variable of each table dimension
+	//! @throws std::invalid_argument if the number of variables does not match the table dimensions
+	AeroCoefficientTable(std::vector<AeroVariable> axisVariables, math::GriddedTable table);
+
+	double evaluate(const AeroVariables& variables, math::GriddedTableCursor& cursor) const;
+
+	const std::vector<AeroVariable>& getAxisVariables() const { return mAxisVariables; }
+	const math::GriddedTable& getTable() const { return mTable; }
+
+private:
+	std::vector<AeroVariable> mAxisVariables;
+	math::GriddedTable mTable;
+};
+
+//! Dimensionless aerodynamic coefficients.
+//! Forces are in wind axes and moments are in body axes.
+struct AeroCoefficients
+{
+	double lift = 0;
+	double drag = 0;
+	double sideForce = 0;
+	double rollMoment = 0;
+	double pitchMoment = 0;
+	double yawMoment = 0;
+};
+
+//! Stores lookup state for each table in AeroCoefficientTables, to speed up evaluation when flight conditions change gradually
+struct AeroCoefficientCursors
+{
+	math::GriddedTableCursor lift;
+	math::GriddedTableCursor drag;
+	math::GriddedTableCursor sideForce;
+	math::GriddedTableCursor rollMoment;
+	math::GriddedTableCursor pitchMoment;
+	math::GriddedTableCursor yawMoment;
+};
+
+struct AeroCoefficientTables
+{
+	double referenceArea = 1; //!< m^2
+	double referenceSpan = 1; //!< m. Used for roll and yaw moments.
+	double referenceChord = 1; //!< m. Used for pitch moment.
+
+	//! Missing tables have zero coefficient
+	std::optional<AeroCoefficientTable> lift;
+	std::optional<AeroCoefficientTable> drag;
+	std::optional<AeroCoefficientTable> sideForce;
+	std::optional<AeroCoefficientTable> rollMoment;
+	std::optional<AeroCoefficientTable> pitchMoment;
+	std::optional<AeroCoefficientTable> yawMoment;
+
+	AeroCoefficients evaluate(const AeroVariables& variables, AeroCoefficientCursors& cursors) const;
+};
+
+//! Reads tables in the format:
+//! {
+//!   "referenceArea": 27.9, "referenceSpan": 9.96, "referenceChord": 3.45,
+//!   "lift": {
+//!     "axes": [
+//!       {"variable": "mach", "breakpoints": [0, 0.8, 1.2]},
+//!       {"variable": "angleOfAttack", "breakpoints": [-10, 0, 10, 20], "units": "degrees"}
+//!     ],
+//!     "values": [[-0.8, 0.1, 1.0, 1.4], [-0.9, 0.1, 1.1, 1.5], [-0.7, 0.1, 0.9, 1.2]]
+//!   }
+//! }
+//! Variables are mach, angleOfAttack, sideSlipAngle, aileron, elevator and rudder.
+//! Angles are in radians unless units are "degrees". Control deflections are normalized to [-1, 1].
+//! Values are nested arrays with one level per axis, or a flat array with the last axis varying fastest.
+//! @throws std::runtime_error if the json is invalid
+AeroCoefficientTables readAeroCoefficientTables(const nlohmann::json& json);
+
+} // namespace sim
+} // namespace skybolt
@@ -15,12 +15,13 @@ namespace sim {
 const double Atmosphere::m_universalGasConst = 8.31447;
 
 Atmosphere::Atmosphere(double tempSeaLevel, double pressureSeaLevel,
-	double tempLapsRate, double g, double molarMass) :
+	double tempLapsRate, double g, double molarMass, double tropopauseAltitude) :
     m_tempSeaLevel(tempSeaLevel),
     m_pressureSeaLevel(pressureSeaLevel),
     m_tempLapsRate(tempLapsRate),
     m_lapseRateOnTemp(tempLapsRate / tempSeaLevel),
-    m_molarMass(molarMass)
+    m_molarMass(molarMass),
+    m_tropopauseAltitude(tropopauseAltitude)
 {
     m_exponent = g * molarMass / (m_universalGasConst * tempLapsRate);
 }
@@ -29,13 +30,28 @@ double Atmosphere::getDensity(double altitude) const
 {
 	double safeAltitude = std::max(0.0, altitude);
 	double p = m_pressureSeaLevel * (pow(std::max(double(0.0), double(1.0) - m_lapseRateOnTemp * safeAltitude), m_exponent));
-	double T = m_tempSeaLevel - m_tempLapsRate * safeAltitude;
+	double T = getTemperature(safeAltitude);
     return std::max(0.0, p * m_molarMass / (m_universalGasConst * T));
 }
 
+double Atmosphere::getTemperature(double altitude) const
+{
+	double safeAltitude = std::max(0.0, altitude);
+	return m_tempSeaLevel - m_tempLapsRate * safeAltitude;
+}
+
+double Atmosphere::getSpeedOfSound(double altitude) const
+{
+	// The linear lapse rate model only holds in the troposphere. Temperature is approximately
+	// constant above the tropopause, and clamping here keeps the speed of sound positive at any altitude.
+	constexpr double heatCapacityRatio = 1.4;
+	double T = getTemperature(std::min(altitude, m_tropopauseAltitude));
+	return std::sqrt(heatCapacityRatio * m_universalGasConst * T / m_molarMass);
+}
+
 Atmosphere createEarthAtmosphere()
 {
-	return Atmosphere(288.15, 101300, 0.0065, 9.8, 0.0289644);
+	return Atmosphere(288.15, 101300, 0.0065, 9.8, 0.0289644, 11000);
 }
 
 } // namespace sim
@@ -15,10 +15,14 @@ namespace sim {
 class Atmosphere
 {
 public:
+    //! @param tropopauseAltitude is the altitude above which temperature is held constant
     Atmosphere(double tempSeaLevel, double pressureSeaLevel, double tempLapsRate,
-		double g, double molarMass);
+		double g, double molarMass, double tropopauseAltitude);
 
 	double getDensity(double altitude) const;
+	double getTemperature(double altitude) const;
+	//! Temperature is held constant above the tropopause, so the result is always positive
+	double getSpeedOfSound(double altitude) const;
 
 private:
 	double m_lapseRateOnTemp; // L / T0
@@ -27,6 +31,7 @@ private:
 	double m_pressureSeaLevel;
 	double m_tempLapsRate;
 	double m_molarMass;
+	double m_tropopauseAltitude;
     static const double m_universalGasConst;
 };
 
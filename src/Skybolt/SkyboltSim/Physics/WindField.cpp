@@ -0,0 +1,368 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "WindField.h"
+#include "SkyboltSim/Spatial/Geocentric.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <assert.h>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace skybolt {
+namespace sim {
+
+void UniformWindModel::addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		windNed[i] += mVelocityNed;
+	}
+}
+
+GustWindModel::GustWindModel(const Params& params) :
+	mParams(params)
+{
+	if (mParams.duration <= 0)
+	{
+		throw std::invalid_argument("Gust duration must be positive");
+	}
+}
+
+void GustWindModel::addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const
+{
+	Vector3 velocity = calcVelocityNed(time);
+	for (size_t i = 0; i < count; ++i)
+	{
+		windNed[i] += velocity;
+	}
+}
+
+Vector3 GustWindModel::calcVelocityNed(SecondsD time) const
+{
+	double t = (time - mParams.startTime) / mParams.duration;
+	if (t <= 0 || t >= 1)
+	{
+		return math::dvec3Zero();
+	}
+	return mParams.peakVelocityNed * (0.5 * (1.0 - std::cos(math::twoPiD() * t)));
+}
+
+//! von Karman energy spectrum, without constant factors
+static double calcVonKarmanEnergy(double k, double lengthScale)
+{
+	double kl2 = k * k * lengthScale * lengthScale;
+	return kl2 * kl2 / std::pow(1.0 + kl2, 17.0 / 6.0);
+}
+
+static Vector3 randomUnitVector(std::mt19937& generator)
+{
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	double z = distribution(generator);
+	double theta = math::piD() * distribution(generator);
+	double r = std::sqrt(std::max(0.0, 1.0 - z * z));
+	return Vector3(r * std::cos(theta), r * std::sin(theta), z);
+}
+
+TurbulenceWindModel::TurbulenceWindModel(const Params& params)
+{
+	if (params.modeCount <= 0 || params.lengthScale <= 0)
+	{
+		throw std::invalid_argument("Turbulence mode count and length scale must be positive");
+	}
+
+	// Distribute modes logarithmically over wave numbers either side of the spectrum peak
+	const double kMin = 0.05 / params.lengthScale;
+	const double kMax = 50.0 / params.lengthScale;
+	const double logRange = std::log(kMax / kMin);
+
+	std::mt19937 generator(params.seed);
+	std::uniform_real_distribution<double> phaseDistribution(0.0, math::twoPiD());
+
+	std::vector<double> energies(params.modeCount);
+	double totalEnergy = 0;
+	mModes.resize(params.modeCount);
+	for (int i = 0; i < params.modeCount; ++i)
+	{
+		double k = kMin * std::exp(logRange * (double(i) + 0.5) / double(params.modeCount));
+		double dk = k * logRange / double(params.modeCount);
+		energies[i] = calcVonKarmanEnergy(k, params.lengthScale) * dk;
+		totalEnergy += energies[i];
+
+		Mode& mode = mModes[i];
+		Vector3 direction = randomUnitVector(generator);
+		mode.waveVector = direction * k;
+
+		// Amplitude perpendicular to the wave vector makes the field divergence free
+		Vector3 amplitudeDirection;
+		do
+		{
+			amplitudeDirection = glm::cross(direction, randomUnitVector(generator));
+		} while (glm::length(amplitudeDirection) < 1e-3);
+		mode.amplitude = glm::normalize(amplitudeDirection);
+		mode.angularFrequency = params.rmsVelocity * k;
+		mode.phase = phaseDistribution(generator);
+	}
+
+	// Scale amplitudes so that mean square speed is 3 * rmsVelocity^2.
+	// Each mode contributes half its squared amplitude to the mean square speed.
+	for (int i = 0; i < params.modeCount; ++i)
+	{
+		mModes[i].amplitude *= params.rmsVelocity * std::sqrt(6.0 * energies[i] / totalEnergy);
+	}
+}
+
+void TurbulenceWindModel::addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const
+{
+	// Modes are defined in geocentric axes, so the field is divergence free in geocentric space.
+	// The summed velocity is rotated into each point's local NED axes.
+	for (size_t i = 0; i < count; ++i)
+	{
+		Vector3 windGeocentric = math::dvec3Zero();
+		for (const Mode& mode : mModes)
+		{
+			double phase = glm::dot(mode.waveVector, points[i].position) + mode.phase - mode.angularFrequency * time;
+			windGeocentric += mode.amplitude * std::cos(phase);
+		}
+		windNed[i] += glm::inverse(latLonToGeocentricLtpOrientation(toLatLon(points[i].lla))) * windGeocentric;
+	}
+}
+
+constexpr size_t griddedWindLongitudeDimension = 1;
+
+//! If the table's longitude axis spans the globe, appends a copy of the first longitude's values at the first longitude plus 2 pi,
+//! so that interpolation is continuous across the seam.
+//! @returns the first longitude of the axis if the table is global
+static std::optional<double> closeLongitudeSeam(math::GriddedTable& table)
+{
+	const std::vector<std::vector<double>>& axes = table.getAxes();
+	const std::vector<double>& longitudes = axes[griddedWindLongitudeDimension];
+	if (longitudes.size() < 2)
+	{
+		return std::nullopt;
+	}
+
+	double maxSpacing = 0;
+	for (size_t i = 1; i < longitudes.size(); ++i)
+	{
+		maxSpacing = std::max(maxSpacing, longitudes[i] - longitudes[i - 1]);
+	}
+
+	constexpr double seamEpsilon = 1e-9;
+	const double seamGap = longitudes.front() + math::twoPiD() - longitudes.back();
+	if (seamGap < -seamEpsilon || seamGap > maxSpacing * (1.0 + 1e-6))
+	{
+		return std::nullopt;
+	}
+
+	if (seamGap > seamEpsilon)
+	{
+		std::vector<std::vector<double>> newAxes = axes;
+		newAxes[griddedWindLongitudeDimension].push_back(longitudes.front() + math::twoPiD());
+
+		// Copy values in row-major order, repeating the block of the first longitude at the end of each latitude row
+		const size_t latitudeCount = axes[0].size();
+		const size_t longitudeCount = longitudes.size();
+		const size_t blockSize = table.getValues().size() / (latitudeCount * longitudeCount);
+		const std::vector<double>& values = table.getValues();
+
+		std::vector<double> newValues;
+		newValues.reserve(latitudeCount * (longitudeCount + 1) * blockSize);
+		for (size_t i = 0; i < latitudeCount; ++i)
+		{
+			auto rowBegin = values.begin() + i * longitudeCount * blockSize;
+			newValues.insert(newValues.end(), rowBegin, rowBegin + longitudeCount * blockSize);
+			newValues.insert(newValues.end(), rowBegin, rowBegin + blockSize);
+		}
+		table = math::GriddedTable(std::move(newAxes), std::move(newValues));
+	}
+	return table.getAxes()[griddedWindLongitudeDimension].front();
+}
+
+static double wrapLongitude(double longitude, const std::optional<double>& wrapStart)
+{
+	return wrapStart ? *wrapStart + math::fmodNeg(longitude - *wrapStart, math::twoPiD()) : longitude;
+}
+
+GriddedWindModel::GriddedWindModel(math::GriddedTable north, math::GriddedTable east, math::GriddedTable down) :
+	mNorth(std::move(north)),
+	mEast(std::move(east)),
+	mDown(std::move(down))
+{
+	if (mNorth.getDimensionCount() != 4 || mEast.getDimensionCount() != 4 || mDown.getDimensionCount() != 4)
+	{
+		throw std::invalid_argument("Wind tables must have 4 dimensions");
+	}
+
+	mNorthWrapStart = closeLongitudeSeam(mNorth);
+	mEastWrapStart = closeLongitudeSeam(mEast);
+	mDownWrapStart = closeLongitudeSeam(mDown);
+}
+
+void GriddedWindModel::addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const
+{
+	// Nearby points are usually sampled together, so cursors speed up the bracket search within a batch
+	math::GriddedTableCursor northCursor;
+	math::GriddedTableCursor eastCursor;
+	math::GriddedTableCursor downCursor;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const LatLonAlt& lla = points[i].lla;
+		double p[4] = {lla.lat, 0, lla.alt, time};
+
+		p[griddedWindLongitudeDimension] = wrapLongitude(lla.lon, mNorthWrapStart);
+		double north = mNorth.evaluate(p, northCursor);
+		p[griddedWindLongitudeDimension] = wrapLongitude(lla.lon, mEastWrapStart);
+		double east = mEast.evaluate(p, eastCursor);
+		p[griddedWindLongitudeDimension] = wrapLongitude(lla.lon, mDownWrapStart);
+		double down = mDown.evaluate(p, downCursor);
+
+		windNed[i] += Vector3(north, east, down);
+	}
+}
+
+static std::vector<double> readAxis(const nlohmann::json& json, const std::string& name, double scale)
+{
+	std::vector<double> axis = json.at(name).get<std::vector<double>>();
+	for (double& value : axis)
+	{
+		value *= scale;
+	}
+	return axis;
+}
+
+std::shared_ptr<GriddedWindModel> readGriddedWindModel(const std::filesystem::path& filename)
+{
+	std::ifstream f(filename);
+	if (!f.is_open())
+	{
+		throw std::runtime_error("Could not open wind file: " + filename.string());
+	}
+
+	try
+	{
+		nlohmann::json json = nlohmann::json::parse(f);
+
+		std::vector<std::vector<double>> axes = {
+			readAxis(json, "latitudes", math::degToRadD()),
+			readAxis(json, "longitudes", math::degToRadD()),
+			readAxis(json, "altitudes", 1.0),
+			readAxis(json, "times", 1.0)
+		};
+
+		size_t valueCount = 1;
+		for (const auto& axis : axes)
+		{
+			valueCount *= axis.size();
+		}
+
+		std::vector<double> north = json.at("north").get<std::vector<double>>();
+		std::vector<double> east = json.at("east").get<std::vector<double>>();
+		std::vector<double> down = json.contains("down") ? json.at("down").get<std::vector<double>>() : std::vector<double>(valueCount, 0.0);
+
+		return std::make_shared<GriddedWindModel>(
+			math::GriddedTable(axes, std::move(north)),
+			math::GriddedTable(axes, std::move(east)),
+			math::GriddedTable(axes, std::move(down)));
+	}
+	catch (const std::exception& e)
+	{
+		throw std::runtime_error("Could not read wind file " + filename.string() + ": " + e.what());
+	}
+}
+
+WindField::WindField(double planetRadius) :
+	mPlanetRadius(planetRadius)
+{
+}
+
+void WindField::addModel(const WindModelPtr& model)
+{
+	assert(model);
+	mModels.push_back(model);
+}
+
+void WindField::removeModel(const WindModelPtr& model)
+{
+	mModels.erase(std::remove(mModels.begin(), mModels.end(), model), mModels.end());
+}
+
+Vector3 WindField::sampleNed(const Vector3& position) const
+{
+	// Sampled once per vehicle per step, so avoid the batch path's chunk buffer
+	Vector3 windNed = math::dvec3Zero();
+	if (!mModels.empty())
+	{
+		WindSamplePoint point;
+		point.position = position;
+		point.lla = geocentricToLla(position, mPlanetRadius);
+		addModelsWindNed(&point, 1, &windNed);
+	}
+	return windNed;
+}
+
+Vector3 WindField::sampleGeocentric(const Vector3& position) const
+{
+	Vector3 windNed = sampleNed(position);
+	if (mModels.empty())
+	{
+		return windNed;
+	}
+	return latLonToGeocentricLtpOrientation(geocentricToLatLon(position)) * windNed;
+}
+
+void WindField::sampleNed(const Vector3* positions, size_t count, Vector3* windNed) const
+{
+	std::fill(windNed, windNed + count, math::dvec3Zero());
+	if (mModels.empty())
+	{
+		return;
+	}
+
+	// Convert points in fixed size chunks on the stack to avoid allocating
+	constexpr size_t chunkSize = 64;
+	WindSamplePoint points[chunkSize];
+	for (size_t chunkBegin = 0; chunkBegin < count; chunkBegin += chunkSize)
+	{
+		size_t chunkCount = std::min(chunkSize, count - chunkBegin);
+		for (size_t i = 0; i < chunkCount; ++i)
+		{
+			points[i].position = positions[chunkBegin + i];
+			points[i].lla = geocentricToLla(positions[chunkBegin + i], mPlanetRadius);
+		}
+		addModelsWindNed(points, chunkCount, windNed + chunkBegin);
+	}
+}
+
+void WindField::addModelsWindNed(const WindSamplePoint* points, size_t count, Vector3* windNed) const
+{
+	for (const WindModelPtr& model : mModels)
+	{
+		model->addWindNed(points, count, mTime, windNed);
+	}
+}
+
+void WindField::sampleGeocentric(const Vector3* positions, size_t count, Vector3* wind) const
+{
+	sampleNed(positions, count, wind);
+	if (mModels.empty())
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		wind[i] = latLonToGeocentricLtpOrientation(geocentricToLatLon(positions[i])) * wind[i];
+	}
+}
+
+} // namespace sim
+} // namespace skybolt
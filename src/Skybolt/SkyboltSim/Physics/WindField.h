@@ -0,0 +1,173 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltSim/Chrono.h"
+#include "SkyboltSim/SimMath.h"
+#include "SkyboltSim/SkyboltSimFwd.h"
+#include "SkyboltSim/Spatial/LatLonAlt.h"
+#include <SkyboltCommon/Math/GriddedTable.h>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace sim {
+
+struct WindSamplePoint
+{
+	Vector3 position; //!< Geocentric position relative to planet center
+	LatLonAlt lla;
+};
+
+//! A source of wind, such as a mean wind field, gust or turbulence.
+//! Implementations must be stateless, so that they may be sampled concurrently and in any order.
+class WindModel
+{
+public:
+	virtual ~WindModel() = default;
+
+	//! Adds the wind velocity at each point to windNed, in north-east-down axes and m/s
+	virtual void addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const = 0;
+};
+
+//! Wind velocity which is the same everywhere
+class UniformWindModel : public WindModel
+{
+public:
+	explicit UniformWindModel(const Vector3& velocityNed) : mVelocityNed(velocityNed) {}
+
+	void addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const override;
+
+private:
+	Vector3 mVelocityNed;
+};
+
+//! Discrete "1-cosine" gust, which rises from zero to peak velocity and back to zero over its duration
+class GustWindModel : public WindModel
+{
+public:
+	struct Params
+	{
+		SecondsD startTime = 0;
+		SecondsD duration = 1;
+		Vector3 peakVelocityNed;
+	};
+
+	explicit GustWindModel(const Params& params);
+
+	void addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const override;
+
+	Vector3 calcVelocityNed(SecondsD time) const;
+
+private:
+	Params mParams;
+};
+
+//! Procedural turbulence synthesized from a sum of divergence free Fourier modes, with amplitudes following the von Karman energy spectrum.
+//! Modes are defined in geocentric axes, and velocities are rotated into each point's NED axes.
+//! The field is a deterministic function of position and time, so all vehicles sample the same turbulence and results are repeatable.
+class TurbulenceWindModel : public WindModel
+{
+public:
+	struct Params
+	{
+		double rmsVelocity = 1; //!< RMS velocity of each component in m/s
+		double lengthScale = 500; //!< Integral length scale in meters
+		int modeCount = 64;
+		unsigned int seed = 0;
+	};
+
+	explicit TurbulenceWindModel(const Params& params);
+
+	void addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const override;
+
+private:
+	struct Mode
+	{
+		Vector3 waveVector;
+		Vector3 amplitude;
+		double angularFrequency;
+		double phase;
+	};
+
+	std::vector<Mode> mModes;
+};
+
+//! Wind velocity interpolated from a 4-D grid over latitude, longitude, altitude and time.
+//! Points outside the grid take the value at the nearest grid boundary, except for longitudes of global grids,
+//! which wrap around. A grid is global if the gap between its last and first longitude,
+//! going east around the planet, is no larger than its largest longitude spacing.
+class GriddedWindModel : public WindModel
+{
+public:
+	//! Each table must have dimensions of latitude (radians), longitude (radians), altitude (meters) and time (seconds), in that order
+	GriddedWindModel(math::GriddedTable north, math::GriddedTable east, math::GriddedTable down);
+
+	void addWindNed(const WindSamplePoint* points, size_t count, SecondsD time, Vector3* windNed) const override;
+
+private:
+	math::GriddedTable mNorth;
+	math::GriddedTable mEast;
+	math::GriddedTable mDown;
+
+	//! First longitude of each table if the table is global, used to wrap longitudes into the table's range
+	std::optional<double> mNorthWrapStart;
+	std::optional<double> mEastWrapStart;
+	std::optional<double> mDownWrapStart;
+};
+
+//! Reads a GriddedWindModel from a json file in the format:
+//! {
+//!   "latitudes": [...], "longitudes": [...], "altitudes": [...], "times": [...],
+//!   "north": [...], "east": [...], "down": [...]
+//! }
+//! Latitudes and longitudes are in degrees, altitudes in meters and times in seconds.
+//! Velocities are in m/s in row-major order, with time varying fastest. "down" is optional.
+//! @throws std::runtime_error if the file could not be read
+std::shared_ptr<GriddedWindModel> readGriddedWindModel(const std::filesystem::path& filename);
+
+using WindModelPtr = std::shared_ptr<const WindModel>;
+
+//! Provides the wind velocity at any point on a planet, summed over all wind models
+class WindField
+{
+public:
+	explicit WindField(double planetRadius);
+
+	void addModel(const WindModelPtr& model);
+	void removeModel(const WindModelPtr& model);
+	const std::vector<WindModelPtr>& getModels() const { return mModels; }
+
+	//! Sets the time at which the wind field is sampled
+	void setTime(SecondsD time) { mTime = time; }
+	SecondsD getTime() const { return mTime; }
+
+	//! @param position is the geocentric position relative to planet center
+	//! @returns wind velocity in north-east-down axes
+	Vector3 sampleNed(const Vector3& position) const;
+
+	//! @returns wind velocity in geocentric axes
+	Vector3 sampleGeocentric(const Vector3& position) const;
+
+	//! Samples many points in one call, which is faster than sampling points one at a time
+	void sampleNed(const Vector3* positions, size_t count, Vector3* windNed) const;
+	void sampleGeocentric(const Vector3* positions, size_t count, Vector3* wind) const;
+
+private:
+	void addModelsWindNed(const WindSamplePoint* points, size_t count, Vector3* windNed) const;
+
+private:
+	const double mPlanetRadius;
+	std::vector<WindModelPtr> mModels;
+	SecondsD mTime = 0;
+};
+
+} // namespace sim
+} // namespace skybolt
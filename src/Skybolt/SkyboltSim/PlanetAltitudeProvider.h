@@ -7,7 +7,9 @@
 #pragma once
 
 #include <SkyboltSim/Spatial/LatLon.h>
+#include <assert.h>
 #include <optional>
+#include <span>
 #include <tuple>
 
 namespace skybolt {
@@ -16,6 +18,8 @@ namespace sim {
 class PlanetAltitudeProvider
 {
 public:
+	virtual ~PlanetAltitudeProvider() = default;
+
 	struct AltitudeResult
 	{
 		double altitude; //!< Altitude above sea level, positive is up.
@@ -47,6 +51,30 @@ public:
 	};
 
 	virtual AltitudeResult getAltitude(const sim::LatLon& position) const = 0;
+
+	//! Gets altitudes for a batch of positions. Implementations may override this to share work between positions.
+	virtual void getAltitudes(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results) const
+	{
+		assert(positions.size() == results.size());
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			results[i] = getAltitude(positions[i]);
+		}
+	}
+
+	struct AltitudeBounds
+	{
+		double minimum;
+		double maximum;
+	};
+
+	//! @returns bounds of the altitudes that getAltitude() may return for positions within a lat/lon rectangle,
+	//! or nullopt if bounds are not known. Longitudes must not wrap across the antimeridian.
+	//! Used to accelerate queries such as ray intersection by skipping regions that cannot contain terrain.
+	virtual std::optional<AltitudeBounds> getAltitudeBounds(const sim::LatLon& minimum, const sim::LatLon& maximum) const
+	{
+		return std::nullopt;
+	}
 };
 
 } // namespace sim
@@ -10,6 +10,7 @@
 #include <SkyboltCommon/Json/JsonHelpers.h>
 
 #include <boost/log/trivial.hpp>
+#include <unordered_map>
 
 namespace skybolt::sim {
 
@@ -36,30 +37,55 @@ static bool isSerializable(const refl::Property& property)
 	return true;
 }
 
-static std::optional<refl::Instance> jsonToReflVariant(refl::TypeRegistry& registry, const refl::Type& type, const nlohmann::json& json)
+//! Translators are keyed by type name rather than type pointer, so that they can be created once and shared by all registries
+template <typename TranslatorT>
+using TranslatorMap = std::unordered_map<std::string, TranslatorT>;
+
+template <typename TranslatorT>
+static TranslatorMap<TranslatorT> toTranslatorMap(const std::vector<std::pair<refl::TypePtr, TranslatorT>>& translators)
+{
+	TranslatorMap<TranslatorT> result;
+	for (const auto& [type, translator] : translators)
+	{
+		result[type->getName()] = translator;
+	}
+	return result;
+}
+
+static TranslatorMap<ToReflVariantTranslator> createToReflVariantTranslators(refl::TypeRegistry& registry)
 {
-	std::map<const refl::Type*, ToReflVariantTranslator> translators = {
-		{ registry.getOrCreateType<bool>().get(), createToReflVariantTranslator<bool>() },
-		{ registry.getOrCreateType<int>().get(), createToReflVariantTranslator<int>() },
-		{ registry.getOrCreateType<unsigned int>().get(), createToReflVariantTranslator<unsigned int>() },
-		{ registry.getOrCreateType<float>().get(), createToReflVariantTranslator<float>() },
-		{ registry.getOrCreateType<double>().get(), createToReflVariantTranslator<double>() },
-		{ registry.getOrCreateType<std::string>().get(), createToReflVariantTranslator<std::string>() },
+	return toTranslatorMap<ToReflVariantTranslator>({
+		{ registry.getOrCreateType<bool>(), createToReflVariantTranslator<bool>() },
+		{ registry.getOrCreateType<int>(), createToReflVariantTranslator<int>() },
+		{ registry.getOrCreateType<unsigned int>(), createToReflVariantTranslator<unsigned int>() },
+		{ registry.getOrCreateType<float>(), createToReflVariantTranslator<float>() },
+		{ registry.getOrCreateType<double>(), createToReflVariantTranslator<double>() },
+		{ registry.getOrCreateType<std::string>(), createToReflVariantTranslator<std::string>() },
 
-		{ registry.getOrCreateType<std::optional<bool>>().get(), createOptionalToReflVariantTranslator<bool>() },
-		{ registry.getOrCreateType<std::optional<int>>().get(), createOptionalToReflVariantTranslator<int>() },
-		{ registry.getOrCreateType<std::optional<unsigned int>>().get(), createOptionalToReflVariantTranslator<unsigned int>() },
-		{ registry.getOrCreateType<std::optional<float>>().get(), createOptionalToReflVariantTranslator<float>() },
-		{ registry.getOrCreateType<std::optional<double>>().get(), createOptionalToReflVariantTranslator<double>() },
-		{ registry.getOrCreateType<std::optional<std::string>>().get(), createToReflVariantTranslator<std::string>() },
+		{ registry.getOrCreateType<std::optional<bool>>(), createOptionalToReflVariantTranslator<bool>() },
+		{ registry.getOrCreateType<std::optional<int>>(), createOptionalToReflVariantTranslator<int>() },
+		{ registry.getOrCreateType<std::optional<unsigned int>>(), createOptionalToReflVariantTranslator<unsigned int>() },
+		{ registry.getOrCreateType<std::optional<float>>(), createOptionalToReflVariantTranslator<float>() },
+		{ registry.getOrCreateType<std::optional<double>>(), createOptionalToReflVariantTranslator<double>() },
+		{ registry.getOrCreateType<std::optional<std::string>>(), createToReflVariantTranslator<std::string>() },
 
-		{ registry.getOrCreateType<sim::Vector3>().get(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readVector3(json)); }},
-		{ registry.getOrCreateType<sim::Quaternion>().get(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readQuaternion(json)); }},
-		{ registry.getOrCreateType<sim::LatLon>().get(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readLatLon(json)); }},
-		{ registry.getOrCreateType<sim::LatLonAlt>().get(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readLatLonAlt(json)); }}
-	};
+		{ registry.getOrCreateType<sim::Vector3>(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readVector3(json)); }},
+		{ registry.getOrCreateType<sim::Quaternion>(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readQuaternion(json)); }},
+		{ registry.getOrCreateType<sim::LatLon>(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readLatLon(json)); }},
+		{ registry.getOrCreateType<sim::LatLonAlt>(), [] (refl::TypeRegistry& registry, const nlohmann::json& json) { return refl::makeValueInstance(registry, readLatLonAlt(json)); }}
+	});
+}
 
-	if (const auto& i = translators.find(&type); i != translators.end())
+static const TranslatorMap<ToReflVariantTranslator>& getToReflVariantTranslators(refl::TypeRegistry& registry)
+{
+	static const TranslatorMap<ToReflVariantTranslator> translators = createToReflVariantTranslators(registry);
+	return translators;
+}
+
+std::optional<refl::Instance> readBuiltInValue(refl::TypeRegistry& registry, const refl::Type& type, const nlohmann::json& json)
+{
+	const auto& translators = getToReflVariantTranslators(registry);
+	if (const auto& i = translators.find(type.getName()); i != translators.end())
 	{
 		return (i->second)(registry, json);
 	}
@@ -68,7 +94,7 @@ static std::optional<refl::Instance> jsonToReflVariant(refl::TypeRegistry& regis
 
 static void jsonToExistingReflVariant(refl::TypeRegistry& registry, refl::Instance& var, const nlohmann::json& json)
 {
-	if (const std::optional<refl::Instance>& newVar = jsonToReflVariant(registry, *var.getType(), json); newVar)
+	if (const std::optional<refl::Instance>& newVar = readBuiltInValue(registry, *var.getType(), json); newVar)
 	{
 		var = *newVar;
 	}
@@ -94,7 +120,12 @@ void readReflectedObject(refl::TypeRegistry& registry, refl::Instance& object, c
 
 void readReflectedObjectProperties(refl::TypeRegistry& registry, refl::Instance& object, const nlohmann::json& json)
 {
-	for (const auto& [name, property] : getProperties(object))
+	readReflectedObjectProperties(registry, object, json, getProperties(object));
+}
+
+void readReflectedObjectProperties(refl::TypeRegistry& registry, refl::Instance& object, const nlohmann::json& json, const refl::Type::PropertyMap& properties)
+{
+	for (const auto& [name, property] : properties)
 	{
 		if (isSerializable(*property))
 		{
@@ -126,30 +157,47 @@ ToJsonTranslator createOptionalToJsonTranslator()
 	};
 }
 
-static nlohmann::json toJson(refl::TypeRegistry& registry, const refl::Type& type, const refl::Instance& var)
+static TranslatorMap<ToJsonTranslator> createToJsonTranslators(refl::TypeRegistry& registry)
 {
-	std::map<const refl::Type*, ToJsonTranslator> translators = {
-		{ registry.getOrCreateType<bool>().get(), createToJsonTranslator<bool>() },
-		{ registry.getOrCreateType<int>().get(), createToJsonTranslator<int>() },
-		{ registry.getOrCreateType<unsigned int>().get(), createToJsonTranslator<unsigned int>() },
-		{ registry.getOrCreateType<float>().get(), createToJsonTranslator<float>() },
-		{ registry.getOrCreateType<double>().get(), createToJsonTranslator<double>() },
-		{ registry.getOrCreateType<std::string>().get(), createToJsonTranslator<std::string>() },
-
-		{ registry.getOrCreateType<std::optional<bool>>().get(), createOptionalToJsonTranslator<bool>() },
-		{ registry.getOrCreateType<std::optional<int>>().get(), createOptionalToJsonTranslator<int>() },
-		{ registry.getOrCreateType<std::optional<unsigned int>>().get(), createOptionalToJsonTranslator<unsigned int>() },
-		{ registry.getOrCreateType<std::optional<float>>().get(), createOptionalToJsonTranslator<float>() },
-		{ registry.getOrCreateType<std::optional<double>>().get(), createOptionalToJsonTranslator<double>() },
-		{ registry.getOrCreateType<std::optional<std::string>>().get(), createOptionalToJsonTranslator<std::string>() },
-
-		{ registry.getOrCreateType<sim::Vector3>().get(), [] (const refl::Instance& var) {	return writeJson(var.cast<sim::Vector3>()); }},
-		{ registry.getOrCreateType<sim::Quaternion>().get(), [] (const refl::Instance& var) { return writeJson(var.cast<sim::Quaternion>()); }},
-		{ registry.getOrCreateType<sim::LatLon>().get(), [] (const refl::Instance& var) { return writeJson(var.cast<sim::LatLon>()); }},
-		{ registry.getOrCreateType<sim::LatLonAlt>().get(), [] (const refl::Instance& var) { return writeJson(var.cast<sim::LatLonAlt>()); }}
-	};
+	return toTranslatorMap<ToJsonTranslator>({
+		{ registry.getOrCreateType<bool>(), createToJsonTranslator<bool>() },
+		{ registry.getOrCreateType<int>(), createToJsonTranslator<int>() },
+		{ registry.getOrCreateType<unsigned int>(), createToJsonTranslator<unsigned int>() },
+		{ registry.getOrCreateType<float>(), createToJsonTranslator<float>() },
+		{ registry.getOrCreateType<double>(), createToJsonTranslator<double>() },
+		{ registry.getOrCreateType<std::string>(), createToJsonTranslator<std::string>() },
+
+		{ registry.getOrCreateType<std::optional<bool>>(), createOptionalToJsonTranslator<bool>() },
+		{ registry.getOrCreateType<std::optional<int>>(), createOptionalToJsonTranslator<int>() },
+		{ registry.getOrCreateType<std::optional<unsigned int>>(), createOptionalToJsonTranslator<unsigned int>() },
+		{ registry.getOrCreateType<std::optional<float>>(), createOptionalToJsonTranslator<float>() },
+		{ registry.getOrCreateType<std::optional<double>>(), createOptionalToJsonTranslator<double>() },
+		{ registry.getOrCreateType<std::optional<std::string>>(), createOptionalToJsonTranslator<std::string>() },
+
+		{ registry.getOrCreateType<sim::Vector3>(), [] (const refl::Instance& var) {	return writeJson(var.cast<sim::Vector3>()); }},
+		{ registry.getOrCreateType<sim::Quaternion>(), [] (const refl::Instance& var) { return writeJson(var.cast<sim::Quaternion>()); }},
+		{ registry.getOrCreateType<sim::LatLon>(), [] (const refl::Instance& var) { return writeJson(var.cast<sim::LatLon>()); }},
+		{ registry.getOrCreateType<sim::LatLonAlt>(), [] (const refl::Instance& var) { return writeJson(var.cast<sim::LatLonAlt>()); }}
+	});
+}
 
-	if (const auto& i = translators.find(&type); i != translators.end())
+static const TranslatorMap<ToJsonTranslator>& getToJsonTranslators(refl::TypeRegistry& registry)
+{
+	static const TranslatorMap<ToJsonTranslator> translators = createToJsonTranslators(registry);
+	return translators;
+}
+
+void prepareConcurrentSerialization(refl::TypeRegistry& registry)
+{
+	// Translators are created on first use, which may create types in the registry
+	getToReflVariantTranslators(registry);
+	getToJsonTranslators(registry);
+}
+
+static nlohmann::json toJson(refl::TypeRegistry& registry, const refl::Type& type, const refl::Instance& var)
+{
+	const auto& translators = getToJsonTranslators(registry);
+	if (const auto& i = translators.find(type.getName()); i != translators.end())
 	{
 		return (i->second)(var);
 	}
@@ -181,10 +229,15 @@ nlohmann::json writeReflectedObject(refl::TypeRegistry& registry, const refl::In
 }
 
 nlohmann::json writeReflectedObjectProperties(refl::TypeRegistry& registry, const refl::Instance& object)
+{
+	return writeReflectedObjectProperties(registry, object, getProperties(object));
+}
+
+nlohmann::json writeReflectedObjectProperties(refl::TypeRegistry& registry, const refl::Instance& object, const refl::Type::PropertyMap& properties)
 {
 	nlohmann::json json;
 
-	for (const auto& [name, property] : getProperties(object))
+	for (const auto& [name, property] : properties)
 	{
 		if (isSerializable(*property))
 		{
@@ -18,6 +18,14 @@ void readReflectedObject(refl::TypeRegistry& registry, refl::Instance& object, c
 
 void readReflectedObjectProperties(refl::TypeRegistry& registry, refl::Instance& object, const nlohmann::json& json);
 
+//! Reads the given properties of object from json. Use to avoid looking up the properties of many objects of the same type.
+void readReflectedObjectProperties(refl::TypeRegistry& registry, refl::Instance& object, const nlohmann::json& json, const refl::Type::PropertyMap& properties);
+
+//! Reads a value of a type with built-in json support, which includes bool, numeric and string types, optionals of these types,
+//! vectors, quaternions and lat/lon types. Values are read without accessing any object, so may be read from multiple threads.
+//! @returns the value, or nullopt if the type does not have built-in json support
+std::optional<refl::Instance> readBuiltInValue(refl::TypeRegistry& registry, const refl::Type& type, const nlohmann::json& json);
+
 //! Writes object's properties to json. If object derives from ExplicitSerialization, the
 //! ExplicitSerialization function will be used, otherwise fall back to writeReflectedObjectProperties().
 nlohmann::json writeReflectedObject(refl::TypeRegistry& registry, const refl::Instance& object);
@@ -25,6 +33,14 @@ nlohmann::json writeReflectedObject(refl::TypeRegistry& registry, const refl::In
 //! Writes object's properties to json
 nlohmann::json writeReflectedObjectProperties(refl::TypeRegistry& registry, const refl::Instance& object);
 
+//! Writes the given properties of object to json. Use to avoid looking up the properties of many objects of the same type.
+nlohmann::json writeReflectedObjectProperties(refl::TypeRegistry& registry, const refl::Instance& object, const refl::Type::PropertyMap& properties);
+
+//! Must be called before serializing objects from multiple threads with the same registry,
+//! because serialization may otherwise create types in the registry on first use.
+//! Serializing objects concurrently is only safe if the objects' types and property types already exist in the registry.
+void prepareConcurrentSerialization(refl::TypeRegistry& registry);
+
 //! If an object implements this class, the toJson/fromJson methods will be used to serialize the object,
 //! instead of relying on reflection for automatic serialization. This is useful for implementing complex
 //! serialization logic that can't be handled by rttr reflection.
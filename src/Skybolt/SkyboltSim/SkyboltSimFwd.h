@@ -41,6 +41,9 @@ class Positionable;
 class PropellerComponent;
 class SimStepper;
 class System;
+class WindComponent;
+class WindField;
+class WindModel;
 class World;
 
 typedef std::shared_ptr<AttacherComponent> AttacherComponentPtr;
@@ -63,6 +66,7 @@ typedef std::shared_ptr<Position> PositionPtr;
 typedef std::shared_ptr<Positionable> PositionablePtr;
 typedef std::shared_ptr<PropellerComponent> PropellerComponentPtr;
 typedef std::shared_ptr<System> SystemPtr;
+typedef std::shared_ptr<WindComponent> WindComponentPtr;
 
 } // namespace sim
 } // namespace skybolt
\ No newline at end of file
@@ -0,0 +1,204 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TerrainRayIntersection.h"
+#include "Geocentric.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace skybolt {
+namespace sim {
+
+namespace {
+
+class TerrainRayMarcher
+{
+public:
+	TerrainRayMarcher(const PlanetAltitudeProvider& provider, double planetRadius, const Vector3& start, const Vector3& end, const TerrainRayIntersectionConfig& config) :
+		mProvider(provider),
+		mPlanetRadius(planetRadius),
+		mStart(start),
+		mLength(glm::length(end - start)),
+		mConfig(config)
+	{
+		mDirection = (mLength > 0) ? (end - start) / mLength : Vector3(0, 0, 0);
+	}
+
+	std::optional<double> intersect()
+	{
+		return intersectSegment(0, mLength);
+	}
+
+	Vector3 getPosition(double t) const
+	{
+		return mStart + mDirection * t;
+	}
+
+	//! @returns height of a position above the terrain
+	double getHeightAboveTerrain(const Vector3& position) const
+	{
+		return glm::length(position) - mPlanetRadius - mProvider.getAltitude(geocentricToLatLon(position)).altitude;
+	}
+
+private:
+	std::optional<double> intersectSegment(double t0, double t1)
+	{
+		// Find range of segment altitudes above the planet's sphere
+		double closestT = std::clamp(-glm::dot(mStart, mDirection), t0, t1);
+		double minRadius = glm::length(getPosition(closestT));
+		double maxRadius = std::max(glm::length(getPosition(t0)), glm::length(getPosition(t1)));
+
+		if (std::optional<PlanetAltitudeProvider::AltitudeBounds> bounds = getTerrainAltitudeBounds(t0, t1, minRadius); bounds)
+		{
+			if (minRadius - mPlanetRadius > bounds->maximum)
+			{
+				return std::nullopt; // Segment is entirely above terrain
+			}
+			if (maxRadius - mPlanetRadius < bounds->minimum)
+			{
+				return t0; // Segment is entirely below terrain
+			}
+		}
+
+		if (t1 - t0 <= mConfig.minStepLength)
+		{
+			return intersectLeafSegment(t0, t1);
+		}
+
+		double mid = (t0 + t1) * 0.5;
+		if (std::optional<double> result = intersectSegment(t0, mid); result)
+		{
+			return result;
+		}
+		return intersectSegment(mid, t1);
+	}
+
+	std::optional<double> intersectLeafSegment(double t0, double t1)
+	{
+		double h0 = getHeightAboveTerrainCached(t0);
+		if (h0 <= 0)
+		{
+			return t0;
+		}
+
+		double h1 = getHeightAboveTerrainCached(t1);
+		if (h1 > 0)
+		{
+			return std::nullopt;
+		}
+
+		// Bisect between a point above and a point below the terrain
+		while (t1 - t0 > mConfig.refinementTolerance)
+		{
+			double mid = (t0 + t1) * 0.5;
+			if (getHeightAboveTerrain(getPosition(mid)) > 0)
+			{
+				t0 = mid;
+			}
+			else
+			{
+				t1 = mid;
+			}
+		}
+		return t1;
+	}
+
+	//! Leaf segments are visited in order, so the height at the start of a leaf is usually the height at the end of the previous leaf
+	double getHeightAboveTerrainCached(double t)
+	{
+		if (!mCachedSample || mCachedSample->first != t)
+		{
+			mCachedSample = std::make_pair(t, getHeightAboveTerrain(getPosition(t)));
+		}
+		return mCachedSample->second;
+	}
+
+	//! @returns terrain altitude bounds within a lat/lon rectangle containing the segment [t0, t1]
+	std::optional<PlanetAltitudeProvider::AltitudeBounds> getTerrainAltitudeBounds(double t0, double t1, double minRadius) const
+	{
+		// Every point on the segment is within an angle theta of the midpoint, as seen from the planet center
+		double halfLength = (t1 - t0) * 0.5;
+		double sinTheta = (minRadius > 0) ? halfLength / minRadius : 1.0;
+
+		LatLon minimum(-math::halfPiD(), -math::piD());
+		LatLon maximum(math::halfPiD(), math::piD());
+		if (sinTheta < 0.7)
+		{
+			LatLon mid = geocentricToLatLon(getPosition(t0 + halfLength));
+			double theta = std::asin(sinTheta);
+			minimum.lat = std::max(-math::halfPiD(), mid.lat - theta);
+			maximum.lat = std::min(math::halfPiD(), mid.lat + theta);
+
+			// Longitude extent of the spherical cap, unless the cap contains a pole or wraps across the antimeridian
+			double sinLonExtent = sinTheta / std::cos(mid.lat);
+			if (std::abs(mid.lat) + theta < math::halfPiD() && sinLonExtent < 1.0)
+			{
+				double lonExtent = std::asin(sinLonExtent);
+				if (mid.lon - lonExtent >= -math::piD() && mid.lon + lonExtent <= math::piD())
+				{
+					minimum.lon = mid.lon - lonExtent;
+					maximum.lon = mid.lon + lonExtent;
+				}
+			}
+		}
+		return mProvider.getAltitudeBounds(minimum, maximum);
+	}
+
+private:
+	const PlanetAltitudeProvider& mProvider;
+	const double mPlanetRadius;
+	const Vector3 mStart;
+	Vector3 mDirection;
+	const double mLength;
+	const TerrainRayIntersectionConfig& mConfig;
+	std::optional<std::pair<double, double>> mCachedSample;
+};
+
+Vector3 calcTerrainNormal(const PlanetAltitudeProvider& provider, const Vector3& position, double sampleSpacing)
+{
+	Vector3 up = glm::normalize(position);
+	Vector3 east = glm::cross(Vector3(0, 0, 1), up);
+	east = (glm::dot(east, east) > 1e-12) ? glm::normalize(east) : Vector3(0, 1, 0);
+	Vector3 north = glm::cross(up, east);
+
+	std::array<LatLon, 4> positions = {
+		geocentricToLatLon(position + east * sampleSpacing),
+		geocentricToLatLon(position - east * sampleSpacing),
+		geocentricToLatLon(position + north * sampleSpacing),
+		geocentricToLatLon(position - north * sampleSpacing)
+	};
+	std::array<PlanetAltitudeProvider::AltitudeResult, 4> altitudes;
+	provider.getAltitudes(positions, altitudes);
+
+	double dAltitudeByEast = (altitudes[0].altitude - altitudes[1].altitude) / (2.0 * sampleSpacing);
+	double dAltitudeByNorth = (altitudes[2].altitude - altitudes[3].altitude) / (2.0 * sampleSpacing);
+	return glm::normalize(up - east * dAltitudeByEast - north * dAltitudeByNorth);
+}
+
+} // namespace
+
+std::optional<TerrainRayIntersection> intersectTerrain(const PlanetAltitudeProvider& provider, double planetRadius,
+	const Vector3& start, const Vector3& end, const TerrainRayIntersectionConfig& config)
+{
+	TerrainRayMarcher marcher(provider, planetRadius, start, end, config);
+	std::optional<double> distance = marcher.intersect();
+	if (!distance)
+	{
+		return std::nullopt;
+	}
+
+	TerrainRayIntersection result;
+	result.position = marcher.getPosition(*distance);
+	result.normal = calcTerrainNormal(provider, result.position, std::max(1.0, config.minStepLength * 0.5));
+	result.distance = *distance;
+	return result;
+}
+
+} // namespace sim
+} // namespace skybolt
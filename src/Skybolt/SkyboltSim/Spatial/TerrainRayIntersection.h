@@ -0,0 +1,40 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltSim/SimMath.h"
+#include "SkyboltSim/PlanetAltitudeProvider.h"
+
+#include <optional>
+
+namespace skybolt {
+namespace sim {
+
+struct TerrainRayIntersectionConfig
+{
+	double minStepLength = 10.0; //!< Segments no longer than this are tested by sampling terrain at their endpoints
+	double refinementTolerance = 0.1; //!< Intersection distance is refined to within this tolerance
+};
+
+struct TerrainRayIntersection
+{
+	Vector3 position; //!< Position in planet space
+	Vector3 normal; //!< Terrain normal in planet space
+	double distance; //!< Distance from the segment start
+};
+
+//! Finds the first intersection of a line segment with a planet's terrain.
+//! The segment is recursively subdivided, and sub-segments entirely above the terrain altitude bounds reported by
+//! PlanetAltitudeProvider::getAltitudeBounds() are skipped. Without bounds, this degrades to marching along the segment in steps of minStepLength.
+//! If the segment starts below the terrain, the intersection is at the start.
+//! @param start and end are in planet space, with the origin at the planet center
+//! @ThreadSafe if the provider is thread safe
+std::optional<TerrainRayIntersection> intersectTerrain(const PlanetAltitudeProvider& provider, double planetRadius,
+	const Vector3& start, const Vector3& end, const TerrainRayIntersectionConfig& config = {});
+
+} // namespace sim
+} // namespace skybolt
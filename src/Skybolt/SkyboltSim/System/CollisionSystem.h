@@ -12,15 +12,28 @@
 #include <SkyboltSim/System/System.h>
 
 #include <optional>
+#include <vector>
 
 namespace skybolt::sim {
 
+//! Describes contact between a pair of entities, aggregated over all contact points and substeps in a sim step.
+//! At most one event is generated per pair per sim step.
 struct CollisionEvent : public Event
 {
+	enum class Phase
+	{
+		Begin, //!< Entities started touching during the step
+		Persist, //!< Entities were already touching and still are
+		End //!< Entities stopped touching during the step
+	};
+
+	Phase phase = Phase::Begin;
 	EntityId entityA;
 	EntityId entityB;
-	Vector3 position; //!< Position of impact point
+	Vector3 position; //!< Position of deepest contact point on entityB. For End events, this is the last known position.
 	Vector3 normalB; //!< Direction of entityB's normal force from the collision
+	double impulse = 0; //!< Peak total impulse between the entities in any substep of the step, in N*s. Zero for End events.
+	int contactCount = 0; //!< Number of contact points between the entities. Zero for End events.
 };
 
 struct RayIntersectionResult
@@ -35,8 +48,14 @@ class CollisionSystem : public System
 {
 public:
 	~CollisionSystem() override = default;
+
+	//! Each CollisionEvent is emitted once per sim step.
 	EventEmitterPtr getEventEmitter() const { return mEventEmitter; }
 
+	//! @returns CollisionEvents generated in the most recent sim step.
+	//! Allows consumers to process events in bulk instead of listening to the event emitter.
+	const std::vector<CollisionEvent>& getCollisionEvents() const { return mCollisionEvents; }
+
 	virtual std::optional<RayIntersectionResult> intersectRay(const Vector3 &position, const Vector3 &direction, double length, int collisionFilterMask) const
 	{
 		Vector3 end = position + length * direction;
@@ -47,6 +66,7 @@ public:
 
 protected:
 	EventEmitterPtr mEventEmitter = std::make_shared<EventEmitter>();
+	std::vector<CollisionEvent> mCollisionEvents;
 };
 
 } // namespace skybolt::sim
\ No newline at end of file
@@ -0,0 +1,36 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltSim/Physics/WindField.h>
+#include <SkyboltSim/System/System.h>
+
+#include <assert.h>
+
+namespace skybolt::sim {
+
+//! Keeps the WindField time in sync with the simulation time
+class WindSystem : public System
+{
+public:
+	explicit WindSystem(WindField* windField) : mWindField(windField)
+	{
+		assert(mWindField);
+	}
+
+	~WindSystem() override = default;
+
+	void setSimTime(SecondsD newTime) override
+	{
+		mWindField->setTime(newTime);
+	}
+
+private:
+	WindField* mWindField;
+};
+
+} // namespace skybolt::sim
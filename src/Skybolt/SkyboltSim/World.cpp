@@ -7,12 +7,13 @@
 
 #include "SkyboltSim/World.h"
 #include "SkyboltSim/Components/NameComponent.h"
-#include <SkyboltCommon/MapUtility.h>
+#include "SkyboltSim/Spatial/GreatCircle.h"
 
 namespace skybolt {
 namespace sim {
 
-World::World()
+World::World() :
+	mWindField(earthRadius())
 {
 }
 
@@ -35,6 +36,34 @@ void World::addEntity(const EntityPtr& entity)
 		return;
 	}
 
+	insertEntity(entity);
+
+	CALL_LISTENERS(entityAdded(entity));
+}
+
+void World::addEntities(const std::vector<EntityPtr>& entities)
+{
+	if (mDestructing || entities.empty())
+	{
+		return;
+	}
+
+	mEntities.reserve(mEntities.size() + entities.size());
+	mIdToEntityMap.reserve(mIdToEntityMap.size() + entities.size());
+	mNameToEntityMap.reserve(mNameToEntityMap.size() + entities.size());
+
+	for (const EntityPtr& entity : entities)
+	{
+		assert(entity);
+		assert(!getEntityById(entity->getId()));
+		insertEntity(entity);
+	}
+
+	CALL_LISTENERS(entitiesAdded(entities));
+}
+
+void World::insertEntity(const EntityPtr& entity)
+{
 	mEntities.push_back(entity);
 	mIdToEntityMap[entity->getId()] = entity;
 
@@ -42,8 +71,6 @@ void World::addEntity(const EntityPtr& entity)
 	{
 		mNameToEntityMap[name] = entity;
 	}
-
-	CALL_LISTENERS(entityAdded(entity));
 }
 
 void World::removeEntity(Entity* entity)
@@ -107,7 +134,11 @@ Vector3 World::calcGravity(const Vector3& position, double mass) const
 
 EntityPtr World::findObjectByName(const std::string& name) const
 {
-	return findOptional(mNameToEntityMap, name).value_or(nullptr);
+	if (auto i = mNameToEntityMap.find(name); i != mNameToEntityMap.end())
+	{
+		return i->second;
+	}
+	return nullptr;
 }
 
 } // namespace sim
@@ -8,9 +8,12 @@
 #pragma once
 
 #include "SkyboltSim/Entity.h"
+#include "SkyboltSim/Physics/WindField.h"
 #include <SkyboltCommon/Event.h>
 #include <SkyboltCommon/Listenable.h>
 
+#include <unordered_map>
+
 namespace skybolt {
 namespace sim {
 
@@ -20,6 +23,17 @@ public:
 	virtual ~WorldListener() {}
 
 	virtual void entityAdded(const sim::EntityPtr& entity) {}
+
+	//! Called once when a batch of entities is added with World::addEntities.
+	//! The default implementation calls entityAdded() for each entity.
+	virtual void entitiesAdded(const std::vector<sim::EntityPtr>& entities)
+	{
+		for (const sim::EntityPtr& entity : entities)
+		{
+			entityAdded(entity);
+		}
+	}
+
 	virtual void entityAboutToBeRemoved(const sim::EntityPtr& entity) {}
 	virtual void entityRemoved(const sim::EntityPtr& entity) {}
 };
@@ -32,7 +46,15 @@ public:
 
 	Vector3 calcGravity(const Vector3& position, double mass) const;
 
+	WindField& getWindField() { return mWindField; }
+	const WindField& getWindField() const { return mWindField; }
+
 	void addEntity(const EntityPtr& entity);
+
+	//! Adds a batch of entities in a single transaction. All entities are added to the world before listeners
+	//! are notified once through WorldListener::entitiesAdded.
+	void addEntities(const std::vector<EntityPtr>& entities);
+
 	void removeEntity(Entity* entity);
 	void removeAllEntities();
 
@@ -46,9 +68,13 @@ public:
 	EntityPtr findObjectByName(const std::string& name) const;
 
 private:
+	void insertEntity(const EntityPtr& entity);
+
+private:
+	WindField mWindField; //!< Declared before entities so that it outlives components which reference it
 	Entities mEntities;
-	std::map<EntityId, EntityPtr> mIdToEntityMap;
-	std::map<std::string, EntityPtr> mNameToEntityMap;
+	std::unordered_map<EntityId, EntityPtr> mIdToEntityMap;
+	std::unordered_map<std::string, EntityPtr> mNameToEntityMap;
 
 	bool mDestructing = false;
 };
@@ -0,0 +1,222 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <SkyboltSim/Components/FuselageComponent.h>
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/Components/SimpleDynamicBodyComponent.h>
+#include <SkyboltSim/Physics/AeroCoefficientTables.h>
+#include <SkyboltSim/Physics/Atmosphere.h>
+#include <SkyboltSim/Spatial/GreatCircle.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <catch2/catch.hpp>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+static AeroVariables createAeroVariables(double mach, double angleOfAttack)
+{
+	AeroVariables variables = {};
+	variables[size_t(AeroVariable::Mach)] = mach;
+	variables[size_t(AeroVariable::AngleOfAttack)] = angleOfAttack;
+	return variables;
+}
+
+static nlohmann::json createTablesJson()
+{
+	return nlohmann::json::parse(R"({
+		"referenceArea": 20,
+		"referenceSpan": 10,
+		"referenceChord": 2,
+		"lift": {
+			"axes": [
+				{"variable": "mach", "breakpoints": [0, 1]},
+				{"variable": "angleOfAttack", "breakpoints": [-10, 0, 10], "units": "degrees"}
+			],
+			"values": [[-1, 0, 1], [-2, 0, 2]]
+		},
+		"drag": {
+			"axes": [{"variable": "angleOfAttack", "breakpoints": [-0.2, 0, 0.2]}],
+			"values": [0.1, 0.02, 0.1]
+		},
+		"pitchMoment": {
+			"axes": [
+				{"variable": "angleOfAttack", "breakpoints": [-1, 1]},
+				{"variable": "elevator", "breakpoints": [-1, 1]}
+			],
+			"values": [0.1, 0.3, -0.1, 0.1]
+		}
+	})");
+}
+
+TEST_CASE("Read aero coefficient tables from json")
+{
+	AeroCoefficientTables tables = readAeroCoefficientTables(createTablesJson());
+	CHECK(tables.referenceArea == 20);
+	CHECK(tables.referenceSpan == 10);
+	CHECK(tables.referenceChord == 2);
+
+	REQUIRE(tables.lift);
+	REQUIRE(tables.drag);
+	REQUIRE(tables.pitchMoment);
+	CHECK(!tables.sideForce);
+	CHECK(!tables.rollMoment);
+	CHECK(!tables.yawMoment);
+
+	CHECK(tables.lift->getAxisVariables() == std::vector<AeroVariable>({AeroVariable::Mach, AeroVariable::AngleOfAttack}));
+	CHECK(tables.lift->getTable().getAxes()[1][2] == Approx(10.0 * math::degToRadD()));
+	CHECK(tables.lift->getTable().getValues() == std::vector<double>({-1, 0, 1, -2, 0, 2}));
+	CHECK(tables.pitchMoment->getTable().getValues() == std::vector<double>({0.1, 0.3, -0.1, 0.1}));
+}
+
+TEST_CASE("Evaluate aero coefficient tables")
+{
+	AeroCoefficientTables tables = readAeroCoefficientTables(createTablesJson());
+	AeroCoefficientCursors cursors;
+
+	AeroVariables variables = createAeroVariables(0.5, 5.0 * math::degToRadD());
+	variables[size_t(AeroVariable::Elevator)] = 0.5;
+
+	AeroCoefficients c = tables.evaluate(variables, cursors);
+	CHECK(c.lift == Approx(0.75));
+	CHECK(c.drag == Approx(0.02 + 0.08 * (5.0 * math::degToRadD()) / 0.2));
+	CHECK(c.pitchMoment == Approx(0.15 - 0.1 * 5.0 * math::degToRadD()));
+	CHECK(c.sideForce == 0);
+	CHECK(c.rollMoment == 0);
+	CHECK(c.yawMoment == 0);
+
+	// Values outside table are clamped
+	variables = createAeroVariables(3.0, 1.0);
+	c = tables.evaluate(variables, cursors);
+	CHECK(c.lift == Approx(2));
+	CHECK(c.drag == Approx(0.1));
+}
+
+TEST_CASE("Reading invalid aero coefficient tables throws")
+{
+	nlohmann::json json = createTablesJson();
+
+	SECTION("Unknown variable")
+	{
+		json["lift"]["axes"][0]["variable"] = "altitude";
+	}
+
+	SECTION("Degrees units for non-angle variable")
+	{
+		json["lift"]["axes"][0]["units"] = "degrees";
+	}
+
+	SECTION("Nested values do not match axis size")
+	{
+		json["lift"]["values"] = nlohmann::json::parse("[[-1, 0], [-2, 0], [1, 2]]");
+	}
+
+	SECTION("Wrong number of flat values")
+	{
+		json["pitchMoment"]["values"] = nlohmann::json::parse("[1, 2, 3]");
+	}
+
+	SECTION("Breakpoints not increasing")
+	{
+		json["drag"]["axes"][0]["breakpoints"] = nlohmann::json::parse("[0, 0, 0.2]");
+	}
+
+	CHECK_THROWS_AS(readAeroCoefficientTables(json), std::runtime_error);
+}
+
+namespace {
+
+class RecordingBody : public SimpleDynamicBodyComponent
+{
+public:
+	using SimpleDynamicBodyComponent::SimpleDynamicBodyComponent;
+
+	void applyCentralForce(const Vector3& f) override { force += f; }
+	void applyTorque(const Vector3& t) override { torque += t; }
+
+	Vector3 force = math::dvec3Zero();
+	Vector3 torque = math::dvec3Zero();
+};
+
+} // namespace
+
+TEST_CASE("Fuselage applies forces and moments from coefficient tables")
+{
+	const double altitude = 1000;
+	Node node(Vector3(earthRadius() + altitude, 0, 0));
+	Motion motion;
+	RecordingBody body(&node, &motion, 1000, Vector3(1, 1, 1));
+
+	// Flying along the body x axis at 2 degrees angle of attack
+	const double speed = 100;
+	const double angleOfAttack = 2.0 * math::degToRadD();
+	motion.linearVelocity = speed * Vector3(std::cos(angleOfAttack), 0, std::sin(angleOfAttack));
+	motion.angularVelocity = math::dvec3Zero();
+
+	auto tables = std::make_shared<AeroCoefficientTables>(readAeroCoefficientTables(createTablesJson()));
+
+	FuselageComponentConfig config;
+	config.params = FuselageParams{};
+	config.params.momentMultiplier = 1;
+	config.params.coefficientTables = tables;
+	config.node = &node;
+	config.motion = &motion;
+	config.body = &body;
+
+	FuselageComponent fuselage(config);
+	fuselage.updatePreDynamicsSubstep();
+
+	Atmosphere atmosphere = createEarthAtmosphere();
+	AeroCoefficientCursors cursors;
+	AeroCoefficients c = tables->evaluate(createAeroVariables(speed / atmosphere.getSpeedOfSound(altitude), angleOfAttack), cursors);
+	double qS = 0.5 * atmosphere.getDensity(altitude) * speed * speed * tables->referenceArea;
+
+	// Lift is perpendicular to velocity, drag opposes velocity
+	Vector3 velocityDir = glm::normalize(motion.linearVelocity);
+	CHECK(glm::dot(body.force, velocityDir) == Approx(-qS * c.drag));
+	CHECK(glm::length(body.force - glm::dot(body.force, velocityDir) * velocityDir) == Approx(qS * c.lift));
+	CHECK(body.force.z < 0); // upward
+	CHECK(body.force.y == Approx(0).margin(1e-8));
+
+	CHECK(body.torque.x == Approx(0).margin(1e-8));
+	CHECK(body.torque.y == Approx(qS * tables->referenceChord * c.pitchMoment));
+	CHECK(body.torque.z == Approx(0).margin(1e-8));
+}
+
+TEST_CASE("Fuselage scales table moments by moment multiplier")
+{
+	const double altitude = 1000;
+	Node node(Vector3(earthRadius() + altitude, 0, 0));
+	Motion motion;
+	motion.linearVelocity = Vector3(100, 0, 0);
+	motion.angularVelocity = math::dvec3Zero();
+
+	auto tables = std::make_shared<AeroCoefficientTables>(readAeroCoefficientTables(createTablesJson()));
+
+	auto calcTorque = [&] (float momentMultiplier) {
+		RecordingBody body(&node, &motion, 1000, Vector3(1, 1, 1));
+
+		FuselageComponentConfig config;
+		config.params = FuselageParams{};
+		config.params.momentMultiplier = momentMultiplier;
+		config.params.coefficientTables = tables;
+		config.node = &node;
+		config.motion = &motion;
+		config.body = &body;
+
+		FuselageComponent fuselage(config);
+		fuselage.updatePreDynamicsSubstep();
+		return body.torque;
+	};
+
+	Vector3 torque = calcTorque(1);
+	REQUIRE(torque.y != 0);
+
+	Vector3 scaledTorque = calcTorque(2);
+	CHECK(scaledTorque.x == Approx(2 * torque.x).margin(1e-8));
+	CHECK(scaledTorque.y == Approx(2 * torque.y));
+	CHECK(scaledTorque.z == Approx(2 * torque.z).margin(1e-8));
+}
@@ -10,14 +10,44 @@
 #include <catch2/catch.hpp>
 
 #include <assert.h>
+#include <cmath>
 
 using namespace skybolt;
 using namespace skybolt::sim;
 
 TEST_CASE("Atmosphere density matches reference data")
 {
-    Atmosphere atm(288.15, 101300, 0.0065, 9.8, 0.0289644);
+    Atmosphere atm(288.15, 101300, 0.0065, 9.8, 0.0289644, 11000);
     // From 1976 Standard Atmosphere
 	CHECK(almostEqualFracEpsilon(0.909122, atm.getDensity(3000), 0.001));
 	CHECK(almostEqualFracEpsilon(0.525168, atm.getDensity(8000), 0.001));
 }
+
+TEST_CASE("Atmosphere speed of sound matches reference data")
+{
+	Atmosphere atm = createEarthAtmosphere();
+	// From 1976 Standard Atmosphere
+	CHECK(almostEqualFracEpsilon(340.294, atm.getSpeedOfSound(0), 0.001));
+	CHECK(almostEqualFracEpsilon(308.063, atm.getSpeedOfSound(8000), 0.001));
+	CHECK(almostEqualFracEpsilon(295.070, atm.getSpeedOfSound(11000), 0.001));
+	CHECK(almostEqualFracEpsilon(295.070, atm.getSpeedOfSound(20000), 0.001));
+}
+
+TEST_CASE("Atmosphere speed of sound is constant above configured tropopause")
+{
+	Atmosphere atm(288.15, 101300, 0.0065, 9.8, 0.0289644, 8000);
+	CHECK(almostEqualFracEpsilon(308.063, atm.getSpeedOfSound(8000), 0.001));
+	CHECK(almostEqualFracEpsilon(308.063, atm.getSpeedOfSound(11000), 0.001));
+}
+
+TEST_CASE("Atmosphere speed of sound is positive above the range of the lapse rate model")
+{
+	Atmosphere atm = createEarthAtmosphere();
+	// Temperature from the linear lapse rate model reaches zero at around 44km
+	for (double altitude : {44000.0, 50000.0, 100000.0, 1e7})
+	{
+		double speedOfSound = atm.getSpeedOfSound(altitude);
+		CHECK(std::isfinite(speedOfSound));
+		CHECK(almostEqualFracEpsilon(295.070, speedOfSound, 0.001));
+	}
+}
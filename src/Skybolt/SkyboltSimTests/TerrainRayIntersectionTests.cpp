@@ -0,0 +1,121 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TestHelpers.h"
+#include <catch2/catch.hpp>
+#include <SkyboltSim/Spatial/Geocentric.h>
+#include <SkyboltSim/Spatial/GreatCircle.h>
+#include <SkyboltSim/Spatial/TerrainRayIntersection.h>
+
+#include <atomic>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+//! Flat terrain with a rectangular plateau
+class PlateauAltitudeProvider : public PlanetAltitudeProvider
+{
+public:
+	PlateauAltitudeProvider(bool provideBounds) : mProvideBounds(provideBounds) {}
+
+	AltitudeResult getAltitude(const LatLon& position) const override
+	{
+		++altitudeQueryCount;
+		return AltitudeResult::finalValue(isInPlateau(position.lat, position.lon, position.lat, position.lon) ? plateauAltitude : baseAltitude);
+	}
+
+	std::optional<AltitudeBounds> getAltitudeBounds(const LatLon& minimum, const LatLon& maximum) const override
+	{
+		if (!mProvideBounds)
+		{
+			return std::nullopt;
+		}
+		if (isInPlateau(minimum.lat, minimum.lon, maximum.lat, maximum.lon))
+		{
+			return AltitudeBounds{ baseAltitude, plateauAltitude };
+		}
+		return AltitudeBounds{ baseAltitude, baseAltitude };
+	}
+
+	static constexpr double baseAltitude = 0;
+	static constexpr double plateauAltitude = 100;
+	static constexpr double plateauMinLon = 0.001;
+	static constexpr double plateauMaxLon = 0.0015;
+	static constexpr double plateauHalfLatExtent = 0.001;
+
+	mutable std::atomic<int> altitudeQueryCount = 0;
+
+private:
+	//! @returns true if the rectangle overlaps the plateau
+	static bool isInPlateau(double minLat, double minLon, double maxLat, double maxLon)
+	{
+		return maxLon >= plateauMinLon && minLon <= plateauMaxLon && maxLat >= -plateauHalfLatExtent && minLat <= plateauHalfLatExtent;
+	}
+
+	const bool mProvideBounds;
+};
+
+static const double radius = earthRadius();
+
+TEST_CASE("Vertical ray intersects flat terrain")
+{
+	PlateauAltitudeProvider provider(true);
+	Vector3 start = llaToGeocentric(LatLonAlt(0.5, 0.5, 1000), radius);
+	Vector3 end = llaToGeocentric(LatLonAlt(0.5, 0.5, -1000), radius);
+
+	std::optional<TerrainRayIntersection> result = intersectTerrain(provider, radius, start, end);
+	REQUIRE(result);
+	CHECK(result->distance == Approx(1000).margin(0.1));
+	CHECK(almostEqual(result->normal, glm::normalize(start), 1e-6));
+}
+
+TEST_CASE("Ray above terrain does not intersect")
+{
+	for (bool provideBounds : {false, true})
+	{
+		PlateauAltitudeProvider provider(provideBounds);
+		Vector3 start = llaToGeocentric(LatLonAlt(0, 0, 200), radius);
+		Vector3 end = llaToGeocentric(LatLonAlt(0, 0.002, 200), radius);
+		CHECK(!intersectTerrain(provider, radius, start, end));
+	}
+}
+
+TEST_CASE("Ray starting below terrain intersects at start")
+{
+	PlateauAltitudeProvider provider(true);
+	Vector3 start = llaToGeocentric(LatLonAlt(0, 0, -10), radius);
+	Vector3 end = llaToGeocentric(LatLonAlt(0, 0.002, 200), radius);
+
+	std::optional<TerrainRayIntersection> result = intersectTerrain(provider, radius, start, end);
+	REQUIRE(result);
+	CHECK(result->distance == 0.0);
+}
+
+TEST_CASE("Altitude bounds reduce terrain samples without changing intersection")
+{
+	Vector3 start = llaToGeocentric(LatLonAlt(0, 0, 50), radius);
+	Vector3 end = llaToGeocentric(LatLonAlt(0, 0.002, 50), radius);
+
+	TerrainRayIntersectionConfig config;
+	config.minStepLength = 10;
+	config.refinementTolerance = 0.1;
+
+	PlateauAltitudeProvider unboundedProvider(false);
+	std::optional<TerrainRayIntersection> unboundedResult = intersectTerrain(unboundedProvider, radius, start, end, config);
+
+	PlateauAltitudeProvider boundedProvider(true);
+	std::optional<TerrainRayIntersection> boundedResult = intersectTerrain(boundedProvider, radius, start, end, config);
+
+	REQUIRE(unboundedResult);
+	REQUIRE(boundedResult);
+	CHECK(boundedResult->distance == Approx(unboundedResult->distance).margin(config.refinementTolerance));
+
+	// Intersection is at the edge of the plateau
+	double hitLon = geocentricToLatLon(boundedResult->position).lon;
+	CHECK(hitLon == Approx(PlateauAltitudeProvider::plateauMinLon).margin(1e-5));
+
+	CHECK(boundedProvider.altitudeQueryCount * 4 < unboundedProvider.altitudeQueryCount);
+}
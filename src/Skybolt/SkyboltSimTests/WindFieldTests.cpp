@@ -0,0 +1,324 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TestHelpers.h"
+#include <SkyboltSim/Components/FuselageComponent.h>
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/Components/SimpleDynamicBodyComponent.h>
+#include <SkyboltSim/Components/WindComponent.h>
+#include <SkyboltSim/Physics/WindField.h>
+#include <SkyboltSim/Spatial/Geocentric.h>
+#include <SkyboltSim/Spatial/GreatCircle.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+namespace fs = std::filesystem;
+
+constexpr double epsilon = 1e-8;
+
+static Vector3 toGeocentric(double latDeg, double lonDeg, double alt)
+{
+	return llaToGeocentric(LatLonAlt(latDeg * math::degToRadD(), lonDeg * math::degToRadD(), alt), earthRadius());
+}
+
+TEST_CASE("Empty wind field has no wind")
+{
+	WindField field(earthRadius());
+	CHECK(almostEqual(field.sampleNed(toGeocentric(10, 20, 1000)), math::dvec3Zero(), epsilon));
+	CHECK(almostEqual(field.sampleGeocentric(toGeocentric(10, 20, 1000)), math::dvec3Zero(), epsilon));
+}
+
+TEST_CASE("Wind field sums models and converts to geocentric axes")
+{
+	WindField field(earthRadius());
+	auto model1 = std::make_shared<UniformWindModel>(Vector3(1, 2, 0));
+	auto model2 = std::make_shared<UniformWindModel>(Vector3(0, 0, 3));
+	field.addModel(model1);
+	field.addModel(model2);
+
+	Vector3 position = toGeocentric(0, 0, 1000);
+	CHECK(almostEqual(field.sampleNed(position), Vector3(1, 2, 3), epsilon));
+
+	// At zero latitude and longitude, north is +Z, east is +Y and down is -X
+	CHECK(almostEqual(field.sampleGeocentric(position), Vector3(-3, 2, 1), epsilon));
+
+	field.removeModel(model2);
+	CHECK(almostEqual(field.sampleNed(position), Vector3(1, 2, 0), epsilon));
+}
+
+TEST_CASE("Wind component adds models to wind field for its lifetime")
+{
+	WindField field(earthRadius());
+	{
+		WindComponent component(&field, {std::make_shared<UniformWindModel>(Vector3(1, 0, 0))});
+		CHECK(field.getModels().size() == 1);
+	}
+	CHECK(field.getModels().empty());
+}
+
+TEST_CASE("Gust follows 1-cosine profile")
+{
+	GustWindModel::Params params;
+	params.startTime = 10;
+	params.duration = 4;
+	params.peakVelocityNed = Vector3(0, 8, 0);
+	GustWindModel gust(params);
+
+	CHECK(almostEqual(gust.calcVelocityNed(5), math::dvec3Zero(), epsilon));
+	CHECK(almostEqual(gust.calcVelocityNed(11), Vector3(0, 4, 0), epsilon));
+	CHECK(almostEqual(gust.calcVelocityNed(12), Vector3(0, 8, 0), epsilon));
+	CHECK(almostEqual(gust.calcVelocityNed(13), Vector3(0, 4, 0), epsilon));
+	CHECK(almostEqual(gust.calcVelocityNed(15), math::dvec3Zero(), epsilon));
+
+	WindField field(earthRadius());
+	field.addModel(std::make_shared<GustWindModel>(params));
+	field.setTime(12);
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, 0, 0)), Vector3(0, 8, 0), epsilon));
+}
+
+static std::vector<Vector3> createGridPositions(double spacing, int countPerAxis)
+{
+	std::vector<Vector3> positions;
+	Vector3 origin = toGeocentric(45, 10, 500);
+	for (int x = 0; x < countPerAxis; ++x)
+	{
+		for (int y = 0; y < countPerAxis; ++y)
+		{
+			for (int z = 0; z < countPerAxis; ++z)
+			{
+				positions.push_back(origin + Vector3(x, y, z) * spacing);
+			}
+		}
+	}
+	return positions;
+}
+
+TEST_CASE("Turbulence has expected statistics")
+{
+	TurbulenceWindModel::Params params;
+	params.rmsVelocity = 2;
+	params.lengthScale = 300;
+	params.modeCount = 128;
+
+	WindField field(earthRadius());
+	field.addModel(std::make_shared<TurbulenceWindModel>(params));
+
+	std::vector<Vector3> positions = createGridPositions(400, 16);
+	std::vector<Vector3> wind(positions.size());
+	field.sampleNed(positions.data(), positions.size(), wind.data());
+
+	Vector3 mean = math::dvec3Zero();
+	double meanSquare = 0;
+	for (const Vector3& w : wind)
+	{
+		mean += w;
+		meanSquare += glm::dot(w, w);
+	}
+	mean /= double(wind.size());
+	meanSquare /= double(wind.size());
+
+	double rmsPerComponent = std::sqrt(meanSquare / 3.0);
+	CHECK(rmsPerComponent == Approx(params.rmsVelocity).epsilon(0.1));
+	CHECK(glm::length(mean) < 0.15 * params.rmsVelocity);
+}
+
+TEST_CASE("Turbulence is divergence free")
+{
+	TurbulenceWindModel::Params params;
+	params.rmsVelocity = 2;
+	params.lengthScale = 300;
+	params.seed = 3;
+
+	WindField field(earthRadius());
+	field.addModel(std::make_shared<TurbulenceWindModel>(params));
+
+	// Central differences of geocentric velocity, with a step small enough for truncation error to be negligible at the highest wave number
+	const double h = 0.05;
+	for (const Vector3& position : createGridPositions(150, 3))
+	{
+		double divergence = 0;
+		double gradientMagnitude = 0;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			Vector3 offset = math::dvec3Zero();
+			offset[axis] = h;
+			Vector3 derivative = (field.sampleGeocentric(position + offset) - field.sampleGeocentric(position - offset)) / (2.0 * h);
+			divergence += derivative[axis];
+			gradientMagnitude += glm::dot(derivative, derivative);
+		}
+		gradientMagnitude = std::sqrt(gradientMagnitude);
+
+		REQUIRE(gradientMagnitude > 1e-4);
+		CHECK(std::abs(divergence) < 1e-3 * gradientMagnitude);
+	}
+}
+
+TEST_CASE("Turbulence is repeatable and batch sampling matches single sampling")
+{
+	TurbulenceWindModel::Params params;
+	params.seed = 5;
+
+	WindField field(earthRadius());
+	field.addModel(std::make_shared<TurbulenceWindModel>(params));
+	field.setTime(3.5);
+
+	WindField sameSeedField(earthRadius());
+	sameSeedField.addModel(std::make_shared<TurbulenceWindModel>(params));
+	sameSeedField.setTime(3.5);
+
+	params.seed = 6;
+	WindField differentSeedField(earthRadius());
+	differentSeedField.addModel(std::make_shared<TurbulenceWindModel>(params));
+	differentSeedField.setTime(3.5);
+
+	// More points than the batch chunk size, so that several chunks are sampled
+	std::vector<Vector3> positions = createGridPositions(50, 5);
+	std::vector<Vector3> wind(positions.size());
+	field.sampleGeocentric(positions.data(), positions.size(), wind.data());
+
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		CHECK(almostEqual(wind[i], field.sampleGeocentric(positions[i]), epsilon));
+		CHECK(almostEqual(wind[i], sameSeedField.sampleGeocentric(positions[i]), epsilon));
+	}
+	CHECK(!almostEqual(wind[0], differentSeedField.sampleGeocentric(positions[0]), 1e-3));
+}
+
+static fs::path writeWindFile(const std::string& name, const std::string& content)
+{
+	fs::path dir = fs::temp_directory_path() / "SkyboltTests";
+	fs::create_directories(dir);
+	fs::path filename = dir / name;
+
+	std::ofstream f(filename);
+	f << content;
+	return filename;
+}
+
+static fs::path writeWindFile()
+{
+	// 2 latitudes x 1 longitude x 2 altitudes x 2 times, with time varying fastest
+	return writeWindFile("wind.json", R"({
+		"latitudes": [0, 10],
+		"longitudes": [0],
+		"altitudes": [0, 1000],
+		"times": [0, 100],
+		"north": [0, 2, 10, 12, 20, 22, 30, 32],
+		"east": [1, 1, 1, 1, 1, 1, 1, 1]
+	})");
+}
+
+TEST_CASE("Gridded wind interpolates over latitude, altitude and time")
+{
+	WindField field(earthRadius());
+	field.addModel(readGriddedWindModel(writeWindFile()));
+
+	field.setTime(0);
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, 0, 0)), Vector3(0, 1, 0), 1e-6));
+	CHECK(almostEqual(field.sampleNed(toGeocentric(10, 0, 1000)), Vector3(30, 1, 0), 1e-6));
+	CHECK(almostEqual(field.sampleNed(toGeocentric(5, 0, 500)), Vector3(15, 1, 0), 1e-6));
+
+	field.setTime(50);
+	CHECK(almostEqual(field.sampleNed(toGeocentric(5, 0, 500)), Vector3(16, 1, 0), 1e-6));
+
+	// Points outside grid are clamped
+	field.setTime(1000);
+	CHECK(almostEqual(field.sampleNed(toGeocentric(20, 30, 5000)), Vector3(32, 1, 0), 1e-6));
+}
+
+TEST_CASE("Gridded wind wraps longitude for global grids")
+{
+	WindField field(earthRadius());
+	field.addModel(readGriddedWindModel(writeWindFile("globalWind.json", R"({
+		"latitudes": [0],
+		"longitudes": [-180, -90, 0, 90],
+		"altitudes": [0],
+		"times": [0],
+		"north": [0, 0, 0, 0],
+		"east": [0, 10, 20, 30]
+	})")));
+
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, 90, 0)), Vector3(0, 30, 0), 1e-6));
+
+	// Interpolates across the seam between the last longitude and the first longitude plus 360 degrees
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, 135, 0)), Vector3(0, 15, 0), 1e-6));
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, 179.9, 0)), Vector3(0, 30 * 0.1 / 90, 0), 1e-6));
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, -135, 0)), Vector3(0, 5, 0), 1e-6));
+}
+
+TEST_CASE("Gridded wind clamps longitude for regional grids")
+{
+	WindField field(earthRadius());
+	field.addModel(readGriddedWindModel(writeWindFile("regionalWind.json", R"({
+		"latitudes": [0],
+		"longitudes": [0, 90],
+		"altitudes": [0],
+		"times": [0],
+		"north": [0, 0],
+		"east": [0, 30]
+	})")));
+
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, 135, 0)), Vector3(0, 30, 0), 1e-6));
+	CHECK(almostEqual(field.sampleNed(toGeocentric(0, -135, 0)), Vector3(0, 0, 0), 1e-6));
+}
+
+TEST_CASE("Reading missing wind file throws")
+{
+	CHECK_THROWS_AS(readGriddedWindModel("missingFile.json"), std::runtime_error);
+}
+
+namespace {
+
+class RecordingBody : public SimpleDynamicBodyComponent
+{
+public:
+	using SimpleDynamicBodyComponent::SimpleDynamicBodyComponent;
+
+	void applyCentralForce(const Vector3& f) override { force += f; }
+
+	Vector3 force = math::dvec3Zero();
+};
+
+} // namespace
+
+TEST_CASE("Fuselage aerodynamics use velocity relative to wind")
+{
+	// Flying north at zero latitude and longitude, where north is +Z
+	Node node(toGeocentric(0, 0, 1000));
+	Motion motion;
+	motion.linearVelocity = Vector3(0, 0, 50);
+	RecordingBody body(&node, &motion, 1000, Vector3(1, 1, 1));
+
+	WindField field(earthRadius());
+
+	FuselageComponentConfig config;
+	config.params = FuselageParams{};
+	config.params.dragConst = Vector3(1, 1, 1);
+	config.params.momentMultiplier = 1;
+	config.params.maxAutoTrimAngleOfAttack = std::nullopt;
+	config.node = &node;
+	config.motion = &motion;
+	config.body = &body;
+	config.windField = &field;
+
+	FuselageComponent fuselage(config);
+
+	fuselage.updatePreDynamicsSubstep();
+	CHECK(body.force.z < 0);
+
+	// Tail wind matching ground speed gives zero airspeed
+	body.force = math::dvec3Zero();
+	field.addModel(std::make_shared<UniformWindModel>(Vector3(50, 0, 0)));
+	fuselage.updatePreDynamicsSubstep();
+	CHECK(almostEqual(body.force, math::dvec3Zero(), 1e-6));
+}
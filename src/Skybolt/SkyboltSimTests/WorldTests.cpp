@@ -0,0 +1,105 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/NameComponent.h>
+#include <catch2/catch.hpp>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+static EntityPtr createNamedEntity(std::uint32_t id, const std::string& name)
+{
+	auto entity = std::make_shared<Entity>(EntityId({1, id}));
+	entity->addComponent(std::make_shared<NameComponent>(name));
+	return entity;
+}
+
+namespace {
+
+struct RecordingWorldListener : WorldListener
+{
+	RecordingWorldListener(const World& world) : world(world) {}
+
+	void entityAdded(const EntityPtr& entity) override
+	{
+		++entityAddedCount;
+	}
+
+	void entitiesAdded(const std::vector<EntityPtr>& entities) override
+	{
+		++entitiesAddedCount;
+		addedEntities = entities;
+		worldEntityCountOnNotification = world.getEntities().size();
+	}
+
+	const World& world;
+	int entityAddedCount = 0;
+	int entitiesAddedCount = 0;
+	std::vector<EntityPtr> addedEntities;
+	size_t worldEntityCountOnNotification = 0;
+};
+
+struct DefaultWorldListener : WorldListener
+{
+	void entityAdded(const EntityPtr& entity) override
+	{
+		addedEntities.push_back(entity);
+	}
+
+	std::vector<EntityPtr> addedEntities;
+};
+
+} // namespace
+
+TEST_CASE("World adds batch of entities in a single transaction")
+{
+	World world;
+	world.addEntity(createNamedEntity(1, "existing"));
+
+	RecordingWorldListener listener(world);
+	world.addListener(&listener);
+
+	std::vector<EntityPtr> entities = {
+		createNamedEntity(2, "a"),
+		createNamedEntity(3, "b"),
+		createNamedEntity(4, "")
+	};
+	world.addEntities(entities);
+
+	// Listener is notified once, after all entities are in the world
+	CHECK(listener.entitiesAddedCount == 1);
+	CHECK(listener.entityAddedCount == 0);
+	CHECK(listener.addedEntities == entities);
+	CHECK(listener.worldEntityCountOnNotification == 4);
+
+	// Entities are indexed and appended in order
+	REQUIRE(world.getEntities().size() == 4);
+	CHECK(world.getEntities()[1] == entities[0]);
+	CHECK(world.getEntities()[3] == entities[2]);
+	CHECK(world.findObjectByName("a") == entities[0]);
+	CHECK(world.findObjectByName("b") == entities[1]);
+	CHECK(world.getEntityById(EntityId({1, 4})) == entities[2]);
+
+	// Empty batches do not notify listeners
+	world.addEntities({});
+	CHECK(listener.entitiesAddedCount == 1);
+
+	world.removeListener(&listener);
+}
+
+TEST_CASE("World listeners without batch support are notified of each entity in batch")
+{
+	World world;
+	DefaultWorldListener listener;
+	world.addListener(&listener);
+
+	std::vector<EntityPtr> entities = { createNamedEntity(1, "a"), createNamedEntity(2, "b") };
+	world.addEntities(entities);
+	CHECK(listener.addedEntities == entities);
+
+	world.removeListener(&listener);
+}
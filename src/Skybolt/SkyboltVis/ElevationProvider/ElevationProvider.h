@@ -6,6 +6,10 @@
 
 #pragma once
 
+#include <osg/Vec2f>
+#include <assert.h>
+#include <span>
+
 namespace skybolt {
 namespace vis {
 
@@ -14,6 +18,17 @@ class ElevationProvider
 public:
 	virtual ~ElevationProvider() {}
 	virtual float get(float x, float y) const = 0; //!< Returns Z coordinate of terrain at X,Y point. -ve is up.
+
+	//! Batched version of get() for many points.
+	//! @param results must be the same size as positions
+	virtual void getElevations(std::span<const osg::Vec2f> positions, std::span<float> results) const
+	{
+		assert(positions.size() == results.size());
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			results[i] = get(positions[i].x(), positions[i].y());
+		}
+	}
 };
 
 } // namespace vis
@@ -19,36 +19,71 @@ HeightMapElevationProvider::HeightMapElevationProvider(const osg::ref_ptr<osg::I
 		image->t() / (bounds.maximum.x() - bounds.minimum.x()));
 }
 
-float HeightMapElevationProvider::get(float x, float y) const
+//! Bilinearly samples a 16 bit height map and returns the elevation
+class HeightMapSampler
 {
-	osg::Vec3f uv = osg::Vec3f((y - mHorizontalOffset.x()) * mHorizontalScale.x(),
-		(x - mHorizontalOffset.y()) * mHorizontalScale.y(), 0.0f);
+public:
+	HeightMapSampler(const osg::Image& image, const HeightMapElevationRerange& elevationRerange, const osg::Vec2f& horizontalOffset, const osg::Vec2f& horizontalScale) :
+		mData((const uint16_t*)image.getDataPointer()),
+		mWidth(image.s()),
+		mSMax(image.s() - 1),
+		mTMax(image.t() - 1),
+		mElevationRerange(elevationRerange),
+		mHorizontalOffset(horizontalOffset),
+		mHorizontalScale(horizontalScale)
+	{
+	}
+
+	float get(float x, float y) const
+	{
+		osg::Vec2f uv((y - mHorizontalOffset.x()) * mHorizontalScale.x(),
+			(x - mHorizontalOffset.y()) * mHorizontalScale.y());
 
-	int sMax = mImage->s() - 1;
-	int tMax = mImage->t() - 1;
+		uv.x() = skybolt::math::clamp(uv.x(), 0.0f, float(mSMax));
+		uv.y() = skybolt::math::clamp(uv.y(), 0.0f, float(mTMax));
 
-	uv.x() = skybolt::math::clamp(uv.x(), 0.0f, float(sMax));
-	uv.y() = skybolt::math::clamp(uv.y(), 0.0f, float(tMax));
+		int u0 = (int)uv.x();
+		int u1 = std::min(u0 + 1, mSMax);
+		int v0 = (int)uv.y();
+		int v1 = std::min(v0 + 1, mTMax);
 
-	int u0 = (int)uv.x();
-	int u1 = std::min(u0 + 1, sMax);
-	int v0 = (int)uv.y();
-	int v1 = std::min(v0 + 1, tMax);
+		float fracU = uv.x() - u0;
+		float fracV = uv.y() - v0;
 
-	float fracU = uv.x() - u0;
-	float fracV = uv.y() - v0;
+		float d00 = float(mData[u0 + mWidth * v0]);
+		float d10 = float(mData[u1 + mWidth * v0]);
+		float d01 = float(mData[u0 + mWidth * v1]);
+		float d11 = float(mData[u1 + mWidth * v1]);
 
-	const uint16_t* ptr = (const uint16_t*)mImage->getDataPointer();
+		float d0 = skybolt::math::lerp(d00, d10, fracU);
+		float d1 = skybolt::math::lerp(d01, d11, fracU);
 
-	float d00 = float(ptr[u0 + mImage->s() * v0]);
-	float d10 = float(ptr[u1 + mImage->s() * v0]);
-	float d01 = float(ptr[u0 + mImage->s() * v1]);
-	float d11 = float(ptr[u1 + mImage->s() * v1]);
+		return getElevationForColorValue(mElevationRerange, skybolt::math::lerp(d0, d1, fracV));
+	}
 
-	float d0 = skybolt::math::lerp(d00, d10, fracU);
-	float d1 = skybolt::math::lerp(d01, d11, fracU);
+private:
+	const uint16_t* mData;
+	const int mWidth;
+	const int mSMax;
+	const int mTMax;
+	const HeightMapElevationRerange& mElevationRerange;
+	const osg::Vec2f mHorizontalOffset;
+	const osg::Vec2f mHorizontalScale;
+};
 
-	return getElevationForColorValue(mElevationRerange, skybolt::math::lerp(d0, d1, fracV));
+float HeightMapElevationProvider::get(float x, float y) const
+{
+	return HeightMapSampler(*mImage, mElevationRerange, mHorizontalOffset, mHorizontalScale).get(x, y);
+}
+
+void HeightMapElevationProvider::getElevations(std::span<const osg::Vec2f> positions, std::span<float> results) const
+{
+	assert(positions.size() == results.size());
+	HeightMapSampler sampler(*mImage, mElevationRerange, mHorizontalOffset, mHorizontalScale);
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		results[i] = sampler.get(positions[i].x(), positions[i].y());
+	}
 }
 
 } // namespace vis
@@ -21,7 +21,9 @@ public:
 
 	//! @param x is latitude in radians
 	//! @param y is longitude in radians
-	float get(float x, float y) const;
+	float get(float x, float y) const override;
+
+	void getElevations(std::span<const osg::Vec2f> positions, std::span<float> results) const override;
 
 private:
 	osg::ref_ptr<const osg::Image> mImage;
@@ -11,6 +11,8 @@
 #include "SkyboltVis/GeoImageHelpers.h"
 #include <SkyboltSim/Spatial/GreatCircle.h>
 
+#include <algorithm>
+
 namespace skybolt {
 namespace vis {
 
@@ -19,26 +21,193 @@ static vis::Box2f toBox2f(const BlockingTilePlanetAltitudeProvider::LatLonBounds
 	return vis::Box2f(osg::Vec2f(b.minimum.x(), b.minimum.y()), osg::Vec2f(b.maximum.x(), b.maximum.y()));
 }
 
+static double getKeySize(const QuadTreeTileKey& key)
+{
+	return math::piD() / double(1 << key.level);
+}
+
+//! @returns lat/lon of the south-west corner of a key
+static sim::LatLon getKeyMinimum(const QuadTreeTileKey& key)
+{
+	double size = getKeySize(key);
+	return sim::LatLon(math::halfPiD() - double(key.y + 1) * size, -math::piD() + double(key.x) * size);
+}
+
+//! @returns bounds of the elevations in an image within a lat/lon rectangle. Parts of the rectangle outside the image are ignored.
+static HeightMapElevationBounds getImageElevationBoundsWithinRegion(const HeightMapElevationBoundsPyramid& pyramid, const QuadTreeTileKey& imageKey, const sim::LatLon& minimum, const sim::LatLon& maximum)
+{
+	// Image columns increase eastwards and rows increase northwards
+	sim::LatLon imageMinimum = getKeyMinimum(imageKey);
+	double texelsPerRadianS = double(pyramid.getWidth()) / getKeySize(imageKey);
+	double texelsPerRadianT = double(pyramid.getHeight()) / getKeySize(imageKey);
+	return pyramid.getBounds(
+		osg::Vec2f((minimum.lon - imageMinimum.lon) * texelsPerRadianS, (minimum.lat - imageMinimum.lat) * texelsPerRadianT),
+		osg::Vec2f((maximum.lon - imageMinimum.lon) * texelsPerRadianS, (maximum.lat - imageMinimum.lat) * texelsPerRadianT));
+}
+
+//! @returns bounds of the elevations within a key in an image, where the key is the image's key or a descendant of it
+static HeightMapElevationBounds getImageElevationBoundsWithinKey(const HeightMapElevationBoundsPyramid& pyramid, const QuadTreeTileKey& imageKey, const QuadTreeTileKey& key)
+{
+	if (key == imageKey)
+	{
+		return pyramid.getBounds();
+	}
+
+	sim::LatLon minimum = getKeyMinimum(key);
+	double size = getKeySize(key);
+	return getImageElevationBoundsWithinRegion(pyramid, imageKey, minimum, sim::LatLon(minimum.lat + size, minimum.lon + size));
+}
+
+static sim::PlanetAltitudeProvider::AltitudeBounds toAltitudeBounds(const HeightMapElevationBounds& bounds)
+{
+	return { bounds.x(), bounds.y() };
+}
+
+static constexpr size_t tileImageCacheCapacity = 1024;
+
+BlockingTilePlanetAltitudeProvider::TileImageCacheShard::TileImageCacheShard() :
+	cache(tileImageCacheCapacity / tileImageCacheShardCount)
+{
+}
+
 BlockingTilePlanetAltitudeProvider::BlockingTilePlanetAltitudeProvider(const TileSourcePtr& tileSource, int maxLod) :
 	mTileSource(tileSource),
-	mMaxLod(maxLod),
-	mTileImageCache(1024)
+	mMaxLod(maxLod)
 {
 	assert(mTileSource);
 }
 
 BlockingTilePlanetAltitudeProvider::AltitudeResult BlockingTilePlanetAltitudeProvider::getAltitude(const sim::LatLon& position) const
 {
-	std::optional<TileImage> tile;
 	QuadTreeTileKey highestLodKey = getKeyAtLevelIntersectingLonLatPoint(mMaxLod, LatLonVec2Adapter(position));
+	std::optional<TileImage> tile = findOrLoadTile(highestLodKey);
+	if (!tile)
+	{
+		return AltitudeResult::provisionalValue(0.0);
+	}
+
+	return AltitudeResult::finalValue(tile->elevationProvider->get(position.lat, position.lon));
+}
+
+void BlockingTilePlanetAltitudeProvider::getAltitudes(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results) const
+{
+	getAltitudesGroupedByTile(positions, results, [this] (const QuadTreeTileKey& highestLodKey) {
+		return findOrLoadTile(highestLodKey);
+	}, /* provisionalBelowMaxLod */ false);
+}
+
+void BlockingTilePlanetAltitudeProvider::getAltitudesGroupedByTile(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results, const TileFinder& tileFinder, bool provisionalBelowMaxLod) const
+{
+	assert(positions.size() == results.size());
+
+	// Sort positions by key so that positions in the same tile are adjacent
+	std::vector<std::pair<QuadTreeTileKey, size_t>> keyIndices(positions.size());
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		keyIndices[i] = { getKeyAtLevelIntersectingLonLatPoint(mMaxLod, LatLonVec2Adapter(positions[i])), i };
+	}
+	std::sort(keyIndices.begin(), keyIndices.end(), [] (const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	std::vector<osg::Vec2f> tilePositions;
+	std::vector<float> tileElevations;
+
+	for (size_t begin = 0; begin < keyIndices.size();)
+	{
+		const QuadTreeTileKey& key = keyIndices[begin].first;
+		size_t end = begin + 1;
+		while (end < keyIndices.size() && keyIndices[end].first == key)
+		{
+			++end;
+		}
 
-	tile = findTile(highestLodKey);
+		std::optional<TileImage> tile = tileFinder(key);
+		if (!tile)
+		{
+			for (size_t i = begin; i < end; ++i)
+			{
+				results[keyIndices[i].second] = AltitudeResult::provisionalValue(0.0);
+			}
+		}
+		else
+		{
+			size_t count = end - begin;
+			tilePositions.resize(count);
+			tileElevations.resize(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				const sim::LatLon& position = positions[keyIndices[begin + i].second];
+				tilePositions[i] = osg::Vec2f(position.lat, position.lon);
+			}
+
+			tile->elevationProvider->getElevations(tilePositions, tileElevations);
+
+			bool provisional = provisionalBelowMaxLod && tile->key.level < mMaxLod;
+			for (size_t i = 0; i < count; ++i)
+			{
+				AltitudeResult& result = results[keyIndices[begin + i].second];
+				result.altitude = tileElevations[i];
+				result.provisional = provisional;
+			}
+		}
+		begin = end;
+	}
+}
+
+std::optional<BlockingTilePlanetAltitudeProvider::AltitudeBounds> BlockingTilePlanetAltitudeProvider::getAltitudeBounds(const sim::LatLon& minimum, const sim::LatLon& maximum) const
+{
+	std::vector<QuadTreeTileKey> keys = getKeysOverlappingRegion(minimum, maximum);
+	if (keys.empty())
+	{
+		return std::nullopt;
+	}
+
+	HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
+	for (const QuadTreeTileKey& key : keys)
+	{
+		if (key.level == mMaxLod)
+		{
+			// All altitudes within the key come from the same tile
+			std::optional<TileImage> tile = findOrLoadTile(key);
+			if (!tile)
+			{
+				// No tile covers the key, so getAltitude() returns zero
+				expand(bounds, 0.0f);
+			}
+			else if (tile->elevationBounds)
+			{
+				expand(bounds, getImageElevationBoundsWithinRegion(*tile->elevationBounds, tile->key, minimum, maximum));
+			}
+			else
+			{
+				return std::nullopt;
+			}
+		}
+		else
+		{
+			// Every key at maxLod within the key must have been loaded, otherwise loading the remaining keys could expand the bounds
+			std::optional<ElevationBoundsNode> node = findElevationBoundsNode(key);
+			int levelDelta = mMaxLod - key.level;
+			if (!node || levelDelta >= 32 || node->maxLodKeyCount < (uint64_t(1) << (2 * levelDelta)))
+			{
+				return std::nullopt;
+			}
+			expand(bounds, node->bounds);
+		}
+	}
+	return toAltitudeBounds(bounds);
+}
+
+std::optional<BlockingTilePlanetAltitudeProvider::TileImage> BlockingTilePlanetAltitudeProvider::findOrLoadTile(const QuadTreeTileKey& highestLodKey) const
+{
+	std::optional<TileImage> tile = findTile(highestLodKey);
 	if (!tile)
 	{
 		// Load tile at highest available LOD level
 		for (int lod = mMaxLod; lod >= 0; lod--)
 		{
-			QuadTreeTileKey key = key = createAncestorKey(highestLodKey, lod);
+			QuadTreeTileKey key = createAncestorKey(highestLodKey, lod);
 			tile = loadTile(key);
 			if (tile)
 			{
@@ -48,22 +217,66 @@ BlockingTilePlanetAltitudeProvider::AltitudeResult BlockingTilePlanetAltitudePro
 			}
 		}
 	}
+	return tile;
+}
 
-	if (!tile)
+std::vector<QuadTreeTileKey> BlockingTilePlanetAltitudeProvider::getKeysOverlappingRegion(const sim::LatLon& minimum, const sim::LatLon& maximum) const
+{
+	double size = std::max(maximum.lat - minimum.lat, maximum.lon - minimum.lon);
+	if (size < 0)
 	{
-		return AltitudeResult::provisionalValue(0.0);
+		return {};
+	}
+
+	int level = 0;
+	while (level < mMaxLod && math::piD() / double(1 << (level + 1)) >= size)
+	{
+		++level;
 	}
 
-	HeightMapElevationRerange rerange = getRequiredHeightMapElevationRerange(*tile->image);
-	vis::HeightMapElevationProvider provider(tile->image, rerange, toBox2f(getKeyLatLonBounds<LatLonVec2Adapter>(tile->key)));
-	return AltitudeResult::finalValue(provider.get(position.lat, position.lon));
+	// Keys at minimum x and y are in the north-west corner
+	QuadTreeTileKey northWest = getKeyAtLevelIntersectingLonLatPoint(level, LatLonVec2Adapter(sim::LatLon(maximum.lat, minimum.lon)));
+	QuadTreeTileKey southEast = getKeyAtLevelIntersectingLonLatPoint(level, LatLonVec2Adapter(sim::LatLon(minimum.lat, maximum.lon)));
+
+	int xMax = (2 << level) - 1;
+	int yMax = (1 << level) - 1;
+
+	std::vector<QuadTreeTileKey> keys;
+	for (int y = std::clamp(northWest.y, 0, yMax); y <= std::clamp(southEast.y, 0, yMax); ++y)
+	{
+		for (int x = std::clamp(northWest.x, 0, xMax); x <= std::clamp(southEast.x, 0, xMax); ++x)
+		{
+			QuadTreeTileKey key;
+			key.level = level;
+			key.x = x;
+			key.y = y;
+			keys.push_back(key);
+		}
+	}
+	return keys;
+}
+
+std::optional<BlockingTilePlanetAltitudeProvider::ElevationBoundsNode> BlockingTilePlanetAltitudeProvider::findElevationBoundsNode(const QuadTreeTileKey& key) const
+{
+	std::shared_lock<std::shared_mutex> lock(mElevationBoundsTreeMutex);
+	if (auto i = mElevationBoundsTree.find(key); i != mElevationBoundsTree.end())
+	{
+		return i->second;
+	}
+	return std::nullopt;
+}
+
+BlockingTilePlanetAltitudeProvider::TileImageCacheShard& BlockingTilePlanetAltitudeProvider::getTileImageCacheShard(const QuadTreeTileKey& key) const
+{
+	return mTileImageCacheShards[std::hash<QuadTreeTileKey>()(key) % tileImageCacheShardCount];
 }
 
 std::optional<BlockingTilePlanetAltitudeProvider::TileImage> BlockingTilePlanetAltitudeProvider::findTile(const QuadTreeTileKey& key) const
 {
+	TileImageCacheShard& shard = getTileImageCacheShard(key);
 	TileImage result;
-	std::scoped_lock<std::mutex> lock(mTileImageCacheMutex);
-	if (mTileImageCache.get(key, result))
+	std::scoped_lock<std::mutex> lock(shard.mutex);
+	if (shard.cache.get(key, result))
 	{
 		return result;
 	}
@@ -80,6 +293,9 @@ std::optional<BlockingTilePlanetAltitudeProvider::TileImage> BlockingTilePlanetA
 		TileImage result;
 		result.image = image;
 		result.key = key;
+		HeightMapElevationRerange rerange = getRequiredHeightMapElevationRerange(*image);
+		result.elevationBounds = std::make_shared<HeightMapElevationBoundsPyramid>(*image, rerange);
+		result.elevationProvider = std::make_shared<HeightMapElevationProvider>(image, rerange, toBox2f(getKeyLatLonBounds<LatLonVec2Adapter>(key)));
 		return result;
 	}
 	return std::nullopt;
@@ -88,61 +304,161 @@ std::optional<BlockingTilePlanetAltitudeProvider::TileImage> BlockingTilePlanetA
 
 void BlockingTilePlanetAltitudeProvider::addTileToCache(const TileImage& image, const QuadTreeTileKey& key) const
 {
-	std::scoped_lock<std::mutex> lock(mTileImageCacheMutex);
-	mTileImageCache.putSafe(key, image);
+	{
+		TileImageCacheShard& shard = getTileImageCacheShard(key);
+		std::scoped_lock<std::mutex> lock(shard.mutex);
+		shard.cache.putSafe(key, image);
+	}
+
+	if (!image.elevationBounds)
+	{
+		return;
+	}
+
+	HeightMapElevationBounds bounds = getImageElevationBoundsWithinKey(*image.elevationBounds, image.key, key);
+
+	std::unique_lock<std::shared_mutex> lock(mElevationBoundsTreeMutex);
+	ElevationBoundsNode& imageNode = mElevationBoundsTree[image.key];
+	imageNode.image = image.elevationBounds;
+	imageNode.hasImage = true;
+
+	bool newMaxLodKey = (key.level == mMaxLod) && (mElevationBoundsTree[key].maxLodKeyCount == 0);
+	for (int level = key.level; level >= 0; --level)
+	{
+		ElevationBoundsNode& node = mElevationBoundsTree[createAncestorKey(key, level)];
+		expand(node.bounds, bounds);
+		if (newMaxLodKey)
+		{
+			++node.maxLodKeyCount;
+		}
+	}
 }
 
-NonBlockingTilePlanetAltitudeProvider::NonBlockingTilePlanetAltitudeProvider(px_sched::Scheduler* scheduler, const TileSourcePtr& tileSource, int maxLod) :
+NonBlockingTilePlanetAltitudeProvider::NonBlockingTilePlanetAltitudeProvider(px_sched::Scheduler* scheduler, const TileSourcePtr& tileSource, int maxLod, int maxConcurrentLoads) :
 	BlockingTilePlanetAltitudeProvider(tileSource, maxLod),
-	mScheduler(scheduler)
+	mScheduler(scheduler),
+	mMaxConcurrentLoads(std::max(1, maxConcurrentLoads))
 {
 	assert(mScheduler);
 	assert(mTileSource);
 }
 
+NonBlockingTilePlanetAltitudeProvider::~NonBlockingTilePlanetAltitudeProvider()
+{
+	mScheduler->waitFor(mLoadingTaskSync);
+}
+
 BlockingTilePlanetAltitudeProvider::AltitudeResult NonBlockingTilePlanetAltitudeProvider::getAltitude(const sim::LatLon& position) const
 {
-	std::optional<TileImage> highestLodTile;
-	for (int lod = 0; lod <= mMaxLod; lod++)
+	QuadTreeTileKey highestLodKey = getKeyAtLevelIntersectingLonLatPoint(mMaxLod, LatLonVec2Adapter(position));
+	std::optional<TileImage> tile = findHighestLoadedTile(highestLodKey);
+	if (!tile)
 	{
-		QuadTreeTileKey key = getKeyAtLevelIntersectingLonLatPoint(lod, LatLonVec2Adapter(position));
-		std::optional<TileImage> tile = findTile(key);
-		if (tile)
-		{
-			highestLodTile = tile;
-		}
-		else
+		return AltitudeResult::provisionalValue(0.0);
+	}
+
+	AltitudeResult result;
+	result.altitude = tile->elevationProvider->get(position.lat, position.lon);
+	result.provisional = (tile->key.level < mMaxLod);
+	return result;
+}
+
+void NonBlockingTilePlanetAltitudeProvider::getAltitudes(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results) const
+{
+	getAltitudesGroupedByTile(positions, results, [this] (const QuadTreeTileKey& highestLodKey) {
+		return findHighestLoadedTile(highestLodKey);
+	}, /* provisionalBelowMaxLod */ true);
+}
+
+std::optional<BlockingTilePlanetAltitudeProvider::TileImage> NonBlockingTilePlanetAltitudeProvider::findHighestLoadedTile(const QuadTreeTileKey& highestLodKey) const
+{
+	// Search from the highest LOD down, because once loaded, most queries are answered by the first search
+	for (int lod = mMaxLod; lod >= 0; lod--)
+	{
+		if (std::optional<TileImage> tile = findTile(createAncestorKey(highestLodKey, lod)); tile)
 		{
-			requestLoadTileAndAddToCache(key);
-			break;
+			if (lod < mMaxLod)
+			{
+				requestLoadTileAndAddToCache(createAncestorKey(highestLodKey, lod + 1));
+			}
+			return tile;
 		}
 	}
 
-	if (!highestLodTile)
+	requestLoadTileAndAddToCache(createAncestorKey(highestLodKey, 0));
+	return std::nullopt;
+}
+
+std::optional<BlockingTilePlanetAltitudeProvider::AltitudeBounds> NonBlockingTilePlanetAltitudeProvider::getAltitudeBounds(const sim::LatLon& minimum, const sim::LatLon& maximum) const
+{
+	std::vector<QuadTreeTileKey> keys = getKeysOverlappingRegion(minimum, maximum);
+	if (keys.empty())
 	{
-		return AltitudeResult::provisionalValue(0.0);
+		return std::nullopt;
 	}
 
-	HeightMapElevationRerange rerange = getRequiredHeightMapElevationRerange(*highestLodTile->image);
-	vis::HeightMapElevationProvider provider(highestLodTile->image, rerange, toBox2f(getKeyLatLonBounds<LatLonVec2Adapter>(highestLodTile->key)));
+	HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
+	std::shared_lock<std::shared_mutex> lock(mElevationBoundsTreeMutex);
+	for (const QuadTreeTileKey& key : keys)
+	{
+		// Altitudes within the key come from the loaded tile at the highest LOD, which may be the key's tile,
+		// a descendant, or an ancestor. If none are loaded, getAltitude() returns zero.
+		bool loaded = false;
+		for (int level = key.level; level >= 0; --level)
+		{
+			QuadTreeTileKey ancestorKey = createAncestorKey(key, level);
+			auto i = mElevationBoundsTree.find(ancestorKey);
+			if (i == mElevationBoundsTree.end())
+			{
+				continue;
+			}
 
-	AltitudeResult result;
-	result.altitude = provider.get(position.lat, position.lon);
-	result.provisional = (highestLodTile->key.level < mMaxLod);
-	return result;
+			const ElevationBoundsNode& node = i->second;
+			if (level == key.level)
+			{
+				expand(bounds, node.bounds);
+				loaded |= !node.image.expired();
+			}
+			else if (auto pyramid = node.image.lock(); pyramid)
+			{
+				expand(bounds, getImageElevationBoundsWithinKey(*pyramid, ancestorKey, key));
+				loaded = true;
+			}
+			else if (node.hasImage)
+			{
+				// Image has been evicted and may be reloaded. Use the node bounds, which contain the image bounds.
+				expand(bounds, node.bounds);
+			}
+		}
+
+		if (!loaded)
+		{
+			expand(bounds, 0.0f);
+		}
+	}
+	return toAltitudeBounds(bounds);
 }
 
 void NonBlockingTilePlanetAltitudeProvider::requestLoadTileAndAddToCache(const QuadTreeTileKey& key) const
 {
-	if (mScheduler->hasFinished(mLoadingTaskSync))
 	{
-		mScheduler->run([=]() {
-			if (std::optional<TileImage> image = loadTile(key); image)
-			{
-				addTileToCache(*image, key);
-			}
-		}, &mLoadingTaskSync);
+		// Load different tiles in parallel, but never load the same tile more than once at a time
+		std::scoped_lock<std::mutex> lock(mLoadingKeysMutex);
+		if (mLoadingKeys.size() >= mMaxConcurrentLoads || !mLoadingKeys.insert(key).second)
+		{
+			return;
+		}
 	}
+
+	mScheduler->run([=]() {
+		if (std::optional<TileImage> image = loadTile(key); image)
+		{
+			addTileToCache(*image, key);
+		}
+
+		std::scoped_lock<std::mutex> lock(mLoadingKeysMutex);
+		mLoadingKeys.erase(key);
+	}, &mLoadingTaskSync);
 }
 
 } // namespace vis
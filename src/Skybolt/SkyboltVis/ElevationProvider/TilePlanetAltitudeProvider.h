@@ -7,6 +7,7 @@
 #pragma once
 
 #include "SkyboltVis/SkyboltVisFwd.h"
+#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h"
 #include <SkyboltSim/PlanetAltitudeProvider.h>
 #include <SkyboltCommon/LruCacheMap.h>
 #include <SkyboltCommon/LruCacheSet.h>
@@ -14,7 +15,15 @@
 
 #include <osg/Image>
 #include <px_sched/px_sched.h>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace skybolt {
 namespace vis {
@@ -82,6 +91,15 @@ public:
 	//! @ThreadSafe
 	AltitudeResult getAltitude(const sim::LatLon& position) const override;
 
+	//! Positions are grouped by tile so that each tile is found or loaded once per batch
+	//! @ThreadSafe
+	void getAltitudes(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results) const override;
+
+	//! Bounds of regions no larger than a tile at maxLod are found by loading the tiles in the region.
+	//! Bounds of larger regions are only known once all tiles at maxLod within the region have been loaded.
+	//! @ThreadSafe
+	std::optional<AltitudeBounds> getAltitudeBounds(const sim::LatLon& minimum, const sim::LatLon& maximum) const override;
+
 	typedef skybolt::Box2T<LatLonVec2Adapter> LatLonBounds;
 
 protected:
@@ -89,37 +107,96 @@ protected:
 	{
 		QuadTreeTileKey key;
 		osg::ref_ptr<osg::Image> image;
+		std::shared_ptr<const HeightMapElevationBoundsPyramid> elevationBounds;
+		std::shared_ptr<const HeightMapElevationProvider> elevationProvider; //!< Samples the image, with image rerange and bounds precomputed
 	};
 
 	std::optional<TileImage> findTile(const QuadTreeTileKey& key) const;
 
 	std::optional<TileImage> loadTile(const QuadTreeTileKey& key) const;
 
+	//! @returns tile at highest available LOD containing the given key at maxLod, loading the tile if it is not in the cache
+	std::optional<TileImage> findOrLoadTile(const QuadTreeTileKey& highestLodKey) const;
+
 	void addTileToCache(const TileImage& image, const QuadTreeTileKey& key) const;
 
+	//! Finds the tile to sample for a key at maxLod
+	//! @returns the tile, or nullopt if no tile is available
+	using TileFinder = std::function<std::optional<TileImage>(const QuadTreeTileKey& highestLodKey)>;
+
+	//! Groups positions by their key at maxLod and samples the tile found for each key
+	//! @param provisionalBelowMaxLod if true, altitudes from tiles below maxLod are marked as provisional
+	void getAltitudesGroupedByTile(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results, const TileFinder& tileFinder, bool provisionalBelowMaxLod) const;
+
+	//! @returns keys overlapping a lat/lon rectangle at the finest level, no finer than maxLod, with tiles at least as large as the rectangle
+	std::vector<QuadTreeTileKey> getKeysOverlappingRegion(const sim::LatLon& minimum, const sim::LatLon& maximum) const;
+
+	struct ElevationBoundsNode
+	{
+		HeightMapElevationBounds bounds = emptyHeightMapElevationBounds(); //!< Bounds of elevations within this node's key from all tiles added to the cache at or below the key
+		std::weak_ptr<const HeightMapElevationBoundsPyramid> image; //!< Bounds of the image with this node's key
+		bool hasImage = false; //!< True if an image with this node's key has been added to the cache
+		uint64_t maxLodKeyCount = 0; //!< Number of keys at maxLod at or below this node's key that have been added to the cache
+	};
+
+	std::optional<ElevationBoundsNode> findElevationBoundsNode(const QuadTreeTileKey& key) const;
+
 protected:
 	const TileSourcePtr mTileSource;
 	const int mMaxLod;
 
-	mutable LruCacheMap<QuadTreeTileKey, TileImage> mTileImageCache;
-	mutable std::mutex mTileImageCacheMutex;
+	//! Tile cache is split into shards, each with its own lock, so that concurrent queries of different tiles rarely contend
+	struct TileImageCacheShard
+	{
+		TileImageCacheShard();
+		LruCacheMap<QuadTreeTileKey, TileImage> cache;
+		std::mutex mutex;
+	};
+	static constexpr size_t tileImageCacheShardCount = 16;
+
+	TileImageCacheShard& getTileImageCacheShard(const QuadTreeTileKey& key) const;
+
+	mutable std::array<TileImageCacheShard, tileImageCacheShardCount> mTileImageCacheShards;
+
+	//! Elevation bounds of every tile that has been added to the cache. Nodes are never evicted, which is valid because
+	//! evicted tiles are reloaded with the same data. Nodes are small compared to images.
+	mutable std::unordered_map<QuadTreeTileKey, ElevationBoundsNode> mElevationBoundsTree;
+	mutable std::shared_mutex mElevationBoundsTreeMutex;
 };
 
 //! Immediately returns result from an already loaded tile at the highest available LOD, and schedules a background task to load higher LOD levels if requred
 class NonBlockingTilePlanetAltitudeProvider : public BlockingTilePlanetAltitudeProvider
 {
 public:
-	NonBlockingTilePlanetAltitudeProvider(px_sched::Scheduler* scheduler, const TileSourcePtr& tileSource, int maxLod);
+	//! @param maxConcurrentLoads is the maximum number of tiles loaded in parallel
+	NonBlockingTilePlanetAltitudeProvider(px_sched::Scheduler* scheduler, const TileSourcePtr& tileSource, int maxLod, int maxConcurrentLoads = 4);
+	~NonBlockingTilePlanetAltitudeProvider() override;
 
 	//! @ThreadSafe
 	AltitudeResult getAltitude(const sim::LatLon& position) const override;
 
+	//! Positions are grouped by tile so that each tile is found once per batch
+	//! @ThreadSafe
+	void getAltitudes(std::span<const sim::LatLon> positions, std::span<AltitudeResult> results) const override;
+
+	//! Returns bounds of the altitudes available from tiles loaded so far, which are the altitudes getAltitude() would currently return.
+	//! Never loads tiles.
+	//! @ThreadSafe
+	std::optional<AltitudeBounds> getAltitudeBounds(const sim::LatLon& minimum, const sim::LatLon& maximum) const override;
+
 protected:
+	//! @returns the loaded tile at the highest LOD containing the given key at maxLod, and requests loading of the tile at the next LOD
+	std::optional<TileImage> findHighestLoadedTile(const QuadTreeTileKey& highestLodKey) const;
+
 	void requestLoadTileAndAddToCache(const QuadTreeTileKey& key) const;
 
 protected:
 	mutable px_sched::Sync mLoadingTaskSync;
 	px_sched::Scheduler* mScheduler;
+	const size_t mMaxConcurrentLoads;
+
+	mutable std::mutex mLoadingKeysMutex;
+	mutable std::unordered_set<QuadTreeTileKey> mLoadingKeys;
 };
 
 } // namespace vis
@@ -135,6 +135,7 @@ BruentonAtmosphere::BruentonAtmosphere(const BruentonAtmosphereConfig& config) :
 	//   For the Earth case, 102 degrees is a good choice for most cases.
 	//   120 degrees is necessary for very high exposure values which may be possible in full precision.
 	generatorConfig.maxSunZenithAngle = (generatorConfig.useHalfPrecision ? 102.0 : 120.0) * math::degToRadD();
+	generatorConfig.cacheDirectory = config.cacheDirectory;
 
 	mGenerator = osg::ref_ptr<BruentonAtmosphereGenerator>(new BruentonAtmosphereGenerator(generatorConfig));
 	mGenerator->addCullCallback(new TextureGeneratorCullCallback());
@@ -10,6 +10,7 @@
 #include <osg/Group>
 #include <osg/Texture2D>
 #include <functional>
+#include <string>
 
 namespace skybolt {
 namespace vis {
@@ -45,6 +46,9 @@ struct BruentonAtmosphereConfig
 	double miePhaseFunctionG = 0.8;
 
 	bool useEarthOzone = true;
+
+	//! If not empty, precomputed textures are cached in this directory and reused when the atmosphere parameters are unchanged
+	std::string cacheDirectory;
 };
 
 class BruentonAtmosphere : public osg::Group
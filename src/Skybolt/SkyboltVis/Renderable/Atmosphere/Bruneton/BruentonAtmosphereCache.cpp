@@ -0,0 +1,521 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "BruentonAtmosphereCache.h"
+#include "BruentonAtmosphereGenerator.h"
+#include "ThirdParty/constants.h"
+#include <SkyboltCommon/ShaUtility.h>
+
+#include <boost/log/trivial.hpp>
+#include <osg/Texture2D>
+#include <osg/Texture3D>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using namespace atmosphere;
+
+namespace skybolt {
+namespace vis {
+
+//! Increment when the file format or the precomputation changes such that existing cache files are invalid
+constexpr std::uint32_t cacheFormatVersion = 1;
+constexpr char cacheFileMagic[] = "SKYBOLT_ATMOSPHERE_CACHE";
+
+static void writeLayer(std::ostream& s, const DensityProfileLayer& layer)
+{
+	s << layer.width << "," << layer.exp_term << "," << layer.exp_scale << "," << layer.linear_term << "," << layer.constant_term << ";";
+}
+
+static void writeValues(std::ostream& s, const std::vector<double>& values)
+{
+	for (double value : values)
+	{
+		s << value << ",";
+	}
+	s << ";";
+}
+
+std::string calcBruentonAtmosphereCacheKey(const BruentonAtmosphereGeneratorConfig& config)
+{
+	std::ostringstream s;
+	// Write values in hex so that they are exactly represented
+	s << std::hexfloat;
+	s << "version:" << cacheFormatVersion << ";";
+	s << "textureSizes:" << TRANSMITTANCE_TEXTURE_WIDTH << "," << TRANSMITTANCE_TEXTURE_HEIGHT << ","
+		<< SCATTERING_TEXTURE_R_SIZE << "," << SCATTERING_TEXTURE_MU_SIZE << "," << SCATTERING_TEXTURE_MU_S_SIZE << "," << SCATTERING_TEXTURE_NU_SIZE << ","
+		<< IRRADIANCE_TEXTURE_WIDTH << "," << IRRADIANCE_TEXTURE_HEIGHT << ";";
+
+	s << config.sunAngularRadius << ";" << config.bottomRadius << ";" << config.topRadius << ";";
+	writeValues(s, config.wavelengths);
+	writeValues(s, config.solarIrradiance);
+	writeValues(s, config.rayleighScattering);
+	writeValues(s, config.mieScattering);
+	writeValues(s, config.mieExtinction);
+	writeValues(s, config.absorptionExtinction);
+	writeLayer(s, config.rayleighLayer);
+	writeLayer(s, config.mieLayer);
+	for (const DensityProfileLayer& layer : config.ozoneDensity)
+	{
+		writeLayer(s, layer);
+	}
+	s << config.miePhaseFunctionG << ";" << config.useHalfPrecision << ";" << config.useCombinedTextures << ";"
+		<< config.maxSunZenithAngle << ";" << config.lengthUnitInMeters << ";";
+
+	return calcSha1(s.str());
+}
+
+std::string getBruentonAtmosphereCacheFilename(const std::string& cacheDirectory, const std::string& key)
+{
+	return cacheDirectory + "/" + key + ".atmosphere";
+}
+
+//! FNV-1a hash used to detect corrupt cache files
+static std::uint64_t updateChecksum(std::uint64_t hash, const unsigned char* data, size_t size)
+{
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+constexpr std::uint64_t initialChecksum = 14695981039346656037ull;
+
+template <typename T>
+static void writeValue(std::ostream& s, const T& value)
+{
+	s.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+static T readValue(std::istream& s)
+{
+	T value{};
+	s.read(reinterpret_cast<char*>(&value), sizeof(T));
+	return value;
+}
+
+static void writeString(std::ostream& s, const std::string& str)
+{
+	writeValue<std::uint32_t>(s, std::uint32_t(str.size()));
+	s.write(str.data(), str.size());
+}
+
+static std::string readString(std::istream& s, size_t maxSize)
+{
+	auto size = readValue<std::uint32_t>(s);
+	if (!s || size > maxSize)
+	{
+		return {};
+	}
+	std::string str(size, '\0');
+	s.read(str.data(), size);
+	return str;
+}
+
+static void writeImage(std::ostream& s, const osg::Image* image, std::uint64_t& checksum)
+{
+	writeValue<std::uint8_t>(s, image ? 1 : 0);
+	if (!image)
+	{
+		return;
+	}
+
+	writeValue<std::int32_t>(s, image->s());
+	writeValue<std::int32_t>(s, image->t());
+	writeValue<std::int32_t>(s, image->r());
+	writeValue<std::int32_t>(s, image->getPixelFormat());
+	writeValue<std::int32_t>(s, image->getDataType());
+	writeValue<std::int32_t>(s, image->getInternalTextureFormat());
+	writeValue<std::uint32_t>(s, image->getPacking());
+
+	std::uint64_t size = image->getTotalSizeInBytes();
+	writeValue<std::uint64_t>(s, size);
+	s.write(reinterpret_cast<const char*>(image->data()), size);
+	checksum = updateChecksum(checksum, image->data(), size);
+}
+
+//! @returns false if the stream did not contain a valid image
+static bool readImage(std::istream& s, osg::ref_ptr<osg::Image>& image, std::uint64_t& checksum)
+{
+	auto present = readValue<std::uint8_t>(s);
+	if (!s)
+	{
+		return false;
+	}
+	if (!present)
+	{
+		image = nullptr;
+		return true;
+	}
+
+	auto width = readValue<std::int32_t>(s);
+	auto height = readValue<std::int32_t>(s);
+	auto depth = readValue<std::int32_t>(s);
+	auto pixelFormat = readValue<std::int32_t>(s);
+	auto dataType = readValue<std::int32_t>(s);
+	auto internalTextureFormat = readValue<std::int32_t>(s);
+	auto packing = readValue<std::uint32_t>(s);
+	auto size = readValue<std::uint64_t>(s);
+	if (!s || width <= 0 || height <= 0 || depth <= 0)
+	{
+		return false;
+	}
+
+	image = new osg::Image();
+	image->allocateImage(width, height, depth, pixelFormat, dataType, packing);
+	if (image->getTotalSizeInBytes() != size)
+	{
+		return false;
+	}
+	image->setInternalTextureFormat(internalTextureFormat);
+	s.read(reinterpret_cast<char*>(image->data()), size);
+	checksum = updateChecksum(checksum, image->data(), size);
+	return bool(s);
+}
+
+void writeBruentonAtmosphereCache(const std::string& filename, const std::string& key, const BruentonAtmospherePrecomputedImages& images)
+{
+	std::filesystem::path path(filename);
+	if (path.has_parent_path())
+	{
+		std::filesystem::create_directories(path.parent_path());
+	}
+
+	std::string partialFilename = filename + ".partial";
+	{
+		std::ofstream f(partialFilename, std::ios::binary);
+		if (!f)
+		{
+			throw std::runtime_error("Could not open atmosphere cache file for writing: " + partialFilename);
+		}
+
+		f.write(cacheFileMagic, sizeof(cacheFileMagic));
+		writeValue<std::uint32_t>(f, cacheFormatVersion);
+		writeString(f, key);
+
+		std::uint64_t checksum = initialChecksum;
+		writeImage(f, images.transmittance.get(), checksum);
+		writeImage(f, images.scattering.get(), checksum);
+		writeImage(f, images.irradiance.get(), checksum);
+		writeImage(f, images.optionalSingleMieScattering.get(), checksum);
+		writeValue<std::uint64_t>(f, checksum);
+
+		if (!f)
+		{
+			throw std::runtime_error("Could not write atmosphere cache file: " + partialFilename);
+		}
+	}
+	std::filesystem::rename(partialFilename, filename);
+}
+
+std::optional<BruentonAtmospherePrecomputedImages> readBruentonAtmosphereCache(const std::string& filename, const std::string& key)
+{
+	std::ifstream f(filename, std::ios::binary);
+	if (!f)
+	{
+		return std::nullopt;
+	}
+
+	auto invalid = [&] (const std::string& reason) {
+		BOOST_LOG_TRIVIAL(warning) << "Ignoring atmosphere cache file '" << filename << "': " << reason;
+		return std::nullopt;
+	};
+
+	char magic[sizeof(cacheFileMagic)] = {};
+	f.read(magic, sizeof(magic));
+	if (!f || std::string(magic, sizeof(magic)) != std::string(cacheFileMagic, sizeof(cacheFileMagic)))
+	{
+		return invalid("not an atmosphere cache file");
+	}
+
+	if (readValue<std::uint32_t>(f) != cacheFormatVersion)
+	{
+		return invalid("unsupported version");
+	}
+
+	if (readString(f, key.size()) != key)
+	{
+		return invalid("key mismatch");
+	}
+
+	BruentonAtmospherePrecomputedImages images;
+	std::uint64_t checksum = initialChecksum;
+	if (!readImage(f, images.transmittance, checksum)
+		|| !readImage(f, images.scattering, checksum)
+		|| !readImage(f, images.irradiance, checksum)
+		|| !readImage(f, images.optionalSingleMieScattering, checksum))
+	{
+		return invalid("truncated or malformed image");
+	}
+
+	auto storedChecksum = readValue<std::uint64_t>(f);
+	if (!f || storedChecksum != checksum)
+	{
+		return invalid("checksum mismatch");
+	}
+
+	if (!images.transmittance || !images.scattering || !images.irradiance)
+	{
+		return invalid("missing image");
+	}
+	return images;
+}
+
+namespace {
+
+// CPU implementation of the transmittance functions in functions.glsl, in meters
+
+struct TransmittanceParameters
+{
+	double bottomRadius;
+	double topRadius;
+	std::vector<DensityProfileLayer> rayleighDensity;
+	std::vector<DensityProfileLayer> mieDensity;
+	std::vector<DensityProfileLayer> absorptionDensity;
+	osg::Vec3d rayleighScattering;
+	osg::Vec3d mieExtinction;
+	osg::Vec3d absorptionExtinction;
+};
+
+//! Pads layers to two layers, as the model does when generating the shader's density profiles
+std::vector<DensityProfileLayer> toTwoLayerProfile(std::vector<DensityProfileLayer> layers)
+{
+	while (layers.size() < 2)
+	{
+		layers.insert(layers.begin(), DensityProfileLayer());
+	}
+	return layers;
+}
+
+osg::Vec3d interpolateRgb(const std::vector<double>& wavelengths, const std::vector<double>& values)
+{
+	return osg::Vec3d(
+		Interpolate(wavelengths, values, Model::kLambdaR),
+		Interpolate(wavelengths, values, Model::kLambdaG),
+		Interpolate(wavelengths, values, Model::kLambdaB));
+}
+
+double safeSqrt(double a)
+{
+	return std::sqrt(std::max(a, 0.0));
+}
+
+double distanceToTopAtmosphereBoundary(const TransmittanceParameters& p, double r, double mu)
+{
+	double discriminant = r * r * (mu * mu - 1.0) + p.topRadius * p.topRadius;
+	return std::max(-r * mu + safeSqrt(discriminant), 0.0);
+}
+
+double getLayerDensity(const DensityProfileLayer& layer, double altitude)
+{
+	double density = layer.exp_term * std::exp(layer.exp_scale * altitude) + layer.linear_term * altitude + layer.constant_term;
+	return std::clamp(density, 0.0, 1.0);
+}
+
+double getProfileDensity(const std::vector<DensityProfileLayer>& profile, double altitude)
+{
+	return altitude < profile[0].width ? getLayerDensity(profile[0], altitude) : getLayerDensity(profile[1], altitude);
+}
+
+double computeOpticalLengthToTopAtmosphereBoundary(const TransmittanceParameters& p, const std::vector<DensityProfileLayer>& profile, double r, double mu)
+{
+	constexpr int sampleCount = 500;
+	double dx = distanceToTopAtmosphereBoundary(p, r, mu) / double(sampleCount);
+	double result = 0.0;
+	for (int i = 0; i <= sampleCount; ++i)
+	{
+		double d = double(i) * dx;
+		double ri = std::sqrt(d * d + 2.0 * r * mu * d + r * r);
+		double y = getProfileDensity(profile, ri - p.bottomRadius);
+		double weight = (i == 0 || i == sampleCount) ? 0.5 : 1.0;
+		result += y * weight * dx;
+	}
+	return result;
+}
+
+osg::Vec3d computeTransmittanceToTopAtmosphereBoundary(const TransmittanceParameters& p, double r, double mu)
+{
+	osg::Vec3d opticalDepth =
+		p.rayleighScattering * computeOpticalLengthToTopAtmosphereBoundary(p, p.rayleighDensity, r, mu) +
+		p.mieExtinction * computeOpticalLengthToTopAtmosphereBoundary(p, p.mieDensity, r, mu) +
+		p.absorptionExtinction * computeOpticalLengthToTopAtmosphereBoundary(p, p.absorptionDensity, r, mu);
+	return osg::Vec3d(std::exp(-opticalDepth.x()), std::exp(-opticalDepth.y()), std::exp(-opticalDepth.z()));
+}
+
+double getUnitRangeFromTextureCoord(double u, int textureSize)
+{
+	return (u - 0.5 / double(textureSize)) / (1.0 - 1.0 / double(textureSize));
+}
+
+osg::Vec3d computeTransmittanceTexel(const TransmittanceParameters& p, int x, int y)
+{
+	double xMu = getUnitRangeFromTextureCoord((double(x) + 0.5) / double(TRANSMITTANCE_TEXTURE_WIDTH), TRANSMITTANCE_TEXTURE_WIDTH);
+	double xR = getUnitRangeFromTextureCoord((double(y) + 0.5) / double(TRANSMITTANCE_TEXTURE_HEIGHT), TRANSMITTANCE_TEXTURE_HEIGHT);
+
+	double H = std::sqrt(p.topRadius * p.topRadius - p.bottomRadius * p.bottomRadius);
+	double rho = H * xR;
+	double r = std::sqrt(rho * rho + p.bottomRadius * p.bottomRadius);
+
+	double dMin = p.topRadius - r;
+	double dMax = rho + H;
+	double d = dMin + xMu * (dMax - dMin);
+	double mu = (d == 0.0) ? 1.0 : (H * H - rho * rho - d * d) / (2.0 * r * d);
+	mu = std::clamp(mu, -1.0, 1.0);
+
+	return computeTransmittanceToTopAtmosphereBoundary(p, r, mu);
+}
+
+TransmittanceParameters toTransmittanceParameters(const BruentonAtmosphereGeneratorConfig& config)
+{
+	TransmittanceParameters p;
+	p.bottomRadius = config.bottomRadius;
+	p.topRadius = config.topRadius;
+	p.rayleighDensity = toTwoLayerProfile({config.rayleighLayer});
+	p.mieDensity = toTwoLayerProfile({config.mieLayer});
+	p.absorptionDensity = toTwoLayerProfile(config.ozoneDensity);
+	p.rayleighScattering = interpolateRgb(config.wavelengths, config.rayleighScattering);
+	p.mieExtinction = interpolateRgb(config.wavelengths, config.mieExtinction);
+	p.absorptionExtinction = interpolateRgb(config.wavelengths, config.absorptionExtinction);
+	return p;
+}
+
+} // namespace
+
+osg::ref_ptr<osg::Image> computeBruentonTransmittanceImage(const BruentonAtmosphereGeneratorConfig& config)
+{
+	TransmittanceParameters p = toTransmittanceParameters(config);
+
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(TRANSMITTANCE_TEXTURE_WIDTH, TRANSMITTANCE_TEXTURE_HEIGHT, 1, GL_RGBA, GL_FLOAT);
+	image->setInternalTextureFormat(GL_RGBA32F_ARB);
+
+	float* data = reinterpret_cast<float*>(image->data());
+	for (int y = 0; y < TRANSMITTANCE_TEXTURE_HEIGHT; ++y)
+	{
+		for (int x = 0; x < TRANSMITTANCE_TEXTURE_WIDTH; ++x)
+		{
+			osg::Vec3d t = computeTransmittanceTexel(p, x, y);
+			float* texel = data + (y * TRANSMITTANCE_TEXTURE_WIDTH + x) * 4;
+			texel[0] = float(t.x());
+			texel[1] = float(t.y());
+			texel[2] = float(t.z());
+			texel[3] = 0.0f;
+		}
+	}
+	return image;
+}
+
+static std::optional<std::string> validateImage(const osg::Image* image, const std::string& name, int width, int height, int depth)
+{
+	if (!image)
+	{
+		return name + " image is missing";
+	}
+	if (image->s() != width || image->t() != height || image->r() != depth)
+	{
+		return name + " image has unexpected dimensions";
+	}
+	if (image->getDataType() != GL_FLOAT)
+	{
+		return name + " image is not float";
+	}
+
+	const float* data = reinterpret_cast<const float*>(image->data());
+	size_t count = image->getTotalSizeInBytes() / sizeof(float);
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!std::isfinite(data[i]) || data[i] < 0.0f)
+		{
+			return name + " image contains invalid values";
+		}
+	}
+	return std::nullopt;
+}
+
+std::optional<std::string> validateBruentonAtmospherePrecomputedImages(const BruentonAtmospherePrecomputedImages& images,
+	const BruentonAtmosphereGeneratorConfig& config, double transmittanceTolerance)
+{
+	if (auto error = validateImage(images.transmittance.get(), "Transmittance", TRANSMITTANCE_TEXTURE_WIDTH, TRANSMITTANCE_TEXTURE_HEIGHT, 1); error)
+	{
+		return error;
+	}
+	if (auto error = validateImage(images.scattering.get(), "Scattering", SCATTERING_TEXTURE_WIDTH, SCATTERING_TEXTURE_HEIGHT, SCATTERING_TEXTURE_DEPTH); error)
+	{
+		return error;
+	}
+	if (auto error = validateImage(images.irradiance.get(), "Irradiance", IRRADIANCE_TEXTURE_WIDTH, IRRADIANCE_TEXTURE_HEIGHT, 1); error)
+	{
+		return error;
+	}
+	if (!config.useCombinedTextures)
+	{
+		if (auto error = validateImage(images.optionalSingleMieScattering.get(), "Single Mie scattering", SCATTERING_TEXTURE_WIDTH, SCATTERING_TEXTURE_HEIGHT, SCATTERING_TEXTURE_DEPTH); error)
+		{
+			return error;
+		}
+	}
+
+	// Spot check a sparse grid of transmittance texels against the CPU implementation
+	TransmittanceParameters p = toTransmittanceParameters(config);
+	const osg::Image& transmittance = *images.transmittance;
+	int components = osg::Image::computeNumComponents(transmittance.getPixelFormat());
+	if (components < 3)
+	{
+		return std::string("Transmittance image has too few components");
+	}
+
+	constexpr int sampleStride = 8;
+	const float* data = reinterpret_cast<const float*>(transmittance.data());
+	for (int y = 0; y < TRANSMITTANCE_TEXTURE_HEIGHT; y += sampleStride)
+	{
+		for (int x = 0; x < TRANSMITTANCE_TEXTURE_WIDTH; x += sampleStride)
+		{
+			osg::Vec3d expected = computeTransmittanceTexel(p, x, y);
+			const float* texel = data + (y * TRANSMITTANCE_TEXTURE_WIDTH + x) * components;
+			for (int c = 0; c < 3; ++c)
+			{
+				if (std::abs(double(texel[c]) - expected[c]) > transmittanceTolerance)
+				{
+					return "Transmittance texel (" + std::to_string(x) + ", " + std::to_string(y) + ") does not match CPU reference";
+				}
+			}
+		}
+	}
+	return std::nullopt;
+}
+
+osg::ref_ptr<osg::Texture> createBruentonAtmosphereTexture(const osg::ref_ptr<osg::Image>& image)
+{
+	osg::ref_ptr<osg::Texture> texture;
+	if (image->r() > 1)
+	{
+		osg::ref_ptr<osg::Texture3D> texture3d = new osg::Texture3D(image);
+		texture3d->setWrap(osg::Texture::WRAP_R, osg::Texture::CLAMP_TO_EDGE);
+		texture = texture3d;
+	}
+	else
+	{
+		texture = new osg::Texture2D(image);
+	}
+
+	texture->setInternalFormat(image->getInternalTextureFormat());
+	texture->setFilter(osg::Texture::FilterParameter::MIN_FILTER, osg::Texture::FilterMode::LINEAR);
+	texture->setFilter(osg::Texture::FilterParameter::MAG_FILTER, osg::Texture::FilterMode::LINEAR);
+	texture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+	texture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+	texture->setResizeNonPowerOfTwoHint(false);
+	texture->setUnRefImageDataAfterApply(true);
+	return texture;
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,58 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <osg/Image>
+#include <osg/Texture>
+
+#include <optional>
+#include <string>
+
+namespace skybolt {
+namespace vis {
+
+struct BruentonAtmosphereGeneratorConfig;
+
+//! Precomputed atmosphere textures read back from the GPU, stored in the cache as 32 bit float images
+struct BruentonAtmospherePrecomputedImages
+{
+	osg::ref_ptr<osg::Image> transmittance;
+	osg::ref_ptr<osg::Image> scattering;
+	osg::ref_ptr<osg::Image> irradiance;
+	osg::ref_ptr<osg::Image> optionalSingleMieScattering; //!< Null if scattering textures are combined
+};
+
+//! @returns a key which changes if any parameter affecting the precomputed textures changes.
+//! The config's cacheDirectory does not affect the key.
+std::string calcBruentonAtmosphereCacheKey(const BruentonAtmosphereGeneratorConfig& config);
+
+std::string getBruentonAtmosphereCacheFilename(const std::string& cacheDirectory, const std::string& key);
+
+//! Writes images to a temporary file and then renames it, so that an interrupted write does not leave a partial cache file.
+//! @throws std::runtime_error if the file could not be written
+void writeBruentonAtmosphereCache(const std::string& filename, const std::string& key, const BruentonAtmospherePrecomputedImages& images);
+
+//! @returns images read from the file, or nullopt if the file does not exist, is corrupt, or was written with a different key
+std::optional<BruentonAtmospherePrecomputedImages> readBruentonAtmosphereCache(const std::string& filename, const std::string& key);
+
+//! Computes the transmittance texture on the CPU using the same method as the GPU precomputation.
+//! This is slow, but allows precomputed textures to be validated without a GPU.
+//! @returns an RGBA 32 bit float image with the dimensions of the transmittance texture
+osg::ref_ptr<osg::Image> computeBruentonTransmittanceImage(const BruentonAtmosphereGeneratorConfig& config);
+
+//! Checks that images have the expected dimensions, contain only finite non-negative values,
+//! and that a sparse sample of transmittance texels match values computed on the CPU to within the tolerance.
+//! @returns a description of the first problem found, or nullopt if the images are valid
+std::optional<std::string> validateBruentonAtmospherePrecomputedImages(const BruentonAtmospherePrecomputedImages& images,
+	const BruentonAtmosphereGeneratorConfig& config, double transmittanceTolerance = 1e-2);
+
+//! Creates a texture with the same sampling parameters as the GPU precomputation's textures, initialized with the image.
+//! The texture's internal format is the image's internal texture format.
+osg::ref_ptr<osg::Texture> createBruentonAtmosphereTexture(const osg::ref_ptr<osg::Image>& image);
+
+} // namespace vis
+} // namespace skybolt
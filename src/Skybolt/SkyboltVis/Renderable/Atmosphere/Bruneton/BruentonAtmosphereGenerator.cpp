@@ -5,9 +5,14 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "BruentonAtmosphereGenerator.h"
+#include "BruentonAtmosphereCache.h"
+#include <SkyboltVis/CaptureTexture.h>
 #include <SkyboltVis/OsgStateSetHelpers.h>
 #include <SkyboltVis/TextureGenerator/CompositingPipelineFactory.h>
 
+#include <boost/log/trivial.hpp>
+#include <osg/Camera>
+
 using namespace atmosphere;
 
 namespace skybolt {
@@ -15,9 +20,80 @@ namespace vis {
 
 bool use_precomputed_luminance = false;
 
+//! Reads back the precomputed textures after the final precomputation stage is drawn, and writes them to the cache
+class CacheWriterDrawCallback : public osg::Camera::DrawCallback
+{
+public:
+	CacheWriterDrawCallback(const BruentonAtmosphereGeneratorConfig& config, const std::string& filename, const std::string& key, const atmosphere::Model::Pipeline& pipeline) :
+		mConfig(config),
+		mFilename(filename),
+		mKey(key),
+		mTransmittanceTexture(pipeline.transmittanceTexture),
+		mScatteringTexture(pipeline.scatteringTexture),
+		mIrradianceTexture(pipeline.irradianceTexture),
+		mOptionalSingleMieScatteringTexture(pipeline.optionalSingleMieScatteringTexture)
+	{
+	}
+
+	void operator () (osg::RenderInfo& renderInfo) const override
+	{
+		if (mWritten)
+		{
+			return;
+		}
+		mWritten = true;
+
+		BruentonAtmospherePrecomputedImages images;
+		images.transmittance = captureTexture(renderInfo, *mTransmittanceTexture, GL_FLOAT);
+		images.scattering = captureTexture(renderInfo, *mScatteringTexture, GL_FLOAT);
+		images.irradiance = captureTexture(renderInfo, *mIrradianceTexture, GL_FLOAT);
+		if (mOptionalSingleMieScatteringTexture)
+		{
+			images.optionalSingleMieScattering = captureTexture(renderInfo, *mOptionalSingleMieScatteringTexture, GL_FLOAT);
+		}
+
+		if (auto error = validateBruentonAtmospherePrecomputedImages(images, mConfig); error)
+		{
+			BOOST_LOG_TRIVIAL(warning) << "Precomputed atmosphere not cached because it failed validation: " << *error;
+			return;
+		}
+
+		try
+		{
+			writeBruentonAtmosphereCache(mFilename, mKey, images);
+		}
+		catch (const std::exception& e)
+		{
+			BOOST_LOG_TRIVIAL(warning) << e.what();
+		}
+	}
+
+private:
+	BruentonAtmosphereGeneratorConfig mConfig;
+	std::string mFilename;
+	std::string mKey;
+	osg::ref_ptr<osg::Texture> mTransmittanceTexture;
+	osg::ref_ptr<osg::Texture> mScatteringTexture;
+	osg::ref_ptr<osg::Texture> mIrradianceTexture;
+	osg::ref_ptr<osg::Texture> mOptionalSingleMieScatteringTexture;
+	mutable bool mWritten = false;
+};
+
 BruentonAtmosphereGenerator::BruentonAtmosphereGenerator(const BruentonAtmosphereGeneratorConfig& config) :
 	mCompositingPipelineFactory(std::make_unique<CompositingPipelineFactory>())
 {
+	std::string cacheKey;
+	std::string cacheFilename;
+	if (!config.cacheDirectory.empty())
+	{
+		cacheKey = calcBruentonAtmosphereCacheKey(config);
+		cacheFilename = getBruentonAtmosphereCacheFilename(config.cacheDirectory, cacheKey);
+		if (loadFromCache(config, cacheFilename, cacheKey))
+		{
+			return;
+		}
+	}
+
 	constexpr double kGroundAlbedo = 0.1;
 
 	std::vector<double> ground_albedo;
@@ -39,12 +115,47 @@ BruentonAtmosphereGenerator::BruentonAtmosphereGenerator(const BruentonAtmospher
 	mIrradianceTexture = pipeline.irradianceTexture;
 	mOptionalSingleMieScatteringTexture = pipeline.optionalSingleMieScatteringTexture;
 
-	addChild(mCompositingPipelineFactory->createCompositingPipeline(pipeline.precomputation));
+	osg::ref_ptr<osg::Group> precomputation = mCompositingPipelineFactory->createCompositingPipeline(pipeline.precomputation);
+	addChild(precomputation);
+
+	if (!cacheFilename.empty() && precomputation->getNumChildren() > 0)
+	{
+		// Stages are pre-render cameras drawn in order, so the textures are complete after the last stage is drawn
+		if (osg::Camera* finalStage = precomputation->getChild(precomputation->getNumChildren() - 1)->asCamera(); finalStage)
+		{
+			finalStage->setFinalDrawCallback(new CacheWriterDrawCallback(config, cacheFilename, cacheKey, pipeline));
+		}
+	}
 }
 
 BruentonAtmosphereGenerator::~BruentonAtmosphereGenerator()
 {
 }
 
+bool BruentonAtmosphereGenerator::loadFromCache(const BruentonAtmosphereGeneratorConfig& config, const std::string& filename, const std::string& key)
+{
+	std::optional<BruentonAtmospherePrecomputedImages> images = readBruentonAtmosphereCache(filename, key);
+	if (!images)
+	{
+		return false;
+	}
+
+	if (auto error = validateBruentonAtmospherePrecomputedImages(*images, config); error)
+	{
+		BOOST_LOG_TRIVIAL(warning) << "Ignoring cached atmosphere '" << filename << "' because it failed validation: " << *error;
+		return false;
+	}
+
+	mTransmittanceTexture = createBruentonAtmosphereTexture(images->transmittance);
+	mScatteringTexture = createBruentonAtmosphereTexture(images->scattering);
+	mIrradianceTexture = createBruentonAtmosphereTexture(images->irradiance);
+	if (images->optionalSingleMieScattering)
+	{
+		mOptionalSingleMieScatteringTexture = createBruentonAtmosphereTexture(images->optionalSingleMieScattering);
+	}
+	mLoadedFromCache = true;
+	return true;
+}
+
 } // namespace vis
 } // namespace skybolt
\ No newline at end of file
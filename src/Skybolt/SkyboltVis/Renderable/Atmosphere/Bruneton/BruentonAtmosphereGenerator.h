@@ -10,6 +10,7 @@
 
 #include <osg/Group>
 #include <osg/Texture>
+#include <string>
 #include <vector>
 
 namespace skybolt {
@@ -44,6 +45,10 @@ struct BruentonAtmosphereGeneratorConfig
 	bool useCombinedTextures = true;
 	double maxSunZenithAngle;
 	double lengthUnitInMeters = 1.0;
+
+	//! If not empty, precomputed textures are loaded from this directory instead of being computed,
+	//! and newly computed textures are written to this directory.
+	std::string cacheDirectory;
 };
 
 class BruentonAtmosphereGenerator : public osg::Group
@@ -57,12 +62,19 @@ public:
 	const osg::ref_ptr<osg::Texture>& getIrradianceTexture() const { return mIrradianceTexture; }
 	const osg::ref_ptr<osg::Texture>& getOptionalSingleMieScatteringTexture() const { return mOptionalSingleMieScatteringTexture; }
 
+	//! @returns true if the textures were loaded from the cache, in which case no precomputation is rendered
+	bool isLoadedFromCache() const { return mLoadedFromCache; }
+
+private:
+	bool loadFromCache(const BruentonAtmosphereGeneratorConfig& config, const std::string& filename, const std::string& key);
+
 private:
 	std::unique_ptr<class CompositingPipelineFactory> mCompositingPipelineFactory;
 	osg::ref_ptr<osg::Texture> mTransmittanceTexture;
 	osg::ref_ptr<osg::Texture> mScatteringTexture;
 	osg::ref_ptr<osg::Texture> mIrradianceTexture;
 	osg::ref_ptr<osg::Texture> mOptionalSingleMieScatteringTexture;
+	bool mLoadedFromCache = false;
 };
 
 } // namespace vis
@@ -8,6 +8,7 @@
 #include "earcutOsg.h"
 #include "OsgGeometryHelpers.h"
 #include "OsgStateSetHelpers.h"
+#include "VertexQuantization.h"
 #include "VisibilityCategory.h"
 #include "Renderable/Planet/Features/BuildingTypes.h"
 
@@ -18,11 +19,18 @@
 #include <osg/Texture2D>
 #include <osg/Texture2DArray>
 
+#include <algorithm>
+#include <cmath>
+
 const int horizontalWindowsInTexture = 10;
 const float buildingLevelHeight = 3.9f;
 const float roofTextureWorldSize = 20;
 const float roofUvScale = 1.0f / roofTextureWorldSize;
 
+//! Walls are split into quads at most this many texture repeats wide to keep U within fixed point range.
+//! This is a whole number of repeats, so the texture is continuous across splits.
+const float wallMaxTextureRepeatsX = 64;
+
 namespace skybolt {
 namespace vis {
 
@@ -31,6 +39,11 @@ inline osg::Vec2f toVec2f(const osg::Vec3f& v)
 	return osg::Vec2f(v.x(), v.y());
 }
 
+inline osg::Vec3f toVec3f(const osg::Vec2f& v)
+{
+	return osg::Vec3f(v.x(), v.y(), 0.f);
+}
+
 static osg::Vec2f getNormal(const std::vector<osg::Vec3f>& points, int i)
 {
 	osg::Vec2f p0 = toVec2f(points[i]);
@@ -41,42 +54,20 @@ static osg::Vec2f getNormal(const std::vector<osg::Vec3f>& points, int i)
 	return osg::Vec2f(dir.y(), -dir.x());
 }
 
-static osg::BoundingBoxf createBuilding(const Building& building, const BuildingTypes::Facade& facade, int facadeIndex, osg::Vec3Array* posBuffer, osg::Vec3Array* normalBuffer, osg::Vec4Array* uvBuffer, osg::UIntArray* indexBuffer, int buildingIndex)
+static void createBuilding(const Building& building, const BuildingTypes::Facade& facade, short facadeIndex, short buildingSeed, const PositionQuantizer& quantizer, QuantizedVertexArrays& arrays)
 {
 	assert(building.points.size() > 1);
 
-	osg::BoundingBoxf bounds;
-
-	size_t index = posBuffer->size();
+	size_t index = arrays.positions->size();
 	int pointCount = (int)building.points.size();
 	for (int i = 0; i < pointCount; ++i)
 	{	
 		int nextIndex = (i + 1) % pointCount;
 
-		// Quad vertices
 		osg::Vec3f v0 = building.points[i];
 		osg::Vec3f v1 = building.points[nextIndex];
-
-		posBuffer->push_back(v0);
-		posBuffer->push_back(v1);
-
-		bounds.expandBy(v0);
-		bounds.expandBy(v1);
-
-		v0.z() -= building.height;
-		v1.z() -= building.height;
-		posBuffer->push_back(v1);
-		posBuffer->push_back(v0);
-
-		bounds.expandBy(v0);
-		bounds.expandBy(v1);
-
-		// Normals
-		osg::Vec2f normal = getNormal(building.points, i);
-		for (int n = 0; n < 4; ++n)
-		{
-			normalBuffer->push_back(osg::Vec3f(normal.x(), normal.y(), 0.f));
-		}
+		osg::Vec3f height(0, 0, building.height);
+		osg::Vec2s normal = encodeOctahedralNormal(toVec3f(getNormal(building.points, i)));
 
 		// UVs
 		int levels = ceilf(building.height / buildingLevelHeight);
@@ -91,30 +82,51 @@ static osg::BoundingBoxf createBuilding(const Building& building, const Building
 		float textureRepeatsX = horizontalWidth / textureWorldWidth;
 		textureRepeatsX = std::ceil(textureRepeatsX * facade.horizontalSectionsInTexture) / (float)facade.horizontalSectionsInTexture;
 
-		uvBuffer->push_back(osg::Vec4f(i * textureRepeatsX, 0, facadeIndex, buildingIndex));
-		uvBuffer->push_back(osg::Vec4f(nextIndex * textureRepeatsX, 0, facadeIndex, buildingIndex));
-		uvBuffer->push_back(osg::Vec4f(nextIndex * textureRepeatsX, textureRepeatsY, facadeIndex, buildingIndex));
-		uvBuffer->push_back(osg::Vec4f(i * textureRepeatsX, textureRepeatsY, facadeIndex, buildingIndex));
-
-		// Indicies
-		indexBuffer->push_back(index);
-		indexBuffer->push_back(index + 3);
-		indexBuffer->push_back(index + 2);
-		indexBuffer->push_back(index);
-		indexBuffer->push_back(index + 2);
-		indexBuffer->push_back(index + 1);
-		index += 4;
+		// Each wall starts at u = 0 to keep texture coordinates small enough for fixed point storage.
+		// Walls are a whole number of sections wide, so windows are not cut off at corners.
+		int quadCount = std::max(1, int(std::ceil(textureRepeatsX / wallMaxTextureRepeatsX)));
+		for (int quad = 0; quad < quadCount; ++quad)
+		{
+			float u0 = float(quad) * wallMaxTextureRepeatsX;
+			float u1 = std::min(u0 + wallMaxTextureRepeatsX, textureRepeatsX);
+			float t0 = (quad == 0) ? 0.f : u0 / textureRepeatsX;
+			float t1 = (quad == quadCount - 1) ? 1.f : u1 / textureRepeatsX;
+			osg::Vec3f p0 = v0 + (v1 - v0) * t0;
+			osg::Vec3f p1 = v0 + (v1 - v0) * t1;
+			float width = u1 - u0;
+
+			// Quad vertices
+			arrays.positions->push_back(quantizer.quantize(p0));
+			arrays.positions->push_back(quantizer.quantize(p1));
+			arrays.positions->push_back(quantizer.quantize(p1 - height));
+			arrays.positions->push_back(quantizer.quantize(p0 - height));
+
+			for (int n = 0; n < 4; ++n)
+			{
+				arrays.normals->push_back(normal);
+			}
+
+			arrays.texCoords->push_back(quantizeTexCoord(osg::Vec2f(0, 0), facadeIndex, buildingSeed));
+			arrays.texCoords->push_back(quantizeTexCoord(osg::Vec2f(width, 0), facadeIndex, buildingSeed));
+			arrays.texCoords->push_back(quantizeTexCoord(osg::Vec2f(width, textureRepeatsY), facadeIndex, buildingSeed));
+			arrays.texCoords->push_back(quantizeTexCoord(osg::Vec2f(0, textureRepeatsY), facadeIndex, buildingSeed));
+
+			// Indicies
+			arrays.indices->push_back(index);
+			arrays.indices->push_back(index + 3);
+			arrays.indices->push_back(index + 2);
+			arrays.indices->push_back(index);
+			arrays.indices->push_back(index + 2);
+			arrays.indices->push_back(index + 1);
+			index += 4;
+		}
 	}
-
-	return bounds;
 }
 
-static osg::BoundingBoxf createBuildingRoof(const Building& building, int textureIndex, osg::Vec3Array* posBuffer, osg::Vec3Array* normalBuffer, osg::Vec4Array* uvBuffer, osg::UIntArray* indexBuffer, int buildingIndex)
+static void createBuildingRoof(const Building& building, short textureIndex, short buildingSeed, const PositionQuantizer& quantizer, QuantizedVertexArrays& arrays)
 {
 	assert(building.points.size() > 1);
 
-	osg::BoundingBoxf bounds;
-
 	std::vector<std::vector<osg::Vec3f>> polygon;
 	polygon.push_back(building.points);
 
@@ -124,74 +136,80 @@ static osg::BoundingBoxf createBuildingRoof(const Building& building, int textur
 	using N = uint32_t;
 	std::vector<N> indices = mapbox::earcut<N>(polygon);
 
-	size_t index = posBuffer->size();
+	// UVs are relative to the first point to keep them small enough for fixed point storage
+	osg::Vec2f uvOrigin = toVec2f(building.points.front());
+	osg::Vec2s normal = encodeOctahedralNormal(osg::Vec3f(0, 0, -1.f));
+
+	size_t index = arrays.positions->size();
 	int pointCount = (int)building.points.size();
 	for (int i = 0; i < pointCount; ++i)
 	{
-		// Quad vertices
 		osg::Vec3f v0 = building.points[i];
-		bounds.expandBy(v0);
-
 		v0.z() -= building.height;
-		posBuffer->push_back(v0);
-		bounds.expandBy(v0);
-
-		// Normals
-		osg::Vec2f normal = getNormal(building.points, i);
-		normalBuffer->push_back(osg::Vec3f(0, 0, -1.f));
-
-		// UVs
-		uvBuffer->push_back(osg::Vec4f(v0.x() * roofUvScale, v0.y() * roofUvScale, textureIndex, buildingIndex));
+		arrays.positions->push_back(quantizer.quantize(v0));
+		arrays.normals->push_back(normal);
+		arrays.texCoords->push_back(quantizeTexCoord((toVec2f(v0) - uvOrigin) * roofUvScale, textureIndex, buildingSeed));
 	}
 
 	for (size_t i = 0; i < indices.size(); i += 3)
 	{
-		indexBuffer->push_back(index + indices[i+2]);
-		indexBuffer->push_back(index + indices[i+1]);
-		indexBuffer->push_back(index + indices[i]);
+		arrays.indices->push_back(index + indices[i+2]);
+		arrays.indices->push_back(index + indices[i+1]);
+		arrays.indices->push_back(index + indices[i]);
+	}
+}
+
+static osg::BoundingBoxf calcBounds(const Buildings& buildings)
+{
+	osg::BoundingBoxf bounds;
+	for (const Building& building : buildings)
+	{
+		for (const osg::Vec3f& point : building.points)
+		{
+			bounds.expandBy(point);
+			bounds.expandBy(point - osg::Vec3f(0, 0, building.height));
+		}
 	}
 	return bounds;
 }
 
-static osg::Geode* createBuildings(const Buildings& buildings, const BuildingTypes& buildingTypes)
+osg::ref_ptr<osg::Geometry> createBuildingsGeometry(const Buildings& buildings, const BuildingTypes& buildingTypes)
 {
-	osg::Vec3Array* posBuffer = new osg::Vec3Array();
-	osg::Vec3Array* normalBuffer = new osg::Vec3Array();
-	osg::Vec4Array* uvBuffer = new osg::Vec4Array();
-	osg::UIntArray* indexBuffer = new osg::UIntArray();
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (const Building& building : buildings)
+	{
+		size_t pointCount = building.points.size();
+		vertexCount += pointCount * 5; // 4 per wall and 1 per roof point
+		indexCount += pointCount * 6 + (pointCount - 2) * 3; // 6 per wall and a triangle fan's worth for the roof
+	}
+
+	QuantizedVertexArrays arrays;
+	arrays.reserve(vertexCount, indexCount);
+
+	osg::BoundingBoxf bounds = calcBounds(buildings);
+	PositionQuantizer quantizer(bounds);
 
 	skybolt::Random random(0);
 
-	osg::BoundingBoxf bounds;
 	for (size_t i = 0; i < buildings.size(); ++i)
 	{
 		const Building& building = buildings[i];
 
-		const osg::Vec3f& pos = building.points.front();
-
 		int facadeIndex = i % buildingTypes.facades.size();
 
-		bounds.expandBy(createBuilding(building, buildingTypes.facades[facadeIndex], facadeIndex, posBuffer, normalBuffer, uvBuffer, indexBuffer, i));
+		// Seed for random per-building variation, which only needs to differ between neighbouring buildings
+		short buildingSeed = short(i % 32768);
+
+		createBuilding(building, buildingTypes.facades[facadeIndex], facadeIndex, buildingSeed, quantizer, arrays);
 
 		int roofTextureIndex = random.getInt(buildingTypes.facades.size(), buildingTypes.facades.size() + buildingTypes.roofCount - 1);
-		bounds.expandBy(createBuildingRoof(building, roofTextureIndex, posBuffer, normalBuffer, uvBuffer, indexBuffer, i));
+		createBuildingRoof(building, roofTextureIndex, buildingSeed, quantizer, arrays);
 	}
 
-    osg::Geode *geode = new osg::Geode();
-    osg::Geometry *geometry = new osg::Geometry();
-
-    geometry->setVertexArray(posBuffer);
-	geometry->setNormalArray(normalBuffer);
-	geometry->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
-
-	geometry->setTexCoordArray(0, uvBuffer); 
-	configureDrawable(*geometry);
-
-    geometry->addPrimitiveSet(new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, indexBuffer->size(), (GLuint*)indexBuffer->getDataPointer()));
+	osg::ref_ptr<osg::Geometry> geometry = createQuantizedGeometry(arrays, quantizer);
 	geometry->setComputeBoundingBoxCallback(createFixedBoundingBoxCallback(bounds));
-
-    geode->addDrawable(geometry);
-    return geode;
+	return geometry;
 }
 
 static osg::ref_ptr<osg::StateSet> createStateSet(const osg::ref_ptr<osg::Program>& program, osg::ref_ptr<osg::Texture2DArray> texture, const BuildingsBatch::Uniforms& uniforms)
@@ -210,7 +228,8 @@ BuildingsBatch::BuildingsBatch(const Buildings& buildings, const osg::ref_ptr<os
 {
 	mTransform->setNodeMask(vis::VisibilityCategory::defaultCategories | vis::VisibilityCategory::shadowCaster);
 
-	osg::Geode* geode = createBuildings(buildings, *buildingTypes);
+	osg::Geode* geode = new osg::Geode();
+	geode->addDrawable(createBuildingsGeometry(buildings, *buildingTypes));
 	mUniforms.modelMatrix = new osg::Uniform("modelMatrix", osg::Matrixf());
 	geode->setStateSet(createStateSet(program, buildingTypes->texture, mUniforms));
 	mTransform->addChild(geode);
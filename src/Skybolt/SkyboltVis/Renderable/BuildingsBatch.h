@@ -9,6 +9,8 @@
 #include "DefaultRootNode.h"
 #include "Shadow/ShadowHelpers.h"
 
+#include <osg/Geometry>
+
 namespace skybolt {
 namespace vis {
 
@@ -20,6 +22,10 @@ struct Building
 
 typedef std::vector<Building> Buildings;
 
+//! Creates geometry for buildings using the compact vertex format described in VertexQuantization.h.
+//! Texture coordinate z holds the texture array layer and w holds a per-building random seed.
+osg::ref_ptr<osg::Geometry> createBuildingsGeometry(const Buildings& buildings, const BuildingTypes& buildingTypes);
+
 class BuildingsBatch : public DefaultRootNode
 {
 public:
@@ -6,6 +6,10 @@
 
 #include "ForestGenerator.h"
 #include <SkyboltCommon/Math/MathUtility.h>
+#include <SkyboltCommon/Random.h>
+
+#include <array>
+#include <limits>
 
 std::vector<float> treeTypeHeights = {45, 45, 45};
 const float minTreeZ = -5.f; //!< Trees will not be generated below this world Z coordinate
@@ -13,15 +17,51 @@ const float minTreeZ = -5.f; //!< Trees will not be generated below this world Z
 namespace skybolt {
 namespace vis {
 
-ForestGenerator::ForestGenerator() :
-	random(0)
+//! Flat lookup table from attribute image value to attribute
+class ForestAttributeTable
+{
+public:
+	ForestAttributeTable(const ForestGenerator::Attributes& attributes)
+	{
+		mAttributes.fill(nullptr);
+		for (const auto& [value, attribute] : attributes)
+		{
+			// Image values are read as char, so attributes outside of char range can never match
+			if (value >= std::numeric_limits<char>::min() && value <= std::numeric_limits<char>::max())
+			{
+				mAttributes[std::uint8_t(char(value))] = &attribute;
+			}
+		}
+	}
+
+	const ForestGenerator::Attribute* find(char value) const
+	{
+		return mAttributes[std::uint8_t(value)];
+	}
+
+private:
+	std::array<const ForestGenerator::Attribute*, 256> mAttributes;
+};
+
+ForestGenerator::ForestGenerator(std::uint32_t seed) :
+	mSeed(seed)
 {
 }
 
-std::vector<BillboardForest::Tree> ForestGenerator::generate(const ElevationProvider& elevation, const AttributeImage& image, const Box2f& worldBounds, const Box2f& imageBounds)
+std::vector<BillboardForest::Tree> ForestGenerator::generate(const ElevationProvider& elevation, const AttributeImage& image, const Box2f& worldBounds, const Box2f& imageBounds) const
 {
-	std::vector<BillboardForest::Tree> result;
+	return generateRows(elevation, image, worldBounds, imageBounds, getRowRange(image, imageBounds));
+}
 
+IntRangeClosedOpen ForestGenerator::getRowRange(const AttributeImage& image, const Box2f& imageBounds)
+{
+	int yStart = std::max(0, (int)imageBounds.minimum.y());
+	int yEnd = std::min(image.height, (int)ceil(imageBounds.maximum.y()));
+	return IntRangeClosedOpen(yStart, std::max(yStart, yEnd));
+}
+
+std::vector<BillboardForest::Tree> ForestGenerator::generateRows(const ElevationProvider& elevation, const AttributeImage& image, const Box2f& worldBounds, const Box2f& imageBounds, const IntRangeClosedOpen& rowRange) const
+{
 	osg::Vec2f cellSize = worldBounds.maximum - worldBounds.minimum;
 	cellSize.x() /= imageBounds.maximum.y() - imageBounds.minimum.y();
 	cellSize.y() /= imageBounds.maximum.x() - imageBounds.minimum.x();
@@ -29,20 +69,25 @@ std::vector<BillboardForest::Tree> ForestGenerator::generate(const ElevationProv
 	osg::Vec2f offset(worldBounds.minimum.x() - cellSize.x() * imageBounds.minimum.y(),
 					  worldBounds.minimum.y() - cellSize.y() * imageBounds.minimum.x());
 
+	IntRangeClosedOpen boundsRowRange = getRowRange(image, imageBounds);
 	int xStart = std::max(0, (int)imageBounds.minimum.x());
-	int yStart = std::max(0, (int)imageBounds.minimum.y());
 	int xEnd = std::min(image.width, (int)ceil(imageBounds.maximum.x()));
-	int yEnd = std::min(image.height, (int)ceil(imageBounds.maximum.y()));
+	int yStart = std::max(boundsRowRange.first, rowRange.first);
+	int yEnd = std::min(boundsRowRange.last, rowRange.last);
 
+	ForestAttributeTable attributes(image.attributes);
+
+	// Place candidate trees. All random values for a tree are drawn up front from the cell's
+	// own random stream so that placement does not depend on elevation or on other cells.
+	std::vector<BillboardForest::Tree> candidates;
 	for (int y = yStart; y < yEnd; ++y)
 	{
 		for (int x = xStart; x < xEnd; ++x)
 		{
-			int attribute = image.data[4 * (x + y * image.width) + 3];
-			Attributes::const_iterator it = image.attributes.find(attribute);
-			if (it != image.attributes.end())
+			const Attribute* attr = attributes.find(image.data[4 * (x + y * image.width) + 3]);
+			if (attr)
 			{
-				const Attribute& attr = it->second;
+				FastRandom random(hashSeed(mSeed, std::uint32_t(x), std::uint32_t(y)));
 
 				float xMin = std::max(float(y), imageBounds.minimum.y()) * cellSize.x() + offset.x();
 				float yMin = std::max(float(x), imageBounds.minimum.x()) * cellSize.y() + offset.y();
@@ -51,7 +96,7 @@ std::vector<BillboardForest::Tree> ForestGenerator::generate(const ElevationProv
 
 				double area = (xMax - xMin) * (yMax - yMin);
 
-				float treeCountF = (double)attr.density * area;
+				float treeCountF = (double)attr->density * area;
 
 				// account for fractional trees
 				int treeCount = treeCountF;
@@ -64,20 +109,36 @@ std::vector<BillboardForest::Tree> ForestGenerator::generate(const ElevationProv
 					BillboardForest::Tree tree;
 					tree.position.x() = skybolt::math::lerp(xMin, xMax, random.unitRand()); // TODO: use a more uniformly spaced random number sequence
 					tree.position.y() = skybolt::math::lerp(yMin, yMax, random.unitRand());
-					tree.position.z() = elevation.get(tree.position.x(), tree.position.y());
-
-					if (tree.position.z() < minTreeZ)
-					{
-						tree.type = std::min((int)treeTypeHeights.size()-1, int(random.unitRand() * treeTypeHeights.size()));
-						tree.height = treeTypeHeights[tree.type] * skybolt::math::lerp(0.75f, 1.25f, random.unitRand());
-						tree.yaw = 2.f * osg::PI * random.unitRand();
-						result.push_back(tree);
-					}
+					tree.type = std::min((int)treeTypeHeights.size()-1, int(random.unitRand() * treeTypeHeights.size()));
+					tree.height = treeTypeHeights[tree.type] * skybolt::math::lerp(0.75f, 1.25f, random.unitRand());
+					tree.yaw = 2.f * osg::PI * random.unitRand();
+					candidates.push_back(tree);
 				}
 			}
 		}
 	}
 
+	// Sample elevation of all candidates in one batch
+	std::vector<osg::Vec2f> positions(candidates.size());
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		positions[i] = osg::Vec2f(candidates[i].position.x(), candidates[i].position.y());
+	}
+	std::vector<float> elevations(candidates.size());
+	elevation.getElevations(positions, elevations);
+
+	std::vector<BillboardForest::Tree> result;
+	result.reserve(candidates.size());
+	for (size_t i = 0; i < candidates.size(); ++i)
+	{
+		if (elevations[i] < minTreeZ)
+		{
+			BillboardForest::Tree& tree = candidates[i];
+			tree.position.z() = elevations[i];
+			result.push_back(tree);
+		}
+	}
+
 	return result;
 }
 
@@ -9,7 +9,8 @@
 #include "BillboardForest.h"
 #include "SkyboltVis/OsgBox2.h"
 #include "SkyboltVis/ElevationProvider/ElevationProvider.h"
-#include <SkyboltCommon/Random.h>
+#include <SkyboltCommon/Range.h>
+#include <cstdint>
 #include <osg/Vec2f>
 #include <osg/Vec3f>
 #include <osg/Array>
@@ -36,13 +37,24 @@ public:
 		Attributes attributes;
 	};
 
-	ForestGenerator();
+	//! @param seed is combined with the coordinates of each image cell to seed the placement of trees in that cell
+	ForestGenerator(std::uint32_t seed = 0);
 
 	//! @param imageBounds are inclusive
-	std::vector<BillboardForest::Tree> generate(const ElevationProvider& elevation, const AttributeImage& image, const Box2f& worldBounds, const Box2f& imageBounds);
+	std::vector<BillboardForest::Tree> generate(const ElevationProvider& elevation, const AttributeImage& image, const Box2f& worldBounds, const Box2f& imageBounds) const;
+
+	//! Generates trees for the image rows in rowRange, which should be a sub range of getRowRange().
+	//! Trees in each image cell are placed by a random stream seeded from the cell coordinates, so results
+	//! do not depend on generation order. Concatenating the results of consecutive row ranges gives the same
+	//! result as generate(), which allows a page to be split across multiple tasks.
+	//! Can be called from multiple threads concurrently.
+	std::vector<BillboardForest::Tree> generateRows(const ElevationProvider& elevation, const AttributeImage& image, const Box2f& worldBounds, const Box2f& imageBounds, const IntRangeClosedOpen& rowRange) const;
+
+	//! @returns the range of image rows overlapped by imageBounds
+	static IntRangeClosedOpen getRowRange(const AttributeImage& image, const Box2f& imageBounds);
 
 private:
-	skybolt::Random random;
+	const std::uint32_t mSeed;
 };
 
 } // namespace vis
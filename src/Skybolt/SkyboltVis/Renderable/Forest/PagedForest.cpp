@@ -14,6 +14,7 @@
 #include "SkyboltVis/Scene.h"
 #include "SkyboltVis/Shader/ShaderProgramRegistry.h"
 #include <SkyboltCommon/Math/MathUtility.h>
+#include <SkyboltCommon/Random.h>
 #include <osg/Geode>
 #include <atomic>
 #include <deque>
@@ -25,11 +26,23 @@ using namespace skybolt;
 namespace skybolt {
 namespace vis {
 
+//! Trees for a page are generated in chunks of image rows which can be processed by separate tasks.
+//! Chunks are concatenated in row order, so the result is independent of task scheduling.
+struct PageGenerationJob
+{
+	ForestGenerator::AttributeImage image;
+	Box2f worldBounds;
+	Box2f imageBounds;
+	std::uint32_t seed;
+	std::vector<IntRangeClosedOpen> chunkRowRanges;
+	std::vector<std::vector<BillboardForest::Tree>> chunkTrees; //!< Element i is written only by the task generating chunk i
+};
+
 class PageGeneratorTask
 {
 public:
 	PageGeneratorTask(const osg::ref_ptr<osg::Image>& attributeMap, const ShaderPrograms* programs,
-		const ElevationProviderPtr& elevationProvider, const Box2f& bounds, Vec2Transform converter, float visRangeWorldUnits, const osg::Vec2f pageSize) :
+		const ElevationProviderPtr& elevationProvider, const Box2f& bounds, Vec2ArrayTransform converter, float visRangeWorldUnits, const osg::Vec2f pageSize) :
 		mConverter(converter),
 		mAttributeMap(attributeMap),
 		mPrograms(programs),
@@ -40,20 +53,21 @@ public:
 	{
 	}
 
-	//! Can be called on multiple threads concurrently
-	osg::Group* run(const osg::Vec2i& pageId) const
+	std::shared_ptr<PageGenerationJob> createJob(const osg::Vec2i& pageId) const
 	{
-		ForestGenerator::AttributeImage image;
+		auto job = std::make_shared<PageGenerationJob>();
+
+		ForestGenerator::AttributeImage& image = job->image;
 		image.data = (char*)mAttributeMap->getDataPointer();
 		image.width = mAttributeMap->s();
 		image.height = mAttributeMap->t();
 
-		Box2f worldBounds;
+		Box2f& worldBounds = job->worldBounds;
 		worldBounds.minimum = mBounds.minimum + osg::Vec2f(pageId.x() * mPageSize.x(), pageId.y() * mPageSize.y());
 		worldBounds.maximum = worldBounds.minimum + mPageSize;
 		worldBounds.maximum = osg::Vec2f(std::min(worldBounds.maximum.x(), mBounds.maximum.x()), std::min(worldBounds.maximum.y(), mBounds.maximum.y()));
 
-		Box2f imageBounds = getSubImageBounds(mBounds, worldBounds, image.width, image.height);
+		job->imageBounds = getSubImageBounds(mBounds, worldBounds, image.width, image.height);
 
 		ForestGenerator::Attribute attribute;
 		const float treesPerSquareMeter = 0.01f;
@@ -61,24 +75,66 @@ public:
 		attribute.density = treesPerSquareMeter * radiusOfEarth * radiusOfEarth; // trees per sterradian
 		image.attributes[2] = attribute;
 
-		ForestGenerator generator;
-		std::vector<BillboardForest::Tree> trees = generator.generate(*mElevationProvider, image, worldBounds, imageBounds);
+		job->seed = hashSeed(std::uint32_t(pageId.x()), std::uint32_t(pageId.y()));
 
-		// Convert tree positions
-		for (BillboardForest::Tree& tree : trees)
+		IntRangeClosedOpen rowRange = ForestGenerator::getRowRange(image, job->imageBounds);
+		for (int row = rowRange.first; row < rowRange.last; row += rowsPerChunk)
 		{
-			osg::Vec2f pos = mConverter(osg::Vec2f(tree.position.x(), tree.position.y()));
-			tree.position.x() = pos.x();
-			tree.position.y() = pos.y();
+			job->chunkRowRanges.push_back(IntRangeClosedOpen(row, std::min(row + rowsPerChunk, rowRange.last)));
+		}
+		job->chunkTrees.resize(job->chunkRowRanges.size());
+		return job;
+	}
+
+	//! Can be called on multiple threads concurrently for different chunks
+	void generateChunk(PageGenerationJob& job, size_t chunkIndex) const
+	{
+		ForestGenerator generator(job.seed);
+		std::vector<BillboardForest::Tree> trees = generator.generateRows(*mElevationProvider, job.image, job.worldBounds, job.imageBounds, job.chunkRowRanges[chunkIndex]);
+
+		// Convert tree positions in one batch
+		std::vector<osg::Vec2f> positions(trees.size());
+		for (size_t i = 0; i < trees.size(); ++i)
+		{
+			positions[i] = osg::Vec2f(trees[i].position.x(), trees[i].position.y());
+		}
+
+		mConverter(positions);
+
+		for (size_t i = 0; i < trees.size(); ++i)
+		{
+			trees[i].position.x() = positions[i].x();
+			trees[i].position.y() = positions[i].y();
+		}
+
+		job.chunkTrees[chunkIndex] = std::move(trees);
+	}
+
+	//! Must be called after all chunks have been generated
+	osg::Group* createGroup(const PageGenerationJob& job) const
+	{
+		size_t treeCount = 0;
+		for (const auto& trees : job.chunkTrees)
+		{
+			treeCount += trees.size();
+		}
+
+		std::vector<BillboardForest::Tree> trees;
+		trees.reserve(treeCount);
+		for (const auto& chunkTrees : job.chunkTrees)
+		{
+			trees.insert(trees.end(), chunkTrees.begin(), chunkTrees.end());
 		}
 
 		osg::Group* group = new osg::Group;
-		BillboardForest::addGeodes(*group, trees, mPrograms->getRequiredProgram("treeSideBillboard"), mPrograms->getRequiredProgram("treeTopBillboard"), mVisRangeWorldUnits, worldBounds.size());
+		BillboardForest::addGeodes(*group, trees, mPrograms->getRequiredProgram("treeSideBillboard"), mPrograms->getRequiredProgram("treeTopBillboard"), mVisRangeWorldUnits, job.worldBounds.size());
 		return group;
 	}
 
 private:
-	const Vec2Transform mConverter;
+	static constexpr int rowsPerChunk = 8;
+
+	const Vec2ArrayTransform mConverter;
 	const osg::ref_ptr<osg::Image> mAttributeMap;
 	const ShaderPrograms* mPrograms;
 	const ElevationProviderPtr mElevationProvider;
@@ -89,7 +145,7 @@ private:
 
 PagedForest::PagedForest(px_sched::Scheduler& scheduler, const osg::ref_ptr<osg::Image>& attributeMap, const ShaderPrograms* programs,
 						 const ElevationProviderPtr& elevationProvider, const Box2f& bounds, const osg::Vec2f& maxPageSize,
-						 Vec2Transform converter, float visRangeWorldUnits) :
+						 Vec2ArrayTransform converter, float visRangeWorldUnits) :
 	mScheduler(scheduler),
 	mBounds(bounds),
 	mVisibilityRange(maxPageSize.x(), maxPageSize.y())
@@ -180,12 +236,24 @@ void PagedForest::asyncCreatePage(const osg::Vec2i& pageId)
 {
 	LoadingPagePtr page(new LoadingPage);
 	page->pageId = pageId;
+	page->job = mPageGeneratorTask->createJob(pageId);
 	mLoadingPageQueue.push_back(page);
 
-	mScheduler.run([=]() {
+	// Generate chunks of the page in parallel, then build the page's geometry once they have all finished
+	for (size_t i = 0; i < page->job->chunkRowRanges.size(); ++i)
+	{
+		mScheduler.run([=]() {
+			if (!page->cancel)
+			{
+				mPageGeneratorTask->generateChunk(*page->job, i);
+			}
+		}, &page->chunksGeneratedSync);
+	}
+
+	mScheduler.runAfter(page->chunksGeneratedSync, [=]() {
 		if (!page->cancel)
 		{
-			page->group = mPageGeneratorTask->run(page->pageId);
+			page->group = mPageGeneratorTask->createGroup(*page->job);
 		}
 	}, &mLoadingPageSync);
 }
@@ -13,18 +13,20 @@
 #include <osg/Image>
 #include <atomic>
 #include <functional>
+#include <span>
 
 namespace skybolt {
 namespace vis {
 
-typedef std::function<osg::Vec2f(const osg::Vec2f&)> Vec2Transform;
+//! Transforms an array of positions in place. Must be safe to call from multiple threads concurrently.
+typedef std::function<void(std::span<osg::Vec2f>)> Vec2ArrayTransform;
 
 class PagedForest : public DefaultRootNode
 {
 public:
 	PagedForest(px_sched::Scheduler& scheduler, const osg::ref_ptr<osg::Image>& attributeMap, const ShaderPrograms* programs,
 		        const ElevationProviderPtr& elevationProvider, const Box2f& bounds, const osg::Vec2f& maxPageSize,
-				Vec2Transform converter, float visRangeWorldUnits);
+				Vec2ArrayTransform converter, float visRangeWorldUnits);
 
 	~PagedForest();
 
@@ -54,6 +56,8 @@ private:
 	struct LoadingPage
 	{
 		osg::Vec2i pageId;
+		std::shared_ptr<struct PageGenerationJob> job;
+		px_sched::Sync chunksGeneratedSync; //!< Signalled when all chunks of the page's trees have been generated
 		osg::ref_ptr<osg::Group> group; // TODO: Ensure this is consistent across multiple threads
 		std::atomic<bool> cancel = false; //!< Signals the loading task to cancel
 	};
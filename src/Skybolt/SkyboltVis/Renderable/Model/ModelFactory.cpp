@@ -11,10 +11,14 @@
 #include "OsgStateSetHelpers.h"
 #include <SkyboltCommon/MapUtility.h>
 
+#include <osg/Geometry>
 #include <osg/Image>
 #include <osgDB/ReadFile>
+#include <boost/log/trivial.hpp>
 
 #include <assert.h>
+#include <atomic>
+#include <set>
 
 using namespace skybolt::vis;
 
@@ -184,49 +188,347 @@ private:
 	osg::ref_ptr<osg::Program> mGlassProgram;
 };
 
+namespace skybolt {
+namespace vis {
+
+struct PendingModelLoad
+{
+	osg::ref_ptr<osg::Node> node; //!< Null if loading failed. Must only be read once complete is true.
+	std::atomic<bool> complete = false;
+};
+
+} // namespace vis
+} // namespace skybolt
+
+class ModelProxyUpdateCallback : public osg::NodeCallback
+{
+public:
+	void operator()(osg::Node* node, osg::NodeVisitor* nv) override
+	{
+		ModelProxy* proxy = static_cast<ModelProxy*>(node);
+		proxy->update();
+		if (proxy->isLoadComplete())
+		{
+			// Proxy no longer needs updating. Keep this callback alive until it returns.
+			osg::ref_ptr<osg::Callback> self = this;
+			proxy->setUpdateCallback(nullptr);
+		}
+		traverse(node, nv);
+	}
+};
+
+ModelProxy::ModelProxy(const std::shared_ptr<PendingModelLoad>& load) :
+	mLoad(load)
+{
+	assert(mLoad);
+	update();
+	if (!isLoadComplete())
+	{
+		setUpdateCallback(new ModelProxyUpdateCallback);
+	}
+}
+
+bool ModelProxy::isLoadComplete() const
+{
+	return !mLoad || mLoad->complete;
+}
+
+void ModelProxy::update()
+{
+	if (mLoad && mLoad->complete)
+	{
+		if (mLoad->node)
+		{
+			addChild(mLoad->node);
+		}
+		mLoad.reset();
+	}
+}
+
+class ModelMemoryEstimator : public StateSetVisitor
+{
+public:
+	void apply(osg::Drawable& drawable) override
+	{
+		if (osg::Geometry* geometry = drawable.asGeometry(); geometry)
+		{
+			addArray(geometry->getVertexArray());
+			addArray(geometry->getNormalArray());
+			addArray(geometry->getColorArray());
+			for (const auto& array : geometry->getTexCoordArrayList())
+			{
+				addArray(array.get());
+			}
+			for (const auto& array : geometry->getVertexAttribArrayList())
+			{
+				addArray(array.get());
+			}
+			for (const auto& primitiveSet : geometry->getPrimitiveSetList())
+			{
+				if (mVisited.insert(primitiveSet.get()).second)
+				{
+					memoryBytes += primitiveSet->getTotalDataSize();
+				}
+			}
+		}
+		StateSetVisitor::apply(drawable);
+	}
+
+	using StateSetVisitor::apply;
+
+	void apply(osg::StateSet& stateSet) override
+	{
+		for (unsigned int unit = 0; unit < stateSet.getTextureAttributeList().size(); ++unit)
+		{
+			if (osg::Texture* texture = dynamic_cast<osg::Texture*>(stateSet.getTextureAttribute(unit, osg::StateAttribute::TEXTURE)); texture)
+			{
+				for (unsigned int i = 0; i < texture->getNumImages(); ++i)
+				{
+					const osg::Image* image = texture->getImage(i);
+					if (image && mVisited.insert(image).second)
+					{
+						memoryBytes += image->getTotalSizeInBytesIncludingMipmaps();
+					}
+				}
+			}
+		}
+	}
+
+	size_t memoryBytes = 0;
+
+private:
+	void addArray(const osg::Array* array)
+	{
+		if (array && mVisited.insert(array).second)
+		{
+			memoryBytes += array->getTotalDataSize();
+		}
+	}
+
+	std::set<const osg::Referenced*> mVisited;
+};
+
+size_t skybolt::vis::estimateModelMemoryBytes(osg::Node& node)
+{
+	ModelMemoryEstimator estimator;
+	node.accept(estimator);
+	return estimator.memoryBytes;
+}
+
 ModelFactory::ModelFactory(const ModelFactoryConfig &config) :
 	mStateSetModifiers(config.stateSetModifiers),
 	mDefaultProgram(config.defaultProgram),
-	mGlassProgram(config.glassProgram)
+	mGlassProgram(config.glassProgram),
+	mScheduler(config.scheduler),
+	mCacheMemoryBudgetBytes(config.cacheMemoryBudgetBytes)
 {
 	assert(mDefaultProgram);
 	assert(mGlassProgram);
 }
 
+ModelFactory::~ModelFactory()
+{
+	waitForLoads();
+}
+
 osg::ref_ptr<osg::Node> ModelFactory::createModel(const std::string& filename, const std::vector<TextureRole>& textureRoles)
 {
-	static std::map<std::string, osg::ref_ptr<osg::Node>> modelCache;
-	auto it = modelCache.find(filename);
-	if (it == modelCache.end())
+	CacheKey key{filename, textureRoles};
 	{
-		osg::ref_ptr<osg::Node> model = osgDB::readNodeFile(filename);
-		if (!model)
+		std::scoped_lock<std::mutex> lock(mCacheMutex);
+		if (osg::ref_ptr<osg::Node> model = findCachedModel(key); model)
 		{
-			throw skybolt::Exception("Could not load OSG model: " + filename);
+			++mStats.hitCount;
+			return model;
 		}
+		++mStats.missCount;
+	}
+
+	osg::ref_ptr<osg::Node> model = loadModel(filename, textureRoles);
+
+	std::scoped_lock<std::mutex> lock(mCacheMutex);
+	// Another thread may have loaded the same model while we were loading it
+	if (osg::ref_ptr<osg::Node> cachedModel = findCachedModel(key); cachedModel)
+	{
+		return cachedModel;
+	}
+	addToCache(key, model);
+	return model;
+}
+
+osg::ref_ptr<ModelProxy> ModelFactory::createModelAsync(const std::string& filename, const std::vector<TextureRole>& textureRoles)
+{
+	if (!mScheduler)
+	{
+		auto load = std::make_shared<PendingModelLoad>();
+		load->node = createModel(filename, textureRoles);
+		load->complete = true;
+		return new ModelProxy(load);
+	}
+
+	CacheKey key{filename, textureRoles};
+	std::scoped_lock<std::mutex> lock(mCacheMutex);
+	if (osg::ref_ptr<osg::Node> model = findCachedModel(key); model)
+	{
+		++mStats.hitCount;
+		auto load = std::make_shared<PendingModelLoad>();
+		load->node = model;
+		load->complete = true;
+		return new ModelProxy(load);
+	}
+	++mStats.missCount;
+	return new ModelProxy(getOrStartLoad(key));
+}
+
+void ModelFactory::prefetchModel(const std::string& filename, const std::vector<TextureRole>& textureRoles)
+{
+	if (!mScheduler)
+	{
+		return;
+	}
+
+	CacheKey key{filename, textureRoles};
+	std::scoped_lock<std::mutex> lock(mCacheMutex);
+	if (mCache.find(key) == mCache.end())
+	{
+		getOrStartLoad(key);
+	}
+}
+
+void ModelFactory::waitForLoads()
+{
+	if (mScheduler)
+	{
+		mScheduler->waitFor(mLoadingTaskSync);
+	}
+}
+
+void ModelFactory::trimCache()
+{
+	std::scoped_lock<std::mutex> lock(mCacheMutex);
+	trimCacheLocked();
+}
+
+ModelCacheStats ModelFactory::getCacheStats() const
+{
+	std::scoped_lock<std::mutex> lock(mCacheMutex);
+	ModelCacheStats stats = mStats;
+	stats.modelCount = mCache.size();
+	stats.memoryBytes = mCacheMemoryBytes;
+	stats.pendingLoadCount = mPendingLoads.size();
+	return stats;
+}
+
+osg::ref_ptr<osg::Node> ModelFactory::loadModel(const std::string& filename, const std::vector<TextureRole>& textureRoles) const
+{
+	osg::ref_ptr<osg::Node> model = osgDB::readNodeFile(filename);
+	if (!model)
+	{
+		throw skybolt::Exception("Could not load OSG model: " + filename);
+	}
+
+	TexturePreparer modifier(textureRoles);
+	model->accept(modifier);
+
+	{
+		ModelPreparerConfig config;
+		config.generateTangents = modifier.hasNormalMap;
+		ModelPreparer preparer(config);
+		model->accept(preparer);
+	}
 
-		TexturePreparer modifier(textureRoles);
+	{
+		MaterialShaderAssignmentsModifier modifier(mStateSetModifiers, mGlassProgram);
 		model->accept(modifier);
+	}
+
+	model->getOrCreateStateSet()->setAttribute(mDefaultProgram); // set default program at top level
+	return model;
+}
+
+osg::ref_ptr<osg::Node> ModelFactory::findCachedModel(const CacheKey& key)
+{
+	auto it = mCache.find(key);
+	if (it == mCache.end())
+	{
+		return nullptr;
+	}
+	it->second.lastUsedTick = ++mTick;
+	return it->second.node;
+}
 
+void ModelFactory::addToCache(const CacheKey& key, const osg::ref_ptr<osg::Node>& node)
+{
+	CacheEntry entry;
+	entry.node = node;
+	entry.memoryBytes = estimateModelMemoryBytes(*node);
+	entry.lastUsedTick = ++mTick;
+
+	mCacheMemoryBytes += entry.memoryBytes;
+	mCache[key] = entry;
+
+	trimCacheLocked();
+}
+
+void ModelFactory::trimCacheLocked()
+{
+	while (mCacheMemoryBytes > mCacheMemoryBudgetBytes)
+	{
+		// Find least recently used model which is only referenced by the cache
+		auto evictionCandidate = mCache.end();
+		for (auto it = mCache.begin(); it != mCache.end(); ++it)
 		{
-			ModelPreparerConfig config;
-			config.generateTangents = modifier.hasNormalMap;
-			ModelPreparer preparer(config);
-			model->accept(preparer);
+			if (it->second.node->referenceCount() == 1
+				&& (evictionCandidate == mCache.end() || it->second.lastUsedTick < evictionCandidate->second.lastUsedTick))
+			{
+				evictionCandidate = it;
+			}
 		}
 
+		if (evictionCandidate == mCache.end())
 		{
-			MaterialShaderAssignmentsModifier modifier(mStateSetModifiers, mGlassProgram);
-			model->accept(modifier);
+			return; // All models are in use
 		}
 
-		model->getOrCreateStateSet()->setAttribute(mDefaultProgram); // set default program at top level
-
-		modelCache[filename] = model;
-		return model;
+		mCacheMemoryBytes -= evictionCandidate->second.memoryBytes;
+		mCache.erase(evictionCandidate);
+		++mStats.evictionCount;
 	}
-	else
+}
+
+std::shared_ptr<PendingModelLoad> ModelFactory::getOrStartLoad(const CacheKey& key)
+{
+	if (auto it = mPendingLoads.find(key); it != mPendingLoads.end())
 	{
 		return it->second;
 	}
-}
\ No newline at end of file
+
+	auto load = std::make_shared<PendingModelLoad>();
+	mPendingLoads[key] = load;
+
+	mScheduler->run([this, key, load] {
+		osg::ref_ptr<osg::Node> model;
+		try
+		{
+			model = loadModel(key.filename, key.textureRoles);
+		}
+		catch (const std::exception& e)
+		{
+			BOOST_LOG_TRIVIAL(error) << e.what();
+		}
+
+		{
+			std::scoped_lock<std::mutex> lock(mCacheMutex);
+			if (model)
+			{
+				addToCache(key, model);
+			}
+			mPendingLoads.erase(key);
+		}
+
+		load->node = model;
+		load->complete = true;
+	}, &mLoadingTaskSync);
+
+	return load;
+}
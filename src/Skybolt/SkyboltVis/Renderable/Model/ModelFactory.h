@@ -8,9 +8,16 @@
 #pragma once
 
 #include "SkyboltVis/DefaultRootNode.h"
+#include <osg/Group>
 #include <osg/Material>
 #include <osg/Program>
+#include <px_sched/px_sched.h>
+#include <cstdint>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
 
 namespace skybolt {
 namespace vis {
@@ -23,12 +30,47 @@ struct ModelFactoryConfig
 	NamedStateSetModifiers stateSetModifiers;
 	osg::ref_ptr<osg::Program> defaultProgram;
 	osg::ref_ptr<osg::Program> glassProgram;
+	px_sched::Scheduler* scheduler = nullptr; //!< Used to load models asynchronously. If null, models are loaded on the calling thread.
+	size_t cacheMemoryBudgetBytes = 512 * 1024 * 1024; //!< Models not used by the scene are evicted from the cache when the budget is exceeded
+};
+
+struct PendingModelLoad;
+
+//! Placeholder node returned for an asynchronously loaded model.
+//! The loaded model is added as a child during the first update traversal after loading completes.
+class ModelProxy : public osg::Group
+{
+public:
+	ModelProxy(const std::shared_ptr<PendingModelLoad>& load);
+
+	//! @returns true if loading has finished, successfully or not
+	bool isLoadComplete() const;
+
+	//! @returns true if the loaded model has been added to the proxy
+	bool isModelAttached() const { return getNumChildren() > 0; }
+
+	//! Attaches the loaded model if loading has completed. Called automatically during update traversal.
+	void update();
+
+private:
+	std::shared_ptr<PendingModelLoad> mLoad;
+};
+
+struct ModelCacheStats
+{
+	size_t modelCount = 0;
+	size_t memoryBytes = 0;
+	size_t pendingLoadCount = 0;
+	size_t hitCount = 0;
+	size_t missCount = 0;
+	size_t evictionCount = 0;
 };
 
 class ModelFactory : public DefaultRootNode
 {
 public:
 	ModelFactory(const ModelFactoryConfig &config);
+	~ModelFactory() override;
 	
 	enum class TextureRole
 {
@@ -37,13 +79,77 @@ public:
 	OcclusionRoughnessMetalness
 };
 
+	//! Loads and prepares a model on the calling thread, or returns the cached model if it has already been loaded.
+	//! @throws skybolt::Exception if the model could not be loaded
 	osg::ref_ptr<osg::Node> createModel(const std::string& filename, const std::vector<TextureRole>& textureRoles);
 
+	//! Returns a proxy immediately, and loads the model on the scheduler if it is not already cached.
+	//! The proxy is populated with the model once loading completes. Falls back to synchronous loading if there is no scheduler.
+	osg::ref_ptr<ModelProxy> createModelAsync(const std::string& filename, const std::vector<TextureRole>& textureRoles);
+
+	//! Starts loading a model into the cache, if it is not already cached or loading, so that later requests for it are fast.
+	void prefetchModel(const std::string& filename, const std::vector<TextureRole>& textureRoles);
+
+	//! Blocks until all pending asynchronous loads have completed
+	void waitForLoads();
+
+	//! Evicts least recently used models that are not referenced outside the cache until the cache is within its memory budget
+	void trimCache();
+
+	ModelCacheStats getCacheStats() const;
+
+private:
+	struct CacheKey
+	{
+		std::string filename;
+		std::vector<TextureRole> textureRoles;
+
+		bool operator<(const CacheKey& other) const
+		{
+			return std::tie(filename, textureRoles) < std::tie(other.filename, other.textureRoles);
+		}
+	};
+
+	struct CacheEntry
+	{
+		osg::ref_ptr<osg::Node> node;
+		size_t memoryBytes;
+		std::uint64_t lastUsedTick;
+	};
+
+	//! Loads and prepares a model. Thread safe.
+	osg::ref_ptr<osg::Node> loadModel(const std::string& filename, const std::vector<TextureRole>& textureRoles) const;
+
+	//! Must be called with mCacheMutex locked
+	osg::ref_ptr<osg::Node> findCachedModel(const CacheKey& key);
+
+	//! Must be called with mCacheMutex locked
+	void addToCache(const CacheKey& key, const osg::ref_ptr<osg::Node>& node);
+
+	//! Must be called with mCacheMutex locked
+	void trimCacheLocked();
+
+	//! @returns the pending load for the key, starting a new load if required. Must be called with mCacheMutex locked.
+	std::shared_ptr<PendingModelLoad> getOrStartLoad(const CacheKey& key);
+
 private:
 	NamedStateSetModifiers mStateSetModifiers;
 	osg::ref_ptr<osg::Program> mDefaultProgram;
 	osg::ref_ptr<osg::Program> mGlassProgram;
+	px_sched::Scheduler* mScheduler;
+	px_sched::Sync mLoadingTaskSync;
+	size_t mCacheMemoryBudgetBytes;
+
+	mutable std::mutex mCacheMutex;
+	std::map<CacheKey, CacheEntry> mCache;
+	std::map<CacheKey, std::shared_ptr<PendingModelLoad>> mPendingLoads;
+	size_t mCacheMemoryBytes = 0;
+	std::uint64_t mTick = 0;
+	ModelCacheStats mStats;
 };
 
+//! @returns an estimate of the memory used by the geometry and images in a node's subgraph
+size_t estimateModelMemoryBytes(osg::Node& node);
+
 } // namespace vis
 } // namespace skybolt
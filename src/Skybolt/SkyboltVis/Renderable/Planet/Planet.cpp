@@ -464,11 +464,19 @@ void Planet::updatePreRender(const CameraRenderContext& context)
 	}
 
 	double julianDateSeconds = mJulianDate * 24.0 * 60.0 * 60.0;
-	// Move clouds
+	// Move clouds by integrating wind velocity over time
 	{
-		float windSpeed = 10.0;
-		osg::Vec2 displacement(0.0, -20000 + std::fmod(julianDateSeconds, 40000) * windSpeed);
-		mCloudDisplacementMetersUniform->set(displacement);
+		double dt = mPrevCloudUpdateJulianDateSeconds ? julianDateSeconds - *mPrevCloudUpdateJulianDateSeconds : 0.0;
+		mPrevCloudUpdateJulianDateSeconds = julianDateSeconds;
+		mCloudDisplacement += osg::Vec2d(mCloudWindVelocity) * dt;
+
+		// Wrap displacement to keep it small enough to represent precisely as a float in the shader
+		constexpr double wrapDistance = 400000;
+		mCloudDisplacement.x() = std::fmod(mCloudDisplacement.x(), wrapDistance);
+		mCloudDisplacement.y() = std::fmod(mCloudDisplacement.y(), wrapDistance);
+
+		// The shader offsets the cloud sample position, so negate displacement to move clouds downwind
+		mCloudDisplacementMetersUniform->set(osg::Vec2f(-mCloudDisplacement));
 	}
 
 	if (mReflectionCameraController)
@@ -478,6 +486,14 @@ void Planet::updatePreRender(const CameraRenderContext& context)
 
 	if (mWaterMaterial)
 	{
+		// The sim samples the ocean surface even when the ocean is not being updated, so always update the frame
+		WaveTextureFrame frame;
+		frame.planetRadius = mInnerRadius;
+		frame.planetPosition = position;
+		frame.planetOrientation = getOrientation();
+		frame.wrappedNoiseOrigin = mScene->getWrappedNoiseOrigin();
+		mWaterMaterial->setWaveTextureFrame(frame);
+
 		double altitude = (getPosition() - context.camera.getPosition()).length() - mInnerRadius;
 		if (altitude < 40000) // TODO: ensure this value matches oceanMeshFadeoutEndDistance in Ocean.h shader file
 		{
@@ -101,6 +101,10 @@ public:
 	void setCloudCoverageFraction(std::optional<float> cloudCoverageFraction);
 	std::optional<float> getCloudCoverageFraction() const { return mCloudCoverageFraction; }
 
+	//! Sets the velocity at which clouds drift, in north-east axes and m/s
+	void setCloudWindVelocity(const osg::Vec2f& velocityNorthEast) { mCloudWindVelocity = velocityNorthEast; }
+	osg::Vec2f getCloudWindVelocity() const { return mCloudWindVelocity; }
+
 	float calcAtmosphericDensity(const osg::Vec3f& position) const;
 
 	double getInnerRadius() const { return mInnerRadius; }
@@ -144,6 +148,9 @@ private:
 	osg::Uniform* mCloudDisplacementMetersUniform;
 	osg::Uniform* mCloudCoverageFractionUniform;
 	std::optional<float> mCloudCoverageFraction;
+	osg::Vec2f mCloudWindVelocity = osg::Vec2f(0, -10); //!< Default gives the same drift as previous releases
+	osg::Vec2d mCloudDisplacement = osg::Vec2d(0, 0); //!< Distance clouds have drifted, in north-east axes
+	std::optional<double> mPrevCloudUpdateJulianDateSeconds;
 
 	bool mCloudsVisible = false;
 };
@@ -145,9 +145,7 @@ bool PlanetSurface::updateGeometry()
 		const PlanetTileImages& images = static_cast<const PlanetTileImages&>(*tile);
 
 		auto textureTiles = mTileTexturesProvider(images);
-		auto bounds = getKeyLonLatBounds<osg::Vec2d>(key);
-		Box2d latLonBounds(math::vec2SwapComponents(bounds.minimum), math::vec2SwapComponents(bounds.maximum));
-		OsgTile osgTile = mOsgTileFactory->createOsgTile(key, latLonBounds, textureTiles);
+		OsgTile osgTile = mOsgTileFactory->createOsgTile(key, images.vertices, textureTiles);
 
 		mGroup->addChild(osgTile.transform);
 		mTileNodes[key] = osgTile;
@@ -166,6 +164,35 @@ bool PlanetSurface::updateGeometry()
 	return !mightNeedToLoadNextUpdate && !mTileSource->isLoading();
 }
 
+//! @returns the side planes of the camera's view frustum in the planet's coordinate space
+static osg::Polytope createPlanetSpaceViewFrustum(const Camera& camera, const osg::Matrix& planetMatrix)
+{
+	// Near and far planes are omitted because tiles are culled by distance by the subdivision predicate
+	osg::Polytope frustum;
+	frustum.setToUnitFrustum(/* withNear */ false, /* withFar */ false);
+	frustum.transformProvidingInverse(planetMatrix * camera.getViewMatrix() * camera.getProjectionMatrix());
+	return frustum;
+}
+
+void PlanetSurface::setPrefetchObserverPositions(const std::vector<osg::Vec3d>& positions)
+{
+	osg::Matrix worldToPlanet = osg::Matrix::inverse(mParentTransform->getMatrix());
+
+	mPrefetchPredicates.resize(positions.size());
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		auto& predicate = mPrefetchPredicates[i];
+		if (!predicate)
+		{
+			predicate = std::make_shared<PlanetSubdivisionPredicate>(*mPredicate);
+			predicate->viewFrustum = std::nullopt;
+		}
+		geocentricToLla(positions[i] * worldToPlanet, predicate->observerLatLon, predicate->observerAltitude, predicate->planetRadius);
+	}
+
+	mTileSource->setPrefetchPredicates(std::vector<QuadTreeSubdivisionPredicatePtr>(mPrefetchPredicates.begin(), mPrefetchPredicates.end()));
+}
+
 static sim::LatLon toLatLon(const osg::Vec2d& latLon)
 {
 	return sim::LatLon(latLon.x(), latLon.y());
@@ -188,6 +215,7 @@ void PlanetSurface::updatePreRender(const CameraRenderContext& context)
 #endif
 
 	geocentricToLla(geocentricPos, mPredicate->observerLatLon, mPredicate->observerAltitude, mPredicate->planetRadius);
+	mPredicate->viewFrustum = createPlanetSpaceViewFrustum(context.camera, mParentTransform->getMatrix());
 
 	bool loadingComplete = updateGeometry();
 
@@ -69,6 +69,14 @@ public:
 
 	skybolt::Listenable<QuadTreeTileLoaderListener>* getTileLoaderListenable() const { return mTileSource.get(); }
 
+	//! Sets world space positions from which the observer is predicted to view the surface in future,
+	//! for example positions sampled along a camera's path. Tiles needed at these positions are prefetched
+	//! at lower priority than visible tiles. View direction is not predicted, so tiles are prefetched in all directions.
+	void setPrefetchObserverPositions(const std::vector<osg::Vec3d>& positions);
+
+	void setPrefetchConfig(const TilePrefetchConfig& config) { mTileSource->setPrefetchConfig(config); }
+	TilePrefetchStats getPrefetchStats() const { return mTileSource->getPrefetchStats(); }
+
 	const osg::ref_ptr<osg::Group>& getGroup() const { return mGroup; }
 
 private:
@@ -79,6 +87,7 @@ private:
 	std::function<OsgTileFactory::TileTextures(const struct PlanetTileImages&)> mTileTexturesProvider;
 	std::shared_ptr<OsgTileFactory> mOsgTileFactory;
 	std::shared_ptr<struct PlanetSubdivisionPredicate> mPredicate;
+	std::vector<std::shared_ptr<struct PlanetSubdivisionPredicate>> mPrefetchPredicates;
 	GpuForestPtr mGpuForest;
 
 	osg::ref_ptr<osg::MatrixTransform> mParentTransform;
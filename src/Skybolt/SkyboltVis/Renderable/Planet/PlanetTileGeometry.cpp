@@ -17,67 +17,117 @@ using namespace skybolt;
 namespace skybolt {
 namespace vis {
 
-osg::ref_ptr<osg::Geometry> createPlanetTileGeometry(const osg::Vec3d& tileCenter, const Box2d& latLonBounds,
-	double radius, float skirtLength, PrimitiveType type)
+static constexpr int segmentCountX = 64;
+static constexpr int segmentCountY = 64;
+static constexpr int vertexCountX = segmentCountX + 1;
+static constexpr int vertexCountY = segmentCountY + 1;
+
+//! @returns texture coordinate of a grid vertex. Edge vertices form a skirt, and have the same texture coordinates as their inner neighbors.
+static osg::Vec2f getGridUv(int x, int y)
+{
+	constexpr int innerMaxX = segmentCountX - 2;
+	constexpr int innerMaxY = segmentCountY - 2;
+
+	return osg::Vec2f(
+		(float)math::clamp(x - 1, 0, innerMaxX) / (float)innerMaxX,
+		(float)math::clamp(y - 1, 0, innerMaxY) / (float)innerMaxY);
+}
+
+static bool isSkirtVertex(int x, int y)
+{
+	return x == 0 || x == segmentCountX || y == 0 || y == segmentCountY;
+}
+
+//! Buffers shared by all planet tiles with the same primitive type
+struct PlanetTileMeshTemplate
+{
+	osg::ref_ptr<osg::Vec2Array> uvs;
+	osg::ref_ptr<osg::DrawElementsUInt> primitiveSet;
+};
+
+static PlanetTileMeshTemplate createPlanetTileMeshTemplate(PrimitiveType type)
 {
 	osg::ref_ptr<osg::Vec3Array> posBuffer = new osg::Vec3Array();
 	osg::ref_ptr<osg::UIntArray> indexBuffer = new osg::UIntArray();
-	int segmentCountX = 64;
-	int segmentCountY = 64;
-
 	createPlaneBuffers(*posBuffer, *indexBuffer, osg::Vec2f(0,0), osg::Vec2f(1,1), segmentCountX, segmentCountY, type);
+	assert(posBuffer->size() == vertexCountX * vertexCountY);
 
-	osg::ref_ptr<osg::Vec2Array> uvBuffer = new osg::Vec2Array();
-	uvBuffer->resize(posBuffer->size());
+	PlanetTileMeshTemplate result;
+	result.uvs = new osg::Vec2Array();
+	result.uvs->reserve(vertexCountX * vertexCountY);
+	for (int y = 0; y < vertexCountY; ++y)
+	{
+		for (int x = 0; x < vertexCountX; ++x)
+		{
+			result.uvs->push_back(getGridUv(x, y));
+		}
+	}
 
-	int countX = segmentCountX + 1;
-	int countY = segmentCountY + 1;
-	int innerMaxX = segmentCountX - 2;
-	int innerMaxY = segmentCountY - 2;
+	// Take the primitive set from a temporary geometry so that the primitive mode matches other geometry created from plane buffers
+	osg::ref_ptr<osg::Geometry> geometry = createPrimitiveFromBuffers(posBuffer, indexBuffer, type);
+	result.primitiveSet = static_cast<osg::DrawElementsUInt*>(geometry->getPrimitiveSet(0));
+	return result;
+}
 
-	osg::BoundingBoxf bounds;
+static const PlanetTileMeshTemplate& getPlanetTileMeshTemplate(PrimitiveType type)
+{
+	// Function local statics are initialized thread-safely
+	static PlanetTileMeshTemplate triangles = createPlanetTileMeshTemplate(Triangles);
+	static PlanetTileMeshTemplate quads = createPlanetTileMeshTemplate(Quads);
+	return (type == Quads) ? quads : triangles;
+}
+
+PlanetTileVertices createPlanetTileVertices(const Box2d& latLonBounds, double planetRadius, const HeightMapElevationBounds& elevationBounds)
+{
+	PlanetTileVertices result;
+	result.tileCenter = llaToGeocentric(latLonBounds.center(), 0, planetRadius);
+	result.positions = new osg::Vec3Array(vertexCountX * vertexCountY);
+
+	double skirtLength = 0.005 * latLonBounds.size().length() * planetRadius; // TODO: tweak
+
+	// Sea level is included because areas below sea level may be covered by ocean
+	double minAltitude = std::min(0.0, double(elevationBounds.x()));
+	double maxAltitude = std::max(0.0, double(elevationBounds.y()));
 
 	size_t i = 0;
-	for (int y = 0; y < countY; ++y)
+	for (int y = 0; y < vertexCountY; ++y)
 	{
-		for (int x = 0; x < countX; ++x)
+		for (int x = 0; x < vertexCountX; ++x)
 		{
-			bool skirt = (x == 0 || x == segmentCountX || y == 0 || y == segmentCountY);
-			osg::Vec2f uv;
-			uv.x() = (float)math::clamp(x - 1, 0, innerMaxX) / (float)innerMaxX;
-			uv.y() = (float)math::clamp(y - 1, 0, innerMaxY) / (float)innerMaxY;
-
+			osg::Vec2f uv = getGridUv(x, y);
 			osg::Vec2d latLon = latLonBounds.getPointFromNormalizedCoord(math::vec2SwapComponents(uv));
 
-			double effectiveRadius = skirt ? (radius - double(skirtLength)) : radius;
-			osg::Vec3f pos = llaToGeocentric(latLon, 0, effectiveRadius) - tileCenter;
-			posBuffer->at(i) = pos;
-			uvBuffer->at(i) = uv;
-			++i;
-
-			// Add point to bounding box, with some vertical padding to ensure vertical bounds are large enough to account for height in heightmap.
-			// TODO: use actual tile vertical bounds.
-			pos = llaToGeocentric(latLon, 0, radius - 9000) - tileCenter; // lowest point
-			bounds.expandBy(pos);
-			pos = llaToGeocentric(latLon, 0, radius + 9000) - tileCenter; // highest point
-			bounds.expandBy(pos);
+			double effectiveRadius = isSkirtVertex(x, y) ? (planetRadius - skirtLength) : planetRadius;
+			(*result.positions)[i++] = llaToGeocentric(latLon, 0, effectiveRadius) - result.tileCenter;
+
+			result.bounds.expandBy(llaToGeocentric(latLon, minAltitude, planetRadius) - result.tileCenter);
+			result.bounds.expandBy(llaToGeocentric(latLon, maxAltitude, planetRadius) - result.tileCenter);
 		}
 	}
 
-	osg::ref_ptr<osg::Geometry> geometry = createPrimitiveFromBuffers(posBuffer, indexBuffer, type);
-	geometry->setTexCoordArray(0, uvBuffer);
-	geometry->setComputeBoundingBoxCallback(createFixedBoundingBoxCallback(bounds));
-	return geometry;
+	return result;
 }
 
-osg::ref_ptr<osg::Geode> createPlanetTileGeode(const osg::Vec3d& tileCenter, const Box2d& latLonBounds, double planetRadius, PrimitiveType type)
+osg::ref_ptr<osg::Geometry> createPlanetTileGeometry(const PlanetTileVertices& vertices, PrimitiveType type)
 {
-	float skirtLength = 0.005 * latLonBounds.size().length() * planetRadius; // TODO: tweak
-	osg::ref_ptr<osg::Geometry> geometry = createPlanetTileGeometry(tileCenter, latLonBounds, planetRadius, skirtLength, type);
+	assert(vertices.positions);
+	assert(vertices.positions->size() == vertexCountX * vertexCountY);
 
-	osg::ref_ptr<osg::Geode> geode = new osg::Geode;
-	geode->addDrawable(geometry);
+	const PlanetTileMeshTemplate& meshTemplate = getPlanetTileMeshTemplate(type);
+
+	osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry();
+	geometry->setVertexArray(vertices.positions);
+	geometry->setTexCoordArray(0, meshTemplate.uvs);
+	geometry->addPrimitiveSet(meshTemplate.primitiveSet);
+	configureDrawable(*geometry);
+	geometry->setComputeBoundingBoxCallback(createFixedBoundingBoxCallback(vertices.bounds));
+	return geometry;
+}
 
+osg::ref_ptr<osg::Geode> createPlanetTileGeode(const PlanetTileVertices& vertices, PrimitiveType type)
+{
+	osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+	geode->addDrawable(createPlanetTileGeometry(vertices, type));
 	return geode;
 }
 
@@ -8,6 +8,8 @@
 
 #include "SkyboltVis/OsgGeometryFactory.h"
 #include "SkyboltVis/OsgBox2.h"
+#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h"
+#include <osg/BoundingBox>
 #include <osg/Geometry>
 #include <osg/Vec2>
 #include <osg/Vec3>
@@ -15,10 +17,23 @@
 namespace skybolt {
 namespace vis {
 
-osg::ref_ptr<osg::Geometry> createPlanetTileGeometry(const osg::Vec3d& tileCenter, const Box2d& latLonBounds,
-	double radius, float skirtLength, PrimitiveType type);
+//! Per-tile part of a planet tile mesh.
+//! All tiles share the same grid template, so index and texture coordinate buffers are shared between tiles.
+struct PlanetTileVertices
+{
+	osg::Vec3d tileCenter;
+	osg::ref_ptr<osg::Vec3Array> positions; //!< Relative to tileCenter
+	osg::BoundingBoxf bounds; //!< Bounds of the terrain surface relative to tileCenter, including elevation
+};
 
-osg::ref_ptr<osg::Geode> createPlanetTileGeode(const osg::Vec3d& tileCenter, const Box2d& latLonBounds, double radius, PrimitiveType type);
+//! Creates the vertices of a planet tile. May be called from any thread.
+//! @param elevationBounds is the range of terrain elevations within the tile, used to calculate the tile's vertical bounds
+PlanetTileVertices createPlanetTileVertices(const Box2d& latLonBounds, double planetRadius, const HeightMapElevationBounds& elevationBounds);
+
+//! Creates planet tile geometry using the tile's vertices and index and texture coordinate buffers shared by all tiles
+osg::ref_ptr<osg::Geometry> createPlanetTileGeometry(const PlanetTileVertices& vertices, PrimitiveType type);
+
+osg::ref_ptr<osg::Geode> createPlanetTileGeode(const PlanetTileVertices& vertices, PrimitiveType type);
 
 } // namespace vis
 } // namespace skybolt
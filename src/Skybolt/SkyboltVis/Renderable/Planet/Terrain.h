@@ -9,6 +9,7 @@
 #include "SkyboltVis/DefaultRootNode.h"
 #include "SkyboltVis/OsgBox2.h"
 #include "SkyboltVis/SkyboltVisFwd.h"
+#include "SkyboltVis/Renderable/Planet/PlanetTileGeometry.h"
 #include "SkyboltVis/Shadow/ShadowHelpers.h"
 #include <osg/Texture2D>
 
@@ -54,8 +55,7 @@ struct TerrainConfig
 
 	struct PlanetTile : public Tile
 	{
-		Box2d latLonBounds;
-		float planetRadius;
+		PlanetTileVertices vertices;
 	};
 
 	std::shared_ptr<Tile> tile;
@@ -5,10 +5,15 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "HeightMapElevationBounds.h"
+#include "TileKeyHelpers.h"
+#include "SkyboltVis/OsgMathHelpers.h"
 
 #include <osg/Image>
 #include <osg/ValueObject>
 
+#include <algorithm>
+#include <assert.h>
+
 namespace skybolt {
 namespace vis {
 
@@ -37,5 +42,116 @@ void setHeightMapElevationBounds(osg::Image& image, const HeightMapElevationBoun
 	image.setUserValue("HeightMapElevationBounds", bounds);
 }
 
+HeightMapElevationBoundsPyramid::HeightMapElevationBoundsPyramid(const osg::Image& image, const HeightMapElevationRerange& rerange, int blockSize) :
+	mWidth(image.s()),
+	mHeight(image.t()),
+	mBlockSize(blockSize)
+{
+	assert(mWidth > 0 && mHeight > 0);
+	assert(mBlockSize > 0);
+
+	// Each block covers texels [i * blockSize, (i + 1) * blockSize] inclusive, so that blocks bound
+	// the elevations interpolated between the texels on either side of a block boundary.
+	Level level;
+	level.width = std::max(1, (mWidth - 1 + mBlockSize - 1) / mBlockSize);
+	level.height = std::max(1, (mHeight - 1 + mBlockSize - 1) / mBlockSize);
+	level.bounds.resize(level.width * level.height, emptyHeightMapElevationBounds());
+
+	const uint16_t* data = reinterpret_cast<const uint16_t*>(image.data());
+	for (int t = 0; t < mHeight; ++t)
+	{
+		int by0 = std::min(t / mBlockSize, level.height - 1);
+		int by1 = (t % mBlockSize == 0 && t > 0) ? t / mBlockSize - 1 : by0; // Boundary texels belong to blocks on both sides
+		for (int s = 0; s < mWidth; ++s)
+		{
+			float elevation = getElevationForColorValue(rerange, data[s + t * mWidth]);
+			int bx0 = std::min(s / mBlockSize, level.width - 1);
+			int bx1 = (s % mBlockSize == 0 && s > 0) ? s / mBlockSize - 1 : bx0;
+			for (int by = std::min(by0, by1); by <= std::max(by0, by1); ++by)
+			{
+				for (int bx = std::min(bx0, bx1); bx <= std::max(bx0, bx1); ++bx)
+				{
+					expand(level.bounds[bx + by * level.width], elevation);
+				}
+			}
+		}
+	}
+	mLevels.push_back(std::move(level));
+
+	// Merge 2x2 blocks of each level into the next level until one block remains
+	while (mLevels.back().width > 1 || mLevels.back().height > 1)
+	{
+		const Level& child = mLevels.back();
+		Level parent;
+		parent.width = (child.width + 1) / 2;
+		parent.height = (child.height + 1) / 2;
+		parent.bounds.resize(parent.width * parent.height, emptyHeightMapElevationBounds());
+		for (int y = 0; y < child.height; ++y)
+		{
+			for (int x = 0; x < child.width; ++x)
+			{
+				expand(parent.bounds[x / 2 + (y / 2) * parent.width], child.bounds[x + y * child.width]);
+			}
+		}
+		mLevels.push_back(std::move(parent));
+	}
+}
+
+HeightMapElevationBounds HeightMapElevationBoundsPyramid::getBounds(const osg::Vec2f& minimum, const osg::Vec2f& maximum) const
+{
+	const Level& finest = mLevels.front();
+	auto toBlock = [this] (float texel, int texelCount, int blockCount) {
+		texel = std::clamp(texel, 0.0f, float(texelCount - 1));
+		return std::min(int(texel) / mBlockSize, blockCount - 1);
+	};
+
+	int x0 = toBlock(minimum.x(), mWidth, finest.width);
+	int x1 = toBlock(maximum.x(), mWidth, finest.width);
+	int y0 = toBlock(minimum.y(), mHeight, finest.height);
+	int y1 = toBlock(maximum.y(), mHeight, finest.height);
+
+	// Visit at most 4x4 blocks at the coarsest level needed
+	size_t levelIndex = 0;
+	while ((x1 - x0) >= 4 || (y1 - y0) >= 4)
+	{
+		x0 /= 2; x1 /= 2; y0 /= 2; y1 /= 2;
+		++levelIndex;
+	}
+	assert(levelIndex < mLevels.size());
+
+	const Level& level = mLevels[levelIndex];
+	HeightMapElevationBounds result = emptyHeightMapElevationBounds();
+	for (int y = y0; y <= y1; ++y)
+	{
+		for (int x = x0; x <= x1; ++x)
+		{
+			expand(result, level.bounds[x + y * level.width]);
+		}
+	}
+	return result;
+}
+
+HeightMapElevationBounds HeightMapElevationBoundsPyramid::getBounds() const
+{
+	return mLevels.back().bounds.front();
+}
+
+HeightMapElevationBounds getHeightMapElevationBoundsWithinTile(const HeightMapElevationBoundsPyramid& pyramid, const QuadTreeTileKey& heightMapKey, const QuadTreeTileKey& key)
+{
+	if (key == heightMapKey)
+	{
+		return pyramid.getBounds();
+	}
+
+	osg::Vec2f scale, offset;
+	getTileTransformInParentSpace(key, heightMapKey.level, scale, offset);
+
+	osg::Vec2f size(pyramid.getWidth(), pyramid.getHeight());
+	osg::Vec2f padding(1, 1);
+	return pyramid.getBounds(
+		math::componentWiseMultiply(offset, size) - padding,
+		math::componentWiseMultiply(offset + scale, size) + padding);
+}
+
 } // namespace vis
 } // namespace skybolt
\ No newline at end of file
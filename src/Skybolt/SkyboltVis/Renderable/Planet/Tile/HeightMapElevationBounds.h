@@ -6,9 +6,12 @@
 
 #pragma once
 
+#include "HeightMapElevationRerange.h"
+#include <SkyboltCommon/Math/QuadTree.h>
 #include <osg/Vec2>
 #include <limits>
 #include <optional>
+#include <vector>
 
 namespace osg {
 class Image;
@@ -43,5 +46,41 @@ std::optional<HeightMapElevationBounds> getHeightMapElevationBounds(const osg::I
 HeightMapElevationBounds getRequiredHeightMapElevationBounds(const osg::Image& image);
 void setHeightMapElevationBounds(osg::Image& image, const HeightMapElevationBounds& bounds);
 
+//! Hierarchy of elevation bounds over square blocks of a 16 bit height map, finest blocks first.
+//! Allows the bounds of the elevations in a region of the height map to be found without visiting every texel in the region.
+class HeightMapElevationBoundsPyramid
+{
+public:
+	//! @param blockSize is the width of the finest blocks in texels
+	HeightMapElevationBoundsPyramid(const osg::Image& image, const HeightMapElevationRerange& rerange, int blockSize = 8);
+
+	//! @returns bounds of the elevations bilinearly interpolated from the height map within a rectangle in texel coordinates.
+	//! The rectangle is clamped to the height map.
+	HeightMapElevationBounds getBounds(const osg::Vec2f& minimum, const osg::Vec2f& maximum) const;
+
+	//! @returns bounds of all elevations in the height map
+	HeightMapElevationBounds getBounds() const;
+
+	int getWidth() const { return mWidth; }
+	int getHeight() const { return mHeight; }
+
+private:
+	struct Level
+	{
+		int width; //!< Number of blocks
+		int height; //!< Number of blocks
+		std::vector<HeightMapElevationBounds> bounds;
+	};
+
+	int mWidth;
+	int mHeight;
+	int mBlockSize;
+	std::vector<Level> mLevels;
+};
+
+//! @returns bounds of the elevations within a tile, where the height map belongs to the tile or one of its ancestors.
+//! The region is padded by one texel to allow for height maps with texels on tile edges or offset half a texel inside.
+HeightMapElevationBounds getHeightMapElevationBoundsWithinTile(const HeightMapElevationBoundsPyramid& pyramid, const skybolt::QuadTreeTileKey& heightMapKey, const skybolt::QuadTreeTileKey& key);
+
 } // namespace vis
 } // namespace skybolt
\ No newline at end of file
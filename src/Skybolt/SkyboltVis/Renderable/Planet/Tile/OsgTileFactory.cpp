@@ -34,7 +34,7 @@ OsgTileFactory::OsgTileFactory(const OsgTileFactoryConfig& config) :
 
 OsgTileFactory::~OsgTileFactory() = default;
 
-OsgTile OsgTileFactory::createOsgTile(const QuadTreeTileKey& key, const Box2d& latLonBounds, const TileTextures& textures) const
+OsgTile OsgTileFactory::createOsgTile(const QuadTreeTileKey& key, const PlanetTileVertices& vertices, const TileTextures& textures) const
 {
 	// Get heightmap for tile, and its scale and offset relative to the tile
 	osg::Vec2f heightImageScale, heightImageOffset;
@@ -52,12 +52,9 @@ OsgTile OsgTileFactory::createOsgTile(const QuadTreeTileKey& key, const Box2d& l
 	OsgTile result;
 
 	// Create terrain
-	osg::Vec2d centerLatLon = latLonBounds.center();
-	osg::Vec3d tilePosition = llaToGeocentric(centerLatLon, 0, mPlanetRadius);
-
 	result.transform = new osg::MatrixTransform;
 	osg::Matrix matrix;
-	matrix.setTrans(tilePosition);
+	matrix.setTrans(vertices.tileCenter);
 	result.transform->setMatrix(matrix);
 
 	result.modelMatrixUniform = new osg::Uniform("modelMatrix", osg::Matrixf());
@@ -75,8 +72,7 @@ OsgTile OsgTileFactory::createOsgTile(const QuadTreeTileKey& key, const Box2d& l
 	{
 		// High LOD terrain
 		std::shared_ptr<TerrainConfig::PlanetTile> planetTile(new TerrainConfig::PlanetTile);
-		planetTile->latLonBounds = latLonBounds;
-		planetTile->planetRadius = mPlanetRadius;
+		planetTile->vertices = vertices;
 
 		osg::Vec2f attributeImageScale, attributeImageOffset;
 		if (textures.attribute)
@@ -107,7 +103,7 @@ OsgTile OsgTileFactory::createOsgTile(const QuadTreeTileKey& key, const Box2d& l
 	else if (textures.albedo.texture)
 	{
 		// Low LOD terrain
-		osg::ref_ptr<osg::Geode> geode = createPlanetTileGeode(tilePosition, latLonBounds, mPlanetRadius, Triangles);
+		osg::ref_ptr<osg::Geode> geode = createPlanetTileGeode(vertices, Triangles);
 		result.transform->addChild(geode);
 
 		int unit = 0;
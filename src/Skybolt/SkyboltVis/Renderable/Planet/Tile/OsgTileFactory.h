@@ -9,6 +9,7 @@
 #include "OsgTile.h"
 #include "TileTexture.h"
 #include "SkyboltVis/SkyboltVisFwd.h"
+#include "SkyboltVis/Renderable/Planet/PlanetTileGeometry.h"
 #include "SkyboltVis/Renderable/Planet/Terrain.h"
 #include <SkyboltCommon/Math/QuadTree.h>
 
@@ -46,7 +47,8 @@ public:
 		std::optional<TileTexture> attribute;
 	};
 
-	OsgTile createOsgTile(const skybolt::QuadTreeTileKey& key, const Box2d& latLonBounds, const TileTextures& textures) const;
+	//! @param vertices are the tile's vertices, which may be created off the render thread with createPlanetTileVertices()
+	OsgTile createOsgTile(const skybolt::QuadTreeTileKey& key, const PlanetTileVertices& vertices, const TileTextures& textures) const;
 
 private:
 	double mPlanetRadius;
@@ -32,7 +32,7 @@ static bool hasAnyChildren(const std::vector<TileSourcePtr>& tileSources, const
 	return false;
 }
 
-bool PlanetSubdivisionPredicate::operator()(const Box2d& bounds, const QuadTreeTileKey& key, const TileImages& images)
+bool PlanetSubdivisionPredicate::operator()(const Box2d& bounds, const QuadTreeTileKey& key, const TileImages& images, bool currentlySubdivided)
 {
 	if (!hasAnyChildren(tileSources, key))
 	{
@@ -40,7 +40,7 @@ bool PlanetSubdivisionPredicate::operator()(const Box2d& bounds, const QuadTreeT
 	}
 
 	const auto& tileImages = static_cast<const PlanetTileImages&>(images);
-	std::optional<HeightMapElevationBounds> elevationBounds = getHeightMapElevationBounds(*tileImages.heightMapImage.image);
+	const std::optional<HeightMapElevationBounds>& elevationBounds = tileImages.heightMapElevationBounds;
 	if (!elevationBounds)
 	{
 		if (!mHasMissingElevationBoundsError)
@@ -53,6 +53,11 @@ bool PlanetSubdivisionPredicate::operator()(const Box2d& bounds, const QuadTreeT
 
 	Box2d latLonBounds(math::vec2SwapComponents(bounds.minimum), math::vec2SwapComponents(bounds.maximum));
 
+	if (!intersectsViewFrustum(latLonBounds, *elevationBounds, currentlySubdivided ? (1.0 + hysteresis) : 1.0))
+	{
+		return false;
+	}
+
 	osg::Vec2d latLon = nearestPointInSolidBox(observerLatLon, latLonBounds);
 	double altitude = std::clamp(observerAltitude, double(elevationBounds->x()), double(elevationBounds->y()));
 
@@ -68,18 +73,64 @@ bool PlanetSubdivisionPredicate::operator()(const Box2d& bounds, const QuadTreeT
 
 	tileNearestPointAtLowestAltitude.normalize();
 	float cosElevation = directionFromTileNearestPointAtLowestAltitudeToObserver * tileNearestPointAtLowestAltitude;
-	bool visible = (cosElevation > 0.0f);
 
-	if (visible)
+	// Tile is below the horizon if the observer is below the plane tangent to the planet at the tile's nearest point
+	bool aboveHorizon = (cosElevation > 0.0f);
+
+	if (aboveHorizon)
 	{
 		double tileSize = planetRadius / std::pow(2, key.level);
 		double projectedSize = tileSize / std::max(0.01, distanceToTileNearestPoint);
-		return projectedSize > glm::mix(0.4f, 0.1f, cosElevation); // TODO: tune
+		double threshold = glm::mix(0.4f, 0.1f, cosElevation); // TODO: tune
+		if (currentlySubdivided)
+		{
+			threshold *= (1.0 - hysteresis);
+		}
+		return projectedSize > threshold;
 	}
 
 	return false;
 }
 
+bool PlanetSubdivisionPredicate::intersectsViewFrustum(const Box2d& latLonBounds, const HeightMapElevationBounds& elevationBounds, double boundsScale) const
+{
+	if (!viewFrustum)
+	{
+		return true;
+	}
+
+	// Bound the tile surface with a box around a grid of sample points.
+	constexpr int samplesPerAxis = 3;
+	osg::Vec2d sampleSpacing = latLonBounds.size() / double(samplesPerAxis - 1);
+	double diagonalSpacing = sampleSpacing.length();
+	if (diagonalSpacing > math::halfPiD())
+	{
+		// Tile is too large to bound with the sample points, so treat it as visible
+		return true;
+	}
+
+	// The surface bulges outwards between sample points. Raise the upper sample points to account for this.
+	double bulge = (planetRadius + elevationBounds.y()) * (1.0 - std::cos(diagonalSpacing * 0.5));
+
+	osg::BoundingBoxd box;
+	for (int y = 0; y < samplesPerAxis; ++y)
+	{
+		for (int x = 0; x < samplesPerAxis; ++x)
+		{
+			osg::Vec2d latLon = latLonBounds.minimum + osg::Vec2d(sampleSpacing.x() * x, sampleSpacing.y() * y);
+			box.expandBy(llaToGeocentric(latLon, elevationBounds.x(), planetRadius));
+			box.expandBy(llaToGeocentric(latLon, elevationBounds.y() + bulge, planetRadius));
+		}
+	}
+
+	osg::Vec3d center = box.center();
+	osg::Vec3d halfSize = (box._max - box._min) * (0.5 * boundsScale);
+
+	// Polytope::contains() updates the polytope's mask state, so test against a copy
+	osg::Polytope frustum = *viewFrustum;
+	return frustum.contains(osg::BoundingBox(center - halfSize, center + halfSize));
+}
+
 osg::Vec2d PlanetSubdivisionPredicate::nearestPointInSolidBox(const osg::Vec2d& point, const Box2d& bounds) const
 {
 	// Handle longitude wrap around
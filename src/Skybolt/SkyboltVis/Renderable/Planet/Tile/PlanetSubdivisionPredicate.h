@@ -6,12 +6,16 @@
 
 #pragma once
 
+#include "HeightMapElevationBounds.h"
 #include "QuadTreeTileLoader.h"
 #include "SkyboltVis/SkyboltVisFwd.h"
 #include "SkyboltVis/OsgBox2.h"
 #include <SkyboltCommon/Math/QuadTree.h>
+#include <osg/Polytope>
 #include <osg/Vec2d>
 
+#include <optional>
+
 namespace skybolt {
 namespace vis {
 
@@ -19,17 +23,28 @@ struct PlanetSubdivisionPredicate : public QuadTreeSubdivisionPredicate
 {
 	~PlanetSubdivisionPredicate() override = default;
 
-	bool operator()(const Box2d& bounds, const skybolt::QuadTreeTileKey& key, const TileImages& images) override;
+	bool operator()(const Box2d& bounds, const skybolt::QuadTreeTileKey& key, const TileImages& images, bool currentlySubdivided) override;
 
 	std::vector<TileSourcePtr> tileSources; //!< tileSources are queried to see if children exist at each level
 	osg::Vec2d observerLatLon;
 	double observerAltitude;
 	double planetRadius;
 
+	//! View frustum in planet-centered coordinates. Tiles outside the frustum are not subdivided.
+	//! If not set, tiles are subdivided regardless of view direction.
+	std::optional<osg::Polytope> viewFrustum;
+
+	//! Fraction by which the thresholds for keeping a subdivided tile are relaxed relative to the thresholds for subdividing it.
+	//! This stops tiles near a threshold from being repeatedly loaded and unloaded as the observer moves or turns.
+	double hysteresis = 0.25;
+
 private:
 	// TODO: handle longitude wrap around
 	osg::Vec2d nearestPointInSolidBox(const osg::Vec2d& point, const Box2d& bounds) const;
 
+	//! @param boundsScale is a factor by which the tile's bounds are scaled about their center before testing against the frustum
+	bool intersectsViewFrustum(const Box2d& latLonBounds, const HeightMapElevationBounds& elevationBounds, double boundsScale) const;
+
 private:
 	bool mHasMissingElevationBoundsError = false;
 };
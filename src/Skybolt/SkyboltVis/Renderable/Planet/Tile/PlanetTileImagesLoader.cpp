@@ -11,6 +11,7 @@
 #include "SkyboltVis/Renderable/Planet/Tile/NormalMapHelpers.h"
 #include "SkyboltVis/OsgImageHelpers.h"
 #include "SkyboltVis/OsgTextureHelpers.h"
+#include <SkyboltCommon/Math/MathUtility.h>
 #include <algorithm>
 #include <osg/Texture>
 
@@ -25,6 +26,29 @@ using namespace skybolt;
 namespace skybolt {
 namespace vis {
 
+static size_t getImageSizeInBytes(const osg::Image* image)
+{
+	return image ? image->getTotalSizeInBytes() : 0;
+}
+
+size_t PlanetTileImages::getSizeInBytes() const
+{
+	size_t size = getImageSizeInBytes(heightMapImage.image.get())
+		+ getImageSizeInBytes(normalMapImage.get())
+		+ getImageSizeInBytes(landMaskImage.get())
+		+ getImageSizeInBytes(albedoMapImage.image.get());
+
+	if (attributeMapImage)
+	{
+		size += getImageSizeInBytes(attributeMapImage->image.get());
+	}
+	if (vertices.positions)
+	{
+		size += vertices.positions->getTotalDataSize();
+	}
+	return size;
+}
+
 static osg::Image* createDefaultHeightImage(const HeightMapElevationRerange& rerange)
 {
 	const int oceanHeight = getColorValueForElevation(rerange, 0.f);
@@ -44,6 +68,26 @@ static osg::Image* createDefaultHeightImage(const HeightMapElevationRerange& rer
 	return image;
 }
 
+//! @returns bounds of the elevations within the tile, or nullopt if unknown
+static std::optional<HeightMapElevationBounds> getTileElevationBounds(const TileImage& heightMap, const QuadTreeTileKey& key)
+{
+	if (heightMap.key == key)
+	{
+		if (std::optional<HeightMapElevationBounds> bounds = getHeightMapElevationBounds(*heightMap.image); bounds)
+		{
+			return bounds;
+		}
+	}
+
+	// Height map belongs to an ancestor tile, so find bounds of the part of the height map covering this tile
+	if (std::optional<HeightMapElevationRerange> rerange = getHeightMapElevationRerange(*heightMap.image); rerange)
+	{
+		HeightMapElevationBoundsPyramid pyramid(*heightMap.image, *rerange);
+		return getHeightMapElevationBoundsWithinTile(pyramid, heightMap.key, key);
+	}
+	return getHeightMapElevationBounds(*heightMap.image);
+}
+
 static osg::Image* createDefaultAlbedoImage()
 {
 	osg::Image* image = new osg::Image();
@@ -217,6 +261,31 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 #endif
 	}
 
+	// Geometry
+	{
+		if (images->heightMapImage.image == defaultHeightImage)
+		{
+			images->heightMapElevationBounds = getHeightMapElevationBounds(*defaultHeightImage);
+		}
+		else
+		{
+			images->heightMapElevationBounds = getTileElevationBounds(images->heightMapImage, key);
+		}
+
+		// If elevation is unknown, use bounds large enough to contain any terrain on Earth
+		static const HeightMapElevationBounds conservativeElevationBounds(-9000, 9000);
+
+		auto bounds = getKeyLonLatBounds<osg::Vec2d>(key);
+		Box2d latLonBounds(math::vec2SwapComponents(bounds.minimum), math::vec2SwapComponents(bounds.maximum));
+		images->vertices = createPlanetTileVertices(latLonBounds, mPlanetRadius, images->heightMapElevationBounds.value_or(conservativeElevationBounds));
+
+#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
+		std::cout << "Geometry@" << key.level << ": " << timer.count() << std::endl;
+		timer.reset();
+		timer.start();
+#endif
+	}
+
 #ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
 	std::cout << "Total TileImage load time: " << timer.count() << std::endl;
 #endif
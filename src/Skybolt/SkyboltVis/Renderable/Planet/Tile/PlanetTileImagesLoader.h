@@ -7,6 +7,7 @@
 #pragma once
 
 #include "TileImagesLoader.h"
+#include "SkyboltVis/Renderable/Planet/PlanetTileGeometry.h"
 
 namespace skybolt {
 namespace vis {
@@ -21,6 +22,15 @@ struct PlanetTileImages : TileImages
 
 	TileImage albedoMapImage;
 	std::optional<TileImage> attributeMapImage;
+
+	//! Elevation bounds within the tile. May be tighter than the bounds of heightMapImage if heightMapImage belongs to an ancestor tile.
+	//! Null if the height map has no elevation data.
+	std::optional<HeightMapElevationBounds> heightMapElevationBounds;
+
+	PlanetTileVertices vertices; //!< Created with the images so that geometry is not built on the render thread
+
+	//! Images shared with other tiles, such as ancestor height maps, are included in the size
+	size_t getSizeInBytes() const override;
 };
 
 enum AttributeMapProcessing
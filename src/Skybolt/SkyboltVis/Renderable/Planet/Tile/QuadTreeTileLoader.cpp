@@ -7,12 +7,14 @@
 #include "QuadTreeTileLoader.h"
 #include "AsyncTileLoader.h"
 #include "PlanetSubdivisionPredicate.h"
+#include "TileImagesLoader.h"
 #include "SkyboltVis/OsgMathHelpers.h"
 
 #include <SkyboltCommon/Listenable.h>
 #include <SkyboltCommon/Math/MathUtility.h>
 
 #include <ostream>
+#include <tuple>
 
 using namespace skybolt;
 
@@ -124,6 +126,8 @@ QuadTreeTileLoader::~QuadTreeTileLoader()
 	mAsyncTree->rightTree.merge(rightRoot);
 	rightRoot.requestCancelLoad();
 
+	clearPrefetchCache();
+
 	mAsyncTileLoader.reset();
 
 	for (size_t i = 0; i < mLoadQueue.size(); ++i)
@@ -155,10 +159,20 @@ void QuadTreeTileLoader::update()
 		}
 	}
 
+	updatePrefetchCache();
+	++mUpdateCount;
+
 	// Issue new load/unloads
 	traveseToLoadAndUnload(mAsyncTree->leftTree, mAsyncTree->leftTree.getRoot());
 	traveseToLoadAndUnload(mAsyncTree->rightTree, mAsyncTree->rightTree.getRoot());
 
+	// Issue prefetch loads after visible loads so that visible tiles are loaded first
+	for (const QuadTreeSubdivisionPredicatePtr& predicate : mPrefetchPredicates)
+	{
+		traverseToPrefetch(*predicate, mAsyncTree->leftTree.getRoot().key, &mAsyncTree->leftTree.getRoot());
+		traverseToPrefetch(*predicate, mAsyncTree->rightTree.getRoot().key, &mAsyncTree->rightTree.getRoot());
+	}
+
 	// Tick the async loader
 	mAsyncTileLoader->update();
 
@@ -181,7 +195,7 @@ void QuadTreeTileLoader::traveseToLoadAndUnload(QuadTree<AsyncQuadTreeTile>& tre
 		return;
 	}
 
-	bool shouldSubdivide = (*mSubdivisionPredicate)(tile.bounds, tile.key, *tile.getData());
+	bool shouldSubdivide = (*mSubdivisionPredicate)(tile.bounds, tile.key, *tile.getData(), tile.hasChildren());
 
 	if (shouldSubdivide)
 	{
@@ -260,15 +274,206 @@ void QuadTreeTileLoader::loadTile(AsyncQuadTreeTile& tile)
 {
 	assert(tile.getState() == AsyncQuadTreeTile::State::NotLoaded);
 
+	if (loadTileFromPrefetchCache(tile))
+		return;
+
 	if (mLoadQueue.size() > 32) // throttle loading to maintain reasonable realtime performance
 		return;
 
+	if (!mPrefetchPredicates.empty())
+	{
+		++mPrefetchStats.missCount;
+	}
+
 	tile.progressCallback = std::make_shared<TileProgressCallback>();
 	mAsyncTileLoader->load(tile.key, tile.dataPtr, tile.progressCallback);
 	CALL_LISTENERS(tileLoadRequested());
 	mLoadQueue.push_back({ tile.progressCallback });
 }
 
+void QuadTreeTileLoader::setPrefetchPredicates(const std::vector<QuadTreeSubdivisionPredicatePtr>& predicates)
+{
+	mPrefetchPredicates = predicates;
+	if (mPrefetchPredicates.empty())
+	{
+		clearPrefetchCache();
+	}
+}
+
+TilePrefetchStats QuadTreeTileLoader::getPrefetchStats() const
+{
+	TilePrefetchStats stats = mPrefetchStats;
+	stats.cachedTileCount = mPrefetchCache.size();
+	return stats;
+}
+
+static QuadTreeTileKey getChildKey(const QuadTreeTileKey& key, int childIndex)
+{
+	// Same child order as QuadTree::subdivide()
+	return QuadTreeTileKey(key.level + 1, key.x * 2 + (childIndex & 1), key.y * 2 + (childIndex >> 1));
+}
+
+void QuadTreeTileLoader::traverseToPrefetch(QuadTreeSubdivisionPredicate& predicate, const QuadTreeTileKey& key, const AsyncQuadTreeTile* visibleTile)
+{
+	TileImagesPtr images;
+	auto visibleState = visibleTile ? visibleTile->getState() : AsyncQuadTreeTile::State::NotLoaded;
+	if (visibleState == AsyncQuadTreeTile::State::Loaded)
+	{
+		images = *visibleTile->dataPtr;
+	}
+	else if (visibleState == AsyncQuadTreeTile::State::Loading)
+	{
+		return; // Already being loaded as a visible tile
+	}
+	else if (auto i = mPrefetchCache.find(key); i != mPrefetchCache.end())
+	{
+		PrefetchedTile& prefetched = i->second;
+		prefetched.lastUsedUpdate = mUpdateCount;
+		if (prefetched.progressCallback->state != TileProgressCallback::State::Loaded)
+		{
+			return;
+		}
+		images = *prefetched.dataPtr;
+	}
+	else
+	{
+		prefetchTile(key);
+		return;
+	}
+
+	if (!images || !predicate(getKeyLonLatBounds<osg::Vec2d>(key), key, *images, /* currentlySubdivided */ false))
+	{
+		return;
+	}
+
+	bool visibleTileHasChildren = visibleTile && visibleTile->hasChildren();
+	for (int i = 0; i < 4; ++i)
+	{
+		traverseToPrefetch(predicate, getChildKey(key, i), visibleTileHasChildren ? visibleTile->children[i].get() : nullptr);
+	}
+}
+
+void QuadTreeTileLoader::prefetchTile(const QuadTreeTileKey& key)
+{
+	if (int(mLoadQueue.size()) > mPrefetchConfig.maxVisibleLoadsForPrefetch
+		|| mPrefetchLoadingCount >= mPrefetchConfig.maxConcurrentLoads
+		|| mPrefetchStats.cachedBytes >= mPrefetchConfig.memoryBudgetBytes)
+	{
+		return;
+	}
+
+	PrefetchedTile prefetched;
+	prefetched.dataPtr = std::make_shared<TileImagesPtr>();
+	prefetched.progressCallback = std::make_shared<TileProgressCallback>();
+	prefetched.lastUsedUpdate = mUpdateCount;
+	mAsyncTileLoader->load(key, prefetched.dataPtr, prefetched.progressCallback);
+	mPrefetchCache[key] = prefetched;
+
+	++mPrefetchLoadingCount;
+	++mPrefetchStats.requestCount;
+}
+
+bool QuadTreeTileLoader::loadTileFromPrefetchCache(AsyncQuadTreeTile& tile)
+{
+	auto i = mPrefetchCache.find(tile.key);
+	if (i == mPrefetchCache.end())
+	{
+		return false;
+	}
+
+	PrefetchedTile prefetched = i->second;
+	mPrefetchCache.erase(i);
+	if (prefetched.progressCallback->state == TileProgressCallback::State::FailedOrCanceled)
+	{
+		return false;
+	}
+
+	// Adopt the prefetched load, whether or not it has completed.
+	// The tile goes through the load queue so that listeners see the same events as for a regular load.
+	tile.dataPtr = prefetched.dataPtr;
+	tile.progressCallback = prefetched.progressCallback;
+	CALL_LISTENERS(tileLoadRequested());
+	mLoadQueue.push_back({ tile.progressCallback });
+
+	++mPrefetchStats.hitCount;
+	return true;
+}
+
+void QuadTreeTileLoader::updatePrefetchCache()
+{
+	mPrefetchLoadingCount = 0;
+	size_t cachedBytes = 0;
+
+	for (auto i = mPrefetchCache.begin(); i != mPrefetchCache.end();)
+	{
+		PrefetchedTile& prefetched = i->second;
+		auto state = prefetched.progressCallback->state.load();
+		if (state == TileProgressCallback::State::Loading)
+		{
+			// Cancel loads that were not required by the previous update, for example because the predicted path has changed
+			if (prefetched.lastUsedUpdate != mUpdateCount)
+			{
+				prefetched.progressCallback->requestCancel();
+				++mPrefetchStats.evictedUnusedCount;
+				i = mPrefetchCache.erase(i);
+				continue;
+			}
+			++mPrefetchLoadingCount;
+		}
+		else if (state == TileProgressCallback::State::Loaded)
+		{
+			if (prefetched.sizeInBytes == 0 && *prefetched.dataPtr)
+			{
+				prefetched.sizeInBytes = (*prefetched.dataPtr)->getSizeInBytes();
+			}
+			cachedBytes += prefetched.sizeInBytes;
+		}
+		else
+		{
+			i = mPrefetchCache.erase(i);
+			continue;
+		}
+		++i;
+	}
+
+	// Evict least recently used tiles until the cache is within budget.
+	// Of equally recently used tiles, evict the highest level tiles first because lower level tiles are needed to reach them.
+	auto isEvictedBefore = [] (const auto& a, const auto& b) {
+		return std::make_tuple(a.second.lastUsedUpdate, -a.first.level) < std::make_tuple(b.second.lastUsedUpdate, -b.first.level);
+	};
+
+	while (cachedBytes > mPrefetchConfig.memoryBudgetBytes)
+	{
+		auto lruTile = mPrefetchCache.end();
+		for (auto i = mPrefetchCache.begin(); i != mPrefetchCache.end(); ++i)
+		{
+			if (i->second.sizeInBytes > 0 && (lruTile == mPrefetchCache.end() || isEvictedBefore(*i, *lruTile)))
+			{
+				lruTile = i;
+			}
+		}
+		assert(lruTile != mPrefetchCache.end());
+
+		cachedBytes -= lruTile->second.sizeInBytes;
+		++mPrefetchStats.evictedUnusedCount;
+		mPrefetchCache.erase(lruTile);
+	}
+
+	mPrefetchStats.cachedBytes = cachedBytes;
+}
+
+void QuadTreeTileLoader::clearPrefetchCache()
+{
+	for (const auto& [key, prefetched] : mPrefetchCache)
+	{
+		prefetched.progressCallback->requestCancel();
+	}
+	mPrefetchStats.evictedUnusedCount += mPrefetchCache.size();
+	mPrefetchStats.cachedBytes = 0;
+	mPrefetchCache.clear();
+	mPrefetchLoadingCount = 0;
+}
+
 void findLeafTiles(const QuadTreeTileLoader::LoadedTile& tile, TileKeyImagesMap& result, std::optional<int> maxLevel)
 {
 	if ((maxLevel && tile.key.level == *maxLevel) || !tile.hasChildren())
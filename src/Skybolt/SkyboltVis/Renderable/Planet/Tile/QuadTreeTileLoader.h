@@ -14,6 +14,7 @@
 #include <osg/Vec2d>
 
 #include <assert.h>
+#include <map>
 #include <set>
 #include <vector>
 
@@ -35,13 +36,41 @@ struct QuadTreeSubdivisionPredicate
 	//! Returns true if the tile with the given key should be subdivded.
 	//! @param images specifies the tile's images, which are useful if the subdivision decision is based on image content,
 	//!        for example how close the camera is to elevations stored in a height map image.
-	virtual bool operator()(const Box2d& bounds, const QuadTreeTileKey& key, const TileImages& images) = 0;
+	//! @param currentlySubdivided is true if the tile is currently subdivided. Predicates can use this to apply hysteresis,
+	//!        so that tiles near the subdivision threshold are not repeatedly subdivided and merged.
+	virtual bool operator()(const Box2d& bounds, const QuadTreeTileKey& key, const TileImages& images, bool currentlySubdivided) = 0;
 };
 
 using QuadTreeSubdivisionPredicatePtr = std::shared_ptr<QuadTreeSubdivisionPredicate>;
 
 struct AsyncQuadTreeTile;
 
+struct TilePrefetchConfig
+{
+	size_t memoryBudgetBytes = 256 * 1024 * 1024; //!< Maximum total size of prefetched tiles that have not yet been used
+	int maxConcurrentLoads = 4; //!< Maximum number of prefetch loads in progress at once
+
+	//! Prefetch loads are only issued while the number of visible tiles loading is no greater than this.
+	//! This gives visible tiles priority over prefetched tiles.
+	int maxVisibleLoadsForPrefetch = 4;
+};
+
+struct TilePrefetchStats
+{
+	size_t requestCount = 0; //!< Number of prefetch loads issued
+	size_t hitCount = 0; //!< Number of visible tile loads satisfied by a prefetched or prefetching tile
+	size_t missCount = 0; //!< Number of visible tile loads not satisfied by prefetching
+	size_t evictedUnusedCount = 0; //!< Number of prefetched tiles discarded without being used
+	size_t cachedTileCount = 0;
+	size_t cachedBytes = 0;
+
+	double getHitRate() const
+	{
+		size_t total = hitCount + missCount;
+		return total ? double(hitCount) / double(total) : 0.0;
+	}
+};
+
 //! QuadTreeTileLoader loads a quadtree of tiles to satisfy a predicate governing whether a given tile is of sufficient resolution.
 //! While a tile is of sufficient resolution, child tiles will not be loaded.
 //! If a tile is of insufficient resolution, its children will be loaded.
@@ -68,8 +97,30 @@ public:
 
 	LoadedTileTreePtr getLoadedTree() const { return mLoadedTree; }
 
+	//! Sets predicates describing the tiles that will be needed in future, for example by an observer moving along a predicted path.
+	//! Tiles satisfying these predicates are loaded in the background, at lower priority than visible tiles,
+	//! and are used when they become visible. Set an empty vector to disable prefetching.
+	void setPrefetchPredicates(const std::vector<QuadTreeSubdivisionPredicatePtr>& predicates);
+
+	void setPrefetchConfig(const TilePrefetchConfig& config) { mPrefetchConfig = config; }
+	const TilePrefetchConfig& getPrefetchConfig() const { return mPrefetchConfig; }
+
+	TilePrefetchStats getPrefetchStats() const;
+
 private:
 	void traveseToLoadAndUnload(skybolt::QuadTree<AsyncQuadTreeTile>& tree, AsyncQuadTreeTile& tile);
+
+	//! @param visibleTile is the tile with the same key in the visible tree, or null if the visible tree does not contain the key
+	void traverseToPrefetch(QuadTreeSubdivisionPredicate& predicate, const QuadTreeTileKey& key, const AsyncQuadTreeTile* visibleTile);
+
+	void prefetchTile(const QuadTreeTileKey& key);
+
+	//! @returns true if a prefetched tile was used to satisfy the load
+	bool loadTileFromPrefetchCache(AsyncQuadTreeTile& tile);
+
+	//! Processes results of prefetch loads issued by the previous update, and evicts tiles to keep the cache within budget
+	void updatePrefetchCache();
+	void clearPrefetchCache();
 	
 	void populateLoadedTree(AsyncQuadTreeTile& srcTile, skybolt::QuadTree<LoadedTile>& destTree, LoadedTile& destTile) const;
 
@@ -90,6 +141,22 @@ private:
 	};
 
 	std::vector<LoadRequest> mLoadQueue;
+
+	std::vector<QuadTreeSubdivisionPredicatePtr> mPrefetchPredicates;
+	TilePrefetchConfig mPrefetchConfig;
+	TilePrefetchStats mPrefetchStats;
+
+	struct PrefetchedTile
+	{
+		std::shared_ptr<TileImagesPtr> dataPtr;
+		ProgressCallbackPtr progressCallback;
+		size_t sizeInBytes = 0; //!< Zero until loaded
+		size_t lastUsedUpdate = 0; //!< Update in which the tile was last required by a prefetch predicate
+	};
+
+	std::map<QuadTreeTileKey, PrefetchedTile> mPrefetchCache;
+	int mPrefetchLoadingCount = 0;
+	size_t mUpdateCount = 0;
 };
 
 using TileKeyImagesMap = std::map<QuadTreeTileKey, TileImagesPtr>;
@@ -15,6 +15,9 @@ namespace vis {
 struct TileImages
 {
 	virtual ~TileImages() = default;
+
+	//! @returns approximate memory used by the images, for budgeting caches of tiles
+	virtual size_t getSizeInBytes() const { return 0; }
 };
 
 using TileImagesPtr = std::shared_ptr<TileImages>;
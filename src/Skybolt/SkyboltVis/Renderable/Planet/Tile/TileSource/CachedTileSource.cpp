@@ -22,10 +22,25 @@ CachedTileSource::CachedTileSource(const TileSourcePtr& tileSource, const std::s
 	assert(mTileSource);
 }
 
+static std::string getImageDirectory(const std::string& cacheDirectory, const skybolt::QuadTreeTileKey& key)
+{
+	return cacheDirectory + "/" + std::to_string(key.level) + "/" + std::to_string(key.x) + "/";
+}
+
+std::string CachedTileSource::getCacheFilename(const skybolt::QuadTreeTileKey& key) const
+{
+	return getImageDirectory(mCacheDirectory, key) + std::to_string(key.y) + "." + mTileSource->getCacheFileFormat();
+}
+
+bool CachedTileSource::isCached(const skybolt::QuadTreeTileKey& key) const
+{
+	return std::filesystem::exists(getCacheFilename(key));
+}
+
 osg::ref_ptr<osg::Image> CachedTileSource::createImage(const skybolt::QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const
 {
-	std::string imageDirectory = mCacheDirectory + "/" + std::to_string(key.level) + "/" + std::to_string(key.x) + "/";
-	std::string filename = imageDirectory + std::to_string(key.y) + "." + mTileSource->getCacheFileFormat();
+	std::string imageDirectory = getImageDirectory(mCacheDirectory, key);
+	std::string filename = getCacheFilename(key);
 
 	const bool supportUserData = (mTileSource->getCacheFileFormat() == "pngx");
 
@@ -55,9 +70,12 @@ osg::ref_ptr<osg::Image> CachedTileSource::createImage(const skybolt::QuadTreeTi
 		{
 			std::filesystem::create_directories(imageDirectory);
 
+			// Write to a temporary file and then rename it, so that an interrupted write does not leave a partial image in the cache.
+			// The temporary filename keeps the image extension so that osgDB can choose a writer for it.
+			std::string partialFilename = imageDirectory + std::to_string(key.y) + ".partial." + mTileSource->getCacheFileFormat();
 			if (supportUserData)
 			{
-				std::ofstream f(filename.c_str(), std::ios::binary);
+				std::ofstream f(partialFilename.c_str(), std::ios::binary);
 				if (!writeImageWithUserData(*image, f, "png"))
 				{
 					throw std::runtime_error("Could not write cached tile image to: " + filename);
@@ -66,11 +84,12 @@ osg::ref_ptr<osg::Image> CachedTileSource::createImage(const skybolt::QuadTreeTi
 			}
 			else
 			{
-				if (!osgDB::writeImageFile(*image, filename))
+				if (!osgDB::writeImageFile(*image, partialFilename))
 				{
 					throw std::runtime_error("Could not write cached tile image to: " + filename);
 				}
 			}
+			std::filesystem::rename(partialFilename, filename);
 		}
 		return image;
 	}
@@ -31,6 +31,12 @@ public:
 
 	const std::string& getCacheSha() const override { throw std::runtime_error("Cached tile source cann't be cached"); }
 
+	//! @returns the filename of the tile's image in the cache, whether or not the image has been cached
+	std::string getCacheFilename(const skybolt::QuadTreeTileKey& key) const;
+
+	//! @returns true if the tile's image is in the cache
+	bool isCached(const skybolt::QuadTreeTileKey& key) const;
+
 private:
 	TileSourcePtr mTileSource;
 	std::string mCacheDirectory;
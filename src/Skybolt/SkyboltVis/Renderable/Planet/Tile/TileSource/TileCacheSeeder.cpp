@@ -0,0 +1,296 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TileCacheSeeder.h"
+#include "CachedTileSource.h"
+#include "JsonTileSourceFactory.h"
+#include "TileSource.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace skybolt {
+namespace vis {
+
+double TileCacheSeedRoute::getCorridorWidth(int level) const
+{
+	assert(!corridorWidths.empty());
+	auto i = corridorWidths.upper_bound(level);
+	if (i != corridorWidths.begin())
+	{
+		--i;
+	}
+	return i->second;
+}
+
+TileCacheSeedRoute readTileCacheSeedRoute(const nlohmann::json& json)
+{
+	TileCacheSeedRoute route;
+	for (const nlohmann::json& point : json.at("points"))
+	{
+		if (!point.is_array() || point.size() != 2)
+		{
+			throw std::runtime_error("Route point was not in form [latitude, longitude]");
+		}
+		route.points.push_back(osg::Vec2d(point[0].get<double>(), point[1].get<double>()) * math::degToRadD());
+	}
+
+	for (const nlohmann::json& item : json.at("corridorWidths"))
+	{
+		route.corridorWidths[item.at("level").get<int>()] = item.at("width").get<double>();
+	}
+
+	if (route.corridorWidths.empty())
+	{
+		throw std::runtime_error("Route must specify at least one corridor width");
+	}
+	return route;
+}
+
+std::vector<QuadTreeTileKey> findTilesInLatLonBounds(const Box2d& latLonBounds, int level)
+{
+	int xCount = 2 << level;
+	int yCount = 1 << level;
+
+	// Key x increases eastwards and key y increases southwards
+	QuadTreeTileKey northWestKey = getKeyAtLevelIntersectingLonLatPoint(level, osg::Vec2d(latLonBounds.minimum.y(), latLonBounds.maximum.x()));
+	QuadTreeTileKey southEastKey = getKeyAtLevelIntersectingLonLatPoint(level, osg::Vec2d(latLonBounds.maximum.y(), latLonBounds.minimum.x()));
+
+	int minX = std::clamp(northWestKey.x, 0, xCount - 1);
+	int maxX = std::clamp(southEastKey.x, 0, xCount - 1);
+	int minY = std::clamp(northWestKey.y, 0, yCount - 1);
+	int maxY = std::clamp(southEastKey.y, 0, yCount - 1);
+
+	std::vector<QuadTreeTileKey> result;
+	for (int y = minY; y <= maxY; ++y)
+	{
+		for (int x = minX; x <= maxX; ++x)
+		{
+			result.push_back(QuadTreeTileKey(level, x, y));
+		}
+	}
+	return result;
+}
+
+static void addTilesInLatLonBoundsWrappingLongitude(const Box2d& latLonBounds, int level, std::set<QuadTreeTileKey>& result)
+{
+	auto addTiles = [&] (const Box2d& bounds) {
+		std::vector<QuadTreeTileKey> keys = findTilesInLatLonBounds(bounds, level);
+		result.insert(keys.begin(), keys.end());
+	};
+
+	Box2d bounds = latLonBounds;
+	bounds.minimum.x() = std::max(bounds.minimum.x(), -math::halfPiD());
+	bounds.maximum.x() = std::min(bounds.maximum.x(), math::halfPiD());
+
+	// Split bounds that cross the antimeridian
+	if (bounds.minimum.y() < -math::piD())
+	{
+		addTiles(Box2d(osg::Vec2d(bounds.minimum.x(), bounds.minimum.y() + math::twoPiD()), osg::Vec2d(bounds.maximum.x(), math::piD())));
+		bounds.minimum.y() = -math::piD();
+	}
+	if (bounds.maximum.y() > math::piD())
+	{
+		addTiles(Box2d(osg::Vec2d(bounds.minimum.x(), -math::piD()), osg::Vec2d(bounds.maximum.x(), bounds.maximum.y() - math::twoPiD())));
+		bounds.maximum.y() = math::piD();
+	}
+	addTiles(bounds);
+}
+
+std::vector<QuadTreeTileKey> findTilesAlongRoute(const TileCacheSeedRoute& route, int level, double planetRadius)
+{
+	std::set<QuadTreeTileKey> result;
+	if (route.points.empty())
+	{
+		return {};
+	}
+
+	double halfWidthAngle = 0.5 * route.getCorridorWidth(level) / planetRadius;
+	double tileSizeAngle = math::piD() / double(1 << level);
+
+	// Sample the route finely enough that the corridors around consecutive samples overlap and no tile is skipped
+	double sampleSpacing = 0.5 * std::max(std::min(tileSizeAngle, halfWidthAngle), tileSizeAngle * 0.01);
+
+	auto addCorridorAtPoint = [&] (const osg::Vec2d& latLon) {
+		double lonHalfWidth = halfWidthAngle / std::max(std::cos(latLon.x()), 0.01);
+		Box2d bounds(latLon - osg::Vec2d(halfWidthAngle, lonHalfWidth), latLon + osg::Vec2d(halfWidthAngle, lonHalfWidth));
+		addTilesInLatLonBoundsWrappingLongitude(bounds, level, result);
+	};
+
+	addCorridorAtPoint(route.points.front());
+	for (size_t i = 1; i < route.points.size(); ++i)
+	{
+		const osg::Vec2d& p0 = route.points[i - 1];
+		const osg::Vec2d& p1 = route.points[i];
+		int sampleCount = std::max(1, int(std::ceil((p1 - p0).length() / sampleSpacing)));
+		for (int s = 1; s <= sampleCount; ++s)
+		{
+			addCorridorAtPoint(p0 + (p1 - p0) * (double(s) / double(sampleCount)));
+		}
+	}
+
+	return std::vector<QuadTreeTileKey>(result.begin(), result.end());
+}
+
+std::vector<QuadTreeTileKey> findTilesInRegion(const TileCacheSeedRegion& region, const TileSource& source)
+{
+	std::set<QuadTreeTileKey> keys;
+	for (int level = region.levelRange.first; level <= region.levelRange.last; ++level)
+	{
+		if (region.latLonBounds)
+		{
+			std::vector<QuadTreeTileKey> levelKeys = findTilesInLatLonBounds(*region.latLonBounds, level);
+			keys.insert(levelKeys.begin(), levelKeys.end());
+		}
+		if (region.route)
+		{
+			std::vector<QuadTreeTileKey> levelKeys = findTilesAlongRoute(*region.route, level, region.planetRadius);
+			keys.insert(levelKeys.begin(), levelKeys.end());
+		}
+	}
+
+	std::vector<QuadTreeTileKey> result;
+	for (const QuadTreeTileKey& key : keys)
+	{
+		if (source.getHighestAvailableLevel(key) == key)
+		{
+			result.push_back(key);
+		}
+	}
+	return result;
+}
+
+TileCacheSeederProgress seedTileCache(const CachedTileSource& source, std::vector<QuadTreeTileKey> keys, const TileCacheSeederConfig& config)
+{
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+	std::mutex mutex;
+	std::condition_variable progressChanged;
+	TileCacheSeederProgress progress;
+	progress.totalTileCount = keys.size();
+	int activeWorkerCount = std::max(1, config.threadCount);
+
+	std::atomic<size_t> nextKeyIndex = 0;
+	std::atomic<bool> canceled = config.cancelSupplier && config.cancelSupplier();
+	auto cancelSupplier = [&] { return canceled.load(); };
+
+	auto runWorker = [&] {
+		while (!canceled)
+		{
+			size_t index = nextKeyIndex++;
+			if (index >= keys.size())
+			{
+				break;
+			}
+
+			const QuadTreeTileKey& key = keys[index];
+			bool alreadyCached = source.isCached(key);
+			bool fetched = false;
+			if (!alreadyCached)
+			{
+				try
+				{
+					fetched = source.createImage(key, cancelSupplier) != nullptr;
+				}
+				catch (const std::exception& e)
+				{
+					BOOST_LOG_TRIVIAL(error) << e.what();
+				}
+
+				if (!fetched && canceled)
+				{
+					break;
+				}
+			}
+
+			{
+				std::scoped_lock<std::mutex> lock(mutex);
+				++(alreadyCached ? progress.alreadyCachedCount : (fetched ? progress.fetchedCount : progress.failedCount));
+			}
+			progressChanged.notify_one();
+		}
+
+		{
+			std::scoped_lock<std::mutex> lock(mutex);
+			--activeWorkerCount;
+		}
+		progressChanged.notify_one();
+	};
+
+	std::vector<std::thread> workers;
+	int workerCount = activeWorkerCount;
+	for (int i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(runWorker);
+	}
+
+	auto startTime = std::chrono::steady_clock::now();
+	auto interval = std::chrono::duration<double>(std::max(config.progressIntervalSeconds, 0.01));
+	auto nextReportTime = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+
+	bool finished = false;
+	while (!finished)
+	{
+		TileCacheSeederProgress currentProgress;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			progressChanged.wait_until(lock, nextReportTime, [&] { return activeWorkerCount == 0; });
+			finished = (activeWorkerCount == 0);
+			currentProgress = progress;
+		}
+
+		if (config.cancelSupplier && config.cancelSupplier())
+		{
+			canceled = true;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (now >= nextReportTime || finished)
+		{
+			currentProgress.elapsedSeconds = std::chrono::duration<double>(now - startTime).count();
+			if (config.progressHandler)
+			{
+				config.progressHandler(currentProgress);
+			}
+			nextReportTime = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval);
+		}
+	}
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	progress.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return progress;
+}
+
+std::shared_ptr<CachedTileSource> createCachedTileSource(const JsonTileSourceFactoryRegistry& registry, nlohmann::json json)
+{
+	json["cache"] = true;
+	std::string format = json.at("format");
+	TileSourcePtr source = registry.getFactory(format)(json);
+
+	auto cachedSource = std::dynamic_pointer_cast<CachedTileSource>(source);
+	if (!cachedSource)
+	{
+		throw std::runtime_error("Tile source format '" + format + "' does not support caching");
+	}
+	return cachedSource;
+}
+
+} // namespace vis
+} // namespace skybolt
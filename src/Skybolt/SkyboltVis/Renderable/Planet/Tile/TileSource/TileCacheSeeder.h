@@ -0,0 +1,98 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltVis/OsgBox2.h"
+#include "SkyboltVis/SkyboltVisFwd.h"
+#include <SkyboltCommon/Math/QuadTree.h>
+#include <SkyboltCommon/Range.h>
+
+#include <nlohmann/json.hpp>
+#include <osg/Vec2d>
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+class CachedTileSource;
+class JsonTileSourceFactoryRegistry;
+
+//! A path along which tiles are seeded within a corridor either side of the path
+struct TileCacheSeedRoute
+{
+	std::vector<osg::Vec2d> points; //!< Lat/lon in radians
+
+	//! Maps a tile level to the total width of the corridor in meters, centered on the route.
+	//! Each width applies to its level and higher levels, up to the next level in the map.
+	//! Levels lower than the lowest level in the map use the lowest level's width.
+	std::map<int, double> corridorWidths;
+
+	double getCorridorWidth(int level) const;
+};
+
+//! Reads a route in the form:
+//! { "points": [[latDegrees, lonDegrees], ...], "corridorWidths": [{"level": 0, "width": 100000}, ...] }
+TileCacheSeedRoute readTileCacheSeedRoute(const nlohmann::json& json);
+
+//! @param latLonBounds is in radians and must not cross the antimeridian
+//! @returns keys of tiles at the given level which intersect the bounds
+std::vector<QuadTreeTileKey> findTilesInLatLonBounds(const Box2d& latLonBounds, int level);
+
+//! @returns keys of tiles at the given level which intersect the route's corridor
+std::vector<QuadTreeTileKey> findTilesAlongRoute(const TileCacheSeedRoute& route, int level, double planetRadius);
+
+struct TileCacheSeedRegion
+{
+	std::optional<Box2d> latLonBounds; //!< Lat/lon in radians. Must not cross the antimeridian.
+	std::optional<TileCacheSeedRoute> route;
+	IntRangeInclusive levelRange;
+	double planetRadius = 6371000; //!< Used to convert route corridor widths to angles
+};
+
+//! @returns keys of tiles within the region's bounds or route at each level in the region's level range.
+//! Tiles for which the source has no data at the tile's level are excluded.
+std::vector<QuadTreeTileKey> findTilesInRegion(const TileCacheSeedRegion& region, const TileSource& source);
+
+struct TileCacheSeederProgress
+{
+	size_t totalTileCount = 0;
+	size_t fetchedCount = 0; //!< Number of tiles fetched from the source and written to the cache
+	size_t alreadyCachedCount = 0; //!< Number of tiles skipped because they were already in the cache
+	size_t failedCount = 0; //!< Number of tiles which could not be fetched
+	double elapsedSeconds = 0;
+
+	size_t getCompletedCount() const { return fetchedCount + alreadyCachedCount + failedCount; }
+	double getFetchedTilesPerSecond() const { return elapsedSeconds > 0 ? double(fetchedCount) / elapsedSeconds : 0.0; }
+};
+
+using TileCacheSeederProgressHandler = std::function<void(const TileCacheSeederProgress&)>;
+
+struct TileCacheSeederConfig
+{
+	int threadCount = 8; //!< Number of tiles fetched concurrently
+	double progressIntervalSeconds = 1.0;
+	TileCacheSeederProgressHandler progressHandler; //!< Called from the calling thread at each progress interval and on completion. May be null.
+	std::function<bool()> cancelSupplier; //!< Seeding stops if this returns true. May be null.
+};
+
+//! Fetches tiles from the source and writes them to its cache.
+//! Tiles which are already cached are skipped, so seeding resumes where it stopped if it was interrupted.
+//! Tiles are fetched in order of level so that low detail tiles are cached first.
+//! @returns progress on completion
+TileCacheSeederProgress seedTileCache(const CachedTileSource& source, std::vector<QuadTreeTileKey> keys, const TileCacheSeederConfig& config = {});
+
+//! Creates a cached tile source from tile source JSON in the format read by JsonTileSourceFactoryRegistry.
+//! Caching is enabled regardless of the JSON's 'cache' value.
+//! @throws std::runtime_error if the tile source does not support caching
+std::shared_ptr<CachedTileSource> createCachedTileSource(const JsonTileSourceFactoryRegistry& registry, nlohmann::json json);
+
+} // namespace vis
+} // namespace skybolt
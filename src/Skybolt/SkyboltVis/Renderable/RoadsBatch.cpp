@@ -10,6 +10,7 @@
 #include "OsgStateSetHelpers.h"
 #include "SkyboltVis/earcutOsg.h"
 #include "SkyboltVis/OsgTextureHelpers.h"
+#include "SkyboltVis/VertexQuantization.h"
 #include <SkyboltVis/VisibilityCategory.h>
 #include "SkyboltVis/Renderable/Planet/Terrain.h"
 #include <SkyboltCommon/Math/IntersectionUtility.h>
@@ -20,7 +21,9 @@
 #include <osg/Texture2D>
 #include <osgUtil/Tessellator>
 
+#include <cmath>
 #include <optional>
+#include <vector>
 
 
 float roadTextureLengthMeters = 10.f;
@@ -88,28 +91,71 @@ static osg::Vec2f getSegmentNormal(const std::optional<osg::Vec3f>& prevPoint, c
 	return normal;
 }
 
-static void createRoad(const Road& road, osg::Vec3Array* posBuffer, osg::Vec3Array* normalBuffer, osg::Vec3Array* uvBuffer, osg::UIntArray* indexBuffer)
+//! Texture V coordinates are wrapped back towards zero after this many repeats to keep them within fixed point range
+static const float roadTextureMaxV = 64.f;
+
+//! Segments are split so that V increases by no more than this between vertices.
+//! With roadTextureMaxV, this keeps V below 96 repeats, within the fixed point limit of about 128.
+static const float roadMaxSegmentTextureRepeats = 32.f;
+
+//! @returns points with extra points inserted along segments longer than maxSegmentLength
+static std::vector<osg::Vec3f> splitLongSegments(const std::vector<osg::Vec3f>& points, float maxSegmentLength)
+{
+	std::vector<osg::Vec3f> result;
+	result.reserve(points.size());
+	for (size_t i = 0; i < points.size(); ++i)
+	{
+		if (i > 0)
+		{
+			const osg::Vec3f& p0 = points[i - 1];
+			const osg::Vec3f& p1 = points[i];
+			float length = toVec2f(p1 - p0).length();
+			int pieceCount = int(std::ceil(length / maxSegmentLength));
+			for (int piece = 1; piece < pieceCount; ++piece)
+			{
+				result.push_back(p0 + (p1 - p0) * (float(piece) / float(pieceCount)));
+			}
+		}
+		result.push_back(points[i]);
+	}
+	return result;
+}
+
+static void createRoad(const Road& road, const PositionQuantizer& quantizer, QuantizedVertexArrays& arrays)
 {
 	assert(road.points.size() > 1);
 
-	size_t firstVertIndex = posBuffer->size();
+	// Inserted points are on straight segments, so they do not change the road's shape
+	const std::vector<osg::Vec3f> points = splitLongSegments(road.points, roadMaxSegmentTextureRepeats * roadTextureLengthMeters);
+
+	const osg::Vec2s encodedNormal = encodeOctahedralNormal(osg::Vec3f(0, 0, -1)); // TODO: get terrain normal
 
 	float t = 0;
+	float vOffset = 0;
 
 	float width = road.width + roadBorderSizeMeters * 2.0f;
 	float halfWidth = width * 0.5f;
 
-	int addedPoints = 0;
-	for (int i = 0; i < road.points.size(); ++i)
+	auto addVertexPair = [&] (const osg::Vec3f& left, const osg::Vec3f& right, float scaleX, float scaleY) {
+		arrays.positions->push_back(quantizer.quantize(left));
+		arrays.positions->push_back(quantizer.quantize(right));
+		arrays.normals->push_back(encodedNormal);
+		arrays.normals->push_back(encodedNormal);
+		arrays.texCoords->push_back(quantizeTexCoord(osg::Vec2f(-roadBorderSizeMeters / road.width * scaleX, scaleY), 0));
+		arrays.texCoords->push_back(quantizeTexCoord(osg::Vec2f((1.0 + roadBorderSizeMeters / road.width) * scaleX, scaleY), 1));
+	};
+
+	std::optional<size_t> prevPairIndex;
+	for (int i = 0; i < points.size(); ++i)
 	{
 		// Get previous point
 		std::optional<osg::Vec3f> prevPoint;
 		if (i > 0)
 		{
-			prevPoint = road.points[i - 1];
+			prevPoint = points[i - 1];
 
 			// Increase road length
-			float segmentLength = toVec2f(road.points[i] - *prevPoint).length();
+			float segmentLength = toVec2f(points[i] - *prevPoint).length();
 			t += segmentLength;
 		}
 		else if (road.endLaneCounts[0] > 0)
@@ -119,9 +165,10 @@ static void createRoad(const Road& road, osg::Vec3Array* posBuffer, osg::Vec3Arr
 
 		// Get next point
 		std::optional<osg::Vec3f> nextPoint;
-		if (i < road.points.size() - 1)
+		bool isLastPoint = (i == points.size() - 1);
+		if (!isLastPoint)
 		{
-			nextPoint = road.points[i + 1];
+			nextPoint = points[i + 1];
 		}
 		else if (road.endLaneCounts[1] > 0)
 		{
@@ -129,7 +176,7 @@ static void createRoad(const Road& road, osg::Vec3Array* posBuffer, osg::Vec3Arr
 		}
 
 		// Add geometry to buffers
-		osg::Vec3f point = road.points[i];
+		osg::Vec3f point = points[i];
 		osg::Vec2f normal = getSegmentNormal(prevPoint, point, nextPoint);
 
 		float effectiveHalfWidth;
@@ -139,7 +186,7 @@ static void createRoad(const Road& road, osg::Vec3Array* posBuffer, osg::Vec3Arr
 			effectiveLaneCount = road.endLaneCounts[0];
 			effectiveHalfWidth = float(effectiveLaneCount) / float(road.laneCount) * halfWidth;
 		}
-		else if ((i == road.points.size() - 1) && road.endLaneCounts[1] > 0)
+		else if (isLastPoint && road.endLaneCounts[1] > 0)
 		{
 			effectiveLaneCount = road.endLaneCounts[1];
 			effectiveHalfWidth = float(effectiveLaneCount) / float(road.laneCount) * halfWidth;
@@ -150,58 +197,79 @@ static void createRoad(const Road& road, osg::Vec3Array* posBuffer, osg::Vec3Arr
 			effectiveHalfWidth = halfWidth;
 		}
 
-		posBuffer->push_back(point + osg::Vec3(normal * effectiveHalfWidth, -roadHeightAboveTerrain));
-		posBuffer->push_back(point - osg::Vec3(normal * effectiveHalfWidth, -roadHeightAboveTerrain));
-		
-		normalBuffer->push_back(osg::Vec3(0, 0, -1)); // TODO: get terrain normal
-		normalBuffer->push_back(osg::Vec3(0, 0, -1));
+		osg::Vec3f left = point + osg::Vec3(normal * effectiveHalfWidth, -roadHeightAboveTerrain);
+		osg::Vec3f right = point - osg::Vec3(normal * effectiveHalfWidth, -roadHeightAboveTerrain);
 
 		float scaleX = (float)effectiveLaneCount / (float)numLanesInTexture;
-		float scaleY = t / roadTextureLengthMeters;
+		float scaleY = t / roadTextureLengthMeters - vOffset;
 
-		uvBuffer->push_back(osg::Vec3f(-roadBorderSizeMeters / road.width * scaleX, scaleY, 0.0));
-		uvBuffer->push_back(osg::Vec3f((1.0 + roadBorderSizeMeters / road.width) * scaleX, scaleY, 1.0));
+		size_t pairIndex = arrays.positions->size();
+		addVertexPair(left, right, scaleX, scaleY);
 
-		++addedPoints;
+		if (prevPairIndex)
+		{
+			size_t j = *prevPairIndex;
+			arrays.indices->push_back(j);
+			arrays.indices->push_back(j + 1);
+			arrays.indices->push_back(pairIndex);
+			arrays.indices->push_back(j + 1);
+			arrays.indices->push_back(pairIndex + 1);
+			arrays.indices->push_back(pairIndex);
+		}
+		prevPairIndex = pairIndex;
+
+		// Start the next segment from a duplicate pair with V shifted by a whole number of texture repeats, which is seamless
+		if (scaleY > roadTextureMaxV && !isLastPoint)
+		{
+			float wrap = std::floor(scaleY);
+			vOffset += wrap;
+			prevPairIndex = arrays.positions->size();
+			addVertexPair(left, right, scaleX, scaleY - wrap);
+		}
 	}
+}
 
-	for (int i = 0; i < addedPoints-1; ++i)
+static osg::BoundingBoxf calcBounds(const Roads& roads)
+{
+	osg::BoundingBoxf bounds;
+	for (const Road& road : roads)
 	{
-		int j = firstVertIndex + i*2;
-		indexBuffer->push_back(j);
-		indexBuffer->push_back(j + 1);
-		indexBuffer->push_back(j + 2);
-		indexBuffer->push_back(j + 1);
-		indexBuffer->push_back(j + 3);
-		indexBuffer->push_back(j + 2);
+		// Segment normals are scaled by up to 2 at sharp corners
+		float maxOffset = road.width + roadBorderSizeMeters * 2.0f;
+		osg::Vec3f extent(maxOffset, maxOffset, roadHeightAboveTerrain);
+		for (const osg::Vec3f& point : road.points)
+		{
+			bounds.expandBy(point - extent);
+			bounds.expandBy(point + extent);
+		}
 	}
+	return bounds;
 }
 
-static osg::Geode* createRoads(const Roads& roads)
+osg::ref_ptr<osg::Geometry> createRoadsGeometry(const Roads& roads)
 {
-	osg::Vec3Array* posBuffer = new osg::Vec3Array();
-	osg::Vec3Array* normalBuffer = new osg::Vec3Array();
-	osg::Vec3Array* uvBuffer = new osg::Vec3Array();
-	osg::UIntArray* indexBuffer = new osg::UIntArray();
-
-	for (size_t i = 0; i < roads.size(); ++i)
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (const Road& road : roads)
 	{
-		createRoad(roads[i], posBuffer, normalBuffer, uvBuffer, indexBuffer);
+		vertexCount += road.points.size() * 2;
+		indexCount += (road.points.size() - 1) * 6;
 	}
 
-    osg::Geode *geode = new osg::Geode();
-    osg::Geometry *geometry = new osg::Geometry();
+	QuantizedVertexArrays arrays;
+	arrays.reserve(vertexCount, indexCount);
 
-    geometry->setVertexArray(posBuffer);
-	geometry->setNormalArray(normalBuffer);
-	geometry->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
-	geometry->setTexCoordArray(0, uvBuffer); 
-	configureDrawable(*geometry);
+	osg::BoundingBoxf bounds = calcBounds(roads);
+	PositionQuantizer quantizer(bounds);
 
-    geometry->addPrimitiveSet(new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, indexBuffer->size(), (GLuint*)indexBuffer->getDataPointer()));
-	geometry->setComputeBoundingBoxCallback(createFixedBoundingBoxCallback(osg::BoundingBox())); // TODO: set bounds
-    geode->addDrawable(geometry);
-    return geode;
+	for (const Road& road : roads)
+	{
+		createRoad(road, quantizer, arrays);
+	}
+
+	osg::ref_ptr<osg::Geometry> geometry = createQuantizedGeometry(arrays, quantizer);
+	geometry->setComputeBoundingBoxCallback(createFixedBoundingBoxCallback(bounds));
+	return geometry;
 }
 
 static osg::ref_ptr<osg::Texture2D> createRoadTexture(const std::string& filename)
@@ -230,10 +298,12 @@ static osg::ref_ptr<osg::StateSet> createStateSet(const osg::ref_ptr<osg::Progra
 
 RoadsBatch::RoadsBatch(const Roads& roads, const osg::ref_ptr<osg::Program>& program)
 {
-	osg::Geode* geode = createRoads(roads);
+	osg::Geode* geode = new osg::Geode();
+	geode->addDrawable(createRoadsGeometry(roads));
 	mUniforms.modelMatrix = new osg::Uniform("modelMatrix", osg::Matrixf());
 
 	auto stateSet = createStateSet(program, mUniforms);
+	stateSet->setDefine("QUANTIZED_VERTEX");
 	{
 		int unit = 0;
 		stateSet->setTextureAttributeAndModes(unit, createRoadTexture("Environment/Road/Asphalt010_2K_Road_Color.jpg"));
@@ -9,6 +9,8 @@
 #include "DefaultRootNode.h"
 #include "OsgBox2.h"
 
+#include <osg/Geometry>
+
 namespace skybolt {
 namespace vis {
 
@@ -32,6 +34,10 @@ struct Road
 
 typedef std::vector<Road> Roads;
 
+//! Creates geometry for roads using the compact vertex format described in VertexQuantization.h.
+//! Texture coordinate z is 0 on the left edge of the road and 1 on the right.
+osg::ref_ptr<osg::Geometry> createRoadsGeometry(const Roads& roads);
+
 struct PolyRegion
 {
 	std::vector<osg::Vec3f> points;
@@ -9,6 +9,7 @@
 #include "SkyboltVis/OsgGeometryHelpers.h"
 #include "SkyboltVis/OsgImageHelpers.h"
 #include "SkyboltVis/OsgStateSetHelpers.h"
+#include "SkyboltVis/VertexQuantization.h"
 #include <SkyboltVis/VisibilityCategory.h>
 
 #include <osg/Geode>
@@ -27,10 +28,10 @@ float lakeHeightAboveTerrain = 0.01f;
 namespace skybolt {
 namespace vis {
 
-void createLake(const Lake& lake, osg::Vec3Array* posBuffer, osg::Vec3Array* normalBuffer, osg::Vec2Array* uvBuffer, osg::UIntArray* indexBuffer)
+static void createLake(const Lake& lake, const PositionQuantizer& quantizer, QuantizedVertexArrays& arrays)
 {
 	assert(lake.points.size() >= 3);
-	size_t indexoffset = posBuffer->size();
+	size_t indexoffset = arrays.positions->size();
 
 	std::vector<osg::Vec3> points = lake.points;
 	std::vector<std::vector<osg::Vec3f>> polygon = { points };
@@ -39,16 +40,14 @@ void createLake(const Lake& lake, osg::Vec3Array* posBuffer, osg::Vec3Array* nor
 
 	for (int i = 0; i < points.size(); ++i)
 	{
-		posBuffer->push_back(points[i] - osg::Vec3(0,0, lakeHeightAboveTerrain));
-		normalBuffer->push_back(osg::Vec3(0, 0, -1));
-		uvBuffer->push_back(osg::Vec2f(i, i)); // TODO: remove UVs. They are unused.
+		arrays.positions->push_back(quantizer.quantize(points[i] - osg::Vec3(0,0, lakeHeightAboveTerrain)));
 	}
 
 	for (int i = 0; i < indices.size(); i += 3)
 	{
-		indexBuffer->push_back(indexoffset + indices[i]);
-		indexBuffer->push_back(indexoffset + indices[i+2]); // reverse winding
-		indexBuffer->push_back(indexoffset + indices[i+1]);
+		arrays.indices->push_back(indexoffset + indices[i]);
+		arrays.indices->push_back(indexoffset + indices[i+2]); // reverse winding
+		arrays.indices->push_back(indexoffset + indices[i+1]);
 	}
 
 //#define EXPORT_OBJ
@@ -76,33 +75,48 @@ void createLake(const Lake& lake, osg::Vec3Array* posBuffer, osg::Vec3Array* nor
 #endif
 }
 
-osg::Geode* createLakes(const Lakes& lakes)
+static osg::BoundingBoxf calcBounds(const Lakes& lakes)
 {
-	osg::Vec3Array* posBuffer = new osg::Vec3Array();
-	osg::Vec3Array* normalBuffer = new osg::Vec3Array();
-	osg::Vec2Array* uvBuffer = new osg::Vec2Array();
-	osg::UIntArray* indexBuffer = new osg::UIntArray();
-
-	for (size_t i = 0; i < lakes.size(); ++i)
+	osg::BoundingBoxf bounds;
+	for (const Lake& lake : lakes)
 	{
-		createLake(lakes[i], posBuffer, normalBuffer, uvBuffer, indexBuffer);
+		for (const osg::Vec3f& point : lake.points)
+		{
+			bounds.expandBy(point - osg::Vec3(0, 0, lakeHeightAboveTerrain));
+		}
 	}
+	return bounds;
+}
 
-	osg::Geode* geode = new osg::Geode();
-	osg::Geometry* geometry = new osg::Geometry();
+osg::ref_ptr<osg::Geometry> createLakesGeometry(const Lakes& lakes)
+{
+	size_t vertexCount = 0;
+	size_t indexCount = 0;
+	for (const Lake& lake : lakes)
+	{
+		vertexCount += lake.points.size();
+		indexCount += (lake.points.size() - 2) * 3;
+	}
 
-	geometry->setVertexArray(posBuffer);
-	geometry->setNormalArray(normalBuffer);
-	geometry->setNormalBinding(osg::Geometry::BIND_PER_VERTEX);
+	// The lake shader only uses positions
+	QuantizedVertexArrays arrays;
+	arrays.normals = nullptr;
+	arrays.texCoords = nullptr;
+	arrays.reserve(vertexCount, indexCount);
 
-	geometry->setTexCoordArray(0, uvBuffer);
-	configureDrawable(*geometry);
+	osg::BoundingBoxf bounds = calcBounds(lakes);
+	PositionQuantizer quantizer(bounds);
 
-	geometry->addPrimitiveSet(new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, indexBuffer->size(), (GLuint*)indexBuffer->getDataPointer()));
+	for (size_t i = 0; i < lakes.size(); ++i)
+	{
+		createLake(lakes[i], quantizer, arrays);
+	}
 
-	geometry->setCullingActive(false); // TODO: set bounds and enable culling
-	geode->addDrawable(geometry);
-	return geode;
+	osg::ref_ptr<osg::Geometry> geometry = createQuantizedGeometry(arrays, quantizer);
+	// Bounds are set explicitly because OSG cannot compute bounds from quantized vertices
+	geometry->setComputeBoundingBoxCallback(createFixedBoundingBoxCallback(bounds));
+	geometry->setCullingActive(false); // TODO: enable culling. Bounds do not include wave displacement.
+	return geometry;
 }
 
 
@@ -130,7 +144,8 @@ LakesBatch::LakesBatch(const Lakes& lakes, const LakesConfig& config)
 {
 	mUniforms.modelMatrix = new osg::Uniform("modelMatrix", osg::Matrixf());
 
-	osg::Geode* geode = createLakes(lakes);
+	osg::Geode* geode = new osg::Geode();
+	geode->addDrawable(createLakesGeometry(lakes));
 	geode->setStateSet(createStateSet(config.program, mUniforms));
 
 	mTransform->setStateSet(config.waterStateSet);
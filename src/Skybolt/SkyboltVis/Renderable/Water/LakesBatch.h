@@ -7,6 +7,7 @@
 #pragma once
 
 #include "SkyboltVis/DefaultRootNode.h"
+#include <osg/Geometry>
 #include <osg/MatrixTransform>
 #include <osg/Texture2D>
 
@@ -20,6 +21,10 @@ struct Lake
 
 typedef std::vector<Lake> Lakes;
 
+//! Creates geometry for lakes using the compact vertex format described in VertexQuantization.h.
+//! Only positions are stored, because the lake shader derives everything else from position.
+osg::ref_ptr<osg::Geometry> createLakesGeometry(const Lakes& lakes);
+
 struct LakesConfig
 {
 	osg::ref_ptr<osg::Program> program;
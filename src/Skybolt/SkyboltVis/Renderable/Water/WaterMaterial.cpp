@@ -248,6 +248,11 @@ void WaterMaterial::update(double timeSeconds)
 	}
 }
 
+void WaterMaterial::setWaveTextureFrame(const WaveTextureFrame& frame)
+{
+	mWaveHeightTextureGenerator->setWaveTextureFrame(frame);
+}
+
 int WaterMaterial::getCascadeCount() const
 {
 	return mWaveHeightTextureGenerator->getTextureCount();
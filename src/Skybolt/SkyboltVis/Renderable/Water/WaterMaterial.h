@@ -16,6 +16,7 @@ namespace skybolt {
 namespace vis {
 
 class WaveHeightTextureGeneratorFactory;
+struct WaveTextureFrame;
 
 struct WaterMaterialConfig
 {
@@ -38,6 +39,9 @@ public:
 
 	void update(double timeSeconds);
 
+	//! Sets the frame used by the surface sampler to map planet positions to the wave textures. Should be updated every frame.
+	void setWaveTextureFrame(const WaveTextureFrame& frame);
+
 	osg::ref_ptr<osg::Texture2D> getHeightTexture(int cascadeIndex) const;
 	osg::ref_ptr<osg::Texture2D> getNormalTexture(int cascadeIndex) const;
 	osg::ref_ptr<osg::Texture2D> getFoamMaskTexture(int cascadeIndex) const;
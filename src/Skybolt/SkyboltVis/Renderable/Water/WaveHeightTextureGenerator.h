@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include "SkyboltVis/OsgGeocentric.h"
 #include "SkyboltVis/VisFactory.h"
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <SkyboltSim/OceanSurfaceSampler.h>
@@ -15,6 +16,28 @@
 namespace skybolt {
 namespace vis {
 
+//! Pose of a planet's ocean in vis world space, used to find where ocean shaders sample wave textures.
+//! Shaders sample wave textures at vis world space positions relative to the scene's wrapped noise origin
+//! (see calcWrappedNoiseCoord() in Shaders/GlobalUniforms.h), so the mapping from the planet surface to
+//! wave texture coordinates changes as the scene origin moves, and must be updated every frame.
+struct WaveTextureFrame
+{
+	double planetRadius;
+	osg::Vec3d planetPosition; //!< Planet center in vis world space
+	osg::Quat planetOrientation; //!< Planet orientation in vis world space
+	osg::Vec3d wrappedNoiseOrigin; //!< See Scene::getWrappedNoiseOrigin()
+};
+
+//! @returns the horizontal position, in meters along the vis world x and y axes, at which ocean shaders sample
+//! wave textures for the given point on the planet's surface. Dividing by a texture's world size gives the texture coordinate.
+inline osg::Vec2d toWaveTextureSpace(const WaveTextureFrame& frame, const sim::LatLon& position)
+{
+	osg::Vec3d geocentric = llaToGeocentric(osg::Vec2d(position.lat, position.lon), 0, frame.planetRadius);
+	osg::Vec3d positionWorld = frame.planetPosition + frame.planetOrientation * geocentric;
+	osg::Vec3d result = positionWorld - frame.wrappedNoiseOrigin;
+	return osg::Vec2d(result.x(), result.y());
+}
+
 class WaveHeightTextureGenerator
 {
 public:
@@ -34,6 +57,9 @@ public:
 	virtual osg::ref_ptr<osg::Texture2D> getTexture(int index) const = 0;
 	virtual float getTextureWorldSize(int index) const = 0;
 
+	//! Sets the frame which the surface sampler uses to map planet positions to the wave textures
+	virtual void setWaveTextureFrame(const WaveTextureFrame& frame) {}
+
 	//! @returns an interface for sampling the ocean surface eometry. Result is never null.
 	virtual skybolt::sim::OceanSurfaceSamplerPtr getSurfaceSampler() const
 	{
@@ -13,9 +13,12 @@
 namespace skybolt {
 namespace vis {
 
+class ShaderSourceCache;
+
 std::string loadFileToString(const std::string& filepath);
 
-osg::Shader* readShaderFile(osg::Shader::Type type, const std::string& filename);
+//! @param cache is used to preprocess the file. If null, a temporary cache is used.
+osg::Shader* readShaderFile(osg::Shader::Type type, const std::string& filename, ShaderSourceCache* cache = nullptr);
 osg::Shader* readShaderFromString(osg::Shader::Type type, const std::string& source, const std::optional<std::string>& includeDirPath = {});
 
 } // namespace vis
@@ -6,6 +6,7 @@
 
 #include "ShaderProgramRegistry.h"
 #include "OsgShaderHelpers.h"
+#include "ShaderSourceCache.h"
 
 namespace skybolt {
 namespace vis {
@@ -165,12 +166,18 @@ static ShaderProgramSourceFilesRegistry createShaderProgramSourceFilesRegistry()
 	};
 }
 
-osg::ref_ptr<osg::Program> createProgram(const std::string& name, const ShaderProgramSourceFiles& files)
+osg::ref_ptr<osg::Program> createProgram(const std::string& name, const ShaderProgramSourceFiles& files, ShaderSourceCache* cache)
 {
+	std::optional<ShaderSourceCache> temporaryCache;
+	if (!cache)
+	{
+		cache = &temporaryCache.emplace();
+	}
+
 	osg::ref_ptr<osg::Program> p = new osg::Program();
 	for (auto file : files)
 	{
-		p->addShader(vis::readShaderFile(file.first, file.second));
+		p->addShader(vis::readShaderFile(file.first, file.second, cache));
 	}
 	return p;
 }
@@ -181,17 +188,15 @@ ShaderPrograms createShaderPrograms()
 
 	ShaderProgramSourceFilesRegistry registry = createShaderProgramSourceFilesRegistry();
 
+	// Share a cache between all programs so that each shader file is only read and preprocessed once
+	auto cache = std::make_shared<ShaderSourceCache>();
+
 	for (const auto& i : registry)
 	{
-		osg::ref_ptr<osg::Program> p = new osg::Program();
-		for (auto shader : i.second)
-		{
-			p->addShader(vis::readShaderFile(shader.first, shader.second));
-		}
-		programs[i.first] = p;
+		programs[i.first] = createProgram(i.first, i.second, cache.get());
 	}
 
-	return ShaderPrograms(programs);
+	return ShaderPrograms(programs, cache);
 }
 
 } // namespace vis
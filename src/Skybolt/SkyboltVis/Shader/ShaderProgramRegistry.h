@@ -7,29 +7,41 @@
 #pragma once
 
 #include <osg/Program>
+#include <memory>
 
 namespace skybolt {
 namespace vis {
 
+class ShaderSourceCache;
+
 using NamedProgramsMap = std::map<std::string, osg::ref_ptr<osg::Program>>;
 
 class ShaderPrograms
 {
 public:
 	ShaderPrograms() {};
-	ShaderPrograms(const NamedProgramsMap& programs) : mPrograms(programs) {};
+	ShaderPrograms(const NamedProgramsMap& programs, const std::shared_ptr<ShaderSourceCache>& sourceCache = nullptr) :
+		mPrograms(programs),
+		mSourceCache(sourceCache)
+	{};
 
 	//! Throws exception if program not found
 	const osg::ref_ptr<osg::Program>& getRequiredProgram(const std::string& name) const;
 
 	const NamedProgramsMap& getPrograms() const { return mPrograms; }
 
+	//! @returns the cache used to preprocess the programs' shader files, or null if not known
+	const std::shared_ptr<ShaderSourceCache>& getSourceCache() const { return mSourceCache; }
+
 private:
 	NamedProgramsMap mPrograms;
+	std::shared_ptr<ShaderSourceCache> mSourceCache;
 };
 
 using ShaderProgramSourceFiles = std::map<osg::Shader::Type, std::string>; //!< Source code files for a program
-osg::ref_ptr<osg::Program> createProgram(const std::string& name, const ShaderProgramSourceFiles& files);
+
+//! @param cache is used to preprocess the shader files. If null, a temporary cache is used.
+osg::ref_ptr<osg::Program> createProgram(const std::string& name, const ShaderProgramSourceFiles& files, ShaderSourceCache* cache = nullptr);
 
 ShaderProgramSourceFiles getShaderSource_terrainFlatTile();
 
@@ -0,0 +1,287 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "ShaderSourceCache.h"
+
+#include <osgDB/FileUtils>
+#include <osgDB/Registry>
+
+#include <algorithm>
+#include <assert.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace skybolt {
+namespace vis {
+
+std::string resolveShaderFilename(const std::string& filename)
+{
+	return osgDB::Registry::instance()->findDataFile(filename, nullptr, osgDB::CASE_SENSITIVE);
+}
+
+std::optional<std::string> readShaderFileContents(const std::string& resolvedFilename)
+{
+	std::ifstream stream(resolvedFilename, std::ios::in);
+	if (!stream.is_open())
+	{
+		return std::nullopt;
+	}
+	return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+}
+
+static bool isSpace(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+std::optional<std::string_view> parseShaderIncludeDirective(std::string_view line)
+{
+	static constexpr std::string_view keyword = "include";
+
+	size_t i = 0;
+	auto skipSpaces = [&] {
+		while (i < line.size() && isSpace(line[i]))
+		{
+			++i;
+		}
+	};
+
+	skipSpaces();
+	if (i >= line.size() || line[i] != '#')
+	{
+		return std::nullopt;
+	}
+	++i;
+
+	skipSpaces();
+	if (line.substr(i, keyword.size()) != keyword)
+	{
+		return std::nullopt;
+	}
+	i += keyword.size();
+
+	// The keyword must be followed by a space, e.g. to reject '#included'
+	size_t keywordEnd = i;
+	skipSpaces();
+	if (i == keywordEnd || i >= line.size())
+	{
+		return std::nullopt;
+	}
+
+	char closingDelimiter;
+	if (line[i] == '"')
+	{
+		closingDelimiter = '"';
+	}
+	else if (line[i] == '<')
+	{
+		closingDelimiter = '>';
+	}
+	else
+	{
+		return std::nullopt;
+	}
+	++i;
+
+	size_t end = line.find(closingDelimiter, i);
+	if (end == std::string_view::npos)
+	{
+		return std::nullopt;
+	}
+	return line.substr(i, end - i);
+}
+
+ShaderSourceCache::ShaderSourceCache(const ShaderFileResolver& resolver, const ShaderFileReader& reader) :
+	mResolver(resolver),
+	mReader(reader)
+{
+	assert(mResolver);
+	assert(mReader);
+}
+
+std::string ShaderSourceCache::getPreprocessedSource(const std::string& filename)
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	std::string includeDirPath = std::filesystem::path(filename).parent_path().string();
+	std::vector<std::string> includeStack;
+	return preprocess(filename, includeDirPath, includeStack);
+}
+
+std::string ShaderSourceCache::preprocessSource(const std::string& source, const std::string& includeDirPath)
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	std::vector<std::string> includeStack;
+	std::set<std::string> dependencies;
+	return expandIncludes(source, findIncludeDirectives(source), includeDirPath, includeStack, dependencies);
+}
+
+std::set<std::string> ShaderSourceCache::getDependencies(const std::string& filename) const
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	std::set<std::string> result;
+	for (const auto& [key, file] : mPreprocessedFiles)
+	{
+		if (key.first == filename)
+		{
+			result.insert(file.dependencies.begin(), file.dependencies.end());
+		}
+	}
+	return result;
+}
+
+std::set<std::string> ShaderSourceCache::invalidate(const std::string& resolvedFilename)
+{
+	std::string normalizedFilename = std::filesystem::path(resolvedFilename).lexically_normal().string();
+
+	std::scoped_lock<std::mutex> lock(mMutex);
+	mSourceFiles.erase(normalizedFilename);
+
+	std::set<std::string> result;
+	for (auto i = mPreprocessedFiles.begin(); i != mPreprocessedFiles.end();)
+	{
+		if (i->second.dependencies.count(normalizedFilename))
+		{
+			result.insert(i->second.filename);
+			i = mPreprocessedFiles.erase(i);
+		}
+		else
+		{
+			++i;
+		}
+	}
+	return result;
+}
+
+size_t ShaderSourceCache::getFileReadCount() const
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	return mFileReadCount;
+}
+
+std::string ShaderSourceCache::preprocess(const std::string& filename, const std::string& includeDirPath, std::vector<std::string>& includeStack)
+{
+	auto key = std::make_pair(filename, includeDirPath);
+	if (auto i = mPreprocessedFiles.find(key); i != mPreprocessedFiles.end())
+	{
+		return i->second.source;
+	}
+
+	std::string resolvedFilename = resolve(filename);
+	if (std::find(includeStack.begin(), includeStack.end(), resolvedFilename) != includeStack.end())
+	{
+		throw std::runtime_error("Cyclic shader include of file: " + filename);
+	}
+
+	const SourceFile& file = getSourceFile(resolvedFilename, filename);
+
+	PreprocessedFile result;
+	result.filename = filename;
+	result.dependencies.insert(resolvedFilename);
+
+	includeStack.push_back(resolvedFilename);
+	result.source = expandIncludes(file.source, file.includes, includeDirPath, includeStack, result.dependencies);
+	includeStack.pop_back();
+
+	return mPreprocessedFiles.emplace(key, std::move(result)).first->second.source;
+}
+
+std::string ShaderSourceCache::expandIncludes(const std::string& source, const std::vector<IncludeDirective>& includes, const std::string& includeDirPath,
+	std::vector<std::string>& includeStack, std::set<std::string>& dependencies)
+{
+	if (includes.empty())
+	{
+		return source;
+	}
+
+	std::string result;
+	result.reserve(source.size());
+
+	size_t position = 0;
+	for (const IncludeDirective& include : includes)
+	{
+		result.append(source, position, include.lineBegin - position);
+
+		std::string includeFilename = includeDirPath + "/" + include.filename;
+		result += preprocess(includeFilename, includeDirPath, includeStack);
+		result += '\n';
+
+		// Included files are preprocessed and cached before their dependencies are read
+		auto i = mPreprocessedFiles.find(std::make_pair(includeFilename, includeDirPath));
+		assert(i != mPreprocessedFiles.end());
+		dependencies.insert(i->second.dependencies.begin(), i->second.dependencies.end());
+
+		position = include.lineEnd;
+	}
+	result.append(source, position);
+	return result;
+}
+
+std::string ShaderSourceCache::resolve(const std::string& filename)
+{
+	if (auto i = mResolvedFilenames.find(filename); i != mResolvedFilenames.end())
+	{
+		return i->second;
+	}
+
+	std::string resolvedFilename = mResolver(filename);
+	if (resolvedFilename.empty())
+	{
+		throw std::runtime_error("Could not find shader file: " + filename);
+	}
+	resolvedFilename = std::filesystem::path(resolvedFilename).lexically_normal().string();
+	mResolvedFilenames[filename] = resolvedFilename;
+	return resolvedFilename;
+}
+
+ShaderSourceCache::SourceFile& ShaderSourceCache::getSourceFile(const std::string& resolvedFilename, const std::string& filename)
+{
+	if (auto i = mSourceFiles.find(resolvedFilename); i != mSourceFiles.end())
+	{
+		return i->second;
+	}
+
+	std::optional<std::string> source = mReader(resolvedFilename);
+	++mFileReadCount;
+	if (!source)
+	{
+		throw std::runtime_error("Could not open file: " + filename);
+	}
+
+	SourceFile file;
+	file.includes = findIncludeDirectives(*source);
+	file.source = std::move(*source);
+	return mSourceFiles.emplace(resolvedFilename, std::move(file)).first->second;
+}
+
+std::vector<ShaderSourceCache::IncludeDirective> ShaderSourceCache::findIncludeDirectives(const std::string& source)
+{
+	std::vector<IncludeDirective> result;
+	std::string_view view(source);
+
+	size_t lineBegin = 0;
+	while (lineBegin < view.size())
+	{
+		size_t lineBreak = view.find('\n', lineBegin);
+		size_t lineEnd = (lineBreak == std::string_view::npos) ? view.size() : lineBreak + 1;
+
+		// Cheap rejection of lines that cannot be directives before parsing
+		std::string_view line = view.substr(lineBegin, lineEnd - lineBegin);
+		if (line.find('#') != std::string_view::npos)
+		{
+			if (std::optional<std::string_view> filename = parseShaderIncludeDirective(line); filename)
+			{
+				result.push_back({lineBegin, lineEnd, std::string(*filename)});
+			}
+		}
+		lineBegin = lineEnd;
+	}
+	return result;
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,104 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+//! @returns the path of a file found in the data file search paths, or an empty string if the file is not found
+using ShaderFileResolver = std::function<std::string(const std::string& filename)>;
+
+//! @returns the contents of a resolved file, or nullopt if the file cannot be read
+using ShaderFileReader = std::function<std::optional<std::string>(const std::string& resolvedFilename)>;
+
+std::string resolveShaderFilename(const std::string& filename);
+std::optional<std::string> readShaderFileContents(const std::string& resolvedFilename);
+
+//! @returns the filename in an #include "filename" or #include <filename> directive, or nullopt if the line is not an include directive
+std::optional<std::string_view> parseShaderIncludeDirective(std::string_view line);
+
+//! Preprocesses shader source files by expanding #include directives.
+//! Each file is read from disk once and each preprocessed file is cached, so that includes shared by many shaders are only read and expanded once.
+//! The cache records the include graph, so that when a file changes, only the files that depend on it need to be preprocessed again.
+//! Include paths are relative to the include directory, which is the directory of the top level shader file.
+//! @ThreadSafe
+class ShaderSourceCache
+{
+public:
+	ShaderSourceCache(const ShaderFileResolver& resolver = &resolveShaderFilename, const ShaderFileReader& reader = &readShaderFileContents);
+
+	//! @returns the file's source with includes expanded
+	//! @throws std::runtime_error if a file is not found or includes are cyclic
+	std::string getPreprocessedSource(const std::string& filename);
+
+	//! @returns the source with includes expanded
+	//! @throws std::runtime_error if an included file is not found or includes are cyclic
+	std::string preprocessSource(const std::string& source, const std::string& includeDirPath);
+
+	//! @returns resolved filenames of the file and every file it includes directly or indirectly.
+	//! Only known for files that have been preprocessed.
+	std::set<std::string> getDependencies(const std::string& filename) const;
+
+	//! Removes a changed file from the cache, along with the preprocessed source of every file that includes it directly or indirectly.
+	//! @param resolvedFilename is the path of the changed file
+	//! @returns the filenames, as passed to getPreprocessedSource(), whose preprocessed source has changed
+	std::set<std::string> invalidate(const std::string& resolvedFilename);
+
+	//! @returns number of files read since construction
+	size_t getFileReadCount() const;
+
+private:
+	struct IncludeDirective
+	{
+		size_t lineBegin; //!< Offset of the first character of the directive's line
+		size_t lineEnd; //!< Offset after the end of the directive's line, including the line break
+		std::string filename;
+	};
+
+	struct SourceFile
+	{
+		std::string source;
+		std::vector<IncludeDirective> includes;
+	};
+
+	struct PreprocessedFile
+	{
+		std::string filename;
+		std::string source;
+		std::set<std::string> dependencies; //!< Resolved filenames of the file and all its includes
+	};
+
+	std::string preprocess(const std::string& filename, const std::string& includeDirPath, std::vector<std::string>& includeStack);
+	std::string expandIncludes(const std::string& source, const std::vector<IncludeDirective>& includes, const std::string& includeDirPath,
+		std::vector<std::string>& includeStack, std::set<std::string>& dependencies);
+	std::string resolve(const std::string& filename);
+	SourceFile& getSourceFile(const std::string& resolvedFilename, const std::string& filename);
+
+	static std::vector<IncludeDirective> findIncludeDirectives(const std::string& source);
+
+private:
+	const ShaderFileResolver mResolver;
+	const ShaderFileReader mReader;
+
+	mutable std::mutex mMutex;
+	std::map<std::string, std::string> mResolvedFilenames; //!< Maps filename to resolved filename
+	std::map<std::string, SourceFile> mSourceFiles; //!< Keyed on resolved filename
+	std::map<std::pair<std::string, std::string>, PreprocessedFile> mPreprocessedFiles; //!< Keyed on filename and include directory
+	size_t mFileReadCount = 0;
+};
+
+} // namespace vis
+} // namespace skybolt
@@ -6,9 +6,10 @@
 
 #include "ShaderSourceFileChangeMonitor.h"
 #include "OsgShaderHelpers.h"
+#include "ShaderSourceCache.h"
 #include "ThirdParty/FileWatch.h"
 
-#include <osgDB/Registry>
+#include <boost/log/trivial.hpp>
 #include <filesystem>
 
 namespace skybolt {
@@ -20,35 +21,49 @@ struct WatcherImpl
 	filewatch::FileWatch<std::string> watcher;
 };
 
-static std::string resolveFilename(const std::string& filename)
-{
-	return osgDB::Registry::instance()->findDataFile(filename, nullptr, osgDB::CASE_SENSITIVE);
-}
-
-static std::set<std::filesystem::path> findShaderDirectories(const NamedProgramsMap& programs)
+//! @returns directories of the shader files and all files they include
+static std::set<std::filesystem::path> findShaderDirectories(const NamedProgramsMap& programs, ShaderSourceCache& cache)
 {
 	std::set<std::filesystem::path> directories;
 	for (const auto& [name, program] : programs)
 	{
 		for (unsigned int i = 0; i < program->getNumShaders(); ++i)
 		{
-			osg::Shader* shader = program->getShader(i);
-			auto resolvedFilename = resolveFilename(shader->getFileName());
-			if (!resolvedFilename.empty())
+			const std::string& filename = program->getShader(i)->getFileName();
+			if (filename.empty())
 			{
-				auto directory = std::filesystem::path(resolvedFilename).parent_path();
-				directories.insert(directory);
+				continue;
+			}
+
+			std::set<std::string> dependencies = cache.getDependencies(filename);
+			if (dependencies.empty())
+			{
+				// File was not preprocessed by the cache, so preprocess it to discover its includes
+				try
+				{
+					cache.getPreprocessedSource(filename);
+					dependencies = cache.getDependencies(filename);
+				}
+				catch (const std::exception& e)
+				{
+					BOOST_LOG_TRIVIAL(warning) << "Could not preprocess shader file: " << e.what();
+				}
+			}
+
+			for (const std::string& dependency : dependencies)
+			{
+				directories.insert(std::filesystem::path(dependency).parent_path());
 			}
 		}
 	}
 	return directories;
 }
 
-
 ShaderSourceFileChangeMonitor::ShaderSourceFileChangeMonitor(const ShaderPrograms& programs) :
-	mPrograms(programs)
+	mPrograms(programs),
+	mSourceCache(programs.getSourceCache() ? programs.getSourceCache() : std::make_shared<ShaderSourceCache>())
 {
-	std::set<std::filesystem::path> directories = findShaderDirectories(programs.getPrograms());
+	std::set<std::filesystem::path> directories = findShaderDirectories(programs.getPrograms(), *mSourceCache);
 
 	// Create watcher for each directory
 	for (const auto directory : directories)
@@ -85,6 +100,13 @@ void ShaderSourceFileChangeMonitor::update()
 
 void ShaderSourceFileChangeMonitor::reloadShadersUsingFile(const std::string& filename)
 {
+	// Find shader files that depend on the changed file directly or through includes
+	std::set<std::string> changedShaderFiles = mSourceCache->invalidate(filename);
+	if (changedShaderFiles.empty())
+	{
+		return;
+	}
+
 	for (const auto& [programName, program] : mPrograms.getPrograms())
 	{
 		std::vector<osg::ref_ptr<osg::Shader>> shaders(program->getNumShaders());
@@ -95,11 +117,18 @@ void ShaderSourceFileChangeMonitor::reloadShadersUsingFile(const std::string& fi
 
 		for (const auto& shader : shaders)
 		{
-			if (resolveFilename(shader->getFileName()) == filename)
+			if (changedShaderFiles.count(shader->getFileName()))
 			{
-				// Reload
-				program->removeShader(shader);
-				program->addShader(vis::readShaderFile(shader->getType(), shader->getFileName()));
+				try
+				{
+					osg::ref_ptr<osg::Shader> reloadedShader = vis::readShaderFile(shader->getType(), shader->getFileName(), mSourceCache.get());
+					program->removeShader(shader);
+					program->addShader(reloadedShader);
+				}
+				catch (const std::exception& e)
+				{
+					BOOST_LOG_TRIVIAL(error) << "Could not reload shader in program '" << programName << "': " << e.what();
+				}
 			}
 		}
 	}
@@ -16,7 +16,7 @@
 namespace skybolt {
 namespace vis {
 
-//! Monitors shader files and reloads file and associated program if the file changes on disk
+//! Monitors shader files, including files included by shaders, and reloads the shaders that depend on a file when the file changes on disk
 class ShaderSourceFileChangeMonitor
 {
 public:
@@ -30,6 +30,7 @@ private:
 
 private:
 	ShaderPrograms mPrograms;
+	std::shared_ptr<ShaderSourceCache> mSourceCache;
 	std::mutex mChangedFilesMutex;
 	std::set<std::string> mChangedFiles;
 	std::vector<std::shared_ptr<struct WatcherImpl>> mWatchers;
@@ -34,6 +34,7 @@ class LlaToNedConverter;
 class GpuForest;
 class GpuForestTile;
 class GpuTextureGenerator;
+class HeightMapElevationProvider;
 class JsonTileSourceFactoryRegistry;
 class Model;
 class ModelFactory;
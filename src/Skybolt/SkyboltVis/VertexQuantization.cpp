@@ -0,0 +1,178 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "VertexQuantization.h"
+#include "OsgGeometryHelpers.h"
+
+#include <osg/StateSet>
+#include <osg/Uniform>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace skybolt {
+namespace vis {
+
+constexpr float maxUnsignedShort = float(std::numeric_limits<unsigned short>::max());
+constexpr float maxShort = float(std::numeric_limits<short>::max());
+
+static unsigned short quantizeUnsigned(float value)
+{
+	return (unsigned short)std::lround(std::clamp(value, 0.f, maxUnsignedShort));
+}
+
+static short quantizeSignedNormalized(float value)
+{
+	return (short)std::lround(std::clamp(value, -1.f, 1.f) * maxShort);
+}
+
+static float dequantizeSignedNormalized(short value)
+{
+	// Matches OpenGL's conversion of signed normalized integers
+	return std::max(float(value) / maxShort, -1.f);
+}
+
+PositionQuantizer::PositionQuantizer(const osg::BoundingBoxf& bounds)
+{
+	if (bounds.valid())
+	{
+		mOffset = bounds._min;
+		osg::Vec3f extent = bounds._max - bounds._min;
+		for (int i = 0; i < 3; ++i)
+		{
+			// Avoid division by zero for flat bounds
+			mScale[i] = std::max(extent[i], 1e-6f) / maxUnsignedShort;
+		}
+	}
+	else
+	{
+		mOffset = osg::Vec3f(0, 0, 0);
+		mScale = osg::Vec3f(1, 1, 1);
+	}
+}
+
+osg::Vec4us PositionQuantizer::quantize(const osg::Vec3f& position, unsigned short w) const
+{
+	osg::Vec3f p = osg::componentDivide(position - mOffset, mScale);
+	return osg::Vec4us(quantizeUnsigned(p.x()), quantizeUnsigned(p.y()), quantizeUnsigned(p.z()), w);
+}
+
+osg::Vec3f PositionQuantizer::dequantize(const osg::Vec4us& quantized) const
+{
+	return mOffset + osg::componentMultiply(osg::Vec3f(quantized.x(), quantized.y(), quantized.z()), mScale);
+}
+
+void PositionQuantizer::addUniforms(osg::StateSet& stateSet) const
+{
+	stateSet.addUniform(new osg::Uniform("positionDequantizeOffset", mOffset));
+	stateSet.addUniform(new osg::Uniform("positionDequantizeScale", mScale));
+}
+
+static float signNotZero(float v)
+{
+	return (v >= 0.f) ? 1.f : -1.f;
+}
+
+osg::Vec2s encodeOctahedralNormal(const osg::Vec3f& normal)
+{
+	// Project onto octahedron, then unfold the lower hemisphere onto the outer triangles of the square
+	float l1Norm = std::abs(normal.x()) + std::abs(normal.y()) + std::abs(normal.z());
+	if (l1Norm <= 0.f)
+	{
+		return osg::Vec2s(0, 0);
+	}
+
+	osg::Vec2f p(normal.x() / l1Norm, normal.y() / l1Norm);
+	if (normal.z() < 0.f)
+	{
+		p = osg::Vec2f(
+			(1.f - std::abs(p.y())) * signNotZero(p.x()),
+			(1.f - std::abs(p.x())) * signNotZero(p.y()));
+	}
+	return osg::Vec2s(quantizeSignedNormalized(p.x()), quantizeSignedNormalized(p.y()));
+}
+
+osg::Vec3f decodeOctahedralNormal(const osg::Vec2s& encoded)
+{
+	float x = dequantizeSignedNormalized(encoded.x());
+	float y = dequantizeSignedNormalized(encoded.y());
+	osg::Vec3f v(x, y, 1.f - std::abs(x) - std::abs(y));
+	if (v.z() < 0.f)
+	{
+		v.x() = (1.f - std::abs(y)) * signNotZero(x);
+		v.y() = (1.f - std::abs(x)) * signNotZero(y);
+	}
+	v.normalize();
+	return v;
+}
+
+static short quantizeFixedPoint(float value)
+{
+	return (short)std::lround(std::clamp(value * texCoordQuantizationStepsPerUnit, -maxShort, maxShort));
+}
+
+osg::Vec4s quantizeTexCoord(const osg::Vec2f& texCoord, short z, short w)
+{
+	return osg::Vec4s(quantizeFixedPoint(texCoord.x()), quantizeFixedPoint(texCoord.y()), z, w);
+}
+
+osg::Vec2f dequantizeTexCoordXy(const osg::Vec4s& quantized)
+{
+	return osg::Vec2f(quantized.x(), quantized.y()) / texCoordQuantizationStepsPerUnit;
+}
+
+QuantizedVertexArrays::QuantizedVertexArrays() :
+	positions(new osg::Vec4usArray),
+	normals(new osg::Vec2sArray),
+	texCoords(new osg::Vec4sArray),
+	indices(new osg::UIntArray)
+{
+}
+
+void QuantizedVertexArrays::reserve(size_t vertexCount, size_t indexCount)
+{
+	positions->reserve(vertexCount);
+	if (normals)
+	{
+		normals->reserve(vertexCount);
+	}
+	if (texCoords)
+	{
+		texCoords->reserve(vertexCount);
+	}
+	indices->reserve(indexCount);
+}
+
+osg::ref_ptr<osg::Geometry> createQuantizedGeometry(const QuantizedVertexArrays& arrays, const PositionQuantizer& quantizer)
+{
+	osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry();
+
+	// Positions and texture coordinates are converted to float without normalization and rescaled in the shader
+	arrays.positions->setNormalize(false);
+	geometry->setVertexArray(arrays.positions);
+
+	if (arrays.normals && !arrays.normals->empty())
+	{
+		geometry->setNormalArray(arrays.normals, osg::Array::BIND_PER_VERTEX);
+		arrays.normals->setNormalize(true);
+	}
+
+	if (arrays.texCoords && !arrays.texCoords->empty())
+	{
+		arrays.texCoords->setNormalize(false);
+		geometry->setTexCoordArray(0, arrays.texCoords, osg::Array::BIND_PER_VERTEX);
+	}
+
+	configureDrawable(*geometry);
+	geometry->addPrimitiveSet(new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLES, arrays.indices->size(), (GLuint*)arrays.indices->getDataPointer()));
+
+	quantizer.addUniforms(*geometry->getOrCreateStateSet());
+	return geometry;
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,73 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <osg/Array>
+#include <osg/BoundingBox>
+#include <osg/Geometry>
+
+namespace skybolt {
+namespace vis {
+
+//! Compact vertex attributes for large batches of static geometry, decoded in shaders by Shaders/VertexQuantization.h:
+//! - Positions are 16-bit unsigned integers within the batch bounding box. The fourth component is free for per-vertex data.
+//! - Normals are octahedral encoded into two 16-bit signed normalized integers.
+//! - Texture coordinates xy are 16-bit fixed point numbers. zw are 16-bit integers, e.g. for texture array layers.
+
+//! Number of fixed point steps per texture repeat.
+//! Texture coordinates must be within +/- 32767 / texCoordQuantizationStepsPerUnit.
+//! Must match texCoordDequantizeScale in Shaders/VertexQuantization.h
+constexpr float texCoordQuantizationStepsPerUnit = 256;
+
+//! Maps positions within a bounding box to 16-bit unsigned integers
+class PositionQuantizer
+{
+public:
+	explicit PositionQuantizer(const osg::BoundingBoxf& bounds);
+
+	//! Positions outside the bounds are clamped
+	osg::Vec4us quantize(const osg::Vec3f& position, unsigned short w = 0) const;
+	osg::Vec3f dequantize(const osg::Vec4us& quantized) const;
+
+	//! @returns the maximum per axis distance between a position within the bounds and its reconstruction
+	osg::Vec3f getMaxError() const { return mScale * 0.5f; }
+
+	//! Adds uniforms which shaders use to dequantize positions
+	void addUniforms(osg::StateSet& stateSet) const;
+
+private:
+	osg::Vec3f mOffset;
+	osg::Vec3f mScale;
+};
+
+osg::Vec2s encodeOctahedralNormal(const osg::Vec3f& normal);
+osg::Vec3f decodeOctahedralNormal(const osg::Vec2s& encoded);
+
+//! Values outside the representable range are clamped
+osg::Vec4s quantizeTexCoord(const osg::Vec2f& texCoord, short z = 0, short w = 0);
+osg::Vec2f dequantizeTexCoordXy(const osg::Vec4s& quantized);
+
+//! Quantized vertex arrays, which should be reserved to their final size before filling
+struct QuantizedVertexArrays
+{
+	QuantizedVertexArrays();
+
+	void reserve(size_t vertexCount, size_t indexCount);
+
+	osg::ref_ptr<osg::Vec4usArray> positions;
+	osg::ref_ptr<osg::Vec2sArray> normals; //!< Optional
+	osg::ref_ptr<osg::Vec4sArray> texCoords; //!< Optional
+	osg::ref_ptr<osg::UIntArray> indices;
+};
+
+//! Creates triangle geometry from quantized arrays.
+//! Null or empty optional arrays are omitted.
+//! Dequantization uniforms are added to the geometry's StateSet.
+osg::ref_ptr<osg::Geometry> createQuantizedGeometry(const QuantizedVertexArrays& arrays, const PositionQuantizer& quantizer);
+
+} // namespace vis
+} // namespace skybolt
@@ -5,84 +5,89 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "CaptureScreenshot.h"
+#include "FrameCaptureEncoder.h"
 #include "VisRoot.h"
+#include "Window.h"
 
-#include <osgViewer/CompositeViewer>
-#include <osgViewer/ViewerEventHandlers>
-#include <osgDB/WriteFile>
-
-#include <filesystem>
+#include <osg/GraphicsContext>
 
 namespace skybolt {
 namespace vis {
 
-struct StoreImage : public osgViewer::ScreenCaptureHandler::CaptureOperation
+//! Reads the camera's framebuffer directly into a new image, after calling the camera's existing final draw callback
+class ReadPixelsDrawCallback : public osg::Camera::DrawCallback
 {
-    void operator() (const osg::Image& img, const unsigned int context_id) override
+public:
+	explicit ReadPixelsDrawCallback(const osg::ref_ptr<osg::Camera::DrawCallback>& previousCallback) :
+		mPreviousCallback(previousCallback)
+	{
+	}
+
+	void operator() (osg::RenderInfo& renderInfo) const override
 	{
-		// Only capture from first context for now. TODO: write out one image per context.
-		if (!image)
+		if (mPreviousCallback)
 		{
-			image = new osg::Image(img, osg::CopyOp::DEEP_COPY_ALL);
+			(*mPreviousCallback)(renderInfo);
 		}
-	}
 
-    osg::ref_ptr<osg::Image> image;
-};
+		if (image)
+		{
+			return;
+		}
 
-osg::ref_ptr<osg::Image> captureScreenshot(VisRoot& visRoot)
-{
-	osg::ref_ptr<StoreImage> storeImage = new StoreImage();
-	osg::ref_ptr<osgViewer::ScreenCaptureHandler> screenCaptureHandler = new osgViewer::ScreenCaptureHandler(storeImage);
+		const osg::Camera* camera = renderInfo.getCurrentCamera();
+		const osg::Viewport* viewport = camera->getViewport();
+		if (!viewport)
+		{
+			return;
+		}
 
-	screenCaptureHandler->setFramesToCapture(1);
-	screenCaptureHandler->captureNextFrame(visRoot.getViewer());
-	visRoot.render();
-	screenCaptureHandler->stopCapture();
+		const osg::GraphicsContext* context = camera->getGraphicsContext();
+		bool doubleBuffer = context && context->getTraits() && context->getTraits()->doubleBuffer;
+		glReadBuffer(doubleBuffer ? GL_BACK : GL_FRONT);
 
-	return storeImage->image;
-}
+		image = new osg::Image;
+		image->readPixels(int(viewport->x()), int(viewport->y()), int(viewport->width()), int(viewport->height()), GL_RGBA, GL_UNSIGNED_BYTE, 1);
+	}
+
+	mutable osg::ref_ptr<osg::Image> image;
+
+private:
+	osg::ref_ptr<osg::Camera::DrawCallback> mPreviousCallback;
+};
 
-class WriteToFile : public osgViewer::ScreenCaptureHandler::CaptureOperation
+osg::ref_ptr<osg::Image> captureScreenshot(VisRoot& visRoot)
 {
-public:
-    WriteToFile(const std::string& filename) :
-		mFilename(filename)
+	// Only capture from first window for now. TODO: capture one image per window.
+	if (visRoot.getWindows().empty())
 	{
+		return nullptr;
 	}
+	osg::Camera* camera = visRoot.getWindows().front()->getView()->getCamera();
+
+	// The caller expects the image on return, so a frame must be rendered now. The previous frame's back buffer is undefined after the swap,
+	// and a FrameCaptureService readback only completes after later frames have been rendered.
+	// Chain the existing callback, e.g. a FrameCaptureService, so that it still runs for the screenshot frame.
+	osg::ref_ptr<osg::Camera::DrawCallback> previousCallback = camera->getFinalDrawCallback();
+	osg::ref_ptr<ReadPixelsDrawCallback> callback = new ReadPixelsDrawCallback(previousCallback);
+	camera->setFinalDrawCallback(callback);
+	visRoot.render();
 
-    void operator() (const osg::Image& image, const unsigned int context_id) override
+	// Only restore the previous callback if it was not replaced during rendering
+	if (camera->getFinalDrawCallback() == callback.get())
 	{
-		// Only capture from first context for now. TODO: write out one image per context.
-		if (!mCaptured)
-		{
-			osgDB::writeImageFile(image, mFilename);
-			mCaptured = true;
-		}
+		camera->setFinalDrawCallback(previousCallback);
 	}
 
-protected:
-    const std::string mFilename;
-	bool mCaptured = false;
-};
+	return callback->image;
+}
 
 void captureScreenshot(VisRoot& visRoot, const std::string& filename)
 {
-	// Create directory if it does not already exist
-	std::filesystem::path path(filename);
-	if (!std::filesystem::exists(path.parent_path()))
+	if (osg::ref_ptr<osg::Image> image = captureScreenshot(visRoot); image)
 	{
-		std::filesystem::create_directories(path.parent_path());
+		writeCapturedImage(*image, filename);
 	}
-
-	// Capture
-	osg::ref_ptr<WriteToFile> writeToFile = new WriteToFile(filename);
-	osg::ref_ptr<osgViewer::ScreenCaptureHandler> screenCaptureHandler = new osgViewer::ScreenCaptureHandler(writeToFile);
-
-	screenCaptureHandler->setFramesToCapture(1);
-	screenCaptureHandler->captureNextFrame(visRoot.getViewer());
-	visRoot.render();
-	screenCaptureHandler->stopCapture();
 }
 
 } // namespace vis
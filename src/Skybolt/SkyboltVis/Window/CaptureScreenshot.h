@@ -14,7 +14,11 @@
 namespace skybolt {
 namespace vis {
 
+//! Renders a frame and returns the image read back from the first window.
+//! The readback stalls the render thread, so use FrameCaptureService to capture frames which are already being rendered.
 osg::ref_ptr<osg::Image> captureScreenshot(VisRoot& visRoot);
+
+//! Renders a frame and writes the image from the first window to file
 void captureScreenshot(VisRoot& visRoot, const std::string& filename);
 
 } // namespace vis
@@ -0,0 +1,198 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "FrameCaptureEncoder.h"
+
+#include <osgDB/WriteFile>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <assert.h>
+#include <filesystem>
+#include <fstream>
+
+namespace skybolt {
+namespace vis {
+
+std::optional<ImageFileFormat> getImageFileFormat(const std::string& filename)
+{
+	std::string extension = boost::algorithm::to_lower_copy(std::filesystem::path(filename).extension().string());
+	if (extension == ".png")
+	{
+		return ImageFileFormat::Png;
+	}
+	else if (extension == ".raw")
+	{
+		return ImageFileFormat::Raw;
+	}
+	else if (extension == ".exr")
+	{
+		return ImageFileFormat::Exr;
+	}
+	return std::nullopt;
+}
+
+static bool writeRawImage(const osg::Image& image, const std::string& filename)
+{
+	std::ofstream f(filename, std::ios::binary);
+	if (!f.is_open())
+	{
+		return false;
+	}
+
+	// Write rows individually because rows may be padded
+	const unsigned int rowSizeInBytes = image.getRowSizeInBytes();
+	for (int t = 0; t < image.t(); ++t)
+	{
+		f.write(reinterpret_cast<const char*>(image.data(0, t)), rowSizeInBytes);
+	}
+	return f.good();
+}
+
+//! @returns image with float channels, suitable for writing to EXR
+static osg::ref_ptr<const osg::Image> toFloatImage(const osg::Image& image)
+{
+	if (image.getDataType() == GL_FLOAT)
+	{
+		return &image;
+	}
+
+	osg::ref_ptr<osg::Image> result = new osg::Image;
+	result->allocateImage(image.s(), image.t(), 1, image.getPixelFormat(), GL_FLOAT);
+	for (int t = 0; t < image.t(); ++t)
+	{
+		for (int s = 0; s < image.s(); ++s)
+		{
+			result->setColor(image.getColor(s, t), s, t);
+		}
+	}
+	return result;
+}
+
+bool writeCapturedImage(const osg::Image& image, const std::string& filename)
+{
+	std::filesystem::path path(filename);
+	if (path.has_parent_path())
+	{
+		std::error_code ec;
+		std::filesystem::create_directories(path.parent_path(), ec);
+	}
+
+	std::optional<ImageFileFormat> format = getImageFileFormat(filename);
+	if (!format)
+	{
+		// Let osgDB choose a writer for any other extension
+		return osgDB::writeImageFile(image, filename);
+	}
+
+	switch (*format)
+	{
+		case ImageFileFormat::Png:
+			return osgDB::writeImageFile(image, filename);
+		case ImageFileFormat::Raw:
+			return writeRawImage(image, filename);
+		case ImageFileFormat::Exr:
+			return osgDB::writeImageFile(*toFloatImage(image), filename);
+	}
+	return false;
+}
+
+FrameCaptureEncoder::FrameCaptureEncoder(const FrameCaptureEncoderConfig& config) :
+	mConfig(config)
+{
+	assert(mConfig.writer);
+	assert(mConfig.maxQueuedImages > 0);
+
+	for (int i = 0; i < std::max(1, mConfig.workerCount); ++i)
+	{
+		mWorkers.emplace_back([this] { runWorker(); });
+	}
+}
+
+FrameCaptureEncoder::~FrameCaptureEncoder()
+{
+	{
+		std::scoped_lock<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mJobAvailable.notify_all();
+
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+bool FrameCaptureEncoder::submit(const osg::ref_ptr<const osg::Image>& image, const std::string& filename)
+{
+	assert(image);
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		if (mJobs.size() >= mConfig.maxQueuedImages)
+		{
+			if (mConfig.overflowPolicy == FrameCaptureEncoderConfig::OverflowPolicy::Drop)
+			{
+				++mStats.droppedCount;
+				return false;
+			}
+			mQueueChanged.wait(lock, [this] { return mJobs.size() < mConfig.maxQueuedImages; });
+		}
+
+		mJobs.push_back({image, filename});
+		++mStats.submittedCount;
+	}
+	mJobAvailable.notify_one();
+	return true;
+}
+
+void FrameCaptureEncoder::flush()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mQueueChanged.wait(lock, [this] { return mJobs.empty() && mActiveJobCount == 0; });
+}
+
+FrameCaptureEncoderStats FrameCaptureEncoder::getStats() const
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	return mStats;
+}
+
+void FrameCaptureEncoder::runWorker()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mJobAvailable.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+			if (mJobs.empty())
+			{
+				return; // Stopping and all jobs have been taken
+			}
+
+			job = std::move(mJobs.front());
+			mJobs.pop_front();
+			++mActiveJobCount;
+		}
+		mQueueChanged.notify_all();
+
+		bool written = mConfig.writer(*job.image, job.filename);
+		if (!written)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Could not write captured image: " << job.filename;
+		}
+
+		{
+			std::scoped_lock<std::mutex> lock(mMutex);
+			--mActiveJobCount;
+			++(written ? mStats.writtenCount : mStats.failedCount);
+		}
+		mQueueChanged.notify_all();
+	}
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,105 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <osg/Image>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+enum class ImageFileFormat
+{
+	Png,
+	Raw, //!< Pixel data without a header, with rows in OpenGL order (bottom row first)
+	Exr //!< 32 bit float channels
+};
+
+//! @returns the format implied by the filename's extension, or nullopt if the extension is not supported
+std::optional<ImageFileFormat> getImageFileFormat(const std::string& filename);
+
+//! Writes an image in the format implied by the filename's extension, creating parent directories if necessary.
+//! @returns false if the image could not be written
+bool writeCapturedImage(const osg::Image& image, const std::string& filename);
+
+using CapturedImageWriter = std::function<bool(const osg::Image& image, const std::string& filename)>;
+
+struct FrameCaptureEncoderConfig
+{
+	int workerCount = 2;
+	size_t maxQueuedImages = 8;
+
+	enum class OverflowPolicy
+	{
+		Block, //!< submit() blocks until there is space in the queue
+		Drop //!< submit() discards the image if the queue is full
+	};
+	OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+
+	CapturedImageWriter writer = &writeCapturedImage;
+};
+
+struct FrameCaptureEncoderStats
+{
+	size_t submittedCount = 0;
+	size_t writtenCount = 0;
+	size_t failedCount = 0;
+	size_t droppedCount = 0;
+};
+
+//! Encodes and writes captured images to file on worker threads, so that encoding does not block the render thread.
+//! Images are owned by the encoder once submitted and must not be modified by the caller.
+class FrameCaptureEncoder
+{
+public:
+	FrameCaptureEncoder(const FrameCaptureEncoderConfig& config = {});
+
+	//! Writes all queued images before returning
+	~FrameCaptureEncoder();
+
+	//! Queues an image to be written
+	//! @returns false if the image was dropped because the queue is full
+	bool submit(const osg::ref_ptr<const osg::Image>& image, const std::string& filename);
+
+	//! Blocks until all submitted images have been written
+	void flush();
+
+	FrameCaptureEncoderStats getStats() const;
+
+private:
+	void runWorker();
+
+private:
+	const FrameCaptureEncoderConfig mConfig;
+
+	struct Job
+	{
+		osg::ref_ptr<const osg::Image> image;
+		std::string filename;
+	};
+
+	mutable std::mutex mMutex;
+	std::condition_variable mJobAvailable;
+	std::condition_variable mQueueChanged; //!< Signalled when a job is taken from the queue or completed
+	std::deque<Job> mJobs;
+	int mActiveJobCount = 0;
+	bool mStopping = false;
+	FrameCaptureEncoderStats mStats;
+
+	std::vector<std::thread> mWorkers;
+};
+
+} // namespace vis
+} // namespace skybolt
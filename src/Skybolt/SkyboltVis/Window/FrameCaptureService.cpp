@@ -0,0 +1,256 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "FrameCaptureService.h"
+#include "Window.h"
+
+#include <osg/BufferObject>
+#include <osg/GLExtensions>
+#include <osg/GraphicsContext>
+
+#include <assert.h>
+#include <cstring>
+#include <mutex>
+
+namespace skybolt {
+namespace vis {
+
+struct FrameCaptureReadbackState
+{
+	struct Slot
+	{
+		GLuint buffer = 0;
+		size_t bufferSizeInBytes = 0;
+		int width = 0;
+		int height = 0;
+		std::vector<CapturedFrameHandler> handlers; //!< Non-empty if the slot has a pending readback
+	};
+
+	std::mutex mutex;
+	std::vector<Slot> slots;
+	size_t frameNumber = 0;
+	std::vector<CapturedFrameHandler> requests; //!< Handlers for the next rendered frame
+	bool drainRequested = false;
+	bool releaseRequested = false;
+};
+
+using CompletedFrame = std::pair<osg::ref_ptr<osg::Image>, std::vector<CapturedFrameHandler>>;
+
+class FrameCaptureDrawCallback : public osg::Camera::DrawCallback
+{
+public:
+	FrameCaptureDrawCallback(const std::shared_ptr<FrameCaptureReadbackState>& state, const osg::ref_ptr<osg::Camera::DrawCallback>& previousCallback) :
+		mState(state),
+		mPreviousCallback(previousCallback)
+	{
+	}
+
+	void operator()(osg::RenderInfo& renderInfo) const override
+	{
+		if (mPreviousCallback)
+		{
+			(*mPreviousCallback)(renderInfo);
+		}
+
+		osg::GLExtensions* ext = renderInfo.getState()->get<osg::GLExtensions>();
+		std::vector<CompletedFrame> completedFrames;
+		{
+			std::scoped_lock<std::mutex> lock(mState->mutex);
+			if (mState->releaseRequested)
+			{
+				releaseBuffers(*ext);
+				detach(renderInfo);
+				return;
+			}
+
+			size_t slotCount = mState->slots.size();
+			size_t currentSlot = mState->frameNumber % slotCount;
+
+			// Map the oldest readback, or all readbacks if draining, starting from the oldest
+			size_t slotsToMap = mState->drainRequested ? slotCount : 1;
+			for (size_t i = 0; i < slotsToMap; ++i)
+			{
+				FrameCaptureReadbackState::Slot& slot = mState->slots[(currentSlot + i) % slotCount];
+				if (!slot.handlers.empty())
+				{
+					completedFrames.emplace_back(mapReadback(*ext, slot), std::move(slot.handlers));
+					slot.handlers.clear();
+				}
+			}
+			mState->drainRequested = false;
+
+			if (!mState->requests.empty())
+			{
+				FrameCaptureReadbackState::Slot& slot = mState->slots[currentSlot];
+				if (startReadback(*ext, *renderInfo.getCurrentCamera(), slot))
+				{
+					slot.handlers = std::move(mState->requests);
+				}
+				mState->requests.clear();
+			}
+
+			++mState->frameNumber;
+		}
+
+		// Call handlers without the lock held so that they can request further captures
+		for (const auto& [image, handlers] : completedFrames)
+		{
+			if (image)
+			{
+				for (const CapturedFrameHandler& handler : handlers)
+				{
+					handler(image);
+				}
+			}
+		}
+	}
+
+private:
+	static bool startReadback(osg::GLExtensions& ext, osg::Camera& camera, FrameCaptureReadbackState::Slot& slot)
+	{
+		const osg::Viewport* viewport = camera.getViewport();
+		if (!viewport || viewport->width() <= 0 || viewport->height() <= 0)
+		{
+			return false;
+		}
+
+		slot.width = int(viewport->width());
+		slot.height = int(viewport->height());
+		size_t sizeInBytes = size_t(slot.width) * slot.height * 4;
+
+		if (!slot.buffer)
+		{
+			ext.glGenBuffers(1, &slot.buffer);
+		}
+
+		ext.glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, slot.buffer);
+		if (slot.bufferSizeInBytes != sizeInBytes)
+		{
+			ext.glBufferData(GL_PIXEL_PACK_BUFFER_ARB, sizeInBytes, nullptr, GL_STREAM_READ_ARB);
+			slot.bufferSizeInBytes = sizeInBytes;
+		}
+
+		const osg::GraphicsContext* context = camera.getGraphicsContext();
+		bool doubleBuffer = context && context->getTraits() && context->getTraits()->doubleBuffer;
+		glReadBuffer(doubleBuffer ? GL_BACK : GL_FRONT);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+
+		// Reading into a pixel pack buffer returns immediately. The transfer completes asynchronously.
+		glReadPixels(int(viewport->x()), int(viewport->y()), slot.width, slot.height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		ext.glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+		return true;
+	}
+
+	static osg::ref_ptr<osg::Image> mapReadback(osg::GLExtensions& ext, const FrameCaptureReadbackState::Slot& slot)
+	{
+		osg::ref_ptr<osg::Image> image;
+
+		ext.glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, slot.buffer);
+		if (const void* data = ext.glMapBuffer(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB); data)
+		{
+			image = new osg::Image;
+			image->allocateImage(slot.width, slot.height, 1, GL_RGBA, GL_UNSIGNED_BYTE, 1);
+			std::memcpy(image->data(), data, size_t(slot.width) * slot.height * 4);
+			ext.glUnmapBuffer(GL_PIXEL_PACK_BUFFER_ARB);
+		}
+		ext.glBindBuffer(GL_PIXEL_PACK_BUFFER_ARB, 0);
+		return image;
+	}
+
+	void releaseBuffers(osg::GLExtensions& ext) const
+	{
+		for (FrameCaptureReadbackState::Slot& slot : mState->slots)
+		{
+			if (slot.buffer)
+			{
+				ext.glDeleteBuffers(1, &slot.buffer);
+				slot.buffer = 0;
+			}
+		}
+	}
+
+	void detach(osg::RenderInfo& renderInfo) const
+	{
+		// Keep this callback alive until it returns
+		osg::ref_ptr<const osg::Camera::DrawCallback> self = this;
+		if (osg::Camera* camera = renderInfo.getCurrentCamera(); camera && camera->getFinalDrawCallback() == this)
+		{
+			camera->setFinalDrawCallback(mPreviousCallback);
+		}
+	}
+
+private:
+	std::shared_ptr<FrameCaptureReadbackState> mState;
+	osg::ref_ptr<osg::Camera::DrawCallback> mPreviousCallback;
+};
+
+FrameCaptureService::FrameCaptureService(Window& window, const FrameCaptureServiceConfig& config) :
+	mCamera(window.getView()->getCamera()),
+	mState(std::make_shared<FrameCaptureReadbackState>()),
+	mEncoder(std::make_shared<FrameCaptureEncoder>(config.encoder))
+{
+	assert(mCamera);
+	mState->slots.resize(std::max(1, config.readbackBufferCount));
+
+	mCallback = new FrameCaptureDrawCallback(mState, mCamera->getFinalDrawCallback());
+	mCamera->setFinalDrawCallback(mCallback);
+}
+
+FrameCaptureService::~FrameCaptureService()
+{
+	{
+		// The callback releases its pixel buffers in the next rendered frame, when the graphics context is current, and then detaches itself.
+		std::scoped_lock<std::mutex> lock(mState->mutex);
+		mState->releaseRequested = true;
+		mState->requests.clear();
+		for (FrameCaptureReadbackState::Slot& slot : mState->slots)
+		{
+			slot.handlers.clear();
+		}
+	}
+
+	// Handlers already running on the render thread may keep the encoder alive, so write queued images now rather than in the encoder's destructor
+	mEncoder->flush();
+}
+
+void FrameCaptureService::captureNextFrame(const std::string& filename)
+{
+	captureNextFrame([encoder = mEncoder, filename] (const osg::ref_ptr<osg::Image>& image) {
+		encoder->submit(image, filename);
+	});
+}
+
+void FrameCaptureService::captureNextFrame(const CapturedFrameHandler& handler)
+{
+	std::scoped_lock<std::mutex> lock(mState->mutex);
+	mState->requests.push_back(handler);
+}
+
+void FrameCaptureService::requestReadbackDrain()
+{
+	std::scoped_lock<std::mutex> lock(mState->mutex);
+	mState->drainRequested = true;
+}
+
+int FrameCaptureService::getPendingReadbackCount() const
+{
+	std::scoped_lock<std::mutex> lock(mState->mutex);
+	int count = 0;
+	for (const FrameCaptureReadbackState::Slot& slot : mState->slots)
+	{
+		count += slot.handlers.empty() ? 0 : 1;
+	}
+	return count;
+}
+
+void FrameCaptureService::flushEncoder()
+{
+	mEncoder->flush();
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,72 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "FrameCaptureEncoder.h"
+#include "SkyboltVis/SkyboltVisFwd.h"
+
+#include <osg/Camera>
+
+#include <functional>
+#include <memory>
+
+namespace skybolt {
+namespace vis {
+
+struct FrameCaptureReadbackState;
+
+using CapturedFrameHandler = std::function<void(const osg::ref_ptr<osg::Image>& image)>;
+
+struct FrameCaptureServiceConfig
+{
+	//! Number of pixel pack buffers to cycle through. Pixels read in one frame are mapped readbackBufferCount frames later,
+	//! giving the GPU time to complete the transfer without stalling the render thread.
+	int readbackBufferCount = 3;
+
+	FrameCaptureEncoderConfig encoder;
+};
+
+//! Captures frames rendered to a window, reading back pixels asynchronously through a ring of pixel pack buffers
+//! and encoding them to file on worker threads.
+//! The service can stay attached to a window for the lifetime of the window and has no cost in frames that are not captured.
+class FrameCaptureService
+{
+public:
+	FrameCaptureService(Window& window, const FrameCaptureServiceConfig& config = {});
+	~FrameCaptureService();
+
+	//! Captures the next rendered frame to file. The file format is given by the filename's extension.
+	//! The image is read back a few frames later and written in the background.
+	void captureNextFrame(const std::string& filename);
+
+	//! Captures the next rendered frame and passes the image to the handler once it has been read back.
+	//! The handler is called from the render thread. The image is shared by all handlers for the frame and must not be modified.
+	void captureNextFrame(const CapturedFrameHandler& handler);
+
+	//! Completes pending readbacks in the next rendered frame rather than waiting for the ring of buffers to cycle
+	void requestReadbackDrain();
+
+	//! @returns number of frames that have been captured but not yet read back
+	int getPendingReadbackCount() const;
+
+	//! Blocks until all read back frames have been written to file.
+	//! Frames still pending readback are not waited for. Use requestReadbackDrain() and render a frame first to include them.
+	void flushEncoder();
+
+	FrameCaptureEncoder& getEncoder() { return *mEncoder; }
+
+private:
+	osg::ref_ptr<osg::Camera> mCamera;
+	std::shared_ptr<FrameCaptureReadbackState> mState;
+	osg::ref_ptr<osg::Camera::DrawCallback> mCallback;
+
+	//! Shared with capture handlers, which may be called on the render thread after the service is destroyed
+	std::shared_ptr<FrameCaptureEncoder> mEncoder;
+};
+
+} // namespace vis
+} // namespace skybolt
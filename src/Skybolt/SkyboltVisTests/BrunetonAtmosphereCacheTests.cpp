@@ -0,0 +1,221 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+
+#include "Helpers/BruentonAtmosphereTestConfig.h"
+#include <SkyboltVis/Renderable/Atmosphere/Bruneton/BruentonAtmosphereCache.h>
+#include <SkyboltVis/Renderable/Atmosphere/Bruneton/BruentonAtmosphereGenerator.h>
+#include <SkyboltVis/Renderable/Atmosphere/Bruneton/ThirdParty/constants.h>
+
+#include <osg/Texture3D>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+using namespace skybolt;
+using namespace vis;
+
+namespace fs = std::filesystem;
+
+static fs::path getCacheDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "AtmosphereCache";
+}
+
+static osg::ref_ptr<osg::Image> createFloatImage(int width, int height, int depth, GLint internalFormat, float value)
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(width, height, depth, GL_RGBA, GL_FLOAT);
+	image->setInternalTextureFormat(internalFormat);
+	float* data = reinterpret_cast<float*>(image->data());
+	std::fill(data, data + image->getTotalSizeInBytes() / sizeof(float), value);
+	return image;
+}
+
+//! Creates images which pass validation, using the CPU transmittance and constant scattering and irradiance
+static BruentonAtmospherePrecomputedImages createValidImages(const BruentonAtmosphereGeneratorConfig& config)
+{
+	using namespace atmosphere;
+	BruentonAtmospherePrecomputedImages images;
+	images.transmittance = computeBruentonTransmittanceImage(config);
+	images.scattering = createFloatImage(SCATTERING_TEXTURE_WIDTH, SCATTERING_TEXTURE_HEIGHT, SCATTERING_TEXTURE_DEPTH, GL_RGBA16F_ARB, 0.25f);
+	images.irradiance = createFloatImage(IRRADIANCE_TEXTURE_WIDTH, IRRADIANCE_TEXTURE_HEIGHT, 1, GL_RGBA32F_ARB, 0.5f);
+	return images;
+}
+
+static bool imagesEqual(const osg::Image& a, const osg::Image& b)
+{
+	return a.s() == b.s() && a.t() == b.t() && a.r() == b.r()
+		&& a.getPixelFormat() == b.getPixelFormat()
+		&& a.getDataType() == b.getDataType()
+		&& a.getInternalTextureFormat() == b.getInternalTextureFormat()
+		&& a.getTotalSizeInBytes() == b.getTotalSizeInBytes()
+		&& std::memcmp(a.data(), b.data(), a.getTotalSizeInBytes()) == 0;
+}
+
+TEST_CASE("Atmosphere cache key depends on atmosphere parameters")
+{
+	BruentonAtmosphereGeneratorConfig config = createBruentonAtmosphereGeneratorConfig();
+	std::string key = calcBruentonAtmosphereCacheKey(config);
+	CHECK(key == calcBruentonAtmosphereCacheKey(config));
+
+	SECTION("Cache directory does not affect key")
+	{
+		config.cacheDirectory = "someDirectory";
+		CHECK(key == calcBruentonAtmosphereCacheKey(config));
+	}
+
+	SECTION("Scalar parameter affects key")
+	{
+		config.topRadius += 1.0;
+		CHECK(key != calcBruentonAtmosphereCacheKey(config));
+	}
+
+	SECTION("Spectral parameter affects key")
+	{
+		config.rayleighScattering.back() *= 1.0001;
+		CHECK(key != calcBruentonAtmosphereCacheKey(config));
+	}
+
+	SECTION("Density profile affects key")
+	{
+		config.ozoneDensity[0].linear_term *= 2.0;
+		CHECK(key != calcBruentonAtmosphereCacheKey(config));
+	}
+
+	SECTION("Precision affects key")
+	{
+		config.useHalfPrecision = !config.useHalfPrecision;
+		CHECK(key != calcBruentonAtmosphereCacheKey(config));
+	}
+}
+
+TEST_CASE("CPU transmittance matches GPU precomputation")
+{
+	// Reference values are from the GPU precomputation test
+	osg::ref_ptr<osg::Image> image = computeBruentonTransmittanceImage(createBruentonAtmosphereGeneratorConfig());
+	REQUIRE(image->s() == atmosphere::TRANSMITTANCE_TEXTURE_WIDTH);
+	REQUIRE(image->t() == atmosphere::TRANSMITTANCE_TEXTURE_HEIGHT);
+
+	constexpr float epsilon = 1e-3f;
+	const float* data = reinterpret_cast<const float*>(image->data());
+	CHECK(data[10000] == Approx(0.283131).margin(epsilon));
+	CHECK(data[20000] == Approx(0.581288).margin(epsilon));
+	CHECK(data[30000] == Approx(0.823351).margin(epsilon));
+	CHECK(data[40000] == Approx(0.970999).margin(epsilon));
+}
+
+TEST_CASE("Atmosphere cache round trip")
+{
+	fs::remove_all(getCacheDirectory());
+
+	BruentonAtmosphereGeneratorConfig config = createBruentonAtmosphereGeneratorConfig();
+	BruentonAtmospherePrecomputedImages images = createValidImages(config);
+	CHECK(!validateBruentonAtmospherePrecomputedImages(images, config));
+
+	std::string key = calcBruentonAtmosphereCacheKey(config);
+	std::string filename = getBruentonAtmosphereCacheFilename(getCacheDirectory().string(), key);
+
+	CHECK(!readBruentonAtmosphereCache(filename, key));
+
+	writeBruentonAtmosphereCache(filename, key, images);
+	CHECK(fs::exists(filename));
+	CHECK(!fs::exists(filename + ".partial"));
+
+	SECTION("Read with same key")
+	{
+		std::optional<BruentonAtmospherePrecomputedImages> result = readBruentonAtmosphereCache(filename, key);
+		REQUIRE(result);
+		CHECK(imagesEqual(*result->transmittance, *images.transmittance));
+		CHECK(imagesEqual(*result->scattering, *images.scattering));
+		CHECK(imagesEqual(*result->irradiance, *images.irradiance));
+		CHECK(!result->optionalSingleMieScattering);
+	}
+
+	SECTION("Read with different key")
+	{
+		CHECK(!readBruentonAtmosphereCache(filename, key + "x"));
+		CHECK(!readBruentonAtmosphereCache(filename, "different"));
+	}
+
+	SECTION("Read corrupt file")
+	{
+		auto size = fs::file_size(filename);
+		{
+			std::fstream f(filename, std::ios::binary | std::ios::in | std::ios::out);
+			f.seekp(size / 2);
+			char c = 0x7f;
+			f.write(&c, 1);
+		}
+		CHECK(!readBruentonAtmosphereCache(filename, key));
+	}
+
+	SECTION("Read truncated file")
+	{
+		fs::resize_file(filename, fs::file_size(filename) / 2);
+		CHECK(!readBruentonAtmosphereCache(filename, key));
+	}
+}
+
+TEST_CASE("Atmosphere cache validation rejects invalid images")
+{
+	BruentonAtmosphereGeneratorConfig config = createBruentonAtmosphereGeneratorConfig();
+	BruentonAtmospherePrecomputedImages images = createValidImages(config);
+
+	SECTION("Non-finite value")
+	{
+		reinterpret_cast<float*>(images.scattering->data())[123] = std::numeric_limits<float>::quiet_NaN();
+		CHECK(validateBruentonAtmospherePrecomputedImages(images, config));
+	}
+
+	SECTION("Wrong dimensions")
+	{
+		images.irradiance = createFloatImage(8, 8, 1, GL_RGBA32F_ARB, 0.5f);
+		CHECK(validateBruentonAtmospherePrecomputedImages(images, config));
+	}
+
+	SECTION("Transmittance computed with different parameters")
+	{
+		BruentonAtmosphereGeneratorConfig otherConfig = config;
+		for (double& value : otherConfig.rayleighScattering)
+		{
+			value *= 2.0;
+		}
+		CHECK(validateBruentonAtmospherePrecomputedImages(images, otherConfig));
+	}
+
+	SECTION("Missing single Mie scattering when textures are not combined")
+	{
+		config.useCombinedTextures = false;
+		CHECK(validateBruentonAtmospherePrecomputedImages(images, config));
+	}
+}
+
+TEST_CASE("Atmosphere generator loads textures from cache instead of precomputing them")
+{
+	fs::remove_all(getCacheDirectory());
+
+	BruentonAtmosphereGeneratorConfig config = createBruentonAtmosphereGeneratorConfig();
+	config.cacheDirectory = getCacheDirectory().string();
+
+	BruentonAtmospherePrecomputedImages images = createValidImages(config);
+	std::string key = calcBruentonAtmosphereCacheKey(config);
+	writeBruentonAtmosphereCache(getBruentonAtmosphereCacheFilename(config.cacheDirectory, key), key, images);
+
+	osg::ref_ptr<BruentonAtmosphereGenerator> generator = new BruentonAtmosphereGenerator(config);
+	CHECK(generator->isLoadedFromCache());
+	CHECK(generator->getNumChildren() == 0);
+
+	REQUIRE(generator->getTransmittanceTexture());
+	REQUIRE(generator->getScatteringTexture());
+	REQUIRE(generator->getIrradianceTexture());
+	CHECK(generator->getTransmittanceTexture()->getInternalFormat() == GL_RGBA32F_ARB);
+	CHECK(generator->getScatteringTexture()->getInternalFormat() == GL_RGBA16F_ARB);
+	CHECK(dynamic_cast<osg::Texture3D*>(generator->getScatteringTexture().get()));
+	CHECK(generator->getTransmittanceTexture()->getImage(0) != nullptr);
+}
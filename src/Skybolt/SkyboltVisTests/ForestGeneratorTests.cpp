@@ -0,0 +1,142 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/Renderable/Forest/ForestGenerator.h>
+
+#include <thread>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace {
+
+//! Returns lowElevation where x + y <= 150, and zero elsewhere
+class SteppedElevationProvider : public ElevationProvider
+{
+public:
+	SteppedElevationProvider(float lowElevation) : mLowElevation(lowElevation) {}
+
+	float get(float x, float y) const override
+	{
+		// Reject trees in part of the world to exercise elevation filtering
+		return (x + y > 150.f) ? 0.f : mLowElevation;
+	}
+
+private:
+	float mLowElevation;
+};
+
+struct ForestFixture
+{
+	static constexpr int imageSize = 64;
+
+	ForestFixture()
+	{
+		data.resize(4 * imageSize * imageSize);
+		for (int y = 0; y < imageSize; ++y)
+		{
+			for (int x = 0; x < imageSize; ++x)
+			{
+				// Alternate between forest and non-forest attributes
+				data[4 * (x + y * imageSize) + 3] = ((x / 4 + y / 4) % 3 == 0) ? 5 : 2;
+			}
+		}
+
+		image.data = data.data();
+		image.width = imageSize;
+		image.height = imageSize;
+		image.attributes[2] = ForestGenerator::Attribute{0.05f};
+
+		worldBounds = Box2f(osg::Vec2f(0, 0), osg::Vec2f(100, 100));
+		imageBounds = Box2f(osg::Vec2f(0.5f, 0.5f), osg::Vec2f(imageSize - 0.5f, imageSize - 0.5f));
+	}
+
+	std::vector<char> data;
+	ForestGenerator::AttributeImage image;
+	Box2f worldBounds;
+	Box2f imageBounds;
+	SteppedElevationProvider elevation{-10.f};
+};
+
+} // namespace
+
+namespace skybolt {
+namespace vis {
+
+static bool operator==(const BillboardForest::Tree& a, const BillboardForest::Tree& b)
+{
+	return a.position == b.position && a.height == b.height && a.yaw == b.yaw && a.type == b.type;
+}
+
+} // namespace vis
+} // namespace skybolt
+
+TEST_CASE("ForestGenerator output is deterministic")
+{
+	ForestFixture f;
+	std::vector<BillboardForest::Tree> trees1 = ForestGenerator(1).generate(f.elevation, f.image, f.worldBounds, f.imageBounds);
+	std::vector<BillboardForest::Tree> trees2 = ForestGenerator(1).generate(f.elevation, f.image, f.worldBounds, f.imageBounds);
+
+	REQUIRE(!trees1.empty());
+	CHECK(trees1 == trees2);
+
+	// A different seed gives different placement
+	std::vector<BillboardForest::Tree> trees3 = ForestGenerator(2).generate(f.elevation, f.image, f.worldBounds, f.imageBounds);
+	CHECK(!(trees1 == trees3));
+}
+
+TEST_CASE("ForestGenerator places trees only in matching cells above minimum elevation")
+{
+	ForestFixture f;
+	std::vector<BillboardForest::Tree> trees = ForestGenerator().generate(f.elevation, f.image, f.worldBounds, f.imageBounds);
+
+	for (const BillboardForest::Tree& tree : trees)
+	{
+		CHECK(tree.position.z() == -10.f);
+		CHECK(tree.position.x() + tree.position.y() <= 150.f);
+		CHECK(f.worldBounds.intersects(osg::Vec2f(tree.position.x(), tree.position.y())));
+	}
+
+	// No trees if no attributes match
+	f.image.attributes.clear();
+	f.image.attributes[-3] = ForestGenerator::Attribute{0.05f};
+	CHECK(ForestGenerator().generate(f.elevation, f.image, f.worldBounds, f.imageBounds).empty());
+}
+
+TEST_CASE("ForestGenerator output is independent of row splitting and thread count")
+{
+	ForestFixture f;
+	ForestGenerator generator(3);
+	std::vector<BillboardForest::Tree> expected = generator.generate(f.elevation, f.image, f.worldBounds, f.imageBounds);
+
+	IntRangeClosedOpen rowRange = ForestGenerator::getRowRange(f.image, f.imageBounds);
+	CHECK(rowRange == IntRangeClosedOpen(0, ForestFixture::imageSize));
+
+	for (int threadCount : {1, 2, 3, 8})
+	{
+		int rowsPerChunk = (rowRange.size() + threadCount - 1) / threadCount;
+
+		std::vector<std::vector<BillboardForest::Tree>> chunks(threadCount);
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			IntRangeClosedOpen chunkRange(rowRange.first + i * rowsPerChunk, std::min(rowRange.last, rowRange.first + (i + 1) * rowsPerChunk));
+			threads.emplace_back([&, i, chunkRange] {
+				chunks[i] = generator.generateRows(f.elevation, f.image, f.worldBounds, f.imageBounds, chunkRange);
+			});
+		}
+
+		std::vector<BillboardForest::Tree> trees;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads[i].join();
+			trees.insert(trees.end(), chunks[i].begin(), chunks[i].end());
+		}
+
+		CHECK(trees == expected);
+	}
+}
@@ -0,0 +1,154 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/Window/FrameCaptureEncoder.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace fs = std::filesystem;
+
+static fs::path getTemporaryDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "FrameCaptureEncoderTests";
+}
+
+static osg::ref_ptr<osg::Image> createTestImage(int width, int height)
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image;
+	image->allocateImage(width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, 1);
+	for (int t = 0; t < height; ++t)
+	{
+		for (int s = 0; s < width; ++s)
+		{
+			unsigned char* pixel = image->data(s, t);
+			pixel[0] = static_cast<unsigned char>(s);
+			pixel[1] = static_cast<unsigned char>(t);
+			pixel[2] = static_cast<unsigned char>(s + t);
+			pixel[3] = 255;
+		}
+	}
+	return image;
+}
+
+TEST_CASE("Image file format is derived from filename extension")
+{
+	CHECK(getImageFileFormat("a/b/frame.png") == ImageFileFormat::Png);
+	CHECK(getImageFileFormat("frame.RAW") == ImageFileFormat::Raw);
+	CHECK(getImageFileFormat("frame.exr") == ImageFileFormat::Exr);
+	CHECK(getImageFileFormat("frame.xyz") == std::nullopt);
+	CHECK(getImageFileFormat("frame") == std::nullopt);
+}
+
+TEST_CASE("Raw captured image is written row by row without a header")
+{
+	fs::path path = getTemporaryDirectory() / "RawImage" / "frame.raw";
+	fs::remove_all(path.parent_path());
+
+	osg::ref_ptr<osg::Image> image = createTestImage(7, 5);
+	REQUIRE(writeCapturedImage(*image, path.string()));
+
+	std::ifstream f(path, std::ios::binary);
+	std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	REQUIRE(bytes.size() == 7 * 5 * 4);
+	CHECK(std::equal(bytes.begin(), bytes.end(), image->data()));
+}
+
+TEST_CASE("Encoder writes all submitted images")
+{
+	std::atomic<int> writtenCount = 0;
+
+	FrameCaptureEncoderConfig config;
+	config.workerCount = 3;
+	config.maxQueuedImages = 2;
+	config.writer = [&] (const osg::Image& image, const std::string& filename) {
+		++writtenCount;
+		return filename != "fail";
+	};
+
+	FrameCaptureEncoder encoder(config);
+	osg::ref_ptr<osg::Image> image = createTestImage(4, 4);
+	for (int i = 0; i < 20; ++i)
+	{
+		// Block policy never drops images, even though the queue is smaller than the number of images
+		CHECK(encoder.submit(image, std::to_string(i)));
+	}
+	CHECK(encoder.submit(image, "fail"));
+	encoder.flush();
+
+	CHECK(writtenCount == 21);
+	FrameCaptureEncoderStats stats = encoder.getStats();
+	CHECK(stats.submittedCount == 21);
+	CHECK(stats.writtenCount == 20);
+	CHECK(stats.failedCount == 1);
+	CHECK(stats.droppedCount == 0);
+}
+
+TEST_CASE("Encoder drops images when queue is full and overflow policy is Drop")
+{
+	std::mutex writerMutex;
+	std::unique_lock<std::mutex> writerBlock(writerMutex);
+
+	FrameCaptureEncoderConfig config;
+	config.workerCount = 1;
+	config.maxQueuedImages = 2;
+	config.overflowPolicy = FrameCaptureEncoderConfig::OverflowPolicy::Drop;
+	config.writer = [&] (const osg::Image& image, const std::string& filename) {
+		std::scoped_lock<std::mutex> lock(writerMutex);
+		return true;
+	};
+
+	FrameCaptureEncoder encoder(config);
+	osg::ref_ptr<osg::Image> image = createTestImage(4, 4);
+
+	// The worker takes at most one image and blocks writing it, so at most 3 images can be accepted
+	int acceptedCount = 0;
+	for (int i = 0; i < 10; ++i)
+	{
+		acceptedCount += encoder.submit(image, std::to_string(i)) ? 1 : 0;
+	}
+	CHECK(acceptedCount >= 2);
+	CHECK(acceptedCount <= 3);
+
+	writerBlock.unlock();
+	encoder.flush();
+
+	FrameCaptureEncoderStats stats = encoder.getStats();
+	CHECK(stats.submittedCount == size_t(acceptedCount));
+	CHECK(stats.writtenCount == size_t(acceptedCount));
+	CHECK(stats.droppedCount == size_t(10 - acceptedCount));
+}
+
+TEST_CASE("Benchmark FrameCaptureEncoder", "[.][benchmark]")
+{
+	fs::path directory = getTemporaryDirectory() / "Benchmark";
+	osg::ref_ptr<osg::Image> image = createTestImage(1920, 1080);
+
+	BENCHMARK("Write 16 raw frames synchronously")
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			writeCapturedImage(*image, (directory / (std::to_string(i) + ".raw")).string());
+		}
+	};
+
+	FrameCaptureEncoder encoder;
+	BENCHMARK("Submit 16 raw frames to encoder and flush")
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			encoder.submit(image, (directory / (std::to_string(i) + ".raw")).string());
+		}
+		encoder.flush();
+	};
+}
@@ -9,6 +9,9 @@
 
 #include <osg/Image>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace skybolt;
 using namespace skybolt::vis;
 
@@ -24,3 +27,101 @@ TEST_CASE("Test get and set HeightMapElevationBounds image data")
 	REQUIRE(bounds2);
 	CHECK(bounds == *bounds2);
 }
+
+static osg::ref_ptr<osg::Image> createSyntheticHeightMap(int width, int height)
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(width, height, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	uint16_t* data = reinterpret_cast<uint16_t*>(image->data());
+	for (int t = 0; t < height; ++t)
+	{
+		for (int s = 0; s < width; ++s)
+		{
+			data[s + t * width] = uint16_t((s * 7919 + t * 104729 + s * t * 31) % 1000);
+		}
+	}
+	return image;
+}
+
+TEST_CASE("HeightMapElevationBoundsPyramid bounds contain all texels in region")
+{
+	const int width = 37;
+	const int height = 21;
+	osg::ref_ptr<osg::Image> image = createSyntheticHeightMap(width, height);
+	const uint16_t* data = reinterpret_cast<const uint16_t*>(image->data());
+	HeightMapElevationRerange rerange(2.0f, -100.0f);
+
+	HeightMapElevationBoundsPyramid pyramid(*image, rerange, 4);
+
+	auto calcExpectedBounds = [&] (int s0, int t0, int s1, int t1) {
+		HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
+		for (int t = t0; t <= t1; ++t)
+		{
+			for (int s = s0; s <= s1; ++s)
+			{
+				expand(bounds, getElevationForColorValue(rerange, data[s + t * width]));
+			}
+		}
+		return bounds;
+	};
+
+	CHECK(pyramid.getBounds() == calcExpectedBounds(0, 0, width - 1, height - 1));
+
+	for (const auto& [minimum, maximum] : std::vector<std::pair<osg::Vec2f, osg::Vec2f>>{
+		{{0.0f, 0.0f}, {0.5f, 0.5f}},
+		{{3.5f, 2.2f}, {4.5f, 9.7f}},
+		{{7.9f, 8.0f}, {8.1f, 8.0f}},
+		{{1.0f, 1.0f}, {35.2f, 19.9f}},
+		{{30.0f, 15.0f}, {100.0f, 100.0f}}, // Clamped to image
+	})
+	{
+		// Bilinearly interpolated elevations within the region are bounded by the texels surrounding the region
+		int s0 = int(std::floor(minimum.x()));
+		int t0 = int(std::floor(minimum.y()));
+		int s1 = std::min(width - 1, int(std::ceil(maximum.x())));
+		int t1 = std::min(height - 1, int(std::ceil(maximum.y())));
+		HeightMapElevationBounds expected = calcExpectedBounds(s0, t0, s1, t1);
+
+		HeightMapElevationBounds bounds = pyramid.getBounds(minimum, maximum);
+		CHECK(bounds.x() <= expected.x());
+		CHECK(bounds.y() >= expected.y());
+
+		// Bounds should be within the bounds of the whole image
+		HeightMapElevationBounds loose = calcExpectedBounds(0, 0, width - 1, height - 1);
+		CHECK(bounds.x() >= loose.x());
+		CHECK(bounds.y() <= loose.y());
+	}
+}
+
+TEST_CASE("HeightMapElevationBoundsPyramid bounds of small region are tight")
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(64, 64, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	uint16_t* data = reinterpret_cast<uint16_t*>(image->data());
+	std::fill(data, data + 64 * 64, uint16_t(10));
+	data[60 + 60 * 64] = 500; // Peak far from the queried region
+
+	HeightMapElevationBoundsPyramid pyramid(*image, HeightMapElevationRerange(1.0f, 0.0f), 8);
+	CHECK(pyramid.getBounds() == HeightMapElevationBounds(10, 500));
+	CHECK(pyramid.getBounds(osg::Vec2f(2, 2), osg::Vec2f(20, 20)) == HeightMapElevationBounds(10, 10));
+	CHECK(pyramid.getBounds(osg::Vec2f(58, 58), osg::Vec2f(59, 59)) == HeightMapElevationBounds(10, 500));
+}
+
+TEST_CASE("Get HeightMapElevationBounds within descendant tile of height map")
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(64, 64, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	uint16_t* data = reinterpret_cast<uint16_t*>(image->data());
+	std::fill(data, data + 64 * 64, uint16_t(10));
+	data[60 + 60 * 64] = 500; // Peak in north east corner
+
+	HeightMapElevationBoundsPyramid pyramid(*image, HeightMapElevationRerange(1.0f, 0.0f), 8);
+	QuadTreeTileKey imageKey(1, 1, 0);
+
+	CHECK(getHeightMapElevationBoundsWithinTile(pyramid, imageKey, imageKey) == HeightMapElevationBounds(10, 500));
+
+	// Tile key y increases southwards, and height map rows increase northwards
+	CHECK(getHeightMapElevationBoundsWithinTile(pyramid, imageKey, QuadTreeTileKey(2, 3, 0)) == HeightMapElevationBounds(10, 500)); // North east
+	CHECK(getHeightMapElevationBoundsWithinTile(pyramid, imageKey, QuadTreeTileKey(2, 2, 0)) == HeightMapElevationBounds(10, 10)); // North west
+	CHECK(getHeightMapElevationBoundsWithinTile(pyramid, imageKey, QuadTreeTileKey(2, 2, 1)) == HeightMapElevationBounds(10, 10)); // South west
+}
@@ -53,3 +53,36 @@ TEST_CASE("Test HeightMapElevationProvider returns correct elevations")
 	CHECK(provider.get(-1, -1) == Approx(0).margin(epsilon));
 	CHECK(provider.get(10, 10) == Approx(9).margin(epsilon));
 }
+
+TEST_CASE("Test HeightMapElevationProvider batched elevations match individual queries")
+{
+	HeightMapElevationRerange rerange = rerangeElevationFromUInt16WithElevationBounds(-100, 100);
+
+	osg::ref_ptr<osg::Image> image = new osg::Image;
+	image->allocateImage(8, 8, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+
+	uint16_t* p = reinterpret_cast<uint16_t*>(image->data());
+	for (int i = 0; i < 64; ++i)
+	{
+		p[i] = getColorValueForElevation(rerange, heightFunction(i % 8, i / 8));
+	}
+
+	HeightMapElevationProvider provider(image, rerange, Box2f(osg::Vec2f(-1, 2), osg::Vec2f(5, 6)));
+
+	std::vector<osg::Vec2f> positions;
+	for (float y = 0; y < 8; y += 0.37f)
+	{
+		for (float x = -3; x < 7; x += 0.41f)
+		{
+			positions.push_back(osg::Vec2f(x, y));
+		}
+	}
+
+	std::vector<float> elevations(positions.size());
+	provider.getElevations(positions, elevations);
+
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		CHECK(elevations[i] == provider.get(positions[i].x(), positions[i].y()));
+	}
+}
@@ -0,0 +1,165 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/Renderable/Model/ModelFactory.h>
+#include <SkyboltCommon/Exception.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace fs = std::filesystem;
+
+static fs::path getTemporaryDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "ModelFactoryTests";
+}
+
+//! Writes a Wavefront OBJ file containing a grid of quads
+static std::string writeGridModel(const std::string& name, int quadsPerSide)
+{
+	fs::create_directories(getTemporaryDirectory());
+	fs::path path = getTemporaryDirectory() / (name + ".obj");
+
+	std::ofstream f(path);
+	int verticesPerSide = quadsPerSide + 1;
+	for (int y = 0; y < verticesPerSide; ++y)
+	{
+		for (int x = 0; x < verticesPerSide; ++x)
+		{
+			f << "v " << x << " " << y << " 0\n";
+		}
+	}
+	for (int y = 0; y < quadsPerSide; ++y)
+	{
+		for (int x = 0; x < quadsPerSide; ++x)
+		{
+			int i = 1 + x + y * verticesPerSide;
+			f << "f " << i << " " << i + 1 << " " << i + 1 + verticesPerSide << " " << i + verticesPerSide << "\n";
+		}
+	}
+	return path.string();
+}
+
+static ModelFactoryConfig createConfig(px_sched::Scheduler* scheduler)
+{
+	ModelFactoryConfig config;
+	config.defaultProgram = new osg::Program;
+	config.glassProgram = new osg::Program;
+	config.scheduler = scheduler;
+	return config;
+}
+
+static const std::vector<ModelFactory::TextureRole> albedoRoles = { ModelFactory::TextureRole::Albedo };
+static const std::vector<ModelFactory::TextureRole> albedoNormalRoles = { ModelFactory::TextureRole::Albedo, ModelFactory::TextureRole::Normal };
+
+TEST_CASE("ModelFactory loads models asynchronously into proxy")
+{
+	std::string filename = writeGridModel("AsyncGrid", 4);
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+	ModelFactory factory(createConfig(&scheduler));
+
+	osg::ref_ptr<ModelProxy> proxy = factory.createModelAsync(filename, albedoRoles);
+	REQUIRE(proxy);
+
+	factory.waitForLoads();
+	CHECK(proxy->isLoadComplete());
+	proxy->update();
+	REQUIRE(proxy->isModelAttached());
+
+	// Second request is served from the cache and shares the loaded model
+	osg::ref_ptr<ModelProxy> proxy2 = factory.createModelAsync(filename, albedoRoles);
+	REQUIRE(proxy2->isModelAttached());
+	CHECK(proxy2->getChild(0) == proxy->getChild(0));
+	CHECK(factory.createModel(filename, albedoRoles) == proxy->getChild(0));
+
+	ModelCacheStats stats = factory.getCacheStats();
+	CHECK(stats.modelCount == 1);
+	CHECK(stats.missCount == 1);
+	CHECK(stats.hitCount == 2);
+	CHECK(stats.pendingLoadCount == 0);
+	CHECK(stats.memoryBytes > 0);
+}
+
+TEST_CASE("ModelFactory caches models by filename and texture roles")
+{
+	std::string filename = writeGridModel("RolesGrid", 2);
+	ModelFactory factory(createConfig(nullptr));
+
+	osg::ref_ptr<osg::Node> a = factory.createModel(filename, albedoRoles);
+	osg::ref_ptr<osg::Node> b = factory.createModel(filename, albedoNormalRoles);
+	CHECK(a != b);
+	CHECK(factory.createModel(filename, albedoRoles) == a);
+	CHECK(factory.createModel(filename, albedoNormalRoles) == b);
+	CHECK(factory.getCacheStats().modelCount == 2);
+}
+
+TEST_CASE("ModelFactory evicts unreferenced models when over memory budget")
+{
+	std::string smallFilename = writeGridModel("SmallGrid", 2);
+	std::string largeFilename = writeGridModel("LargeGrid", 32);
+
+	ModelFactoryConfig config = createConfig(nullptr);
+	config.cacheMemoryBudgetBytes = 0;
+	ModelFactory factory(config);
+
+	osg::ref_ptr<osg::Node> small = factory.createModel(smallFilename, albedoRoles);
+	CHECK(estimateModelMemoryBytes(*small) > 0);
+	CHECK(estimateModelMemoryBytes(*factory.createModel(largeFilename, albedoRoles)) > estimateModelMemoryBytes(*small));
+
+	// Large model is no longer referenced and is evicted. Small model is still referenced and is kept.
+	factory.trimCache();
+	ModelCacheStats stats = factory.getCacheStats();
+	CHECK(stats.modelCount == 1);
+	CHECK(stats.evictionCount == 1);
+	CHECK(factory.createModel(smallFilename, albedoRoles) == small);
+
+	small = nullptr;
+	factory.trimCache();
+	CHECK(factory.getCacheStats().modelCount == 0);
+	CHECK(factory.getCacheStats().memoryBytes == 0);
+}
+
+TEST_CASE("ModelFactory prefetches models")
+{
+	std::string filename = writeGridModel("PrefetchGrid", 2);
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+	ModelFactory factory(createConfig(&scheduler));
+
+	factory.prefetchModel(filename, albedoRoles);
+	factory.prefetchModel(filename, albedoRoles); // duplicate request is ignored
+	factory.waitForLoads();
+	CHECK(factory.getCacheStats().modelCount == 1);
+
+	osg::ref_ptr<ModelProxy> proxy = factory.createModelAsync(filename, albedoRoles);
+	CHECK(proxy->isModelAttached());
+	CHECK(factory.getCacheStats().hitCount == 1);
+}
+
+TEST_CASE("ModelFactory reports failed loads")
+{
+	std::string filename = (getTemporaryDirectory() / "NonExistent.obj").string();
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+	ModelFactory factory(createConfig(&scheduler));
+
+	osg::ref_ptr<ModelProxy> proxy = factory.createModelAsync(filename, albedoRoles);
+	factory.waitForLoads();
+	proxy->update();
+	CHECK(proxy->isLoadComplete());
+	CHECK(!proxy->isModelAttached());
+	CHECK(factory.getCacheStats().modelCount == 0);
+
+	CHECK_THROWS_AS(factory.createModel(filename, albedoRoles), skybolt::Exception);
+}
@@ -15,8 +15,12 @@
 #include <SkyboltVis/ElevationProvider/TilePlanetAltitudeProvider.h>
 #include <SkyboltCommon/Eventually.h>
 #include <SkyboltCommon/NumericComparison.h>
+#include <SkyboltSim/Spatial/Geocentric.h>
+#include <SkyboltSim/Spatial/TerrainRayIntersection.h>
 
+#include <algorithm>
 #include <optional>
+#include <random>
 
 using namespace skybolt;
 using namespace skybolt::vis;
@@ -129,4 +133,240 @@ TEST_CASE("Test NonBlockingPlanetAltitudeProvider background loads tile")
 	CHECK(eventually([&]{
 		return provider.getAltitude(sim::LatLon(1.4, -3.0)) == NonBlockingTilePlanetAltitudeProvider::AltitudeResult::finalValue(altitude);
 	}));
-}
\ No newline at end of file
+}
+
+//! @returns height map with elevation increasing eastwards from baseAltitude in steps of 10 meters per texel
+static osg::ref_ptr<osg::Image> createRampImage(int size, double baseAltitude)
+{
+	HeightMapElevationRerange rerange = rerangeElevationFromUInt16WithElevationBounds(0, 65535);
+
+	auto image = new osg::Image;
+	image->allocateImage(size, size, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	uint16_t* p = reinterpret_cast<uint16_t*>(image->data());
+	for (int t = 0; t < size; ++t)
+	{
+		for (int s = 0; s < size; ++s)
+		{
+			p[s + t * size] = getColorValueForElevation(rerange, baseAltitude + s * 10);
+		}
+	}
+
+	setHeightMapElevationRerange(*image, rerange);
+	return image;
+}
+
+static bool contains(const sim::PlanetAltitudeProvider::AltitudeBounds& bounds, double altitude)
+{
+	return altitude >= bounds.minimum - 1e-3 && altitude <= bounds.maximum + 1e-3;
+}
+
+TEST_CASE("Test BlockingTilePlanetAltitudeProvider altitude bounds contain altitudes in region")
+{
+	auto source = std::make_shared<DummyTileSource>();
+	source->images[QuadTreeTileKey(1, 0, 0)] = createRampImage(64, 1000);
+	source->images[QuadTreeTileKey(1, 1, 0)] = createRampImage(64, 2000);
+	source->images[QuadTreeTileKey(1, 0, 1)] = createRampImage(64, 3000);
+	source->images[QuadTreeTileKey(1, 1, 1)] = createRampImage(64, 4000);
+
+	BlockingTilePlanetAltitudeProvider provider(source, 1);
+
+	// Region smaller than a tile at max LOD. Tile (1, 0, 0) spans latitude [0, pi/2] and longitude [-pi, -pi/2].
+	sim::LatLon minimum(0.2, -3.0);
+	sim::LatLon maximum(0.4, -2.9);
+	std::optional<sim::PlanetAltitudeProvider::AltitudeBounds> bounds = provider.getAltitudeBounds(minimum, maximum);
+	REQUIRE(bounds);
+	CHECK(bounds->minimum >= 1000);
+	CHECK(bounds->maximum - bounds->minimum < 200); // Tighter than the whole tile's range of 630m
+
+	for (double lat = minimum.lat; lat <= maximum.lat; lat += 0.02)
+	{
+		for (double lon = minimum.lon; lon <= maximum.lon; lon += 0.01)
+		{
+			CHECK(contains(*bounds, provider.getAltitude(sim::LatLon(lat, lon)).altitude));
+		}
+	}
+
+	// Bounds of a region larger than a tile at max LOD are unknown until all tiles in the region are loaded
+	sim::LatLon coarseMinimum(-1.0, -3.0);
+	sim::LatLon coarseMaximum(1.0, -0.5);
+	CHECK(!provider.getAltitudeBounds(coarseMinimum, coarseMaximum));
+
+	provider.getAltitude(sim::LatLon(-1.0, -3.0));
+	provider.getAltitude(sim::LatLon(1.0, -1.0));
+	provider.getAltitude(sim::LatLon(-1.0, -1.0));
+
+	bounds = provider.getAltitudeBounds(coarseMinimum, coarseMaximum);
+	REQUIRE(bounds);
+	CHECK(bounds->minimum == Approx(1000).margin(1e-3));
+	CHECK(bounds->maximum == Approx(4630).margin(1e-3));
+}
+
+TEST_CASE("Test NonBlockingTilePlanetAltitudeProvider altitude bounds contain altitudes from loaded tiles")
+{
+	auto source = std::make_shared<DummyTileSource>();
+	source->images[QuadTreeTileKey(0, 0, 0)] = createRampImage(64, 500);
+	source->images[QuadTreeTileKey(1, 0, 0)] = createRampImage(64, 1000);
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	NonBlockingTilePlanetAltitudeProvider provider(&scheduler, source, 1);
+
+	// No tiles are loaded, so provisional altitudes are zero
+	sim::LatLon minimum(0.2, -3.0);
+	sim::LatLon maximum(0.4, -2.9);
+	std::optional<sim::PlanetAltitudeProvider::AltitudeBounds> bounds = provider.getAltitudeBounds(minimum, maximum);
+	REQUIRE(bounds);
+	CHECK(bounds->minimum == 0.0);
+	CHECK(bounds->maximum == 0.0);
+
+	CHECK(eventually([&]{
+		return !provider.getAltitude(sim::LatLon(0.3, -2.95)).provisional;
+	}));
+
+	bounds = provider.getAltitudeBounds(minimum, maximum);
+	REQUIRE(bounds);
+	CHECK(contains(*bounds, provider.getAltitude(minimum).altitude));
+	CHECK(contains(*bounds, provider.getAltitude(maximum).altitude));
+	CHECK(bounds->minimum >= 500 - 1e-3);
+	CHECK(bounds->maximum <= 1630 + 1e-3);
+}
+
+TEST_CASE("Test ray intersects terrain from BlockingTilePlanetAltitudeProvider")
+{
+	auto source = std::make_shared<DummyTileSource>();
+	source->images[QuadTreeTileKey(1, 0, 0)] = createRampImage(64, 1000);
+
+	BlockingTilePlanetAltitudeProvider provider(source, 1);
+
+	const double radius = 1e6;
+	sim::LatLon position(0.3, -2.95);
+	double terrainAltitude = provider.getAltitude(position).altitude;
+
+	sim::Vector3 start = sim::llaToGeocentric(sim::LatLonAlt(position.lat, position.lon, 5000), radius);
+	sim::Vector3 end = sim::llaToGeocentric(sim::LatLonAlt(position.lat, position.lon, -1000), radius);
+
+	std::optional<sim::TerrainRayIntersection> result = sim::intersectTerrain(provider, radius, start, end);
+	REQUIRE(result);
+	CHECK(result->distance == Approx(5000 - terrainAltitude).margin(0.1));
+
+	// Ray passing above the highest terrain does not intersect
+	start = sim::llaToGeocentric(sim::LatLonAlt(0.3, -2.95, 1200), radius);
+	end = sim::llaToGeocentric(sim::LatLonAlt(0.3, -2.949, 1200), radius);
+	CHECK(!sim::intersectTerrain(provider, radius, start, end));
+}
+
+static std::shared_ptr<DummyTileSource> createRampTileSource(int maxLod)
+{
+	auto source = std::make_shared<DummyTileSource>();
+	for (int level = 0; level <= maxLod; ++level)
+	{
+		for (int y = 0; y < (1 << level); ++y)
+		{
+			for (int x = 0; x < (2 << level); ++x)
+			{
+				source->images[QuadTreeTileKey(level, x, y)] = createRampImage(64, 100 * (x + y));
+			}
+		}
+	}
+	return source;
+}
+
+static std::vector<sim::LatLon> createRandomPositions(size_t count)
+{
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> lat(-1.5, 1.5);
+	std::uniform_real_distribution<double> lon(-3.1, 3.1);
+
+	std::vector<sim::LatLon> positions(count);
+	for (sim::LatLon& position : positions)
+	{
+		position = sim::LatLon(lat(generator), lon(generator));
+	}
+	return positions;
+}
+
+TEST_CASE("Test TilePlanetAltitudeProvider batch altitudes match individual altitudes")
+{
+	const int maxLod = 2;
+	auto source = createRampTileSource(maxLod);
+	std::vector<sim::LatLon> positions = createRandomPositions(500);
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	BlockingTilePlanetAltitudeProvider blockingProvider(source, maxLod);
+	NonBlockingTilePlanetAltitudeProvider nonBlockingProvider(&scheduler, source, maxLod);
+
+	// Wait for non blocking provider to load all tiles
+	CHECK(eventually([&]{
+		std::vector<sim::PlanetAltitudeProvider::AltitudeResult> results(positions.size());
+		nonBlockingProvider.getAltitudes(positions, results);
+		return std::all_of(results.begin(), results.end(), [] (const auto& result) { return !result.provisional; });
+	}));
+
+	for (const sim::PlanetAltitudeProvider* provider : std::vector<const sim::PlanetAltitudeProvider*>{&blockingProvider, &nonBlockingProvider})
+	{
+		std::vector<sim::PlanetAltitudeProvider::AltitudeResult> results(positions.size());
+		provider->getAltitudes(positions, results);
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			sim::PlanetAltitudeProvider::AltitudeResult expected = provider->getAltitude(positions[i]);
+			CHECK(results[i].altitude == expected.altitude);
+			CHECK(results[i].provisional == expected.provisional);
+		}
+	}
+}
+
+TEST_CASE("Test NonBlockingTilePlanetAltitudeProvider loads tiles in parallel")
+{
+	const int maxLod = 1;
+	auto source = createRampTileSource(maxLod);
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	NonBlockingTilePlanetAltitudeProvider provider(&scheduler, source, maxLod, 8);
+
+	// Query positions in both level 0 tiles in one batch. Both tiles should be requested without waiting for each other.
+	std::vector<sim::LatLon> positions = { sim::LatLon(0.1, -1.0), sim::LatLon(0.1, 1.0) };
+	std::vector<sim::PlanetAltitudeProvider::AltitudeResult> results(positions.size());
+	provider.getAltitudes(positions, results);
+
+	CHECK(eventually([&]{
+		std::scoped_lock<std::mutex> lock(source->requestsMutex);
+		return source->requests.size() == 2;
+	}));
+}
+
+TEST_CASE("Benchmark TilePlanetAltitudeProvider batch altitudes", "[.][benchmark]")
+{
+	const int maxLod = 4;
+	auto source = createRampTileSource(maxLod);
+	std::vector<sim::LatLon> positions = createRandomPositions(10000);
+	std::vector<sim::PlanetAltitudeProvider::AltitudeResult> results(positions.size());
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	NonBlockingTilePlanetAltitudeProvider provider(&scheduler, source, maxLod, 16);
+	REQUIRE(eventually([&]{
+		provider.getAltitudes(positions, results);
+		return std::all_of(results.begin(), results.end(), [] (const auto& result) { return !result.provisional; });
+	}));
+
+	BENCHMARK("Per-point getAltitude")
+	{
+		for (size_t i = 0; i < positions.size(); ++i)
+		{
+			results[i] = provider.getAltitude(positions[i]);
+		}
+		return results.size();
+	};
+
+	BENCHMARK("Batch getAltitudes")
+	{
+		provider.getAltitudes(positions, results);
+		return results.size();
+	};
+}
@@ -0,0 +1,71 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/OsgGeocentric.h>
+#include <SkyboltVis/Renderable/Planet/PlanetTileGeometry.h>
+
+#include <osg/Geometry>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+static const double planetRadius = 6371000;
+
+static Box2d getTestTileLatLonBounds()
+{
+	return Box2d(osg::Vec2d(0.1, 0.2), osg::Vec2d(0.11, 0.21));
+}
+
+TEST_CASE("Planet tile vertical bounds are derived from tile elevation bounds")
+{
+	Box2d latLonBounds = getTestTileLatLonBounds();
+	PlanetTileVertices vertices = createPlanetTileVertices(latLonBounds, planetRadius, HeightMapElevationBounds(100, 2000));
+
+	// Tile center is at sea level, so the bounds extend from sea level to the highest elevation
+	osg::Vec3d highestPoint = llaToGeocentric(latLonBounds.center(), 2000, planetRadius) - vertices.tileCenter;
+	CHECK(vertices.bounds.contains(highestPoint));
+	CHECK(vertices.bounds.contains(osg::Vec3d(0, 0, 0)));
+
+	// Bounds should be tighter than bounds which assume the full range of elevations on Earth
+	PlanetTileVertices conservativeVertices = createPlanetTileVertices(latLonBounds, planetRadius, HeightMapElevationBounds(-9000, 9000));
+	CHECK(vertices.bounds.radius() < conservativeVertices.bounds.radius());
+	CHECK(conservativeVertices.bounds.contains(vertices.bounds._min));
+	CHECK(conservativeVertices.bounds.contains(vertices.bounds._max));
+}
+
+TEST_CASE("Planet tile bounds include elevations below sea level")
+{
+	Box2d latLonBounds = getTestTileLatLonBounds();
+	PlanetTileVertices vertices = createPlanetTileVertices(latLonBounds, planetRadius, HeightMapElevationBounds(-400, -100));
+
+	osg::Vec3d lowestPoint = llaToGeocentric(latLonBounds.center(), -400, planetRadius) - vertices.tileCenter;
+	CHECK(vertices.bounds.contains(lowestPoint));
+	CHECK(vertices.bounds.contains(osg::Vec3d(0, 0, 0)));
+}
+
+TEST_CASE("Planet tiles share index and texture coordinate buffers")
+{
+	PlanetTileVertices vertices1 = createPlanetTileVertices(Box2d(osg::Vec2d(0.1, 0.2), osg::Vec2d(0.11, 0.21)), planetRadius, HeightMapElevationBounds(0, 0));
+	PlanetTileVertices vertices2 = createPlanetTileVertices(Box2d(osg::Vec2d(-0.5, 1.2), osg::Vec2d(-0.4, 1.3)), planetRadius, HeightMapElevationBounds(0, 0));
+
+	for (PrimitiveType type : {Triangles, Quads})
+	{
+		osg::ref_ptr<osg::Geometry> geometry1 = createPlanetTileGeometry(vertices1, type);
+		osg::ref_ptr<osg::Geometry> geometry2 = createPlanetTileGeometry(vertices2, type);
+
+		CHECK(geometry1->getVertexArray() != geometry2->getVertexArray());
+		CHECK(geometry1->getTexCoordArray(0) == geometry2->getTexCoordArray(0));
+		REQUIRE(geometry1->getNumPrimitiveSets() == 1);
+		CHECK(geometry1->getPrimitiveSet(0) == geometry2->getPrimitiveSet(0));
+
+		// Bounds are fixed to the tile's bounds
+		CHECK(geometry1->getBoundingBox().contains(vertices1.bounds._min));
+		CHECK(geometry1->getBoundingBox().contains(vertices1.bounds._max));
+	}
+
+	CHECK(createPlanetTileGeometry(vertices1, Triangles)->getPrimitiveSet(0) != createPlanetTileGeometry(vertices1, Quads)->getPrimitiveSet(0));
+}
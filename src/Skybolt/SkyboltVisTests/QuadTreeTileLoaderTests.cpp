@@ -7,7 +7,13 @@
 #include <catch2/catch.hpp>
 #include <SkyboltVis/Renderable/Planet/Tile/AsyncTileLoader.h>
 #include <SkyboltVis/Renderable/Planet/Tile/QuadTreeTileLoader.h>
+#include <SkyboltVis/Renderable/Planet/Tile/PlanetSubdivisionPredicate.h>
+#include <SkyboltVis/Renderable/Planet/Tile/PlanetTileImagesLoader.h>
 #include <SkyboltVis/Renderable/Planet/Tile/TileImagesLoader.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/TileSource.h>
+#include <SkyboltVis/OsgGeocentric.h>
+
+#include <algorithm>
 
 using namespace skybolt;
 using namespace skybolt::vis;
@@ -45,7 +51,7 @@ class DummyQuadTreeSubdivisionPredicate : public QuadTreeSubdivisionPredicate
 public:
 	~DummyQuadTreeSubdivisionPredicate() override = default;
 
-	bool operator()(const Box2d& bounds, const QuadTreeTileKey& key, const TileImages& images) override
+	bool operator()(const Box2d& bounds, const QuadTreeTileKey& key, const TileImages& images, bool currentlySubdivided) override
 	{
 		return key.level < maxSubdivisionLevel;
 	}
@@ -229,4 +235,320 @@ TEST_CASE("Find tiles added and removed from tree")
 		CHECK(addedTiles.empty());
 		CHECK(removedTiles == std::set<QuadTreeTileKey>({ QuadTreeTileKey(0, 0, 0) }));
 	}
-}
\ No newline at end of file
+}
+
+//! Tile source with data for all tiles up to a maximum level
+class LevelLimitedTileSource : public TileSource
+{
+public:
+	LevelLimitedTileSource(int maxLevel) : mMaxLevel(maxLevel) {}
+	~LevelLimitedTileSource() override = default;
+
+	osg::ref_ptr<osg::Image> createImage(const QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const override { return nullptr; }
+
+	bool hasAnyChildren(const QuadTreeTileKey& key) const override { return key.level < mMaxLevel; }
+
+	std::optional<QuadTreeTileKey> getHighestAvailableLevel(const QuadTreeTileKey& key) const override { return key; }
+
+	const std::string& getCacheSha() const override
+	{
+		static std::string r;
+		return r;
+	}
+
+private:
+	int mMaxLevel;
+};
+
+static const double testPlanetRadius = 6371000;
+
+static std::shared_ptr<PlanetSubdivisionPredicate> createPlanetSubdivisionPredicate(int maxLevel, const osg::Vec2d& observerLatLon, double observerAltitude)
+{
+	auto predicate = std::make_shared<PlanetSubdivisionPredicate>();
+	predicate->tileSources = { std::make_shared<LevelLimitedTileSource>(maxLevel) };
+	predicate->observerLatLon = observerLatLon;
+	predicate->observerAltitude = observerAltitude;
+	predicate->planetRadius = testPlanetRadius;
+	return predicate;
+}
+
+static osg::Polytope createViewFrustum(const osg::Vec3d& eye, const osg::Vec3d& target, double fovYDegrees)
+{
+	osg::Polytope frustum;
+	frustum.setToUnitFrustum(false, false);
+	frustum.transformProvidingInverse(osg::Matrix::lookAt(eye, target, osg::Vec3d(0, 0, 1)) * osg::Matrix::perspective(fovYDegrees, 1.0, 1.0, 1e8));
+	return frustum;
+}
+
+//! Completes pending loads with flat planet tiles
+static void loadPendingPlanetTiles(const std::vector<DummyAsyncTileLoader::Request>& requests)
+{
+	for (const auto& request : requests)
+	{
+		if (request.progress->state == TileProgressCallback::State::Loading && !request.progress->isCancelRequested())
+		{
+			auto images = std::make_shared<PlanetTileImages>();
+			images->heightMapElevationBounds = HeightMapElevationBounds(0, 0);
+			*request.result = images;
+			request.progress->state = TileProgressCallback::State::Loaded;
+		}
+	}
+}
+
+//! Updates the loader until it stops requesting tiles
+static void updateUntilLoadingComplete(QuadTreeTileLoader& loader, DummyAsyncTileLoader& asyncTileLoader)
+{
+	for (int i = 0; i < 1000; ++i)
+	{
+		size_t requestCount = asyncTileLoader.requests.size();
+		loadPendingPlanetTiles(asyncTileLoader.requests);
+		loader.update();
+		if (asyncTileLoader.requests.size() == requestCount && !loader.isLoading())
+		{
+			return;
+		}
+	}
+	FAIL("Loading did not complete");
+}
+
+static size_t getLeafTileCount(const QuadTreeTileLoader& loader)
+{
+	TileKeyImagesMap tiles;
+	findLeafTiles(*loader.getLoadedTree(), tiles);
+	return tiles.size();
+}
+
+TEST_CASE("Planet tiles outside view frustum are not loaded")
+{
+	const osg::Vec2d observerLatLon(0, 0);
+	const double observerAltitude = 100000;
+	const osg::Vec3d eye = llaToGeocentric(observerLatLon, observerAltitude, testPlanetRadius);
+
+	auto countLoadedTiles = [&] (const std::optional<osg::Polytope>& frustum) {
+		auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+		auto predicate = createPlanetSubdivisionPredicate(12, observerLatLon, observerAltitude);
+		predicate->viewFrustum = frustum;
+		QuadTreeTileLoader loader(asyncTileLoader, predicate);
+		updateUntilLoadingComplete(loader, *asyncTileLoader);
+		return asyncTileLoader->requests.size();
+	};
+
+	size_t unculledCount = countLoadedTiles(std::nullopt);
+	size_t lookingDownCount = countLoadedTiles(createViewFrustum(eye, osg::Vec3d(0, 0, 0), 30));
+	size_t lookingAlongHorizonCount = countLoadedTiles(createViewFrustum(eye, eye + osg::Vec3d(0, 1, -0.2) * 100000, 60));
+	size_t lookingAwayCount = countLoadedTiles(createViewFrustum(eye, eye * 2.0, 30));
+
+	CHECK(lookingDownCount < unculledCount);
+	CHECK(lookingAlongHorizonCount < unculledCount / 2);
+	CHECK(lookingAwayCount < lookingDownCount);
+}
+
+TEST_CASE("Planet tiles below horizon are not subdivided")
+{
+	const osg::Vec2d observerLatLon(0, math::piD() / 4);
+
+	auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+	auto predicate = createPlanetSubdivisionPredicate(8, observerLatLon, 100);
+	QuadTreeTileLoader loader(asyncTileLoader, predicate);
+	updateUntilLoadingComplete(loader, *asyncTileLoader);
+
+	TileKeyImagesMap tiles;
+	findLeafTiles(*loader.getLoadedTree(), tiles);
+	REQUIRE(!tiles.empty());
+
+	// Only tiles with an ancestor above the horizon can be subdivided beyond level 2.
+	// The horizon is very close to the observer, so these tiles must be within a level 2 tile width of the observer.
+	osg::Vec3d observerDirection = llaToGeocentric(observerLatLon, 0, 1);
+	for (const auto& [key, images] : tiles)
+	{
+		if (key.level >= 3)
+		{
+			auto bounds = getKeyLonLatBounds<osg::Vec2d>(key);
+			osg::Vec3d tileDirection = llaToGeocentric(math::vec2SwapComponents(bounds.center()), 0, 1);
+			CHECK(std::acos(std::clamp(observerDirection * tileDirection, -1.0, 1.0)) < math::piD() / 4 + 0.1);
+		}
+	}
+}
+
+TEST_CASE("Planet tile subdivision has hysteresis when camera turns")
+{
+	const osg::Vec2d observerLatLon(0, 0);
+	const double observerAltitude = 1000000;
+	const osg::Vec3d eye = llaToGeocentric(observerLatLon, observerAltitude, testPlanetRadius);
+
+	auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+	auto predicate = createPlanetSubdivisionPredicate(10, observerLatLon, observerAltitude);
+	QuadTreeTileLoader loader(asyncTileLoader, predicate);
+
+	auto lookAtAngle = [&] (double angle) {
+		osg::Vec3d target(0, eye.length() * std::tan(angle), 0);
+		predicate->viewFrustum = createViewFrustum(eye, target, 30);
+		updateUntilLoadingComplete(loader, *asyncTileLoader);
+	};
+
+	lookAtAngle(0);
+	size_t initialLeafCount = getLeafTileCount(loader);
+
+	// Turn slightly. Tiles that leave the frustum by a small margin should be kept.
+	lookAtAngle(math::degToRadD() * 0.5);
+	size_t requestCount = asyncTileLoader->requests.size();
+
+	// Turn back. Tiles should already be loaded.
+	lookAtAngle(0);
+	CHECK(asyncTileLoader->requests.size() == requestCount);
+	CHECK(getLeafTileCount(loader) >= initialLeafCount);
+}
+
+struct SizedTileImages : public TileImages
+{
+	~SizedTileImages() override = default;
+	size_t getSizeInBytes() const override { return 1000; }
+};
+
+static void loadPendingSizedTiles(const std::vector<DummyAsyncTileLoader::Request>& requests)
+{
+	for (const auto& request : requests)
+	{
+		if (request.progress->state == TileProgressCallback::State::Loading && !request.progress->isCancelRequested())
+		{
+			*request.result = std::make_shared<SizedTileImages>();
+			request.progress->state = TileProgressCallback::State::Loaded;
+		}
+	}
+}
+
+static void updateUntilSizedTilesLoaded(QuadTreeTileLoader& loader, DummyAsyncTileLoader& asyncTileLoader)
+{
+	for (int i = 0; i < 1000; ++i)
+	{
+		size_t requestCount = asyncTileLoader.requests.size();
+		loadPendingSizedTiles(asyncTileLoader.requests);
+		loader.update();
+		if (asyncTileLoader.requests.size() == requestCount && !loader.isLoading())
+		{
+			return;
+		}
+	}
+	FAIL("Loading did not complete");
+}
+
+TEST_CASE("Prefetched tiles are used when they become visible")
+{
+	auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+	auto predicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	predicate->maxSubdivisionLevel = 1;
+	auto prefetchPredicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	prefetchPredicate->maxSubdivisionLevel = 3;
+
+	QuadTreeTileLoader loader(asyncTileLoader, predicate);
+	loader.setPrefetchPredicates({ prefetchPredicate });
+	updateUntilSizedTilesLoaded(loader, *asyncTileLoader);
+
+	// Levels 0 and 1 are visible. Levels 2 and 3 are prefetched.
+	CHECK(asyncTileLoader->requests.size() == 2 + 8 + 32 + 128);
+	CHECK(loader.getPrefetchStats().requestCount == 32 + 128);
+	CHECK(loader.getPrefetchStats().cachedTileCount == 32 + 128);
+	CHECK(getLeafTileCount(loader) == 8);
+
+	// Make prefetched tiles visible. No further loads should be needed.
+	predicate->maxSubdivisionLevel = 3;
+	updateUntilSizedTilesLoaded(loader, *asyncTileLoader);
+
+	CHECK(asyncTileLoader->requests.size() == 2 + 8 + 32 + 128);
+	CHECK(getLeafTileCount(loader) == 128);
+
+	TilePrefetchStats stats = loader.getPrefetchStats();
+	CHECK(stats.hitCount == 32 + 128);
+	CHECK(stats.cachedTileCount == 0);
+	CHECK(stats.cachedBytes == 0);
+	CHECK(stats.evictedUnusedCount == 0);
+}
+
+TEST_CASE("Visible tiles are loaded before prefetched tiles")
+{
+	auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+	auto predicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	predicate->maxSubdivisionLevel = 1;
+	auto prefetchPredicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	prefetchPredicate->maxSubdivisionLevel = 2;
+
+	QuadTreeTileLoader loader(asyncTileLoader, predicate);
+	TilePrefetchConfig config;
+	config.maxVisibleLoadsForPrefetch = 0;
+	loader.setPrefetchConfig(config);
+	loader.setPrefetchPredicates({ prefetchPredicate });
+
+	// Load level 0, which causes level 1 to be requested
+	loader.update();
+	loadPendingSizedTiles(asyncTileLoader->requests);
+	loader.update();
+	REQUIRE(asyncTileLoader->requests.size() == 2 + 8);
+	CHECK(loader.getPrefetchStats().requestCount == 0);
+
+	// Level 1 loaded. No visible loads remain so prefetching starts.
+	loadPendingSizedTiles(asyncTileLoader->requests);
+	loader.update();
+	loader.update();
+	CHECK(loader.getPrefetchStats().requestCount > 0);
+}
+
+TEST_CASE("Prefetched tiles are limited by memory budget")
+{
+	auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+	auto predicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	predicate->maxSubdivisionLevel = 0;
+	auto prefetchPredicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	prefetchPredicate->maxSubdivisionLevel = 3;
+
+	QuadTreeTileLoader loader(asyncTileLoader, predicate);
+	TilePrefetchConfig config;
+	config.memoryBudgetBytes = SizedTileImages().getSizeInBytes() * 20;
+	loader.setPrefetchConfig(config);
+	loader.setPrefetchPredicates({ prefetchPredicate });
+
+	for (int i = 0; i < 100; ++i)
+	{
+		loadPendingSizedTiles(asyncTileLoader->requests);
+		loader.update();
+		CHECK(loader.getPrefetchStats().cachedBytes <= config.memoryBudgetBytes);
+	}
+
+	TilePrefetchStats stats = loader.getPrefetchStats();
+	CHECK(stats.cachedBytes > 0);
+	CHECK(stats.requestCount < 8 + 32 + 128);
+}
+
+TEST_CASE("Prefetch loads are canceled when no longer predicted")
+{
+	auto asyncTileLoader = std::make_shared<DummyAsyncTileLoader>();
+	auto predicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	predicate->maxSubdivisionLevel = 0;
+	auto prefetchPredicate = std::make_shared<DummyQuadTreeSubdivisionPredicate>();
+	prefetchPredicate->maxSubdivisionLevel = 1;
+
+	QuadTreeTileLoader loader(asyncTileLoader, predicate);
+	loader.setPrefetchPredicates({ prefetchPredicate });
+
+	loadPendingSizedTiles(asyncTileLoader->requests);
+	loader.update();
+	loadPendingSizedTiles(asyncTileLoader->requests);
+	loader.update();
+	REQUIRE(loader.getPrefetchStats().requestCount > 0);
+
+	// Stop predicting level 1 while its loads are in progress.
+	// Loads are canceled on the update after the one that stops requiring them.
+	prefetchPredicate->maxSubdivisionLevel = 0;
+	loader.update();
+	loader.update();
+
+	for (const auto& request : asyncTileLoader->requests)
+	{
+		if (request.key.level == 1)
+		{
+			CHECK(request.progress->isCancelRequested());
+		}
+	}
+	TilePrefetchStats stats = loader.getPrefetchStats();
+	CHECK(stats.cachedTileCount == 0);
+	CHECK(stats.evictedUnusedCount == stats.requestCount);
+}
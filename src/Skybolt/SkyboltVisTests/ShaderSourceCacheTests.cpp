@@ -0,0 +1,127 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/Shader/ShaderSourceCache.h>
+
+#include <map>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+//! In-memory shader files, keyed on filename
+struct TestShaderFiles
+{
+	std::map<std::string, std::string> files;
+	std::map<std::string, int> readCounts;
+
+	ShaderSourceCache createCache()
+	{
+		return ShaderSourceCache(
+			[this] (const std::string& filename) {
+				return files.count(filename) ? filename : std::string();
+			},
+			[this] (const std::string& resolvedFilename) -> std::optional<std::string> {
+				++readCounts[resolvedFilename];
+				auto i = files.find(resolvedFilename);
+				return (i == files.end()) ? std::nullopt : std::optional<std::string>(i->second);
+			});
+	}
+};
+
+TEST_CASE("Parse shader include directives")
+{
+	CHECK(parseShaderIncludeDirective("#include \"A.h\"") == "A.h");
+	CHECK(parseShaderIncludeDirective("#include <B.h>") == "B.h");
+	CHECK(parseShaderIncludeDirective("  \t# include \"Dir/C.h\" // comment\r") == "Dir/C.h");
+	CHECK(!parseShaderIncludeDirective("#included \"A.h\""));
+	CHECK(!parseShaderIncludeDirective("#include\"A.h\""));
+	CHECK(!parseShaderIncludeDirective("#include \"A.h"));
+	CHECK(!parseShaderIncludeDirective("// #include \"A.h\""));
+	CHECK(!parseShaderIncludeDirective("#define X"));
+	CHECK(!parseShaderIncludeDirective(""));
+}
+
+TEST_CASE("ShaderSourceCache expands nested includes")
+{
+	TestShaderFiles files;
+	files.files["Shaders/Main.frag"] = "#version 440\n#include \"A.h\"\nvoid main() {}\n";
+	files.files["Shaders/A.h"] = "#include \"B.h\"\nfloat a;";
+	files.files["Shaders/B.h"] = "float b;\n";
+
+	ShaderSourceCache cache = files.createCache();
+	CHECK(cache.getPreprocessedSource("Shaders/Main.frag") == "#version 440\nfloat b;\n\nfloat a;\nvoid main() {}\n");
+	CHECK(cache.getDependencies("Shaders/Main.frag") == std::set<std::string>{"Shaders/Main.frag", "Shaders/A.h", "Shaders/B.h"});
+
+	CHECK(cache.preprocessSource("#include \"B.h\"\n", "Shaders") == "float b;\n\n");
+}
+
+TEST_CASE("ShaderSourceCache reads each file once")
+{
+	TestShaderFiles files;
+	files.files["Shaders/A.vert"] = "#include \"Common.h\"\nA\n";
+	files.files["Shaders/B.vert"] = "#include \"Common.h\"\n#include \"Common.h\"\nB\n";
+	files.files["Shaders/Common.h"] = "Common\n";
+
+	ShaderSourceCache cache = files.createCache();
+	cache.getPreprocessedSource("Shaders/A.vert");
+	cache.getPreprocessedSource("Shaders/B.vert");
+	cache.getPreprocessedSource("Shaders/A.vert");
+
+	CHECK(cache.getFileReadCount() == 3);
+	CHECK(files.readCounts["Shaders/Common.h"] == 1);
+}
+
+TEST_CASE("ShaderSourceCache throws on cyclic includes")
+{
+	TestShaderFiles files;
+	files.files["Shaders/A.h"] = "#include \"B.h\"\n";
+	files.files["Shaders/B.h"] = "#include \"A.h\"\n";
+
+	ShaderSourceCache cache = files.createCache();
+	CHECK_THROWS(cache.getPreprocessedSource("Shaders/A.h"));
+}
+
+TEST_CASE("ShaderSourceCache throws on missing include")
+{
+	TestShaderFiles files;
+	files.files["Shaders/A.vert"] = "#include \"Missing.h\"\n";
+
+	ShaderSourceCache cache = files.createCache();
+	CHECK_THROWS(cache.getPreprocessedSource("Shaders/A.vert"));
+}
+
+TEST_CASE("ShaderSourceCache invalidates only files depending on a changed include")
+{
+	TestShaderFiles files;
+	files.files["Shaders/A.vert"] = "#include \"Lighting.h\"\nA\n";
+	files.files["Shaders/B.vert"] = "#include \"Common.h\"\nB\n";
+	files.files["Shaders/Lighting.h"] = "#include \"Common.h\"\nLighting\n";
+	files.files["Shaders/Common.h"] = "Common\n";
+	files.files["Shaders/C.vert"] = "C\n";
+
+	ShaderSourceCache cache = files.createCache();
+	for (const std::string& filename : {"Shaders/A.vert", "Shaders/B.vert", "Shaders/C.vert"})
+	{
+		cache.getPreprocessedSource(filename);
+	}
+
+	// Change an include of an include
+	files.files["Shaders/Common.h"] = "Common2\n";
+	std::set<std::string> changed = cache.invalidate("Shaders/Common.h");
+	CHECK(changed.count("Shaders/A.vert"));
+	CHECK(changed.count("Shaders/B.vert"));
+	CHECK(!changed.count("Shaders/C.vert"));
+
+	// Only the changed file is read again
+	size_t readCount = cache.getFileReadCount();
+	CHECK(cache.getPreprocessedSource("Shaders/A.vert") == "Common2\n\nLighting\n\nA\n");
+	CHECK(cache.getPreprocessedSource("Shaders/B.vert") == "Common2\n\nB\n");
+	CHECK(cache.getFileReadCount() == readCount + 1);
+
+	// Changing a file that no shader depends on invalidates nothing
+	CHECK(cache.invalidate("Shaders/Unused.h").empty());
+}
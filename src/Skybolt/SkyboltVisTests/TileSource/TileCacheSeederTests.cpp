@@ -0,0 +1,236 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/CachedTileSource.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/TileCacheSeeder.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <osg/Image>
+#include <filesystem>
+#include <set>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace fs = std::filesystem;
+
+static fs::path getCacheDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "TileCacheSeeder";
+}
+
+//! Creates images in memory and counts the number of images created
+class CountingTileSource : public TileSource
+{
+public:
+	CountingTileSource(int maxLevel) : mMaxLevel(maxLevel) {}
+
+	osg::ref_ptr<osg::Image> createImage(const QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const override
+	{
+		++createdCount;
+		osg::ref_ptr<osg::Image> image = new osg::Image();
+		image->allocateImage(1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+		return image;
+	}
+
+	bool hasAnyChildren(const QuadTreeTileKey& key) const override
+	{
+		return key.level < mMaxLevel;
+	}
+
+	std::optional<QuadTreeTileKey> getHighestAvailableLevel(const QuadTreeTileKey& key) const override
+	{
+		return key.level <= mMaxLevel ? key : createAncestorKey(key, mMaxLevel);
+	}
+
+	const std::string& getCacheSha() const override
+	{
+		static const std::string s = "counting";
+		return s;
+	}
+
+	mutable std::atomic<int> createdCount = 0;
+
+private:
+	int mMaxLevel;
+};
+
+TEST_CASE("Find tiles in lat/lon bounds")
+{
+	// Level 0 has 2x1 tiles, each covering 180 degrees of longitude
+	Box2d westernHemisphere(osg::Vec2d(-1.0, -2.0), osg::Vec2d(1.0, -1.0));
+	std::vector<QuadTreeTileKey> keys = findTilesInLatLonBounds(westernHemisphere, 0);
+	REQUIRE(keys.size() == 1);
+	CHECK(keys[0] == QuadTreeTileKey(0, 0, 0));
+
+	Box2d bothHemispheres(osg::Vec2d(-1.0, -1.0), osg::Vec2d(1.0, 1.0));
+	CHECK(findTilesInLatLonBounds(bothHemispheres, 0).size() == 2);
+
+	// Level 2 has 8x4 tiles, each covering 45 degrees. The bounds span two tiles in each axis.
+	Box2d bounds(osg::Vec2d(10, 10) * math::degToRadD(), osg::Vec2d(50, 50) * math::degToRadD());
+	keys = findTilesInLatLonBounds(bounds, 2);
+	CHECK(keys.size() == 4);
+}
+
+TEST_CASE("Route corridor width applies to its level and higher levels")
+{
+	TileCacheSeedRoute route;
+	route.corridorWidths = {{2, 1000.0}, {5, 100.0}};
+
+	CHECK(route.getCorridorWidth(0) == 1000.0);
+	CHECK(route.getCorridorWidth(2) == 1000.0);
+	CHECK(route.getCorridorWidth(4) == 1000.0);
+	CHECK(route.getCorridorWidth(5) == 100.0);
+	CHECK(route.getCorridorWidth(10) == 100.0);
+}
+
+TEST_CASE("Read tile cache seed route from json")
+{
+	nlohmann::json json = nlohmann::json::parse(R"({
+		"points": [[10, 20], [11, 21]],
+		"corridorWidths": [{"level": 0, "width": 5000}]
+	})");
+
+	TileCacheSeedRoute route = readTileCacheSeedRoute(json);
+	REQUIRE(route.points.size() == 2);
+	CHECK(route.points[1].x() == Approx(11.0 * math::degToRadD()));
+	CHECK(route.points[1].y() == Approx(21.0 * math::degToRadD()));
+	CHECK(route.getCorridorWidth(3) == 5000.0);
+
+	CHECK_THROWS(readTileCacheSeedRoute(nlohmann::json::parse(R"({"points": [], "corridorWidths": []})")));
+}
+
+TEST_CASE("Find tiles along route")
+{
+	const double planetRadius = 6371000;
+	const int level = 8;
+	const double tileSize = math::piD() / double(1 << level);
+
+	// East-west route along the equator spanning several tiles
+	TileCacheSeedRoute route;
+	route.points = {osg::Vec2d(0.1 * tileSize, 0.5 * tileSize), osg::Vec2d(0.1 * tileSize, 4.5 * tileSize)};
+
+	SECTION("Narrow corridor only covers tiles on the route")
+	{
+		route.corridorWidths[0] = 0.01 * tileSize * planetRadius;
+		std::vector<QuadTreeTileKey> keys = findTilesAlongRoute(route, level, planetRadius);
+		CHECK(keys.size() == 5);
+
+		std::set<int> rows;
+		for (const QuadTreeTileKey& key : keys)
+		{
+			rows.insert(key.y);
+		}
+		CHECK(rows.size() == 1);
+	}
+
+	SECTION("Wide corridor covers tiles either side of the route")
+	{
+		route.corridorWidths[0] = 2.0 * tileSize * planetRadius;
+		std::vector<QuadTreeTileKey> keys = findTilesAlongRoute(route, level, planetRadius);
+
+		std::set<int> rows;
+		for (const QuadTreeTileKey& key : keys)
+		{
+			rows.insert(key.y);
+		}
+		CHECK(rows.size() == 3);
+	}
+
+	SECTION("Every route point is covered")
+	{
+		route.corridorWidths[0] = 0.01 * tileSize * planetRadius;
+		std::vector<QuadTreeTileKey> keys = findTilesAlongRoute(route, level, planetRadius);
+		for (double t = 0; t <= 1.0; t += 0.05)
+		{
+			osg::Vec2d latLon = route.points[0] * (1.0 - t) + route.points[1] * t;
+			QuadTreeTileKey key = getKeyAtLevelIntersectingLonLatPoint(level, osg::Vec2d(latLon.y(), latLon.x()));
+			CHECK(std::find(keys.begin(), keys.end(), key) != keys.end());
+		}
+	}
+}
+
+TEST_CASE("Tiles beyond source's maximum level are excluded from region")
+{
+	CountingTileSource source(/* maxLevel */ 1);
+
+	TileCacheSeedRegion region;
+	region.latLonBounds = Box2d(osg::Vec2d(-math::halfPiD(), -math::piD()), osg::Vec2d(math::halfPiD(), math::piD()));
+	region.levelRange = IntRangeInclusive(0, 3);
+
+	std::vector<QuadTreeTileKey> keys = findTilesInRegion(region, source);
+	CHECK(keys.size() == 2 + 8);
+}
+
+TEST_CASE("Seed tile cache and resume after interruption")
+{
+	fs::remove_all(getCacheDirectory());
+
+	auto source = std::make_shared<CountingTileSource>(/* maxLevel */ 2);
+	CachedTileSource cachedSource(source, getCacheDirectory().string());
+
+	TileCacheSeedRegion region;
+	region.latLonBounds = Box2d(osg::Vec2d(-math::halfPiD(), -math::piD()), osg::Vec2d(math::halfPiD(), math::piD()));
+	region.levelRange = IntRangeInclusive(0, 2);
+	std::vector<QuadTreeTileKey> keys = findTilesInRegion(region, *source);
+	REQUIRE(keys.size() == 2 + 8 + 32);
+
+	TileCacheSeederConfig config;
+	config.threadCount = 4;
+
+	int progressReportCount = 0;
+	config.progressHandler = [&] (const TileCacheSeederProgress& progress) {
+		++progressReportCount;
+		CHECK(progress.getCompletedCount() <= progress.totalTileCount);
+	};
+
+	// Fetch all tiles
+	TileCacheSeederProgress progress = seedTileCache(cachedSource, keys, config);
+	CHECK(progress.totalTileCount == keys.size());
+	CHECK(progress.fetchedCount == keys.size());
+	CHECK(progress.alreadyCachedCount == 0);
+	CHECK(progress.failedCount == 0);
+	CHECK(source->createdCount.load() == int(keys.size()));
+	CHECK(progressReportCount >= 1);
+
+	CHECK(fs::exists(getCacheDirectory() / "2" / "3" / "1.png"));
+	for (const QuadTreeTileKey& key : keys)
+	{
+		CHECK(cachedSource.isCached(key));
+	}
+
+	// Seeding again fetches nothing
+	source->createdCount = 0;
+	progress = seedTileCache(cachedSource, keys, config);
+	CHECK(progress.fetchedCount == 0);
+	CHECK(progress.alreadyCachedCount == keys.size());
+	CHECK(source->createdCount.load() == 0);
+
+	// Seeding after tiles are missing, e.g. due to interruption, only fetches the missing tiles
+	fs::remove(cachedSource.getCacheFilename(QuadTreeTileKey(2, 3, 1)));
+	fs::remove(cachedSource.getCacheFilename(QuadTreeTileKey(1, 0, 0)));
+	progress = seedTileCache(cachedSource, keys, config);
+	CHECK(progress.fetchedCount == 2);
+	CHECK(progress.alreadyCachedCount == keys.size() - 2);
+	CHECK(source->createdCount.load() == 2);
+}
+
+TEST_CASE("Canceled seeding stops fetching tiles")
+{
+	fs::remove_all(getCacheDirectory());
+
+	auto source = std::make_shared<CountingTileSource>(/* maxLevel */ 2);
+	CachedTileSource cachedSource(source, getCacheDirectory().string());
+
+	std::vector<QuadTreeTileKey> keys = findTilesInLatLonBounds(Box2d(osg::Vec2d(-1, -3), osg::Vec2d(1, 3)), 2);
+
+	TileCacheSeederConfig config;
+	config.cancelSupplier = [] { return true; };
+
+	TileCacheSeederProgress progress = seedTileCache(cachedSource, keys, config);
+	CHECK(progress.getCompletedCount() == 0);
+}
@@ -0,0 +1,421 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/VertexQuantization.h>
+#include <SkyboltVis/Renderable/BuildingsBatch.h>
+#include <SkyboltVis/Renderable/RoadsBatch.h>
+#include <SkyboltVis/Renderable/Planet/Features/BuildingTypes.h>
+#include <SkyboltVis/Renderable/Water/LakesBatch.h>
+
+#include <osg/Geometry>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+constexpr double degToRad = 3.14159265358979 / 180.0;
+
+static osg::Vec3f randomUnitVector(std::mt19937& generator)
+{
+	std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+	float z = distribution(generator);
+	float theta = 3.14159265f * distribution(generator);
+	float r = std::sqrt(std::max(0.f, 1.f - z * z));
+	return osg::Vec3f(r * std::cos(theta), r * std::sin(theta), z);
+}
+
+//! Uses atan2 in double precision, because acos is inaccurate for small angles
+static double angleBetween(const osg::Vec3f& a, const osg::Vec3f& b)
+{
+	osg::Vec3d ad(a);
+	osg::Vec3d bd(b);
+	return std::atan2((ad ^ bd).length(), ad * bd);
+}
+
+static bool withinError(const osg::Vec3f& a, const osg::Vec3f& b, const osg::Vec3f& maxError)
+{
+	// Allow for float rounding of large coordinates
+	const float tolerance = 1e-3f;
+	osg::Vec3f diff = a - b;
+	return std::abs(diff.x()) <= maxError.x() + tolerance
+		&& std::abs(diff.y()) <= maxError.y() + tolerance
+		&& std::abs(diff.z()) <= maxError.z() + tolerance;
+}
+
+TEST_CASE("Quantized positions are reconstructed within half a quantization step")
+{
+	osg::BoundingBoxf bounds(osg::Vec3f(-2000, -1500, -200), osg::Vec3f(2000, 2500, 10));
+	PositionQuantizer quantizer(bounds);
+
+	// 4km over 65535 steps
+	osg::Vec3f maxError = quantizer.getMaxError();
+	CHECK(maxError.x() == Approx(4000.0 / 65535.0 * 0.5));
+	CHECK(maxError.z() == Approx(210.0 / 65535.0 * 0.5));
+
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> distribution(0.f, 1.f);
+	for (int i = 0; i < 10000; ++i)
+	{
+		osg::Vec3f position = bounds._min + osg::componentMultiply(bounds._max - bounds._min,
+			osg::Vec3f(distribution(generator), distribution(generator), distribution(generator)));
+
+		osg::Vec4us quantized = quantizer.quantize(position, 123);
+		CHECK(quantized.w() == 123);
+		REQUIRE(withinError(quantizer.dequantize(quantized), position, maxError));
+	}
+
+	// Corners are exact
+	CHECK(withinError(quantizer.dequantize(quantizer.quantize(bounds._min)), bounds._min, osg::Vec3f()));
+	CHECK(withinError(quantizer.dequantize(quantizer.quantize(bounds._max)), bounds._max, osg::Vec3f()));
+
+	// Points outside bounds are clamped
+	CHECK(withinError(quantizer.dequantize(quantizer.quantize(bounds._max + osg::Vec3f(10, 10, 10))), bounds._max, osg::Vec3f()));
+}
+
+TEST_CASE("Octahedral normals are reconstructed accurately")
+{
+	for (const osg::Vec3f& normal : {
+		osg::Vec3f(1, 0, 0), osg::Vec3f(-1, 0, 0),
+		osg::Vec3f(0, 1, 0), osg::Vec3f(0, -1, 0),
+		osg::Vec3f(0, 0, 1), osg::Vec3f(0, 0, -1)})
+	{
+		CHECK(angleBetween(decodeOctahedralNormal(encodeOctahedralNormal(normal)), normal) < 1e-4f);
+	}
+
+	std::mt19937 generator(0);
+	double maxError = 0;
+	for (int i = 0; i < 100000; ++i)
+	{
+		osg::Vec3f normal = randomUnitVector(generator);
+		osg::Vec3f decoded = decodeOctahedralNormal(encodeOctahedralNormal(normal));
+		CHECK(decoded.length() == Approx(1.f));
+		maxError = std::max(maxError, angleBetween(decoded, normal));
+	}
+	CHECK(maxError < 0.01 * degToRad);
+}
+
+TEST_CASE("Quantized texture coordinates are reconstructed within half a fixed point step")
+{
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<float> distribution(-100.f, 100.f);
+	for (int i = 0; i < 10000; ++i)
+	{
+		osg::Vec2f texCoord(distribution(generator), distribution(generator));
+		osg::Vec4s quantized = quantizeTexCoord(texCoord, 3, 4);
+		CHECK(quantized.z() == 3);
+		CHECK(quantized.w() == 4);
+		REQUIRE((dequantizeTexCoordXy(quantized) - texCoord).length() <= 0.5f * std::sqrt(2.f) / texCoordQuantizationStepsPerUnit + 1e-5f);
+	}
+}
+
+//! Creates a city of rotated rectangular buildings on a grid
+static Buildings createSyntheticCity(int buildingsPerSide, float spacing)
+{
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<float> size(8.f, 30.f);
+	std::uniform_real_distribution<float> height(5.f, 120.f);
+	std::uniform_real_distribution<float> angle(0.f, 3.14159265f);
+
+	Buildings buildings;
+	for (int y = 0; y < buildingsPerSide; ++y)
+	{
+		for (int x = 0; x < buildingsPerSide; ++x)
+		{
+			osg::Vec3f center((x - buildingsPerSide / 2) * spacing, (y - buildingsPerSide / 2) * spacing, 0);
+			float halfWidth = size(generator) * 0.5f;
+			float halfDepth = size(generator) * 0.5f;
+			float theta = angle(generator);
+			osg::Vec3f u(std::cos(theta), std::sin(theta), 0);
+			osg::Vec3f v(-u.y(), u.x(), 0);
+
+			Building building;
+			building.height = height(generator);
+			building.points = {
+				center - u * halfWidth - v * halfDepth,
+				center - u * halfWidth + v * halfDepth,
+				center + u * halfWidth + v * halfDepth,
+				center + u * halfWidth - v * halfDepth
+			};
+			buildings.push_back(building);
+		}
+	}
+	return buildings;
+}
+
+//! Dequantizes positions the same way as the shader, using uniforms from the geometry
+static std::vector<osg::Vec3f> dequantizePositions(const osg::Geometry& geometry, osg::Vec3f& scale)
+{
+	osg::Vec3f offset;
+	REQUIRE(geometry.getStateSet());
+	REQUIRE(geometry.getStateSet()->getUniform("positionDequantizeOffset")->get(offset));
+	REQUIRE(geometry.getStateSet()->getUniform("positionDequantizeScale")->get(scale));
+
+	auto positions = dynamic_cast<const osg::Vec4usArray*>(geometry.getVertexArray());
+	REQUIRE(positions);
+
+	std::vector<osg::Vec3f> result;
+	for (const osg::Vec4us& p : *positions)
+	{
+		result.push_back(offset + osg::componentMultiply(osg::Vec3f(p.x(), p.y(), p.z()), scale));
+	}
+	return result;
+}
+
+static size_t getVertexDataSize(const osg::Geometry& geometry)
+{
+	size_t size = geometry.getVertexArray()->getTotalDataSize();
+	if (geometry.getNormalArray())
+	{
+		size += geometry.getNormalArray()->getTotalDataSize();
+	}
+	if (geometry.getTexCoordArray(0))
+	{
+		size += geometry.getTexCoordArray(0)->getTotalDataSize();
+	}
+	return size;
+}
+
+TEST_CASE("Synthetic city buildings are reconstructed accurately with reduced memory")
+{
+	Buildings buildings = createSyntheticCity(40, 50);
+
+	BuildingTypes buildingTypes;
+	buildingTypes.facades = {{4, 3}, {2, 5}};
+	buildingTypes.roofCount = 2;
+
+	osg::ref_ptr<osg::Geometry> geometry = createBuildingsGeometry(buildings, buildingTypes);
+
+	osg::Vec3f scale;
+	std::vector<osg::Vec3f> positions = dequantizePositions(*geometry, scale);
+	auto normals = dynamic_cast<const osg::Vec2sArray*>(geometry->getNormalArray());
+	REQUIRE(normals);
+	REQUIRE(normals->size() == positions.size());
+
+	// 2km city spans 65535 steps, so positions should be accurate to about 1.5cm
+	osg::Vec3f maxError = scale * 0.5f;
+	CHECK(maxError.x() < 0.02f);
+	CHECK(maxError.y() < 0.02f);
+
+	// Vertices are ordered as 4 per wall, followed by 1 per roof point, for each building
+	size_t vertex = 0;
+	double maxNormalError = 0;
+	for (const Building& building : buildings)
+	{
+		osg::Vec3f height(0, 0, building.height);
+		size_t pointCount = building.points.size();
+		for (size_t i = 0; i < pointCount; ++i)
+		{
+			const osg::Vec3f& p0 = building.points[i];
+			const osg::Vec3f& p1 = building.points[(i + 1) % pointCount];
+			std::vector<osg::Vec3f> expected = {p0, p1, p1 - height, p0 - height};
+
+			osg::Vec3f edge = p1 - p0;
+			osg::Vec3f expectedNormal = osg::Vec3f(edge.y(), -edge.x(), 0);
+			expectedNormal.normalize();
+
+			for (const osg::Vec3f& expectedPosition : expected)
+			{
+				REQUIRE(withinError(positions[vertex], expectedPosition, maxError));
+				maxNormalError = std::max(maxNormalError, angleBetween(decodeOctahedralNormal((*normals)[vertex]), expectedNormal));
+				++vertex;
+			}
+		}
+
+		for (const osg::Vec3f& point : building.points)
+		{
+			REQUIRE(withinError(positions[vertex], point - height, maxError));
+			maxNormalError = std::max(maxNormalError, angleBetween(decodeOctahedralNormal((*normals)[vertex]), osg::Vec3f(0, 0, -1)));
+			++vertex;
+		}
+	}
+	CHECK(vertex == positions.size());
+	CHECK(maxNormalError < 0.01 * degToRad);
+
+	// Previous format used float positions, float normals and vec4 float texture coordinates
+	size_t floatVertexSize = sizeof(osg::Vec3f) + sizeof(osg::Vec3f) + sizeof(osg::Vec4f);
+	size_t floatDataSize = positions.size() * floatVertexSize;
+	size_t quantizedDataSize = getVertexDataSize(*geometry);
+	CHECK(floatVertexSize == 40);
+	CHECK(quantizedDataSize == positions.size() * 20);
+	CHECK(quantizedDataSize * 2 <= floatDataSize);
+}
+
+TEST_CASE("Long road texture coordinates stay within fixed point range")
+{
+	// Straight 10km road
+	Road road;
+	road.laneCount = 2;
+	road.width = 8;
+	road.endLaneCounts[0] = -1;
+	road.endLaneCounts[1] = -1;
+	for (int i = 0; i <= 200; ++i)
+	{
+		road.points.push_back(osg::Vec3f(i * 50.f, 0, 0));
+	}
+
+	osg::ref_ptr<osg::Geometry> geometry = createRoadsGeometry({road});
+
+	osg::Vec3f scale;
+	std::vector<osg::Vec3f> positions = dequantizePositions(*geometry, scale);
+	auto texCoords = dynamic_cast<const osg::Vec4sArray*>(geometry->getTexCoordArray(0));
+	REQUIRE(texCoords);
+	REQUIRE(texCoords->size() == positions.size());
+
+	// V is wrapped, which requires extra vertices
+	CHECK(positions.size() > road.points.size() * 2);
+
+	float maxV = 0;
+	for (size_t i = 0; i < texCoords->size(); i += 2)
+	{
+		osg::Vec2f left = dequantizeTexCoordXy((*texCoords)[i]);
+		osg::Vec2f right = dequantizeTexCoordXy((*texCoords)[i + 1]);
+		CHECK(left.y() == right.y());
+		CHECK((*texCoords)[i].z() == 0);
+		CHECK((*texCoords)[i + 1].z() == 1);
+		maxV = std::max(maxV, left.y());
+
+		// Road edges are either side of the center line
+		CHECK(positions[i].y() == Approx(-positions[i + 1].y()).margin(0.01));
+		CHECK(std::abs(positions[i].y()) == Approx(road.width * 0.5 + 0.5).margin(0.01));
+	}
+	CHECK(maxV < 70.f);
+
+	// Triangles never span a wrap, so each triangle covers at most one 50m segment (5 texture repeats) in V
+	const osg::DrawElementsUInt* elements = dynamic_cast<const osg::DrawElementsUInt*>(geometry->getPrimitiveSet(0));
+	REQUIRE(elements);
+	for (size_t i = 0; i < elements->size(); i += 3)
+	{
+		float v0 = dequantizeTexCoordXy((*texCoords)[(*elements)[i]]).y();
+		float v1 = dequantizeTexCoordXy((*texCoords)[(*elements)[i + 1]]).y();
+		float v2 = dequantizeTexCoordXy((*texCoords)[(*elements)[i + 2]]).y();
+		REQUIRE(std::max({v0, v1, v2}) - std::min({v0, v1, v2}) <= 5.01f);
+	}
+
+	// Previous format used float positions, normals and texture coordinates
+	size_t floatDataSize = positions.size() * sizeof(osg::Vec3f) * 3;
+	CHECK(getVertexDataSize(*geometry) * 1.75 <= floatDataSize);
+}
+
+TEST_CASE("Road segments longer than the texture wrap distance stay within fixed point range")
+{
+	// Single 5km segment, which spans 500 texture repeats
+	Road road;
+	road.laneCount = 2;
+	road.width = 8;
+	road.endLaneCounts[0] = -1;
+	road.endLaneCounts[1] = -1;
+	road.points = {osg::Vec3f(0, 0, 0), osg::Vec3f(5000, 0, 0)};
+
+	osg::ref_ptr<osg::Geometry> geometry = createRoadsGeometry({road});
+
+	osg::Vec3f scale;
+	std::vector<osg::Vec3f> positions = dequantizePositions(*geometry, scale);
+	auto texCoords = dynamic_cast<const osg::Vec4sArray*>(geometry->getTexCoordArray(0));
+	REQUIRE(texCoords);
+	REQUIRE(texCoords->size() == positions.size());
+
+	// The segment is split, which requires extra vertices
+	CHECK(positions.size() > road.points.size() * 2);
+
+	// No coordinate saturates
+	constexpr short maxFixedPoint = std::numeric_limits<short>::max();
+	for (const osg::Vec4s& texCoord : *texCoords)
+	{
+		CHECK(texCoord.y() < maxFixedPoint);
+		CHECK(texCoord.y() >= 0);
+	}
+
+	// Within each triangle, V changes at the same rate as distance along the road, so the texture is not smeared
+	const osg::DrawElementsUInt* elements = dynamic_cast<const osg::DrawElementsUInt*>(geometry->getPrimitiveSet(0));
+	REQUIRE(elements);
+	for (size_t i = 0; i < elements->size(); i += 3)
+	{
+		float minV = std::numeric_limits<float>::max();
+		float maxV = std::numeric_limits<float>::lowest();
+		float minX = std::numeric_limits<float>::max();
+		float maxX = std::numeric_limits<float>::lowest();
+		for (size_t j = i; j < i + 3; ++j)
+		{
+			float v = dequantizeTexCoordXy((*texCoords)[(*elements)[j]]).y();
+			float x = positions[(*elements)[j]].x();
+			minV = std::min(minV, v);
+			maxV = std::max(maxV, v);
+			minX = std::min(minX, x);
+			maxX = std::max(maxX, x);
+		}
+		REQUIRE(maxV - minV == Approx((maxX - minX) / 10.f).margin(0.05));
+	}
+}
+
+TEST_CASE("Long building walls stay within fixed point range")
+{
+	// 3km long building. With 4 levels per texture, each texture repeat is 15.6m wide, so the long walls span about 190 repeats.
+	Building building;
+	building.height = 20;
+	building.points = {osg::Vec3f(0, 0, 0), osg::Vec3f(0, 20, 0), osg::Vec3f(3000, 20, 0), osg::Vec3f(3000, 0, 0)};
+
+	BuildingTypes buildingTypes;
+	buildingTypes.facades = {{4, 3}};
+	buildingTypes.roofCount = 1;
+
+	osg::ref_ptr<osg::Geometry> geometry = createBuildingsGeometry({building}, buildingTypes);
+
+	osg::Vec3f scale;
+	std::vector<osg::Vec3f> positions = dequantizePositions(*geometry, scale);
+	auto texCoords = dynamic_cast<const osg::Vec4sArray*>(geometry->getTexCoordArray(0));
+	REQUIRE(texCoords);
+
+	// Long walls are split into several quads
+	size_t roofVertexCount = building.points.size();
+	size_t wallVertexCount = positions.size() - roofVertexCount;
+	CHECK(wallVertexCount > building.points.size() * 4);
+
+	// Wall quads are 4 vertices each, and the U span of each quad matches its width
+	const float textureRepeatWidth = 4 * 3.9f;
+	for (size_t i = 0; i < wallVertexCount; i += 4)
+	{
+		float u0 = dequantizeTexCoordXy((*texCoords)[i]).x();
+		float u1 = dequantizeTexCoordXy((*texCoords)[i + 1]).x();
+		CHECK(u0 == 0.f);
+		CHECK(u1 <= 64.f);
+		CHECK((*texCoords)[i + 1].x() < std::numeric_limits<short>::max());
+
+		float width = (positions[i + 1] - positions[i]).length();
+		CHECK(u1 * textureRepeatWidth == Approx(width).margin(1.0));
+	}
+}
+
+TEST_CASE("Lakes store only quantized positions")
+{
+	Lake lake;
+	for (int i = 0; i < 64; ++i)
+	{
+		float theta = float(i) / 64.f * 2.f * 3.14159265f;
+		lake.points.push_back(osg::Vec3f(std::cos(theta) * 500.f, std::sin(theta) * 300.f, 0));
+	}
+
+	osg::ref_ptr<osg::Geometry> geometry = createLakesGeometry({lake});
+	CHECK(!geometry->getNormalArray());
+	CHECK(!geometry->getTexCoordArray(0));
+
+	osg::Vec3f scale;
+	std::vector<osg::Vec3f> positions = dequantizePositions(*geometry, scale);
+	REQUIRE(positions.size() == lake.points.size());
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		CHECK(positions[i].x() == Approx(lake.points[i].x()).margin(0.01));
+		CHECK(positions[i].y() == Approx(lake.points[i].y()).margin(0.01));
+	}
+
+	// Previous format used float positions, float normals and vec2 float texture coordinates
+	size_t floatDataSize = positions.size() * (sizeof(osg::Vec3f) * 2 + sizeof(osg::Vec2f));
+	CHECK(getVertexDataSize(*geometry) * 4 == floatDataSize);
+}
@@ -0,0 +1,142 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+//! Command line tool which fetches the tiles needed for a region or route and writes them to the tile cache,
+//! so that the tiles are available on machines without internet access.
+//!
+//! Example usage:
+//!   TileCacheSeeder --tileSource albedo.json --bounds 47.0,-123.0,48.0,-122.0 --minLevel 0 --maxLevel 12
+//!   TileCacheSeeder --tileSource albedo.json --route route.json --maxLevel 15
+//!
+//! The tile source file contains a tile source in the same format as tile sources in entity template files.
+//! The route file is in the form:
+//!   { "points": [[latDegrees, lonDegrees], ...], "corridorWidths": [{"level": 0, "width": 100000}, {"level": 12, "width": 5000}] }
+//! Tiles are written to the directory given by the SKYBOLT_CACHE_DIR environment variable if set, otherwise to the default cache directory.
+//! Tiles already in the cache are skipped, so the tool can be run again to resume after interruption.
+
+#include <SkyboltEngine/EngineCommandLineParser.h>
+#include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltEngine/EngineSettings.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/CachedTileSource.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/TileCacheSeeder.h>
+#include <SkyboltCommon/Json/JsonHelpers.h>
+#include <SkyboltCommon/Json/ReadJsonFile.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <iomanip>
+#include <iostream>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace po = boost::program_options;
+
+//! @param str is in the form "minLatDegrees,minLonDegrees,maxLatDegrees,maxLonDegrees"
+static Box2d parseLatLonBounds(const std::string& str)
+{
+	std::vector<std::string> parts;
+	boost::split(parts, str, boost::is_any_of(","));
+	if (parts.size() != 4)
+	{
+		throw std::runtime_error("Bounds must be in form minLat,minLon,maxLat,maxLon");
+	}
+
+	std::vector<double> values;
+	for (const std::string& part : parts)
+	{
+		values.push_back(std::stod(part) * math::degToRadD());
+	}
+	return Box2d(osg::Vec2d(values[0], values[1]), osg::Vec2d(values[2], values[3]));
+}
+
+static void printProgress(const TileCacheSeederProgress& progress)
+{
+	double percent = progress.totalTileCount ? 100.0 * double(progress.getCompletedCount()) / double(progress.totalTileCount) : 100.0;
+	std::cout << std::fixed << std::setprecision(1)
+		<< percent << "% (" << progress.getCompletedCount() << "/" << progress.totalTileCount << " tiles): "
+		<< progress.fetchedCount << " fetched, "
+		<< progress.alreadyCachedCount << " already cached, "
+		<< progress.failedCount << " failed, "
+		<< progress.getFetchedTilesPerSecond() << " tiles/s" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	try
+	{
+		po::options_description desc("Seeds the tile cache with tiles for a region or route");
+		EngineCommandLineParser::addOptions(desc);
+		desc.add_options()
+			("tileSource", po::value<std::string>(), "JSON file containing the tile source")
+			("bounds", po::value<std::string>(), "Lat/lon bounds in degrees, in form minLat,minLon,maxLat,maxLon")
+			("route", po::value<std::string>(), "JSON file containing route points and corridor widths")
+			("minLevel", po::value<int>()->default_value(0), "Minimum tile level")
+			("maxLevel", po::value<int>(), "Maximum tile level. Defaults to the tile source's maximum level.")
+			("planetRadius", po::value<double>()->default_value(6371000), "Planet radius in meters, used to convert route corridor widths to angles")
+			("threads", po::value<int>()->default_value(8), "Number of tiles fetched concurrently");
+
+		po::variables_map params = EngineCommandLineParser::parse(argc, argv, desc);
+		if (params.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return EXIT_SUCCESS;
+		}
+
+		if (!params.count("tileSource"))
+		{
+			throw std::runtime_error("Tile source not specified");
+		}
+		if (!params.count("bounds") && !params.count("route"))
+		{
+			throw std::runtime_error("Bounds or route must be specified");
+		}
+
+		nlohmann::json tileSourceJson = readJsonFile(params["tileSource"].as<std::string>());
+
+		nlohmann::json settings = readEngineSettings(params);
+		JsonTileSourceFactoryRegistryConfig registryConfig;
+		registryConfig.apiKeys = readNameMap<std::string>(settings, "tileApiKeys");
+		registryConfig.cacheDirectory = getCacheDir().string();
+		JsonTileSourceFactoryRegistry registry(registryConfig);
+		addDefaultFactories(registry);
+
+		std::shared_ptr<CachedTileSource> source = createCachedTileSource(registry, tileSourceJson);
+		BOOST_LOG_TRIVIAL(info) << "Seeding tile cache in '" << registryConfig.cacheDirectory << "'";
+
+		TileCacheSeedRegion region;
+		if (params.count("bounds"))
+		{
+			region.latLonBounds = parseLatLonBounds(params["bounds"].as<std::string>());
+		}
+		if (params.count("route"))
+		{
+			region.route = readTileCacheSeedRoute(readJsonFile(params["route"].as<std::string>()));
+		}
+		region.levelRange.first = params["minLevel"].as<int>();
+		region.levelRange.last = params.count("maxLevel") ? params["maxLevel"].as<int>() : tileSourceJson.at("maxLevel").get<int>();
+		region.planetRadius = params["planetRadius"].as<double>();
+
+		std::vector<QuadTreeTileKey> keys = findTilesInRegion(region, *source);
+		std::cout << keys.size() << " tiles in region at levels " << region.levelRange.first << " to " << region.levelRange.last << std::endl;
+
+		TileCacheSeederConfig config;
+		config.threadCount = params["threads"].as<int>();
+		config.progressHandler = &printProgress;
+
+		TileCacheSeederProgress progress = seedTileCache(*source, keys, config);
+		std::cout << "Completed in " << progress.elapsedSeconds << "s" << std::endl;
+		return progress.failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
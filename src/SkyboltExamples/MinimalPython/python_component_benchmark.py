@@ -0,0 +1,82 @@
+"""
+Measures the overhead of dispatching simulation updates and property reads to Python components.
+Compares calling advance_sim_time on each component with calling advance_sim_time_batch once per class.
+"""
+import time
+from types import SimpleNamespace
+
+import setup_environment
+
+setup_environment.setup_skybolt_environment() # Environment must be setup before importing skybolt
+import skybolt as sb
+
+COMPONENT_COUNT = 500
+STEP_COUNT = 200
+DT = 1.0 / 60.0
+
+
+class PerComponentDispatch():
+	def __init__(self, entity):
+		self.properties = SimpleNamespace(gain=1.0, label="a")
+		self.value = 0.0
+
+	def advance_sim_time(self, time: float, dt: float):
+		self.value += self.properties.gain * dt
+
+
+class BatchedDispatch():
+	def __init__(self, entity):
+		self.properties = SimpleNamespace(gain=1.0, label="a")
+		self.value = 0.0
+
+	@classmethod
+	def advance_sim_time_batch(cls, components: list, time: float, dt: float):
+		for c in components:
+			c.value += c.properties.gain * dt
+
+
+def measure_seconds_per_component_step(engine, component_class) -> float:
+	entity = engine.entityFactory.createEntity("Camera")
+	for _ in range(COMPONENT_COUNT):
+		entity.addPythonComponent(component_class(entity))
+	engine.world.addEntity(entity)
+
+	# Measure the empty world first so that only the cost of the components is reported
+	start = time.perf_counter()
+	sb.advanceSimTime(engine, STEP_COUNT * DT)
+	elapsed = time.perf_counter() - start
+
+	engine.world.removeEntity(entity)
+	start = time.perf_counter()
+	sb.advanceSimTime(engine, STEP_COUNT * DT)
+	baseline = time.perf_counter() - start
+
+	return (elapsed - baseline) / (COMPONENT_COUNT * STEP_COUNT)
+
+
+def measure_seconds_per_property_read(engine) -> float:
+	entity = engine.entityFactory.createEntity("Camera")
+	entity.addPythonComponent(PerComponentDispatch(entity))
+	component = entity.getFirstComponentOfType("PyComponent")
+	gain = sb.getProperty(engine, component, "gain")
+
+	read_count = 100000
+	start = time.perf_counter()
+	for _ in range(read_count):
+		gain.value
+	return (time.perf_counter() - start) / read_count
+
+
+engine = sb.createEngineRoot(enableVis=False, loadPlugins=False)
+sb.setGlobalEngineRoot(engine)
+sb.registerComponent(engine, PerComponentDispatch)
+sb.registerComponent(engine, BatchedDispatch)
+
+per_component = measure_seconds_per_component_step(engine, PerComponentDispatch)
+batched = measure_seconds_per_component_step(engine, BatchedDispatch)
+property_read = measure_seconds_per_property_read(engine)
+
+print(f"{COMPONENT_COUNT} components, {STEP_COUNT} steps")
+print(f"advance_sim_time per component:       {per_component * 1e6:.3f} us per component step")
+print(f"advance_sim_time_batch per class:     {batched * 1e6:.3f} us per component step")
+print(f"Property read:                        {property_read * 1e6:.3f} us")
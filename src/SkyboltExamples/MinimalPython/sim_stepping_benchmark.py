@@ -0,0 +1,39 @@
+"""
+Compares the simulation steps per second achieved by calling advanceSimTime once per step from Python
+with advancing many steps in a single advanceSimTimeSteps call.
+"""
+import time
+
+import setup_environment
+
+setup_environment.setup_skybolt_environment() # Environment must be setup before importing skybolt
+import skybolt as sb
+
+STEP_COUNT = 5000
+DT = 1.0 / 60.0
+
+
+def measure_steps_per_second(engine, advance) -> float:
+	start = time.perf_counter()
+	advance(engine)
+	return STEP_COUNT / (time.perf_counter() - start)
+
+
+def advance_per_call(engine):
+	for _ in range(STEP_COUNT):
+		sb.advanceSimTime(engine, DT)
+
+
+def advance_multi_step(engine):
+	sb.advanceSimTimeSteps(engine, DT, STEP_COUNT)
+
+
+engine = sb.createEngineRoot(enableVis=False, loadPlugins=False)
+engine.world.addEntity(engine.entityFactory.createEntity("Camera"))
+
+per_call = measure_steps_per_second(engine, advance_per_call)
+multi_step = measure_steps_per_second(engine, advance_multi_step)
+
+print(f"{STEP_COUNT} steps of {DT:.4f}s")
+print(f"advanceSimTime per step:     {per_call:.0f} steps/s")
+print(f"advanceSimTimeSteps:         {multi_step:.0f} steps/s")
@@ -134,7 +134,8 @@ void ScenarioWorkspace::loadScenario(const nlohmann::json& json)
 	};
 
 	ifChildExists(json, "scenario", [this, entityFactoryFn] (const nlohmann::json& child) {
-		readScenario(*mEngineRoot->typeRegistry, *mEngineRoot->scenario, entityFactoryFn, child);
+		mEngineRoot->entityFactory->prefetchModels(readScenarioTemplateNames(child));
+		readScenario(*mEngineRoot->typeRegistry, *mEngineRoot->scenario, entityFactoryFn, child, {}, mEngineRoot->scheduler.get());
 	});
 
 	emit scenarioLoaded(json);
@@ -142,7 +143,7 @@ void ScenarioWorkspace::loadScenario(const nlohmann::json& json)
 
 void ScenarioWorkspace::saveScenario(nlohmann::json& json) const
 {
-	json["scenario"] = writeScenario(*mEngineRoot->typeRegistry, *mEngineRoot->scenario);
+	json["scenario"] = writeScenario(*mEngineRoot->typeRegistry, *mEngineRoot->scenario, mEngineRoot->scheduler.get());
 	emit scenarioSaved(json);
 }
 